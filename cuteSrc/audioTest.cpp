@@ -50,6 +50,7 @@
 #endif
 
 #include <ttLibC/resampler/audioResampler.h>
+#include <ttLibC/resampler/polyphaseResampler.h>
 
 #include <ttLibC/frame/audio/mp3.h>
 #include <ttLibC/frame/audio/speex.h>
@@ -74,6 +75,7 @@
 
 #include <stdio.h>
 #include <unistd.h>
+#include <time.h>
 
 static void fdkaacTest() {
 	LOG_PRINT("fdkaacTest");
@@ -426,6 +428,101 @@ static void audioResamplerTest() {
 	ASSERT(ttLibC_Allocator_dump() == 0);
 }
 
+static void polyphaseResamplerTest() {
+	LOG_PRINT("polyphaseResamplerTest");
+	uint32_t input_sample_rate = 44100;
+	uint32_t output_sample_rate = 48000;
+	ttLibC_BeepGenerator *generator = ttLibC_BeepGenerator_make(PcmS16Type_littleEndian, 440, input_sample_rate, 2);
+	ttLibC_PolyphaseResampler *resampler = ttLibC_PolyphaseResampler_make(2, input_sample_rate, output_sample_rate, PolyphaseResamplerQuality_high);
+	ttLibC_PcmS16 *pcm = NULL, *p;
+	ttLibC_PcmS16 *resampled = NULL, *r;
+	uint64_t next_pts = 0;
+	uint64_t out_total = 0;
+	uint32_t frame_num = 500;
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(uint32_t i = 0;i < frame_num;++ i) {
+		p = ttLibC_BeepGenerator_makeBeepBySampleNum(generator, pcm, 441);
+		if(p == NULL) {
+			break;
+		}
+		pcm = p;
+		pcm->inherit_super.inherit_super.pts = i * 441;
+		pcm->inherit_super.inherit_super.timebase = input_sample_rate;
+		r = ttLibC_PolyphaseResampler_resamplePcmS16(resampler, resampled, pcm);
+		if(r == NULL) {
+			ASSERT(resampler->error == Error_noError);
+			continue;
+		}
+		resampled = r;
+		// output pts must be continuous.
+		ASSERT(resampled->inherit_super.inherit_super.pts == next_pts);
+		next_pts += resampled->inherit_super.sample_num;
+		out_total += resampled->inherit_super.sample_num;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+	LOG_PRINT("polyphase: %f ns per channel-second", elapsed_ns / (frame_num * 441.0 / input_sample_rate * 2));
+	// output lack only the filter delay.
+	uint64_t expect_total = (uint64_t)frame_num * 441 * output_sample_rate / input_sample_rate;
+	ASSERT(out_total <= expect_total);
+	ASSERT(out_total + resampler->tap_num * 2 >= expect_total);
+#ifdef __ENABLE_SPEEXDSP__
+	{
+		SpeexResamplerState *speex = speex_resampler_init(2, input_sample_rate, output_sample_rate, 8, NULL);
+		int16_t out_buffer[2048];
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for(uint32_t i = 0;i < frame_num;++ i) {
+			uint32_t in_size = 441;
+			uint32_t out_size = 1024;
+			speex_resampler_process_interleaved_int(speex, (const spx_int16_t *)pcm->l_data, &in_size, out_buffer, &out_size);
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+		LOG_PRINT("speexdsp(8): %f ns per channel-second", elapsed_ns / (frame_num * 441.0 / input_sample_rate * 2));
+		speex_resampler_destroy(speex);
+	}
+#endif
+	ttLibC_PcmS16_close(&resampled);
+	ttLibC_PolyphaseResampler_close(&resampler);
+
+	// pcmf32 planar, down sampling.
+	resampler = ttLibC_PolyphaseResampler_make(2, input_sample_rate, 16000, PolyphaseResamplerQuality_medium);
+	ttLibC_PcmF32 *fpcm = NULL, *f;
+	ttLibC_PcmF32 *fresampled = NULL;
+	for(uint32_t i = 0;i < 10;++ i) {
+		p = ttLibC_BeepGenerator_makeBeepBySampleNum(generator, pcm, 4410);
+		if(p == NULL) {
+			break;
+		}
+		pcm = p;
+		f = ttLibC_AudioResampler_makePcmF32FromPcmS16(fpcm, PcmF32Type_planar, pcm);
+		if(f == NULL) {
+			break;
+		}
+		fpcm = f;
+		f = ttLibC_PolyphaseResampler_resamplePcmF32(resampler, fresampled, fpcm);
+		if(f == NULL) {
+			continue;
+		}
+		if(fresampled == NULL) {
+			// generator keep the pts from previous test.
+			next_pts = f->inherit_super.inherit_super.pts;
+		}
+		fresampled = f;
+		ASSERT(fresampled->inherit_super.sample_rate == 16000);
+		ASSERT(fresampled->inherit_super.inherit_super.pts == next_pts);
+		next_pts += fresampled->inherit_super.sample_num;
+	}
+	ASSERT(fresampled != NULL);
+	ttLibC_PcmF32_close(&fresampled);
+	ttLibC_PcmF32_close(&fpcm);
+	ttLibC_PolyphaseResampler_close(&resampler);
+	ttLibC_PcmS16_close(&pcm);
+	ttLibC_BeepGenerator_close(&generator);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
 static void opusTest() {
 	LOG_PRINT("opusTest");
 #if defined(__ENABLE_OPUS__) && defined(__ENABLE_OPENAL__)
@@ -1018,6 +1115,7 @@ cute::suite audioTests(cute::suite s) {
 	s.push_back(CUTE(vorbisTest));
 	s.push_back(CUTE(faadTest));
 	s.push_back(CUTE(audioResamplerTest));
+	s.push_back(CUTE(polyphaseResamplerTest));
 	s.push_back(CUTE(opusTest));
 	s.push_back(CUTE(mp3DecodeTest));
 	s.push_back(CUTE(speexFrameTest));
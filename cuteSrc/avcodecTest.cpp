@@ -44,6 +44,10 @@ extern "C" {
 #include <ttLibC/frame/audio/pcmf32.h>
 #include <ttLibC/frame/audio/audio.h>
 #include <ttLibC/frame/frame.h>
+#include <ttLibC/frame/video/h264.h>
+#include <ttLibC/frame/video/yuv420.h>
+#include <pthread.h>
+#include <string.h>
 
 #include <ttLibC/container/flv.h>
 #include <ttLibC/container/mkv.h>
@@ -852,6 +856,202 @@ static void wmv2Test() {
 	ASSERT(ttLibC_Allocator_dump() == 0);
 }
 
+#if defined(__ENABLE_AVCODEC__)
+typedef struct refFrameTest_t {
+	ttLibC_AvcodecDecoder *decoder;
+	ttLibC_Frame *refs[20];
+	uint32_t ref_num;
+} refFrameTest_t;
+
+static bool refFrameTest_decodeCallback(void *ptr, ttLibC_Frame *frame) {
+	refFrameTest_t *testData = (refFrameTest_t *)ptr;
+	if(testData->ref_num < 20) {
+		testData->refs[testData->ref_num ++] = ttLibC_AvcodecDecoder_refFrame(testData->decoder, frame);
+	}
+	return true;
+}
+
+static bool refFrameTest_encodeCallback(void *ptr, ttLibC_Frame *frame) {
+	refFrameTest_t *testData = (refFrameTest_t *)ptr;
+	return ttLibC_AvcodecDecoder_decode(testData->decoder, frame, refFrameTest_decodeCallback, ptr);
+}
+
+static void *refFrameTest_unref(void *arg) {
+	refFrameTest_t *testData = (refFrameTest_t *)arg;
+	// release even index on other thread.
+	for(uint32_t i = 0;i < testData->ref_num;i += 2) {
+		ttLibC_AvcodecDecoder_unrefFrame(testData->decoder, &testData->refs[i]);
+	}
+	return NULL;
+}
+#endif
+
+static void refFrameTest() {
+	LOG_PRINT("refFrameTest");
+#if defined(__ENABLE_AVCODEC__)
+	refFrameTest_t testData;
+	memset(&testData, 0, sizeof(testData));
+	uint32_t width = 64, height = 48;
+	ttLibC_AvcodecEncoder *encoder = ttLibC_AvcodecVideoEncoder_make(frameType_flv1, width, height);
+	testData.decoder = ttLibC_AvcodecVideoDecoder_make(frameType_flv1, width, height);
+	ttLibC_Yuv420 *yuv = ttLibC_Yuv420_makeEmptyFrame(Yuv420Type_planar, width, height);
+	for(int i = 0;i < 10;++ i) {
+		memset(yuv->y_data, i * 20, yuv->y_stride * height);
+		yuv->inherit_super.inherit_super.pts = i * 100;
+		yuv->inherit_super.inherit_super.timebase = 1000;
+		ASSERT(ttLibC_AvcodecEncoder_encode(encoder, (ttLibC_Frame *)yuv, refFrameTest_encodeCallback, &testData));
+	}
+	ASSERT(testData.ref_num > 4);
+	// ref keeps the picture after next decode.
+	for(uint32_t i = 0;i < testData.ref_num;++ i) {
+		ASSERT(testData.refs[i] != NULL);
+		ASSERT(i == 0 || testData.refs[i]->pts > testData.refs[i - 1]->pts);
+	}
+	pthread_t thread;
+	pthread_create(&thread, NULL, refFrameTest_unref, &testData);
+	pthread_join(thread, NULL);
+	// odd index is not released, closed with decoder.
+	ttLibC_AvcodecDecoder_close(&testData.decoder);
+	ttLibC_Yuv420_close(&yuv);
+	ttLibC_AvcodecEncoder_close(&encoder);
+#endif
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+#if defined(__ENABLE_AVCODEC__)
+typedef struct frameIdTest_t {
+	ttLibC_AvcodecDecoder *decoder;
+	ttLibC_H264 *h264;
+	uint32_t decode_num;
+	uint32_t bad_id_num;
+	uint32_t zero_id_num;
+	uint64_t last_pts;
+} frameIdTest_t;
+
+static bool frameIdTest_decodeCallback(void *ptr, ttLibC_Frame *frame) {
+	frameIdTest_t *testData = (frameIdTest_t *)ptr;
+	if(frame->id == 0) {
+		++ testData->zero_id_num;
+	}
+	// id is made from pts on input.
+	if(frame->id != frame->pts / 100 + 1
+	|| (testData->decode_num != 0 && frame->pts <= testData->last_pts)) {
+		++ testData->bad_id_num;
+	}
+	testData->last_pts = frame->pts;
+	++ testData->decode_num;
+	return true;
+}
+
+/*
+ * split annexB packet into h264 frames, and decode with id made from pts.
+ */
+static void frameIdTest_decodePacket(frameIdTest_t *testData, AVPacket *packet) {
+	uint8_t *data = packet->data;
+	size_t data_size = packet->size;
+	while(data_size > 0) {
+		ttLibC_H264 *h = ttLibC_H264_getFrame(testData->h264, data, data_size, true, packet->pts, 1000);
+		if(h == NULL) {
+			break;
+		}
+		testData->h264 = h;
+		h->inherit_super.inherit_super.id = (uint32_t)(packet->pts / 100 + 1);
+		if(h->type != H264Type_unknown) {
+			ttLibC_AvcodecDecoder_decode(testData->decoder, (ttLibC_Frame *)h, frameIdTest_decodeCallback, testData);
+		}
+		data += h->inherit_super.inherit_super.buffer_size;
+		data_size -= h->inherit_super.inherit_super.buffer_size;
+	}
+}
+#endif
+
+/*
+ * b-frame reorder and frame threading delay, id of source frame should be kept.
+ */
+static void frameIdTest() {
+	LOG_PRINT("frameIdTest");
+#if defined(__ENABLE_AVCODEC__)
+	uint32_t width = 64, height = 48, frame_num = 30;
+	AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_H264);
+	if(codec == NULL || strcmp(codec->name, "libx264") != 0) {
+		// need b-frame.
+		LOG_PRINT("no libx264 in avcodec, skip.");
+		ASSERT(ttLibC_Allocator_dump() == 0);
+		return;
+	}
+	AVCodecContext *enc = avcodec_alloc_context3(codec);
+	enc->width = width;
+	enc->height = height;
+	enc->pix_fmt = AV_PIX_FMT_YUV420P;
+	enc->time_base = (AVRational){1, 1000};
+	enc->gop_size = 10;
+	enc->max_b_frames = 2;
+	enc->bit_rate = 150000;
+	ASSERT(avcodec_open2(enc, codec, NULL) >= 0);
+	frameIdTest_t testData;
+	memset(&testData, 0, sizeof(testData));
+	testData.decoder = ttLibC_AvcodecVideoDecoder_makeWithThread(frameType_h264, width, height, NULL, 0, 2, AvcodecDecoderThreadType_frame);
+	ttLibC_Yuv420 *yuv = ttLibC_Yuv420_makeEmptyFrame(Yuv420Type_planar, width, height);
+	AVFrame *avframe = av_frame_alloc();
+	avframe->format = AV_PIX_FMT_YUV420P;
+	avframe->width = width;
+	avframe->height = height;
+	AVPacket packet;
+	uint32_t encode_num = 0;
+	bool is_reordered = false;
+	int64_t last_dts_pts = -1;
+	for(uint32_t i = 0;i <= frame_num;++ i) {
+		AVFrame *target = NULL;
+		if(i < frame_num) {
+			memset(yuv->y_data, i * 8, yuv->y_stride * height);
+			avframe->data[0] = yuv->y_data;
+			avframe->data[1] = yuv->u_data;
+			avframe->data[2] = yuv->v_data;
+			avframe->linesize[0] = yuv->y_stride;
+			avframe->linesize[1] = yuv->u_stride;
+			avframe->linesize[2] = yuv->v_stride;
+			avframe->pts = i * 100;
+			target = avframe;
+		}
+		// last loop flush encoder.
+		do {
+			av_init_packet(&packet);
+			packet.data = NULL;
+			packet.size = 0;
+			int got_output = 0;
+			ASSERT(avcodec_encode_video2(enc, &packet, target, &got_output) >= 0);
+			if(got_output != 1) {
+				break;
+			}
+			if(packet.pts < last_dts_pts) {
+				is_reordered = true;
+			}
+			last_dts_pts = packet.pts;
+			++ encode_num;
+			frameIdTest_decodePacket(&testData, &packet);
+			av_packet_unref(&packet);
+		} while(target == NULL);
+	}
+	ASSERT(encode_num == frame_num);
+	ASSERT(is_reordered);
+	// some frames are held in decoder.
+	uint32_t decode_num = testData.decode_num;
+	ASSERT(ttLibC_AvcodecDecoder_flush(testData.decoder, frameIdTest_decodeCallback, &testData));
+	LOG_PRINT("before flush:%u after flush:%u", decode_num, testData.decode_num);
+	ASSERT(decode_num < frame_num);
+	ASSERT(testData.decode_num == frame_num);
+	ASSERT(testData.zero_id_num == 0);
+	ASSERT(testData.bad_id_num == 0);
+	av_frame_free(&avframe);
+	avcodec_close(enc);
+	av_free(enc);
+	ttLibC_Yuv420_close(&yuv);
+	ttLibC_H264_close(&testData.h264);
+	ttLibC_AvcodecDecoder_close(&testData.decoder);
+#endif
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
 static void h264Test() {
 	LOG_PRINT("h264Test");
 #if defined(__ENABLE_AVCODEC__) && defined(__ENABLE_OPENCV__)
@@ -956,5 +1156,7 @@ cute::suite avcodecTests(cute::suite s) {
 	s.push_back(CUTE(wmv1Test));
 	s.push_back(CUTE(wmv2Test));
 	s.push_back(CUTE(h264Test));
+	s.push_back(CUTE(refFrameTest));
+	s.push_back(CUTE(frameIdTest));
 	return s;
 }
@@ -10,6 +10,7 @@
 
 #include <cute.h>
 #include <array>
+#include <string>
 #include <ttLibC/log.h>
 #include <ttLibC/allocator.h>
 #include <ttLibC/util/hexUtil.h>
@@ -20,9 +21,18 @@
 #include <ttLibC/container/mp3.h>
 #include <ttLibC/container/mp4.h>
 #include <ttLibC/container/mkv.h>
+#include <ttLibC/container/batchRemux.h>
+#include <ttLibC/container/segmenter.h>
+#include <ttLibC/container/segmentIndex.h>
+#include <ttLibC/container/containerCommon.h>
 
 #include <ttLibC/frame/audio/audio.h>
 #include <ttLibC/frame/video/h264.h>
+#include <ttLibC/frame/audio/mp3.h>
+#include <ttLibC/util/dynamicBufferUtil.h>
+#include <string.h>
+
+#include "containerTestUtil.h"
 
 typedef struct {
 	ttLibC_ContainerReader *reader;
@@ -1021,6 +1031,760 @@ static void flvFlv1AacTest() {
 	ASSERT(ttLibC_Allocator_dump() == 0);
 }
 
+typedef struct {
+	ttLibC_ContainerWriter *writer;
+	ttLibC_DynamicBuffer *buffer;
+	uint32_t audio_num;
+	uint32_t key_num;
+	uint32_t inner_num;
+} keyOnlyTest_t;
+
+static bool keyOnlyTest_writeCallback(void *ptr, void *data, size_t data_size) {
+	keyOnlyTest_t *testData = (keyOnlyTest_t *)ptr;
+	return ttLibC_DynamicBuffer_append(testData->buffer, (uint8_t *)data, data_size);
+}
+
+static bool keyOnlyTest_getFrameCallback(void *ptr, ttLibC_Frame *frame) {
+	keyOnlyTest_t *testData = (keyOnlyTest_t *)ptr;
+	if(frame->type == frameType_h264) {
+		if(((ttLibC_H264 *)frame)->type == H264Type_slice) {
+			++ testData->inner_num;
+		}
+		else if(((ttLibC_H264 *)frame)->type == H264Type_sliceIDR) {
+			++ testData->key_num;
+		}
+	}
+	else if(ttLibC_Frame_isAudio(frame)) {
+		++ testData->audio_num;
+	}
+	return true;
+}
+
+static bool keyOnlyTest_write(void *ptr, ttLibC_Frame *frame) {
+	keyOnlyTest_t *testData = (keyOnlyTest_t *)ptr;
+	ttLibC_ContainerWriter *writer = testData->writer;
+	switch(writer->type) {
+	case containerType_flv:
+		return ttLibC_FlvWriter_write((ttLibC_FlvWriter *)writer, frame, keyOnlyTest_writeCallback, testData);
+	case containerType_mkv:
+		return ttLibC_MkvWriter_write((ttLibC_MkvWriter *)writer, frame, keyOnlyTest_writeCallback, testData);
+	case containerType_mp4:
+		return ttLibC_Mp4Writer_write((ttLibC_Mp4Writer *)writer, frame, keyOnlyTest_writeCallback, testData);
+	case containerType_mpegts:
+		return ttLibC_MpegtsWriter_write((ttLibC_MpegtsWriter *)writer, frame, keyOnlyTest_writeCallback, testData);
+	default:
+		return false;
+	}
+}
+
+static bool keyOnlyTest_readCallback(void *ptr, ttLibC_Container *container) {
+	return ttLibC_Container_getFrame(container, keyOnlyTest_getFrameCallback, ptr);
+}
+
+/*
+ * write h264 / mp3 with writer, then read it with normal and key only mode.
+ */
+static void keyOnlyTest_check(
+		ttLibC_ContainerWriter *writer,
+		uint32_t track_base,
+		ttLibC_ContainerReader *reader,
+		ttLibC_ContainerReader *key_reader) {
+	keyOnlyTest_t testData;
+	testData.buffer = ttLibC_DynamicBuffer_make();
+	testData.writer = writer;
+	ASSERT(containerTest_makeAvStream(keyOnlyTest_write, &testData, 40, track_base));
+	ttLibC_ContainerWriter_close(&writer);
+
+	testData.audio_num = 0;
+	testData.key_num = 0;
+	testData.inner_num = 0;
+	ASSERT(ttLibC_ContainerReader_read(reader, ttLibC_DynamicBuffer_refData(testData.buffer), ttLibC_DynamicBuffer_refSize(testData.buffer), keyOnlyTest_readCallback, &testData));
+	uint32_t key_num = testData.key_num;
+	LOG_PRINT("normal   key:%d inner:%d audio:%d", testData.key_num, testData.inner_num, testData.audio_num);
+	ASSERT(testData.key_num > 0 && testData.inner_num > 0 && testData.audio_num > 0);
+
+	// rewrite slices to idr nal, key only mode should decide with the flag on container, not with nal.
+	uint8_t *data = (uint8_t *)ttLibC_DynamicBuffer_refData(testData.buffer);
+	size_t data_size = ttLibC_DynamicBuffer_refSize(testData.buffer);
+	uint32_t rewrite_num = 0;
+	size_t slice_size = sizeof(containerTest_h264Slice) - 4;
+	for(size_t i = 0;i + slice_size <= data_size;++ i) {
+		if(memcmp(data + i, containerTest_h264Slice + 4, slice_size) == 0) {
+			data[i] = 0x65;
+			++ rewrite_num;
+		}
+	}
+	ASSERT(rewrite_num > 0);
+	testData.audio_num = 0;
+	testData.key_num = 0;
+	testData.inner_num = 0;
+	ttLibC_ContainerReader_setKeyOnly(key_reader, true);
+	ASSERT(ttLibC_ContainerReader_read(key_reader, ttLibC_DynamicBuffer_refData(testData.buffer), ttLibC_DynamicBuffer_refSize(testData.buffer), keyOnlyTest_readCallback, &testData));
+	LOG_PRINT("key only key:%d inner:%d audio:%d", testData.key_num, testData.inner_num, testData.audio_num);
+	ASSERT(testData.key_num == key_num && testData.inner_num == 0 && testData.audio_num == 0);
+	ttLibC_ContainerReader_close(&reader);
+	ttLibC_ContainerReader_close(&key_reader);
+	ttLibC_DynamicBuffer_close(&testData.buffer);
+}
+
+static void keyOnlyTest() {
+	LOG_PRINT("keyOnlyTest");
+	ttLibC_Frame_Type types[2] = {frameType_h264, frameType_mp3};
+	LOG_PRINT("flv");
+	keyOnlyTest_check(
+			(ttLibC_ContainerWriter *)ttLibC_FlvWriter_make(frameType_h264, frameType_mp3),
+			1,
+			(ttLibC_ContainerReader *)ttLibC_FlvReader_make(),
+			(ttLibC_ContainerReader *)ttLibC_FlvReader_make());
+	LOG_PRINT("mkv");
+	keyOnlyTest_check(
+			(ttLibC_ContainerWriter *)ttLibC_MkvWriter_make_ex(types, 2, 1000),
+			1,
+			(ttLibC_ContainerReader *)ttLibC_MkvReader_make(),
+			(ttLibC_ContainerReader *)ttLibC_MkvReader_make());
+	LOG_PRINT("mp4");
+	keyOnlyTest_check(
+			(ttLibC_ContainerWriter *)ttLibC_Mp4Writer_make_ex(types, 2, 1000),
+			1,
+			(ttLibC_ContainerReader *)ttLibC_Mp4Reader_make(),
+			(ttLibC_ContainerReader *)ttLibC_Mp4Reader_make());
+	LOG_PRINT("mpegts");
+	keyOnlyTest_check(
+			(ttLibC_ContainerWriter *)ttLibC_MpegtsWriter_make_ex(types, 2, 1000),
+			0x0100,
+			(ttLibC_ContainerReader *)ttLibC_MpegtsReader_make(),
+			(ttLibC_ContainerReader *)ttLibC_MpegtsReader_make());
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+typedef struct {
+	uint32_t frame_num;
+	uint64_t pts[32];
+} stssTest_t;
+
+static void stssTest_u32(ttLibC_DynamicBuffer *buffer, uint32_t value) {
+	uint8_t buf[4] = {(uint8_t)(value >> 24), (uint8_t)(value >> 16), (uint8_t)(value >> 8), (uint8_t)value};
+	ttLibC_DynamicBuffer_append(buffer, buf, 4);
+}
+
+/*
+ * start atom, size is updated on stssTest_close.
+ */
+static size_t stssTest_open(ttLibC_DynamicBuffer *buffer, const char *tag) {
+	size_t pos = ttLibC_DynamicBuffer_refSize(buffer);
+	stssTest_u32(buffer, 0);
+	ttLibC_DynamicBuffer_append(buffer, (uint8_t *)tag, 4);
+	return pos;
+}
+
+static void stssTest_close(ttLibC_DynamicBuffer *buffer, size_t pos) {
+	uint32_t size = (uint32_t)(ttLibC_DynamicBuffer_refSize(buffer) - pos);
+	uint8_t *data = ttLibC_DynamicBuffer_refData(buffer) + pos;
+	data[0] = size >> 24;
+	data[1] = size >> 16;
+	data[2] = size >> 8;
+	data[3] = size;
+}
+
+static void stssTest_zero(ttLibC_DynamicBuffer *buffer, size_t size) {
+	for(size_t i = 0;i < size;++ i) {
+		uint8_t zero = 0;
+		ttLibC_DynamicBuffer_append(buffer, &zero, 1);
+	}
+}
+
+/*
+ * moov of 1 h264 track, 20 samples on 4 chunks. (6, 6, 4, 4 samples)
+ * sync samples are 1, 8, 14 and 20.
+ */
+static void stssTest_makeMoov(
+		ttLibC_DynamicBuffer *buffer,
+		uint32_t *sample_sizes,
+		uint32_t mdat_data_pos) {
+	size_t moov = stssTest_open(buffer, "moov");
+	size_t mvhd = stssTest_open(buffer, "mvhd");
+	stssTest_u32(buffer, 0);
+	stssTest_zero(buffer, 8);
+	stssTest_u32(buffer, 1000);
+	stssTest_u32(buffer, 2000);
+	stssTest_zero(buffer, 80);
+	stssTest_close(buffer, mvhd);
+	size_t trak = stssTest_open(buffer, "trak");
+	size_t tkhd = stssTest_open(buffer, "tkhd");
+	stssTest_u32(buffer, 3);
+	stssTest_zero(buffer, 8);
+	stssTest_u32(buffer, 1);
+	stssTest_zero(buffer, 4);
+	stssTest_u32(buffer, 2000);
+	stssTest_zero(buffer, 52);
+	stssTest_u32(buffer, 64 << 16);
+	stssTest_u32(buffer, 48 << 16);
+	stssTest_close(buffer, tkhd);
+	size_t mdia = stssTest_open(buffer, "mdia");
+	size_t mdhd = stssTest_open(buffer, "mdhd");
+	stssTest_u32(buffer, 0);
+	stssTest_zero(buffer, 8);
+	stssTest_u32(buffer, 1000);
+	stssTest_u32(buffer, 2000);
+	stssTest_zero(buffer, 4);
+	stssTest_close(buffer, mdhd);
+	size_t hdlr = stssTest_open(buffer, "hdlr");
+	stssTest_zero(buffer, 8);
+	ttLibC_DynamicBuffer_append(buffer, (uint8_t *)"vide", 4);
+	stssTest_zero(buffer, 13);
+	stssTest_close(buffer, hdlr);
+	size_t minf = stssTest_open(buffer, "minf");
+	size_t vmhd = stssTest_open(buffer, "vmhd");
+	stssTest_u32(buffer, 1);
+	stssTest_zero(buffer, 8);
+	stssTest_close(buffer, vmhd);
+	size_t stbl = stssTest_open(buffer, "stbl");
+	size_t stsd = stssTest_open(buffer, "stsd");
+	stssTest_u32(buffer, 0);
+	stssTest_u32(buffer, 1);
+	size_t avc1 = stssTest_open(buffer, "avc1");
+	stssTest_zero(buffer, 78);
+	size_t avcC = stssTest_open(buffer, "avcC");
+	// sps and pps of containerTest_h264Config.
+	uint8_t avcc[] = {0x01, 0x42, 0xC0, 0x0A, 0xFF, 0xE1,
+			0x00, 0x07, 0x67, 0x42, 0xC0, 0x0A, 0xDA, 0x25, 0x90,
+			0x01, 0x00, 0x04, 0x68, 0xCE, 0x38, 0x80};
+	ttLibC_DynamicBuffer_append(buffer, avcc, sizeof(avcc));
+	stssTest_close(buffer, avcC);
+	stssTest_close(buffer, avc1);
+	stssTest_close(buffer, stsd);
+	size_t stts = stssTest_open(buffer, "stts");
+	stssTest_u32(buffer, 0);
+	stssTest_u32(buffer, 1);
+	stssTest_u32(buffer, 20);
+	stssTest_u32(buffer, 100);
+	stssTest_close(buffer, stts);
+	size_t stss = stssTest_open(buffer, "stss");
+	stssTest_u32(buffer, 0);
+	stssTest_u32(buffer, 4);
+	stssTest_u32(buffer, 1);
+	stssTest_u32(buffer, 8);
+	stssTest_u32(buffer, 14);
+	stssTest_u32(buffer, 20);
+	stssTest_close(buffer, stss);
+	size_t stsc = stssTest_open(buffer, "stsc");
+	stssTest_u32(buffer, 0);
+	stssTest_u32(buffer, 2);
+	stssTest_u32(buffer, 1);
+	stssTest_u32(buffer, 6);
+	stssTest_u32(buffer, 1);
+	stssTest_u32(buffer, 3);
+	stssTest_u32(buffer, 4);
+	stssTest_u32(buffer, 1);
+	stssTest_close(buffer, stsc);
+	size_t stsz = stssTest_open(buffer, "stsz");
+	stssTest_u32(buffer, 0);
+	stssTest_u32(buffer, 0);
+	stssTest_u32(buffer, 20);
+	for(uint32_t i = 0;i < 20;++ i) {
+		stssTest_u32(buffer, sample_sizes[i]);
+	}
+	stssTest_close(buffer, stsz);
+	size_t stco = stssTest_open(buffer, "stco");
+	stssTest_u32(buffer, 0);
+	stssTest_u32(buffer, 4);
+	uint32_t chunk_samples[4] = {6, 6, 4, 4};
+	uint32_t pos = mdat_data_pos;
+	for(uint32_t i = 0, sample = 0;i < 4;++ i) {
+		stssTest_u32(buffer, pos);
+		for(uint32_t j = 0;j < chunk_samples[i];++ j, ++ sample) {
+			pos += sample_sizes[sample];
+		}
+	}
+	stssTest_close(buffer, stco);
+	stssTest_close(buffer, stbl);
+	stssTest_close(buffer, minf);
+	stssTest_close(buffer, mdia);
+	stssTest_close(buffer, trak);
+	stssTest_close(buffer, moov);
+}
+
+static bool stssTest_getFrameCallback(void *ptr, ttLibC_Frame *frame) {
+	stssTest_t *testData = (stssTest_t *)ptr;
+	if(frame->type != frameType_h264 || ((ttLibC_H264 *)frame)->type == H264Type_configData) {
+		return true;
+	}
+	if(testData->frame_num < 32) {
+		testData->pts[testData->frame_num] = frame->pts;
+	}
+	++ testData->frame_num;
+	return true;
+}
+
+static bool stssTest_readCallback(void *ptr, ttLibC_Container *container) {
+	return ttLibC_Container_getFrame(container, stssTest_getFrameCallback, ptr);
+}
+
+/*
+ * key only mode of non fragmented mp4 follows stss, not nal.
+ * sample 18 is idr nal without stss entry, sample 20 is slice nal with stss entry.
+ */
+static void stssTest() {
+	LOG_PRINT("stssTest");
+	ttLibC_DynamicBuffer *mdat_data = ttLibC_DynamicBuffer_make();
+	uint32_t sample_sizes[20];
+	for(uint32_t i = 0;i < 20;++ i) {
+		bool is_idr = (i == 0 || i == 7 || i == 13 || i == 17);
+		const uint8_t *nal = is_idr ? containerTest_h264Idr : containerTest_h264Slice;
+		uint32_t nal_size = (is_idr ? sizeof(containerTest_h264Idr) : sizeof(containerTest_h264Slice)) - 4;
+		stssTest_u32(mdat_data, nal_size);
+		ttLibC_DynamicBuffer_append(mdat_data, (uint8_t *)nal + 4, nal_size);
+		sample_sizes[i] = nal_size + 4;
+	}
+	ttLibC_DynamicBuffer *buffer = ttLibC_DynamicBuffer_make();
+	size_t ftyp = stssTest_open(buffer, "ftyp");
+	ttLibC_DynamicBuffer_append(buffer, (uint8_t *)"isom", 4);
+	stssTest_u32(buffer, 0x200);
+	ttLibC_DynamicBuffer_append(buffer, (uint8_t *)"isomavc1", 8);
+	stssTest_close(buffer, ftyp);
+	// moov size does not depend on chunk offsets, make once to get size.
+	ttLibC_DynamicBuffer *moov = ttLibC_DynamicBuffer_make();
+	stssTest_makeMoov(moov, sample_sizes, 0);
+	uint32_t mdat_data_pos = ttLibC_DynamicBuffer_refSize(buffer) + ttLibC_DynamicBuffer_refSize(moov) + 8;
+	ttLibC_DynamicBuffer_close(&moov);
+	stssTest_makeMoov(buffer, sample_sizes, mdat_data_pos);
+	size_t mdat = stssTest_open(buffer, "mdat");
+	ttLibC_DynamicBuffer_append(buffer, ttLibC_DynamicBuffer_refData(mdat_data), ttLibC_DynamicBuffer_refSize(mdat_data));
+	stssTest_close(buffer, mdat);
+	ttLibC_DynamicBuffer_close(&mdat_data);
+
+	stssTest_t testData;
+	memset(&testData, 0, sizeof(testData));
+	ttLibC_ContainerReader *reader = (ttLibC_ContainerReader *)ttLibC_Mp4Reader_make();
+	ASSERT(ttLibC_ContainerReader_read(reader, ttLibC_DynamicBuffer_refData(buffer), ttLibC_DynamicBuffer_refSize(buffer), stssTest_readCallback, &testData));
+	ttLibC_ContainerReader_close(&reader);
+	LOG_PRINT("normal   frame:%u", testData.frame_num);
+	ASSERT(testData.frame_num == 20);
+	for(uint32_t i = 0;i < 20;++ i) {
+		ASSERT(testData.pts[i] == i * 100);
+	}
+
+	memset(&testData, 0, sizeof(testData));
+	reader = (ttLibC_ContainerReader *)ttLibC_Mp4Reader_make();
+	ttLibC_ContainerReader_setKeyOnly(reader, true);
+	ASSERT(ttLibC_ContainerReader_read(reader, ttLibC_DynamicBuffer_refData(buffer), ttLibC_DynamicBuffer_refSize(buffer), stssTest_readCallback, &testData));
+	ttLibC_ContainerReader_close(&reader);
+	LOG_PRINT("key only frame:%u", testData.frame_num);
+	ASSERT(testData.frame_num == 4);
+	ASSERT(testData.pts[0] == 0 && testData.pts[1] == 700 && testData.pts[2] == 1300 && testData.pts[3] == 1900);
+	ttLibC_DynamicBuffer_close(&buffer);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+typedef struct {
+	ttLibC_Segmenter *segmenter;
+	ttLibC_DynamicBuffer *buffer[2];
+	uint64_t next_index[2];
+	uint64_t next_offset[2];
+	bool is_error;
+	uint32_t video_num;
+	uint32_t audio_num;
+} segmenterTest_t;
+
+static bool segmenterTest_tsWriteCallback(void *ptr, void *data, size_t data_size) {
+	segmenterTest_t *testData = (segmenterTest_t *)ptr;
+	ttLibC_DynamicBuffer_append(testData->buffer[0], (uint8_t *)data, data_size);
+	return true;
+}
+
+static bool segmenterTest_mp4WriteCallback(void *ptr, void *data, size_t data_size) {
+	segmenterTest_t *testData = (segmenterTest_t *)ptr;
+	ttLibC_DynamicBuffer_append(testData->buffer[1], (uint8_t *)data, data_size);
+	return true;
+}
+
+static bool segmenterTest_segmentCallback(void *ptr, ttLibC_Segmenter *segmenter, uint32_t output_index, ttLibC_Segment *segment) {
+	segmenterTest_t *testData = (segmenterTest_t *)ptr;
+	if(testData->next_index[output_index] == 0) {
+		testData->next_offset[output_index] = ttLibC_Segmenter_refInitSize(segmenter, output_index);
+	}
+	// segments are continuous, on the boundary of key frame.
+	if(segment->index != testData->next_index[output_index]
+	|| segment->offset != testData->next_offset[output_index]
+	|| segment->pts != segment->index * 2000
+	|| segment->duration != (segment->index == 4 ? 2005 : 2000)
+	|| segment->timebase != 1000) {
+		testData->is_error = true;
+	}
+	uint8_t *data = ttLibC_DynamicBuffer_refData(testData->buffer[output_index]) + segment->offset;
+	if(output_index == 0) {
+		if(segment->offset % 188 != 0 || data[0] != 0x47) {
+			testData->is_error = true;
+		}
+	}
+	else {
+		if(memcmp(data + 4, "styp", 4) != 0) {
+			testData->is_error = true;
+		}
+	}
+	++ testData->next_index[output_index];
+	testData->next_offset[output_index] = segment->offset + segment->size;
+	return true;
+}
+
+static bool segmenterTest_write(void *ptr, ttLibC_Frame *frame) {
+	segmenterTest_t *testData = (segmenterTest_t *)ptr;
+	return ttLibC_Segmenter_write(testData->segmenter, frame, segmenterTest_segmentCallback, testData);
+}
+
+static bool segmenterTest_getFrameCallback(void *ptr, ttLibC_Frame *frame) {
+	segmenterTest_t *testData = (segmenterTest_t *)ptr;
+	if(frame->type == frameType_h264) {
+		switch(((ttLibC_H264 *)frame)->type) {
+		case H264Type_slice:
+		case H264Type_sliceIDR:
+			++ testData->video_num;
+			break;
+		default:
+			break;
+		}
+	}
+	else if(ttLibC_Frame_isAudio(frame)) {
+		++ testData->audio_num;
+	}
+	return true;
+}
+
+static bool segmenterTest_readCallback(void *ptr, ttLibC_Container *container) {
+	return ttLibC_Container_getFrame(container, segmenterTest_getFrameCallback, ptr);
+}
+
+static void segmenterTest() {
+	LOG_PRINT("segmenterTest");
+	segmenterTest_t testData;
+	memset(&testData, 0, sizeof(testData));
+	testData.buffer[0] = ttLibC_DynamicBuffer_make();
+	testData.buffer[1] = ttLibC_DynamicBuffer_make();
+	ttLibC_Frame_Type types[2] = {frameType_h264, frameType_mp3};
+	// key frame for each 1 sec, segment for each 2 sec.
+	ttLibC_Segmenter *segmenter = ttLibC_Segmenter_make(types, 2, 2000);
+	ASSERT(ttLibC_Segmenter_addOutput(segmenter, containerType_mpegts, segmenterTest_tsWriteCallback, &testData) == 0);
+	ASSERT(ttLibC_Segmenter_addOutput(segmenter, containerType_mp4, segmenterTest_mp4WriteCallback, &testData) == 1);
+	testData.segmenter = segmenter;
+	ASSERT(containerTest_makeAvStream(segmenterTest_write, &testData, 100, 1));
+	LOG_PRINT("segments ts:%llu mp4:%llu", (unsigned long long)testData.next_index[0], (unsigned long long)testData.next_index[1]);
+	ASSERT(!testData.is_error);
+	// boundary on 0, 2, 4, 6, 8 sec. last one is not closed before flush.
+	ASSERT(testData.next_index[0] == 4 && testData.next_index[1] == 4);
+	ASSERT(testData.next_offset[0] == ttLibC_DynamicBuffer_refSize(testData.buffer[0]));
+	ASSERT(ttLibC_Segmenter_flush(segmenter, segmenterTest_segmentCallback, &testData));
+	ASSERT(!testData.is_error);
+	// last one ends with the last mp3 frame. (441216 / 44100 sec)
+	ASSERT(testData.next_index[0] == 5 && testData.next_index[1] == 5);
+	ASSERT(testData.next_offset[0] == ttLibC_DynamicBuffer_refSize(testData.buffer[0]));
+	ASSERT(testData.next_offset[1] == ttLibC_DynamicBuffer_refSize(testData.buffer[1]));
+	ttLibC_Segmenter_close(&segmenter);
+	// all frames are written. (mpegts reader holds the last pes)
+	ttLibC_ContainerReader *readers[2] = {
+			(ttLibC_ContainerReader *)ttLibC_MpegtsReader_make(),
+			(ttLibC_ContainerReader *)ttLibC_Mp4Reader_make()};
+	uint32_t video_nums[2] = {99, 100};
+	for(uint32_t i = 0;i < 2;++ i) {
+		testData.video_num = 0;
+		testData.audio_num = 0;
+		ASSERT(ttLibC_ContainerReader_read(readers[i], ttLibC_DynamicBuffer_refData(testData.buffer[i]), ttLibC_DynamicBuffer_refSize(testData.buffer[i]), segmenterTest_readCallback, &testData));
+		LOG_PRINT("output:%d video:%d audio:%d", i, testData.video_num, testData.audio_num);
+		ASSERT(testData.video_num == video_nums[i]);
+		ttLibC_ContainerReader_close(&readers[i]);
+	}
+	ASSERT(testData.audio_num == 383);
+	ttLibC_DynamicBuffer_close(&testData.buffer[0]);
+	ttLibC_DynamicBuffer_close(&testData.buffer[1]);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+static bool segmentIndexTest_writeCallback(void *ptr, void *data, size_t data_size) {
+	(void)ptr;
+	(void)data;
+	(void)data_size;
+	return true;
+}
+
+static uint32_t segmentIndexTest_count(ttLibC_DynamicBuffer *buffer, const char *word) {
+	std::string text((const char *)ttLibC_DynamicBuffer_refData(buffer), ttLibC_DynamicBuffer_refSize(buffer));
+	uint32_t count = 0;
+	for(size_t pos = text.find(word);pos != std::string::npos;pos = text.find(word, pos + 1)) {
+		++ count;
+	}
+	return count;
+}
+
+static bool segmentIndexTest_write(void *ptr, ttLibC_Frame *frame) {
+	return ttLibC_Segmenter_write((ttLibC_Segmenter *)ptr, frame, NULL, NULL);
+}
+
+static void segmentIndexTest() {
+	LOG_PRINT("segmentIndexTest");
+	ttLibC_Frame_Type types[2] = {frameType_h264, frameType_mp3};
+	// segment for each 2 sec, part for each 0.5 sec, hold 3 segments and 12 parts.
+	ttLibC_Segmenter *segmenter = ttLibC_Segmenter_make(types, 2, 2000);
+	ASSERT(ttLibC_Segmenter_addOutput(segmenter, containerType_mp4, segmentIndexTest_writeCallback, NULL) == 0);
+	ASSERT(ttLibC_Segmenter_setPartDuration(segmenter, 500));
+	ttLibC_SegmentIndex *index = ttLibC_SegmentIndex_make(3, 12);
+	ASSERT(ttLibC_Segmenter_setIndex(segmenter, 0, index));
+	ASSERT(containerTest_makeAvStream(segmentIndexTest_write, segmenter, 100, 1));
+	// segment 0 - 3 are done, 1 - 3 are held. parts of 4 are done until 9.5 sec.
+	ASSERT(index->segment_num == 3 && index->first_index == 1);
+	ttLibC_DynamicBuffer *buffer = ttLibC_DynamicBuffer_make();
+	ASSERT(ttLibC_SegmentIndex_renderM3u8(index, "live.mp4", false, buffer));
+	ASSERT(segmentIndexTest_count(buffer, "#EXT-X-MEDIA-SEQUENCE:1\n") == 1);
+	ASSERT(segmentIndexTest_count(buffer, "#EXT-X-TARGETDURATION:2\n") == 1);
+	ASSERT(segmentIndexTest_count(buffer, "#EXT-X-MAP:URI=\"live.mp4\"") == 1);
+	ASSERT(segmentIndexTest_count(buffer, "#EXTINF:2.000,") == 3);
+	// parts of segment 1 are partly dropped, so only 2, 3 and 4 have parts.
+	ASSERT(segmentIndexTest_count(buffer, "#EXT-X-PART:DURATION=0.500") == 11);
+	ASSERT(segmentIndexTest_count(buffer, "INDEPENDENT=YES") == 6);
+	ttLibC_DynamicBuffer_empty(buffer);
+	ASSERT(ttLibC_SegmentIndex_renderSegmentTimeline(index, buffer));
+	ASSERT(segmentIndexTest_count(buffer, "<S t=\"2000\" d=\"2000\" r=\"2\"/>") == 1);
+	ttLibC_DynamicBuffer_close(&buffer);
+	ttLibC_Segmenter_close(&segmenter);
+	ttLibC_SegmentIndex_close(&index);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+typedef struct {
+	ttLibC_FlvWriter *writer;
+	FILE *fp;
+} batchRemuxTest_t;
+
+static bool batchRemuxTest_writeCallback(void *ptr, void *data, size_t data_size) {
+	return fwrite(data, 1, data_size, (FILE *)ptr) == data_size;
+}
+
+static bool batchRemuxTest_write(void *ptr, ttLibC_Frame *frame) {
+	batchRemuxTest_t *testData = (batchRemuxTest_t *)ptr;
+	return ttLibC_FlvWriter_write(testData->writer, frame, batchRemuxTest_writeCallback, testData->fp);
+}
+
+static void batchRemuxTest() {
+	LOG_PRINT("batchRemuxTest");
+#ifdef __ENABLE_FILE__
+	// make flv files for input.
+	char input[4][64];
+	char output[4][64];
+	for(int i = 0;i < 4;++ i) {
+		sprintf(input[i], "batchRemuxTest_%d.flv", i);
+		sprintf(output[i], "batchRemuxTest_%d.%s", i, (i & 1) ? "ts" : "mp4");
+		batchRemuxTest_t testData;
+		testData.fp = fopen(input[i], "wb");
+		ASSERT(testData.fp != NULL);
+		testData.writer = ttLibC_FlvWriter_make(frameType_h264, frameType_mp3);
+		ASSERT(containerTest_makeAvStream(batchRemuxTest_write, &testData, 40 + i * 10, 1));
+		ttLibC_FlvWriter_close(&testData.writer);
+		fclose(testData.fp);
+	}
+	ttLibC_Frame_Type types[2] = {frameType_h264, frameType_mp3};
+	ttLibC_BatchRemux *batch = ttLibC_BatchRemux_make(2);
+	for(int i = 0;i < 4;++ i) {
+		ASSERT(ttLibC_BatchRemux_addJob(batch, input[i], containerType_flv, output[i], (i & 1) ? containerType_mpegts : containerType_mp4, types, 2) != NULL);
+	}
+	ASSERT(ttLibC_BatchRemux_run(batch));
+	ASSERT(batch->error_num == 0);
+	for(int i = 0;i < 4;++ i) {
+		ttLibC_BatchRemuxJob *job = ttLibC_BatchRemux_refJob(batch, i);
+		LOG_PRINT("job:%d worker:%d read:%llu write:%llu frame:%llu drop:%llu", i, job->worker_index,
+				(unsigned long long)job->read_size, (unsigned long long)job->write_size,
+				(unsigned long long)job->frame_count, (unsigned long long)job->drop_count);
+		ASSERT(job->is_success);
+		ASSERT(job->read_size > 0 && job->write_size > 0);
+		ASSERT(job->frame_count > 0 && job->drop_count == 0);
+		uint8_t header[8];
+		FILE *fp = fopen(output[i], "rb");
+		ASSERT(fp != NULL);
+		ASSERT(fread(header, 1, 8, fp) == 8);
+		fseek(fp, 0, SEEK_END);
+		ASSERT((uint64_t)ftell(fp) == job->write_size);
+		fclose(fp);
+		if(i & 1) {
+			ASSERT(header[0] == 0x47);
+		}
+		else {
+			ASSERT(memcmp(header + 4, "ftyp", 4) == 0);
+		}
+	}
+	ttLibC_BatchRemux_close(&batch);
+	// missing input is reported on the job.
+	batch = ttLibC_BatchRemux_make(2);
+	ASSERT(ttLibC_BatchRemux_addJob(batch, "batchRemuxTest_none.flv", containerType_flv, output[0], containerType_mp4, types, 2) != NULL);
+	ASSERT(ttLibC_BatchRemux_addJob(batch, input[0], containerType_flv, output[0], containerType_mp4, types, 2) != NULL);
+	ASSERT(!ttLibC_BatchRemux_run(batch));
+	ASSERT(batch->error_num == 1);
+	ASSERT(!ttLibC_BatchRemux_refJob(batch, 0)->is_success);
+	ASSERT(ttLibC_BatchRemux_refJob(batch, 1)->is_success);
+	ttLibC_BatchRemux_close(&batch);
+	for(int i = 0;i < 4;++ i) {
+		remove(input[i]);
+		remove(output[i]);
+	}
+#endif
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+/*
+ * value * dst / src on 128bit, as exact floor.
+ */
+static uint64_t rescalerTest_exact(uint64_t value, uint32_t dst, uint32_t src) {
+	return (uint64_t)((unsigned __int128)value * dst / src);
+}
+
+static void rescalerTest() {
+	LOG_PRINT("rescalerTest");
+	// 29.97fps on 90k, 1000, aac frames on 44100.
+	uint32_t timebases[3] = {90000, 1000, 44100};
+	uint64_t steps[3]     = {3003, 33, 1024};
+	// from 0, and from large pts which overflows value * num on 64bit.
+	uint64_t starts[2]    = {0, 1ULL << 50};
+	ttLibC_ContainerWriter_Rescaler rescaler;
+	for(int s = 0;s < 3;++ s) {
+		for(int d = 0;d < 3;++ d) {
+			if(s == d) {
+				continue;
+			}
+			ttLibC_ContainerWriter_Rescaler_setup(&rescaler, timebases[d], timebases[s]);
+			for(int k = 0;k < 2;++ k) {
+				uint64_t mismatch = 0;
+				// 10M frames, 92 hours for 90k video.
+				for(uint64_t i = 0;i < 10000000;++ i) {
+					uint64_t value = starts[k] + i * steps[s];
+					if(ttLibC_ContainerWriter_Rescaler_rescale(&rescaler, value) != rescalerTest_exact(value, timebases[d], timebases[s])) {
+						++ mismatch;
+					}
+				}
+				ASSERT(mismatch == 0);
+			}
+		}
+	}
+	// 1000 -> 90k -> 1000 is lossless.
+	ttLibC_ContainerWriter_Rescaler back;
+	ttLibC_ContainerWriter_Rescaler_setup(&rescaler, 90000, 1000);
+	ttLibC_ContainerWriter_Rescaler_setup(&back, 1000, 90000);
+	for(uint64_t value = (1ULL << 40);value < (1ULL << 40) + 1000000;++ value) {
+		ASSERT(ttLibC_ContainerWriter_Rescaler_rescale(&back, ttLibC_ContainerWriter_Rescaler_rescale(&rescaler, value)) == value);
+	}
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+typedef struct {
+	ttLibC_MkvWriter *writer;
+	uint32_t mp3_count;
+	uint32_t write_count;
+	uint32_t top_change;
+	uint32_t top_id;
+	bool is_error;
+} ptsHeapTest_t;
+
+static bool ptsHeapTest_writeCallback(void *ptr, void *data, size_t data_size) {
+	(void)ptr;
+	(void)data;
+	(void)data_size;
+	return true;
+}
+
+/*
+ * compare pts_heap with scan of all tracks.
+ */
+static bool ptsHeapTest_check(ptsHeapTest_t *testData) {
+	ttLibC_ContainerWriter_ *writer = (ttLibC_ContainerWriter_ *)testData->writer;
+	if(writer->heap_num != writer->track_num) {
+		return false;
+	}
+	uint64_t min_pts = (uint64_t)-1;
+	for(uint32_t i = 0;i < writer->track_num;++ i) {
+		ttLibC_ContainerWriter_WriteTrack *track = writer->tracks[i];
+		if(track->heap_pts != track->frame_queue->pts
+		|| writer->pts_heap[track->heap_index] != track) {
+			return false;
+		}
+		if(min_pts > track->heap_pts) {
+			min_pts = track->heap_pts;
+		}
+	}
+	for(uint32_t i = 1;i < writer->heap_num;++ i) {
+		if(writer->pts_heap[(i - 1) / 2]->heap_pts > writer->pts_heap[i]->heap_pts) {
+			return false;
+		}
+	}
+	if(writer->pts_heap[0]->heap_pts != min_pts) {
+		return false;
+	}
+	if(writer->pts_heap[0]->frame_queue->track_id != testData->top_id) {
+		testData->top_id = writer->pts_heap[0]->frame_queue->track_id;
+		++ testData->top_change;
+	}
+	return ttLibC_ContainerWriter_isReadyToWrite(writer) == (writer->target_pos <= min_pts);
+}
+
+static bool ptsHeapTest_writeFrame(ptsHeapTest_t *testData, ttLibC_Frame *frame) {
+	if(!ttLibC_MkvWriter_write(testData->writer, frame, ptsHeapTest_writeCallback, testData)) {
+		return false;
+	}
+	++ testData->write_count;
+	if(!ptsHeapTest_check(testData)) {
+		testData->is_error = true;
+		return false;
+	}
+	return true;
+}
+
+static bool ptsHeapTest_write(void *ptr, ttLibC_Frame *frame) {
+	ptsHeapTest_t *testData = (ptsHeapTest_t *)ptr;
+	if(frame->type != frameType_mp3) {
+		return ptsHeapTest_writeFrame(testData, frame);
+	}
+	uint64_t pts = frame->pts;
+	uint32_t timebase = frame->timebase;
+	// track 2: all mp3 frames.
+	if(!ptsHeapTest_writeFrame(testData, frame)) {
+		return false;
+	}
+	// track 3: each 3 frames, on 44100.
+	if(testData->mp3_count % 3 == 0) {
+		frame->id = 3;
+		if(!ptsHeapTest_writeFrame(testData, frame)) {
+			return false;
+		}
+	}
+	// track 4: 350msec behind, on 1000. (around the queued pts of h264, which waits for 3 frames)
+	uint64_t msec = pts * 1000 / 44100;
+	if(msec >= 350) {
+		frame->id = 4;
+		frame->pts = msec - 350;
+		frame->dts = frame->pts;
+		frame->timebase = 1000;
+		if(!ptsHeapTest_writeFrame(testData, frame)) {
+			return false;
+		}
+	}
+	frame->id = 2;
+	frame->pts = pts;
+	frame->dts = pts;
+	frame->timebase = timebase;
+	++ testData->mp3_count;
+	return true;
+}
+
+static void ptsHeapTest() {
+	LOG_PRINT("ptsHeapTest");
+	ptsHeapTest_t testData;
+	memset(&testData, 0, sizeof(testData));
+	ttLibC_Frame_Type types[4] = {frameType_h264, frameType_mp3, frameType_mp3, frameType_mp3};
+	testData.writer = ttLibC_MkvWriter_make_ex(types, 4, 1000);
+	testData.top_id = 1;
+	ASSERT(containerTest_makeAvStream(ptsHeapTest_write, &testData, 100, 1));
+	ASSERT(!testData.is_error);
+	LOG_PRINT("write:%u top_change:%u", testData.write_count, testData.top_change);
+	// lowest track moves among tracks while writing.
+	ASSERT(testData.top_change > 10);
+	ttLibC_MkvWriter_close(&testData.writer);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
 /**
  * define all test for container package.
  * @param s cute::suite obj
@@ -1032,6 +1796,13 @@ cute::suite containerTests(cute::suite s) {
 //	s.push_back(CUTE(mpegtsH264Mp3Test));
 //	s.push_back(CUTE(flvFlv1AacTest));
 //	s.push_back(CUTE(mpegtsToFlvTest)); // h264/aac
+	s.push_back(CUTE(rescalerTest));
+	s.push_back(CUTE(ptsHeapTest));
+	s.push_back(CUTE(keyOnlyTest));
+	s.push_back(CUTE(stssTest));
+	s.push_back(CUTE(segmenterTest));
+	s.push_back(CUTE(segmentIndexTest));
+	s.push_back(CUTE(batchRemuxTest));
 	s.push_back(CUTE(mp4Test)); // h264/aac
 	s.push_back(CUTE(webmTest)); // vp8/opus
 	s.push_back(CUTE(mkvTest)); // h264/aac
@@ -0,0 +1,86 @@
+/**
+ * @file   containerTestUtil.cpp
+ * @brief  synthetic h264 / mp3 stream for container tests and bench.
+ *
+ * this code is under GPLv3 license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "containerTestUtil.h"
+#include <ttLibC/frame/video/h264.h>
+#include <ttLibC/frame/audio/mp3.h>
+#include <string.h>
+
+const uint8_t containerTest_h264Config[19] = {
+	0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0xC0, 0x0A, 0xDA, 0x25, 0x90,
+	0x00, 0x00, 0x00, 0x01, 0x68, 0xCE, 0x38, 0x80};
+const uint8_t containerTest_h264Idr[12]   = {0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00, 0x33, 0xFF, 0x12, 0x34};
+const uint8_t containerTest_h264Slice[10] = {0x00, 0x00, 0x00, 0x01, 0x41, 0x9A, 0x02, 0x04, 0x56, 0x78};
+const uint8_t containerTest_mp3Header[4]  = {0xFF, 0xFB, 0x90, 0x64};
+
+bool containerTest_makeAvStream(
+		containerTest_AvStreamFunc callback,
+		void *ptr,
+		uint32_t frame_num,
+		uint32_t video_id) {
+	// frames refer the data, so copy to writable buffer.
+	uint8_t config[sizeof(containerTest_h264Config)];
+	uint8_t idr[sizeof(containerTest_h264Idr)];
+	uint8_t slice[sizeof(containerTest_h264Slice)];
+	uint8_t mp3[417];
+	memcpy(config, containerTest_h264Config, sizeof(config));
+	memcpy(idr, containerTest_h264Idr, sizeof(idr));
+	memcpy(slice, containerTest_h264Slice, sizeof(slice));
+	memset(mp3, 0, sizeof(mp3));
+	memcpy(mp3, containerTest_mp3Header, sizeof(containerTest_mp3Header));
+	ttLibC_H264 *h264 = NULL;
+	ttLibC_Mp3 *mp3Frame = NULL;
+	uint64_t audio_pts = 0;
+	bool result = true;
+	for(uint32_t i = 0;i < frame_num && result;++ i) {
+		uint64_t pts = i * 100;
+		if(i % 10 == 0) {
+			h264 = ttLibC_H264_getFrame(h264, config, sizeof(config), true, pts, 1000);
+			if(h264 == NULL) {
+				result = false;
+				break;
+			}
+			h264->inherit_super.inherit_super.id = video_id;
+			if(!callback(ptr, (ttLibC_Frame *)h264)) {
+				result = false;
+				break;
+			}
+			h264 = ttLibC_H264_getFrame(h264, idr, sizeof(idr), true, pts, 1000);
+		}
+		else {
+			h264 = ttLibC_H264_getFrame(h264, slice, sizeof(slice), true, pts, 1000);
+		}
+		if(h264 == NULL) {
+			result = false;
+			break;
+		}
+		h264->inherit_super.inherit_super.id = video_id;
+		if(!callback(ptr, (ttLibC_Frame *)h264)) {
+			result = false;
+			break;
+		}
+		while(audio_pts * 1000 / 44100 < pts + 100) {
+			mp3Frame = ttLibC_Mp3_getFrame(mp3Frame, mp3, sizeof(mp3), true, audio_pts, 44100);
+			if(mp3Frame == NULL) {
+				result = false;
+				break;
+			}
+			mp3Frame->inherit_super.inherit_super.id = video_id + 1;
+			if(!callback(ptr, (ttLibC_Frame *)mp3Frame)) {
+				result = false;
+				break;
+			}
+			audio_pts += 1152;
+		}
+	}
+	ttLibC_H264_close(&h264);
+	ttLibC_Mp3_close(&mp3Frame);
+	return result;
+}
@@ -0,0 +1,49 @@
+/**
+ * @file   containerTestUtil.h
+ * @brief  synthetic h264 / mp3 stream for container tests and bench.
+ *
+ * this code is under GPLv3 license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef CUTESRC_CONTAINERTESTUTIL_H_
+#define CUTESRC_CONTAINERTESTUTIL_H_
+
+#include <ttLibC/frame/frame.h>
+
+/** 32x32 baseline sps / pps in annexB. */
+extern const uint8_t containerTest_h264Config[19];
+/** dummy idr nal in annexB. */
+extern const uint8_t containerTest_h264Idr[12];
+/** dummy slice nal in annexB. */
+extern const uint8_t containerTest_h264Slice[10];
+/** mpeg1 layer3 128kbps 44100Hz header, frame is 417 bytes. */
+extern const uint8_t containerTest_mp3Header[4];
+
+/**
+ * callback for synthetic frame.
+ * @param ptr   user def pointer.
+ * @param frame h264 or mp3 frame, reused for next call.
+ * @return true:continue false:stop
+ */
+typedef bool (* containerTest_AvStreamFunc)(void *ptr, ttLibC_Frame *frame);
+
+/**
+ * make h264 / mp3 stream.
+ * video is 10fps with timebase 1000, sps pps and idr for each 10 frames, slice for others.
+ * mp3 frames with timebase 44100 are made until next video pts after each video frame.
+ * @param callback callback for each frame.
+ * @param ptr      user def pointer for callback.
+ * @param frame_num number of video frames.
+ * @param video_id  id for h264 frames, mp3 frames use video_id + 1.
+ * @return true:success false:error or stopped by callback.
+ */
+bool containerTest_makeAvStream(
+		containerTest_AvStreamFunc callback,
+		void *ptr,
+		uint32_t frame_num,
+		uint32_t video_id);
+
+#endif /* CUTESRC_CONTAINERTESTUTIL_H_ */
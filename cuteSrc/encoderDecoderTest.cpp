@@ -12,6 +12,8 @@
 
 #include <ttLibC/log.h>
 #include <ttLibC/allocator.h>
+#include <ttLibC/encoder/encodeSink.h>
+#include <ttLibC/util/dynamicBufferUtil.h>
 
 #ifdef __ENABLE_OPENCV__
 #	include <ttLibC/util/opencvUtil.h>
@@ -127,6 +129,7 @@
 #include <ttLibC/util/hexUtil.h>
 
 #include <unistd.h>
+#include <string.h>
 
 static void vtJpegDecodeBinaryTest() {
 	LOG_PRINT("vtJpegDecodeBinaryTest");
@@ -1323,6 +1326,267 @@ static void jpegTest() {
 	ASSERT(ttLibC_Allocator_dump() == 0);
 }
 
+#ifdef __ENABLE_JPEG__
+typedef struct {
+	ttLibC_JpegDecoder *decoder;
+	ttLibC_Yuv420 *yuv;
+} jpegParallelTest_t;
+
+static bool jpegParallelTest_decodeCallback(void *ptr, ttLibC_Yuv420 *yuv) {
+	jpegParallelTest_t *testData = (jpegParallelTest_t *)ptr;
+	ttLibC_Yuv420 *y = (ttLibC_Yuv420 *)ttLibC_Frame_clone((ttLibC_Frame *)testData->yuv, (ttLibC_Frame *)yuv);
+	if(y == NULL) {
+		return false;
+	}
+	testData->yuv = y;
+	return true;
+}
+
+static bool jpegParallelTest_encodeCallback(void *ptr, ttLibC_Jpeg *jpeg) {
+	jpegParallelTest_t *testData = (jpegParallelTest_t *)ptr;
+	return ttLibC_JpegDecoder_decode(testData->decoder, jpeg, jpegParallelTest_decodeCallback, ptr);
+}
+#endif
+
+static void jpegParallelTest() {
+	LOG_PRINT("jpegParallelTest");
+#ifdef __ENABLE_JPEG__
+	// odd size, to check padding of strip and mcu.
+	uint32_t width = 641, height = 361;
+	ttLibC_Yuv420 *yuv = ttLibC_Yuv420_makeEmptyFrame(Yuv420Type_planar, width, height);
+	for(uint32_t i = 0;i < height;++ i) {
+		for(uint32_t j = 0;j < width;++ j) {
+			yuv->y_data[i * yuv->y_stride + j] = 16 + ((i + j * 3) % 220);
+		}
+	}
+	for(uint32_t i = 0;i < (height + 1) / 2;++ i) {
+		for(uint32_t j = 0;j < (width + 1) / 2;++ j) {
+			yuv->u_data[i * yuv->u_stride + j] = 64 + ((i * 2) % 128);
+			yuv->v_data[i * yuv->v_stride + j] = 64 + ((j * 2) % 128);
+		}
+	}
+	jpegParallelTest_t single, parallel;
+	single.decoder = ttLibC_JpegDecoder_make();
+	single.yuv = NULL;
+	parallel.decoder = ttLibC_JpegDecoder_make();
+	parallel.yuv = NULL;
+	ttLibC_JpegEncoder *encoder = ttLibC_JpegEncoder_make(width, height, 90);
+	ttLibC_JpegEncoder *pencoder = ttLibC_JpegEncoder_makeWithThread(width, height, 90, 4);
+	ASSERT(pencoder->thread_num == 4);
+	ASSERT(ttLibC_JpegEncoder_encode(encoder, yuv, jpegParallelTest_encodeCallback, &single));
+	ASSERT(ttLibC_JpegEncoder_encode(pencoder, yuv, jpegParallelTest_encodeCallback, &parallel));
+	ASSERT(single.yuv != NULL && parallel.yuv != NULL);
+	ASSERT(parallel.yuv->inherit_super.width == width);
+	ASSERT(parallel.yuv->inherit_super.height == height);
+	// only entropy coding is different, picture must be the same.
+	bool is_same = true;
+	for(uint32_t i = 0;i < height;++ i) {
+		if(memcmp(single.yuv->y_data + i * single.yuv->y_stride, parallel.yuv->y_data + i * parallel.yuv->y_stride, width) != 0) {
+			is_same = false;
+		}
+	}
+	for(uint32_t i = 0;i < (height + 1) / 2;++ i) {
+		if(memcmp(single.yuv->u_data + i * single.yuv->u_stride, parallel.yuv->u_data + i * parallel.yuv->u_stride, (width + 1) / 2) != 0
+		|| memcmp(single.yuv->v_data + i * single.yuv->v_stride, parallel.yuv->v_data + i * parallel.yuv->v_stride, (width + 1) / 2) != 0) {
+			is_same = false;
+		}
+	}
+	ASSERT(is_same);
+	ttLibC_JpegEncoder_close(&encoder);
+	ttLibC_JpegEncoder_close(&pencoder);
+	ttLibC_JpegDecoder_close(&single.decoder);
+	ttLibC_JpegDecoder_close(&parallel.decoder);
+	ttLibC_Yuv420_close(&single.yuv);
+	ttLibC_Yuv420_close(&parallel.yuv);
+	ttLibC_Yuv420_close(&yuv);
+#endif
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+#ifdef __ENABLE_JPEG__
+static bool jpegSinkTest_encodeCallback(void *ptr, ttLibC_Jpeg *jpeg) {
+	ttLibC_DynamicBuffer *buffer = (ttLibC_DynamicBuffer *)ptr;
+	ttLibC_DynamicBuffer_empty(buffer);
+	return ttLibC_DynamicBuffer_append(buffer, (uint8_t *)jpeg->inherit_super.inherit_super.data, jpeg->inherit_super.inherit_super.buffer_size);
+}
+
+static bool jpegSinkTest_sinkCallback(void *ptr, ttLibC_EncodeSink *sink) {
+	uint32_t *count = (uint32_t *)ptr;
+	++ (*count);
+	return sink->frame_type == frameType_jpeg && sink->is_key;
+}
+
+/*
+ * encode with frame output and sink output, then compare binary.
+ */
+static void jpegSinkTest_check(ttLibC_JpegEncoder *encoder, ttLibC_Yuv420 *yuv) {
+	ttLibC_DynamicBuffer *expect = ttLibC_DynamicBuffer_make();
+	ASSERT(ttLibC_JpegEncoder_encode(encoder, yuv, jpegSinkTest_encodeCallback, expect));
+	size_t size = ttLibC_DynamicBuffer_refSize(expect);
+	ASSERT(size > 0);
+	uint32_t count = 0;
+	// region, just the size.
+	uint8_t *region = new uint8_t[size];
+	ttLibC_EncodeSink *sink = ttLibC_EncodeSink_makeRegion(region, size, EncodeSinkNalFormat_annexB);
+	ASSERT(ttLibC_JpegEncoder_encodeToSink(encoder, yuv, sink, jpegSinkTest_sinkCallback, &count));
+	ASSERT(count == 1);
+	ASSERT(sink->unit_offset == 0 && sink->unit_size == size && sink->write_size == size);
+	ASSERT(memcmp(region, ttLibC_DynamicBuffer_refData(expect), size) == 0);
+	// region, too small.
+	ASSERT(ttLibC_EncodeSink_setRegion(sink, region, size - 1));
+	ASSERT(!ttLibC_JpegEncoder_encodeToSink(encoder, yuv, sink, jpegSinkTest_sinkCallback, &count));
+	ASSERT(sink->is_overflow);
+	ASSERT(count == 1);
+	ttLibC_EncodeSink_close(&sink);
+	delete[] region;
+	// dynamicBuffer, append after existing data twice.
+	ttLibC_DynamicBuffer *buffer = ttLibC_DynamicBuffer_make();
+	uint8_t header[3] = {1, 2, 3};
+	ttLibC_DynamicBuffer_append(buffer, header, 3);
+	sink = ttLibC_EncodeSink_makeBuffer(buffer, EncodeSinkNalFormat_annexB);
+	ASSERT(ttLibC_JpegEncoder_encodeToSink(encoder, yuv, sink, jpegSinkTest_sinkCallback, &count));
+	ASSERT(ttLibC_JpegEncoder_encodeToSink(encoder, yuv, sink, jpegSinkTest_sinkCallback, &count));
+	ASSERT(count == 3);
+	ASSERT(sink->unit_num == 2 && sink->unit_offset == size && sink->unit_size == size);
+	ASSERT(ttLibC_DynamicBuffer_refSize(buffer) == 3 + size * 2);
+	ASSERT(memcmp(ttLibC_DynamicBuffer_refData(buffer), header, 3) == 0);
+	ASSERT(memcmp(ttLibC_DynamicBuffer_refData(buffer) + 3, ttLibC_DynamicBuffer_refData(expect), size) == 0);
+	ASSERT(memcmp(ttLibC_EncodeSink_refUnit(sink), ttLibC_DynamicBuffer_refData(expect), size) == 0);
+	ttLibC_EncodeSink_close(&sink);
+	ttLibC_DynamicBuffer_close(&buffer);
+	ttLibC_DynamicBuffer_close(&expect);
+}
+#endif
+
+static void jpegSinkTest() {
+	LOG_PRINT("jpegSinkTest");
+#ifdef __ENABLE_JPEG__
+	uint32_t width = 320, height = 240;
+	ttLibC_Yuv420 *yuv = ttLibC_Yuv420_makeEmptyFrame(Yuv420Type_planar, width, height);
+	for(uint32_t i = 0;i < height;++ i) {
+		for(uint32_t j = 0;j < width;++ j) {
+			yuv->y_data[i * yuv->y_stride + j] = 16 + ((i * 5 + j * 3) % 220);
+		}
+	}
+	for(uint32_t i = 0;i < height / 2;++ i) {
+		for(uint32_t j = 0;j < width / 2;++ j) {
+			yuv->u_data[i * yuv->u_stride + j] = 64 + ((i * 2) % 128);
+			yuv->v_data[i * yuv->v_stride + j] = 64 + ((j * 2) % 128);
+		}
+	}
+	ttLibC_JpegEncoder *encoder = ttLibC_JpegEncoder_make(width, height, 90);
+	jpegSinkTest_check(encoder, yuv);
+	ttLibC_JpegEncoder_close(&encoder);
+	encoder = ttLibC_JpegEncoder_makeWithThread(width, height, 90, 3);
+	jpegSinkTest_check(encoder, yuv);
+	ttLibC_JpegEncoder_close(&encoder);
+	ttLibC_Yuv420_close(&yuv);
+#endif
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+typedef struct h264SinkTest_t {
+	uint32_t unit_num;
+	bool is_key[4];
+	bool is_config[4];
+	size_t unit_size[4];
+	uint64_t pts[4];
+} h264SinkTest_t;
+
+static bool h264SinkTest_callback(void *ptr, ttLibC_EncodeSink *sink) {
+	h264SinkTest_t *testData = (h264SinkTest_t *)ptr;
+	if(testData->unit_num >= 4 || sink->frame_type != frameType_h264) {
+		return false;
+	}
+	testData->is_key[testData->unit_num]    = sink->is_key;
+	testData->is_config[testData->unit_num] = sink->is_config;
+	testData->unit_size[testData->unit_num] = sink->unit_size;
+	testData->pts[testData->unit_num]       = sink->pts;
+	++ testData->unit_num;
+	return true;
+}
+
+/*
+ * write nals of 2 pictures, as h264 encoders do.
+ */
+static bool h264SinkTest_write(ttLibC_EncodeSink *sink, h264SinkTest_t *testData) {
+	uint8_t aud[]   = {0x00, 0x00, 0x00, 0x01, 0x09, 0xF0};
+	uint8_t sps[]   = {0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x1E, 0xAB};
+	uint8_t pps[]   = {0x00, 0x00, 0x00, 0x01, 0x68, 0xCE, 0x38, 0x80};
+	uint8_t sei[]   = {0x00, 0x00, 0x01, 0x06, 0x05, 0x01, 0x00, 0x80};
+	uint8_t idr[]   = {0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00};
+	uint8_t slice[] = {0x41, 0x9A, 0x02};
+	uint8_t *nals[] = {aud, sps, pps, sei, idr};
+	size_t nal_sizes[] = {sizeof(aud), sizeof(sps), sizeof(pps), sizeof(sei), sizeof(idr)};
+	sink->pts = 0;
+	sink->timebase = 1000;
+	for(int i = 0;i < 5;++ i) {
+		if(!ttLibC_EncodeSink_appendH264Nal(sink, nals[i], nal_sizes[i], h264SinkTest_callback, testData)) {
+			return false;
+		}
+	}
+	if(!ttLibC_EncodeSink_endH264(sink, h264SinkTest_callback, testData)) {
+		return false;
+	}
+	// multi slice picture.
+	sink->pts = 33;
+	for(int i = 0;i < 2;++ i) {
+		if(!ttLibC_EncodeSink_appendH264Nal(sink, slice, sizeof(slice), h264SinkTest_callback, testData)) {
+			return false;
+		}
+	}
+	return ttLibC_EncodeSink_endH264(sink, h264SinkTest_callback, testData);
+}
+
+static void h264SinkTest() {
+	LOG_PRINT("h264SinkTest");
+	// sizeNal on region.
+	uint8_t region[64];
+	h264SinkTest_t testData;
+	memset(&testData, 0, sizeof(testData));
+	ttLibC_EncodeSink *sink = ttLibC_EncodeSink_makeRegion(region, sizeof(region), EncodeSinkNalFormat_sizeNal);
+	ASSERT(h264SinkTest_write(sink, &testData));
+	uint8_t size_nal[] = {
+			0x00, 0x00, 0x00, 0x05, 0x67, 0x42, 0x00, 0x1E, 0xAB,
+			0x00, 0x00, 0x00, 0x04, 0x68, 0xCE, 0x38, 0x80,
+			0x00, 0x00, 0x00, 0x04, 0x65, 0x88, 0x84, 0x00,
+			0x00, 0x00, 0x00, 0x03, 0x41, 0x9A, 0x02,
+			0x00, 0x00, 0x00, 0x03, 0x41, 0x9A, 0x02};
+	// sps + pps, idr, 2 slices.
+	ASSERT(testData.unit_num == 3);
+	ASSERT(testData.is_config[0] && testData.unit_size[0] == 17 && testData.pts[0] == 0);
+	ASSERT(testData.is_key[1] && !testData.is_config[1] && testData.unit_size[1] == 8);
+	ASSERT(!testData.is_key[2] && testData.unit_size[2] == 14 && testData.pts[2] == 33);
+	ASSERT(sink->write_size == sizeof(size_nal));
+	ASSERT(memcmp(region, size_nal, sizeof(size_nal)) == 0);
+	ASSERT(ttLibC_EncodeSink_refUnit(sink) == region + 25);
+	// too small region.
+	ASSERT(ttLibC_EncodeSink_setRegion(sink, region, 20));
+	memset(&testData, 0, sizeof(testData));
+	ASSERT(!h264SinkTest_write(sink, &testData));
+	ASSERT(sink->is_overflow);
+	ASSERT(testData.unit_num == 1);
+	ttLibC_EncodeSink_close(&sink);
+
+	// annexB on dynamicBuffer.
+	ttLibC_DynamicBuffer *buffer = ttLibC_DynamicBuffer_make();
+	memset(&testData, 0, sizeof(testData));
+	sink = ttLibC_EncodeSink_makeBuffer(buffer, EncodeSinkNalFormat_annexB);
+	ASSERT(h264SinkTest_write(sink, &testData));
+	ASSERT(testData.unit_num == 3);
+	ASSERT(ttLibC_DynamicBuffer_refSize(buffer) == sizeof(size_nal));
+	for(size_t pos = 0;pos < sizeof(size_nal);) {
+		size_t nal_size = size_nal[pos + 3];
+		uint8_t start_code[] = {0x00, 0x00, 0x00, 0x01};
+		ASSERT(memcmp(ttLibC_DynamicBuffer_refData(buffer) + pos, start_code, 4) == 0);
+		ASSERT(memcmp(ttLibC_DynamicBuffer_refData(buffer) + pos + 4, size_nal + pos + 4, nal_size) == 0);
+		pos += 4 + nal_size;
+	}
+	ttLibC_EncodeSink_close(&sink);
+	ttLibC_DynamicBuffer_close(&buffer);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
 #if defined(__ENABLE_OPUS__) && defined(__ENABLE_OPENAL__)
 typedef struct {
 	ttLibC_AlDevice *device;
@@ -1977,6 +2241,9 @@ cute::suite encoderDecoderTests(cute::suite s) {
 	s.push_back(CUTE(x265Test));
 	s.push_back(CUTE(x264Test));
 	s.push_back(CUTE(jpegTest));
+	s.push_back(CUTE(jpegParallelTest));
+	s.push_back(CUTE(jpegSinkTest));
+	s.push_back(CUTE(h264SinkTest));
 	s.push_back(CUTE(opusTest));
 	s.push_back(CUTE(speexTest));
 	s.push_back(CUTE(swresampleTest));
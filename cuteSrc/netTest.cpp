@@ -16,7 +16,10 @@
 #include <ttLibC/allocator.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
 #include <sys/socket.h>
+#include <pthread.h>
 #include <ttLibC/util/hexUtil.h>
 #include <ttLibC/util/amfUtil.h>
 #include <ttLibC/util/stlListUtil.h>
@@ -29,6 +32,7 @@
 #include <ttLibC/net/udp.h>
 
 #include <ttLibC/net/client/rtmp.h>
+#include <ttLibC/net/server/rtmp.h>
 
 #ifdef __ENABLE_FILE__
 #	include <ttLibC/util/forkUtil.h>
@@ -47,6 +51,15 @@
 #endif
 
 #include <ttLibC/net/tetty2/tcpBootstrap.h>
+#include <ttLibC/net/client/rtmp2/data/clientObject.h>
+#include <ttLibC/net/client/rtmp2/message/rtmpMessage.h>
+#include <ttLibC/net/client/rtmp2/message/amf0Command.h>
+#include <ttLibC/net/client/rtmp2/message/amf0DataMessage.h>
+#include <ttLibC/net/client/rtmp2/message/audioMessage.h>
+#include <ttLibC/net/client/rtmp2/message/setChunkSize.h>
+#include <ttLibC/net/client/rtmp2/message/videoMessage.h>
+#include <ttLibC/frame/audio/pcmAlaw.h>
+#include <errno.h>
 
 #include <ttLibC/resampler/imageResampler.h>
 
@@ -117,6 +130,534 @@ static void tetty2ServerTest() {
 	ASSERT(ttLibC_Allocator_dump() == 0);
 }
 
+/*
+ * raw rtmp client for rtmpServerTest.
+ * all sockets are non-blocking, and server is updated on the same thread.
+ */
+#define RTMPSERVERTEST_FRAME_NUM  220
+#define RTMPSERVERTEST_LATE_JOIN  100
+#define RTMPSERVERTEST_SLOW_RESUME 200
+#define RTMPSERVERTEST_FRAME_SIZE 65536
+
+typedef struct rtmpServerTest_client_t {
+	int sock;
+	bool is_publisher;
+	/** true: don't read socket, for slow player. */
+	bool is_paused;
+	ttLibC_ClientObject *client_object;
+	ttLibC_DynamicBuffer *send_buffer;
+	size_t handshake_size;
+	bool is_handshake_done;
+	uint32_t stream_id;
+	bool is_started;
+	// received
+	uint32_t meta_num;
+	uint32_t video_config_num;
+	uint32_t audio_config_num;
+	/** meta and both config are received before first media. */
+	bool is_config_first;
+	uint32_t media_num;
+	int32_t first_index;
+	int32_t last_index;
+	bool is_first_key;
+	/** number of discontinuity. */
+	uint32_t gap_num;
+	/** discontinuity which doesn't start with keyFrame. */
+	uint32_t bad_gap_num;
+	/** pcm alaw message for rtmpAggregateTest. */
+	uint32_t alaw_num;
+	/** pcm alaw message with unexpected timestamp or body. */
+	uint32_t bad_alaw_num;
+} rtmpServerTest_client_t;
+
+typedef struct rtmpServerTest_t {
+	ttLibC_RtmpServer *server;
+	rtmpServerTest_client_t clients[4];
+	int client_num;
+} rtmpServerTest_t;
+
+static void rtmpServerTest_pump(rtmpServerTest_t *test);
+
+/*
+ * write all data, update server while socket buffer is full.
+ */
+static void rtmpServerTest_write(
+		rtmpServerTest_t *test,
+		rtmpServerTest_client_t *client,
+		uint8_t *data,
+		size_t data_size) {
+	while(data_size > 0) {
+		ssize_t size = send(client->sock, data, data_size, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if(size < 0) {
+			if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				return;
+			}
+			rtmpServerTest_pump(test);
+			continue;
+		}
+		data += size;
+		data_size -= size;
+	}
+}
+
+/*
+ * make chunks with type0 and type3 header, with default chunk size(128).
+ */
+static void rtmpServerTest_sendBinary(
+		rtmpServerTest_t *test,
+		rtmpServerTest_client_t *client,
+		uint32_t cs_id,
+		uint64_t timestamp,
+		ttLibC_RtmpMessage_Type message_type,
+		uint32_t stream_id,
+		uint8_t *data,
+		size_t data_size) {
+	ttLibC_RtmpHeader *header = ttLibC_RtmpHeader_make(cs_id, timestamp, message_type, stream_id);
+	header->type = Type0;
+	header->size = data_size;
+	ttLibC_DynamicBuffer_empty(client->send_buffer);
+	uint8_t buf[18];
+	do {
+		size_t size = ttLibC_RtmpHeader_getData(header, buf, sizeof(buf));
+		ttLibC_DynamicBuffer_append(client->send_buffer, buf, size);
+		size_t write_size = data_size > client->client_object->send_chunk_size ? client->client_object->send_chunk_size : data_size;
+		ttLibC_DynamicBuffer_append(client->send_buffer, data, write_size);
+		data += write_size;
+		data_size -= write_size;
+		header->type = Type3;
+	} while(data_size > 0);
+	ttLibC_RtmpHeader_close(&header);
+	rtmpServerTest_write(
+			test,
+			client,
+			ttLibC_DynamicBuffer_refData(client->send_buffer),
+			ttLibC_DynamicBuffer_refSize(client->send_buffer));
+}
+
+static void rtmpServerTest_sendMessage(
+		rtmpServerTest_t *test,
+		rtmpServerTest_client_t *client,
+		ttLibC_RtmpMessage *message) {
+	ttLibC_DynamicBuffer *buffer = ttLibC_DynamicBuffer_make();
+	if(ttLibC_RtmpMessage_getData(client->client_object, message, buffer)) {
+		rtmpServerTest_sendBinary(
+				test,
+				client,
+				message->header->cs_id,
+				message->header->timestamp,
+				message->header->message_type,
+				message->header->stream_id,
+				ttLibC_DynamicBuffer_refData(buffer),
+				ttLibC_DynamicBuffer_refSize(buffer));
+	}
+	ttLibC_DynamicBuffer_close(&buffer);
+}
+
+static void rtmpServerTest_onCommand(
+		rtmpServerTest_t *test,
+		rtmpServerTest_client_t *client,
+		ttLibC_Amf0Command *command) {
+	const char *name = (const char *)command->command_name;
+	if(strcmp(name, "_result") == 0) {
+		if(command->command_id == 1) {
+			ttLibC_Amf0Command *create_stream = ttLibC_Amf0Command_createStream();
+			create_stream->command_id = 2;
+			rtmpServerTest_sendMessage(test, client, (ttLibC_RtmpMessage *)create_stream);
+			ttLibC_Amf0Command_close(&create_stream);
+		}
+		else if(command->command_id == 2 && command->obj2 != NULL && command->obj2->type == amf0Type_Number) {
+			client->stream_id = (uint32_t)*((double *)command->obj2->object);
+			ttLibC_Amf0Command *next = client->is_publisher
+					? ttLibC_Amf0Command_publish(client->stream_id, "test")
+					: ttLibC_Amf0Command_play(client->stream_id, "test");
+			rtmpServerTest_sendMessage(test, client, (ttLibC_RtmpMessage *)next);
+			ttLibC_Amf0Command_close(&next);
+		}
+	}
+	else if(strcmp(name, "onStatus") == 0 && command->obj2 != NULL) {
+		ttLibC_Amf0Object *code = ttLibC_Amf0_getElement(command->obj2, "code");
+		if(code != NULL
+		&& (strcmp((const char *)code->object, "NetStream.Publish.Start") == 0
+				|| strcmp((const char *)code->object, "NetStream.Play.Start") == 0)) {
+			client->is_started = true;
+		}
+	}
+}
+
+static void rtmpServerTest_onMedia(
+		rtmpServerTest_client_t *client,
+		ttLibC_RtmpMessage_Type message_type,
+		uint8_t *data) {
+	if(message_type == RtmpMessageType_audioMessage) {
+		if((data[0] >> 4) == 10 && data[1] == 0) {
+			++ client->audio_config_num;
+		}
+		return;
+	}
+	if(data[1] == 0) {
+		++ client->video_config_num;
+		return;
+	}
+	bool is_key = (data[0] >> 4) == 1;
+	int32_t index = (data[5] << 24) | (data[6] << 16) | (data[7] << 8) | data[8];
+	if(client->media_num == 0) {
+		client->is_config_first = client->meta_num == 1
+				&& client->video_config_num == 1
+				&& client->audio_config_num == 1;
+		client->first_index = index;
+		client->is_first_key = is_key;
+	}
+	else if(index != client->last_index + 1) {
+		++ client->gap_num;
+		if(!is_key) {
+			++ client->bad_gap_num;
+		}
+	}
+	client->last_index = index;
+	++ client->media_num;
+}
+
+/*
+ * pcm alaw frame n should have timestamp n * 20, and hold n on the head of body.
+ */
+static void rtmpServerTest_onAlaw(
+		rtmpServerTest_client_t *client,
+		ttLibC_AudioMessage *message) {
+	uint8_t *data = message->data;
+	uint32_t index = data[1] | (data[2] << 8);
+	if(message->inherit_super.header->size != 161
+	|| message->inherit_super.header->timestamp != client->alaw_num * 20
+	|| index != client->alaw_num) {
+		++ client->bad_alaw_num;
+	}
+	++ client->alaw_num;
+}
+
+static void rtmpServerTest_read(
+		rtmpServerTest_t *test,
+		rtmpServerTest_client_t *client) {
+	uint8_t buf[65536];
+	while(true) {
+		ssize_t size = recv(client->sock, buf, sizeof(buf), MSG_DONTWAIT);
+		if(size <= 0) {
+			return;
+		}
+		ttLibC_DynamicBuffer *recv_buffer = client->client_object->recv_buffer;
+		ttLibC_DynamicBuffer_append(recv_buffer, buf, size);
+		if(!client->is_handshake_done) {
+			// s0 s1 s2 -> c2(any 1536 bytes) and connect.
+			if(ttLibC_DynamicBuffer_refSize(recv_buffer) < 3073) {
+				continue;
+			}
+			rtmpServerTest_write(test, client, ttLibC_DynamicBuffer_refData(recv_buffer) + 1, 1536);
+			ttLibC_DynamicBuffer_markAsRead(recv_buffer, 3073);
+			ttLibC_DynamicBuffer_clear(recv_buffer);
+			client->is_handshake_done = true;
+			ttLibC_Amf0Command *connect = ttLibC_Amf0Command_connect("rtmp://127.0.0.1/live", "live");
+			connect->command_id = 1;
+			rtmpServerTest_sendMessage(test, client, (ttLibC_RtmpMessage *)connect);
+			ttLibC_Amf0Command_close(&connect);
+		}
+		ttLibC_RtmpMessage *message = NULL;
+		while((message = ttLibC_RtmpMessage_readBinary(recv_buffer, client->client_object)) != NULL) {
+			switch(message->header->message_type) {
+			case RtmpMessageType_setChunkSize:
+				client->client_object->recv_chunk_size = ((ttLibC_SetChunkSize *)message)->size;
+				break;
+			case RtmpMessageType_amf0Command:
+				rtmpServerTest_onCommand(test, client, (ttLibC_Amf0Command *)message);
+				break;
+			case RtmpMessageType_amf0DataMessage:
+				if(strcmp((const char *)((ttLibC_Amf0DataMessage *)message)->message_name, "onMetaData") == 0) {
+					++ client->meta_num;
+				}
+				break;
+			case RtmpMessageType_videoMessage:
+				rtmpServerTest_onMedia(client, message->header->message_type, ((ttLibC_VideoMessage *)message)->data);
+				break;
+			case RtmpMessageType_audioMessage:
+				if((((ttLibC_AudioMessage *)message)->data[0] >> 4) == 7) {
+					rtmpServerTest_onAlaw(client, (ttLibC_AudioMessage *)message);
+					break;
+				}
+				rtmpServerTest_onMedia(client, message->header->message_type, ((ttLibC_AudioMessage *)message)->data);
+				break;
+			default:
+				break;
+			}
+			ttLibC_RtmpMessage_close(&message);
+		}
+	}
+}
+
+static void rtmpServerTest_pump(rtmpServerTest_t *test) {
+	ttLibC_RtmpServer_update(test->server, 1000);
+	for(int i = 0;i < test->client_num;++ i) {
+		if(test->clients[i].sock >= 0 && !test->clients[i].is_paused) {
+			rtmpServerTest_read(test, &test->clients[i]);
+		}
+	}
+}
+
+/*
+ * connect and handshake, wait for publish start / play start.
+ */
+static rtmpServerTest_client_t *rtmpServerTest_connect(
+		rtmpServerTest_t *test,
+		bool is_publisher,
+		int recv_buffer_size) {
+	rtmpServerTest_client_t *client = &test->clients[test->client_num ++];
+	memset(client, 0, sizeof(rtmpServerTest_client_t));
+	client->is_publisher = is_publisher;
+	client->last_index = -1;
+	client->client_object = ttLibC_ClientObject_make();
+	client->send_buffer = ttLibC_DynamicBuffer_make();
+	client->sock = socket(AF_INET, SOCK_STREAM, 0);
+	if(recv_buffer_size > 0) {
+		// before connect, for small tcp window.
+		setsockopt(client->sock, SOL_SOCKET, SO_RCVBUF, &recv_buffer_size, sizeof(recv_buffer_size));
+	}
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons(test->server->port);
+	if(connect(client->sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+		return client;
+	}
+	uint8_t c0c1[1537];
+	memset(c0c1, 0, sizeof(c0c1));
+	c0c1[0] = 0x03;
+	rtmpServerTest_write(test, client, c0c1, sizeof(c0c1));
+	for(int i = 0;i < 5000 && !client->is_started;++ i) {
+		rtmpServerTest_pump(test);
+	}
+	return client;
+}
+
+static void rtmpServerTest_sendVideo(
+		rtmpServerTest_t *test,
+		rtmpServerTest_client_t *publisher,
+		int32_t index) {
+	static uint8_t data[RTMPSERVERTEST_FRAME_SIZE];
+	memset(data, index & 0xFF, sizeof(data));
+	data[0] = (index % 10) == 0 ? 0x17 : 0x27;
+	data[1] = 0x01;
+	data[2] = 0x00;
+	data[3] = 0x00;
+	data[4] = 0x00;
+	data[5] = (index >> 24) & 0xFF;
+	data[6] = (index >> 16) & 0xFF;
+	data[7] = (index >> 8) & 0xFF;
+	data[8] = index & 0xFF;
+	rtmpServerTest_sendBinary(test, publisher, 6, index * 100, RtmpMessageType_videoMessage, publisher->stream_id, data, sizeof(data));
+}
+
+static void rtmpServerTest() {
+	LOG_PRINT("rtmpServerTest");
+	rtmpServerTest_t test;
+	memset(&test, 0, sizeof(test));
+	// small queue for slow player.
+	test.server = ttLibC_RtmpServer_make(4096, 256 * 1024);
+	ASSERT(ttLibC_RtmpServer_bind(test.server, 0));
+	ASSERT(test.server->port != 0);
+	rtmpServerTest_client_t *publisher = rtmpServerTest_connect(&test, true, 0);
+	rtmpServerTest_client_t *fast = rtmpServerTest_connect(&test, false, 0);
+	rtmpServerTest_client_t *slow = rtmpServerTest_connect(&test, false, 4096);
+	ASSERT(publisher->is_started);
+	ASSERT(fast->is_started);
+	ASSERT(slow->is_started);
+	ASSERT(test.server->publisher_num == 1);
+	ASSERT(test.server->subscriber_num == 2);
+
+	// meta and sequence headers.
+	ttLibC_Amf0DataMessage *meta = ttLibC_Amf0DataMessage_make("@setDataFrame");
+	ttLibC_Amf0MapObject meta_objects[] = {
+			{"width",  ttLibC_Amf0_number(32)},
+			{"height", ttLibC_Amf0_number(32)},
+			{NULL,     NULL}
+	};
+	meta->obj1 = ttLibC_Amf0_string("onMetaData");
+	meta->obj2 = ttLibC_Amf0_object(meta_objects);
+	meta->inherit_super.header->stream_id = publisher->stream_id;
+	rtmpServerTest_sendMessage(&test, publisher, (ttLibC_RtmpMessage *)meta);
+	ttLibC_Amf0DataMessage_close(&meta);
+	uint8_t avc_config[] = {0x17, 0x00, 0x00, 0x00, 0x00, 0x01, 0x42, 0x00, 0x1E, 0xFF, 0xE0, 0x00, 0x00, 0x01, 0x00, 0x00};
+	rtmpServerTest_sendBinary(&test, publisher, 6, 0, RtmpMessageType_videoMessage, publisher->stream_id, avc_config, sizeof(avc_config));
+	uint8_t aac_config[] = {0xAF, 0x00, 0x12, 0x10};
+	rtmpServerTest_sendBinary(&test, publisher, 7, 0, RtmpMessageType_audioMessage, publisher->stream_id, aac_config, sizeof(aac_config));
+
+	// slow player doesn't read until RTMPSERVERTEST_SLOW_RESUME.
+	slow->is_paused = true;
+	rtmpServerTest_client_t *late = NULL;
+	for(int32_t i = 0;i < RTMPSERVERTEST_FRAME_NUM;++ i) {
+		if(i == RTMPSERVERTEST_LATE_JOIN) {
+			late = rtmpServerTest_connect(&test, false, 0);
+			ASSERT(late->is_started);
+		}
+		if(i == RTMPSERVERTEST_SLOW_RESUME) {
+			slow->is_paused = false;
+		}
+		rtmpServerTest_sendVideo(&test, publisher, i);
+		rtmpServerTest_pump(&test);
+	}
+	for(int i = 0;i < 5000;++ i) {
+		if(fast->last_index == RTMPSERVERTEST_FRAME_NUM - 1
+		&& slow->last_index == RTMPSERVERTEST_FRAME_NUM - 1
+		&& late->last_index == RTMPSERVERTEST_FRAME_NUM - 1) {
+			break;
+		}
+		rtmpServerTest_pump(&test);
+	}
+	LOG_PRINT("encode:%llu drop:%llu fast:%u slow:%u(gap:%u) late:%u",
+			(unsigned long long)test.server->encode_count,
+			(unsigned long long)test.server->drop_count,
+			fast->media_num,
+			slow->media_num,
+			slow->gap_num,
+			late->media_num);
+	// fan-out, chunks are made once for each message.
+	ASSERT(fast->media_num == RTMPSERVERTEST_FRAME_NUM);
+	ASSERT(fast->gap_num == 0);
+	ASSERT(fast->is_config_first);
+	ASSERT(test.server->encode_count == RTMPSERVERTEST_FRAME_NUM + 3);
+	// late joiner gets cached meta and sequence headers, then starts from keyFrame.
+	ASSERT(late->is_config_first);
+	ASSERT(late->is_first_key);
+	ASSERT(late->first_index == RTMPSERVERTEST_LATE_JOIN);
+	ASSERT(late->media_num == RTMPSERVERTEST_FRAME_NUM - RTMPSERVERTEST_LATE_JOIN);
+	// slow player lost frames, and restart from keyFrame.
+	ASSERT(test.server->drop_count > 0);
+	ASSERT(slow->is_config_first);
+	ASSERT(slow->is_first_key);
+	ASSERT(slow->media_num < RTMPSERVERTEST_FRAME_NUM);
+	ASSERT(slow->gap_num > 0);
+	ASSERT(slow->bad_gap_num == 0);
+	ASSERT(slow->last_index == RTMPSERVERTEST_FRAME_NUM - 1);
+
+	for(int i = 0;i < test.client_num;++ i) {
+		close(test.clients[i].sock);
+	}
+	for(int i = 0;i < 5000 && test.server->client_num != 0;++ i) {
+		ttLibC_RtmpServer_update(test.server, 1000);
+	}
+	ASSERT(test.server->client_num == 0);
+	for(int i = 0;i < test.client_num;++ i) {
+		ttLibC_ClientObject_close(&test.clients[i].client_object);
+		ttLibC_DynamicBuffer_close(&test.clients[i].send_buffer);
+	}
+	ttLibC_RtmpServer_close(&test.server);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+#define RTMPAGGREGATETEST_FRAME_NUM 500
+
+typedef struct rtmpAggregateTest_t {
+	ttLibC_RtmpConnection *conn;
+	ttLibC_RtmpStream *stream;
+	bool is_started;
+	rtmpServerTest_t *server_test;
+	volatile bool is_running;
+} rtmpAggregateTest_t;
+
+/*
+ * connect and stream close of client wait for the reply, so server is updated on other thread for them.
+ */
+static void *rtmpAggregateTest_serve(void *ptr) {
+	rtmpAggregateTest_t *test = (rtmpAggregateTest_t *)ptr;
+	while(test->is_running) {
+		rtmpServerTest_pump(test->server_test);
+	}
+	return NULL;
+}
+
+static bool rtmpAggregateTest_onStatus(void *ptr, ttLibC_Amf0Object *amf0_obj) {
+	rtmpAggregateTest_t *test = (rtmpAggregateTest_t *)ptr;
+	ttLibC_Amf0Object *code = ttLibC_Amf0_getElement(amf0_obj, "code");
+	if(code == NULL) {
+		return true;
+	}
+	if(strcmp((const char *)code->object, "NetConnection.Connect.Success") == 0) {
+		test->stream = ttLibC_RtmpStream_make(test->conn);
+		ttLibC_RtmpStream_addEventListener(test->stream, rtmpAggregateTest_onStatus, test);
+		ttLibC_RtmpStream_publish(test->stream, "test");
+	}
+	else if(strcmp((const char *)code->object, "NetStream.Publish.Start") == 0) {
+		test->is_started = true;
+	}
+	return true;
+}
+
+/*
+ * publish with aggregate message, and check player gets original messages back.
+ */
+static void rtmpAggregateTest() {
+	LOG_PRINT("rtmpAggregateTest");
+	rtmpServerTest_t test;
+	memset(&test, 0, sizeof(test));
+	test.server = ttLibC_RtmpServer_make(4096, 0);
+	ASSERT(ttLibC_RtmpServer_bind(test.server, 0));
+	char address[256];
+	sprintf(address, "rtmp://127.0.0.1:%d/live", test.server->port);
+	rtmpAggregateTest_t publisher;
+	memset(&publisher, 0, sizeof(publisher));
+	publisher.server_test = &test;
+	publisher.is_running = true;
+	pthread_t thread;
+	pthread_create(&thread, NULL, rtmpAggregateTest_serve, &publisher);
+	publisher.conn = ttLibC_RtmpConnection_make();
+	ttLibC_RtmpConnection_addEventListener(publisher.conn, rtmpAggregateTest_onStatus, &publisher);
+	ASSERT(ttLibC_RtmpConnection_connect(publisher.conn, address));
+	for(int i = 0;i < 5000 && !publisher.is_started;++ i) {
+		ttLibC_RtmpConnection_update(publisher.conn, 1000);
+	}
+	publisher.is_running = false;
+	pthread_join(thread, NULL);
+	ASSERT(publisher.is_started);
+	rtmpServerTest_client_t *player = rtmpServerTest_connect(&test, false, 0);
+	ASSERT(player->is_started);
+
+	ttLibC_RtmpStream_setAggregate(publisher.stream, 100, 0);
+	uint8_t data[160];
+	memset(data, 0xD5, sizeof(data));
+	ttLibC_PcmAlaw *frame = NULL;
+	for(uint32_t i = 0;i < RTMPAGGREGATETEST_FRAME_NUM;++ i) {
+		data[0] = i & 0xFF;
+		data[1] = (i >> 8) & 0xFF;
+		frame = ttLibC_PcmAlaw_make(frame, 8000, 160, 1, data, sizeof(data), true, i * 20, 1000);
+		ASSERT(frame != NULL);
+		ASSERT(ttLibC_RtmpStream_addFrame(publisher.stream, (ttLibC_Frame *)frame));
+		ttLibC_RtmpConnection_update(publisher.conn, 0);
+		rtmpServerTest_pump(&test);
+	}
+	ttLibC_PcmAlaw_close(&frame);
+	// send held frames.
+	ttLibC_RtmpStream_setAggregate(publisher.stream, 0, 0);
+	for(int i = 0;i < 5000 && player->alaw_num < RTMPAGGREGATETEST_FRAME_NUM;++ i) {
+		ttLibC_RtmpConnection_update(publisher.conn, 1000);
+		rtmpServerTest_pump(&test);
+	}
+	LOG_PRINT("alaw:%u bad:%u", player->alaw_num, player->bad_alaw_num);
+	ASSERT(player->alaw_num == RTMPAGGREGATETEST_FRAME_NUM);
+	ASSERT(player->bad_alaw_num == 0);
+
+	publisher.is_running = true;
+	pthread_create(&thread, NULL, rtmpAggregateTest_serve, &publisher);
+	ttLibC_RtmpStream_close(&publisher.stream);
+	ttLibC_RtmpConnection_close(&publisher.conn);
+	publisher.is_running = false;
+	pthread_join(thread, NULL);
+
+	close(player->sock);
+	for(int i = 0;i < 5000 && test.server->client_num != 0;++ i) {
+		ttLibC_RtmpServer_update(test.server, 1000);
+	}
+	ASSERT(test.server->client_num == 0);
+	ttLibC_ClientObject_close(&player->client_object);
+	ttLibC_DynamicBuffer_close(&player->send_buffer);
+	ttLibC_RtmpServer_close(&test.server);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
 
 static bool websocketClientTest_onopen(ttLibC_WebSocketEvent *event) {
 	ttLibC_WebSocket_sendText(event->target, "hogehoge");
@@ -133,6 +674,388 @@ static bool websocketClientTest_onmessage(ttLibC_WebSocketEvent *event) {
 
 #include <ttLibC/util/ioUtil.h>
 
+static void websocketMaskTest() {
+	LOG_PRINT("websocketMaskTest");
+	uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+	uint8_t src[300];
+	uint8_t dst[320];
+	for(int i = 0;i < 300;++ i) {
+		src[i] = (uint8_t)(i * 7 + 3);
+	}
+	// try unaligned head, odd size and split offset.
+	for(int align = 0;align < 16;++ align) {
+		for(int size = 0;size < 300 - align;size += 13) {
+			for(int offset = 0;offset < 4;++ offset) {
+				ttLibC_WebSocket_mask(dst + align, src + align, size, mask, offset);
+				for(int i = 0;i < size;++ i) {
+					ASSERT(dst[align + i] == (src[align + i] ^ mask[(offset + i) & 3]));
+				}
+				// in place unmask gives original data.
+				ttLibC_WebSocket_mask(dst + align, dst + align, size, mask, offset);
+				ASSERT(memcmp(dst + align, src + align, size) == 0);
+			}
+		}
+	}
+	// dst on 16byte alignment but not on 32byte. (for -mavx2 build)
+	alignas(32) uint8_t aligned[320];
+	uint8_t *target = aligned + 16;
+	for(int shift = 0;shift < 4;++ shift) {
+		size_t size = 256 + shift;
+		ttLibC_WebSocket_mask(target, src + shift, size, mask, shift);
+		for(size_t i = 0;i < size;++ i) {
+			ASSERT(target[i] == (src[shift + i] ^ mask[(shift + i) & 3]));
+		}
+	}
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+/*
+ * loopback server for websocketChunkTest.
+ * send prepared frames in split pieces, then parse frames from client.
+ */
+typedef struct websocketChunkTest_frame_t {
+	bool is_fin;
+	bool is_masked;
+	uint8_t opcode;
+	/** 7bit length field. 126:16bit 127:64bit */
+	uint8_t length_code;
+	uint64_t size;
+} websocketChunkTest_frame_t;
+
+typedef struct websocketChunkTest_server_t {
+	int listen_sock;
+	uint8_t send_data[512];
+	size_t send_size;
+	size_t splits[16];
+	int split_num;
+	websocketChunkTest_frame_t frames[16];
+	int frame_num;
+	uint8_t recv_payload[150000];
+	volatile size_t recv_payload_size;
+} websocketChunkTest_server_t;
+
+typedef struct websocketChunkTest_client_t {
+	bool is_open;
+	uint8_t text[512];
+	size_t text_size;
+	int text_slices;
+	int text_last_count;
+	size_t text_last_size;
+	uint8_t binary[64];
+	size_t binary_size;
+	int binary_last_count;
+	/** data after is_last. */
+	bool is_overrun;
+} websocketChunkTest_client_t;
+
+typedef struct websocketChunkTest_producer_t {
+	size_t total;
+	size_t pos;
+	websocketChunkTest_server_t *server;
+	/** payload size received by server before this message. */
+	size_t base;
+	/** max payload size which is not reached to server on producer call. */
+	size_t max_pending;
+} websocketChunkTest_producer_t;
+
+static size_t websocketChunkTest_appendFrame(
+		uint8_t *buf,
+		uint8_t first_byte,
+		uint8_t *data,
+		size_t size,
+		const uint8_t *mask) {
+	size_t pos = 0;
+	buf[pos ++] = first_byte;
+	if(size < 126) {
+		buf[pos ++] = 0x80 | size;
+	}
+	else {
+		buf[pos ++] = 0x80 | 126;
+		buf[pos ++] = (size >> 8) & 0xFF;
+		buf[pos ++] = size & 0xFF;
+	}
+	memcpy(buf + pos, mask, 4);
+	pos += 4;
+	for(size_t i = 0;i < size;++ i) {
+		buf[pos ++] = data[i] ^ mask[i & 3];
+	}
+	return pos;
+}
+
+static void *websocketChunkTest_serve(void *arg) {
+	websocketChunkTest_server_t *server = (websocketChunkTest_server_t *)arg;
+	int sock = accept(server->listen_sock, NULL, NULL);
+	if(sock < 0) {
+		return NULL;
+	}
+	int flag = 1;
+	setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+	// handshake, any response is accepted by client.
+	char request[1024];
+	size_t request_size = 0;
+	while(request_size < sizeof(request) - 1) {
+		ssize_t size = recv(sock, request + request_size, sizeof(request) - 1 - request_size, 0);
+		if(size <= 0) {
+			close(sock);
+			return NULL;
+		}
+		request_size += size;
+		request[request_size] = 0;
+		if(strstr(request, "\r\n\r\n") != NULL) {
+			break;
+		}
+	}
+	const char *response = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n\r\n";
+	send(sock, response, strlen(response), 0);
+	// client drops the data which comes with handshake response, wait a little.
+	usleep(100000);
+	size_t pos = 0;
+	for(int i = 0;i <= server->split_num;++ i) {
+		size_t end = i < server->split_num ? server->splits[i] : server->send_size;
+		send(sock, server->send_data + pos, end - pos, 0);
+		pos = end;
+		usleep(20000);
+	}
+	// parse frames from client, until client close.
+	static uint8_t buf[200000];
+	size_t buf_size = 0;
+	while(true) {
+		ssize_t size = recv(sock, buf + buf_size, sizeof(buf) - buf_size, 0);
+		if(size <= 0) {
+			break;
+		}
+		buf_size += size;
+		while(buf_size >= 2) {
+			websocketChunkTest_frame_t frame;
+			frame.is_fin = (buf[0] & 0x80) != 0;
+			frame.opcode = buf[0] & 0x0F;
+			frame.is_masked = (buf[1] & 0x80) != 0;
+			frame.length_code = buf[1] & 0x7F;
+			size_t header_size = 2 + (frame.is_masked ? 4 : 0);
+			if(frame.length_code == 126) {
+				header_size += 2;
+			}
+			else if(frame.length_code == 127) {
+				header_size += 8;
+			}
+			if(buf_size < header_size) {
+				break;
+			}
+			frame.size = frame.length_code;
+			if(frame.length_code == 126) {
+				frame.size = (buf[2] << 8) | buf[3];
+			}
+			else if(frame.length_code == 127) {
+				frame.size = 0;
+				for(int j = 0;j < 8;++ j) {
+					frame.size = (frame.size << 8) | buf[2 + j];
+				}
+			}
+			if(buf_size < header_size + frame.size) {
+				break;
+			}
+			uint8_t *mask = buf + header_size - 4;
+			for(uint64_t j = 0;j < frame.size && server->recv_payload_size < sizeof(server->recv_payload);++ j) {
+				server->recv_payload[server->recv_payload_size ++] = buf[header_size + j] ^ (frame.is_masked ? mask[j & 3] : 0);
+			}
+			if(server->frame_num < 16) {
+				server->frames[server->frame_num ++] = frame;
+			}
+			buf_size -= header_size + frame.size;
+			memmove(buf, buf + header_size + frame.size, buf_size);
+		}
+	}
+	close(sock);
+	return NULL;
+}
+
+static bool websocketChunkTest_onopen(ttLibC_WebSocketEvent *event) {
+	websocketChunkTest_client_t *client = (websocketChunkTest_client_t *)event->target->ptr;
+	client->is_open = true;
+	return true;
+}
+
+static bool websocketChunkTest_onmessagechunk(ttLibC_WebSocketEvent *event) {
+	websocketChunkTest_client_t *client = (websocketChunkTest_client_t *)event->target->ptr;
+	if(event->type == WebSocketOpcode_text) {
+		if(client->text_last_count != 0
+		|| client->text_size + event->data_size > sizeof(client->text)) {
+			client->is_overrun = true;
+			return true;
+		}
+		memcpy(client->text + client->text_size, event->data, event->data_size);
+		client->text_size += event->data_size;
+		++ client->text_slices;
+		if(event->is_last) {
+			++ client->text_last_count;
+			client->text_last_size = event->data_size;
+		}
+	}
+	else if(event->type == WebSocketOpcode_binary) {
+		if(client->binary_last_count != 0
+		|| client->binary_size + event->data_size > sizeof(client->binary)) {
+			client->is_overrun = true;
+			return true;
+		}
+		memcpy(client->binary + client->binary_size, event->data, event->data_size);
+		client->binary_size += event->data_size;
+		if(event->is_last) {
+			++ client->binary_last_count;
+		}
+	}
+	return true;
+}
+
+static size_t websocketChunkTest_produce(void *ptr, void *buffer, size_t buffer_size) {
+	websocketChunkTest_producer_t *producer = (websocketChunkTest_producer_t *)ptr;
+	// previous frames should be on the wire already, wait for server to get them.
+	size_t sent = producer->base + producer->pos;
+	for(int i = 0;i < 100 && producer->server->recv_payload_size < sent;++ i) {
+		usleep(10000);
+	}
+	if(sent - producer->server->recv_payload_size > producer->max_pending) {
+		producer->max_pending = sent - producer->server->recv_payload_size;
+	}
+	size_t size = producer->total - producer->pos;
+	if(size > buffer_size) {
+		size = buffer_size;
+	}
+	uint8_t *u8 = (uint8_t *)buffer;
+	for(size_t i = 0;i < size;++ i) {
+		u8[i] = 'a' + (producer->pos + i) % 26;
+	}
+	producer->pos += size;
+	return size;
+}
+
+static void websocketChunkTest() {
+	LOG_PRINT("websocketChunkTest");
+	static websocketChunkTest_server_t server;
+	memset(&server, 0, sizeof(server));
+	// text message in 3 masked frames (7bit length, 16bit length, empty fin continuation),
+	// then binary message in single frame.
+	uint8_t text[337];
+	for(size_t i = 0;i < sizeof(text);++ i) {
+		text[i] = 'A' + (i * 7) % 26;
+	}
+	uint8_t binary[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+	const uint8_t mask1[4] = {0x01, 0x02, 0x03, 0x04};
+	const uint8_t mask2[4] = {0xA5, 0x5A, 0xC3, 0x3C};
+	const uint8_t mask3[4] = {0x11, 0x22, 0x33, 0x44};
+	const uint8_t mask4[4] = {0xF0, 0x0F, 0x99, 0x66};
+	size_t frame1 = 0;
+	server.send_size += websocketChunkTest_appendFrame(server.send_data + server.send_size, WebSocketOpcode_text, text, 37, mask1);
+	size_t frame2 = server.send_size;
+	server.send_size += websocketChunkTest_appendFrame(server.send_data + server.send_size, WebSocketOpcode_continue, text + 37, 300, mask2);
+	size_t frame3 = server.send_size;
+	server.send_size += websocketChunkTest_appendFrame(server.send_data + server.send_size, 0x80 | WebSocketOpcode_continue, NULL, 0, mask3);
+	size_t frame4 = server.send_size;
+	server.send_size += websocketChunkTest_appendFrame(server.send_data + server.send_size, 0x80 | WebSocketOpcode_binary, binary, 10, mask4);
+	// split inside header, inside mask key, and at payload position which is not multiple of 4.
+	size_t splits[] = {
+		frame1 + 1, frame1 + 4, frame1 + 6 + 5, frame1 + 6 + 18,
+		frame2 + 2, frame2 + 6, frame2 + 8 + 7, frame2 + 8 + 150,
+		frame3 + 3,
+		frame4 + 6 + 1
+	};
+	server.split_num = sizeof(splits) / sizeof(splits[0]);
+	memcpy(server.splits, splits, sizeof(splits));
+
+	server.listen_sock = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	ASSERT(bind(server.listen_sock, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+	socklen_t addr_len = sizeof(addr);
+	getsockname(server.listen_sock, (struct sockaddr *)&addr, &addr_len);
+	listen(server.listen_sock, 1);
+	pthread_t thread;
+	pthread_create(&thread, NULL, websocketChunkTest_serve, &server);
+
+	char address[256];
+	sprintf(address, "ws://127.0.0.1:%d/chunk", ntohs(addr.sin_port));
+	websocketChunkTest_client_t result;
+	memset(&result, 0, sizeof(result));
+	ttLibC_WebSocket *client = ttLibC_WebSocket_make(address);
+	client->ptr = &result;
+	client->onopen = websocketChunkTest_onopen;
+	client->onmessagechunk = websocketChunkTest_onmessagechunk;
+	for(int i = 0;i < 300 && result.binary_last_count == 0;++ i) {
+		if(!ttLibC_WebSocket_update(client, 10000)) {
+			break;
+		}
+	}
+	ASSERT(result.is_open);
+	ASSERT(!result.is_overrun);
+	ASSERT(result.text_size == sizeof(text));
+	ASSERT(memcmp(result.text, text, sizeof(text)) == 0);
+	// split data is given as it arrives, and empty fin continuation gives is_last.
+	ASSERT(result.text_slices > 4);
+	ASSERT(result.text_last_count == 1);
+	ASSERT(result.text_last_size == 0);
+	ASSERT(result.binary_size == sizeof(binary));
+	ASSERT(memcmp(result.binary, binary, sizeof(binary)) == 0);
+	ASSERT(result.binary_last_count == 1);
+
+	// send stream, check frame headers on server side.
+	// each frame is flushed before next producer call, nothing is pending.
+	websocketChunkTest_producer_t producer;
+	memset(&producer, 0, sizeof(producer));
+	producer.server = &server;
+	producer.total = 250;
+	ASSERT(ttLibC_WebSocket_sendStream(client, WebSocketOpcode_binary, 100, websocketChunkTest_produce, &producer));
+	producer.base += producer.total;
+	producer.total = 70000;
+	producer.pos = 0;
+	ASSERT(ttLibC_WebSocket_sendStream(client, WebSocketOpcode_text, 0, websocketChunkTest_produce, &producer));
+	producer.base += producer.total;
+	producer.total = 65535;
+	producer.pos = 0;
+	ASSERT(ttLibC_WebSocket_sendStream(client, WebSocketOpcode_binary, 65535, websocketChunkTest_produce, &producer));
+	ASSERT(producer.max_pending == 0);
+	ttLibC_WebSocket_update(client, 10000);
+	ttLibC_WebSocket_close(&client);
+	pthread_join(thread, NULL);
+	close(server.listen_sock);
+
+	websocketChunkTest_frame_t expect[] = {
+		{false, true, WebSocketOpcode_binary,   100, 100},
+		{false, true, WebSocketOpcode_continue, 100, 100},
+		{false, true, WebSocketOpcode_continue, 50,  50},
+		{true,  true, WebSocketOpcode_continue, 0,   0},
+		{false, true, WebSocketOpcode_text,     127, 65536},
+		{false, true, WebSocketOpcode_continue, 126, 4464},
+		{true,  true, WebSocketOpcode_continue, 0,   0},
+		{false, true, WebSocketOpcode_binary,   126, 65535},
+		{true,  true, WebSocketOpcode_continue, 0,   0}
+	};
+	int expect_num = sizeof(expect) / sizeof(expect[0]);
+	ASSERT(server.frame_num == expect_num);
+	for(int i = 0;i < expect_num && i < server.frame_num;++ i) {
+		ASSERT(server.frames[i].is_fin == expect[i].is_fin);
+		ASSERT(server.frames[i].is_masked == expect[i].is_masked);
+		ASSERT(server.frames[i].opcode == expect[i].opcode);
+		ASSERT(server.frames[i].length_code == expect[i].length_code);
+		ASSERT(server.frames[i].size == expect[i].size);
+	}
+	// unmasked payload is the produced data.
+	ASSERT(server.recv_payload_size == 250 + 70000 + 65535);
+	size_t totals[] = {250, 70000, 65535};
+	size_t pos = 0;
+	bool is_match = true;
+	for(int i = 0;i < 3;++ i) {
+		for(size_t j = 0;j < totals[i];++ j) {
+			if(server.recv_payload[pos ++] != 'a' + j % 26) {
+				is_match = false;
+			}
+		}
+	}
+	ASSERT(is_match);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
 static void websocketClientTest() {
 	LOG_PRINT("websocketClientTest");
 	// connect
@@ -754,6 +1677,10 @@ cute::suite netTests(cute::suite s) {
 #ifdef __ENABLE_SOCKET__
 	s.push_back(CUTE(tetty2ClientTest));
 	s.push_back(CUTE(tetty2ServerTest));
+	s.push_back(CUTE(rtmpServerTest));
+	s.push_back(CUTE(rtmpAggregateTest));
+	s.push_back(CUTE(websocketMaskTest));
+	s.push_back(CUTE(websocketChunkTest));
 	s.push_back(CUTE(websocketClientTest));
 	s.push_back(CUTE(udpTettyServerTest));
 	s.push_back(CUTE(udpClientTest));
@@ -0,0 +1,1435 @@
+/**
+ * @file   ttLibCBench.cpp
+ * @brief  benchmark for hot paths of ttLibC.
+ *
+ * this code is under GPLv3 license.
+ *
+ * usage:
+ *   ./ttLibCBench [-t msec] [-o output.json] [filter ...]
+ *   -t      minimum time for each bench in mili sec.(default 200)
+ *   -o      write result json on file, instead of stdout.
+ *   filter  run only the bench which name contains filter.
+ *
+ * all inputs are made in this program and containerTestUtil (h264 nal, adts, mp3, beep tone, synthetic yuv),
+ * so no media file is needed, and the result is comparable between builds.
+ * result is json, with ns/op, MB/s, allocations/op and write syscalls/op for each bench.
+ * allocations are counted by ttLibC_Allocator_refAllocCount, debug table is not used,
+ * so that threaded bench is safe and fast.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include <ttLibC/allocator.h>
+#include <ttLibC/frame/frame.h>
+#include <ttLibC/frame/video/h264.h>
+#include <ttLibC/frame/video/yuv420.h>
+#include <ttLibC/frame/video/bgr.h>
+#include <ttLibC/frame/audio/aac.h>
+#include <ttLibC/frame/audio/mp3.h>
+#include <ttLibC/frame/audio/pcms16.h>
+#include <ttLibC/frame/audio/pcmf32.h>
+#include <ttLibC/frame/audio/pcmAlaw.h>
+
+#include <ttLibC/container/container.h>
+#include <ttLibC/container/flv.h>
+#include <ttLibC/container/mkv.h>
+#include <ttLibC/container/mp3.h>
+#include <ttLibC/container/mp4.h>
+#include <ttLibC/container/mpegts.h>
+
+#include <ttLibC/resampler/imageResizer.h>
+#include <ttLibC/resampler/imageResampler.h>
+#include <ttLibC/resampler/audioResampler.h>
+#include <ttLibC/resampler/polyphaseResampler.h>
+
+#include <ttLibC/util/beepUtil.h>
+#include <ttLibC/util/crc32Util.h>
+#include <ttLibC/util/amfUtil.h>
+#include <ttLibC/util/dynamicBufferUtil.h>
+
+#include "containerTestUtil.h"
+
+#ifdef __ENABLE_SOCKET__
+#	include <ttLibC/net/client/rtmp.h>
+#	include <ttLibC/net/server/rtmp.h>
+#	include <ttLibC/net/client/websocket.h>
+#	include <ttLibC/net/client/rtmp2/data/clientObject.h>
+#	include <ttLibC/net/client/rtmp2/message/rtmpMessage.h>
+#	include <ttLibC/net/client/rtmp2/message/videoMessage.h>
+#	include <sys/socket.h>
+#	include <sys/wait.h>
+#	include <signal.h>
+#endif
+
+#ifdef __ENABLE_JPEG__
+#	include <ttLibC/encoder/jpegEncoder.h>
+#	include <ttLibC/util/thumbnailUtil.h>
+#endif
+
+#if defined(__ENABLE_AVCODEC__) && defined(__ENABLE_X264__)
+#	include <ttLibC/encoder/x264Encoder.h>
+#	include <ttLibC/decoder/avcodecDecoder.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * result of one op.
+ */
+typedef struct {
+	/** processed bytes of this op, for MB/s. */
+	uint64_t size;
+	/** additional json members for this bench. ex: "\"frames_per_sec\":30.0" */
+	char extra[256];
+} Bench_Op;
+
+/**
+ * one op of bench.
+ * @param ptr user def pointer.
+ * @param op  result of op.
+ * @return true:success false:error
+ */
+typedef bool (* Bench_Func)(void *ptr, Bench_Op *op);
+
+static uint64_t bench_time  = 200000000; // nano sec
+static int      filter_num  = 0;
+static char   **filters     = NULL;
+static FILE    *output      = NULL;
+static int      result_num  = 0;
+
+static uint64_t Bench_now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * ref write syscall count and written bytes from /proc/self/io.
+ * @return false if /proc/self/io is not available.
+ */
+static bool Bench_refIo(uint64_t *syscw, uint64_t *wchar) {
+	FILE *fp = fopen("/proc/self/io", "r");
+	if(fp == NULL) {
+		return false;
+	}
+	char key[64];
+	unsigned long long value;
+	while(fscanf(fp, "%63s %llu", key, &value) == 2) {
+		if(strcmp(key, "syscw:") == 0) {
+			*syscw = value;
+		}
+		else if(strcmp(key, "wchar:") == 0) {
+			*wchar = value;
+		}
+	}
+	fclose(fp);
+	return true;
+}
+
+static bool Bench_isTarget(const char *name) {
+	if(filter_num == 0) {
+		return true;
+	}
+	for(int i = 0;i < filter_num;++ i) {
+		if(strstr(name, filters[i]) != NULL) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * run bench, op is repeated until bench_time.
+ * @param name   name of bench.
+ * @param params json members for condition. ex: "\"width\":1280". can be NULL.
+ * @param func   op function.
+ * @param ptr    user def pointer for func.
+ */
+static void Bench_run(
+		const char *name,
+		const char *params,
+		Bench_Func func,
+		void *ptr) {
+	if(!Bench_isTarget(name)) {
+		return;
+	}
+	Bench_Op op;
+	op.size = 0;
+	op.extra[0] = 0;
+	// warm up.
+	bool result = func(ptr, &op);
+	uint64_t op_num = 0;
+	uint64_t size = 0;
+	uint64_t alloc_count = ttLibC_Allocator_refAllocCount();
+	uint64_t syscw_start = 0, wchar_start = 0, syscw_end = 0, wchar_end = 0;
+	bool has_io = Bench_refIo(&syscw_start, &wchar_start);
+	uint64_t start = Bench_now();
+	uint64_t elapsed = 0;
+	while(result && elapsed < bench_time) {
+		op.size = 0;
+		result = func(ptr, &op);
+		size += op.size;
+		++ op_num;
+		elapsed = Bench_now() - start;
+	}
+	alloc_count = ttLibC_Allocator_refAllocCount() - alloc_count;
+	if(has_io) {
+		// fopen of /proc/self/io itself does not write.
+		Bench_refIo(&syscw_end, &wchar_end);
+	}
+	fprintf(output, "%s\n    {\"name\":\"%s\"", result_num == 0 ? "" : ",", name);
+	if(params != NULL) {
+		fprintf(output, ",%s", params);
+	}
+	if(!result || op_num == 0) {
+		fprintf(output, ",\"error\":true}");
+		fprintf(stderr, "%-40s error\n", name);
+		++ result_num;
+		return;
+	}
+	double ns_per_op    = (double)elapsed / op_num;
+	double mb_per_sec   = size * 1000.0 / elapsed;
+	double alloc_per_op = (double)alloc_count / op_num;
+	fprintf(output, ",\"op_num\":%llu,\"ns_per_op\":%.1f,\"mb_per_sec\":%.3f,\"alloc_per_op\":%.2f",
+			(unsigned long long)op_num, ns_per_op, mb_per_sec, alloc_per_op);
+	if(has_io) {
+		fprintf(output, ",\"syscw_per_op\":%.3f,\"wchar_per_op\":%.1f",
+				(double)(syscw_end - syscw_start) / op_num,
+				(double)(wchar_end - wchar_start) / op_num);
+	}
+	if(op.extra[0] != 0) {
+		fprintf(output, ",%s", op.extra);
+	}
+	fprintf(output, "}");
+	fflush(output);
+	fprintf(stderr, "%-40s %14.1f ns/op %10.3f MB/s %8.2f alloc/op\n", name, ns_per_op, mb_per_sec, alloc_per_op);
+	++ result_num;
+}
+
+/*
+ * xorshift, same sequence for every run.
+ */
+static uint32_t Bench_random(uint32_t *state) {
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return x;
+}
+
+/*
+ * fill nal payload, without 00 for avoiding start code emulation.
+ */
+static void Bench_fillPayload(uint8_t *data, size_t size, uint32_t *state) {
+	for(size_t i = 0;i < size;++ i) {
+		data[i] = (uint8_t)(Bench_random(state) % 255 + 1);
+	}
+}
+
+/*
+ * make synthetic yuv420 planar, gradient with moving offset.
+ */
+static ttLibC_Yuv420 *Bench_makeYuv(
+		ttLibC_Yuv420 *prev_frame,
+		uint32_t width,
+		uint32_t height,
+		uint32_t pos) {
+	ttLibC_Yuv420 *yuv = ttLibC_Yuv420_makeEmptyFrame2(prev_frame, Yuv420Type_planar, width, height);
+	if(yuv == NULL) {
+		return NULL;
+	}
+	for(uint32_t y = 0;y < height;++ y) {
+		uint8_t *line = yuv->y_data + y * yuv->y_stride;
+		for(uint32_t x = 0;x < width;++ x) {
+			line[x] = (uint8_t)(16 + ((x + y + pos) * 219 / (width + height)) % 220);
+		}
+	}
+	for(uint32_t y = 0;y < height / 2;++ y) {
+		uint8_t *u_line = yuv->u_data + y * yuv->u_stride;
+		uint8_t *v_line = yuv->v_data + y * yuv->v_stride;
+		for(uint32_t x = 0;x < width / 2;++ x) {
+			u_line[x] = (uint8_t)(64 + (x * 128 / width));
+			v_line[x] = (uint8_t)(64 + (y * 128 / height));
+		}
+	}
+	yuv->inherit_super.inherit_super.pts = pos;
+	yuv->inherit_super.inherit_super.timebase = 1000;
+	return yuv;
+}
+
+// -------------------------------------------------------------- //
+// h264
+
+typedef struct {
+	uint8_t *data;
+	size_t data_size;
+} H264Bench_t;
+
+/*
+ * start code and nal header of the test nal, random payload follows.
+ */
+#define H264Bench_headerSize 7
+
+/*
+ * make annexB stream, sps pps idr and slices with random size.
+ */
+static void H264Bench_makeStream(ttLibC_DynamicBuffer *buffer, uint32_t frame_num, uint32_t idr_size, uint32_t slice_size) {
+	uint32_t state = 0x12345678;
+	uint8_t *payload = (uint8_t *)malloc((idr_size > slice_size ? idr_size : slice_size) * 2);
+	for(uint32_t i = 0;i < frame_num;++ i) {
+		if(i % 30 == 0) {
+			ttLibC_DynamicBuffer_append(buffer, (uint8_t *)containerTest_h264Config, sizeof(containerTest_h264Config));
+			ttLibC_DynamicBuffer_append(buffer, (uint8_t *)containerTest_h264Idr, H264Bench_headerSize);
+			size_t size = idr_size / 2 + Bench_random(&state) % idr_size;
+			Bench_fillPayload(payload, size, &state);
+			ttLibC_DynamicBuffer_append(buffer, payload, size);
+		}
+		else {
+			ttLibC_DynamicBuffer_append(buffer, (uint8_t *)containerTest_h264Slice, H264Bench_headerSize);
+			size_t size = slice_size / 2 + Bench_random(&state) % slice_size;
+			Bench_fillPayload(payload, size, &state);
+			ttLibC_DynamicBuffer_append(buffer, payload, size);
+		}
+	}
+	free(payload);
+}
+
+static bool H264Bench_getNalInfo(void *ptr, Bench_Op *op) {
+	H264Bench_t *bench = (H264Bench_t *)ptr;
+	uint8_t *data = bench->data;
+	size_t data_size = bench->data_size;
+	ttLibC_H264_NalInfo nal_info;
+	uint32_t nal_num = 0;
+	while(ttLibC_H264_getNalInfo(&nal_info, data, data_size)) {
+		if(nal_info.nal_size == 0) {
+			break;
+		}
+		data += nal_info.nal_size;
+		data_size -= nal_info.nal_size;
+		++ nal_num;
+	}
+	op->size = bench->data_size;
+	sprintf(op->extra, "\"nal_num\":%u", nal_num);
+	return true;
+}
+
+static void h264Bench() {
+	ttLibC_DynamicBuffer *buffer = ttLibC_DynamicBuffer_make();
+	H264Bench_makeStream(buffer, 300, 20000, 3000);
+	H264Bench_t bench;
+	bench.data      = ttLibC_DynamicBuffer_refData(buffer);
+	bench.data_size = ttLibC_DynamicBuffer_refSize(buffer);
+	Bench_run("h264.getNalInfo", NULL, H264Bench_getNalInfo, &bench);
+	ttLibC_DynamicBuffer_close(&buffer);
+}
+
+// -------------------------------------------------------------- //
+// container
+
+/*
+ * unit of synthetic media.
+ */
+typedef struct {
+	ttLibC_Frame_Type type;
+	uint64_t pts;
+	uint32_t timebase;
+	size_t offset;
+	size_t size;
+} ContainerBench_Unit;
+
+typedef struct {
+	ttLibC_Container_Type type;
+	ttLibC_Frame_Type audio_type;
+	uint32_t track_base;
+	/** binary for units. */
+	ttLibC_DynamicBuffer *source;
+	ContainerBench_Unit *units;
+	uint32_t unit_num;
+	/** written container. */
+	ttLibC_DynamicBuffer *output;
+	uint32_t frame_num;
+} ContainerBench_t;
+
+/*
+ * make 10 sec of h264 25fps (gop 50) and aac or mp3 units.
+ */
+static void ContainerBench_makeSource(ContainerBench_t *bench) {
+	uint32_t state = 0x2468ACE0;
+	uint8_t payload[16000];
+	bench->source = ttLibC_DynamicBuffer_make();
+	bench->units = (ContainerBench_Unit *)malloc(sizeof(ContainerBench_Unit) * 2000);
+	bench->unit_num = 0;
+	uint64_t audio_pts = 0;
+	uint32_t audio_timebase = 44100;
+	uint32_t audio_duration = bench->audio_type == frameType_aac ? 1024 : 1152;
+	for(uint32_t i = 0;i < 250;++ i) {
+		uint64_t pts = i * 40;
+		if(bench->type != containerType_mp3) {
+			ContainerBench_Unit *unit = &bench->units[bench->unit_num ++];
+			unit->type     = frameType_h264;
+			unit->pts      = pts;
+			unit->timebase = 1000;
+			unit->offset   = ttLibC_DynamicBuffer_refSize(bench->source);
+			size_t size;
+			if(i % 50 == 0) {
+				ttLibC_DynamicBuffer_append(bench->source, (uint8_t *)containerTest_h264Config, sizeof(containerTest_h264Config));
+				unit->size = sizeof(containerTest_h264Config);
+				unit = &bench->units[bench->unit_num ++];
+				unit->type     = frameType_h264;
+				unit->pts      = pts;
+				unit->timebase = 1000;
+				unit->offset   = ttLibC_DynamicBuffer_refSize(bench->source);
+				ttLibC_DynamicBuffer_append(bench->source, (uint8_t *)containerTest_h264Idr, H264Bench_headerSize);
+				size = 8000 + Bench_random(&state) % 8000;
+				unit->size = H264Bench_headerSize + size;
+			}
+			else {
+				ttLibC_DynamicBuffer_append(bench->source, (uint8_t *)containerTest_h264Slice, H264Bench_headerSize);
+				size = 500 + Bench_random(&state) % 2000;
+				unit->size = H264Bench_headerSize + size;
+			}
+			Bench_fillPayload(payload, size, &state);
+			ttLibC_DynamicBuffer_append(bench->source, payload, size);
+		}
+		while(audio_pts * 1000 / audio_timebase < pts + 40) {
+			ContainerBench_Unit *unit = &bench->units[bench->unit_num ++];
+			unit->type     = bench->audio_type;
+			unit->pts      = audio_pts;
+			unit->timebase = audio_timebase;
+			unit->offset   = ttLibC_DynamicBuffer_refSize(bench->source);
+			uint8_t header[7];
+			if(bench->audio_type == frameType_aac) {
+				// adts aac-lc 44100Hz stereo.
+				uint32_t frame_size = 300 + Bench_random(&state) % 100;
+				header[0] = 0xFF;
+				header[1] = 0xF1;
+				header[2] = 0x50;
+				header[3] = 0x80 | ((frame_size >> 11) & 0x03);
+				header[4] = (frame_size >> 3) & 0xFF;
+				header[5] = ((frame_size & 0x07) << 5) | 0x1F;
+				header[6] = 0xFC;
+				ttLibC_DynamicBuffer_append(bench->source, header, 7);
+				memset(payload, 0, frame_size - 7);
+				ttLibC_DynamicBuffer_append(bench->source, payload, frame_size - 7);
+				unit->size = frame_size;
+			}
+			else {
+				// mpeg1 layer3 128kbps 44100Hz, 417 bytes.
+				ttLibC_DynamicBuffer_append(bench->source, (uint8_t *)containerTest_mp3Header, sizeof(containerTest_mp3Header));
+				memset(payload, 0, 413);
+				ttLibC_DynamicBuffer_append(bench->source, payload, 413);
+				unit->size = 417;
+			}
+			audio_pts += audio_duration;
+		}
+	}
+}
+
+static ttLibC_ContainerWriter *ContainerBench_makeWriter(ContainerBench_t *bench) {
+	ttLibC_Frame_Type types[2] = {frameType_h264, bench->audio_type};
+	switch(bench->type) {
+	case containerType_flv:
+		return (ttLibC_ContainerWriter *)ttLibC_FlvWriter_make(types[0], types[1]);
+	case containerType_mkv:
+		return (ttLibC_ContainerWriter *)ttLibC_MkvWriter_make_ex(types, 2, 1000);
+	case containerType_mp3:
+		return (ttLibC_ContainerWriter *)ttLibC_Mp3Writer_make();
+	case containerType_mp4:
+		return (ttLibC_ContainerWriter *)ttLibC_Mp4Writer_make_ex(types, 2, 1000);
+	case containerType_mpegts:
+		return (ttLibC_ContainerWriter *)ttLibC_MpegtsWriter_make_ex(types, 2, 1000);
+	default:
+		return NULL;
+	}
+}
+
+static ttLibC_ContainerReader *ContainerBench_makeReader(ContainerBench_t *bench) {
+	switch(bench->type) {
+	case containerType_flv:
+		return (ttLibC_ContainerReader *)ttLibC_FlvReader_make();
+	case containerType_mkv:
+		return (ttLibC_ContainerReader *)ttLibC_MkvReader_make();
+	case containerType_mp3:
+		return (ttLibC_ContainerReader *)ttLibC_Mp3Reader_make();
+	case containerType_mp4:
+		return (ttLibC_ContainerReader *)ttLibC_Mp4Reader_make();
+	case containerType_mpegts:
+		return (ttLibC_ContainerReader *)ttLibC_MpegtsReader_make();
+	default:
+		return NULL;
+	}
+}
+
+static bool ContainerBench_writeCallback(void *ptr, void *data, size_t data_size) {
+	ContainerBench_t *bench = (ContainerBench_t *)ptr;
+	return ttLibC_DynamicBuffer_append(bench->output, (uint8_t *)data, data_size);
+}
+
+/*
+ * ContainerWriter_write does not dispatch yet, so call each writer.
+ */
+static bool ContainerBench_writeFrame(
+		ContainerBench_t *bench,
+		ttLibC_ContainerWriter *writer,
+		ttLibC_Frame *frame) {
+	switch(writer->type) {
+	case containerType_flv:
+		return ttLibC_FlvWriter_write((ttLibC_FlvWriter *)writer, frame, ContainerBench_writeCallback, bench);
+	case containerType_mkv:
+		return ttLibC_MkvWriter_write((ttLibC_MkvWriter *)writer, frame, ContainerBench_writeCallback, bench);
+	case containerType_mp3:
+		return ttLibC_Mp3Writer_write((ttLibC_Mp3Writer *)writer, frame, ContainerBench_writeCallback, bench);
+	case containerType_mp4:
+		return ttLibC_Mp4Writer_write((ttLibC_Mp4Writer *)writer, frame, ContainerBench_writeCallback, bench);
+	case containerType_mpegts:
+		return ttLibC_MpegtsWriter_write((ttLibC_MpegtsWriter *)writer, frame, ContainerBench_writeCallback, bench);
+	default:
+		return false;
+	}
+}
+
+/*
+ * write all units into container.
+ */
+static bool ContainerBench_write(void *ptr, Bench_Op *op) {
+	ContainerBench_t *bench = (ContainerBench_t *)ptr;
+	ttLibC_DynamicBuffer_empty(bench->output);
+	ttLibC_ContainerWriter *writer = ContainerBench_makeWriter(bench);
+	if(writer == NULL) {
+		return false;
+	}
+	uint8_t *data = ttLibC_DynamicBuffer_refData(bench->source);
+	ttLibC_H264 *h264 = NULL;
+	ttLibC_Audio *audio = NULL;
+	bool result = true;
+	for(uint32_t i = 0;result && i < bench->unit_num;++ i) {
+		ContainerBench_Unit *unit = &bench->units[i];
+		ttLibC_Frame *frame = NULL;
+		switch(unit->type) {
+		case frameType_h264:
+			h264 = ttLibC_H264_getFrame(h264, data + unit->offset, unit->size, true, unit->pts, unit->timebase);
+			frame = (ttLibC_Frame *)h264;
+			break;
+		case frameType_aac:
+			audio = (ttLibC_Audio *)ttLibC_Aac_getFrame((ttLibC_Aac *)audio, data + unit->offset, unit->size, true, unit->pts, unit->timebase);
+			frame = (ttLibC_Frame *)audio;
+			break;
+		case frameType_mp3:
+			audio = (ttLibC_Audio *)ttLibC_Mp3_getFrame((ttLibC_Mp3 *)audio, data + unit->offset, unit->size, true, unit->pts, unit->timebase);
+			frame = (ttLibC_Frame *)audio;
+			break;
+		default:
+			break;
+		}
+		if(frame == NULL) {
+			result = false;
+			break;
+		}
+		frame->id = bench->track_base + (ttLibC_Frame_isAudio(frame) && bench->type != containerType_mp3 ? 1 : 0);
+		result = ContainerBench_writeFrame(bench, writer, frame);
+	}
+	ttLibC_H264_close(&h264);
+	ttLibC_Frame_close((ttLibC_Frame **)&audio);
+	ttLibC_ContainerWriter_close(&writer);
+	op->size = ttLibC_DynamicBuffer_refSize(bench->output);
+	return result;
+}
+
+static bool ContainerBench_getFrameCallback(void *ptr, ttLibC_Frame *frame) {
+	(void)frame;
+	ContainerBench_t *bench = (ContainerBench_t *)ptr;
+	++ bench->frame_num;
+	return true;
+}
+
+static bool ContainerBench_readCallback(void *ptr, ttLibC_Container *container) {
+	return ttLibC_Container_getFrame(container, ContainerBench_getFrameCallback, ptr);
+}
+
+/*
+ * read written container and get all frames.
+ */
+static bool ContainerBench_read(void *ptr, Bench_Op *op) {
+	ContainerBench_t *bench = (ContainerBench_t *)ptr;
+	ttLibC_ContainerReader *reader = ContainerBench_makeReader(bench);
+	if(reader == NULL) {
+		return false;
+	}
+	bench->frame_num = 0;
+	bool result = ttLibC_ContainerReader_read(
+			reader,
+			ttLibC_DynamicBuffer_refData(bench->output),
+			ttLibC_DynamicBuffer_refSize(bench->output),
+			ContainerBench_readCallback,
+			bench);
+	ttLibC_ContainerReader_close(&reader);
+	op->size = ttLibC_DynamicBuffer_refSize(bench->output);
+	sprintf(op->extra, "\"frame_num\":%u", bench->frame_num);
+	return result && bench->frame_num > 0;
+}
+
+static void containerBench() {
+	struct {
+		const char *name;
+		ttLibC_Container_Type type;
+		ttLibC_Frame_Type audio_type;
+		uint32_t track_base;
+	} targets[] = {
+		{"flv",    containerType_flv,    frameType_aac, 1},
+		{"mkv",    containerType_mkv,    frameType_aac, 1},
+		{"mp3",    containerType_mp3,    frameType_mp3, 1},
+		{"mp4",    containerType_mp4,    frameType_aac, 1},
+		{"mpegts", containerType_mpegts, frameType_aac, 0x0100},
+	};
+	for(size_t i = 0;i < sizeof(targets) / sizeof(targets[0]);++ i) {
+		ContainerBench_t bench;
+		bench.type       = targets[i].type;
+		bench.audio_type = targets[i].audio_type;
+		bench.track_base = targets[i].track_base;
+		bench.output     = ttLibC_DynamicBuffer_make();
+		ContainerBench_makeSource(&bench);
+		char name[64];
+		sprintf(name, "container.%s.write", targets[i].name);
+		// reader bench use the output of writer.
+		Bench_Op op;
+		if(ContainerBench_write(&bench, &op)) {
+			Bench_run(name, NULL, ContainerBench_write, &bench);
+			sprintf(name, "container.%s.read", targets[i].name);
+			Bench_run(name, NULL, ContainerBench_read, &bench);
+		}
+		else {
+			fprintf(stderr, "failed to make %s data.\n", targets[i].name);
+		}
+		ttLibC_DynamicBuffer_close(&bench.output);
+		ttLibC_DynamicBuffer_close(&bench.source);
+		free(bench.units);
+	}
+}
+
+// -------------------------------------------------------------- //
+// image
+
+typedef struct {
+	ttLibC_Yuv420 *yuv;
+	ttLibC_Bgr *bgr;
+	ttLibC_Yuv420 *dst_yuv;
+	ttLibC_Bgr *dst_bgr;
+	uint32_t width;
+	uint32_t height;
+	bool is_quick;
+} ImageBench_t;
+
+static bool ImageBench_resizeYuv420(void *ptr, Bench_Op *op) {
+	ImageBench_t *bench = (ImageBench_t *)ptr;
+	ttLibC_Yuv420 *yuv = ttLibC_ImageResizer_resizeYuv420(bench->dst_yuv, Yuv420Type_planar, bench->width, bench->height, bench->yuv, bench->is_quick);
+	if(yuv == NULL) {
+		return false;
+	}
+	bench->dst_yuv = yuv;
+	op->size = bench->yuv->inherit_super.inherit_super.data_size;
+	return true;
+}
+
+static bool ImageBench_resizeBgr(void *ptr, Bench_Op *op) {
+	ImageBench_t *bench = (ImageBench_t *)ptr;
+	ttLibC_Bgr *bgr = ttLibC_ImageResizer_resizeBgr(bench->dst_bgr, BgrType_bgra, bench->width, bench->height, bench->bgr);
+	if(bgr == NULL) {
+		return false;
+	}
+	bench->dst_bgr = bgr;
+	op->size = bench->bgr->inherit_super.inherit_super.data_size;
+	return true;
+}
+
+static bool ImageBench_yuv420FromBgr(void *ptr, Bench_Op *op) {
+	ImageBench_t *bench = (ImageBench_t *)ptr;
+	ttLibC_Yuv420 *yuv = ttLibC_ImageResampler_makeYuv420FromBgr(bench->dst_yuv, Yuv420Type_planar, bench->bgr);
+	if(yuv == NULL) {
+		return false;
+	}
+	bench->dst_yuv = yuv;
+	op->size = bench->bgr->inherit_super.inherit_super.data_size;
+	return true;
+}
+
+static bool ImageBench_bgrFromYuv420(void *ptr, Bench_Op *op) {
+	ImageBench_t *bench = (ImageBench_t *)ptr;
+	ttLibC_Bgr *bgr = ttLibC_ImageResampler_makeBgrFromYuv420(bench->dst_bgr, BgrType_bgra, bench->yuv);
+	if(bgr == NULL) {
+		return false;
+	}
+	bench->dst_bgr = bgr;
+	op->size = bench->yuv->inherit_super.inherit_super.data_size;
+	return true;
+}
+
+static void ImageBench_clear(ImageBench_t *bench) {
+	ttLibC_Yuv420_close(&bench->dst_yuv);
+	ttLibC_Bgr_close(&bench->dst_bgr);
+}
+
+static void imageBench() {
+	ImageBench_t bench;
+	bench.yuv = Bench_makeYuv(NULL, 1280, 720, 0);
+	bench.bgr = ttLibC_ImageResampler_makeBgrFromYuv420(NULL, BgrType_bgra, bench.yuv);
+	bench.dst_yuv = NULL;
+	bench.dst_bgr = NULL;
+	bench.width  = 640;
+	bench.height = 360;
+	const char *params = "\"src\":\"1280x720\",\"dst\":\"640x360\"";
+	bench.is_quick = false;
+	Bench_run("imageResizer.yuv420", params, ImageBench_resizeYuv420, &bench);
+	ImageBench_clear(&bench);
+	bench.is_quick = true;
+	Bench_run("imageResizer.yuv420.quick", params, ImageBench_resizeYuv420, &bench);
+	ImageBench_clear(&bench);
+	Bench_run("imageResizer.bgra", params, ImageBench_resizeBgr, &bench);
+	ImageBench_clear(&bench);
+	params = "\"src\":\"1280x720\"";
+	Bench_run("imageResampler.yuv420FromBgra", params, ImageBench_yuv420FromBgr, &bench);
+	ImageBench_clear(&bench);
+	Bench_run("imageResampler.bgraFromYuv420", params, ImageBench_bgrFromYuv420, &bench);
+	ImageBench_clear(&bench);
+	ttLibC_Yuv420_close(&bench.yuv);
+	ttLibC_Bgr_close(&bench.bgr);
+}
+
+// -------------------------------------------------------------- //
+// audio
+
+typedef struct {
+	ttLibC_PcmS16 *pcms16;
+	ttLibC_PcmF32 *pcmf32;
+	ttLibC_Audio *dst;
+	ttLibC_PolyphaseResampler *resampler;
+} AudioBench_t;
+
+static bool AudioBench_s16ToF32(void *ptr, Bench_Op *op) {
+	AudioBench_t *bench = (AudioBench_t *)ptr;
+	ttLibC_PcmF32 *f32 = ttLibC_AudioResampler_makePcmF32FromPcmS16((ttLibC_PcmF32 *)bench->dst, PcmF32Type_interleave, bench->pcms16);
+	if(f32 == NULL) {
+		return false;
+	}
+	bench->dst = (ttLibC_Audio *)f32;
+	op->size = bench->pcms16->inherit_super.inherit_super.data_size;
+	return true;
+}
+
+static bool AudioBench_f32ToS16(void *ptr, Bench_Op *op) {
+	AudioBench_t *bench = (AudioBench_t *)ptr;
+	ttLibC_PcmS16 *s16 = ttLibC_AudioResampler_makePcmS16FromPcmF32((ttLibC_PcmS16 *)bench->dst, PcmS16Type_littleEndian, bench->pcmf32);
+	if(s16 == NULL) {
+		return false;
+	}
+	bench->dst = (ttLibC_Audio *)s16;
+	op->size = bench->pcmf32->inherit_super.inherit_super.data_size;
+	return true;
+}
+
+static bool AudioBench_convertFormat(void *ptr, Bench_Op *op) {
+	AudioBench_t *bench = (AudioBench_t *)ptr;
+	// stereo interleave -> mono planar big endian.
+	ttLibC_Audio *audio = ttLibC_AudioResampler_convertFormat(bench->dst, frameType_pcmS16, PcmS16Type_bigEndian_planar, 1, (ttLibC_Audio *)bench->pcms16);
+	if(audio == NULL) {
+		return false;
+	}
+	bench->dst = audio;
+	op->size = bench->pcms16->inherit_super.inherit_super.data_size;
+	return true;
+}
+
+static bool AudioBench_polyphase(void *ptr, Bench_Op *op) {
+	AudioBench_t *bench = (AudioBench_t *)ptr;
+	ttLibC_PcmS16 *s16 = ttLibC_PolyphaseResampler_resamplePcmS16(bench->resampler, (ttLibC_PcmS16 *)bench->dst, bench->pcms16);
+	if(s16 != NULL) {
+		bench->dst = (ttLibC_Audio *)s16;
+	}
+	op->size = bench->pcms16->inherit_super.inherit_super.data_size;
+	return true;
+}
+
+static void audioBench() {
+	ttLibC_BeepGenerator *generator = ttLibC_BeepGenerator_make(PcmS16Type_littleEndian, 440, 44100, 2);
+	AudioBench_t bench;
+	bench.pcms16 = ttLibC_BeepGenerator_makeBeepBySampleNum(generator, NULL, 1024);
+	bench.pcmf32 = ttLibC_AudioResampler_makePcmF32FromPcmS16(NULL, PcmF32Type_interleave, bench.pcms16);
+	bench.dst = NULL;
+	bench.resampler = NULL;
+	const char *params = "\"sample_rate\":44100,\"channel_num\":2,\"sample_num\":1024";
+	Bench_run("audioResampler.pcmS16ToPcmF32", params, AudioBench_s16ToF32, &bench);
+	ttLibC_Frame_close((ttLibC_Frame **)&bench.dst);
+	Bench_run("audioResampler.pcmF32ToPcmS16", params, AudioBench_f32ToS16, &bench);
+	ttLibC_Frame_close((ttLibC_Frame **)&bench.dst);
+	Bench_run("audioResampler.convertFormat", params, AudioBench_convertFormat, &bench);
+	ttLibC_Frame_close((ttLibC_Frame **)&bench.dst);
+	ttLibC_PolyphaseResampler_Quality qualities[] = {
+		PolyphaseResamplerQuality_low,
+		PolyphaseResamplerQuality_medium,
+		PolyphaseResamplerQuality_high};
+	const char *quality_names[] = {"low", "medium", "high"};
+	for(int i = 0;i < 3;++ i) {
+		char name[64];
+		char polyphase_params[128];
+		sprintf(name, "polyphaseResampler.44100to48000.%s", quality_names[i]);
+		sprintf(polyphase_params, "%s,\"quality\":\"%s\"", params, quality_names[i]);
+		bench.resampler = ttLibC_PolyphaseResampler_make(2, 44100, 48000, qualities[i]);
+		Bench_run(name, polyphase_params, AudioBench_polyphase, &bench);
+		ttLibC_PolyphaseResampler_close(&bench.resampler);
+		ttLibC_Frame_close((ttLibC_Frame **)&bench.dst);
+	}
+	ttLibC_PcmS16_close(&bench.pcms16);
+	ttLibC_PcmF32_close(&bench.pcmf32);
+	ttLibC_BeepGenerator_close(&generator);
+}
+
+// -------------------------------------------------------------- //
+// crc32
+
+typedef struct {
+	uint8_t data[65536];
+} Crc32Bench_t;
+
+static bool Crc32Bench_update(void *ptr, Bench_Op *op) {
+	Crc32Bench_t *bench = (Crc32Bench_t *)ptr;
+	ttLibC_Crc32 *crc32 = ttLibC_Crc32_make(0xFFFFFFFF);
+	if(crc32 == NULL) {
+		return false;
+	}
+	for(size_t i = 0;i < sizeof(bench->data);++ i) {
+		ttLibC_Crc32_update(crc32, bench->data[i]);
+	}
+	sprintf(op->extra, "\"crc\":%u", ttLibC_Crc32_getValue(crc32));
+	ttLibC_Crc32_close(&crc32);
+	op->size = sizeof(bench->data);
+	return true;
+}
+
+static void crc32Bench() {
+	Crc32Bench_t *bench = (Crc32Bench_t *)malloc(sizeof(Crc32Bench_t));
+	uint32_t state = 0x13579BDF;
+	for(size_t i = 0;i < sizeof(bench->data);++ i) {
+		bench->data[i] = (uint8_t)Bench_random(&state);
+	}
+	Bench_run("crc32.update", "\"size\":65536", Crc32Bench_update, bench);
+	free(bench);
+}
+
+// -------------------------------------------------------------- //
+// amf0
+
+typedef struct {
+	ttLibC_Amf0Object *object;
+	uint8_t buffer[1024];
+	size_t size;
+	ttLibC_Amf0Arena *arena;
+	uint32_t element_num;
+} Amf0Bench_t;
+
+static bool Amf0Bench_writeBuffer(void *ptr, Bench_Op *op) {
+	Amf0Bench_t *bench = (Amf0Bench_t *)ptr;
+	bench->size = ttLibC_Amf0_writeBuffer(bench->object, bench->buffer, sizeof(bench->buffer));
+	op->size = bench->size;
+	return bench->size != 0;
+}
+
+static bool Amf0Bench_readCallback(void *ptr, ttLibC_Amf0Object *amf0_obj) {
+	Amf0Bench_t *bench = (Amf0Bench_t *)ptr;
+	if(ttLibC_Amf0_getElement(amf0_obj, "tcUrl") != NULL) {
+		++ bench->element_num;
+	}
+	if(ttLibC_Amf0_getElement(amf0_obj, "videoFunction") != NULL) {
+		++ bench->element_num;
+	}
+	return true;
+}
+
+static bool Amf0Bench_read(void *ptr, Bench_Op *op) {
+	Amf0Bench_t *bench = (Amf0Bench_t *)ptr;
+	bench->element_num = 0;
+	if(!ttLibC_Amf0_read(bench->buffer, bench->size, Amf0Bench_readCallback, bench)) {
+		return false;
+	}
+	op->size = bench->size;
+	return bench->element_num == 2;
+}
+
+static bool Amf0Bench_readArena(void *ptr, Bench_Op *op) {
+	Amf0Bench_t *bench = (Amf0Bench_t *)ptr;
+	bench->element_num = 0;
+	ttLibC_Amf0Arena_reset(bench->arena);
+	if(!ttLibC_Amf0_readArena(bench->arena, bench->buffer, bench->size, Amf0Bench_readCallback, bench)) {
+		return false;
+	}
+	op->size = bench->size;
+	return bench->element_num == 2;
+}
+
+static void amf0Bench() {
+	// the same object as connect command.
+	ttLibC_Amf0MapObject map_objects[] = {
+			{(char *)"app",            ttLibC_Amf0_string("live")},
+			{(char *)"flashVer",       ttLibC_Amf0_string("MAC 18,0,0,232")},
+			{(char *)"tcUrl",          ttLibC_Amf0_string("rtmp://localhost/live")},
+			{(char *)"fpad",           ttLibC_Amf0_boolean(false)},
+			{(char *)"audioCodecs",    ttLibC_Amf0_number(3575)},
+			{(char *)"videoCodecs",    ttLibC_Amf0_number(252)},
+			{(char *)"objectEncoding", ttLibC_Amf0_number(0)},
+			{(char *)"capabilities",   ttLibC_Amf0_number(239)},
+			{(char *)"videoFunction",  ttLibC_Amf0_number(1)},
+			{NULL,                     NULL}
+	};
+	Amf0Bench_t bench;
+	bench.object = ttLibC_Amf0_object(map_objects);
+	bench.arena = ttLibC_Amf0Arena_make(4096);
+	Bench_run("amf0.writeBuffer", NULL, Amf0Bench_writeBuffer, &bench);
+	Bench_run("amf0.read", NULL, Amf0Bench_read, &bench);
+	Bench_run("amf0.readArena", NULL, Amf0Bench_readArena, &bench);
+	ttLibC_Amf0Arena_close(&bench.arena);
+	ttLibC_Amf0_close(&bench.object);
+}
+
+#ifdef __ENABLE_SOCKET__
+// -------------------------------------------------------------- //
+// websocket
+
+typedef struct {
+	uint8_t *src;
+	uint8_t *dst;
+	size_t size;
+	size_t align;
+} WebSocketBench_t;
+
+static bool WebSocketBench_mask(void *ptr, Bench_Op *op) {
+	WebSocketBench_t *bench = (WebSocketBench_t *)ptr;
+	uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+	ttLibC_WebSocket_mask(bench->dst + bench->align, bench->src + bench->align, bench->size, mask, 0);
+	op->size = bench->size;
+	return true;
+}
+
+static void websocketBench() {
+	WebSocketBench_t bench;
+	bench.size = 1024 * 1024;
+	bench.src = (uint8_t *)malloc(bench.size + 16);
+	bench.dst = (uint8_t *)malloc(bench.size + 16);
+	uint32_t state = 0x0F1E2D3C;
+	for(size_t i = 0;i < bench.size + 16;++ i) {
+		bench.src[i] = (uint8_t)Bench_random(&state);
+	}
+	bench.align = 0;
+	Bench_run("websocket.mask", "\"size\":1048576,\"align\":0", WebSocketBench_mask, &bench);
+	bench.align = 3;
+	Bench_run("websocket.mask.unaligned", "\"size\":1048576,\"align\":3", WebSocketBench_mask, &bench);
+	bench.size = 125;
+	Bench_run("websocket.mask.small", "\"size\":125,\"align\":3", WebSocketBench_mask, &bench);
+	free(bench.src);
+	free(bench.dst);
+}
+
+// -------------------------------------------------------------- //
+// rtmp chunk
+
+typedef struct {
+	int fds[2];
+	ttLibC_ClientObject *sender;
+	ttLibC_ClientObject *receiver;
+	ttLibC_DynamicBuffer *chunk_buffer;
+	ttLibC_H264 *h264;
+	uint64_t pts;
+	uint32_t message_num;
+} RtmpChunkBench_t;
+
+/*
+ * message -> chunks, the same as rtmpEncoder of tetty2.
+ */
+static bool RtmpChunkBench_encode(RtmpChunkBench_t *bench, ttLibC_RtmpMessage *message) {
+	ttLibC_ClientObject *client_object = bench->sender;
+	ttLibC_DynamicBuffer_empty(client_object->send_buffer);
+	if(!ttLibC_RtmpMessage_getData(client_object, message, client_object->send_buffer)) {
+		return false;
+	}
+	uint8_t *buffer = ttLibC_DynamicBuffer_refData(client_object->send_buffer);
+	size_t buffer_size = ttLibC_DynamicBuffer_refSize(client_object->send_buffer);
+	ttLibC_RtmpHeader *prev_header = (ttLibC_RtmpHeader *)ttLibC_StlMap_get(client_object->send_headers, (void *)((long)message->header->cs_id));
+	if(prev_header != NULL) {
+		if(prev_header->stream_id != message->header->stream_id) {
+			message->header->type = Type0;
+		}
+		else {
+			message->header->delta_time = message->header->timestamp - prev_header->timestamp;
+			if(prev_header->size != buffer_size
+			|| prev_header->message_type != message->header->message_type) {
+				message->header->type = Type1;
+			}
+			else if(prev_header->delta_time != message->header->delta_time) {
+				message->header->type = Type2;
+			}
+			else {
+				message->header->type = Type3;
+			}
+		}
+	}
+	uint8_t header[20];
+	message->header->size = buffer_size;
+	do {
+		size_t size = ttLibC_RtmpHeader_getData(message->header, header, 20);
+		ttLibC_DynamicBuffer_append(bench->chunk_buffer, header, size);
+		size_t write_size = (buffer_size > client_object->send_chunk_size ? client_object->send_chunk_size : buffer_size);
+		ttLibC_DynamicBuffer_append(bench->chunk_buffer, buffer, write_size);
+		buffer += write_size;
+		buffer_size -= write_size;
+		message->header->type = Type3;
+	} while(buffer_size > 0);
+	prev_header = ttLibC_RtmpHeader_copy(prev_header, message->header);
+	ttLibC_StlMap_put(client_object->send_headers, (void *)((long)prev_header->cs_id), prev_header);
+	return true;
+}
+
+/*
+ * encode one video message, send it over socketpair, receive and decode.
+ */
+static bool RtmpChunkBench_sendRecv(void *ptr, Bench_Op *op) {
+	RtmpChunkBench_t *bench = (RtmpChunkBench_t *)ptr;
+	bench->h264->inherit_super.inherit_super.pts = bench->pts;
+	bench->h264->inherit_super.inherit_super.dts = bench->pts;
+	bench->pts += 40;
+	ttLibC_VideoMessage *message = ttLibC_VideoMessage_addFrame(1, (ttLibC_Video *)bench->h264);
+	if(message == NULL) {
+		return false;
+	}
+	ttLibC_DynamicBuffer_empty(bench->chunk_buffer);
+	bool result = RtmpChunkBench_encode(bench, (ttLibC_RtmpMessage *)message);
+	ttLibC_VideoMessage_close(&message);
+	if(!result) {
+		return false;
+	}
+	uint8_t *data = ttLibC_DynamicBuffer_refData(bench->chunk_buffer);
+	size_t data_size = ttLibC_DynamicBuffer_refSize(bench->chunk_buffer);
+	size_t sent_size = 0;
+	size_t recv_size = 0;
+	uint8_t recv_buf[65536];
+	// message is smaller than socket buffer, but send and recv in turn to be safe.
+	while(recv_size < data_size) {
+		if(sent_size < data_size) {
+			ssize_t size = write(bench->fds[0], data + sent_size, data_size - sent_size);
+			if(size < 0) {
+				return false;
+			}
+			sent_size += size;
+		}
+		ssize_t size = read(bench->fds[1], recv_buf, sizeof(recv_buf));
+		if(size <= 0) {
+			return false;
+		}
+		recv_size += size;
+		ttLibC_DynamicBuffer_append(bench->receiver->recv_buffer, recv_buf, size);
+		ttLibC_RtmpMessage *recv_message = NULL;
+		while((recv_message = ttLibC_RtmpMessage_readBinary(bench->receiver->recv_buffer, bench->receiver)) != NULL) {
+			if(recv_message->header->message_type == RtmpMessageType_videoMessage) {
+				++ bench->message_num;
+			}
+			ttLibC_RtmpMessage_close(&recv_message);
+		}
+	}
+	op->size = data_size;
+	return true;
+}
+
+static void rtmpChunkBench() {
+	uint32_t chunk_sizes[] = {128, 4096};
+	uint8_t slice[16000];
+	uint32_t state = 0x55AA55AA;
+	slice[0] = 0x00;
+	slice[1] = 0x00;
+	slice[2] = 0x00;
+	slice[3] = 0x01;
+	slice[4] = 0x41;
+	slice[5] = 0x9A;
+	Bench_fillPayload(slice + 6, sizeof(slice) - 6, &state);
+	for(int i = 0;i < 2;++ i) {
+		RtmpChunkBench_t bench;
+		if(socketpair(AF_UNIX, SOCK_STREAM, 0, bench.fds) != 0) {
+			fprintf(stderr, "failed to make socketpair.\n");
+			return;
+		}
+		bench.sender   = ttLibC_ClientObject_make();
+		bench.receiver = ttLibC_ClientObject_make();
+		bench.sender->send_chunk_size   = chunk_sizes[i];
+		bench.receiver->recv_chunk_size = chunk_sizes[i];
+		bench.chunk_buffer = ttLibC_DynamicBuffer_make();
+		bench.h264 = ttLibC_H264_getFrame(NULL, slice, sizeof(slice), true, 0, 1000);
+		bench.pts = 0;
+		bench.message_num = 0;
+		char name[64];
+		char params[64];
+		sprintf(name, "rtmp.chunk.socketpair.%u", chunk_sizes[i]);
+		sprintf(params, "\"chunk_size\":%u,\"message_size\":%u", chunk_sizes[i], (uint32_t)sizeof(slice));
+		Bench_run(name, params, RtmpChunkBench_sendRecv, &bench);
+		ttLibC_H264_close(&bench.h264);
+		ttLibC_DynamicBuffer_close(&bench.chunk_buffer);
+		ttLibC_ClientObject_close(&bench.sender);
+		ttLibC_ClientObject_close(&bench.receiver);
+		close(bench.fds[0]);
+		close(bench.fds[1]);
+	}
+}
+
+// -------------------------------------------------------------- //
+// rtmp aggregate publish on loopback
+
+typedef struct {
+	ttLibC_RtmpConnection *conn;
+	ttLibC_RtmpStream *stream;
+	bool is_publish_started;
+	bool is_error;
+	ttLibC_PcmAlaw *alaw;
+	uint8_t data[160];
+	uint64_t pts;
+} RtmpAggregateBench_t;
+
+static bool RtmpAggregateBench_onStatus(void *ptr, ttLibC_Amf0Object *amf0_obj) {
+	RtmpAggregateBench_t *bench = (RtmpAggregateBench_t *)ptr;
+	ttLibC_Amf0Object *code = ttLibC_Amf0_getElement(amf0_obj, "code");
+	if(code == NULL) {
+		return true;
+	}
+	const char *code_string = (const char *)code->object;
+	if(strcmp(code_string, "NetConnection.Connect.Success") == 0) {
+		bench->stream = ttLibC_RtmpStream_make(bench->conn);
+		ttLibC_RtmpStream_addEventListener(bench->stream, RtmpAggregateBench_onStatus, bench);
+		ttLibC_RtmpStream_publish(bench->stream, "bench");
+	}
+	else if(strcmp(code_string, "NetStream.Publish.Start") == 0) {
+		bench->is_publish_started = true;
+	}
+	else if(strstr(code_string, "Failed") != NULL || strstr(code_string, "Rejected") != NULL) {
+		bench->is_error = true;
+	}
+	return true;
+}
+
+/*
+ * publish one 20 mili sec alaw frame.
+ */
+static bool RtmpAggregateBench_addFrame(void *ptr, Bench_Op *op) {
+	RtmpAggregateBench_t *bench = (RtmpAggregateBench_t *)ptr;
+	bench->alaw = ttLibC_PcmAlaw_make(bench->alaw, 8000, 160, 1, bench->data, sizeof(bench->data), true, bench->pts, 1000);
+	if(bench->alaw == NULL) {
+		return false;
+	}
+	bench->pts += 20;
+	op->size = sizeof(bench->data);
+	return ttLibC_RtmpStream_addFrame(bench->stream, (ttLibC_Frame *)bench->alaw);
+}
+
+static void rtmpAggregateBench() {
+	if(!Bench_isTarget("rtmp.aggregate")) {
+		return;
+	}
+	uint16_t port = 19350;
+	pid_t pid = fork();
+	if(pid < 0) {
+		return;
+	}
+	if(pid == 0) {
+		// server process, killed by parent.
+		if(freopen("/dev/null", "w", stdout) == NULL) {
+			_exit(1);
+		}
+		ttLibC_RtmpServer *server = ttLibC_RtmpServer_make(4096, 0);
+		if(!ttLibC_RtmpServer_bind(server, port)) {
+			_exit(1);
+		}
+		while(ttLibC_RtmpServer_update(server, 10000)) {
+		}
+		_exit(0);
+	}
+	RtmpAggregateBench_t bench;
+	memset(&bench, 0, sizeof(bench));
+	memset(bench.data, 0xD5, sizeof(bench.data));
+	char address[64];
+	sprintf(address, "rtmp://127.0.0.1:%u/live", port);
+	bool is_connected = false;
+	// wait for server.
+	for(int i = 0;i < 50 && !is_connected;++ i) {
+		usleep(100000);
+		bench.conn = ttLibC_RtmpConnection_make();
+		ttLibC_RtmpConnection_addEventListener(bench.conn, RtmpAggregateBench_onStatus, &bench);
+		if(ttLibC_RtmpConnection_connect(bench.conn, address)) {
+			is_connected = true;
+			break;
+		}
+		ttLibC_RtmpConnection_close(&bench.conn);
+	}
+	uint64_t limit = Bench_now() + 5000000000ULL;
+	while(is_connected && !bench.is_publish_started && !bench.is_error && Bench_now() < limit) {
+		if(!ttLibC_RtmpConnection_update(bench.conn, 10000)) {
+			break;
+		}
+	}
+	if(bench.is_publish_started) {
+		uint32_t windows[] = {0, 100};
+		for(int i = 0;i < 2;++ i) {
+			char name[64];
+			char params[64];
+			sprintf(name, "rtmp.aggregate.publish.%u", windows[i]);
+			sprintf(params, "\"window_msec\":%u,\"frame_msec\":20", windows[i]);
+			ttLibC_RtmpStream_setAggregate(bench.stream, windows[i], 0);
+			Bench_run(name, params, RtmpAggregateBench_addFrame, &bench);
+			ttLibC_RtmpStream_setAggregate(bench.stream, 0, 0);
+		}
+	}
+	else {
+		fprintf(stderr, "failed to publish on loopback rtmp server.\n");
+	}
+	ttLibC_PcmAlaw_close(&bench.alaw);
+	ttLibC_RtmpStream_close(&bench.stream);
+	ttLibC_RtmpConnection_close(&bench.conn);
+	kill(pid, SIGKILL);
+	waitpid(pid, NULL, 0);
+}
+#endif
+
+#ifdef __ENABLE_JPEG__
+// -------------------------------------------------------------- //
+// jpeg
+
+typedef struct {
+	ttLibC_Yuv420 *yuv;
+	ttLibC_JpegEncoder *encoder;
+	ttLibC_Thumbnail *thumbnail;
+	size_t jpeg_size;
+} JpegBench_t;
+
+static bool JpegBench_encodeCallback(void *ptr, ttLibC_Jpeg *jpeg) {
+	JpegBench_t *bench = (JpegBench_t *)ptr;
+	bench->jpeg_size = jpeg->inherit_super.inherit_super.buffer_size;
+	return true;
+}
+
+static bool JpegBench_encode(void *ptr, Bench_Op *op) {
+	JpegBench_t *bench = (JpegBench_t *)ptr;
+	if(!ttLibC_JpegEncoder_encode(bench->encoder, bench->yuv, JpegBench_encodeCallback, bench)) {
+		return false;
+	}
+	op->size = bench->yuv->inherit_super.inherit_super.data_size;
+	sprintf(op->extra, "\"jpeg_size\":%lu", (unsigned long)bench->jpeg_size);
+	return true;
+}
+
+static bool JpegBench_thumbnail(void *ptr, Bench_Op *op) {
+	JpegBench_t *bench = (JpegBench_t *)ptr;
+	if(!ttLibC_Thumbnail_convert(bench->thumbnail, (ttLibC_Frame *)bench->yuv, JpegBench_encodeCallback, bench)) {
+		return false;
+	}
+	op->size = bench->yuv->inherit_super.inherit_super.data_size;
+	sprintf(op->extra, "\"jpeg_size\":%lu", (unsigned long)bench->jpeg_size);
+	return true;
+}
+
+static void jpegBench() {
+	struct {
+		uint32_t width;
+		uint32_t height;
+	} sizes[] = {
+		{320, 240},
+		{640, 480},
+		{1280, 720},
+		{1920, 1080},
+	};
+	uint32_t threads[] = {1, 2, 4};
+	for(size_t i = 0;i < sizeof(sizes) / sizeof(sizes[0]);++ i) {
+		JpegBench_t bench;
+		bench.yuv = Bench_makeYuv(NULL, sizes[i].width, sizes[i].height, 0);
+		bench.thumbnail = NULL;
+		for(size_t j = 0;j < sizeof(threads) / sizeof(threads[0]);++ j) {
+			if(threads[j] == 1) {
+				bench.encoder = ttLibC_JpegEncoder_make(sizes[i].width, sizes[i].height, 90);
+			}
+			else {
+				bench.encoder = ttLibC_JpegEncoder_makeWithThread(sizes[i].width, sizes[i].height, 90, threads[j]);
+			}
+			char name[64];
+			char params[128];
+			sprintf(name, "jpeg.encode.%ux%u.thread%u", sizes[i].width, sizes[i].height, threads[j]);
+			sprintf(params, "\"width\":%u,\"height\":%u,\"quality\":90,\"thread_num\":%u", sizes[i].width, sizes[i].height, threads[j]);
+			Bench_run(name, params, JpegBench_encode, &bench);
+			ttLibC_JpegEncoder_close(&bench.encoder);
+		}
+		// thumbnail from 1280x720 and 1920x1080.
+		if(sizes[i].width >= 1280) {
+			bench.thumbnail = ttLibC_Thumbnail_make(320, 0, 80);
+			char name[64];
+			char params[128];
+			sprintf(name, "thumbnail.%ux%u", sizes[i].width, sizes[i].height);
+			sprintf(params, "\"width\":%u,\"height\":%u,\"thumbnail_width\":320,\"quality\":80", sizes[i].width, sizes[i].height);
+			Bench_run(name, params, JpegBench_thumbnail, &bench);
+			ttLibC_Thumbnail_close(&bench.thumbnail);
+		}
+		ttLibC_Yuv420_close(&bench.yuv);
+	}
+}
+#endif
+
+#if defined(__ENABLE_AVCODEC__) && defined(__ENABLE_X264__)
+// -------------------------------------------------------------- //
+// avcodec decode with threads
+
+#define AvcodecBench_frameNum 60
+
+typedef struct {
+	ttLibC_DynamicBuffer *stream;
+	size_t offsets[AvcodecBench_frameNum * 2];
+	size_t sizes[AvcodecBench_frameNum * 2];
+	uint64_t ptss[AvcodecBench_frameNum * 2];
+	uint32_t unit_num;
+	uint32_t width;
+	uint32_t height;
+	uint32_t thread_num;
+	uint32_t decode_num;
+} AvcodecBench_t;
+
+static bool AvcodecBench_encodeCallback(void *ptr, ttLibC_H264 *h264) {
+	AvcodecBench_t *bench = (AvcodecBench_t *)ptr;
+	if(bench->unit_num >= AvcodecBench_frameNum * 2) {
+		return false;
+	}
+	bench->offsets[bench->unit_num] = ttLibC_DynamicBuffer_refSize(bench->stream);
+	bench->sizes[bench->unit_num]   = h264->inherit_super.inherit_super.buffer_size;
+	bench->ptss[bench->unit_num]    = h264->inherit_super.inherit_super.pts;
+	ttLibC_DynamicBuffer_append(bench->stream, (uint8_t *)h264->inherit_super.inherit_super.data, h264->inherit_super.inherit_super.buffer_size);
+	++ bench->unit_num;
+	return true;
+}
+
+static bool AvcodecBench_decodeCallback(void *ptr, ttLibC_Frame *frame) {
+	(void)frame;
+	AvcodecBench_t *bench = (AvcodecBench_t *)ptr;
+	++ bench->decode_num;
+	return true;
+}
+
+/*
+ * decode whole stream with new decoder, and flush.
+ */
+static bool AvcodecBench_decode(void *ptr, Bench_Op *op) {
+	AvcodecBench_t *bench = (AvcodecBench_t *)ptr;
+	ttLibC_AvcodecDecoder *decoder = ttLibC_AvcodecVideoDecoder_makeWithThread(
+			frameType_h264,
+			bench->width,
+			bench->height,
+			NULL,
+			0,
+			bench->thread_num,
+			bench->thread_num == 1 ? AvcodecDecoderThreadType_none : AvcodecDecoderThreadType_frame);
+	if(decoder == NULL) {
+		return false;
+	}
+	uint64_t start = Bench_now();
+	bench->decode_num = 0;
+	uint8_t *data = ttLibC_DynamicBuffer_refData(bench->stream);
+	ttLibC_H264 *h264 = NULL;
+	bool result = true;
+	for(uint32_t i = 0;result && i < bench->unit_num;++ i) {
+		h264 = ttLibC_H264_getFrame(h264, data + bench->offsets[i], bench->sizes[i], true, bench->ptss[i], 1000);
+		if(h264 == NULL) {
+			result = false;
+			break;
+		}
+		result = ttLibC_AvcodecDecoder_decode(decoder, (ttLibC_Frame *)h264, AvcodecBench_decodeCallback, bench);
+	}
+	if(result) {
+		result = ttLibC_AvcodecDecoder_flush(decoder, AvcodecBench_decodeCallback, bench);
+	}
+	uint64_t elapsed = Bench_now() - start;
+	ttLibC_H264_close(&h264);
+	ttLibC_AvcodecDecoder_close(&decoder);
+	op->size = ttLibC_DynamicBuffer_refSize(bench->stream);
+	sprintf(op->extra, "\"frame_num\":%u,\"frames_per_sec\":%.1f", bench->decode_num, bench->decode_num * 1000000000.0 / elapsed);
+	return result;
+}
+
+static void avcodecBench() {
+	AvcodecBench_t bench;
+	bench.width  = 1280;
+	bench.height = 720;
+	bench.unit_num = 0;
+	bench.stream = ttLibC_DynamicBuffer_make();
+	ttLibC_X264Encoder *encoder = ttLibC_X264Encoder_make(bench.width, bench.height);
+	ttLibC_Yuv420 *yuv = NULL;
+	for(uint32_t i = 0;encoder != NULL && i < AvcodecBench_frameNum;++ i) {
+		yuv = Bench_makeYuv(yuv, bench.width, bench.height, i * 40);
+		if(yuv == NULL || !ttLibC_X264Encoder_encode(encoder, yuv, AvcodecBench_encodeCallback, &bench)) {
+			break;
+		}
+	}
+	ttLibC_Yuv420_close(&yuv);
+	ttLibC_X264Encoder_close(&encoder);
+	uint32_t threads[] = {1, 2, 4, 8};
+	for(size_t i = 0;bench.unit_num > 0 && i < sizeof(threads) / sizeof(threads[0]);++ i) {
+		bench.thread_num = threads[i];
+		char name[64];
+		char params[128];
+		sprintf(name, "avcodec.h264.decode.thread%u", threads[i]);
+		sprintf(params, "\"width\":%u,\"height\":%u,\"thread_num\":%u", bench.width, bench.height, threads[i]);
+		Bench_run(name, params, AvcodecBench_decode, &bench);
+	}
+	ttLibC_DynamicBuffer_close(&bench.stream);
+}
+#endif
+
+/**
+ * main entry for ttLibCBench
+ * @param argc
+ * @param argv
+ * @return exit code.
+ */
+int main(int argc, char *argv[]) {
+	output = stdout;
+	filters = (char **)malloc(sizeof(char *) * argc);
+	for(int i = 1;i < argc;++ i) {
+		if(strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+			bench_time = strtoull(argv[++ i], NULL, 10) * 1000000ULL;
+		}
+		else if(strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			output = fopen(argv[++ i], "w");
+			if(output == NULL) {
+				fprintf(stderr, "failed to open %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else {
+			filters[filter_num ++] = argv[i];
+		}
+	}
+	fprintf(output, "{\n  \"bench_time_msec\":%llu,\n  \"results\":[", (unsigned long long)(bench_time / 1000000));
+	h264Bench();
+	containerBench();
+	imageBench();
+	audioBench();
+	crc32Bench();
+	amf0Bench();
+#ifdef __ENABLE_SOCKET__
+	websocketBench();
+	rtmpChunkBench();
+	rtmpAggregateBench();
+#endif
+#ifdef __ENABLE_JPEG__
+	jpegBench();
+#endif
+#if defined(__ENABLE_AVCODEC__) && defined(__ENABLE_X264__)
+	avcodecBench();
+#endif
+	fprintf(output, "\n  ]\n}\n");
+	if(output != stdout) {
+		fclose(output);
+	}
+	free(filters);
+	return 0;
+}
@@ -14,15 +14,29 @@
 #include <ttLibC/log.h>
 #include <ttLibC/allocator.h>
 #include <array>
+#include <vector>
 
 #include <ttLibC/util/hexUtil.h>
 
 #include <ttLibC/frame/video/bgr.h>
 #include <ttLibC/frame/audio/pcms16.h>
 #include <ttLibC/frame/audio/pcmf32.h>
+#include <ttLibC/frame/audio/aac.h>
+#include <ttLibC/frame/audio/mp3.h>
 #include <ttLibC/util/beepUtil.h>
+#include <ttLibC/util/audioMixerUtil.h>
+#include <ttLibC/util/audioSyncUtil.h>
+#include <ttLibC/util/framePoolUtil.h>
+#include <ttLibC/util/frameRingUtil.h>
+#include <ttLibC/util/transcodeGraphUtil.h>
+#include <ttLibC/container/mp4.h>
+#include <ttLibC/container/mpegts.h>
+#include <ttLibC/container/mp3.h>
+#include "containerTestUtil.h"
 #include <ttLibC/util/ioUtil.h>
 #include <ttLibC/resampler/audioResampler.h>
+#include <ttLibC/resampler/polyphaseResampler.h>
+#include <ttLibC/frame/video/yuv420.h>
 
 #ifdef __ENABLE_OPENCV__
 #	include <ttLibC/util/opencvUtil.h>
@@ -34,6 +48,15 @@
 
 #ifdef __ENABLE_FILE__
 #	include <ttLibC/util/httpUtil.h>
+#	include <ttLibC/util/httpStreamUtil.h>
+#	include <ttLibC/util/fileIoUtil.h>
+#	include <ttLibC/container/mp3.h>
+#endif
+
+#ifdef __ENABLE_JPEG__
+#	include <ttLibC/util/thumbnailUtil.h>
+#	include <ttLibC/encoder/jpegEncoder.h>
+#	include <ttLibC/frame/video/yuv420.h>
 #endif
 
 #include <ttLibC/util/crc32Util.h>
@@ -45,6 +68,7 @@
 #include <ttLibC/util/linkedListUtil.h>
 #include <ttLibC/util/stlListUtil.h>
 #include <ttLibC/util/stlMapUtil.h>
+#include <ttLibC/util/statsUtil.h>
 
 #include <stdio.h>
 #include <string.h>
@@ -56,6 +80,9 @@
 #include <sys/param.h>
 #include <sys/uio.h>
 #include <unistd.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <pthread.h>
 
 #ifdef __ENABLE_APPLE__
 #	include <ttLibC/util/audioUnitUtil.h>
@@ -596,6 +623,49 @@ static void dynamicBufferTest() {
 	LOG_DUMP(ttLibC_DynamicBuffer_refData(buffer),
 			ttLibC_DynamicBuffer_refSize(buffer), true);
 	ttLibC_DynamicBuffer_close(&buffer);
+
+	LOG_PRINT("test no.3");
+	buffer = ttLibC_DynamicBuffer_make();
+	size = ttLibC_HexUtil_makeBuffer("0102030405060708", data, 256);
+	// no unread data, refer data without copy.
+	ttLibC_DynamicBuffer_appendNonCopy(buffer, data, size);
+	ASSERT(ttLibC_DynamicBuffer_refData(buffer) == data);
+	ttLibC_DynamicBuffer_markAsRead(buffer, 5);
+	ASSERT(ttLibC_DynamicBuffer_refData(buffer) == data + 5);
+	// unread data is copied on clear, data can be released after that.
+	ttLibC_DynamicBuffer_clear(buffer);
+	ASSERT(ttLibC_DynamicBuffer_refData(buffer) != data + 5);
+	ASSERT(ttLibC_DynamicBuffer_refSize(buffer) == 3);
+	memset(data, 0, 256);
+	size = ttLibC_HexUtil_makeBuffer("0910", data, 256);
+	// unread data exists, copied.
+	ttLibC_DynamicBuffer_appendNonCopy(buffer, data, size);
+	uint8_t expect[] = {0x06, 0x07, 0x08, 0x09, 0x10};
+	ASSERT(ttLibC_DynamicBuffer_refSize(buffer) == sizeof(expect));
+	ASSERT(memcmp(ttLibC_DynamicBuffer_refData(buffer), expect, sizeof(expect)) == 0);
+
+	LOG_PRINT("test no.4");
+	// reserve and commit, data is appended after unread data.
+	uint8_t *reserved = ttLibC_DynamicBuffer_reserve(buffer, 100);
+	ASSERT(reserved != NULL);
+	ASSERT(ttLibC_DynamicBuffer_refSize(buffer) == sizeof(expect));
+	reserved[0] = 0x11;
+	reserved[1] = 0x12;
+	ASSERT(!ttLibC_DynamicBuffer_commit(buffer, 101));
+	ASSERT(ttLibC_DynamicBuffer_commit(buffer, 2));
+	ASSERT(ttLibC_DynamicBuffer_refSize(buffer) == sizeof(expect) + 2);
+	ASSERT(memcmp(ttLibC_DynamicBuffer_refData(buffer), expect, sizeof(expect)) == 0);
+	ASSERT(ttLibC_DynamicBuffer_refData(buffer)[sizeof(expect) + 1] == 0x12);
+	// committed once.
+	ASSERT(!ttLibC_DynamicBuffer_commit(buffer, 1));
+	// small reserve uses the rest of memory.
+	reserved = ttLibC_DynamicBuffer_reserve(buffer, 10);
+	ASSERT(reserved == ttLibC_DynamicBuffer_refData(buffer) + sizeof(expect) + 2);
+	// other update drops reserve.
+	ttLibC_DynamicBuffer_append(buffer, data, 1);
+	ASSERT(!ttLibC_DynamicBuffer_commit(buffer, 1));
+	ASSERT(ttLibC_DynamicBuffer_refSize(buffer) == sizeof(expect) + 3);
+	ttLibC_DynamicBuffer_close(&buffer);
 	ASSERT(ttLibC_Allocator_dump() == 0);
 }
 
@@ -661,6 +731,628 @@ bool amfTest_read(void *ptr, ttLibC_Amf0Object *amf0_obj) {
 	return false;
 }
 
+typedef struct {
+	int16_t mix_value;
+	int16_t minus_value[3];
+	uint32_t mix_num;
+} audioMixerTest_t;
+
+static bool audioMixerTest_callback(void *ptr, uint32_t source_id, bool is_mix_minus, ttLibC_PcmS16 *pcm) {
+	audioMixerTest_t *testData = (audioMixerTest_t *)ptr;
+	// check the last sample of frame.
+	int16_t *data = (int16_t *)pcm->l_data;
+	int16_t value = data[pcm->inherit_super.sample_num * pcm->inherit_super.channel_num - 1];
+	if(is_mix_minus) {
+		testData->minus_value[source_id] = value;
+	}
+	else {
+		testData->mix_value = value;
+		testData->mix_num ++;
+	}
+	return true;
+}
+
+static void audioMixerTest() {
+	LOG_PRINT("audioMixerTest");
+	ttLibC_AudioMixer *mixer = ttLibC_AudioMixer_make(48000, 2, 960, 20);
+	int16_t data1[960 * 2];
+	int16_t data2[960 * 2];
+	for(int i = 0;i < 960 * 2;++ i) {
+		data1[i] = 1000;
+		data2[i] = 32000;
+	}
+	ttLibC_PcmS16 *pcm1 = NULL, *pcm2 = NULL;
+	audioMixerTest_t testData;
+	memset(&testData, 0, sizeof(testData));
+	ttLibC_AudioMixer_setMixMinus(mixer, 1, true);
+	ttLibC_AudioMixer_setMixMinus(mixer, 2, true);
+	for(int i = 0;i < 10;++ i) {
+		// source1 use mili sec timebase, source2 use sample timebase with offset.
+		pcm1 = ttLibC_PcmS16_make(pcm1, PcmS16Type_littleEndian, 48000, 960, 2, data1, sizeof(data1), data1, sizeof(data1), NULL, 0, true, i * 20, 1000);
+		pcm2 = ttLibC_PcmS16_make(pcm2, PcmS16Type_littleEndian, 48000, 960, 2, data2, sizeof(data2), data2, sizeof(data2), NULL, 0, true, 123456 + i * 960, 48000);
+		ASSERT(ttLibC_AudioMixer_queue(mixer, 1, (ttLibC_Audio *)pcm1));
+		ASSERT(ttLibC_AudioMixer_queue(mixer, 2, (ttLibC_Audio *)pcm2));
+		ASSERT(ttLibC_AudioMixer_mix(mixer, audioMixerTest_callback, &testData));
+		if(i == 0) {
+			// first 20mili sec is jitter buffer, silent.
+			ASSERT(testData.mix_value == 0);
+		}
+		else {
+			// saturated
+			ASSERT(testData.mix_value == 32767);
+			ASSERT(testData.minus_value[1] == 32000);
+			ASSERT(testData.minus_value[2] == 1000);
+		}
+	}
+	ttLibC_AudioMixer_setGain(mixer, 2, 0.5f);
+	ASSERT(ttLibC_AudioMixer_mix(mixer, audioMixerTest_callback, &testData));
+	ASSERT(testData.mix_value == 17000);
+	ASSERT(testData.minus_value[1] == 16000);
+	ASSERT(testData.mix_num == 11);
+	ASSERT(mixer->pts == 960 * 11);
+	ASSERT(ttLibC_AudioMixer_removeSource(mixer, 2));
+	ASSERT(mixer->source_num == 1);
+	ttLibC_PcmS16_close(&pcm1);
+	ttLibC_PcmS16_close(&pcm2);
+	ttLibC_AudioMixer_close(&mixer);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+static bool audioSyncTest_mp3ReadCallback(void *ptr, ttLibC_Container_Mp3 *mp3) {
+	(void)mp3;
+	++ *(uint32_t *)ptr;
+	return true;
+}
+
+static void audioSyncTest() {
+	LOG_PRINT("audioSyncTest");
+	// mp3 v1 layer3 128kbps 44100Hz, 417byte and 418byte(padding) frames with garbage.
+	std::vector<uint8_t> mp3;
+	uint8_t garbage[] = {0x12, 0xFF, 0xFB, 0x00, 0xFF, 0x34};
+	mp3.insert(mp3.end(), garbage, garbage + sizeof(garbage));
+	for(int i = 0;i < 4;++ i) {
+		size_t pos = mp3.size();
+		mp3.resize(pos + 417 + (i & 1), 0);
+		mp3[pos] = 0xFF;
+		mp3[pos + 1] = 0xFB;
+		mp3[pos + 2] = (i & 1) ? 0x92 : 0x90;
+		mp3[pos + 3] = 0x64;
+		if(i == 1) {
+			mp3.insert(mp3.end(), garbage, garbage + sizeof(garbage));
+		}
+	}
+	ASSERT(ttLibC_AudioSync_refMp3Size(&mp3[6]) == 417);
+	ASSERT(ttLibC_AudioSync_refMp3Size(&mp3[6 + 417]) == 418);
+	ttLibC_AudioSync_Unit units[8];
+	size_t read_size = 0;
+	// stop at garbage after frames.
+	ASSERT(ttLibC_AudioSync_scan(AudioSyncType_mp3, mp3.data(), mp3.size(), units, 8, &read_size) == 2);
+	ASSERT(units[0].offset == 6 && units[0].size == 417);
+	ASSERT(units[1].offset == 6 + 417 && units[1].size == 418);
+	ASSERT(read_size == 6 + 417 + 418);
+	size_t pos = read_size;
+	ASSERT(ttLibC_AudioSync_scan(AudioSyncType_mp3, mp3.data() + pos, mp3.size() - pos, units, 8, &read_size) == 2);
+	ASSERT(units[0].offset == 6 && units[1].offset == 6 + 417);
+	ASSERT(read_size == mp3.size() - pos);
+	// partial frame is left for next scan.
+	ASSERT(ttLibC_AudioSync_scan(AudioSyncType_mp3, mp3.data() + pos, mp3.size() - pos - 1, units, 8, &read_size) == 1);
+	ASSERT(read_size == 6 + 417);
+	ttLibC_Mp3 *mp3_frame = ttLibC_Mp3_getFrame(NULL, &mp3[6], 417, true, 0, 44100);
+	ASSERT(mp3_frame != NULL);
+	ASSERT(mp3_frame->inherit_super.inherit_super.buffer_size == 417);
+	ASSERT(mp3_frame->inherit_super.sample_rate == 44100);
+	ASSERT(mp3_frame->inherit_super.sample_num == 1152);
+	ASSERT(mp3_frame->inherit_super.channel_num == 2);
+	ttLibC_Mp3_close(&mp3_frame);
+	// garbage starts with 'T' but not "TAG", reader skips it with the scanner.
+	std::vector<uint8_t> mp3_stream(mp3.begin() + 6, mp3.begin() + 6 + 417 + 418);
+	uint8_t t_garbage[] = {'T', 0x01, 0x02};
+	mp3_stream.insert(mp3_stream.begin(), t_garbage, t_garbage + sizeof(t_garbage));
+	ttLibC_Mp3Reader *mp3_reader = ttLibC_Mp3Reader_make();
+	uint32_t mp3_num = 0;
+	ASSERT(ttLibC_Mp3Reader_read(mp3_reader, mp3_stream.data(), mp3_stream.size(), audioSyncTest_mp3ReadCallback, &mp3_num));
+	ASSERT(mp3_num == 2);
+	ttLibC_Mp3Reader_close(&mp3_reader);
+
+	// adts aac lc 44100Hz stereo, 100byte frames.
+	std::vector<uint8_t> adts(3, 0x00);
+	for(int i = 0;i < 3;++ i) {
+		size_t pos = adts.size();
+		adts.resize(pos + 100, 0);
+		uint8_t header[] = {0xFF, 0xF1, 0x50, 0x80, (100 >> 3) & 0xFF, ((100 & 0x07) << 5) | 0x1F, 0xFC};
+		memcpy(&adts[pos], header, sizeof(header));
+	}
+	ASSERT(ttLibC_AudioSync_refAdtsSize(&adts[3]) == 100);
+	ASSERT(ttLibC_AudioSync_scan(AudioSyncType_adts, adts.data(), adts.size(), units, 2, &read_size) == 2);
+	ASSERT(units[0].offset == 3 && units[1].offset == 103);
+	ASSERT(read_size == 203);
+	ttLibC_Aac *aac = ttLibC_Aac_getFrame(NULL, &adts[3], 100, true, 0, 44100);
+	ASSERT(aac != NULL);
+	ASSERT(aac->inherit_super.inherit_super.buffer_size == 100);
+	ASSERT(aac->inherit_super.sample_rate == 44100);
+	ASSERT(aac->inherit_super.channel_num == 2);
+	// short data is not an error, need more.
+	ASSERT(ttLibC_Aac_getFrame(aac, &adts[3], 50, true, 0, 44100) == NULL);
+	ASSERT(ttLibC_Aac_getFrame(aac, &adts[3], 5, true, 0, 44100) == NULL);
+	ttLibC_Aac_close(&aac);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+static void framePoolTest() {
+	LOG_PRINT("framePoolTest");
+	ttLibC_FramePool *pool = ttLibC_FramePool_make(3);
+	ttLibC_Bgr *bgr = NULL;
+	for(int i = 0;i < 10;++ i) {
+		// steady state, get -> make -> release reuse the same frame.
+		bgr = (ttLibC_Bgr *)ttLibC_FramePool_getVideo(pool, frameType_bgr, BgrType_bgr, 320, 240);
+		bgr = ttLibC_Bgr_makeEmptyFrame2(bgr, BgrType_bgr, 320, 240);
+		ASSERT(bgr != NULL);
+		bgr->inherit_super.inherit_super.pts = i;
+		ttLibC_FramePool_release(pool, (ttLibC_Frame **)&bgr);
+		ASSERT(bgr == NULL);
+	}
+	ASSERT(pool->miss_count == 1);
+	ASSERT(pool->hit_count == 9);
+	ASSERT(pool->num == 1);
+	// different geometry is not shared.
+	ASSERT(ttLibC_FramePool_getVideo(pool, frameType_bgr, BgrType_bgr, 640, 480) == NULL);
+	ASSERT(ttLibC_FramePool_getVideo(pool, frameType_bgr, BgrType_bgra, 320, 240) == NULL);
+
+	// shared frame is back to pool after last release.
+	bgr = ttLibC_Bgr_makeEmptyFrame(BgrType_bgr, 320, 240);
+	ttLibC_Bgr *ref = (ttLibC_Bgr *)ttLibC_FramePool_ref(pool, (ttLibC_Frame *)bgr);
+	ttLibC_FramePool_release(pool, (ttLibC_Frame **)&bgr);
+	ASSERT(pool->num == 1);
+	ttLibC_FramePool_release(pool, (ttLibC_Frame **)&ref);
+	ASSERT(pool->num == 2);
+	// clone audio into pooled frame.
+	int16_t data[480 * 2] = {0};
+	ttLibC_PcmS16 *pcm = ttLibC_PcmS16_make(NULL, PcmS16Type_littleEndian, 48000, 480, 2, data, sizeof(data), data, sizeof(data), NULL, 0, true, 0, 48000);
+	ttLibC_PcmS16 *cloned = (ttLibC_PcmS16 *)ttLibC_FramePool_clone(pool, (ttLibC_Frame *)pcm);
+	ASSERT(cloned != NULL && !cloned->inherit_super.inherit_super.is_non_copy);
+	ttLibC_FramePool_release(pool, (ttLibC_Frame **)&cloned);
+	ttLibC_PcmS16 *reused = (ttLibC_PcmS16 *)ttLibC_FramePool_getAudio(pool, frameType_pcmS16, PcmS16Type_littleEndian, 2);
+	ASSERT(reused != NULL);
+	ttLibC_PcmS16_close(&reused);
+	// pool is full, drop.
+	for(int i = 0;i < 2;++ i) {
+		bgr = ttLibC_Bgr_makeEmptyFrame(BgrType_bgr, 320, 240);
+		ttLibC_FramePool_release(pool, (ttLibC_Frame **)&bgr);
+	}
+	ASSERT(pool->num == 3);
+	ASSERT(pool->drop_count == 1);
+	ttLibC_FramePool_close(&pool);
+
+	// layout and stride are part of key.
+	pool = ttLibC_FramePool_make(4);
+	ttLibC_Yuv420 *yuv = ttLibC_Yuv420_makeEmptyFrame(Yuv420Type_planar, 100, 100);
+	ttLibC_FramePool_release(pool, (ttLibC_Frame **)&yuv);
+	ASSERT(ttLibC_FramePool_getVideo(pool, frameType_yuv420, Yuv420Type_semiPlanar, 100, 100) == NULL);
+	yuv = (ttLibC_Yuv420 *)ttLibC_FramePool_getVideo(pool, frameType_yuv420, Yuv420Type_planar, 100, 100);
+	ASSERT(yuv != NULL && yuv->y_stride == 112);
+	ttLibC_Yuv420_close(&yuv);
+	bgr = ttLibC_Bgr_makeEmptyFrame(BgrType_bgr, 10, 10);
+	// tight stride, not the one of makeEmptyFrame2.
+	bgr->width_stride = 30;
+	ttLibC_FramePool_release(pool, (ttLibC_Frame **)&bgr);
+	ASSERT(pool->num == 0);
+	ASSERT(pool->drop_count == 1);
+
+	// resampler draw output from pool.
+	ttLibC_PolyphaseResampler *resampler = ttLibC_PolyphaseResampler_make(2, 48000, 44100, PolyphaseResamplerQuality_low);
+	ttLibC_PolyphaseResampler_setFramePool(resampler, pool);
+	for(int i = 0;i < 10;++ i) {
+		pcm->inherit_super.inherit_super.pts = i * 480;
+		ttLibC_PcmS16 *resampled = ttLibC_PolyphaseResampler_resamplePcmS16(resampler, NULL, pcm);
+		ASSERT(resampled != NULL);
+		ttLibC_FramePool_release(pool, (ttLibC_Frame **)&resampled);
+	}
+	ASSERT(pool->num == 1);
+	ASSERT(pool->hit_count >= 9);
+	ttLibC_PolyphaseResampler_close(&resampler);
+
+	ttLibC_PcmS16_close(&pcm);
+	ttLibC_FramePool_close(&pool);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+static bool amfArenaTest_read(void *ptr, ttLibC_Amf0Object *amf0_obj) {
+	ttLibC_Amf0Object **target = (ttLibC_Amf0Object **)ptr;
+	*target = amf0_obj;
+	return true;
+}
+
+#ifdef __ENABLE_JPEG__
+typedef struct thumbnailTest_t {
+	uint32_t width;
+	uint32_t height;
+	uint32_t count;
+	ttLibC_Jpeg *source;
+} thumbnailTest_t;
+
+static bool thumbnailTest_callback(void *ptr, ttLibC_Jpeg *jpeg) {
+	thumbnailTest_t *testData = (thumbnailTest_t *)ptr;
+	testData->width  = jpeg->inherit_super.width;
+	testData->height = jpeg->inherit_super.height;
+	++ testData->count;
+	return true;
+}
+
+static bool thumbnailTest_sourceCallback(void *ptr, ttLibC_Jpeg *jpeg) {
+	thumbnailTest_t *testData = (thumbnailTest_t *)ptr;
+	testData->source = (ttLibC_Jpeg *)ttLibC_Frame_clone(
+			(ttLibC_Frame *)testData->source,
+			(ttLibC_Frame *)jpeg);
+	return testData->source != NULL;
+}
+#endif
+
+typedef struct frameRingTest_Producer {
+	ttLibC_FrameRing *ring;
+	ttLibC_Frame **frames;
+	uint32_t frame_num;
+	uint32_t push_num;
+	/** true:wait with pushWait, false:spin with push. */
+	bool is_wait;
+} frameRingTest_Producer;
+
+static void *frameRingTest_produce(void *arg) {
+	frameRingTest_Producer *producer = (frameRingTest_Producer *)arg;
+	for(uint32_t i = 0;i < producer->push_num;++ i) {
+		ttLibC_Frame *frame = producer->frames[i % producer->frame_num];
+		if(producer->is_wait) {
+			if(!ttLibC_FrameRing_pushWait(producer->ring, frame, -1)) {
+				break;
+			}
+			continue;
+		}
+		while(!ttLibC_FrameRing_push(producer->ring, frame)) {
+			sched_yield();
+		}
+	}
+	return NULL;
+}
+
+static void frameRingTest() {
+	LOG_PRINT("frameRingTest");
+	// frames are made on main thread, debug allocator is not thread safe.
+	ttLibC_BeepGenerator *generator = ttLibC_BeepGenerator_make(PcmS16Type_littleEndian, 440, 44100, 1);
+	ttLibC_Frame *frames[4][16];
+	for(int i = 0;i < 4;++ i) {
+		for(int j = 0;j < 16;++ j) {
+			frames[i][j] = (ttLibC_Frame *)ttLibC_BeepGenerator_makeBeepBySampleNum(generator, NULL, 16);
+			frames[i][j]->pts = i * 100 + j;
+		}
+	}
+	// spsc keeps order.
+	ttLibC_FrameRing *ring = ttLibC_FrameRing_make(FrameRingType_spsc, 6);
+	ASSERT(ring->capacity == 8);
+	ASSERT(ttLibC_FrameRing_pop(ring) == NULL);
+	ASSERT(ttLibC_FrameRing_popWait(ring, 10) == NULL);
+	frameRingTest_Producer producer = {ring, frames[0], 16, 100000, false};
+	pthread_t thread;
+	pthread_create(&thread, NULL, frameRingTest_produce, &producer);
+	for(uint32_t i = 0;i < producer.push_num;++ i) {
+		ttLibC_Frame *frame = ttLibC_FrameRing_popWait(ring, 1000);
+		ASSERT(frame == frames[0][i % 16]);
+	}
+	pthread_join(thread, NULL);
+	// armWait and fd.
+	ASSERT(ttLibC_FrameRing_armWait(ring));
+	struct pollfd pfd = {ttLibC_FrameRing_refFd(ring), POLLIN, 0};
+	ASSERT(poll(&pfd, 1, 0) == 0);
+	ASSERT(ttLibC_FrameRing_push(ring, frames[1][0]));
+	ASSERT(poll(&pfd, 1, 0) == 1);
+	ASSERT(!ttLibC_FrameRing_armWait(ring));
+	ASSERT(ttLibC_FrameRing_pop(ring) == frames[1][0]);
+	for(int i = 0;i < 8;++ i) {
+		ASSERT(ttLibC_FrameRing_push(ring, frames[1][i]));
+	}
+	ASSERT(!ttLibC_FrameRing_push(ring, frames[1][8]));
+	// pushWait on full ring, timeout and wake up on pop.
+	ASSERT(!ttLibC_FrameRing_pushWait(ring, frames[1][8], 10));
+	producer.frames    = &frames[1][8];
+	producer.frame_num = 1;
+	producer.push_num  = 1;
+	producer.is_wait   = true;
+	pthread_create(&thread, NULL, frameRingTest_produce, &producer);
+	usleep(20000);
+	for(int i = 0;i < 8;++ i) {
+		ASSERT(ttLibC_FrameRing_pop(ring) == frames[1][i]);
+	}
+	pthread_join(thread, NULL);
+	ASSERT(ttLibC_FrameRing_pop(ring) == frames[1][8]);
+	ttLibC_FrameRing_close(&ring);
+	// mpsc keeps order for each producer.
+	ring = ttLibC_FrameRing_make(FrameRingType_mpsc, 32);
+	frameRingTest_Producer producers[4];
+	pthread_t threads[4];
+	for(int i = 0;i < 4;++ i) {
+		producers[i].ring      = ring;
+		producers[i].frames    = frames[i];
+		producers[i].frame_num = 16;
+		producers[i].push_num  = 50000;
+		producers[i].is_wait   = (i & 1) == 1;
+		pthread_create(&threads[i], NULL, frameRingTest_produce, &producers[i]);
+	}
+	uint32_t counts[4] = {0};
+	for(uint32_t i = 0;i < 4 * 50000;++ i) {
+		ttLibC_Frame *frame = ttLibC_FrameRing_popWait(ring, 1000);
+		ASSERT(frame != NULL);
+		uint32_t id = frame->pts / 100;
+		ASSERT(frame == frames[id][counts[id] % 16]);
+		++ counts[id];
+	}
+	for(int i = 0;i < 4;++ i) {
+		pthread_join(threads[i], NULL);
+		ASSERT(counts[i] == 50000);
+	}
+	ASSERT(ttLibC_FrameRing_pop(ring) == NULL);
+	ttLibC_FrameRing_close(&ring);
+	for(int i = 0;i < 4;++ i) {
+		for(int j = 0;j < 16;++ j) {
+			ttLibC_Frame_close(&frames[i][j]);
+		}
+	}
+	ttLibC_BeepGenerator_close(&generator);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+typedef struct transcodeGraphTest_Sink {
+	uint64_t count;
+	uint64_t next_pts;
+	bool is_order;
+	bool is_eos;
+} transcodeGraphTest_Sink;
+
+static bool transcodeGraphTest_gain(void *ptr, ttLibC_TranscodeNode *node, ttLibC_Frame *frame) {
+	if(frame == NULL) {
+		return true;
+	}
+	// output of component is reused, like decoder / resizer.
+	ttLibC_PcmS16 *pcm = (ttLibC_PcmS16 *)ptr;
+	memcpy(pcm->inherit_super.inherit_super.data, frame->data, pcm->l_stride);
+	pcm->inherit_super.inherit_super.pts = frame->pts;
+	return ttLibC_TranscodeNode_emit(node, (ttLibC_Frame *)pcm);
+}
+
+static bool transcodeGraphTest_sink(void *ptr, ttLibC_TranscodeNode *node, ttLibC_Frame *frame) {
+	transcodeGraphTest_Sink *sink = (transcodeGraphTest_Sink *)ptr;
+	if(frame == NULL) {
+		sink->is_eos = true;
+		return true;
+	}
+	if(frame->pts != sink->next_pts) {
+		sink->is_order = false;
+	}
+	sink->next_pts = frame->pts + 1;
+	++ sink->count;
+	return true;
+}
+
+static bool transcodeGraphTest_pass(void *ptr, ttLibC_TranscodeNode *node, ttLibC_Frame *frame) {
+	return frame == NULL || ttLibC_TranscodeNode_emit(node, frame);
+}
+
+static bool transcodeGraphTest_fail(void *ptr, ttLibC_TranscodeNode *node, ttLibC_Frame *frame) {
+	return frame == NULL || frame->pts < 10;
+}
+
+typedef struct transcodeGraphTest_Writer {
+	ttLibC_ContainerWriter *writer;
+	ttLibC_DynamicBuffer *buffer;
+	/** track id for h264 and mp3, depends on the writer. */
+	uint32_t h264_id;
+	uint32_t mp3_id;
+} transcodeGraphTest_Writer;
+
+static bool transcodeGraphTest_writeCallback(void *ptr, void *data, size_t data_size) {
+	return ttLibC_DynamicBuffer_append((ttLibC_DynamicBuffer *)ptr, (uint8_t *)data, data_size);
+}
+
+static bool transcodeGraphTest_writer(void *ptr, ttLibC_TranscodeNode *node, ttLibC_Frame *frame) {
+	transcodeGraphTest_Writer *writer = (transcodeGraphTest_Writer *)ptr;
+	if(frame == NULL) {
+		return true;
+	}
+	// track order differs for each writer, so the id is rewritten for own writer.
+	frame->id = frame->type == frameType_h264 ? writer->h264_id : writer->mp3_id;
+	return ttLibC_ContainerWriter_write(writer->writer, frame, transcodeGraphTest_writeCallback, writer->buffer);
+}
+
+typedef struct transcodeGraphTest_Source {
+	ttLibC_TranscodeGraph *graph;
+	ttLibC_TranscodeNode *node;
+	transcodeGraphTest_Writer *writers;
+} transcodeGraphTest_Source;
+
+/*
+ * push frame to graph, and write it with reference writers.
+ */
+static bool transcodeGraphTest_source(void *ptr, ttLibC_Frame *frame) {
+	transcodeGraphTest_Source *source = (transcodeGraphTest_Source *)ptr;
+	return ttLibC_TranscodeGraph_push(source->graph, source->node, frame)
+		&& transcodeGraphTest_writer(&source->writers[2], NULL, frame)
+		&& transcodeGraphTest_writer(&source->writers[3], NULL, frame);
+}
+
+static void transcodeGraphTest() {
+	LOG_PRINT("transcodeGraphTest");
+	ttLibC_BeepGenerator *generator = ttLibC_BeepGenerator_make(PcmS16Type_littleEndian, 440, 44100, 1);
+	ttLibC_PcmS16 *pcm = ttLibC_BeepGenerator_makeBeepBySampleNum(generator, NULL, 256);
+	ttLibC_PcmS16 *gain_pcm = (ttLibC_PcmS16 *)ttLibC_Frame_clone(NULL, (ttLibC_Frame *)pcm);
+	// gain -> sink x 3 (fan-out)
+	ttLibC_TranscodeGraph *graph = ttLibC_TranscodeGraph_make(32);
+	ttLibC_TranscodeNode *gain = ttLibC_TranscodeGraph_addNode(graph, "gain", 4, transcodeGraphTest_gain, gain_pcm);
+	transcodeGraphTest_Sink sinks[3];
+	for(int i = 0;i < 3;++ i) {
+		sinks[i].count    = 0;
+		sinks[i].next_pts = 0;
+		sinks[i].is_order = true;
+		sinks[i].is_eos   = false;
+		ttLibC_TranscodeNode *sink = ttLibC_TranscodeGraph_addNode(graph, "sink", 4, transcodeGraphTest_sink, &sinks[i]);
+		ASSERT(ttLibC_TranscodeGraph_connect(graph, gain, sink));
+	}
+	ASSERT(ttLibC_TranscodeGraph_start(graph));
+	for(int i = 0;i < 10000;++ i) {
+		pcm->inherit_super.inherit_super.pts = i;
+		ASSERT(ttLibC_TranscodeGraph_push(graph, gain, (ttLibC_Frame *)pcm));
+	}
+	ASSERT(ttLibC_TranscodeGraph_finish(graph));
+	ASSERT(gain->in_count == 10000);
+	ASSERT(gain->out_count == 10000);
+	for(int i = 0;i < 3;++ i) {
+		ASSERT(sinks[i].count == 10000);
+		ASSERT(sinks[i].is_order);
+		ASSERT(sinks[i].is_eos);
+	}
+	LOG_PRINT("gain utilization:%f block:%llu", ttLibC_TranscodeNode_refUtilization(gain), gain->block_time);
+	ASSERT(ttLibC_TranscodeNode_refUtilization(gain) > 0.0);
+	ttLibC_TranscodeGraph_close(&graph);
+	// node error stops graph.
+	graph = ttLibC_TranscodeGraph_make(8);
+	ttLibC_TranscodeNode *fail = ttLibC_TranscodeGraph_addNode(graph, "fail", 2, transcodeGraphTest_fail, NULL);
+	ASSERT(ttLibC_TranscodeGraph_start(graph));
+	bool is_stopped = false;
+	for(int i = 0;i < 1000 && !is_stopped;++ i) {
+		pcm->inherit_super.inherit_super.pts = i;
+		is_stopped = !ttLibC_TranscodeGraph_push(graph, fail, (ttLibC_Frame *)pcm);
+	}
+	ASSERT(is_stopped);
+	ASSERT(!ttLibC_TranscodeGraph_finish(graph));
+	ASSERT(graph->is_error);
+	ttLibC_TranscodeGraph_close(&graph);
+	// source -> mp4 writer / mpegts writer (fan-out to nodes which rewrite frame->id)
+	ttLibC_Frame_Type mp4_types[2] = {frameType_h264, frameType_mp3};
+	ttLibC_Frame_Type ts_types[2]  = {frameType_mp3, frameType_h264};
+	// writers on graph, and writers for reference on this thread.
+	transcodeGraphTest_Writer writers[4];
+	for(int i = 0;i < 4;++ i) {
+		if((i & 1) == 0) {
+			writers[i].writer  = (ttLibC_ContainerWriter *)ttLibC_Mp4Writer_make(mp4_types, 2);
+			writers[i].h264_id = 1;
+			writers[i].mp3_id  = 2;
+		}
+		else {
+			writers[i].writer  = (ttLibC_ContainerWriter *)ttLibC_MpegtsWriter_make(ts_types, 2);
+			writers[i].h264_id = 0x0101;
+			writers[i].mp3_id  = 0x0100;
+		}
+		writers[i].buffer = ttLibC_DynamicBuffer_make();
+	}
+	graph = ttLibC_TranscodeGraph_make(16);
+	ttLibC_TranscodeNode *source = ttLibC_TranscodeGraph_addNode(graph, "source", 4, transcodeGraphTest_pass, NULL);
+	ttLibC_TranscodeNode *mp4_node = ttLibC_TranscodeGraph_addNode(graph, "mp4", 4, transcodeGraphTest_writer, &writers[0]);
+	ttLibC_TranscodeNode *ts_node  = ttLibC_TranscodeGraph_addNode(graph, "ts", 4, transcodeGraphTest_writer, &writers[1]);
+	ASSERT(ttLibC_TranscodeGraph_connect(graph, source, mp4_node));
+	ASSERT(ttLibC_TranscodeGraph_connect(graph, source, ts_node));
+	ASSERT(ttLibC_TranscodeGraph_start(graph));
+	ASSERT(!ttLibC_TranscodeNode_setReadOnly(mp4_node, true));
+	transcodeGraphTest_Source source_data;
+	source_data.graph   = graph;
+	source_data.node    = source;
+	source_data.writers = writers;
+	ASSERT(containerTest_makeAvStream(transcodeGraphTest_source, &source_data, 100, 1));
+	ASSERT(ttLibC_TranscodeGraph_finish(graph));
+	ttLibC_TranscodeGraph_close(&graph);
+	// output on graph should be the same as the reference.
+	for(int i = 0;i < 2;++ i) {
+		ASSERT(ttLibC_DynamicBuffer_refSize(writers[i].buffer) > 0);
+		ASSERT(ttLibC_DynamicBuffer_refSize(writers[i].buffer) == ttLibC_DynamicBuffer_refSize(writers[i + 2].buffer));
+		ASSERT(memcmp(
+			ttLibC_DynamicBuffer_refData(writers[i].buffer),
+			ttLibC_DynamicBuffer_refData(writers[i + 2].buffer),
+			ttLibC_DynamicBuffer_refSize(writers[i].buffer)) == 0);
+	}
+	for(int i = 0;i < 4;++ i) {
+		ttLibC_ContainerWriter_close(&writers[i].writer);
+		ttLibC_DynamicBuffer_close(&writers[i].buffer);
+	}
+	ttLibC_PcmS16_close(&gain_pcm);
+	ttLibC_PcmS16_close(&pcm);
+	ttLibC_BeepGenerator_close(&generator);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+static void thumbnailTest() {
+	LOG_PRINT("thumbnailTest");
+#ifdef __ENABLE_JPEG__
+	thumbnailTest_t testData;
+	memset(&testData, 0, sizeof(testData));
+	ttLibC_Yuv420 *yuv = ttLibC_Yuv420_makeEmptyFrame(Yuv420Type_planar, 640, 360);
+	ASSERT(yuv != NULL);
+	ttLibC_Thumbnail *thumbnail = ttLibC_Thumbnail_make(160, 0, 80);
+	// yuv420 input, keep aspect.
+	for(int i = 0;i < 10;++ i) {
+		ASSERT(ttLibC_Thumbnail_convert(thumbnail, (ttLibC_Frame *)yuv, thumbnailTest_callback, &testData));
+	}
+	ASSERT(testData.count == 10);
+	ASSERT(testData.width == 160 && testData.height == 90);
+	// jpeg input, decoder is made once and reused.
+	ttLibC_JpegEncoder *encoder = ttLibC_JpegEncoder_make(640, 360, 90);
+	ASSERT(ttLibC_JpegEncoder_encode(encoder, yuv, thumbnailTest_sourceCallback, &testData));
+	ttLibC_JpegEncoder_close(&encoder);
+	for(int i = 0;i < 10;++ i) {
+		ASSERT(ttLibC_Thumbnail_convert(thumbnail, (ttLibC_Frame *)testData.source, thumbnailTest_callback, &testData));
+	}
+	ASSERT(testData.count == 20);
+	ASSERT(testData.width == 160 && testData.height == 90);
+	// nothing is held for yuv and jpeg.
+	ASSERT(ttLibC_Thumbnail_flush(thumbnail, thumbnailTest_callback, &testData));
+	ASSERT(testData.count == 20);
+	ASSERT(thumbnail->frame_count == 20 && thumbnail->thumbnail_count == 20);
+	LOG_PRINT("thumbnail/s:%f", thumbnail->thumbnail_per_sec);
+	ttLibC_Thumbnail_close(&thumbnail);
+	ttLibC_Jpeg_close(&testData.source);
+	ttLibC_Yuv420_close(&yuv);
+#endif
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+static void amfArenaTest() {
+	LOG_PRINT("amfArenaTest");
+	uint8_t buf[1024];
+	uint8_t out[1024];
+	uint32_t size = ttLibC_HexUtil_makeBuffer("080000000D00086475726174696F6E0040607547AE147AE1000577696474680040840000000000000006686569676874004076800000000000000D766964656F646174617261746500000000000000000000096672616D657261746500403DF853E2556B28000C766964656F636F6465636964004000000000000000000D617564696F6461746172617465000000000000000000000F617564696F73616D706C65726174650040E5888000000000000F617564696F73616D706C6573697A65004030000000000000000673746572656F0101000C617564696F636F64656369640040240000000000000007656E636F64657202000D4C61766635362E33362E313030000866696C6573697A65004162D2F860000000000009", buf, 1024);
+	// small block to check multi block.
+	ttLibC_Amf0Arena *arena = ttLibC_Amf0Arena_make(256);
+	ttLibC_Amf0Object *map = NULL;
+	for(int i = 0;i < 2;++ i) {
+		ttLibC_Amf0Arena_reset(arena);
+		ASSERT(ttLibC_Amf0_readArena(arena, buf, size, amfArenaTest_read, &map));
+		ASSERT(map != NULL && map->type == amf0Type_Map);
+		ASSERT(*((double *)ttLibC_Amf0_getElement(map, "width")->object) == 640);
+		ASSERT(strcmp((const char *)ttLibC_Amf0_getElement(map, "encoder")->object, "Lavf56.36.100") == 0);
+		ASSERT(*((uint8_t *)ttLibC_Amf0_getElement(map, "stereo")->object) == 1);
+		ASSERT(ttLibC_Amf0_getElement(map, "unknown") == NULL);
+		// write back, same binary.
+		ASSERT(ttLibC_Amf0_writeBuffer(map, out, sizeof(out)) == size);
+		ASSERT(memcmp(buf, out, size) == 0);
+		ASSERT(ttLibC_Amf0_writeBuffer(map, out, size - 1) == 0);
+	}
+	// clone to other arena.
+	ttLibC_Amf0Arena *clone_arena = ttLibC_Amf0Arena_make(256);
+	ttLibC_Amf0Object *arena_cloned = ttLibC_Amf0_cloneArena(clone_arena, map);
+	// clone to heap object.
+	ttLibC_Amf0Object *cloned = ttLibC_Amf0_clone(map);
+	ttLibC_Amf0Arena_close(&arena);
+	ASSERT(arena_cloned != NULL);
+	ASSERT(*((double *)ttLibC_Amf0_getElement(arena_cloned, "filesize")->object) == 9869251);
+	ASSERT(*((uint8_t *)ttLibC_Amf0_getElement(arena_cloned, "stereo")->object) == 1);
+	ASSERT(ttLibC_Amf0_writeBuffer(arena_cloned, out, sizeof(out)) == size);
+	ASSERT(memcmp(buf, out, size) == 0);
+	ttLibC_Amf0Arena_close(&clone_arena);
+	ASSERT(*((double *)ttLibC_Amf0_getElement(cloned, "height")->object) == 360);
+	ASSERT(ttLibC_Amf0_writeBuffer(cloned, out, sizeof(out)) == size);
+	ASSERT(memcmp(buf, out, size) == 0);
+	ttLibC_Amf0_close(&cloned);
+	// corrupted data.
+	arena = ttLibC_Amf0Arena_make(256);
+	ASSERT(!ttLibC_Amf0_readArena(arena, buf, size - 1, amfArenaTest_read, &map));
+	ttLibC_Amf0Arena_close(&arena);
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
 static void amfTest() {
 	LOG_PRINT("amfTest");
 	uint8_t buf[1024];
@@ -716,6 +1408,63 @@ static void crc32Test() {
 	ASSERT(ttLibC_Allocator_dump() == 0);
 }
 
+static void statsTest_entry(uint32_t wait) {
+	ttLibC_Stats_scope(StatsApi_encode);
+	usleep(wait);
+}
+
+static void statsTest() {
+	LOG_PRINT("statsTest");
+	ttLibC_Stats_reset();
+	ttLibC_BeepGenerator *generator = ttLibC_BeepGenerator_make(PcmS16Type_littleEndian, 440, 44100, 2);
+	ttLibC_PcmS16 *pcm = ttLibC_BeepGenerator_makeBeepByMiliSec(generator, NULL, 100);
+	ttLibC_Stats stats;
+	ttLibC_Stats_snapshot(&stats);
+	for(int i = 0;i < StatsModule_num;++ i) {
+		LOG_PRINT("%s count:%llu size:%llu",
+				ttLibC_Stats_getModuleName((ttLibC_Stats_Module)i),
+				stats.modules[i].alloc_count,
+				stats.modules[i].alloc_size);
+	}
+	ASSERT(stats.modules[StatsModule_util].alloc_count > 0);
+	ASSERT(stats.modules[StatsModule_frame].alloc_count > 0);
+	ASSERT(stats.modules[StatsModule_util].alloc_size >= 4410 * 2 * 2);
+	ASSERT(stats.modules[StatsModule_container].alloc_count == 0);
+	ASSERT(ttLibC_Allocator_refAllocCount() == stats.modules[StatsModule_util].alloc_count + stats.modules[StatsModule_frame].alloc_count);
+	ttLibC_PcmS16_close(&pcm);
+	ttLibC_BeepGenerator_close(&generator);
+	ttLibC_Stats_snapshot(&stats);
+	ASSERT(stats.free_count > 0);
+	// percentile from histogram.
+	ttLibC_Stats_ApiStats api_stats;
+	memset(&api_stats, 0, sizeof(api_stats));
+	ASSERT(ttLibC_Stats_getPercentile(&api_stats, 0.5) == 0);
+	api_stats.call_count = 100;
+	api_stats.histogram[3] = 90;
+	api_stats.histogram[10] = 10;
+	ASSERT(ttLibC_Stats_getPercentile(&api_stats, 0.5) == 8);
+	ASSERT(ttLibC_Stats_getPercentile(&api_stats, 0.95) == 1024);
+	// latency for each entry point.
+	for(int i = 0;i < 4;++ i) {
+		statsTest_entry(i == 0 ? 5000 : 0);
+	}
+	ttLibC_Stats_snapshot(&stats);
+	ttLibC_Stats_ApiStats *entry_stats = ttLibC_Stats_findEntry(&stats, "utilTest", StatsApi_encode);
+	ASSERT(entry_stats != NULL);
+	ASSERT(entry_stats->call_count == 4);
+	ASSERT(ttLibC_Stats_getPercentile(entry_stats, 0.99) >= 4096);
+	ASSERT(ttLibC_Stats_findEntry(&stats, "utilTest", StatsApi_decode) == NULL);
+	ASSERT(stats.apis[StatsApi_encode].call_count >= 4);
+	for(uint32_t i = 0;i < stats.entry_num;++ i) {
+		LOG_PRINT("%s %s count:%llu p99:%lluus",
+				stats.entries[i].name,
+				ttLibC_Stats_getApiName(stats.entries[i].api),
+				stats.entries[i].stats.call_count,
+				ttLibC_Stats_getPercentile(&stats.entries[i].stats, 0.99));
+	}
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
 static void ioTest() {
 	LOG_PRINT("ioTest");
 	uint64_t num = 0x12345678;
@@ -754,6 +1503,128 @@ static void ioTest() {
 	ASSERT(ttLibC_Allocator_dump() == 0);
 }
 
+#ifdef __ENABLE_FILE__
+static bool fileIoTest_getFrameCallback(void *ptr, ttLibC_Frame *frame) {
+	++ *((uint32_t *)ptr);
+	return true;
+}
+
+static bool fileIoTest_readCallback(void *ptr, ttLibC_Container *container) {
+	return ttLibC_Container_getFrame(container, fileIoTest_getFrameCallback, ptr);
+}
+
+typedef struct fileIoTest_Mp4 {
+	ttLibC_ContainerWriter *writer;
+	ttLibC_FileSink *sink;
+	uint32_t h264_num;
+	uint64_t h264_sum;
+} fileIoTest_Mp4;
+
+static bool fileIoTest_mp4Write(void *ptr, ttLibC_Frame *frame) {
+	fileIoTest_Mp4 *testData = (fileIoTest_Mp4 *)ptr;
+	return ttLibC_ContainerWriter_write(testData->writer, frame, ttLibC_FileSink_write, testData->sink);
+}
+
+static bool fileIoTest_mp4GetFrameCallback(void *ptr, ttLibC_Frame *frame) {
+	fileIoTest_Mp4 *testData = (fileIoTest_Mp4 *)ptr;
+	if(frame->type == frameType_h264) {
+		++ testData->h264_num;
+		uint8_t *data = (uint8_t *)frame->data;
+		for(size_t i = 0;i < frame->buffer_size;++ i) {
+			testData->h264_sum += data[i];
+		}
+	}
+	return true;
+}
+
+static bool fileIoTest_mp4ReadCallback(void *ptr, ttLibC_Container *container) {
+	return ttLibC_Container_getFrame(container, fileIoTest_mp4GetFrameCallback, ptr);
+}
+#endif
+
+static void fileIoTest() {
+	LOG_PRINT("fileIoTest");
+#ifdef __ENABLE_FILE__
+	// mp3 v1 layer3 128kbps 44100Hz, 417byte and 418byte(padding) frames.
+	std::vector<uint8_t> mp3;
+	for(int i = 0;i < 20;++ i) {
+		size_t pos = mp3.size();
+		mp3.resize(pos + 417 + (i & 1), 0);
+		mp3[pos] = 0xFF;
+		mp3[pos + 1] = 0xFB;
+		mp3[pos + 2] = (i & 1) ? 0x92 : 0x90;
+		mp3[pos + 3] = 0x64;
+	}
+	char path[] = "/tmp/ttLibC_fileIoTest.mp3";
+	// small buffer, try O_DIRECT. (fallback to normal write for tmpfs)
+	ttLibC_FileSink *sink = ttLibC_FileSink_make(path, 1000, true);
+	ASSERT(sink != NULL);
+	for(size_t pos = 0;pos < mp3.size();pos += 333) {
+		size_t size = mp3.size() - pos;
+		if(size > 333) {
+			size = 333;
+		}
+		ASSERT(ttLibC_FileSink_write(sink, &mp3[pos], size));
+	}
+	ASSERT(ttLibC_FileSink_flush(sink));
+	ASSERT(sink->write_size == mp3.size());
+	ASSERT(sink->flush_count >= 2);
+	ttLibC_FileSink_close(&sink);
+	ASSERT(sink == NULL);
+
+	ttLibC_FileSource *source = ttLibC_FileSource_make(path);
+	ASSERT(source != NULL);
+	ASSERT(source->size == mp3.size());
+	ASSERT(memcmp(ttLibC_FileSource_refData(source), mp3.data(), mp3.size()) == 0);
+	ttLibC_ContainerReader *reader = (ttLibC_ContainerReader *)ttLibC_Mp3Reader_make();
+	uint32_t frame_count = 0;
+	ASSERT(ttLibC_FileSource_read(source, reader, fileIoTest_readCallback, &frame_count));
+	ASSERT(frame_count == 20);
+	ttLibC_ContainerReader_close(&reader);
+	ttLibC_FileSource_close(&source);
+	unlink(path);
+	ASSERT(ttLibC_FileSource_make(path) == NULL);
+
+	// mp4 reader rewrites nal size in place, source should be readable again with small slices.
+	char mp4_path[] = "/tmp/ttLibC_fileIoTest.mp4";
+	ttLibC_Frame_Type mp4_types[2] = {frameType_h264, frameType_mp3};
+	fileIoTest_Mp4 testData;
+	memset(&testData, 0, sizeof(testData));
+	testData.writer = (ttLibC_ContainerWriter *)ttLibC_Mp4Writer_make(mp4_types, 2);
+	testData.sink = ttLibC_FileSink_make(mp4_path, 0, false);
+	ASSERT(containerTest_makeAvStream(fileIoTest_mp4Write, &testData, 100, 1));
+	ttLibC_ContainerWriter_close(&testData.writer);
+	ttLibC_FileSink_close(&testData.sink);
+	source = ttLibC_FileSource_make(mp4_path);
+	ASSERT(source != NULL);
+	ASSERT(source->size > 4096 * 4);
+	// whole file in one slice (rewritten in the mapping), again, then small slices.
+	uint32_t h264_num[3];
+	uint64_t h264_sum[3];
+	for(int i = 0;i < 3;++ i) {
+		if(i == 2) {
+			source->slice_size = 4096;
+		}
+		testData.h264_num = 0;
+		testData.h264_sum = 0;
+		reader = (ttLibC_ContainerReader *)ttLibC_Mp4Reader_make();
+		ASSERT(ttLibC_FileSource_read(source, reader, fileIoTest_mp4ReadCallback, &testData));
+		ttLibC_ContainerReader_close(&reader);
+		h264_num[i] = testData.h264_num;
+		h264_sum[i] = testData.h264_sum;
+	}
+	LOG_PRINT("mp4 size:%zu h264:%u", source->size, h264_num[0]);
+	ASSERT(h264_num[0] > 0);
+	for(int i = 1;i < 3;++ i) {
+		ASSERT(h264_num[0] == h264_num[i]);
+		ASSERT(h264_sum[0] == h264_sum[i]);
+	}
+	ttLibC_FileSource_close(&source);
+	unlink(mp4_path);
+#endif
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
 #ifdef __ENABLE_FILE__
 bool httpClientCallback(void *ptr, ttLibC_HttpClient *client, void *data, size_t data_size) {
 	LOG_PRINT("callback is called.");
@@ -762,6 +1633,289 @@ bool httpClientCallback(void *ptr, ttLibC_HttpClient *client, void *data, size_t
 }
 #endif
 
+#ifdef __ENABLE_FILE__
+typedef struct httpServerTest_t {
+	int listen_sock;
+	volatile bool is_stop;
+	int accept_num;
+	uint8_t body[1000];
+	/** not 0:close connection when body reaches this position. */
+	size_t cut_position;
+} httpServerTest_t;
+
+static void *httpServerTest_connection(void *arg) {
+	httpServerTest_t *server = (httpServerTest_t *)((void **)arg)[0];
+	int sock = (int)(intptr_t)((void **)arg)[1];
+	char buf[4096];
+	size_t size = 0;
+	bool is_killed = false;
+	while(!is_killed) {
+		ssize_t read_size = recv(sock, buf + size, sizeof(buf) - size - 1, 0);
+		if(read_size <= 0) {
+			break;
+		}
+		size += read_size;
+		buf[size] = 0x00;
+		char *end;
+		// reply for each pipelined request.
+		while(!is_killed && (end = strstr(buf, "\r\n\r\n")) != NULL) {
+			char path[256] = "";
+			sscanf(buf, "GET %255s", path);
+			char reply[1200];
+			int reply_size = 0;
+			if(strcmp(path, "/chunked") == 0) {
+				// send 1000 bytes with 3 chunks.
+				reply_size = sprintf(reply, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n");
+				send(sock, reply, reply_size, 0);
+				int chunks[3] = {100, 400, 500};
+				uint8_t *b = server->body;
+				for(int i = 0;i < 3;++ i) {
+					reply_size = sprintf(reply, "%x\r\n", chunks[i]);
+					memcpy(reply + reply_size, b, chunks[i]);
+					reply_size += chunks[i];
+					reply_size += sprintf(reply + reply_size, "\r\n");
+					send(sock, reply, reply_size, 0);
+					b += chunks[i];
+				}
+				send(sock, "0\r\n\r\n", 5, 0);
+			}
+			else if(strcmp(path, "/stall") == 0) {
+				// send first chunk, and hold the rest until client drops connection.
+				reply_size = sprintf(reply, "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n64\r\n");
+				memcpy(reply + reply_size, server->body, 100);
+				reply_size += 100;
+				reply_size += sprintf(reply + reply_size, "\r\n");
+				send(sock, reply, reply_size, 0);
+				while(recv(sock, buf, sizeof(buf) - 1, 0) > 0) {
+				}
+				is_killed = true;
+				continue;
+			}
+			else {
+				size_t start = 0, last = 999;
+				char *range = strstr(buf, "Range: bytes=");
+				if(range != NULL && range < end) {
+					sscanf(range, "Range: bytes=%zu-%zu", &start, &last);
+				}
+				if(start > 999) {
+					reply_size = sprintf(reply, "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Length: 0\r\n\r\n");
+					send(sock, reply, reply_size, 0);
+					size -= (end + 4 - buf);
+					memmove(buf, end + 4, size);
+					buf[size] = 0x00;
+					continue;
+				}
+				if(last > 999) {
+					last = 999;
+				}
+				reply_size = sprintf(reply, "HTTP/1.1 206 Partial Content\r\nContent-Length: %zu\r\nContent-Range: bytes %zu-%zu/1000\r\n\r\n", last - start + 1, start, last);
+				if(server->cut_position != 0 && last >= server->cut_position) {
+					// server is killed in the middle of body.
+					if(start < server->cut_position) {
+						memcpy(reply + reply_size, server->body + start, server->cut_position - start);
+						reply_size += server->cut_position - start;
+					}
+					send(sock, reply, reply_size, 0);
+					is_killed = true;
+					continue;
+				}
+				memcpy(reply + reply_size, server->body + start, last - start + 1);
+				reply_size += last - start + 1;
+				send(sock, reply, reply_size, 0);
+			}
+			size -= (end + 4 - buf);
+			memmove(buf, end + 4, size);
+			buf[size] = 0x00;
+		}
+	}
+	close(sock);
+	return NULL;
+}
+
+static void *httpServerTest_accept(void *arg) {
+	httpServerTest_t *server = (httpServerTest_t *)arg;
+	pthread_t threads[8];
+	void *args[8][2];
+	while(!server->is_stop && server->accept_num < 8) {
+		struct pollfd pfd;
+		pfd.fd = server->listen_sock;
+		pfd.events = POLLIN;
+		if(poll(&pfd, 1, 50) <= 0) {
+			continue;
+		}
+		int sock = accept(server->listen_sock, NULL, NULL);
+		if(sock < 0) {
+			continue;
+		}
+		args[server->accept_num][0] = server;
+		args[server->accept_num][1] = (void *)(intptr_t)sock;
+		pthread_create(&threads[server->accept_num], NULL, httpServerTest_connection, args[server->accept_num]);
+		++ server->accept_num;
+	}
+	for(int i = 0;i < server->accept_num;++ i) {
+		pthread_join(threads[i], NULL);
+	}
+	return NULL;
+}
+
+typedef struct httpKeepAliveTest_t {
+	uint8_t data[4][1000];
+	size_t size[4];
+} httpKeepAliveTest_t;
+
+static bool httpKeepAliveTest_callback(void *ptr, ttLibC_HttpClient *client, void *data, size_t data_size) {
+	httpKeepAliveTest_t *result = (httpKeepAliveTest_t *)ptr;
+	uint32_t index = client->range_index;
+	memcpy(result->data[index] + result->size[index], data, data_size);
+	result->size[index] += data_size;
+	return true;
+}
+
+static bool httpKeepAliveTest_stopCallback(void *ptr, ttLibC_HttpClient *client, void *data, size_t data_size) {
+	httpKeepAliveTest_callback(ptr, client, data, data_size);
+	return false;
+}
+#endif
+
+static void httpKeepAliveTest() {
+	LOG_PRINT("httpKeepAliveTest");
+#ifdef __ENABLE_FILE__
+	httpServerTest_t server;
+	memset(&server, 0, sizeof(server));
+	for(int i = 0;i < 1000;++ i) {
+		server.body[i] = (uint8_t)(i * 13 + 1);
+	}
+	server.listen_sock = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	ASSERT(bind(server.listen_sock, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+	socklen_t addr_len = sizeof(addr);
+	getsockname(server.listen_sock, (struct sockaddr *)&addr, &addr_len);
+	listen(server.listen_sock, 8);
+	pthread_t thread;
+	pthread_create(&thread, NULL, httpServerTest_accept, &server);
+
+	char address[256];
+	sprintf(address, "http://127.0.0.1:%d/data", ntohs(addr.sin_port));
+	ttLibC_HttpClient *client = ttLibC_HttpClient_make(256, 0);
+	ttLibC_HttpClient_setKeepAlive(client, 2);
+	httpKeepAliveTest_t result;
+	// single range requests on the same connection.
+	for(int i = 0;i < 3;++ i) {
+		memset(&result, 0, sizeof(result));
+		ttLibC_HttpClient_getRange(client, address, 100 * i, 300, true, httpKeepAliveTest_callback, &result);
+		ASSERT(result.size[0] == 300);
+		ASSERT(memcmp(result.data[0], server.body + 100 * i, 300) == 0);
+		ASSERT(client->file_length == 1000);
+	}
+	// pipelined ranges.
+	size_t starts[4] = {0, 250, 500, 900};
+	size_t lengths[4] = {250, 250, 400, 100};
+	memset(&result, 0, sizeof(result));
+	ASSERT(ttLibC_HttpClient_getRanges(client, address, starts, lengths, 4, true, httpKeepAliveTest_callback, &result));
+	for(int i = 0;i < 4;++ i) {
+		ASSERT(result.size[i] == lengths[i]);
+		ASSERT(memcmp(result.data[i], server.body + starts[i], lengths[i]) == 0);
+	}
+	// chunked transfer.
+	sprintf(address, "http://127.0.0.1:%d/chunked", ntohs(addr.sin_port));
+	memset(&result, 0, sizeof(result));
+	ttLibC_HttpClient_get(client, address, true, httpKeepAliveTest_callback, &result);
+	ASSERT(result.size[0] == 1000);
+	ASSERT(memcmp(result.data[0], server.body, 1000) == 0);
+	ASSERT(client->reuse_count == 4);
+	// stop in the middle of chunked body, must not wait for the rest.
+	sprintf(address, "http://127.0.0.1:%d/stall", ntohs(addr.sin_port));
+	memset(&result, 0, sizeof(result));
+	ttLibC_HttpClient_get(client, address, true, httpKeepAliveTest_stopCallback, &result);
+	ASSERT(result.size[0] == 100);
+	ASSERT(memcmp(result.data[0], server.body, 100) == 0);
+	// stopped connection is dropped, next request uses new one.
+	sprintf(address, "http://127.0.0.1:%d/data", ntohs(addr.sin_port));
+	memset(&result, 0, sizeof(result));
+	ttLibC_HttpClient_getRange(client, address, 0, 300, true, httpKeepAliveTest_callback, &result);
+	ASSERT(result.size[0] == 300);
+	ASSERT(client->reuse_count == 5);
+	ttLibC_HttpClient_close(&client);
+	server.is_stop = true;
+	pthread_join(thread, NULL);
+	close(server.listen_sock);
+	ASSERT(server.accept_num == 2);
+#endif
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
+#ifdef __ENABLE_FILE__
+static bool httpStreamTest_callback(void *ptr, void *data, size_t data_size) {
+	std::vector<uint8_t> *result = (std::vector<uint8_t> *)ptr;
+	result->insert(result->end(), (uint8_t *)data, (uint8_t *)data + data_size);
+	return true;
+}
+#endif
+
+static void httpStreamTest() {
+	LOG_PRINT("httpStreamTest");
+#ifdef __ENABLE_FILE__
+	httpServerTest_t server;
+	memset(&server, 0, sizeof(server));
+	for(int i = 0;i < 1000;++ i) {
+		server.body[i] = (uint8_t)(i * 7 + 5);
+	}
+	server.listen_sock = socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = 0;
+	ASSERT(bind(server.listen_sock, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+	socklen_t addr_len = sizeof(addr);
+	getsockname(server.listen_sock, (struct sockaddr *)&addr, &addr_len);
+	listen(server.listen_sock, 8);
+	pthread_t thread;
+	pthread_create(&thread, NULL, httpServerTest_accept, &server);
+
+	char address[256];
+	sprintf(address, "http://127.0.0.1:%d/data", ntohs(addr.sin_port));
+	ttLibC_HttpStream *stream = ttLibC_HttpStream_make(address, 64, 256, 3);
+	std::vector<uint8_t> result;
+	while(ttLibC_HttpStream_read(stream, httpStreamTest_callback, &result)) {
+	}
+	ASSERT(!stream->is_error);
+	ASSERT(stream->is_eof);
+	ASSERT(stream->file_length == 1000);
+	ASSERT(stream->read_position == 1000);
+	ASSERT(result.size() == 1000);
+	ASSERT(memcmp(result.data(), server.body, 1000) == 0);
+	LOG_PRINT("request:%llu read_stall:%llu fetch_stall:%llu chunk:%zu",
+			(unsigned long long)stream->request_count,
+			(unsigned long long)stream->read_stall_count,
+			(unsigned long long)stream->fetch_stall_count,
+			stream->chunk_size);
+	ttLibC_HttpStream_close(&stream);
+
+	// server is killed in the middle of body, should be error, not eof.
+	server.cut_position = 500;
+	stream = ttLibC_HttpStream_make(address, 64, 256, 3);
+	result.clear();
+	while(ttLibC_HttpStream_read(stream, httpStreamTest_callback, &result)) {
+	}
+	ASSERT(stream->is_error);
+	ASSERT(!stream->is_eof);
+	ASSERT(stream->read_position < 500);
+	ASSERT(result.size() == stream->read_position);
+	ASSERT(memcmp(result.data(), server.body, result.size()) == 0);
+	ttLibC_HttpStream_close(&stream);
+	server.is_stop = true;
+	pthread_join(thread, NULL);
+	close(server.listen_sock);
+	ASSERT(server.accept_num == 2);
+#endif
+	ASSERT(ttLibC_Allocator_dump() == 0);
+}
+
 static void httpClientTest() {
 	LOG_PRINT("httpClientTest");
 #ifdef __ENABLE_FILE__
@@ -864,10 +2018,21 @@ cute::suite utilTests(cute::suite s) {
 	s.push_back(CUTE(byteUtilH26XTest));
 	s.push_back(CUTE(connectorTest));
 	s.push_back(CUTE(dynamicBufferTest));
+	s.push_back(CUTE(audioMixerTest));
+	s.push_back(CUTE(audioSyncTest));
+	s.push_back(CUTE(framePoolTest));
+	s.push_back(CUTE(frameRingTest));
+	s.push_back(CUTE(transcodeGraphTest));
+	s.push_back(CUTE(thumbnailTest));
 	s.push_back(CUTE(amfTest));
+	s.push_back(CUTE(amfArenaTest));
 	s.push_back(CUTE(crc32Test));
+	s.push_back(CUTE(statsTest));
 	s.push_back(CUTE(ioTest));
+	s.push_back(CUTE(fileIoTest));
 	s.push_back(CUTE(httpClientTest));
+	s.push_back(CUTE(httpKeepAliveTest));
+	s.push_back(CUTE(httpStreamTest));
 	s.push_back(CUTE(hexUtilTest));
 	s.push_back(CUTE(opencvUtilTest));
 	s.push_back(CUTE(openalUtilTest));
@@ -12,13 +12,19 @@
 #include "_log.h"
 
 #include "allocator.h"
+#include "util/statsUtil.h"
 #include <stdint.h>
 
 #if __DEBUG_FLAG__ == 1
 #	include "khash.h"
+#	include <pthread.h>
 
 KHASH_MAP_INIT_INT64(ttLibC_Allocator, void *)
 static khash_t(ttLibC_Allocator) *ttLibC_Allocator_Table = NULL;
+/*
+ * table is shared with worker threads. (transcodeGraph, frameRing users...)
+ */
+static pthread_mutex_t ttLibC_Allocator_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 typedef struct {
 	size_t alloc_size;
@@ -36,9 +42,13 @@ typedef struct {
  */
 void TT_VISIBILITY_DEFAULT *ttLibC_Allocator_malloc(size_t size, const char *file_name, int line, const char *func_name) {
 	void *ptr = malloc(size);
+	if(ptr) {
+		ttLibC_Stats_countAlloc(file_name, size);
+	}
 #if __DEBUG_FLAG__ == 1
 	int ret;
 	if(ptr) {
+		pthread_mutex_lock(&ttLibC_Allocator_mutex);
 		if(ttLibC_Allocator_Table != NULL) {
 			ttLibC_Allocator_Info *info = malloc(sizeof(ttLibC_Allocator_Info));
 			info->alloc_size = size;
@@ -46,6 +56,7 @@ void TT_VISIBILITY_DEFAULT *ttLibC_Allocator_malloc(size_t size, const char *fil
 			khiter_t it = kh_put(ttLibC_Allocator, ttLibC_Allocator_Table, (uint64_t)ptr, &ret);
 			kh_value(ttLibC_Allocator_Table, it) = info;
 		}
+		pthread_mutex_unlock(&ttLibC_Allocator_mutex);
 	}
 #endif
 	return ptr;
@@ -62,9 +73,13 @@ void TT_VISIBILITY_DEFAULT *ttLibC_Allocator_malloc(size_t size, const char *fil
  */
 void TT_VISIBILITY_DEFAULT *ttLibC_Allocator_calloc(size_t n, size_t size, const char *file_name, int line, const char *func_name) {
 	void *ptr = calloc(n, size);
+	if(ptr) {
+		ttLibC_Stats_countAlloc(file_name, n * size);
+	}
 #if __DEBUG_FLAG__ == 1
 	int ret;
 	if(ptr) {
+		pthread_mutex_lock(&ttLibC_Allocator_mutex);
 		if(ttLibC_Allocator_Table != NULL) {
 			ttLibC_Allocator_Info *info = malloc(sizeof(ttLibC_Allocator_Info));
 			info->alloc_size = n * size;
@@ -72,6 +87,7 @@ void TT_VISIBILITY_DEFAULT *ttLibC_Allocator_calloc(size_t n, size_t size, const
 			khiter_t it = kh_put(ttLibC_Allocator, ttLibC_Allocator_Table, (uint64_t)ptr, &ret);
 			kh_value(ttLibC_Allocator_Table, it) = info;
 		}
+		pthread_mutex_unlock(&ttLibC_Allocator_mutex);
 	}
 #endif
 	return ptr;
@@ -83,12 +99,15 @@ void TT_VISIBILITY_DEFAULT *ttLibC_Allocator_calloc(size_t n, size_t size, const
  */
 void TT_VISIBILITY_DEFAULT ttLibC_Allocator_free(void *ptr) {
 	if(ptr) {
+		ttLibC_Stats_countFree();
 #if __DEBUG_FLAG__ == 1
+		pthread_mutex_lock(&ttLibC_Allocator_mutex);
 		if(ttLibC_Allocator_Table != NULL) {
 			khiter_t it = kh_get(ttLibC_Allocator, ttLibC_Allocator_Table, (uint64_t)ptr);
 			free(kh_value(ttLibC_Allocator_Table, it));
 			kh_del(ttLibC_Allocator, ttLibC_Allocator_Table, it);
 		}
+		pthread_mutex_unlock(&ttLibC_Allocator_mutex);
 #endif
 		free(ptr);
 	}
@@ -100,10 +119,13 @@ void TT_VISIBILITY_DEFAULT ttLibC_Allocator_free(void *ptr) {
  */
 bool TT_VISIBILITY_DEFAULT ttLibC_Allocator_init() {
 #if __DEBUG_FLAG__ == 1
+	pthread_mutex_lock(&ttLibC_Allocator_mutex);
 	if(ttLibC_Allocator_Table == NULL) {
 		ttLibC_Allocator_Table = kh_init(ttLibC_Allocator);
 	}
-	return ttLibC_Allocator_Table != NULL;
+	bool result = ttLibC_Allocator_Table != NULL;
+	pthread_mutex_unlock(&ttLibC_Allocator_mutex);
+	return result;
 #else
 	return false;
 #endif
@@ -115,7 +137,9 @@ bool TT_VISIBILITY_DEFAULT ttLibC_Allocator_init() {
  */
 size_t TT_VISIBILITY_DEFAULT ttLibC_Allocator_dump() {
 #if __DEBUG_FLAG__ == 1
+	pthread_mutex_lock(&ttLibC_Allocator_mutex);
 	if(ttLibC_Allocator_Table == NULL) {
+		pthread_mutex_unlock(&ttLibC_Allocator_mutex);
 		return 0;
 	}
 	khiter_t it;
@@ -129,17 +153,37 @@ size_t TT_VISIBILITY_DEFAULT ttLibC_Allocator_dump() {
 		}
 	}
 	printf("total_size:%lu\n", total_size);
+	pthread_mutex_unlock(&ttLibC_Allocator_mutex);
 	return total_size;
 #else
 	return 0;
 #endif
 }
 
+/*
+ * ref the number of allocation.
+ * @return number of malloc / calloc call from program start or ttLibC_Stats_reset.
+ */
+uint64_t TT_VISIBILITY_DEFAULT ttLibC_Allocator_refAllocCount() {
+	ttLibC_Stats stats;
+	ttLibC_Stats_snapshot(&stats);
+	uint64_t count = 0;
+	for(int i = 0;i < StatsModule_num;++ i) {
+		count += stats.modules[i].alloc_count;
+	}
+	return count;
+}
+
 /*
  * close information table.
  */
 void TT_VISIBILITY_DEFAULT ttLibC_Allocator_close() {
 #if __DEBUG_FLAG__ == 1
+	pthread_mutex_lock(&ttLibC_Allocator_mutex);
+	if(ttLibC_Allocator_Table == NULL) {
+		pthread_mutex_unlock(&ttLibC_Allocator_mutex);
+		return;
+	}
 	khiter_t it;
 	for(it = kh_begin(ttLibC_Allocator_Table);it != kh_end(ttLibC_Allocator_Table); ++ it) {
 		if(kh_exist(ttLibC_Allocator_Table, it)) {
@@ -149,5 +193,6 @@ void TT_VISIBILITY_DEFAULT ttLibC_Allocator_close() {
 	kh_clear(ttLibC_Allocator, ttLibC_Allocator_Table);
 	kh_destroy(ttLibC_Allocator, ttLibC_Allocator_Table);
 	ttLibC_Allocator_Table = NULL;
+	pthread_mutex_unlock(&ttLibC_Allocator_mutex);
 #endif
 }
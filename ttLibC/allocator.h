@@ -18,6 +18,7 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -81,6 +82,13 @@ bool ttLibC_Allocator_init();
  */
 size_t ttLibC_Allocator_dump();
 
+/**
+ * ref the number of allocation.
+ * this works without init, and is used for allocations/op of benchmark.
+ * @return number of malloc / calloc call from program start or ttLibC_Stats_reset.
+ */
+uint64_t ttLibC_Allocator_refAllocCount();
+
 /**
  * close information table.
  */
@@ -0,0 +1,462 @@
+/*
+ * @file   batchRemux.c
+ * @brief  remux many files in parallel, on a work stealing thread pool.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifdef __ENABLE_FILE__
+
+#include "batchRemux.h"
+#include "containerCommon.h"
+#include "flv.h"
+#include "mkv.h"
+#include "mp3.h"
+#include "mp4.h"
+#include "mpegts.h"
+
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+#include "../util/fileIoUtil.h"
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+/*
+ * detail definition of job.
+ */
+typedef struct {
+	ttLibC_BatchRemuxJob    inherit_super;
+	ttLibC_Frame_Type       types[ttLibC_BatchRemux_maxTypesNum];
+	uint32_t                types_num;
+	/** id of input frame for each output track. */
+	uint32_t                track_ids[ttLibC_BatchRemux_maxTypesNum];
+	bool                    is_track_found[ttLibC_BatchRemux_maxTypesNum];
+	ttLibC_ContainerWriter *writer;
+	ttLibC_FileSink        *sink;
+} BatchRemux_Job;
+
+struct ttLibC_Container_BatchRemux_;
+
+/*
+ * worker thread, holds the deque of job index.
+ * owner takes from head, thief takes from tail.
+ */
+typedef struct {
+	struct ttLibC_Container_BatchRemux_ *batch;
+	uint32_t        index;
+	pthread_t       thread;
+	bool            is_started;
+	pthread_mutex_t mutex;
+	/** slice of job_indices of batch. */
+	uint32_t       *job_indices;
+	uint32_t        head;
+	uint32_t        tail;
+	uint32_t        steal_num;
+	uint32_t        error_num;
+} BatchRemux_Worker;
+
+/*
+ * detail definition of batch remux.
+ */
+typedef struct ttLibC_Container_BatchRemux_ {
+	ttLibC_BatchRemux  inherit_super;
+	BatchRemux_Job   **jobs;
+	uint32_t           job_capacity;
+	BatchRemux_Worker *workers;
+	uint32_t           worker_num;
+	uint32_t          *job_indices;
+} ttLibC_Container_BatchRemux_;
+
+typedef ttLibC_Container_BatchRemux_ ttLibC_BatchRemux_;
+
+ttLibC_BatchRemux TT_VISIBILITY_DEFAULT *ttLibC_BatchRemux_make(uint32_t thread_num) {
+	ttLibC_BatchRemux_ *batch = ttLibC_malloc(sizeof(ttLibC_BatchRemux_));
+	if(batch == NULL) {
+		ERR_PRINT("failed to allocate memory for batch remux.");
+		return NULL;
+	}
+	memset(batch, 0, sizeof(ttLibC_BatchRemux_));
+	if(thread_num == 0) {
+		long cpu_num = sysconf(_SC_NPROCESSORS_ONLN);
+		thread_num = cpu_num > 0 ? (uint32_t)cpu_num : 1;
+	}
+	batch->inherit_super.thread_num = thread_num;
+	return (ttLibC_BatchRemux *)batch;
+}
+
+/*
+ * copy string with allocator.
+ */
+static char *BatchRemux_copyString(const char *str) {
+	size_t length = strlen(str);
+	char *copy = ttLibC_malloc(length + 1);
+	if(copy != NULL) {
+		memcpy(copy, str, length + 1);
+	}
+	return copy;
+}
+
+static void BatchRemux_closeJob(BatchRemux_Job **job) {
+	BatchRemux_Job *target = *job;
+	if(target == NULL) {
+		return;
+	}
+	ttLibC_free((void *)target->inherit_super.input_path);
+	ttLibC_free((void *)target->inherit_super.output_path);
+	ttLibC_free(target);
+	*job = NULL;
+}
+
+ttLibC_BatchRemuxJob TT_VISIBILITY_DEFAULT *ttLibC_BatchRemux_addJob(
+		ttLibC_BatchRemux *batch,
+		const char *input_path,
+		ttLibC_Container_Type input_type,
+		const char *output_path,
+		ttLibC_Container_Type output_type,
+		ttLibC_Frame_Type *types,
+		uint32_t types_num) {
+	ttLibC_BatchRemux_ *batch_ = (ttLibC_BatchRemux_ *)batch;
+	if(batch_ == NULL || input_path == NULL || output_path == NULL || types == NULL) {
+		return NULL;
+	}
+	if(types_num == 0 || types_num > ttLibC_BatchRemux_maxTypesNum) {
+		ERR_PRINT("types_num should be 1 - %d.", ttLibC_BatchRemux_maxTypesNum);
+		return NULL;
+	}
+	if(batch_->workers != NULL) {
+		ERR_PRINT("job should be added before run.");
+		return NULL;
+	}
+	if(batch_->inherit_super.job_num == batch_->job_capacity) {
+		uint32_t capacity = batch_->job_capacity == 0 ? 16 : batch_->job_capacity * 2;
+		BatchRemux_Job **jobs = ttLibC_malloc(sizeof(BatchRemux_Job *) * capacity);
+		if(jobs == NULL) {
+			ERR_PRINT("failed to allocate memory for jobs.");
+			return NULL;
+		}
+		if(batch_->jobs != NULL) {
+			memcpy(jobs, batch_->jobs, sizeof(BatchRemux_Job *) * batch_->inherit_super.job_num);
+			ttLibC_free(batch_->jobs);
+		}
+		batch_->jobs = jobs;
+		batch_->job_capacity = capacity;
+	}
+	BatchRemux_Job *job = ttLibC_malloc(sizeof(BatchRemux_Job));
+	if(job == NULL) {
+		ERR_PRINT("failed to allocate memory for job.");
+		return NULL;
+	}
+	memset(job, 0, sizeof(BatchRemux_Job));
+	job->inherit_super.input_path  = BatchRemux_copyString(input_path);
+	job->inherit_super.output_path = BatchRemux_copyString(output_path);
+	if(job->inherit_super.input_path == NULL || job->inherit_super.output_path == NULL) {
+		ERR_PRINT("failed to allocate memory for path.");
+		BatchRemux_closeJob(&job);
+		return NULL;
+	}
+	job->inherit_super.input_type  = input_type;
+	job->inherit_super.output_type = output_type;
+	memcpy(job->types, types, sizeof(ttLibC_Frame_Type) * types_num);
+	job->types_num = types_num;
+	batch_->jobs[batch_->inherit_super.job_num] = job;
+	++ batch_->inherit_super.job_num;
+	return (ttLibC_BatchRemuxJob *)job;
+}
+
+ttLibC_BatchRemuxJob TT_VISIBILITY_DEFAULT *ttLibC_BatchRemux_refJob(
+		ttLibC_BatchRemux *batch,
+		uint32_t index) {
+	ttLibC_BatchRemux_ *batch_ = (ttLibC_BatchRemux_ *)batch;
+	if(batch_ == NULL || index >= batch_->inherit_super.job_num) {
+		return NULL;
+	}
+	return (ttLibC_BatchRemuxJob *)batch_->jobs[index];
+}
+
+/*
+ * write input frame on the output track with same frame type.
+ */
+static bool BatchRemux_frameCallback(void *ptr, ttLibC_Frame *frame) {
+	BatchRemux_Job *job = (BatchRemux_Job *)ptr;
+	uint32_t track = job->types_num;
+	for(uint32_t i = 0;i < job->types_num;++ i) {
+		if(job->is_track_found[i] && job->track_ids[i] == frame->id) {
+			track = i;
+			break;
+		}
+	}
+	if(track == job->types_num) {
+		for(uint32_t i = 0;i < job->types_num;++ i) {
+			if(!job->is_track_found[i] && job->types[i] == frame->type) {
+				job->is_track_found[i] = true;
+				job->track_ids[i]      = frame->id;
+				track = i;
+				break;
+			}
+		}
+	}
+	if(track == job->types_num || job->types[track] != frame->type) {
+		++ job->inherit_super.drop_count;
+		return true;
+	}
+	uint32_t id = frame->id;
+	if(job->writer->type != containerType_flv) {
+		// flv writer uses frame type, others use track id.
+		frame->id = track + ((ttLibC_ContainerWriter_ *)job->writer)->track_base_id;
+	}
+	bool result = ttLibC_ContainerWriter_write(job->writer, frame, ttLibC_FileSink_write, job->sink);
+	frame->id = id;
+	if(!result) {
+		ERR_PRINT("failed to write frame.");
+		return false;
+	}
+	++ job->inherit_super.frame_count;
+	return true;
+}
+
+static bool BatchRemux_readCallback(void *ptr, ttLibC_Container *container) {
+	return ttLibC_Container_getFrame(container, BatchRemux_frameCallback, ptr);
+}
+
+static ttLibC_ContainerReader *BatchRemux_makeReader(ttLibC_Container_Type type) {
+	switch(type) {
+	case containerType_flv:
+		return (ttLibC_ContainerReader *)ttLibC_FlvReader_make();
+	case containerType_mkv:
+	case containerType_webm:
+		return (ttLibC_ContainerReader *)ttLibC_MkvReader_make();
+	case containerType_mp3:
+		return (ttLibC_ContainerReader *)ttLibC_Mp3Reader_make();
+	case containerType_mp4:
+		return (ttLibC_ContainerReader *)ttLibC_Mp4Reader_make();
+	case containerType_mpegts:
+		return (ttLibC_ContainerReader *)ttLibC_MpegtsReader_make();
+	default:
+		ERR_PRINT("container type:%d is not supported for input.", type);
+		return NULL;
+	}
+}
+
+static ttLibC_ContainerWriter *BatchRemux_makeWriter(BatchRemux_Job *job) {
+	switch(job->inherit_super.output_type) {
+	case containerType_flv:
+		{
+			ttLibC_Frame_Type video_type = frameType_unknown;
+			ttLibC_Frame_Type audio_type = frameType_unknown;
+			for(uint32_t i = 0;i < job->types_num;++ i) {
+				if(video_type == frameType_unknown && ttLibC_isVideo(job->types[i])) {
+					video_type = job->types[i];
+				}
+				else if(audio_type == frameType_unknown && ttLibC_isAudio(job->types[i])) {
+					audio_type = job->types[i];
+				}
+			}
+			return (ttLibC_ContainerWriter *)ttLibC_FlvWriter_make(video_type, audio_type);
+		}
+	case containerType_mkv:
+		return (ttLibC_ContainerWriter *)ttLibC_MkvWriter_make(job->types, job->types_num);
+	case containerType_mp4:
+		return (ttLibC_ContainerWriter *)ttLibC_Mp4Writer_make(job->types, job->types_num);
+	case containerType_mpegts:
+		return (ttLibC_ContainerWriter *)ttLibC_MpegtsWriter_make(job->types, job->types_num);
+	default:
+		ERR_PRINT("container type:%d is not supported for output.", job->inherit_super.output_type);
+		return NULL;
+	}
+}
+
+/*
+ * remux one file.
+ */
+static bool BatchRemux_process(BatchRemux_Job *job) {
+	struct timeval start, end;
+	gettimeofday(&start, NULL);
+	ttLibC_FileSource *source = ttLibC_FileSource_make(job->inherit_super.input_path);
+	ttLibC_ContainerReader *reader = BatchRemux_makeReader(job->inherit_super.input_type);
+	job->writer = BatchRemux_makeWriter(job);
+	job->sink = ttLibC_FileSink_make(job->inherit_super.output_path, 0, false);
+	bool result = source != NULL
+			&& reader != NULL
+			&& job->writer != NULL
+			&& job->sink != NULL;
+	if(result) {
+		job->inherit_super.read_size = source->size;
+		result = ttLibC_FileSource_read(source, reader, BatchRemux_readCallback, job);
+		if(!result) {
+			ERR_PRINT("failed to remux:%s", job->inherit_super.input_path);
+		}
+		result = ttLibC_FileSink_flush(job->sink) && result;
+		job->inherit_super.write_size = job->sink->write_size;
+	}
+	ttLibC_FileSink_close(&job->sink);
+	ttLibC_ContainerWriter_close(&job->writer);
+	ttLibC_ContainerReader_close(&reader);
+	ttLibC_FileSource_close(&source);
+	gettimeofday(&end, NULL);
+	job->inherit_super.elapsed_time = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec);
+	job->inherit_super.is_success = result;
+	return result;
+}
+
+/*
+ * take job from the head of own deque.
+ */
+static bool BatchRemux_popJob(BatchRemux_Worker *worker, uint32_t *job_index) {
+	bool result = false;
+	pthread_mutex_lock(&worker->mutex);
+	if(worker->head < worker->tail) {
+		*job_index = worker->job_indices[worker->head];
+		++ worker->head;
+		result = true;
+	}
+	pthread_mutex_unlock(&worker->mutex);
+	return result;
+}
+
+/*
+ * take job from the tail of other worker.
+ */
+static bool BatchRemux_stealJob(BatchRemux_Worker *worker, uint32_t *job_index) {
+	ttLibC_BatchRemux_ *batch = worker->batch;
+	for(uint32_t i = 1;i < batch->worker_num;++ i) {
+		BatchRemux_Worker *victim = &batch->workers[(worker->index + i) % batch->worker_num];
+		bool result = false;
+		pthread_mutex_lock(&victim->mutex);
+		if(victim->head < victim->tail) {
+			-- victim->tail;
+			*job_index = victim->job_indices[victim->tail];
+			result = true;
+		}
+		pthread_mutex_unlock(&victim->mutex);
+		if(result) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void *BatchRemux_workerMain(void *arg) {
+	BatchRemux_Worker *worker = (BatchRemux_Worker *)arg;
+	uint32_t job_index = 0;
+	while(true) {
+		if(!BatchRemux_popJob(worker, &job_index)) {
+			if(!BatchRemux_stealJob(worker, &job_index)) {
+				// jobs are not added while running, no more job.
+				break;
+			}
+			++ worker->steal_num;
+		}
+		BatchRemux_Job *job = worker->batch->jobs[job_index];
+		job->inherit_super.worker_index = worker->index;
+		if(!BatchRemux_process(job)) {
+			++ worker->error_num;
+		}
+	}
+	return NULL;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_BatchRemux_run(ttLibC_BatchRemux *batch) {
+	ttLibC_BatchRemux_ *batch_ = (ttLibC_BatchRemux_ *)batch;
+	if(batch_ == NULL) {
+		return false;
+	}
+	uint32_t job_num = batch_->inherit_super.job_num;
+	batch_->inherit_super.error_num = 0;
+	batch_->inherit_super.steal_num = 0;
+	if(job_num == 0) {
+		return true;
+	}
+	for(uint32_t i = 0;i < job_num;++ i) {
+		BatchRemux_Job *job = batch_->jobs[i];
+		memset(job->track_ids, 0, sizeof(job->track_ids));
+		memset(job->is_track_found, 0, sizeof(job->is_track_found));
+		job->inherit_super.is_success   = false;
+		job->inherit_super.worker_index = 0;
+		job->inherit_super.read_size    = 0;
+		job->inherit_super.write_size   = 0;
+		job->inherit_super.frame_count  = 0;
+		job->inherit_super.drop_count   = 0;
+		job->inherit_super.elapsed_time = 0;
+	}
+	uint32_t worker_num = batch_->inherit_super.thread_num;
+	if(worker_num > job_num) {
+		worker_num = job_num;
+	}
+	batch_->workers     = ttLibC_malloc(sizeof(BatchRemux_Worker) * worker_num);
+	batch_->job_indices = ttLibC_malloc(sizeof(uint32_t) * job_num);
+	if(batch_->workers == NULL || batch_->job_indices == NULL) {
+		ERR_PRINT("failed to allocate memory for workers.");
+		ttLibC_free(batch_->workers);
+		ttLibC_free(batch_->job_indices);
+		batch_->workers     = NULL;
+		batch_->job_indices = NULL;
+		return false;
+	}
+	batch_->worker_num = worker_num;
+	// deal jobs like cards, worker n has job n, n + worker_num, ...
+	uint32_t offset = 0;
+	for(uint32_t i = 0;i < worker_num;++ i) {
+		BatchRemux_Worker *worker = &batch_->workers[i];
+		memset(worker, 0, sizeof(BatchRemux_Worker));
+		worker->batch       = batch_;
+		worker->index       = i;
+		worker->job_indices = batch_->job_indices + offset;
+		pthread_mutex_init(&worker->mutex, NULL);
+		for(uint32_t j = i;j < job_num;j += worker_num) {
+			batch_->job_indices[offset] = j;
+			++ offset;
+		}
+		worker->tail = offset - (worker->job_indices - batch_->job_indices);
+	}
+	uint32_t started_num = 0;
+	for(uint32_t i = 0;i < worker_num;++ i) {
+		BatchRemux_Worker *worker = &batch_->workers[i];
+		if(pthread_create(&worker->thread, NULL, BatchRemux_workerMain, worker) != 0) {
+			ERR_PRINT("failed to create worker thread:%d", i);
+			continue;
+		}
+		worker->is_started = true;
+		++ started_num;
+	}
+	if(started_num == 0) {
+		// no thread, do all jobs on this thread.
+		BatchRemux_workerMain(&batch_->workers[0]);
+	}
+	for(uint32_t i = 0;i < worker_num;++ i) {
+		BatchRemux_Worker *worker = &batch_->workers[i];
+		if(worker->is_started) {
+			pthread_join(worker->thread, NULL);
+		}
+		pthread_mutex_destroy(&worker->mutex);
+		batch_->inherit_super.error_num += worker->error_num;
+		batch_->inherit_super.steal_num += worker->steal_num;
+	}
+	ttLibC_free(batch_->workers);
+	ttLibC_free(batch_->job_indices);
+	batch_->workers     = NULL;
+	batch_->job_indices = NULL;
+	batch_->worker_num  = 0;
+	return batch_->inherit_super.error_num == 0;
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_BatchRemux_close(ttLibC_BatchRemux **batch) {
+	ttLibC_BatchRemux_ *target = (ttLibC_BatchRemux_ *)*batch;
+	if(target == NULL) {
+		return;
+	}
+	for(uint32_t i = 0;i < target->inherit_super.job_num;++ i) {
+		BatchRemux_closeJob(&target->jobs[i]);
+	}
+	ttLibC_free(target->jobs);
+	ttLibC_free(target);
+	*batch = NULL;
+}
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file   batchRemux.h
+ * @brief  remux many files in parallel, on a work stealing thread pool.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * each job is a pair of input file and output file.
+ * jobs are dealt to the workers first, idle worker steals jobs from the tail of busy worker.
+ * input is mmaped, output is written with large buffer.
+ * frames of input are mapped to the tracks of output by frame type, others are dropped.
+ *
+ * usage:
+ *   ttLibC_Frame_Type types[2] = {frameType_h264, frameType_aac};
+ *   ttLibC_BatchRemux *batch = ttLibC_BatchRemux_make(0);
+ *   ttLibC_BatchRemuxJob *job = ttLibC_BatchRemux_addJob(batch, "in.flv", containerType_flv, "out.mp4", containerType_mp4, types, 2);
+ *   ...
+ *   ttLibC_BatchRemux_run(batch);
+ *   // check job->is_success, job->write_size...
+ *   ttLibC_BatchRemux_close(&batch);
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_CONTAINER_BATCHREMUX_H_
+#define TTLIBC_CONTAINER_BATCHREMUX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "container.h"
+
+/**
+ * max number of output tracks for one job.
+ */
+#define ttLibC_BatchRemux_maxTypesNum 4
+
+/**
+ * definition of remux job.
+ * result fields are updated by the worker, refer them after run.
+ */
+typedef struct ttLibC_Container_BatchRemuxJob {
+	/** input file path. */
+	const char *input_path;
+	/** output file path. */
+	const char *output_path;
+	ttLibC_Container_Type input_type;
+	ttLibC_Container_Type output_type;
+	/** true:remux is done without error. */
+	bool     is_success;
+	/** index of worker which did this job. */
+	uint32_t worker_index;
+	/** byte size of input. */
+	uint64_t read_size;
+	/** byte size of output. */
+	uint64_t write_size;
+	/** number of written frames. */
+	uint64_t frame_count;
+	/** number of dropped frames. (no track for the frame) */
+	uint64_t drop_count;
+	/** time for the job. (micro sec) */
+	uint64_t elapsed_time;
+} ttLibC_Container_BatchRemuxJob;
+
+typedef ttLibC_Container_BatchRemuxJob ttLibC_BatchRemuxJob;
+
+/**
+ * definition of batch remux.
+ */
+typedef struct ttLibC_Container_BatchRemux {
+	/** number of worker threads. */
+	uint32_t thread_num;
+	/** number of jobs. */
+	uint32_t job_num;
+	/** number of failed jobs on last run. */
+	uint32_t error_num;
+	/** number of jobs done by stealing on last run. */
+	uint32_t steal_num;
+} ttLibC_Container_BatchRemux;
+
+typedef ttLibC_Container_BatchRemux ttLibC_BatchRemux;
+
+/**
+ * make batch remux.
+ * @param thread_num number of worker threads. 0 for number of cpu.
+ * @return batch remux object.
+ */
+ttLibC_BatchRemux *ttLibC_BatchRemux_make(uint32_t thread_num);
+
+/**
+ * add job. (before run)
+ * @param batch       batch remux object.
+ * @param input_path  input file path. copied.
+ * @param input_type  container type of input. flv, mkv, webm, mp3, mp4, mpegts
+ * @param output_path output file path. copied.
+ * @param output_type container type of output. flv, mkv, mp4, mpegts
+ * @param types       frame types of output tracks.
+ * @param types_num   number of types. up to ttLibC_BatchRemux_maxTypesNum
+ * @return job object. owned by batch.
+ */
+ttLibC_BatchRemuxJob *ttLibC_BatchRemux_addJob(
+		ttLibC_BatchRemux *batch,
+		const char *input_path,
+		ttLibC_Container_Type input_type,
+		const char *output_path,
+		ttLibC_Container_Type output_type,
+		ttLibC_Frame_Type *types,
+		uint32_t types_num);
+
+/**
+ * ref job.
+ * @param batch batch remux object.
+ * @param index index of job. (order of addJob)
+ * @return job object. NULL for out of range.
+ */
+ttLibC_BatchRemuxJob *ttLibC_BatchRemux_refJob(
+		ttLibC_BatchRemux *batch,
+		uint32_t index);
+
+/**
+ * run all jobs, and wait until all jobs are done.
+ * @param batch batch remux object.
+ * @return true:all jobs succeeded false:some job failed.
+ */
+bool ttLibC_BatchRemux_run(ttLibC_BatchRemux *batch);
+
+/**
+ * close batch remux.
+ * @param batch
+ */
+void ttLibC_BatchRemux_close(ttLibC_BatchRemux **batch);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_CONTAINER_BATCHREMUX_H_ */
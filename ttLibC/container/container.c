@@ -23,6 +23,7 @@
 #include "../frame/video/video.h"
 #include "../frame/video/h265.h"
 #include "../frame/video/h264.h"
+#include "../frame/video/vp8.h"
 #include "../frame/video/theora.h"
 #include "../frame/audio/audio.h"
 #include "../frame/audio/aac.h"
@@ -204,19 +205,164 @@ ttLibC_ContainerReader TT_VISIBILITY_HIDDEN *ttLibC_ContainerReader_make(
 	return reader;
 }
 
+/*
+ * read container object from binary data.
+ * @param reader    container reader object.
+ * @param data      binary data
+ * @param data_size data size
+ * @param callback  callback function
+ * @param ptr       user def pointer for callback.
+ * @return true:success false:error
+ */
 bool TT_VISIBILITY_DEFAULT ttLibC_ContainerReader_read(
 		ttLibC_ContainerReader *reader,
 		void *data,
 		size_t data_size,
 		ttLibC_ContainerReadFunc callback,
 		void *ptr) {
-	(void)reader;
-	(void)data;
-	(void)data_size;
-	(void)callback;
-	(void)ptr;
-	// TODO make this.
-	return true;
+	if(reader == NULL) {
+		return false;
+	}
+	switch(reader->type) {
+	case containerType_flv:
+		return ttLibC_FlvReader_read((ttLibC_FlvReader *)reader, data, data_size, (ttLibC_FlvReadFunc)callback, ptr);
+	case containerType_mkv:
+	case containerType_webm:
+		return ttLibC_MkvReader_read((ttLibC_MkvReader *)reader, data, data_size, (ttLibC_MkvReadFunc)callback, ptr);
+	case containerType_mp3:
+		return ttLibC_Mp3Reader_read((ttLibC_Mp3Reader *)reader, data, data_size, (ttLibC_Mp3ReadFunc)callback, ptr);
+	case containerType_mp4:
+		return ttLibC_Mp4Reader_read((ttLibC_Mp4Reader *)reader, data, data_size, (ttLibC_Mp4ReadFunc)callback, ptr);
+	case containerType_mpegts:
+		return ttLibC_MpegtsReader_read((ttLibC_MpegtsReader *)reader, data, data_size, (ttLibC_MpegtsReadFunc)callback, ptr);
+//	case containerType_riff:
+//	case containerType_wav:
+	default:
+		ERR_PRINT("unknown container type for reader read.%d", reader->type);
+		return false;
+	}
+}
+
+/*
+ * set key frame only mode.
+ * @param reader      container reader object.
+ * @param is_key_only true:key frame only false:all frames.
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_ContainerReader_setKeyOnly(
+		ttLibC_ContainerReader *reader,
+		bool is_key_only) {
+	if(reader == NULL) {
+		return;
+	}
+	reader->is_key_only = is_key_only;
+}
+
+/*
+ * set non copy mode.
+ * @param reader      container reader object.
+ * @param is_non_copy true:refer data false:copy data.
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_ContainerReader_setNonCopy(
+		ttLibC_ContainerReader *reader,
+		bool is_non_copy) {
+	if(reader == NULL) {
+		return;
+	}
+	reader->is_non_copy = is_non_copy;
+}
+
+/*
+ * check nal type for key.
+ * all slices in one picture have the same type, so first slice decide.
+ * @return 1:key slice 0:non key slice -1:not slice, check next nal.
+ */
+static int Container_checkKeyNal(
+		ttLibC_Frame_Type frame_type,
+		uint8_t nal_header) {
+	switch(frame_type) {
+	case frameType_h264:
+		{
+			uint8_t type = nal_header & 0x1F;
+			if(type == H264NalType_sliceIDR) {
+				return 1;
+			}
+			if(type >= H264NalType_slice && type < H264NalType_sliceIDR) {
+				return 0;
+			}
+		}
+		return -1;
+	case frameType_h265:
+		{
+			uint8_t type = (nal_header >> 1) & 0x3F;
+			// BLA, IDR, CRA
+			if(type >= 16 && type <= 21) {
+				return 1;
+			}
+			if(type < 32) {
+				return 0;
+			}
+		}
+		return -1;
+	default:
+		return -1;
+	}
+}
+
+/*
+ * check the sample is key or not, without making frame.
+ * @param frame_type  frame type of sample.
+ * @param data        sample data.
+ * @param data_size   sample data size.
+ * @param size_length size length of nal for avcc / hvcc. 0 for annexB.
+ * @return true:key frame(or could not decide) false:non key frame or audio.
+ */
+bool TT_VISIBILITY_HIDDEN ttLibC_Container_isKeySample(
+		ttLibC_Frame_Type frame_type,
+		uint8_t *data,
+		size_t data_size,
+		uint32_t size_length) {
+	if(ttLibC_isAudio(frame_type)) {
+		return false;
+	}
+	if(data == NULL || data_size == 0) {
+		return false;
+	}
+	switch(frame_type) {
+	case frameType_h264:
+	case frameType_h265:
+		if(size_length != 0) {
+			// sizeNal
+			size_t pos = 0;
+			while(pos + size_length < data_size) {
+				size_t size = 0;
+				for(uint32_t i = 0;i < size_length;++ i) {
+					size = (size << 8) | data[pos + i];
+				}
+				int result = Container_checkKeyNal(frame_type, data[pos + size_length]);
+				if(result >= 0) {
+					return result == 1;
+				}
+				pos += size_length + size;
+			}
+		}
+		else {
+			// annexB, check the byte after 00 00 01.
+			for(size_t i = 2;i + 1 < data_size;++ i) {
+				if(data[i] == 0x01 && data[i - 1] == 0x00 && data[i - 2] == 0x00) {
+					int result = Container_checkKeyNal(frame_type, data[i + 1]);
+					if(result >= 0) {
+						return result == 1;
+					}
+				}
+			}
+		}
+		return false;
+	case frameType_vp8:
+		return (data[0] & 0x01) == 0;
+	default:
+		// jpeg, png... are always key.
+		return true;
+	}
 }
 
 /*
@@ -302,16 +448,29 @@ ttLibC_ContainerWriter TT_VISIBILITY_HIDDEN *ttLibC_ContainerWriter_make_(
 	}
 	else {
 		writer->track_list = ttLibC_StlMap_make();
+		writer->tracks   = ttLibC_malloc(sizeof(ttLibC_ContainerWriter_WriteTrack *) * (types_num + 1));
+		writer->pts_heap = ttLibC_malloc(sizeof(ttLibC_ContainerWriter_WriteTrack *) * (types_num + 1));
+		if(writer->tracks == NULL || writer->pts_heap == NULL) {
+			ERR_PRINT("failed to allocate memory for track array.");
+			ttLibC_ContainerWriter_close_(&writer);
+			return NULL;
+		}
+		writer->track_num     = types_num;
+		writer->track_base_id = track_base_id;
 		for(uint32_t i = 0;i < types_num;++ i) {
 			ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriteTrack_make(
 					track_size,
 					i + track_base_id,
 					target_frame_types[i]);
+			writer->tracks[i] = track;
 			if(track == NULL) {
 				ERR_PRINT("failed to make track object.");
 			}
 			else {
 				ttLibC_StlMap_put(writer->track_list, (void *)(long)(i + track_base_id), (void *)track);
+				// all heap_pts are 0 now, any order is valid heap.
+				track->heap_index = writer->heap_num;
+				writer->pts_heap[writer->heap_num ++] = track;
 			}
 		}
 	}
@@ -322,6 +481,9 @@ ttLibC_ContainerWriter TT_VISIBILITY_HIDDEN *ttLibC_ContainerWriter_make_(
 	writer->current_pts_pos   = 0;
 	writer->target_pos        = 0;
 	writer->unit_duration = unit_duration;
+	writer->split_func        = NULL;
+	writer->split_ptr         = NULL;
+	writer->is_flushing       = false;
 	return (ttLibC_ContainerWriter *)writer;
 }
 
@@ -343,6 +505,8 @@ void TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_close_(ttLibC_ContainerWriter_
 	// in the case of track have extra memory, not use this function.
 	ttLibC_StlMap_forEach(target->track_list, ContainerWriter_closeTracks, NULL);
 	ttLibC_StlMap_close(&target->track_list);
+	ttLibC_free(target->tracks);
+	ttLibC_free(target->pts_heap);
 	ttLibC_free(target);
 	*writer = NULL;
 }
@@ -352,11 +516,25 @@ bool TT_VISIBILITY_DEFAULT ttLibC_ContainerWriter_write(
 		ttLibC_Frame *frame,
 		ttLibC_ContainerWriteFunc callback,
 		void *ptr) {
-	(void)writer;
-	(void)frame;
-	(void)callback;
-	(void)ptr;
-	return true;
+	if(writer == NULL) {
+		return false;
+	}
+	switch(writer->type) {
+	case containerType_flv:
+		return ttLibC_FlvWriter_write((ttLibC_FlvWriter *)writer, frame, callback, ptr);
+	case containerType_mkv:
+	case containerType_webm:
+		return ttLibC_MkvWriter_write((ttLibC_MkvWriter *)writer, frame, callback, ptr);
+	case containerType_mp3:
+		return ttLibC_Mp3Writer_write((ttLibC_Mp3Writer *)writer, frame, callback, ptr);
+	case containerType_mp4:
+		return ttLibC_Mp4Writer_write((ttLibC_Mp4Writer *)writer, frame, callback, ptr);
+	case containerType_mpegts:
+		return ttLibC_MpegtsWriter_write((ttLibC_MpegtsWriter *)writer, frame, callback, ptr);
+	default:
+		ERR_PRINT("unknown container type for writer write.:%d", writer->type);
+		return false;
+	}
 }
 
 /*
@@ -411,22 +589,135 @@ ttLibC_ContainerWriter_WriteTrack TT_VISIBILITY_HIDDEN *ttLibC_ContainerWriteTra
 	return track;
 }
 
+static uint64_t ContainerWriter_gcd(uint64_t a, uint64_t b) {
+	while(b != 0) {
+		uint64_t r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+void TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_Rescaler_setup(
+		ttLibC_ContainerWriter_Rescaler *rescaler,
+		uint32_t dst_timebase,
+		uint32_t src_timebase) {
+	rescaler->src_timebase = src_timebase;
+	rescaler->dst_timebase = dst_timebase;
+	if(dst_timebase == 0 || src_timebase == 0) {
+		rescaler->num = 1;
+		rescaler->den = 1;
+		return;
+	}
+	uint64_t gcd = ContainerWriter_gcd(dst_timebase, src_timebase);
+	rescaler->num = dst_timebase / gcd;
+	rescaler->den = src_timebase / gcd;
+}
+
+uint64_t TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_Rescaler_rescale(
+		ttLibC_ContainerWriter_Rescaler *rescaler,
+		uint64_t value) {
+	if(rescaler->den == 1) {
+		return value * rescaler->num;
+	}
+	// value = q * den + r, r * num fits 64bit because num and den are 32bit.
+	uint64_t q = value / rescaler->den;
+	uint64_t r = value % rescaler->den;
+	return q * rescaler->num + r * rescaler->num / rescaler->den;
+}
+
+/*
+ * rescale frame pts / dts into timebase, with the rescaler of track.
+ */
+static void ContainerWriteTrack_rescale(
+		ttLibC_ContainerWriter_WriteTrack *track,
+		ttLibC_Frame *frame,
+		uint32_t timebase,
+		uint64_t *pts,
+		uint64_t *dts) {
+	if(track->rescaler.src_timebase != frame->timebase
+	|| track->rescaler.dst_timebase != timebase
+	|| track->rescaler.den == 0) {
+		ttLibC_ContainerWriter_Rescaler_setup(&track->rescaler, timebase, frame->timebase);
+	}
+	*pts = ttLibC_ContainerWriter_Rescaler_rescale(&track->rescaler, frame->pts);
+	*dts = ttLibC_ContainerWriter_Rescaler_rescale(&track->rescaler, frame->dts);
+}
+
+ttLibC_ContainerWriter_WriteTrack TT_VISIBILITY_HIDDEN *ttLibC_ContainerWriter_refTrack(
+		ttLibC_ContainerWriter_ *writer,
+		uint32_t track_id) {
+	if(writer == NULL || track_id < writer->track_base_id) {
+		return NULL;
+	}
+	uint32_t index = track_id - writer->track_base_id;
+	if(index >= writer->track_num) {
+		return NULL;
+	}
+	return writer->tracks[index];
+}
+
+static void ContainerWriter_swapHeap(
+		ttLibC_ContainerWriter_ *writer,
+		uint32_t i,
+		uint32_t j) {
+	ttLibC_ContainerWriter_WriteTrack *track = writer->pts_heap[i];
+	writer->pts_heap[i] = writer->pts_heap[j];
+	writer->pts_heap[j] = track;
+	writer->pts_heap[i]->heap_index = i;
+	writer->pts_heap[j]->heap_index = j;
+}
+
+/*
+ * update queued pts of track, and fix the place on pts_heap.
+ */
+static void ContainerWriter_updateHeap(
+		ttLibC_ContainerWriter_ *writer,
+		ttLibC_ContainerWriter_WriteTrack *track) {
+	if(writer == NULL || writer->heap_num == 0) {
+		return;
+	}
+	// queue timebase is writer timebase. (appendQueue is called with writer timebase)
+	track->heap_pts = track->frame_queue->pts;
+	uint32_t i = track->heap_index;
+	while(i > 0) {
+		uint32_t parent = (i - 1) / 2;
+		if(writer->pts_heap[parent]->heap_pts <= writer->pts_heap[i]->heap_pts) {
+			break;
+		}
+		ContainerWriter_swapHeap(writer, parent, i);
+		i = parent;
+	}
+	while(true) {
+		uint32_t target = i;
+		uint32_t left  = i * 2 + 1;
+		uint32_t right = left + 1;
+		if(left < writer->heap_num && writer->pts_heap[left]->heap_pts < writer->pts_heap[target]->heap_pts) {
+			target = left;
+		}
+		if(right < writer->heap_num && writer->pts_heap[right]->heap_pts < writer->pts_heap[target]->heap_pts) {
+			target = right;
+		}
+		if(target == i) {
+			break;
+		}
+		ContainerWriter_swapHeap(writer, target, i);
+		i = target;
+	}
+}
+
 static bool ContainerWriteTrack_appendQueue(
+		ttLibC_ContainerWriter_ *writer,
 		ttLibC_ContainerWriter_WriteTrack *track,
 		ttLibC_Frame *frame,
 		uint64_t pts,
 		uint64_t dts,
 		uint32_t timebase) {
-	uint64_t original_pts      = frame->pts;
-	uint64_t original_dts      = frame->dts;
-	uint32_t original_timebase = frame->timebase;
-	frame->pts      = pts;
-	frame->dts      = dts;
-	frame->timebase = timebase;
-	bool result     = ttLibC_FrameQueue_queue(track->frame_queue, frame);
-	frame->pts      = original_pts;
-	frame->dts      = original_dts;
-	frame->timebase = original_timebase;
+	// input frame can be shared with other threads, so rescaled time is set on the clone.
+	bool result = ttLibC_FrameQueue_queueWithTime(track->frame_queue, frame, pts, dts, timebase);
+	if(result) {
+		ContainerWriter_updateHeap(writer, track);
+	}
 	return result;
 }
 
@@ -459,7 +750,17 @@ bool TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_isReadyToStart(ttLibC_Container
 
 bool TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_primaryTrackCheck(void *ptr, ttLibC_Frame *frame) {
 	ttLibC_ContainerWriter_ *writer = (ttLibC_ContainerWriter_ *)ptr;
-	ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)ttLibC_StlMap_get(writer->track_list, (void *)(long)frame->id);
+	ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriter_refTrack(writer, frame->id);
+	if(writer->split_func != NULL) {
+		// split point is decided outside, mode and unit_duration are not used.
+		if(!ttLibC_ContainerWriter_isReadyFrame(frame)
+		|| frame->dts <= writer->current_pts_pos
+		|| !writer->split_func(writer->split_ptr, frame)) {
+			return true;
+		}
+		writer->target_pos = frame->dts;
+		return false;
+	}
 	if(ttLibC_Frame_isAudio(frame)) {
 		if(frame->dts < writer->unit_duration + writer->current_pts_pos) {
 			return true;
@@ -583,27 +884,15 @@ bool TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_primaryTrackCheck(void *ptr, tt
 	return true;
 }
 
-static bool ContainerWriter_isReadyToWriteCallback(void *ptr, void *key, void *item) {
-	(void)key;
-	if(ptr != NULL && item != NULL) {
-		ttLibC_ContainerWriter_ *writer = (ttLibC_ContainerWriter_ *)ptr;
-		ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)item;
-		uint64_t pts = track->frame_queue->pts;
-		if(writer->inherit_super.timebase != track->frame_queue->timebase) {
-			pts = (uint64_t)(1.0 * track->frame_queue->pts * writer->inherit_super.timebase / track->frame_queue->timebase);
-		}
-		if(writer->target_pos > pts) {
-			return false;
-		}
-		return true;
-	}
-	return false;
-}
 bool TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_isReadyToWrite(ttLibC_ContainerWriter_ *writer) {
-	if(ttLibC_StlMap_forEach(writer->track_list, ContainerWriter_isReadyToWriteCallback, writer)) {
+	if(writer->track_list == NULL) {
+		return false;
+	}
+	if(writer->heap_num == 0 || writer->is_flushing) {
 		return true;
 	}
-	return false;
+	// all tracks have frames until target_pos, if the lowest one has.
+	return writer->target_pos <= writer->pts_heap[0]->heap_pts;
 }
 
 int TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_write_(
@@ -616,9 +905,15 @@ int TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_write_(
 		return -1;
 	}
 	if(frame == NULL) {
-		return 0;
+		if(!writer->is_flushing) {
+			return 0;
+		}
+		// flush_, run writeFromQueue without new frame.
+		writer->callback = callback;
+		writer->ptr = ptr;
+		return 1;
 	}
-	ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)ttLibC_StlMap_get(writer->track_list, (void *)(long)frame->id);
+	ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriter_refTrack(writer, frame->id);
 	if(track == NULL) {
 		ERR_PRINT("failed to get correspond track. %d", frame->id);
 		return -1;
@@ -627,12 +922,9 @@ int TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_write_(
 		ERR_PRINT("input frame type(%d) is different from track frame type(%d).", frame->type, track->frame_type);
 		return -1;
 	}
-	uint64_t pts = (uint64_t)(1.0 * frame->pts * writer->inherit_super.timebase / frame->timebase);
-	uint64_t dts = (uint64_t)(1.0 * frame->dts * writer->inherit_super.timebase / frame->timebase);
-	if(frame->timebase == writer->inherit_super.timebase) {
-		pts = frame->pts;
-		dts = frame->dts;
-	}
+	uint64_t pts = 0;
+	uint64_t dts = 0;
+	ContainerWriteTrack_rescale(track, frame, writer->inherit_super.timebase, &pts, &dts);
 	track->enable_mode = writer->inherit_super.mode;
 	switch(frame->type) {
 	case frameType_h264:
@@ -724,7 +1016,7 @@ int TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_write_(
 					break;
 				}
 				if(track->counter < 3) {
-					if(!ContainerWriteTrack_appendQueue(track, frame, 0, 0, writer->inherit_super.timebase)) {
+					if(!ContainerWriteTrack_appendQueue(writer, track, frame, 0, 0, writer->inherit_super.timebase)) {
 						return -1;
 					}
 					else {
@@ -804,7 +1096,7 @@ int TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_write_(
 					break;
 				}
 				if(track->counter < 3) {
-					if(!ContainerWriteTrack_appendQueue(track, frame, 0, 0, writer->inherit_super.timebase)){
+					if(!ContainerWriteTrack_appendQueue(writer, track, frame, 0, 0, writer->inherit_super.timebase)){
 						return -1;
 					}
 					else {
@@ -818,7 +1110,7 @@ int TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_write_(
 		break;
 	}
 	track->is_appending = true;
-	if(!ContainerWriteTrack_appendQueue(track, frame, pts, dts, writer->inherit_super.timebase)) {
+	if(!ContainerWriteTrack_appendQueue(writer, track, frame, pts, dts, writer->inherit_super.timebase)) {
 		return -1;
 	}
 	if(writer->is_first) {
@@ -832,6 +1124,56 @@ int TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_write_(
 	return 1;
 }
 
+/*
+ * find the end of queued frames.
+ */
+static bool ContainerWriter_flushEndCheck(void *ptr, ttLibC_Frame *frame) {
+	uint64_t *end_pos = (uint64_t *)ptr;
+	if(frame->pts >= *end_pos) {
+		*end_pos = frame->pts + 1;
+	}
+	return true;
+}
+
+bool TT_VISIBILITY_HIDDEN ttLibC_ContainerWriter_flush_(
+		ttLibC_ContainerWriter_ *writer,
+		uint64_t end_pos,
+		ttLibC_ContainerWriteFunc callback,
+		void *ptr) {
+	if(writer == NULL) {
+		return false;
+	}
+	if(writer->is_first || writer->status < status_target_check) {
+		// no chunk to write.
+		return true;
+	}
+	for(uint32_t i = 0;i < writer->track_num;++ i) {
+		if(writer->tracks[i] != NULL) {
+			ttLibC_FrameQueue_ref(writer->tracks[i]->frame_queue, ContainerWriter_flushEndCheck, &end_pos);
+		}
+	}
+	writer->is_flushing = true;
+	bool result = true;
+	while(result && writer->current_pts_pos < end_pos) {
+		// pending target and split points on queue are written first.
+		uint64_t pos = writer->current_pts_pos;
+		result = ttLibC_ContainerWriter_write((ttLibC_ContainerWriter *)writer, NULL, callback, ptr);
+		if(!result || writer->current_pts_pos != pos) {
+			continue;
+		}
+		if(writer->status != status_target_check) {
+			ERR_PRINT("failed to flush queued frames.");
+			result = false;
+			break;
+		}
+		// no more split point, the rest is the last chunk.
+		writer->target_pos = end_pos;
+		writer->status = status_data_check;
+	}
+	writer->is_flushing = false;
+	return result;
+}
+
 bool TT_VISIBILITY_HIDDEN ttLibC_ContainerWriteTrack_appendQueue(
 		ttLibC_ContainerWriter_WriteTrack *track,
 		ttLibC_Frame                      *frame,
@@ -841,12 +1183,9 @@ bool TT_VISIBILITY_HIDDEN ttLibC_ContainerWriteTrack_appendQueue(
 		ERR_PRINT("failed to get correspond track. %d", frame->id);
 		return false;
 	}
-	uint64_t pts = (uint64_t)(1.0 * frame->pts * timebase / frame->timebase);
-	uint64_t dts = (uint64_t)(1.0 * frame->dts * timebase / frame->timebase);
-	if(frame->timebase == timebase) {
-		pts = frame->pts;
-		dts = frame->dts;
-	}
+	uint64_t pts = 0;
+	uint64_t dts = 0;
+	ContainerWriteTrack_rescale(track, frame, timebase, &pts, &dts);
 	track->enable_mode = enable_mode;
 	switch(frame->type) {
 	case frameType_h264:
@@ -930,7 +1269,7 @@ bool TT_VISIBILITY_HIDDEN ttLibC_ContainerWriteTrack_appendQueue(
 					break;
 				}
 				if(track->counter < 3) {
-					return ContainerWriteTrack_appendQueue(track, frame, 0, 0, timebase);
+					return ContainerWriteTrack_appendQueue(NULL, track, frame, 0, 0, timebase);
 				}
 			}
 		}
@@ -1005,7 +1344,7 @@ bool TT_VISIBILITY_HIDDEN ttLibC_ContainerWriteTrack_appendQueue(
 					break;
 				}
 				if(track->counter < 3) {
-					return ContainerWriteTrack_appendQueue(track, frame, 0, 0, timebase);
+					return ContainerWriteTrack_appendQueue(NULL, track, frame, 0, 0, timebase);
 				}
 			}
 		}
@@ -1014,7 +1353,7 @@ bool TT_VISIBILITY_HIDDEN ttLibC_ContainerWriteTrack_appendQueue(
 		break;
 	}
 	track->is_appending = true;
-	if(!ContainerWriteTrack_appendQueue(track, frame, pts, dts, timebase)) {
+	if(!ContainerWriteTrack_appendQueue(NULL, track, frame, pts, dts, timebase)) {
 		return false;
 	}
 	return true;
@@ -75,10 +75,23 @@ bool ttLibC_Container_getFrame(
  */
 typedef struct ttLibC_ContainerReader {
 	ttLibC_Container_Type type;
+	/** true:skip audio and non key video. */
+	bool is_key_only;
+	/** true:refer the data of read without copy. */
+	bool is_non_copy;
 } ttLibC_ContainerReader;
 
 typedef bool (* ttLibC_ContainerReadFunc)(void *ptr, ttLibC_Container *container);
 
+/**
+ * read container object from binary data.
+ * @param reader    container reader object.
+ * @param data      binary data
+ * @param data_size data size
+ * @param callback  callback function
+ * @param ptr       user def pointer for callback.
+ * @return true:success false:error
+ */
 bool ttLibC_ContainerReader_read(
 		ttLibC_ContainerReader *reader,
 		void  *data,
@@ -86,6 +99,29 @@ bool ttLibC_ContainerReader_read(
 		ttLibC_ContainerReadFunc callback,
 		void  *ptr);
 
+/**
+ * set key frame only mode. (for thumbnail)
+ * audio and non key video are skipped in reader, without making frame.
+ * flv and mkv(simpleBlock) use the key flag of container,
+ * mp4, mkv(block) and mpegts check the nal of h264 / h265.
+ * @param reader      container reader object.
+ * @param is_key_only true:key frame only false:all frames.
+ */
+void ttLibC_ContainerReader_setKeyOnly(
+		ttLibC_ContainerReader *reader,
+		bool is_key_only);
+
+/**
+ * set non copy mode. (for mmaped file)
+ * reader refers the data of read, only unread tail is copied at the end of read.
+ * reader may rewrite the data in place. (nal size to start code...)
+ * @param reader      container reader object.
+ * @param is_non_copy true:refer data false:copy data.
+ */
+void ttLibC_ContainerReader_setNonCopy(
+		ttLibC_ContainerReader *reader,
+		bool is_non_copy);
+
 /**
  * close container reader
  * @param reader
@@ -131,6 +167,14 @@ typedef struct ttLibC_ContainerWriter {
  */
 typedef bool (* ttLibC_ContainerWriteFunc)(void *ptr, void *data, size_t size);
 
+/**
+ * write frame with writer of any type.
+ * @param writer   target writer
+ * @param frame    frame to write
+ * @param callback callback for written data
+ * @param ptr      user def pointer.
+ * @return true:success false:error
+ */
 bool ttLibC_ContainerWriter_write(
 		ttLibC_ContainerWriter *writer,
 		ttLibC_Frame *frame,
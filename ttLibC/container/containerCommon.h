@@ -105,6 +105,21 @@ ttLibC_ContainerReader *ttLibC_ContainerReader_make(
 		ttLibC_Container_Type container_type,
 		size_t reader_size);
 
+/**
+ * check the sample is key or not, without making frame.
+ * use inner only.
+ * @param frame_type  frame type of sample.
+ * @param data        sample data.
+ * @param data_size   sample data size.
+ * @param size_length size length of nal for avcc / hvcc. 0 for annexB.
+ * @return true:key frame(or could not decide) false:non key frame or audio.
+ */
+bool ttLibC_Container_isKeySample(
+		ttLibC_Frame_Type frame_type,
+		uint8_t *data,
+		size_t data_size,
+		uint32_t size_length);
+
 /**
  * common work for containerWriter make
  * use inner only.
@@ -118,6 +133,38 @@ ttLibC_ContainerWriter *ttLibC_ContainerWriter_make(
 		size_t writer_size,
 		uint32_t timebase);
 
+/**
+ * integer rational rescaler for pts / dts.
+ * value * num / den, num / den is reduced. no drift for long recording.
+ */
+typedef struct ttLibC_ContainerWriter_Rescaler {
+	uint32_t src_timebase;
+	uint32_t dst_timebase;
+	uint64_t num;
+	uint64_t den;
+} ttLibC_ContainerWriter_Rescaler;
+
+/**
+ * setup rescaler.
+ * @param rescaler     target rescaler
+ * @param dst_timebase timebase of result
+ * @param src_timebase timebase of input value
+ */
+void ttLibC_ContainerWriter_Rescaler_setup(
+		ttLibC_ContainerWriter_Rescaler *rescaler,
+		uint32_t dst_timebase,
+		uint32_t src_timebase);
+
+/**
+ * convert value. (floor)
+ * @param rescaler target rescaler
+ * @param value    value on src_timebase
+ * @return value on dst_timebase
+ */
+uint64_t ttLibC_ContainerWriter_Rescaler_rescale(
+		ttLibC_ContainerWriter_Rescaler *rescaler,
+		uint64_t value);
+
 typedef struct ttLibC_ContainerWriter_WriteTrack {
 	ttLibC_FrameQueue          *frame_queue;
 	ttLibC_Frame               *h26x_configData;
@@ -126,8 +173,22 @@ typedef struct ttLibC_ContainerWriter_WriteTrack {
 	bool                        is_appending;
 	ttLibC_ContainerWriter_Mode enable_mode;
 	ttLibC_ContainerWriter_Mode use_mode;
+	/** frame timebase -> writer timebase */
+	ttLibC_ContainerWriter_Rescaler rescaler;
+	/** position on pts_heap of writer. */
+	uint32_t                    heap_index;
+	/** queued pts on writer timebase, key of pts_heap. */
+	uint64_t                    heap_pts;
 } ttLibC_ContainerWriter_WriteTrack;
 
+/**
+ * split check from outside of writer.
+ * @param ptr   user def pointer.
+ * @param frame frame on primary track. pts and dts are on writer timebase.
+ * @return true:split at this frame false:continue
+ */
+typedef bool (* ttLibC_ContainerWriter_SplitFunc)(void *ptr, ttLibC_Frame *frame);
+
 // ContainerWriter
 typedef struct ttLibC_ContainerWriter_ {
 	ttLibC_ContainerWriter     inherit_super;
@@ -140,6 +201,19 @@ typedef struct ttLibC_ContainerWriter_ {
 	uint64_t                      current_pts_pos;
 	uint64_t                      target_pos;
 	uint32_t                      unit_duration;
+
+	/** tracks by index, index = track_id - track_base_id */
+	ttLibC_ContainerWriter_WriteTrack **tracks;
+	uint32_t                            track_num;
+	uint32_t                            track_base_id;
+	/** min heap of heap_pts, for isReadyToWrite. */
+	ttLibC_ContainerWriter_WriteTrack **pts_heap;
+	uint32_t                            heap_num;
+	/** split decision from outside. (segmenter) NULL:use mode and unit_duration */
+	ttLibC_ContainerWriter_SplitFunc    split_func;
+	void                               *split_ptr;
+	/** true while flush_, all queued frames are ready to write. */
+	bool                                is_flushing;
 } ttLibC_ContainerWriter_;
 
 ttLibC_ContainerWriter_WriteTrack *ttLibC_ContainerWriteTrack_make(
@@ -167,10 +241,35 @@ int ttLibC_ContainerWriter_write_(
 		ttLibC_ContainerWriteFunc callback,
 		void *ptr);
 
+/**
+ * ref track by id.
+ * @param writer
+ * @param track_id
+ * @return track. NULL for unknown id.
+ */
+ttLibC_ContainerWriter_WriteTrack *ttLibC_ContainerWriter_refTrack(
+		ttLibC_ContainerWriter_ *writer,
+		uint32_t track_id);
+
 bool ttLibC_ContainerWriter_isReadyToStart(ttLibC_ContainerWriter_ *writer);
 bool ttLibC_ContainerWriter_primaryTrackCheck(void *ptr, ttLibC_Frame *frame);
 bool ttLibC_ContainerWriter_isReadyToWrite(ttLibC_ContainerWriter_ *writer);
 
+/**
+ * write all queued frames, for the end of stream.
+ * use inner only. (mp4 / mpegts / mkv, writer with target_check status)
+ * @param writer   writer object.
+ * @param end_pos  end of last chunk on writer timebase, extended to cover queued frames.
+ * @param callback callback for written data.
+ * @param ptr      user def pointer for callback.
+ * @return true:success false:error
+ */
+bool ttLibC_ContainerWriter_flush_(
+		ttLibC_ContainerWriter_ *writer,
+		uint64_t end_pos,
+		ttLibC_ContainerWriteFunc callback,
+		void *ptr);
+
 void ttLibC_ContainerWriteTrack_close(ttLibC_ContainerWriter_WriteTrack **track);
 
 ttLibC_ContainerWriter *ttLibC_ContainerWriter_make_(
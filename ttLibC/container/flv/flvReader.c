@@ -13,6 +13,7 @@
 #include "../../ttLibC_predef.h"
 #include "../../_log.h"
 #include "../../allocator.h"
+#include "../../util/statsUtil.h"
 #include "../../util/hexUtil.h"
 #include "../../util/ioUtil.h"
 
@@ -46,6 +47,20 @@ static bool FlvReader_read(
 		ttLibC_FlvReadFunc callback,
 		void *ptr) {
 	ttLibC_FlvTag *tag = NULL;
+	if(reader->inherit_super.inherit_super.is_key_only) {
+		// skip before making tag, frame type of video is on the first byte of body.
+		switch(reader->type) {
+		case FlvType_audio:
+			return true;
+		case FlvType_video:
+			if(buffer_size <= 11 || (buffer[11] >> 4) != 1) {
+				return true;
+			}
+			break;
+		default:
+			break;
+		}
+	}
 	switch(reader->type) {
 	case FlvType_audio:
 		tag = (ttLibC_FlvTag *)ttLibC_FlvAudioTag_getTag(
@@ -107,11 +122,17 @@ bool TT_VISIBILITY_DEFAULT ttLibC_FlvReader_read(
 		size_t data_size,
 		ttLibC_FlvReadFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_read);
 	if(reader == NULL) {
 		return false;
 	}
 	ttLibC_FlvReader_ *reader_ = (ttLibC_FlvReader_ *)reader;
-	ttLibC_DynamicBuffer_append(reader_->tmp_buffer, (uint8_t *)data, data_size);
+	if(reader_->inherit_super.inherit_super.is_non_copy) {
+		ttLibC_DynamicBuffer_appendNonCopy(reader_->tmp_buffer, (uint8_t *)data, data_size);
+	}
+	else {
+		ttLibC_DynamicBuffer_append(reader_->tmp_buffer, (uint8_t *)data, data_size);
+	}
 	if(reader_->is_reading) {
 		return true;
 	}
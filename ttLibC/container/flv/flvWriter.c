@@ -16,6 +16,7 @@
 #include "../../ttLibC_predef.h"
 #include "../../_log.h"
 #include "../../allocator.h"
+#include "../../util/statsUtil.h"
 #include "../../util/hexUtil.h"
 #include "../../frame/video/h264.h"
 #include <stdlib.h>
@@ -82,9 +83,8 @@ ttLibC_FlvWriter TT_VISIBILITY_DEFAULT *ttLibC_FlvWriter_make(
 static bool FlvWriter_queueFrame(
 		ttLibC_FlvWriter_ *writer,
 		ttLibC_Frame *frame) {
-	// change the timebase to 1000.(mili sec.)
-	frame->pts = (uint64_t)(1.0 * frame->pts * 1000 / frame->timebase);
-	frame->timebase = 1000;
+	// change the timebase to 1000.(mili sec.) on the queued clone, input frame is not changed.
+	uint64_t pts = (uint64_t)(1.0 * frame->pts * 1000 / frame->timebase);
 	switch(frame->type) {
 	case frameType_h264:
 		{
@@ -94,6 +94,11 @@ static bool FlvWriter_queueFrame(
 				return true;
 			case H264Type_configData:
 				writer->video_track.configData = ttLibC_Frame_clone(writer->video_track.configData, frame);
+				if(writer->video_track.configData == NULL) {
+					return false;
+				}
+				writer->video_track.configData->pts = pts;
+				writer->video_track.configData->timebase = 1000;
 				return true;
 			default:
 				break;
@@ -107,7 +112,7 @@ static bool FlvWriter_queueFrame(
 			ERR_PRINT("invalid video frame is detected.");
 			return false;
 		}
- 		if(!ttLibC_FrameQueue_queue(writer->video_track.frame_queue, frame)) {
+ 		if(!ttLibC_FrameQueue_queueWithTime(writer->video_track.frame_queue, frame, pts, frame->dts, 1000)) {
  			return false;
  		}
 		break;
@@ -123,7 +128,7 @@ static bool FlvWriter_queueFrame(
 			ERR_PRINT("invalid audio frame is detected.");
 			return false;
 		}
-		if(!ttLibC_FrameQueue_queue(writer->audio_track.frame_queue, frame)) {
+		if(!ttLibC_FrameQueue_queueWithTime(writer->audio_track.frame_queue, frame, pts, frame->dts, 1000)) {
 			return false;
 		}
 		break;
@@ -213,6 +218,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_FlvWriter_write(
 		ttLibC_Frame *frame,
 		ttLibC_ContainerWriteFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_write);
 	ttLibC_FlvWriter_ *writer_ = (ttLibC_FlvWriter_ *)writer;
 	if(writer_->is_first) {
 		// try to write header information.
@@ -97,6 +97,23 @@ bool ttLibC_FrameQueue_queue(
 		ttLibC_FrameQueue *queue,
 		ttLibC_Frame *frame);
 
+/**
+ * add frame on queue, with other timestamp.
+ * input frame is not changed, the timestamp is set on the queued clone.
+ * @param queue    target queue object.
+ * @param frame    add frame object.
+ * @param pts      pts for queued frame.
+ * @param dts      dts for queued frame.
+ * @param timebase timebase for queued frame.
+ * @return true:success false:error.
+ */
+bool ttLibC_FrameQueue_queueWithTime(
+		ttLibC_FrameQueue *queue,
+		ttLibC_Frame *frame,
+		uint64_t pts,
+		uint64_t dts,
+		uint32_t timebase);
+
 /**
  * close queue object
  * @param queue
@@ -342,6 +342,28 @@ static bool FrameQueue_updateFrame(
 bool TT_VISIBILITY_HIDDEN ttLibC_FrameQueue_queue(
 		ttLibC_FrameQueue *queue,
 		ttLibC_Frame *frame) {
+	if(frame == NULL) {
+		return false;
+	}
+	return ttLibC_FrameQueue_queueWithTime(queue, frame, frame->pts, frame->dts, frame->timebase);
+}
+
+/*
+ * add frame on queue, with other timestamp.
+ * input frame is not changed, timestamp is set on the clone.
+ * @param queue    target queue object.
+ * @param frame    add frame object.
+ * @param pts      pts for queued frame.
+ * @param dts      dts for queued frame.
+ * @param timebase timebase for queued frame.
+ * @return true:success false:error.
+ */
+bool TT_VISIBILITY_HIDDEN ttLibC_FrameQueue_queueWithTime(
+		ttLibC_FrameQueue *queue,
+		ttLibC_Frame *frame,
+		uint64_t pts,
+		uint64_t dts,
+		uint32_t timebase) {
 	ttLibC_FrameQueue2_ *queue_ = (ttLibC_FrameQueue2_ *)queue;
 	if(queue_ == NULL) {
 		return false;
@@ -358,7 +380,9 @@ bool TT_VISIBILITY_HIDDEN ttLibC_FrameQueue_queue(
 		return false;
 	}
 	// let save dts information from frame.
-	f->dts = frame->dts;
+	f->pts      = pts;
+	f->dts      = dts;
+	f->timebase = timebase;
 	ttLibC_StlList_remove(queue_->used_frame_list, prev_frame);
 	if(f->dts == 0) {
 		switch(f->type) {
@@ -14,6 +14,7 @@
 #include "../../ttLibC_predef.h"
 #include "../../_log.h"
 #include "../../allocator.h"
+#include "../../util/statsUtil.h"
 #include "../../util/hexUtil.h"
 #include "../../util/ioUtil.h"
 #include "../../util/byteUtil.h"
@@ -78,6 +79,7 @@ static bool MkvReader_readTag(
 	case MkvType_Audio:
 		{
 			ttLibC_MkvTag mkvTag;
+			mkvTag.inherit_super.inherit_super.type = containerType_mkv;
 			mkvTag.inherit_super.type = type;
 			mkvTag.inherit_super.inherit_super.data = NULL;
 			mkvTag.inherit_super.inherit_super.data_size = size + byte_reader->read_size;
@@ -394,8 +396,14 @@ bool TT_VISIBILITY_DEFAULT ttLibC_MkvReader_read(
 		size_t data_size,
 		ttLibC_MkvReadFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_read);
 	ttLibC_MkvReader_ *reader_ = (ttLibC_MkvReader_ *)reader;
-	ttLibC_DynamicBuffer_append(reader_->tmp_buffer, data, data_size);
+	if(reader_->inherit_super.inherit_super.is_non_copy) {
+		ttLibC_DynamicBuffer_appendNonCopy(reader_->tmp_buffer, data, data_size);
+	}
+	else {
+		ttLibC_DynamicBuffer_append(reader_->tmp_buffer, data, data_size);
+	}
 	if(reader_->in_reading) {
 		return true;
 	}
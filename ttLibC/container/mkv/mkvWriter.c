@@ -13,6 +13,7 @@
 #include "../../ttLibC_predef.h"
 #include "../../_log.h"
 #include "../../allocator.h"
+#include "../../util/statsUtil.h"
 #include "../../util/hexUtil.h"
 #include "../container.h"
 #include "../containerCommon.h"
@@ -653,7 +654,7 @@ static bool MkvWriter_makeData(
 		is_found = false;
 		// find lowest pts data from all tracks.
 		for(uint32_t i = 0;i < writer->track_list->size;++ i) {
-			ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)ttLibC_StlMap_get(writer->track_list, (void *)(long)(1 + i));
+			ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriter_refTrack(writer, 1 + i);
 			frame = ttLibC_FrameQueue_ref_first(track->frame_queue);
 			if(frame != NULL) {
 				if(!is_found) { // add any in the case of not found.
@@ -677,7 +678,7 @@ static bool MkvWriter_makeData(
 			// no track. done
 			break;
 		}
-		ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)ttLibC_StlMap_get(writer->track_list, (void *)target_track);
+		ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriter_refTrack(writer, target_track);
 		frame = ttLibC_FrameQueue_dequeue_first(track->frame_queue);
 		// check if frame is not written in block.
 		switch(frame->type) {
@@ -976,7 +977,7 @@ static bool MkvWriter_writeFromQueue(
 		break;
 	case status_target_check:
 		{
-			ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)ttLibC_StlMap_get(writer->track_list, (void *)1);
+			ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriter_refTrack(writer, 1);
 			ttLibC_FrameQueue_ref(track->frame_queue, ttLibC_ContainerWriter_primaryTrackCheck, writer);
 			if(writer->target_pos != writer->current_pts_pos) {
 				writer->status = status_data_check;
@@ -1019,6 +1020,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_MkvWriter_write(
 		ttLibC_Frame *frame,
 		ttLibC_ContainerWriteFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_write);
 	switch(ttLibC_ContainerWriter_write_(
 			(ttLibC_ContainerWriter_ *)writer,
 			frame,
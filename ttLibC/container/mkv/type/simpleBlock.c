@@ -467,6 +467,36 @@ static void SimpleBlock_getLace0Frame(
 	}
 }
 
+/*
+ * check the block for key only mode.
+ * simpleBlock has key flag, block(in blockGroup) does not, check the nal.
+ */
+static bool SimpleBlock_isKeyTarget(
+		ttLibC_MkvReader_ *reader,
+		ttLibC_MkvTrack *track,
+		ttLibC_MkvTag *tag,
+		bool is_key,
+		uint8_t *data,
+		size_t data_size,
+		ttLibC_getFrameFunc callback,
+		void *ptr) {
+	if(!ttLibC_isVideo(track->type)) {
+		return false;
+	}
+	if(tag->inherit_super.type == MkvType_SimpleBlock) {
+		return is_key;
+	}
+	if(track->frame == NULL) {
+		// need size_length from private data.
+		ttLibC_MkvTag_getPrivateDataFrame((ttLibC_MkvReader *)reader, track, callback, ptr);
+	}
+	return ttLibC_Container_isKeySample(
+			track->type,
+			data,
+			data_size,
+			track->private_data_size != 0 ? track->size_length : 0);
+}
+
 bool TT_VISIBILITY_HIDDEN ttLibC_SimpleBlock_getFrame(
 		ttLibC_MkvTag *tag,
 		ttLibC_getFrameFunc callback,
@@ -478,7 +508,7 @@ bool TT_VISIBILITY_HIDDEN ttLibC_SimpleBlock_getFrame(
 	uint32_t track_id     = ttLibC_ByteReader_ebml(byte_reader, false);
 	int16_t timecode_diff = (int16_t)ttLibC_ByteReader_bit(byte_reader, 16);
 
-	/*bool is_key           = */ttLibC_ByteReader_bit(byte_reader, 1)/* == 1*/;
+	bool is_key           = ttLibC_ByteReader_bit(byte_reader, 1) == 1;
 	ttLibC_ByteReader_bit(byte_reader, 3);
 	/*bool is_invisible     = */ttLibC_ByteReader_bit(byte_reader, 1)/* == 1*/;
 	uint32_t lacing       = ttLibC_ByteReader_bit(byte_reader, 2);
@@ -495,6 +525,10 @@ bool TT_VISIBILITY_HIDDEN ttLibC_SimpleBlock_getFrame(
 		ERR_PRINT("failed to get track information.");
 		reader->error_number = 1;
 	}
+	else if(reader->inherit_super.inherit_super.is_key_only
+			&& !SimpleBlock_isKeyTarget(reader, track, tag, is_key, data, data_size, callback, ptr)) {
+		// skip audio and non key video.
+	}
 	else {
 		switch(lacing) {
 		case 0:
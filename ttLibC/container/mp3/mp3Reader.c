@@ -12,6 +12,8 @@
 #include "../../ttLibC_predef.h"
 #include "../../_log.h"
 #include "../../allocator.h"
+#include "../../util/audioSyncUtil.h"
+#include "../../util/statsUtil.h"
 #include "../../frame/audio/mp3.h"
 #include <stdlib.h>
 #include <string.h>
@@ -76,41 +78,107 @@ ttLibC_Mp3 TT_VISIBILITY_HIDDEN *Mp3Reader_readMp3FromBinary(
 	return mp3;
 }
 
+/*
+ * pass mp3 to callback with mp3Frame container.
+ */
+static bool Mp3Reader_callback(
+		ttLibC_Mp3Reader_ *reader,
+		ttLibC_Mp3 *mp3,
+		ttLibC_Mp3ReadFunc callback,
+		void *ptr) {
+	if(!Mp3Reader_updateMp3Frame(
+			reader,
+			mp3)) {
+		ERR_PRINT("failed to make mp3 frame");
+		ttLibC_DynamicBuffer_clear(reader->tmp_buffer);
+		reader->is_reading = false;
+		return false;
+	}
+	if(!callback(ptr, (ttLibC_Container_Mp3 *)reader->frame)) {
+		ttLibC_DynamicBuffer_clear(reader->tmp_buffer);
+		reader->is_reading = false;
+		return false;
+	}
+	return true;
+}
+
 bool TT_VISIBILITY_DEFAULT ttLibC_Mp3Reader_read(
 		ttLibC_Mp3Reader *reader,
 		void *data,
 		size_t data_size,
 		ttLibC_Mp3ReadFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_read);
 	ttLibC_Mp3Reader_ *reader_ = (ttLibC_Mp3Reader_ *)reader;
 	ttLibC_Mp3 *mp3 = NULL;
-	ttLibC_DynamicBuffer_append(reader_->tmp_buffer, data, data_size);
+	if(reader_->inherit_super.inherit_super.is_non_copy) {
+		ttLibC_DynamicBuffer_appendNonCopy(reader_->tmp_buffer, data, data_size);
+	}
+	else {
+		ttLibC_DynamicBuffer_append(reader_->tmp_buffer, data, data_size);
+	}
 	if(reader_->is_reading) {
 		return true;
 	}
 	reader_->is_reading = true;
 	do {
-		mp3 = Mp3Reader_readMp3FromBinary(reader_, ttLibC_DynamicBuffer_refData(reader_->tmp_buffer), ttLibC_DynamicBuffer_refSize(reader_->tmp_buffer));
-		if(mp3 == NULL) {
-			// if mp3 is NULL, need more data.
-			ttLibC_DynamicBuffer_clear(reader_->tmp_buffer);
-			reader_->is_reading = false;
-			return true;
+		uint8_t *buf = ttLibC_DynamicBuffer_refData(reader_->tmp_buffer);
+		size_t buf_size = ttLibC_DynamicBuffer_refSize(reader_->tmp_buffer);
+		bool is_tag = false;
+		if(buf_size != 0 && (buf[0] == 'I' || buf[0] == 'T')) {
+			// id3 and tag. other data starts with the same byte is left for the scanner.
+			const char *magic = buf[0] == 'I' ? "ID3" : "TAG";
+			size_t check_size = buf_size < 3 ? buf_size : 3;
+			if(memcmp(buf, magic, check_size) == 0) {
+				if(check_size < 3) {
+					// need more data to check magic.
+					ttLibC_DynamicBuffer_clear(reader_->tmp_buffer);
+					reader_->is_reading = false;
+					return true;
+				}
+				is_tag = true;
+			}
 		}
-		ttLibC_DynamicBuffer_markAsRead(reader_->tmp_buffer, mp3->inherit_super.inherit_super.buffer_size);
-		if(!Mp3Reader_updateMp3Frame(
-				reader_,
-				mp3)) {
-			ERR_PRINT("failed to make mp3 frame");
-			ttLibC_DynamicBuffer_clear(reader_->tmp_buffer);
-			reader_->is_reading = false;
-			return false;
+		if(is_tag) {
+			mp3 = Mp3Reader_readMp3FromBinary(reader_, buf, buf_size);
+			if(mp3 == NULL) {
+				// if mp3 is NULL, need more data.
+				ttLibC_DynamicBuffer_clear(reader_->tmp_buffer);
+				reader_->is_reading = false;
+				return true;
+			}
+			ttLibC_DynamicBuffer_markAsRead(reader_->tmp_buffer, mp3->inherit_super.inherit_super.buffer_size);
+			if(!Mp3Reader_callback(reader_, mp3, callback, ptr)) {
+				return false;
+			}
+			continue;
 		}
-		if(!callback(ptr, (ttLibC_Container_Mp3 *)reader_->frame)) {
+		// find frames in batch, garbage between frames is skipped.
+		ttLibC_AudioSync_Unit units[64];
+		size_t read_size = 0;
+		uint32_t num = ttLibC_AudioSync_scan(AudioSyncType_mp3, buf, buf_size, units, 64, &read_size);
+		if(read_size == 0) {
+			// need more data.
 			ttLibC_DynamicBuffer_clear(reader_->tmp_buffer);
 			reader_->is_reading = false;
-			return false;
+			return true;
+		}
+		size_t pos = 0;
+		for(uint32_t i = 0;i < num;++ i) {
+			ttLibC_DynamicBuffer_markAsRead(reader_->tmp_buffer, units[i].offset + units[i].size - pos);
+			pos = units[i].offset + units[i].size;
+			mp3 = Mp3Reader_readMp3FromBinary(reader_, buf + units[i].offset, units[i].size);
+			if(mp3 == NULL) {
+				ERR_PRINT("failed to make mp3 frame");
+				ttLibC_DynamicBuffer_clear(reader_->tmp_buffer);
+				reader_->is_reading = false;
+				return false;
+			}
+			if(!Mp3Reader_callback(reader_, mp3, callback, ptr)) {
+				return false;
+			}
 		}
+		ttLibC_DynamicBuffer_markAsRead(reader_->tmp_buffer, read_size - pos);
 	} while(true);
 }
 
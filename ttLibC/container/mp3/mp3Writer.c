@@ -12,6 +12,7 @@
 #include "../../ttLibC_predef.h"
 #include "../../_log.h"
 #include "../../allocator.h"
+#include "../../util/statsUtil.h"
 #include "../../frame/audio/mp3.h"
 #include <stdlib.h>
 
@@ -28,6 +29,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_Mp3Writer_write(
 		ttLibC_Frame *frame,
 		ttLibC_ContainerWriteFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_write);
 	ttLibC_Mp3Writer_ *writer_ = (ttLibC_Mp3Writer_ *)writer;
 	if(writer_ == NULL) {
 		ERR_PRINT("writer is not ready.");
@@ -17,6 +17,7 @@
 #include "type/stts.h"
 #include "type/stco.h"
 #include "type/stsc.h"
+#include "type/stss.h"
 #include "type/stsz.h"
 #include "type/trun.h"
 #include "type/elst.h"
@@ -45,6 +46,7 @@ ttLibC_Mp4Atom TT_VISIBILITY_HIDDEN *ttLibC_Mp4Atom_make(
 				ttLibC_Stco stco;
 				ttLibC_Stsc stsc;
 				ttLibC_Stsz stsz;
+				ttLibC_Stss stss;
 				ttLibC_Trun trun;
 			}),
 			containerType_mp4,
@@ -315,7 +317,11 @@ static bool Mp4Atom_getTrackFrame(
 			}
 			uint32_t duration = ttLibC_Stts_refCurrentDelta(track->stts);
 
-			if(!Mp4Atom_getFrame(track, mdat_data + currentPos - reader->mdat_start_pos, sample_size, pts, track->timebase, duration, callback, ptr)) {
+			if(reader->inherit_super.inherit_super.is_key_only
+			&& !ttLibC_Stss_refCurrentIsSync(track->stss)) {
+				// skip non sync sample on stss, without reading data.
+			}
+			else if(!Mp4Atom_getFrame(track, mdat_data + currentPos - reader->mdat_start_pos, sample_size, pts, track->timebase, duration, callback, ptr)) {
 				reader->error_number = 5;
 				// quit the loop.
 				return false;
@@ -323,6 +329,7 @@ static bool Mp4Atom_getTrackFrame(
 			ttLibC_Stts_moveNext(track->stts); // prepare next sample time information
 			ttLibC_Ctts_moveNext(track->ctts);
 			ttLibC_Stsz_moveNext(track->stsz); // prepare next sample size
+			ttLibC_Stss_moveNext(track->stss);
 			currentPos += sample_size;
 		}
 		// go next chunk.
@@ -344,6 +351,9 @@ static bool Mp4Atom_getMdatFrameCallback(
 		return false;
 	}
 	ttLibC_Mp4Reader_ *reader = (ttLibC_Mp4Reader_ *)mdatAtom->reader;
+	if(reader->inherit_super.inherit_super.is_key_only && !track->is_video) {
+		return true;
+	}
 	if(!Mp4Atom_getTrackFrame(
 			mdatAtom->inherit_super.inherit_super.data,
 			mdatAtom->inherit_super.inherit_super.buffer_size,
@@ -372,6 +382,9 @@ static bool Mp4Atom_getFmp4FrameCallback(
 	if(reader->error_number != 0) {
 		return false;
 	}
+	if(reader->inherit_super.inherit_super.is_key_only && !track->is_video) {
+		return true;
+	}
 	uint8_t *mdat_buffer = mdatAtom->inherit_super.inherit_super.data;
 	uint64_t pos, pts;
 	uint32_t size, duration, pts_offset;
@@ -396,6 +409,11 @@ static bool Mp4Atom_getFmp4FrameCallback(
 			LOG_PRINT("find 0 pts frame.");
 			pts = 0;
 		}
+		if(reader->inherit_super.inherit_super.is_key_only
+		&& !ttLibC_Trun_refCurrentIsSync(track->trun)) {
+			// skip non sync sample on trun sample flags, without reading data.
+			continue;
+		}
 		if(!Mp4Atom_getFrame(
 				track,
 				target_buffer,
@@ -47,6 +47,7 @@ typedef struct ttLibC_Mp4Track {
 	ttLibC_Mp4 *stts;
 	ttLibC_Mp4 *stsc;
 	ttLibC_Mp4 *stsz;
+	ttLibC_Mp4 *stss;
 	ttLibC_Mp4 *stco;
 	ttLibC_Mp4 *ctts;
 	ttLibC_Mp4 *elst;
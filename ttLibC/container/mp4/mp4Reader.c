@@ -14,12 +14,14 @@
 #include "../../ttLibC_predef.h"
 #include "../../_log.h"
 #include "../../allocator.h"
+#include "../../util/statsUtil.h"
 #include "../../util/hexUtil.h"
 #include "../../util/ioUtil.h"
 #include "../../util/byteUtil.h"
 #include "type/ctts.h"
 #include "type/stco.h"
 #include "type/stsc.h"
+#include "type/stss.h"
 #include "type/stsz.h"
 #include "type/stts.h"
 #include "type/trun.h"
@@ -619,7 +621,14 @@ static bool Mp4Reader_readAtom(
 					}
 				}
 				break;
-//			case Mp4Type_Stss:
+			case Mp4Type_Stss:
+				{
+					reader->track->stss = ttLibC_Stss_make(data, size, reader->timebase);
+					if(reader->track->stss == NULL) {
+						reader->error_number = 1;
+					}
+				}
+				break;
 			case Mp4Type_Stsc:
 				{
 					reader->track->stsc = ttLibC_Stsc_make(data, size, reader->timebase);
@@ -726,8 +735,14 @@ bool TT_VISIBILITY_DEFAULT ttLibC_Mp4Reader_read(
 		size_t data_size,
 		ttLibC_Mp4ReadFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_read);
 	ttLibC_Mp4Reader_ *reader_ = (ttLibC_Mp4Reader_ *)reader;
-	ttLibC_DynamicBuffer_append(reader_->tmp_buffer, data, data_size);
+	if(reader_->inherit_super.inherit_super.is_non_copy) {
+		ttLibC_DynamicBuffer_appendNonCopy(reader_->tmp_buffer, data, data_size);
+	}
+	else {
+		ttLibC_DynamicBuffer_append(reader_->tmp_buffer, data, data_size);
+	}
 	if(reader_->in_reading) {
 		return true;
 	}
@@ -752,6 +767,7 @@ static bool Mp4Reader_closeTrack(void *ptr, void *key, void *item) {
 		ttLibC_Mp4Atom_close((ttLibC_Mp4Atom **)&track->stsc);
 		ttLibC_Mp4Atom_close((ttLibC_Mp4Atom **)&track->stts);
 		ttLibC_Mp4Atom_close((ttLibC_Mp4Atom **)&track->stsz);
+		ttLibC_Mp4Atom_close((ttLibC_Mp4Atom **)&track->stss);
 		ttLibC_Mp4Atom_close((ttLibC_Mp4Atom **)&track->stco);
 		ttLibC_Mp4Atom_close((ttLibC_Mp4Atom **)&track->ctts);
 		ttLibC_Mp4Atom_close((ttLibC_Mp4Atom **)&track->trun);
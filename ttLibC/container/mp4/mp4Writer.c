@@ -11,6 +11,7 @@
 #include "../../ttLibC_predef.h"
 #include "../../_log.h"
 #include "../../allocator.h"
+#include "../../util/statsUtil.h"
 #include "../../util/hexUtil.h"
 #include "../../util/ioUtil.h"
 #include "../container.h"
@@ -718,7 +719,8 @@ static bool Mp4Writer_makeTraf(void *ptr, void *key, void *item) {
 						}
 						// get next frame to get duration of frame.
 						ttLibC_Frame *next_frame = ttLibC_FrameQueue_ref_first(track->inherit_super.frame_queue);
-						uint32_t duration = next_frame->dts - h264->inherit_super.inherit_super.dts;
+						// last frame on flush has no next, use the end of chunk.
+						uint32_t duration = (next_frame != NULL ? next_frame->dts : writer->inherit_super.target_pos) - h264->inherit_super.inherit_super.dts;
 						uint32_t be_duration = be_uint32_t(duration);
 						ttLibC_DynamicBuffer_append(buffer, (uint8_t *)&be_duration, 4);
 
@@ -802,7 +804,8 @@ static bool Mp4Writer_makeTraf(void *ptr, void *key, void *item) {
 						}
 						// get next frame to get duration of frame.
 						ttLibC_Frame *next_frame = ttLibC_FrameQueue_ref_first(track->inherit_super.frame_queue);
-						uint32_t duration = next_frame->dts - h265->inherit_super.inherit_super.dts;
+						// last frame on flush has no next, use the end of chunk.
+						uint32_t duration = (next_frame != NULL ? next_frame->dts : writer->inherit_super.target_pos) - h265->inherit_super.inherit_super.dts;
 						uint32_t be_duration = be_uint32_t(duration);
 						ttLibC_DynamicBuffer_append(buffer, (uint8_t *)&be_duration, 4);
 
@@ -865,7 +868,7 @@ static bool Mp4Writer_makeTraf(void *ptr, void *key, void *item) {
 						}
 						// get next frame to get duration of frame.
 						ttLibC_Frame *next_frame = ttLibC_FrameQueue_ref_first(track->inherit_super.frame_queue);
-						uint32_t duration = next_frame->pts - jpeg->inherit_super.pts;
+						uint32_t duration = (next_frame != NULL ? next_frame->pts : writer->inherit_super.target_pos) - jpeg->inherit_super.pts;
 						uint32_t be_duration = be_uint32_t(duration);
 						ttLibC_DynamicBuffer_append(buffer, (uint8_t *)&be_duration, 4);
 
@@ -1160,7 +1163,7 @@ static bool Mp4Writer_writeFromQueue(
 	case status_target_check:
 		{
 			// check 1st track to decide target_pos.
-			ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)ttLibC_StlMap_get(writer->inherit_super.track_list, (void *)1);
+			ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriter_refTrack((ttLibC_ContainerWriter_ *)writer, 1);
 			ttLibC_FrameQueue_ref(track->frame_queue, ttLibC_ContainerWriter_primaryTrackCheck, writer);
 			if(writer->inherit_super.target_pos != writer->inherit_super.current_pts_pos) {
 				// check each track.
@@ -1205,6 +1208,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_Mp4Writer_write(
 		ttLibC_Frame *frame,
 		ttLibC_ContainerWriteFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_write);
 	switch(ttLibC_ContainerWriter_write_(
 			(ttLibC_ContainerWriter_ *)writer,
 			frame,
@@ -32,12 +32,22 @@ ttLibC_Mp4 TT_VISIBILITY_HIDDEN *ttLibC_Stsc_make(
 	buf += 3;
 	stsc->entry_count = be_uint32_t(*buf);
 	++ buf;
-	stsc->first_chunk = be_uint32_t(*buf);
-	++ buf;
-	stsc->samples_in_chunk = be_uint32_t(*buf);
-	++ buf;
-	stsc->sample_description_ref = be_uint32_t(*buf);
-	++ buf;
+	if(stsc->entry_count == 0) {
+		// fmp4 has no entry.
+		stsc->first_chunk = UINT32_MAX;
+		stsc->samples_in_chunk = 0;
+		stsc->sample_description_ref = 0;
+	}
+	else {
+		stsc->first_chunk = be_uint32_t(*buf);
+		++ buf;
+		stsc->samples_in_chunk = be_uint32_t(*buf);
+		++ buf;
+		stsc->sample_description_ref = be_uint32_t(*buf);
+		++ buf;
+		// entry_count is the number of entries left on data.
+		-- stsc->entry_count;
+	}
 	stsc->data = buf;
 	stsc->current_count = 1;
 	stsc->current_samples_in_chunk = stsc->samples_in_chunk;
@@ -61,16 +71,20 @@ void TT_VISIBILITY_HIDDEN ttLibC_Stsc_moveNext(ttLibC_Mp4 *mp4) {
 	ttLibC_Stsc *stsc = (ttLibC_Stsc *)mp4;
 	stsc->current_count ++;
 	if(stsc->current_count > stsc->first_chunk) {
+		stsc->current_samples_in_chunk = stsc->samples_in_chunk;
+		stsc->current_sample_description_ref = stsc->sample_description_ref;
 		if(stsc->entry_count > 0) {
 			stsc->first_chunk = be_uint32_t(*stsc->data);
 			++ stsc->data;
-			stsc->current_samples_in_chunk = stsc->samples_in_chunk;
-			stsc->current_sample_description_ref = stsc->sample_description_ref;
 			stsc->samples_in_chunk = be_uint32_t(*stsc->data);
 			++ stsc->data;
 			stsc->sample_description_ref = be_uint32_t(*stsc->data);
 			++ stsc->data;
 			-- stsc->entry_count;
 		}
+		else {
+			// last entry is used until the end, don't read over the data.
+			stsc->first_chunk = UINT32_MAX;
+		}
 	}
 }
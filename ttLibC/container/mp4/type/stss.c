@@ -0,0 +1,57 @@
+/**
+ * @file   stss.c
+ * @brief  stss atom support.
+ *
+ * this code is under 3-Cause BSD License.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "stss.h"
+#include "../../../ttLibC_predef.h"
+#include "../../../util/ioUtil.h"
+
+ttLibC_Mp4 TT_VISIBILITY_HIDDEN *ttLibC_Stss_make(
+		uint8_t *data,
+		size_t data_size,
+		uint32_t timebase) {
+	ttLibC_Stss *stss = (ttLibC_Stss *)ttLibC_Mp4Atom_make(
+			NULL,
+			data,
+			data_size,
+			false,
+			0,
+			timebase,
+			Mp4Type_Stss);
+	if(stss == NULL) {
+		return NULL;
+	}
+	uint32_t *buf = (uint32_t *)stss->inherit_super.inherit_super.inherit_super.data;
+	buf += 3;
+	stss->entry_count = be_uint32_t(*buf);
+	stss->sample_number_data = buf + 1;
+	// sample number starts with 1.
+	stss->current_sample_number = 1;
+	return (ttLibC_Mp4 *)stss;
+}
+bool TT_VISIBILITY_HIDDEN ttLibC_Stss_refCurrentIsSync(ttLibC_Mp4 *mp4) {
+	ttLibC_Stss *stss = (ttLibC_Stss *)mp4;
+	if(stss == NULL) {
+		// no stss, all samples are sync sample.
+		return true;
+	}
+	// sample number is in increasing order.
+	while(stss->entry_count > 0 && be_uint32_t(*stss->sample_number_data) < stss->current_sample_number) {
+		++ stss->sample_number_data;
+		-- stss->entry_count;
+	}
+	return stss->entry_count > 0 && be_uint32_t(*stss->sample_number_data) == stss->current_sample_number;
+}
+void TT_VISIBILITY_HIDDEN ttLibC_Stss_moveNext(ttLibC_Mp4 *mp4) {
+	ttLibC_Stss *stss = (ttLibC_Stss *)mp4;
+	if(stss == NULL) {
+		return;
+	}
+	++ stss->current_sample_number;
+}
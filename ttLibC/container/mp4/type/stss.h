@@ -0,0 +1,40 @@
+/**
+ * @file   stss.h
+ * @brief  stss atom support.
+ *
+ * this code is under 3-Cause BSD License.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_CONTAINER_MP4_TYPE_STSS_H_
+#define TTLIBC_CONTAINER_MP4_TYPE_STSS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../mp4Atom.h"
+
+typedef struct ttLibC_Container_Mp4_Stss {
+	ttLibC_Mp4Atom inherit_super;
+	uint32_t entry_count;
+	uint32_t *sample_number_data;
+	uint32_t current_sample_number;
+} ttLibC_Container_Mp4_Stss;
+
+typedef ttLibC_Container_Mp4_Stss ttLibC_Stss;
+
+ttLibC_Mp4 *ttLibC_Stss_make(
+		uint8_t *data,
+		size_t data_size,
+		uint32_t timebase);
+bool ttLibC_Stss_refCurrentIsSync(ttLibC_Mp4 *mp4);
+void ttLibC_Stss_moveNext(ttLibC_Mp4 *mp4);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_CONTAINER_MP4_TYPE_STSS_H_ */
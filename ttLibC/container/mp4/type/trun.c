@@ -79,11 +79,17 @@ uint32_t TT_VISIBILITY_HIDDEN ttLibC_Trun_refCurrentTimeOffset(ttLibC_Mp4 *mp4)
 	ttLibC_Trun *trun = (ttLibC_Trun *)mp4;
 	return trun->current_composition_time_offset;
 }
+bool TT_VISIBILITY_HIDDEN ttLibC_Trun_refCurrentIsSync(ttLibC_Mp4 *mp4) {
+	ttLibC_Trun *trun = (ttLibC_Trun *)mp4;
+	// sample_is_non_sync_sample
+	return (trun->current_flags & 0x00010000) == 0;
+}
 bool TT_VISIBILITY_HIDDEN ttLibC_Trun_moveNext(ttLibC_Mp4 *mp4) {
 	ttLibC_Trun *trun = (ttLibC_Trun *)mp4;
 	ttLibC_Mp4Track *track = trun->track;
 	uint8_t *buf = trun->data;
 	size_t buf_size = trun->data_size;
+	bool is_first = false;
 	if(trun->sample_count == 0) {
 		// in the case of more data. need to check traf binary.
 		while(buf_size >= 0) {
@@ -133,6 +139,7 @@ bool TT_VISIBILITY_HIDDEN ttLibC_Trun_moveNext(ttLibC_Mp4 *mp4) {
 				if(trun->sample_count == 0) {
 					continue;
 				}
+				is_first = true;
 				break;
 			}
 			buf += (sz - 4);
@@ -174,6 +181,10 @@ bool TT_VISIBILITY_HIDDEN ttLibC_Trun_moveNext(ttLibC_Mp4 *mp4) {
 		buf += 4;
 		buf_size -= 4;
 	}
+	else if(is_first) {
+		// first_sample_flags is only for the first sample.
+		trun->current_flags = trun->first_sample_flags;
+	}
 	else {
 		if(track->tfhd_sample_flags != 0) {
 			trun->current_flags = track->tfhd_sample_flags;
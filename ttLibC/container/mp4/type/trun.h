@@ -50,6 +50,7 @@ uint32_t ttLibC_Trun_refCurrentDelta(ttLibC_Mp4 *mp4);
 uint32_t ttLibC_Trun_refCurrentPos(ttLibC_Mp4 *mp4);
 uint32_t ttLibC_Trun_refCurrentSize(ttLibC_Mp4 *mp4);
 uint32_t ttLibC_Trun_refCurrentTimeOffset(ttLibC_Mp4 *mp4);
+bool ttLibC_Trun_refCurrentIsSync(ttLibC_Mp4 *mp4);
 bool ttLibC_Trun_moveNext(ttLibC_Mp4 *mp4);
 
 #ifdef __cplusplus
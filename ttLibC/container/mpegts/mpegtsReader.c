@@ -13,6 +13,7 @@
 #include "../../ttLibC_predef.h"
 #include "../../_log.h"
 #include "../../allocator.h"
+#include "../../util/statsUtil.h"
 #include "../../util/hexUtil.h"
 #include "../../util/ioUtil.h"
 
@@ -33,9 +34,88 @@ ttLibC_MpegtsReader TT_VISIBILITY_DEFAULT *ttLibC_MpegtsReader_make() {
 
 	reader->tmp_buffer = ttLibC_DynamicBuffer_make();
 	reader->is_reading = false;
+	memset(reader->random_access_pids, 0, sizeof(reader->random_access_pids));
+	memset(reader->skip_pids, 0, sizeof(reader->skip_pids));
 	return (ttLibC_MpegtsReader *)reader;
 }
 
+/*
+ * check stream_type on pmt is video or not.
+ */
+static bool MpegtsReader_isVideoStream(uint8_t stream_type) {
+	switch(stream_type) {
+	case 0x01: // mpeg1 video
+	case 0x02: // mpeg2 video
+	case 0x10: // mpeg4 video
+	case 0x1B: // h264
+	case 0x24: // h265
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+ * ref the bit for pid.
+ */
+static bool MpegtsReader_refPidFlag(uint8_t *pids, uint32_t pid) {
+	return (pids[(pid >> 3) & 0x3FF] & (1 << (pid & 0x07))) != 0;
+}
+
+/*
+ * set the bit for pid.
+ */
+static void MpegtsReader_setPidFlag(uint8_t *pids, uint32_t pid, bool flag) {
+	if(flag) {
+		pids[(pid >> 3) & 0x3FF] |= (1 << (pid & 0x07));
+	}
+	else {
+		pids[(pid >> 3) & 0x3FF] &= ~(1 << (pid & 0x07));
+	}
+}
+
+/*
+ * check the first packet of pes for key only mode.
+ * once random access indicator is found on pid, pes without it is skipped before making pes.
+ * @return true:skip this pes false:read
+ */
+static bool MpegtsReader_checkSkipPes(
+		ttLibC_MpegtsReader_ *reader,
+		uint8_t *buffer,
+		uint32_t pid) {
+	// adaptation field exists, and random_access_indicator is on.
+	bool is_random_access = (buffer[3] & 0x20) != 0 && buffer[4] > 0 && (buffer[5] & 0x40) != 0;
+	if(is_random_access) {
+		MpegtsReader_setPidFlag(reader->random_access_pids, pid, true);
+	}
+	bool is_skip = !is_random_access && MpegtsReader_refPidFlag(reader->random_access_pids, pid);
+	MpegtsReader_setPidFlag(reader->skip_pids, pid, is_skip);
+	return is_skip;
+}
+
+/*
+ * check complete pes for key only mode.
+ * @return true:do callback false:skip
+ */
+static bool MpegtsReader_isKeyTarget(
+		ttLibC_MpegtsReader_ *reader,
+		ttLibC_Pes *pes,
+		uint32_t pid) {
+	if(!reader->inherit_super.inherit_super.is_key_only) {
+		return true;
+	}
+	if(MpegtsReader_refPidFlag(reader->random_access_pids, pid)) {
+		// non key pes is already skipped.
+		return true;
+	}
+	// no random access indicator on this stream, check nal.
+	return ttLibC_Container_isKeySample(
+			pes->frame_type,
+			ttLibC_DynamicBuffer_refData(pes->buffer),
+			ttLibC_DynamicBuffer_refSize(pes->buffer),
+			0);
+}
+
 static bool MpegtsReader_read(
 		ttLibC_MpegtsReader_ *reader,
 		uint8_t *buffer,
@@ -89,16 +169,32 @@ static bool MpegtsReader_read(
 		for(uint32_t i = 0;i < reader->pmt->pes_track_num;++ i) {
 			if(pid == reader->pmt->pmtElementaryField_list[i].pid) {
 				find = true;
+				if(reader->inherit_super.inherit_super.is_key_only
+				&& !MpegtsReader_isVideoStream(reader->pmt->pmtElementaryField_list[i].stream_type)) {
+					// skip audio without making pes.
+					break;
+				}
 				ttLibC_Pes *prev_pes = NULL;
 				if(reader->pes_list != NULL) {
 					prev_pes = (ttLibC_Pes *)ttLibC_StlMap_get(reader->pes_list, (void *)(long)pid);
 				}
+				bool is_skip = false;
+				if(reader->inherit_super.inherit_super.is_key_only) {
+					if((buffer[1] & 0x40) != 0) {
+						is_skip = MpegtsReader_checkSkipPes(reader, buffer, pid);
+					}
+					else {
+						is_skip = MpegtsReader_refPidFlag(reader->skip_pids, pid);
+					}
+				}
 				// check unit start.
 				if((buffer[1] & 0x40) != 0) {
 					// prev data is finished.
 					if(prev_pes != NULL) {
 						if(!prev_pes->is_used) {
-							result = callback(ptr, (ttLibC_Mpegts *)prev_pes);
+							if(MpegtsReader_isKeyTarget(reader, prev_pes, pid)) {
+								result = callback(ptr, (ttLibC_Mpegts *)prev_pes);
+							}
 							prev_pes->is_used = true;
 						}
 					}
@@ -109,6 +205,10 @@ static bool MpegtsReader_read(
 						return true;
 					}
 				}
+				if(is_skip) {
+					// non key pes, skip without making pes.
+					break;
+				}
 				ttLibC_Pes *pes = ttLibC_Pes_getPacket(
 						prev_pes,
 						buffer,
@@ -120,7 +220,9 @@ static bool MpegtsReader_read(
 				}
 				ttLibC_StlMap_put(reader->pes_list, (void *)(long)pid, (void *)pes);
 				if(pes->frame_size != 0 && pes->frame_size == pes->inherit_super.inherit_super.inherit_super.buffer_size) {
-					result = callback(ptr, (ttLibC_Mpegts *)pes);
+					if(MpegtsReader_isKeyTarget(reader, pes, pid)) {
+						result = callback(ptr, (ttLibC_Mpegts *)pes);
+					}
 					pes->is_used = true;
 				}
 				break;
@@ -140,12 +242,18 @@ bool TT_VISIBILITY_DEFAULT ttLibC_MpegtsReader_read(
 		size_t data_size,
 		ttLibC_MpegtsReadFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_read);
 	ttLibC_MpegtsReader_ *reader_ = (ttLibC_MpegtsReader_ *)reader;
 	if(reader_ == NULL) {
 		ERR_PRINT("reader is null");
 		return false;
 	}
-	ttLibC_DynamicBuffer_append(reader_->tmp_buffer, data, data_size);
+	if(reader_->inherit_super.inherit_super.is_non_copy) {
+		ttLibC_DynamicBuffer_appendNonCopy(reader_->tmp_buffer, data, data_size);
+	}
+	else {
+		ttLibC_DynamicBuffer_append(reader_->tmp_buffer, data, data_size);
+	}
 	if(reader_->is_reading) {
 		return true;
 	}
@@ -159,6 +267,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_MpegtsReader_read(
 			break;
 		}
 		if(!MpegtsReader_read(reader_, buffer, left_size, callback, ptr)) {
+			ttLibC_DynamicBuffer_clear(reader_->tmp_buffer);
 			reader_->is_reading = false;
 			return false;
 		}
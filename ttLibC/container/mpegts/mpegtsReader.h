@@ -43,6 +43,10 @@ typedef struct ttLibC_ContainerReader_MpegtsReader_ {
 
 	ttLibC_DynamicBuffer *tmp_buffer;
 	bool is_reading;
+
+	// for key only mode. bit for each pid.
+	uint8_t random_access_pids[1024]; // pid which uses random access indicator.
+	uint8_t skip_pids[1024]; // pid which current pes is skipped.
 } ttLibC_ContainerReader_MpegtsReader_;
 
 typedef ttLibC_ContainerReader_MpegtsReader_ ttLibC_MpegtsReader_;
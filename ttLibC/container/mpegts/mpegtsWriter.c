@@ -22,6 +22,7 @@
 #include "../../ttLibC_predef.h"
 #include "../../_log.h"
 #include "../../allocator.h"
+#include "../../util/statsUtil.h"
 #include "../../util/hexUtil.h"
 
 #include <stdlib.h>
@@ -281,7 +282,7 @@ static bool MpegtsWriter_makeData(ttLibC_MpegtsWriter_ *writer) {
 	uint32_t pid = 0x0100;
 	bool result = true;
 	while(true) {
-		ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)ttLibC_StlMap_get(writer->inherit_super.track_list, (void *)(long)pid);
+		ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriter_refTrack((ttLibC_ContainerWriter_ *)writer, pid);
 		if(track == NULL) {
 			break;
 		}
@@ -352,7 +353,7 @@ static bool MpegtsWriter_writeFromQueue(
 		break;
 	case status_target_check:
 		{
-			ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)ttLibC_StlMap_get(writer->track_list, (void *)(long)0x0100);
+			ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriter_refTrack(writer, 0x0100);
 			ttLibC_FrameQueue_ref(track->frame_queue, ttLibC_ContainerWriter_primaryTrackCheck, writer);
 			if(writer->target_pos != writer->current_pts_pos) {
 				writer->status = status_data_check;
@@ -398,6 +399,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_MpegtsWriter_write(
 		ttLibC_Frame *frame,
 		ttLibC_ContainerWriteFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_write);
 	ttLibC_ContainerWriter_ *writer_ = (ttLibC_ContainerWriter_ *)writer;
 	switch(ttLibC_ContainerWriter_write_(
 			writer_,
@@ -412,9 +414,11 @@ bool TT_VISIBILITY_DEFAULT ttLibC_MpegtsWriter_write(
 	case 1:
 		break;
 	}
-	ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)ttLibC_StlMap_get(writer_->track_list, (void *)(long)frame->id);
-	if(track != NULL) {
-		track->use_mode = track->enable_mode;
+	if(frame != NULL) {
+		ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriter_refTrack(writer_, frame->id);
+		if(track != NULL) {
+			track->use_mode = track->enable_mode;
+		}
 	}
 	return MpegtsWriter_writeFromQueue(writer_);
 }
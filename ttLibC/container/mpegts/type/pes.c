@@ -13,6 +13,7 @@
 #include "../../../ttLibC_predef.h"
 #include "../../../_log.h"
 #include "../../../allocator.h"
+#include "../../../util/audioSyncUtil.h"
 #include "../../../util/byteUtil.h"
 #include "../../../util/ioUtil.h"
 #include "../../../util/hexUtil.h"
@@ -242,46 +243,84 @@ ttLibC_Pes TT_VISIBILITY_HIDDEN *ttLibC_Pes_getPacket(
 	}
 }
 
-bool TT_VISIBILITY_HIDDEN ttLibC_Pes_getFrame(
+/*
+ * get audio frames from pes buffer.
+ * frame boundaries are found by audioSyncUtil in batch, garbage is skipped.
+ * @param pes      target pes
+ * @param type     AudioSyncType_adts or AudioSyncType_mp3
+ * @param callback callback for frame
+ * @param ptr      user def pointer.
+ * @return true:success false:error
+ */
+static bool Pes_getAudioFrame(
 		ttLibC_Pes *pes,
+		ttLibC_AudioSync_Type type,
 		ttLibC_getFrameFunc callback,
 		void *ptr) {
 	uint8_t *buffer = ttLibC_DynamicBuffer_refData(pes->buffer);
 	size_t left_size = ttLibC_DynamicBuffer_refSize(pes->buffer);
-	switch(pes->frame_type) {
-	case frameType_aac:
-		{
-			// data should be adts.
-			uint64_t sample_num_count = 0;
-			uint32_t sample_rate = 0;
-			do {
-				uint64_t pts = pes->inherit_super.inherit_super.inherit_super.pts;
-				if(sample_rate != 0) {
-					pts = pts + (sample_num_count * 90000 / sample_rate);
-				}
-				ttLibC_Aac *aac = ttLibC_Aac_getFrame(
+	uint64_t sample_num_count = 0;
+	uint32_t sample_rate = 0;
+	ttLibC_AudioSync_Unit units[32];
+	while(left_size > 0) {
+		size_t read_size = 0;
+		uint32_t num = ttLibC_AudioSync_scan(type, buffer, left_size, units, 32, &read_size);
+		if(read_size == 0) {
+			ERR_PRINT("failed to get audio frame. left:%zu", left_size);
+			return false;
+		}
+		for(uint32_t i = 0;i < num;++ i) {
+			uint64_t pts = pes->inherit_super.inherit_super.inherit_super.pts;
+			if(sample_rate != 0) {
+				pts = pts + (sample_num_count * 90000 / sample_rate);
+			}
+			ttLibC_Audio *audio = NULL;
+			if(type == AudioSyncType_adts) {
+				audio = (ttLibC_Audio *)ttLibC_Aac_getFrame(
 						(ttLibC_Aac *)pes->frame,
-						buffer,
-						left_size,
+						buffer + units[i].offset,
+						units[i].size,
 						true,
 						pts,
 						pes->inherit_super.inherit_super.inherit_super.timebase);
-				if(aac == NULL) {
-					ERR_PRINT("failed to get aac frame.");
-					return false;
-				}
-				sample_rate = aac->inherit_super.sample_rate;
-				sample_num_count += aac->inherit_super.sample_num;
-				aac->inherit_super.inherit_super.id = pes->inherit_super.inherit_super.pid;
-				pes->frame = (ttLibC_Frame *)aac;
-				if(!callback(ptr, pes->frame)) {
-					return false;
-				}
-				buffer += aac->inherit_super.inherit_super.buffer_size;
-				left_size -= aac->inherit_super.inherit_super.buffer_size;
-			}while(left_size > 0);
+			}
+			else {
+				audio = (ttLibC_Audio *)ttLibC_Mp3_getFrame(
+						(ttLibC_Mp3 *)pes->frame,
+						buffer + units[i].offset,
+						units[i].size,
+						true,
+						pts,
+						pes->inherit_super.inherit_super.inherit_super.timebase);
+			}
+			if(audio == NULL) {
+				ERR_PRINT("failed to get audio frame.");
+				return false;
+			}
+			sample_rate = audio->sample_rate;
+			sample_num_count += audio->sample_num;
+			audio->inherit_super.id = pes->inherit_super.inherit_super.pid;
+			pes->frame = (ttLibC_Frame *)audio;
+			if(!callback(ptr, pes->frame)) {
+				return false;
+			}
 		}
-		return true;
+		buffer += read_size;
+		left_size -= read_size;
+	}
+	return true;
+}
+
+bool TT_VISIBILITY_HIDDEN ttLibC_Pes_getFrame(
+		ttLibC_Pes *pes,
+		ttLibC_getFrameFunc callback,
+		void *ptr) {
+	uint8_t *buffer = ttLibC_DynamicBuffer_refData(pes->buffer);
+	size_t left_size = ttLibC_DynamicBuffer_refSize(pes->buffer);
+	switch(pes->frame_type) {
+	case frameType_aac:
+		// data should be adts.
+		return Pes_getAudioFrame(pes, AudioSyncType_adts, callback, ptr);
 	case frameType_h264:
 		{
 			// data should be h264 nal.
@@ -308,38 +347,7 @@ bool TT_VISIBILITY_HIDDEN ttLibC_Pes_getFrame(
 		}
 		break;
 	case frameType_mp3:
-		{
-			uint64_t sample_num_count = 0;
-			uint32_t sample_rate = 0;
-			do {
-				uint64_t pts = pes->inherit_super.inherit_super.inherit_super.pts;
-				if(sample_rate != 0) {
-					pts = pts + (sample_num_count * 90000 / sample_rate);
-				}
-				ttLibC_Mp3 *mp3 = ttLibC_Mp3_getFrame(
-						(ttLibC_Mp3 *)pes->frame,
-						buffer,
-						left_size,
-						true,
-						pts,
-						pes->inherit_super.inherit_super.inherit_super.timebase);
-				if(mp3 == NULL) {
-					ERR_PRINT("failed to get mp3 frame.");
-					return false;
-				}
-				sample_rate = mp3->inherit_super.sample_rate;
-				sample_num_count += mp3->inherit_super.sample_num;
-				mp3->inherit_super.inherit_super.id = pes->inherit_super.inherit_super.pid;
-				pes->frame = (ttLibC_Frame *)mp3;
-				if(!callback(ptr, pes->frame)) {
-					return false;
-				}
-				buffer += mp3->inherit_super.inherit_super.buffer_size;
-				left_size -= mp3->inherit_super.inherit_super.buffer_size;
-			} while(left_size > 0);
-			return true;
-		}
-		break;
+		return Pes_getAudioFrame(pes, AudioSyncType_mp3, callback, ptr);
 	default:
 		LOG_PRINT("unexpected frame type is found.:%d", pes->frame_type);
 	}
@@ -164,7 +164,7 @@ bool TT_VISIBILITY_HIDDEN ttLibC_Pmt_makePacket(
 	uint32_t i = 0;
 	while(true) {
 		uint32_t pid = 0x0100 + i;
-		ttLibC_ContainerWriter_WriteTrack *track = (ttLibC_ContainerWriter_WriteTrack *)ttLibC_StlMap_get(writer->inherit_super.track_list, (void *)(long)pid);
+		ttLibC_ContainerWriter_WriteTrack *track = ttLibC_ContainerWriter_refTrack((ttLibC_ContainerWriter_ *)writer, pid);
 		if(track == NULL) {
 			break;
 		}
@@ -0,0 +1,250 @@
+/*
+ * @file   segmentIndex.c
+ * @brief  in-memory index of segments, render m3u8 / dash SegmentTimeline from it.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "segmentIndex.h"
+
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * detail definition of segment index.
+ */
+typedef struct ttLibC_Container_SegmentIndex_ {
+	ttLibC_SegmentIndex inherit_super;
+	/** ring of segments, oldest is on segment_pos. */
+	ttLibC_Segment     *segments;
+	uint32_t            segment_pos;
+	/** ring of parts, oldest is on part_pos. */
+	ttLibC_Segment     *parts;
+	uint32_t            part_pos;
+} ttLibC_Container_SegmentIndex_;
+
+typedef ttLibC_Container_SegmentIndex_ ttLibC_SegmentIndex_;
+
+ttLibC_SegmentIndex TT_VISIBILITY_DEFAULT *ttLibC_SegmentIndex_make(
+		uint32_t window_num,
+		uint32_t part_window_num) {
+	if(window_num == 0) {
+		ERR_PRINT("window_num should be more than 0.");
+		return NULL;
+	}
+	ttLibC_SegmentIndex_ *index = ttLibC_malloc(sizeof(ttLibC_SegmentIndex_));
+	if(index == NULL) {
+		ERR_PRINT("failed to allocate memory for segment index.");
+		return NULL;
+	}
+	memset(index, 0, sizeof(ttLibC_SegmentIndex_));
+	index->segments = ttLibC_malloc(sizeof(ttLibC_Segment) * window_num);
+	if(index->segments == NULL) {
+		ERR_PRINT("failed to allocate memory for segments.");
+		ttLibC_SegmentIndex_close((ttLibC_SegmentIndex **)&index);
+		return NULL;
+	}
+	if(part_window_num != 0) {
+		index->parts = ttLibC_malloc(sizeof(ttLibC_Segment) * part_window_num);
+		if(index->parts == NULL) {
+			ERR_PRINT("failed to allocate memory for parts.");
+			ttLibC_SegmentIndex_close((ttLibC_SegmentIndex **)&index);
+			return NULL;
+		}
+	}
+	index->inherit_super.window_num      = window_num;
+	index->inherit_super.part_window_num = part_window_num;
+	return (ttLibC_SegmentIndex *)index;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_SegmentIndex_append(
+		ttLibC_SegmentIndex *index,
+		ttLibC_Segment *segment) {
+	ttLibC_SegmentIndex_ *index_ = (ttLibC_SegmentIndex_ *)index;
+	if(index_ == NULL || segment == NULL) {
+		return false;
+	}
+	if(index_->inherit_super.timebase == 0) {
+		index_->inherit_super.timebase = segment->timebase;
+	}
+	if(segment->is_part) {
+		if(index_->inherit_super.part_window_num == 0) {
+			return true;
+		}
+		uint32_t pos = (index_->part_pos + index_->inherit_super.part_num) % index_->inherit_super.part_window_num;
+		if(index_->inherit_super.part_num == index_->inherit_super.part_window_num) {
+			index_->part_pos = (index_->part_pos + 1) % index_->inherit_super.part_window_num;
+		}
+		else {
+			++ index_->inherit_super.part_num;
+		}
+		index_->parts[pos] = *segment;
+		if(index_->inherit_super.max_part_duration < segment->duration) {
+			index_->inherit_super.max_part_duration = segment->duration;
+		}
+		return true;
+	}
+	uint32_t pos = (index_->segment_pos + index_->inherit_super.segment_num) % index_->inherit_super.window_num;
+	if(index_->inherit_super.segment_num == index_->inherit_super.window_num) {
+		index_->segment_pos = (index_->segment_pos + 1) % index_->inherit_super.window_num;
+	}
+	else {
+		++ index_->inherit_super.segment_num;
+	}
+	index_->segments[pos] = *segment;
+	index_->inherit_super.first_index = index_->segments[index_->segment_pos].index;
+	if(index_->inherit_super.max_duration < segment->duration) {
+		index_->inherit_super.max_duration = segment->duration;
+	}
+	// parts of dropped segment is not needed.
+	while(index_->inherit_super.part_num != 0
+	&& index_->parts[index_->part_pos].index < index_->inherit_super.first_index) {
+		index_->part_pos = (index_->part_pos + 1) % index_->inherit_super.part_window_num;
+		-- index_->inherit_super.part_num;
+	}
+	return true;
+}
+
+/*
+ * append formatted text to buffer.
+ */
+static bool SegmentIndex_print(
+		ttLibC_DynamicBuffer *buffer,
+		const char *format,
+		...) {
+	char line[1024];
+	va_list args;
+	va_start(args, format);
+	int size = vsnprintf(line, sizeof(line), format, args);
+	va_end(args);
+	if(size < 0 || (size_t)size >= sizeof(line)) {
+		ERR_PRINT("line is too long.");
+		return false;
+	}
+	return ttLibC_DynamicBuffer_append(buffer, (uint8_t *)line, size);
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_SegmentIndex_renderM3u8(
+		ttLibC_SegmentIndex *index,
+		const char *uri,
+		bool is_end,
+		ttLibC_DynamicBuffer *buffer) {
+	ttLibC_SegmentIndex_ *index_ = (ttLibC_SegmentIndex_ *)index;
+	if(index_ == NULL || uri == NULL || buffer == NULL) {
+		return false;
+	}
+	uint32_t timebase = index_->inherit_super.timebase;
+	if(timebase == 0) {
+		ERR_PRINT("no segment yet.");
+		return false;
+	}
+	uint64_t target_duration = (index_->inherit_super.max_duration + timebase - 1) / timebase;
+	double part_target = 1.0 * index_->inherit_super.max_part_duration / timebase;
+	bool result = SegmentIndex_print(buffer, "#EXTM3U\n#EXT-X-VERSION:6\n#EXT-X-TARGETDURATION:%llu\n",
+			(unsigned long long)target_duration);
+	if(index_->inherit_super.part_num != 0) {
+		result = result && SegmentIndex_print(buffer, "#EXT-X-SERVER-CONTROL:PART-HOLD-BACK=%.3f\n#EXT-X-PART-INF:PART-TARGET=%.3f\n",
+				part_target * 3, part_target);
+	}
+	result = result && SegmentIndex_print(buffer, "#EXT-X-MEDIA-SEQUENCE:%llu\n",
+			(unsigned long long)index_->inherit_super.first_index);
+	if(index_->inherit_super.init_size != 0) {
+		result = result && SegmentIndex_print(buffer, "#EXT-X-MAP:URI=\"%s\",BYTERANGE=\"%llu@0\"\n",
+				uri, (unsigned long long)index_->inherit_super.init_size);
+	}
+	uint32_t part_index = 0;
+	for(uint32_t i = 0;result && i <= index_->inherit_super.segment_num;++ i) {
+		ttLibC_Segment *segment = NULL;
+		if(i < index_->inherit_super.segment_num) {
+			segment = &index_->segments[(index_->segment_pos + i) % index_->inherit_super.window_num];
+		}
+		// parts of segment, or parts after the last segment.
+		bool is_listed = false;
+		while(result && part_index < index_->inherit_super.part_num) {
+			ttLibC_Segment *part = &index_->parts[(index_->part_pos + part_index) % index_->inherit_super.part_window_num];
+			if(segment != NULL && part->index > segment->index) {
+				break;
+			}
+			++ part_index;
+			// segment should have all parts, or no part.
+			if(!is_listed && part->part_index != 0) {
+				continue;
+			}
+			is_listed = true;
+			result = SegmentIndex_print(buffer, "#EXT-X-PART:DURATION=%.3f,URI=\"%s\",BYTERANGE=\"%llu@%llu\"%s\n",
+					1.0 * part->duration / timebase,
+					uri,
+					(unsigned long long)part->size,
+					(unsigned long long)part->offset,
+					part->is_independent ? ",INDEPENDENT=YES" : "");
+		}
+		if(segment != NULL) {
+			result = result && SegmentIndex_print(buffer, "#EXTINF:%.3f,\n#EXT-X-BYTERANGE:%llu@%llu\n%s\n",
+					1.0 * segment->duration / timebase,
+					(unsigned long long)segment->size,
+					(unsigned long long)segment->offset,
+					uri);
+		}
+	}
+	if(is_end) {
+		result = result && SegmentIndex_print(buffer, "#EXT-X-ENDLIST\n");
+	}
+	return result;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_SegmentIndex_renderSegmentTimeline(
+		ttLibC_SegmentIndex *index,
+		ttLibC_DynamicBuffer *buffer) {
+	ttLibC_SegmentIndex_ *index_ = (ttLibC_SegmentIndex_ *)index;
+	if(index_ == NULL || buffer == NULL) {
+		return false;
+	}
+	bool result = SegmentIndex_print(buffer, "<SegmentTimeline>\n");
+	// continuous segments with same duration are put in one S element.
+	ttLibC_Segment *start = NULL;
+	uint32_t repeat = 0;
+	for(uint32_t i = 0;result && i <= index_->inherit_super.segment_num;++ i) {
+		ttLibC_Segment *segment = NULL;
+		if(i < index_->inherit_super.segment_num) {
+			segment = &index_->segments[(index_->segment_pos + i) % index_->inherit_super.window_num];
+			if(start != NULL
+			&& segment->duration == start->duration
+			&& segment->pts == start->pts + start->duration * (repeat + 1)) {
+				++ repeat;
+				continue;
+			}
+		}
+		if(start != NULL) {
+			if(repeat != 0) {
+				result = SegmentIndex_print(buffer, "<S t=\"%llu\" d=\"%llu\" r=\"%u\"/>\n",
+						(unsigned long long)start->pts, (unsigned long long)start->duration, repeat);
+			}
+			else {
+				result = SegmentIndex_print(buffer, "<S t=\"%llu\" d=\"%llu\"/>\n",
+						(unsigned long long)start->pts, (unsigned long long)start->duration);
+			}
+		}
+		start = segment;
+		repeat = 0;
+	}
+	return result && SegmentIndex_print(buffer, "</SegmentTimeline>\n");
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_SegmentIndex_close(ttLibC_SegmentIndex **index) {
+	ttLibC_SegmentIndex_ *target = (ttLibC_SegmentIndex_ *)*index;
+	if(target == NULL) {
+		return;
+	}
+	ttLibC_free(target->segments);
+	ttLibC_free(target->parts);
+	ttLibC_free(target);
+	*index = NULL;
+}
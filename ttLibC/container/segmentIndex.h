@@ -0,0 +1,112 @@
+/**
+ * @file   segmentIndex.h
+ * @brief  in-memory index of segments, render m3u8 / dash SegmentTimeline from it.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * index holds the last window_num segments and part_window_num parts. (rolling window for live)
+ * render only walks the held window, history is not kept.
+ *
+ * usage:
+ *   ttLibC_SegmentIndex *index = ttLibC_SegmentIndex_make(6, 32);
+ *   ttLibC_Segmenter_setIndex(segmenter, output_index, index);
+ *   // on segment callback.
+ *   ttLibC_DynamicBuffer_empty(buffer);
+ *   ttLibC_SegmentIndex_renderM3u8(index, "live.ts", false, buffer);
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_CONTAINER_SEGMENTINDEX_H_
+#define TTLIBC_CONTAINER_SEGMENTINDEX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "segmenter.h"
+#include "../util/dynamicBufferUtil.h"
+
+/**
+ * definition of segment index.
+ */
+typedef struct ttLibC_Container_SegmentIndex {
+	/** max number of segments to hold. */
+	uint32_t window_num;
+	/** max number of parts to hold. */
+	uint32_t part_window_num;
+	/** number of holding segments. */
+	uint32_t segment_num;
+	/** number of holding parts. */
+	uint32_t part_num;
+	/** index of the oldest holding segment. (EXT-X-MEDIA-SEQUENCE / startNumber) */
+	uint64_t first_index;
+	/** timebase of pts and duration, 0 before first append. */
+	uint32_t timebase;
+	/** byte size of initialize data. (EXT-X-MAP) */
+	uint64_t init_size;
+	/** max duration of segments so far. */
+	uint64_t max_duration;
+	/** max duration of parts so far. */
+	uint64_t max_part_duration;
+} ttLibC_Container_SegmentIndex;
+
+typedef ttLibC_Container_SegmentIndex ttLibC_SegmentIndex;
+
+/**
+ * make segment index.
+ * @param window_num      max number of segments to hold.
+ * @param part_window_num max number of parts to hold. 0 for no parts.
+ * @return index object.
+ */
+ttLibC_SegmentIndex *ttLibC_SegmentIndex_make(
+		uint32_t window_num,
+		uint32_t part_window_num);
+
+/**
+ * append segment or part, drop the oldest one if window is full.
+ * @param index   index object.
+ * @param segment segment data. is_part for part.
+ * @return true:success false:error
+ */
+bool ttLibC_SegmentIndex_append(
+		ttLibC_SegmentIndex *index,
+		ttLibC_Segment *segment);
+
+/**
+ * render media playlist, all segments and parts refer byte range of one uri.
+ * @param index  index object.
+ * @param uri    uri of output.
+ * @param is_end true:add EXT-X-ENDLIST
+ * @param buffer rendered text is appended.
+ * @return true:success false:error
+ */
+bool ttLibC_SegmentIndex_renderM3u8(
+		ttLibC_SegmentIndex *index,
+		const char *uri,
+		bool is_end,
+		ttLibC_DynamicBuffer *buffer);
+
+/**
+ * render SegmentTimeline element for dash.
+ * use timebase for timescale, first_index for startNumber.
+ * @param index  index object.
+ * @param buffer rendered text is appended.
+ * @return true:success false:error
+ */
+bool ttLibC_SegmentIndex_renderSegmentTimeline(
+		ttLibC_SegmentIndex *index,
+		ttLibC_DynamicBuffer *buffer);
+
+/**
+ * close segment index.
+ * @param index
+ */
+void ttLibC_SegmentIndex_close(ttLibC_SegmentIndex **index);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_CONTAINER_SEGMENTINDEX_H_ */
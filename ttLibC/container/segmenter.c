@@ -0,0 +1,594 @@
+/*
+ * @file   segmenter.c
+ * @brief  drive many container writers with one split decision.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "segmenter.h"
+#include "segmentIndex.h"
+#include "containerCommon.h"
+#include "mkv.h"
+#include "mp4.h"
+#include "mpegts.h"
+
+#include "../frame/audio/audio.h"
+#include "../frame/video/video.h"
+#include "../frame/video/h264.h"
+
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+
+#include <string.h>
+
+/*
+ * number of boundaries to hold.
+ * writer outputs chunk soon after next boundary is decided, so small ring is enough.
+ */
+#define Segmenter_boundaryNum 64
+
+struct ttLibC_Container_Segmenter_;
+
+/*
+ * start of chunk, segment or part.
+ */
+typedef struct {
+	uint64_t pts;
+	uint64_t segment_index;
+	uint32_t part_index;
+	bool     is_independent;
+} Segmenter_Boundary;
+
+/*
+ * output of segmenter.
+ */
+typedef struct {
+	ttLibC_ContainerWriter_            *writer;
+	ttLibC_ContainerWriteFunc           callback;
+	void                               *ptr;
+	uint32_t                            index;
+	struct ttLibC_Container_Segmenter_ *segmenter;
+	/** segmenter timebase -> writer timebase */
+	ttLibC_ContainerWriter_Rescaler     rescaler;
+	ttLibC_SegmentIndex                *segment_index;
+	/** written bytes. */
+	uint64_t                            position;
+	uint64_t                            init_size;
+	/** number of done chunks. */
+	uint64_t                            chunk_count;
+	/** true while the chunk is written. */
+	bool                                is_open;
+	/** current_pts_pos of writer for open chunk. */
+	uint64_t                            open_pos;
+	/** open chunk. */
+	ttLibC_Segment                      chunk;
+	/** segment of open chunk, chunks are added. */
+	ttLibC_Segment                      segment;
+} Segmenter_Output;
+
+/*
+ * detail definition of segmenter.
+ */
+typedef struct ttLibC_Container_Segmenter_ {
+	ttLibC_Segmenter     inherit_super;
+	ttLibC_Frame_Type   *types;
+	uint32_t             types_num;
+	Segmenter_Output     outputs[ttLibC_Segmenter_maxOutputNum];
+	/** start of chunk, chunk n is on n % Segmenter_boundaryNum. */
+	Segmenter_Boundary   boundaries[Segmenter_boundaryNum];
+	uint64_t             boundary_num;
+	/** start pts of last segment. */
+	uint64_t             segment_pts;
+	/** end of written frames, for the last segment on flush. */
+	uint64_t             end_pts;
+	/** last pts and frame interval of primary track. */
+	uint64_t             last_pts;
+	uint64_t             frame_interval;
+	bool                 is_first;
+	bool                 is_flushed;
+	ttLibC_SegmenterFunc callback;
+	void                *ptr;
+	bool                 is_error;
+} ttLibC_Container_Segmenter_;
+
+typedef ttLibC_Container_Segmenter_ ttLibC_Segmenter_;
+
+ttLibC_Segmenter TT_VISIBILITY_DEFAULT *ttLibC_Segmenter_make(
+		ttLibC_Frame_Type *target_frame_types,
+		uint32_t types_num,
+		uint32_t target_duration) {
+	if(target_frame_types == NULL || types_num == 0) {
+		ERR_PRINT("frame types are required.");
+		return NULL;
+	}
+	ttLibC_Segmenter_ *segmenter = ttLibC_malloc(sizeof(ttLibC_Segmenter_));
+	if(segmenter == NULL) {
+		ERR_PRINT("failed to allocate memory for segmenter.");
+		return NULL;
+	}
+	memset(segmenter, 0, sizeof(ttLibC_Segmenter_));
+	segmenter->types = ttLibC_malloc(sizeof(ttLibC_Frame_Type) * types_num);
+	if(segmenter->types == NULL) {
+		ERR_PRINT("failed to allocate memory for types.");
+		ttLibC_free(segmenter);
+		return NULL;
+	}
+	memcpy(segmenter->types, target_frame_types, sizeof(ttLibC_Frame_Type) * types_num);
+	segmenter->types_num = types_num;
+	segmenter->is_first  = true;
+	segmenter->is_error  = false;
+	segmenter->is_flushed = false;
+	segmenter->inherit_super.output_num      = 0;
+	segmenter->inherit_super.target_duration = target_duration;
+	segmenter->inherit_super.part_duration   = 0;
+	segmenter->inherit_super.segment_num     = 0;
+	segmenter->inherit_super.timebase        = 0;
+	return (ttLibC_Segmenter *)segmenter;
+}
+
+/*
+ * split check from writer, split on the next boundary after the chunk on writer.
+ */
+static bool Segmenter_splitCheck(void *ptr, ttLibC_Frame *frame) {
+	Segmenter_Output *output = (Segmenter_Output *)ptr;
+	ttLibC_Segmenter_ *segmenter = output->segmenter;
+	for(uint64_t i = output->chunk_count + 1;i < segmenter->boundary_num;++ i) {
+		uint64_t pos = ttLibC_ContainerWriter_Rescaler_rescale(
+				&output->rescaler,
+				segmenter->boundaries[i % Segmenter_boundaryNum].pts);
+		if(pos > output->writer->current_pts_pos) {
+			return frame->pts >= pos;
+		}
+	}
+	return false;
+}
+
+int32_t TT_VISIBILITY_DEFAULT ttLibC_Segmenter_addOutput(
+		ttLibC_Segmenter *segmenter,
+		ttLibC_Container_Type container_type,
+		ttLibC_ContainerWriteFunc callback,
+		void *ptr) {
+	ttLibC_Segmenter_ *segmenter_ = (ttLibC_Segmenter_ *)segmenter;
+	if(segmenter_ == NULL) {
+		return -1;
+	}
+	if(!segmenter_->is_first) {
+		ERR_PRINT("output should be added before first frame of primary track.");
+		return -1;
+	}
+	if(segmenter_->inherit_super.output_num >= ttLibC_Segmenter_maxOutputNum) {
+		ERR_PRINT("too many outputs.");
+		return -1;
+	}
+	ttLibC_ContainerWriter *writer = NULL;
+	switch(container_type) {
+	case containerType_mkv:
+		writer = (ttLibC_ContainerWriter *)ttLibC_MkvWriter_make(segmenter_->types, segmenter_->types_num);
+		break;
+	case containerType_mp4:
+		writer = (ttLibC_ContainerWriter *)ttLibC_Mp4Writer_make(segmenter_->types, segmenter_->types_num);
+		break;
+	case containerType_mpegts:
+		writer = (ttLibC_ContainerWriter *)ttLibC_MpegtsWriter_make(segmenter_->types, segmenter_->types_num);
+		break;
+	default:
+		ERR_PRINT("container type:%d is not supported for segmenter.", container_type);
+		return -1;
+	}
+	if(writer == NULL) {
+		ERR_PRINT("failed to make writer.");
+		return -1;
+	}
+	uint32_t index = segmenter_->inherit_super.output_num;
+	Segmenter_Output *output = &segmenter_->outputs[index];
+	memset(output, 0, sizeof(Segmenter_Output));
+	output->writer    = (ttLibC_ContainerWriter_ *)writer;
+	output->callback  = callback;
+	output->ptr       = ptr;
+	output->index     = index;
+	output->segmenter = segmenter_;
+	output->writer->split_func = Segmenter_splitCheck;
+	output->writer->split_ptr  = output;
+	++ segmenter_->inherit_super.output_num;
+	return (int32_t)index;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_Segmenter_setPartDuration(
+		ttLibC_Segmenter *segmenter,
+		uint32_t part_duration) {
+	ttLibC_Segmenter_ *segmenter_ = (ttLibC_Segmenter_ *)segmenter;
+	if(segmenter_ == NULL) {
+		return false;
+	}
+	if(!segmenter_->is_first) {
+		ERR_PRINT("part duration should be set before first frame of primary track.");
+		return false;
+	}
+	segmenter_->inherit_super.part_duration = part_duration;
+	return true;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_Segmenter_setIndex(
+		ttLibC_Segmenter *segmenter,
+		uint32_t output_index,
+		ttLibC_SegmentIndex *index) {
+	ttLibC_Segmenter_ *segmenter_ = (ttLibC_Segmenter_ *)segmenter;
+	if(segmenter_ == NULL || output_index >= segmenter_->inherit_super.output_num) {
+		return false;
+	}
+	segmenter_->outputs[output_index].segment_index = index;
+	return true;
+}
+
+ttLibC_ContainerWriter TT_VISIBILITY_DEFAULT *ttLibC_Segmenter_refWriter(
+		ttLibC_Segmenter *segmenter,
+		uint32_t output_index) {
+	ttLibC_Segmenter_ *segmenter_ = (ttLibC_Segmenter_ *)segmenter;
+	if(segmenter_ == NULL || output_index >= segmenter_->inherit_super.output_num) {
+		return NULL;
+	}
+	return (ttLibC_ContainerWriter *)segmenter_->outputs[output_index].writer;
+}
+
+uint64_t TT_VISIBILITY_DEFAULT ttLibC_Segmenter_refInitSize(
+		ttLibC_Segmenter *segmenter,
+		uint32_t output_index) {
+	ttLibC_Segmenter_ *segmenter_ = (ttLibC_Segmenter_ *)segmenter;
+	if(segmenter_ == NULL || output_index >= segmenter_->inherit_super.output_num) {
+		return 0;
+	}
+	return segmenter_->outputs[output_index].init_size;
+}
+
+/*
+ * report segment or part, on index and callback.
+ */
+static bool Segmenter_report(
+		Segmenter_Output *output,
+		ttLibC_Segment *segment) {
+	ttLibC_Segmenter_ *segmenter = output->segmenter;
+	if(output->segment_index != NULL) {
+		output->segment_index->init_size = output->init_size;
+		ttLibC_SegmentIndex_append(output->segment_index, segment);
+	}
+	if(segmenter->callback != NULL) {
+		if(!segmenter->callback(segmenter->ptr, (ttLibC_Segmenter *)segmenter, output->index, segment)) {
+			segmenter->is_error = true;
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ * chunk of writer is done, report the part and the segment if it is the last part.
+ */
+static bool Segmenter_closeChunk(Segmenter_Output *output) {
+	ttLibC_Segmenter_ *segmenter = output->segmenter;
+	output->is_open = false;
+	++ output->chunk_count;
+	if(output->chunk.is_part) {
+		if(!Segmenter_report(output, &output->chunk)) {
+			return false;
+		}
+	}
+	Segmenter_Boundary *next = &segmenter->boundaries[output->chunk_count % Segmenter_boundaryNum];
+	if(next->part_index != 0) {
+		return true;
+	}
+	output->segment.duration = next->pts - output->segment.pts;
+	return Segmenter_report(output, &output->segment);
+}
+
+/*
+ * writer starts data of chunk.
+ */
+static bool Segmenter_openChunk(Segmenter_Output *output) {
+	ttLibC_Segmenter_ *segmenter = output->segmenter;
+	uint64_t num = output->chunk_count;
+	if(num + 1 >= segmenter->boundary_num) {
+		ERR_PRINT("chunk without boundary, unexpected.");
+		return false;
+	}
+	Segmenter_Boundary *boundary = &segmenter->boundaries[num % Segmenter_boundaryNum];
+	Segmenter_Boundary *next     = &segmenter->boundaries[(num + 1) % Segmenter_boundaryNum];
+	output->chunk.index          = boundary->segment_index;
+	output->chunk.pts            = boundary->pts;
+	output->chunk.duration       = next->pts - boundary->pts;
+	output->chunk.timebase       = segmenter->inherit_super.timebase;
+	output->chunk.offset         = output->position;
+	output->chunk.size           = 0;
+	output->chunk.is_part        = segmenter->inherit_super.part_duration != 0;
+	output->chunk.part_index     = boundary->part_index;
+	output->chunk.is_independent = boundary->is_independent;
+	if(boundary->part_index == 0) {
+		output->segment = output->chunk;
+		output->segment.is_part = false;
+	}
+	output->is_open  = true;
+	output->open_pos = output->writer->current_pts_pos;
+	return true;
+}
+
+static bool Segmenter_writeCallback(void *ptr, void *data, size_t data_size) {
+	Segmenter_Output *output = (Segmenter_Output *)ptr;
+	if(output->writer->status == status_make_data) {
+		if(output->is_open && output->open_pos != output->writer->current_pts_pos) {
+			if(!Segmenter_closeChunk(output)) {
+				return false;
+			}
+		}
+		if(!output->is_open) {
+			if(!Segmenter_openChunk(output)) {
+				return false;
+			}
+		}
+	}
+	if(output->is_open) {
+		output->chunk.size   += data_size;
+		output->segment.size += data_size;
+	}
+	else if(output->chunk_count == 0) {
+		output->init_size += data_size;
+	}
+	output->position += data_size;
+	if(output->callback != NULL) {
+		return output->callback(output->ptr, data, data_size);
+	}
+	return true;
+}
+
+/*
+ * decide boundary with frame on primary track.
+ * @return true:success false:some output is too late.
+ */
+static bool Segmenter_checkBoundary(
+		ttLibC_Segmenter_ *segmenter,
+		ttLibC_Frame *frame) {
+	bool is_key = true;
+	if(ttLibC_Frame_isVideo(frame)) {
+		ttLibC_Video *video = (ttLibC_Video *)frame;
+		switch(video->type) {
+		case videoType_key:
+			break;
+		case videoType_inner:
+			// part can start with p frame. (b frame is not in pts order)
+			if(segmenter->inherit_super.part_duration == 0) {
+				return true;
+			}
+			if(frame->type == frameType_h264
+			&& ((ttLibC_H264 *)frame)->frame_type == H264FrameType_B) {
+				return true;
+			}
+			is_key = false;
+			break;
+		default:
+			return true;
+		}
+	}
+	uint64_t num = segmenter->boundary_num;
+	Segmenter_Boundary *boundary = &segmenter->boundaries[num % Segmenter_boundaryNum];
+	if(num == 0) {
+		if(!is_key) {
+			return true;
+		}
+		boundary->segment_index = 0;
+		boundary->part_index    = 0;
+	}
+	else {
+		Segmenter_Boundary *last = &segmenter->boundaries[(num - 1) % Segmenter_boundaryNum];
+		uint64_t target = (uint64_t)segmenter->inherit_super.target_duration * frame->timebase / 1000;
+		uint64_t part_target = (uint64_t)segmenter->inherit_super.part_duration * frame->timebase / 1000;
+		bool is_segment = is_key && frame->pts >= segmenter->segment_pts + target;
+		bool is_part = part_target != 0 && frame->pts >= last->pts + part_target;
+		if(!is_segment && !is_part) {
+			return true;
+		}
+		for(uint32_t i = 0;i < segmenter->inherit_super.output_num;++ i) {
+			if(num - segmenter->outputs[i].chunk_count >= Segmenter_boundaryNum - 1) {
+				ERR_PRINT("output:%d is too late to hold boundary.", i);
+				return false;
+			}
+		}
+		if(is_segment) {
+			boundary->segment_index = last->segment_index + 1;
+			boundary->part_index    = 0;
+		}
+		else {
+			boundary->segment_index = last->segment_index;
+			boundary->part_index    = last->part_index + 1;
+		}
+	}
+	boundary->pts            = frame->pts;
+	boundary->is_independent = is_key;
+	if(boundary->part_index == 0) {
+		segmenter->segment_pts = frame->pts;
+		++ segmenter->inherit_super.segment_num;
+	}
+	++ segmenter->boundary_num;
+	return true;
+}
+
+/*
+ * hold the end of written frames.
+ * audio has duration, video uses frame interval of primary track.
+ */
+static void Segmenter_updateEnd(
+		ttLibC_Segmenter_ *segmenter,
+		ttLibC_Frame *frame) {
+	uint64_t end = frame->pts + 1;
+	if(ttLibC_Frame_isAudio(frame)) {
+		ttLibC_Audio *audio = (ttLibC_Audio *)frame;
+		if(audio->sample_rate != 0) {
+			end = frame->pts + (uint64_t)audio->sample_num * frame->timebase / audio->sample_rate;
+		}
+	}
+	else if(ttLibC_Frame_isVideo(frame)) {
+		if(((ttLibC_Video *)frame)->type == videoType_info) {
+			return;
+		}
+		if(frame->id == 1) {
+			if(frame->pts > segmenter->last_pts) {
+				if(segmenter->end_pts != 0) {
+					segmenter->frame_interval = frame->pts - segmenter->last_pts;
+				}
+				segmenter->last_pts = frame->pts;
+			}
+			end = segmenter->last_pts + segmenter->frame_interval;
+		}
+	}
+	// ceil to segmenter timebase.
+	end = (end * segmenter->inherit_super.timebase + frame->timebase - 1) / frame->timebase;
+	if(end > segmenter->end_pts) {
+		segmenter->end_pts = end;
+	}
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_Segmenter_write(
+		ttLibC_Segmenter *segmenter,
+		ttLibC_Frame *frame,
+		ttLibC_SegmenterFunc callback,
+		void *ptr) {
+	ttLibC_Segmenter_ *segmenter_ = (ttLibC_Segmenter_ *)segmenter;
+	if(segmenter_ == NULL) {
+		return false;
+	}
+	if(frame == NULL) {
+		return true;
+	}
+	if(segmenter_->is_error) {
+		return false;
+	}
+	if(segmenter_->is_flushed) {
+		ERR_PRINT("segmenter is already flushed.");
+		return false;
+	}
+	if(frame->id == 0 || frame->id > segmenter_->types_num) {
+		ERR_PRINT("frame id:%d is out of types.", frame->id);
+		return false;
+	}
+	if(frame->id == 1) {
+		// boundaries are on timebase of primary track.
+		if(segmenter_->is_first) {
+			segmenter_->inherit_super.timebase = frame->timebase;
+			for(uint32_t i = 0;i < segmenter_->inherit_super.output_num;++ i) {
+				Segmenter_Output *output = &segmenter_->outputs[i];
+				ttLibC_ContainerWriter_Rescaler_setup(
+						&output->rescaler,
+						output->writer->inherit_super.timebase,
+						frame->timebase);
+			}
+			segmenter_->is_first = false;
+		}
+		if(frame->timebase != segmenter_->inherit_super.timebase) {
+			ERR_PRINT("timebase of primary track should not be changed.");
+			return false;
+		}
+		if(!Segmenter_checkBoundary(segmenter_, frame)) {
+			segmenter_->is_error = true;
+			return false;
+		}
+	}
+	if(!segmenter_->is_first) {
+		Segmenter_updateEnd(segmenter_, frame);
+	}
+	segmenter_->callback = callback;
+	segmenter_->ptr      = ptr;
+	uint32_t id = frame->id;
+	bool result = true;
+	for(uint32_t i = 0;i < segmenter_->inherit_super.output_num;++ i) {
+		Segmenter_Output *output = &segmenter_->outputs[i];
+		// each writer has own track id base.
+		frame->id = id - 1 + output->writer->track_base_id;
+		result = ttLibC_ContainerWriter_write(
+				(ttLibC_ContainerWriter *)output->writer,
+				frame,
+				Segmenter_writeCallback,
+				output);
+		if(result && output->is_open && output->open_pos != output->writer->current_pts_pos) {
+			result = Segmenter_closeChunk(output);
+		}
+		if(!result) {
+			segmenter_->is_error = true;
+			break;
+		}
+	}
+	frame->id = id;
+	segmenter_->callback = NULL;
+	segmenter_->ptr      = NULL;
+	return result;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_Segmenter_flush(
+		ttLibC_Segmenter *segmenter,
+		ttLibC_SegmenterFunc callback,
+		void *ptr) {
+	ttLibC_Segmenter_ *segmenter_ = (ttLibC_Segmenter_ *)segmenter;
+	if(segmenter_ == NULL) {
+		return false;
+	}
+	if(segmenter_->is_error) {
+		return false;
+	}
+	if(segmenter_->is_flushed) {
+		return true;
+	}
+	segmenter_->is_flushed = true;
+	uint64_t num = segmenter_->boundary_num;
+	if(num == 0) {
+		return true;
+	}
+	for(uint32_t i = 0;i < segmenter_->inherit_super.output_num;++ i) {
+		if(num - segmenter_->outputs[i].chunk_count >= Segmenter_boundaryNum - 1) {
+			ERR_PRINT("output:%d is too late to hold boundary.", i);
+			segmenter_->is_error = true;
+			return false;
+		}
+	}
+	// boundary for the end of last segment, no segment starts here.
+	Segmenter_Boundary *last = &segmenter_->boundaries[(num - 1) % Segmenter_boundaryNum];
+	Segmenter_Boundary *boundary = &segmenter_->boundaries[num % Segmenter_boundaryNum];
+	boundary->pts            = segmenter_->end_pts > last->pts ? segmenter_->end_pts : last->pts + 1;
+	boundary->segment_index  = last->segment_index + 1;
+	boundary->part_index     = 0;
+	boundary->is_independent = true;
+	++ segmenter_->boundary_num;
+	segmenter_->callback = callback;
+	segmenter_->ptr      = ptr;
+	bool result = true;
+	for(uint32_t i = 0;i < segmenter_->inherit_super.output_num;++ i) {
+		Segmenter_Output *output = &segmenter_->outputs[i];
+		result = ttLibC_ContainerWriter_flush_(
+				output->writer,
+				ttLibC_ContainerWriter_Rescaler_rescale(&output->rescaler, boundary->pts),
+				Segmenter_writeCallback,
+				output);
+		if(result && output->is_open) {
+			result = Segmenter_closeChunk(output);
+		}
+		if(!result) {
+			segmenter_->is_error = true;
+			break;
+		}
+	}
+	segmenter_->callback = NULL;
+	segmenter_->ptr      = NULL;
+	return result;
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_Segmenter_close(ttLibC_Segmenter **segmenter) {
+	ttLibC_Segmenter_ *target = (ttLibC_Segmenter_ *)*segmenter;
+	if(target == NULL) {
+		return;
+	}
+	for(uint32_t i = 0;i < target->inherit_super.output_num;++ i) {
+		ttLibC_ContainerWriter_close((ttLibC_ContainerWriter **)&target->outputs[i].writer);
+	}
+	ttLibC_free(target->types);
+	ttLibC_free(target);
+	*segmenter = NULL;
+}
@@ -0,0 +1,206 @@
+/**
+ * @file   segmenter.h
+ * @brief  drive many container writers with one split decision. (hls ts / cmaf fmp4 from one ingest)
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * segmenter decides segment boundary on primary track(1st of types),
+ * then all writers split at the same frame.
+ * video: key frame after target_duration, audio only: frame after target_duration.
+ * writer outputs one chunk(ts pes / moof+mdat / cluster) for one segment, or for one part with part_duration.
+ *
+ * usage:
+ *   ttLibC_Frame_Type types[] = {frameType_h264, frameType_aac};
+ *   ttLibC_Segmenter *segmenter = ttLibC_Segmenter_make(types, 2, 4000);
+ *   ttLibC_Segmenter_addOutput(segmenter, containerType_mpegts, tsWriteCallback, tsFile);
+ *   ttLibC_Segmenter_addOutput(segmenter, containerType_mp4,    mp4WriteCallback, mp4File);
+ *   // frame->id is 1 for h264, 2 for aac.
+ *   ttLibC_Segmenter_write(segmenter, frame, segmentCallback, playlist);
+ *   // end of stream, write and report the last segment.
+ *   ttLibC_Segmenter_flush(segmenter, segmentCallback, playlist);
+ *   ttLibC_Segmenter_close(&segmenter);
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_CONTAINER_SEGMENTER_H_
+#define TTLIBC_CONTAINER_SEGMENTER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "container.h"
+
+/**
+ * max number of outputs for one segmenter.
+ */
+#define ttLibC_Segmenter_maxOutputNum 8
+
+/**
+ * data for one segment of one output.
+ */
+typedef struct ttLibC_Container_Segmenter_Segment {
+	/** sequence number from 0. */
+	uint64_t index;
+	/** start pts of segment. */
+	uint64_t pts;
+	/** duration of segment. */
+	uint64_t duration;
+	/** timebase for pts and duration. (timebase of input frame) */
+	uint32_t timebase;
+	/** byte offset on output. */
+	uint64_t offset;
+	/** byte size on output. */
+	uint64_t size;
+	/** true:part of segment (ll-hls) false:whole segment */
+	bool is_part;
+	/** part number in segment, 0 for whole segment. */
+	uint32_t part_index;
+	/** true:start with key frame. */
+	bool is_independent;
+} ttLibC_Container_Segmenter_Segment;
+
+typedef ttLibC_Container_Segmenter_Segment ttLibC_Segment;
+
+/**
+ * definition of segmenter.
+ */
+typedef struct ttLibC_Container_Segmenter {
+	/** number of outputs. */
+	uint32_t output_num;
+	/** target duration of segment in milisec. */
+	uint32_t target_duration;
+	/** target duration of part in milisec. 0 for no parts. */
+	uint32_t part_duration;
+	/** number of segments decided. */
+	uint64_t segment_num;
+	/** timebase of input frame, 0 before first write. */
+	uint32_t timebase;
+} ttLibC_Container_Segmenter;
+
+typedef ttLibC_Container_Segmenter ttLibC_Segmenter;
+
+/**
+ * callback for complete segment.
+ * @param ptr          user def pointer.
+ * @param segmenter    segmenter object.
+ * @param output_index index of output. (return value of addOutput)
+ * @param segment      segment data.
+ * @return true:continue false:stop
+ */
+typedef bool (* ttLibC_SegmenterFunc)(void *ptr, ttLibC_Segmenter *segmenter, uint32_t output_index, ttLibC_Segment *segment);
+
+/**
+ * make segmenter
+ * @param target_frame_types array of use frame type list. primary(video) first.
+ * @param types_num          number of array.
+ * @param target_duration    target duration of segment in milisec.
+ * @return segmenter object.
+ */
+ttLibC_Segmenter *ttLibC_Segmenter_make(
+		ttLibC_Frame_Type *target_frame_types,
+		uint32_t types_num,
+		uint32_t target_duration);
+
+/**
+ * add output. (before first write)
+ * @param segmenter      segmenter object.
+ * @param container_type containerType_mp4, containerType_mpegts or containerType_mkv.
+ * @param callback       callback for written data of this output.
+ * @param ptr            user def pointer for callback.
+ * @return index of output. -1 for error.
+ */
+int32_t ttLibC_Segmenter_addOutput(
+		ttLibC_Segmenter *segmenter,
+		ttLibC_Container_Type container_type,
+		ttLibC_ContainerWriteFunc callback,
+		void *ptr);
+
+/**
+ * set target duration of parts. (before first write)
+ * parts are reported before their segment, part may start with non key frame.
+ * @param segmenter     segmenter object.
+ * @param part_duration target duration of part in milisec. 0 for no parts.
+ * @return true:success false:error
+ */
+bool ttLibC_Segmenter_setPartDuration(
+		ttLibC_Segmenter *segmenter,
+		uint32_t part_duration);
+
+struct ttLibC_Container_SegmentIndex;
+
+/**
+ * publish segments and parts of output on index. (segmentIndex.h)
+ * @param segmenter    segmenter object.
+ * @param output_index index of output.
+ * @param index        index object, NULL to stop. owned by caller.
+ * @return true:success false:error
+ */
+bool ttLibC_Segmenter_setIndex(
+		ttLibC_Segmenter *segmenter,
+		uint32_t output_index,
+		struct ttLibC_Container_SegmentIndex *index);
+
+/**
+ * ref writer of output, for detail setting. (ex: ttLibC_MpegtsWriter_setReduceMode)
+ * @param segmenter    segmenter object.
+ * @param output_index index of output.
+ * @return writer object. NULL for invalid index.
+ */
+ttLibC_ContainerWriter *ttLibC_Segmenter_refWriter(
+		ttLibC_Segmenter *segmenter,
+		uint32_t output_index);
+
+/**
+ * ref size of initialize data on output. (mp4:ftyp + moov mpegts:sdt + pat + pmt)
+ * the data is on offset 0.
+ * @param segmenter    segmenter object.
+ * @param output_index index of output.
+ * @return byte size.
+ */
+uint64_t ttLibC_Segmenter_refInitSize(
+		ttLibC_Segmenter *segmenter,
+		uint32_t output_index);
+
+/**
+ * write frame to all outputs.
+ * @param segmenter segmenter object.
+ * @param frame     frame. id is 1 for 1st of types, 2 for 2nd...
+ * @param callback  callback for complete segment.
+ * @param ptr       user def pointer for callback.
+ * @return true:success false:error
+ */
+bool ttLibC_Segmenter_write(
+		ttLibC_Segmenter *segmenter,
+		ttLibC_Frame *frame,
+		ttLibC_SegmenterFunc callback,
+		void *ptr);
+
+/**
+ * write frames after the last boundary as the last segment, and report it.
+ * end of the last segment is the end of written frames.
+ * no more write after flush.
+ * @param segmenter segmenter object.
+ * @param callback  callback for complete segment.
+ * @param ptr       user def pointer for callback.
+ * @return true:success false:error
+ */
+bool ttLibC_Segmenter_flush(
+		ttLibC_Segmenter *segmenter,
+		ttLibC_SegmenterFunc callback,
+		void *ptr);
+
+/**
+ * close segmenter and writers.
+ * frames after the last boundary are not written without flush, same as writers.
+ * @param segmenter
+ */
+void ttLibC_Segmenter_close(ttLibC_Segmenter **segmenter);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_CONTAINER_SEGMENTER_H_ */
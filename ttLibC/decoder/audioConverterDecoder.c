@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../frame/audio/pcms16.h"
 #include "../frame/audio/aac.h"
 #include <string.h>
@@ -191,6 +192,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_AcDecoder_decode(
 		ttLibC_Audio *audio,
 		ttLibC_AcDecodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_decode);
 	if(decoder == NULL) {
 		return false;
 	}
@@ -16,8 +16,12 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/hexUtil.h"
 #include "../util/dynamicBufferUtil.h"
+#include "../util/framePoolUtil.h"
+#include "../khash.h"
+#include <pthread.h>
 
 #include "../frame/video/bgr.h"
 #include "../frame/video/h264.h"
@@ -30,10 +34,20 @@
 #include "../frame/audio/speex.h"
 #include "../frame/audio/vorbis.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#	include <emmintrin.h>
+#	define AVCODECDECODER_USE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	include <arm_neon.h>
+#	define AVCODECDECODER_USE_NEON
+#endif
+
 #ifdef __ENABLE_SWSCALE__
 #	include <libswscale/swscale.h>
 #endif
 
+KHASH_MAP_INIT_INT64(ttLibC_AvcodecDecoder_Ref, AVFrame *)
+
 /*
  * avcodecDecoder detail definition
  */
@@ -47,6 +61,14 @@ typedef struct {
 	ttLibC_Frame *frame;
 	ttLibC_Frame *h26x_configData;
 	ttLibC_DynamicBuffer *extraDataBuffer;
+	/** pool for output frame. */
+	ttLibC_FramePool *pool;
+	/** timebase of last input video frame, for flush. */
+	uint32_t timebase;
+	/** frames made by refFrame -> AVFrame which holds the buffer. */
+	khash_t(ttLibC_AvcodecDecoder_Ref) *ref_table;
+	/** lock for ref_table, unref could be done on other thread. */
+	pthread_mutex_t ref_mutex;
 
 #ifdef __ENABLE_SWSCALE__
 	struct SwsContext *convertCtx;
@@ -56,6 +78,64 @@ typedef struct {
 
 typedef ttLibC_Decoder_AvcodecDecoder_ ttLibC_AvcodecDecoder_;
 
+/*
+ * ref prev_frame for output.
+ * with pool, output is made on pooled frame directly. (copy from avframe buffer, or convert)
+ * without pool, decoder->frame is reused.
+ * @param decoder  decoder object
+ * @param type     output frame type
+ * @param sub_type output detail type
+ * @param width    output width (channel_num for audio)
+ * @param height   output height (0 for audio)
+ * @return prev_frame for make func
+ */
+static ttLibC_Frame *AvcodecDecoder_prevFrame(
+		ttLibC_AvcodecDecoder_ *decoder,
+		ttLibC_Frame_Type type,
+		uint32_t sub_type,
+		uint32_t width,
+		uint32_t height) {
+	if(decoder->pool == NULL) {
+		if(decoder->frame != NULL && decoder->frame->type != type) {
+			ttLibC_Frame_close(&decoder->frame);
+		}
+		return decoder->frame;
+	}
+	if(decoder->frame != NULL) {
+		if(decoder->frame->is_non_copy) {
+			ttLibC_Frame_close(&decoder->frame);
+		}
+		else {
+			ttLibC_FramePool_release(decoder->pool, &decoder->frame);
+		}
+	}
+	switch(type) {
+	case frameType_pcmS16:
+	case frameType_pcmF32:
+		return ttLibC_FramePool_getAudio(decoder->pool, type, sub_type, width);
+	default:
+		return ttLibC_FramePool_getVideo(decoder->pool, type, sub_type, width, height);
+	}
+}
+
+/*
+ * pass decoded frame to callback.
+ * with pool, frame is pooled one, and back to pool after callback.
+ * @param decoder  decoder object
+ * @param callback callback func
+ * @param ptr      user def pointer
+ */
+static bool AvcodecDecoder_callback(
+		ttLibC_AvcodecDecoder_ *decoder,
+		ttLibC_AvcodecDecodeFunc callback,
+		void *ptr) {
+	bool result = callback(ptr, decoder->frame);
+	if(decoder->pool != NULL) {
+		ttLibC_FramePool_release(decoder->pool, &decoder->frame);
+	}
+	return result;
+}
+
 /*
  * do audio decode.
  * @param decoder  decoder object
@@ -191,11 +271,13 @@ static bool AvcodecDecoder_decodeAudio(
 	switch(decoder->dec->sample_fmt) {
 	case AV_SAMPLE_FMT_FLT:
 		{
-			if(decoder->frame != NULL && decoder->frame->type != frameType_pcmF32) {
-				ttLibC_Frame_close(&decoder->frame);
-			}
 			ttLibC_PcmF32 *pcmf32 = ttLibC_PcmF32_make(
-					(ttLibC_PcmF32 *)decoder->frame,
+					(ttLibC_PcmF32 *)AvcodecDecoder_prevFrame(
+						decoder,
+						frameType_pcmF32,
+						PcmF32Type_interleave,
+						decoder->avframe->channels,
+						0),
 					PcmF32Type_interleave,
 					decoder->avframe->sample_rate,
 					decoder->avframe->nb_samples,
@@ -206,7 +288,7 @@ static bool AvcodecDecoder_decodeAudio(
 					decoder->avframe->nb_samples * 4 * decoder->avframe->channels,
 					NULL,
 					0,
-					true,
+					decoder->pool == NULL,
 #ifndef FF_API_PKT_PTS
 					decoder->avframe->pkt_pts,
 #else
@@ -219,17 +301,19 @@ static bool AvcodecDecoder_decodeAudio(
 				if(callback == NULL) {
 					return true;
 				}
-				return callback(ptr, decoder->frame);
+				return AvcodecDecoder_callback(decoder, callback, ptr);
 			}
 		}
 		break;
 	case AV_SAMPLE_FMT_FLTP:
 		{
-			if(decoder->frame != NULL && decoder->frame->type != frameType_pcmF32) {
-				ttLibC_Frame_close(&decoder->frame);
-			}
 			ttLibC_PcmF32 *pcmf32 = ttLibC_PcmF32_make(
-					(ttLibC_PcmF32 *)decoder->frame,
+					(ttLibC_PcmF32 *)AvcodecDecoder_prevFrame(
+						decoder,
+						frameType_pcmF32,
+						PcmF32Type_planar,
+						decoder->avframe->channels,
+						0),
 					PcmF32Type_planar,
 					decoder->avframe->sample_rate,
 					decoder->avframe->nb_samples,
@@ -240,7 +324,7 @@ static bool AvcodecDecoder_decodeAudio(
 					decoder->avframe->nb_samples * 4,
 					decoder->avframe->data[1],
 					decoder->avframe->nb_samples * 4,
-					true,
+					decoder->pool == NULL,
 #ifndef FF_API_PKT_PTS
 					decoder->avframe->pkt_pts,
 #else
@@ -253,17 +337,19 @@ static bool AvcodecDecoder_decodeAudio(
 				if(callback == NULL) {
 					return true;
 				}
-				return callback(ptr, decoder->frame);
+				return AvcodecDecoder_callback(decoder, callback, ptr);
 			}
 		}
 		break;
 	case AV_SAMPLE_FMT_S16:
 		{
-			if(decoder->frame != NULL && decoder->frame->type != frameType_pcmS16) {
-				ttLibC_Frame_close(&decoder->frame);
-			}
 			ttLibC_PcmS16 *pcms16 = ttLibC_PcmS16_make(
-					(ttLibC_PcmS16 *)decoder->frame,
+					(ttLibC_PcmS16 *)AvcodecDecoder_prevFrame(
+						decoder,
+						frameType_pcmS16,
+						PcmS16Type_littleEndian,
+						decoder->avframe->channels,
+						0),
 					PcmS16Type_littleEndian,
 					decoder->avframe->sample_rate,
 					decoder->avframe->nb_samples,
@@ -274,7 +360,7 @@ static bool AvcodecDecoder_decodeAudio(
 					decoder->avframe->nb_samples * 2 * decoder->avframe->channels,
 					NULL,
 					0,
-					true,
+					decoder->pool == NULL,
 #ifndef FF_API_PKT_PTS
 					decoder->avframe->pkt_pts,
 #else
@@ -287,17 +373,19 @@ static bool AvcodecDecoder_decodeAudio(
 				if(callback == NULL) {
 					return true;
 				}
-				return callback(ptr, decoder->frame);
+				return AvcodecDecoder_callback(decoder, callback, ptr);
 			}
 		}
 		break;
 	case AV_SAMPLE_FMT_S16P:
 		{
-			if(decoder->frame != NULL && decoder->frame->type != frameType_pcmS16) {
-				ttLibC_Frame_close(&decoder->frame);
-			}
 			ttLibC_PcmS16 *pcms16 = ttLibC_PcmS16_make(
-					(ttLibC_PcmS16 *)decoder->frame,
+					(ttLibC_PcmS16 *)AvcodecDecoder_prevFrame(
+						decoder,
+						frameType_pcmS16,
+						PcmS16Type_littleEndian_planar,
+						decoder->avframe->channels,
+						0),
 					PcmS16Type_littleEndian_planar,
 					decoder->avframe->sample_rate,
 					decoder->avframe->nb_samples,
@@ -308,7 +396,7 @@ static bool AvcodecDecoder_decodeAudio(
 					decoder->avframe->nb_samples * 2,
 					decoder->avframe->data[1],
 					decoder->avframe->nb_samples * 2,
-					true,
+					decoder->pool == NULL,
 #ifndef FF_API_PKT_PTS
 					decoder->avframe->pkt_pts,
 #else
@@ -321,7 +409,7 @@ static bool AvcodecDecoder_decodeAudio(
 				if(callback == NULL) {
 					return true;
 				}
-				return callback(ptr, decoder->frame);
+				return AvcodecDecoder_callback(decoder, callback, ptr);
 			}
 		}
 		break;
@@ -336,150 +424,65 @@ static bool AvcodecDecoder_decodeAudio(
 }
 
 /*
- * do video decode.
+ * pick even position pixels, for 4:4:4 -> 4:2:0 chroma.
+ * @param dst       dst plane line
+ * @param src       src plane line
+ * @param src_width pixel num of src line.
+ */
+static void AvcodecDecoder_pickEvenPixels(
+		uint8_t *dst,
+		const uint8_t *src,
+		uint32_t src_width) {
+	uint32_t num = (src_width + 1) >> 1;
+	uint32_t i = 0;
+#if defined(AVCODECDECODER_USE_SSE2)
+	const __m128i mask = _mm_set1_epi16(0x00FF);
+	for(;i * 2 + 32 <= src_width;i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(src + i * 2));
+		__m128i b = _mm_loadu_si128((const __m128i *)(src + i * 2 + 16));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+	}
+#elif defined(AVCODECDECODER_USE_NEON)
+	for(;i * 2 + 32 <= src_width;i += 16) {
+		uint8x16x2_t v = vld2q_u8(src + i * 2);
+		vst1q_u8(dst + i, v.val[0]);
+	}
+#endif
+	for(;i < num;++ i) {
+		dst[i] = src[i * 2];
+	}
+}
+
+/*
+ * make frame from decoded avframe and call callback.
  * @param decoder  decoder object
- * @param frame    target frame
+ * @param id       id of source frame
  * @param callback callback func
  * @param ptr      user def pointer.
  */
-static bool AvcodecDecoder_decodeVideo(
+static bool AvcodecDecoder_outputVideo(
 		ttLibC_AvcodecDecoder_ *decoder,
-		ttLibC_Video *frame,
+		uint32_t id,
 		ttLibC_AvcodecDecodeFunc callback,
 		void *ptr) {
-	decoder->packet.data = frame->inherit_super.data;
-	decoder->packet.size = frame->inherit_super.buffer_size;
-	decoder->packet.pts  = frame->inherit_super.pts;
-	switch(frame->inherit_super.type) {
-	case frameType_h264:
-		{
-			ttLibC_H264 *h264 = (ttLibC_H264 *)frame;
-			switch(h264->type) {
-			case H264Type_configData:
-				{
-					ttLibC_Frame *f = ttLibC_Frame_clone(decoder->h26x_configData, (ttLibC_Frame *)frame);
-					if(f == NULL) {
-						ERR_PRINT("failed to make cloned frame.");
-						return false;
-					}
-					decoder->h26x_configData = f;
-					return true;
-				}
-				break;
-			case H264Type_sliceIDR:
-				{
-					if(decoder->h26x_configData == NULL) {
-						ERR_PRINT("need h264_configData for decode sliceIDR.");
-						return false;
-					}
-					if(decoder->extraDataBuffer == NULL) {
-						decoder->extraDataBuffer = ttLibC_DynamicBuffer_make();
-					}
-					ttLibC_DynamicBuffer_empty(decoder->extraDataBuffer);
-					ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, decoder->h26x_configData->data, decoder->h26x_configData->buffer_size);
-					ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, frame->inherit_super.data,      frame->inherit_super.buffer_size);
-					decoder->packet.data = ttLibC_DynamicBuffer_refData(decoder->extraDataBuffer);
-					decoder->packet.size = ttLibC_DynamicBuffer_refSize(decoder->extraDataBuffer);
-				}
-				break;
-			default:
-				break;
-			}
-		}
-		break;
-	case frameType_theora:
-		{
-			ttLibC_Theora *theora = (ttLibC_Theora *)frame;
-			switch(theora->type) {
-			case TheoraType_identificationHeaderDecodeFrame:
-				if(decoder->extraDataBuffer == NULL) {
-					decoder->extraDataBuffer = ttLibC_DynamicBuffer_make();
-				}
-				else {
-					ttLibC_DynamicBuffer_reset(decoder->extraDataBuffer);
-				}
-				uint8_t buf[3] = {0x02, frame->inherit_super.buffer_size, 0};
-				ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, buf, 3);
-				ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, frame->inherit_super.data, frame->inherit_super.buffer_size);
-				return true;
-			case TheoraType_commentHeaderFrame:
-				{
-					uint8_t *buf = ttLibC_DynamicBuffer_refData(decoder->extraDataBuffer);
-					buf[2] = frame->inherit_super.buffer_size;
-					ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, frame->inherit_super.data, frame->inherit_super.buffer_size);
-				}
-				return true;
-			case TheoraType_setupHeaderFrame:
-				ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, frame->inherit_super.data, frame->inherit_super.buffer_size);
-				decoder->dec->extradata = ttLibC_DynamicBuffer_refData(decoder->extraDataBuffer);
-				decoder->dec->extradata_size = ttLibC_DynamicBuffer_refSize(decoder->extraDataBuffer);
-				if(!decoder->is_opened) {
-					int result = 0;
-					if((result = avcodec_open2(decoder->dec, decoder->dec->codec, NULL)) < 0) {
-						ERR_PRINT("failed to open codec.:%d", AVERROR(result));
-						av_free(decoder->dec);
-						ttLibC_free(decoder);
-						return NULL;
-					}
-					decoder->is_opened = true;
-				}
-				else {
-					ERR_PRINT("avcodec is already opened, therefore failed to set private data.");
-				}
-				return true;
-			default:
-				break;
-			}
-		}
-		break;
-	case frameType_jpeg:
-	case frameType_png:
-		{
-			decoder->packet.flags = AV_PKT_FLAG_KEY;
-		}
-		break;
-	default:
-		break;
-	}
-	int got_picture;
-	int result = avcodec_decode_video2(decoder->dec, decoder->avframe, &got_picture, &decoder->packet);
-	if(result < 0) {
-		ERR_PRINT("failed to decode:%d", result);
-		return false;
-	}
-	if(got_picture != 1) {
-		return true;
-	}
-#ifdef TT_FF_OLD_AVCODEC
-	int result = avcodec_send_packet(decoder->dec, &decoder->packet);
-	if(result < 0) {
-		ERR_PRINT("failed to decode:%d", result);
-		return false;
-	}
-	if(result != 0) {
-		return true;
-	}
-	do {
-		result = avcodec_receive_frame(decoder->dec, decoder->avframe);
-		if(result == AVERROR(EAGAIN)) {
-			return true;
-		}
-		if(result < 0) {
-			ERR_PRINT("failed to receive:%d", result);
-			return false;
-		}
+	// with frame delay(b-frame, frame threading), id is carried by avcodec.
+#ifdef AV_CODEC_FLAG_COPY_OPAQUE
+	id = (uint32_t)(uintptr_t)decoder->avframe->opaque;
+#else
+	id = (uint32_t)decoder->avframe->reordered_opaque;
 #endif
-	// decode complete now make frame and call callback.
 	decoder->inherit_super.width  = decoder->avframe->width;
 	decoder->inherit_super.height = decoder->avframe->height;
 	switch(decoder->dec->pix_fmt) {
 	case AV_PIX_FMT_YUV420P:
 		{
-			if(decoder->frame != NULL && decoder->frame->type != frameType_yuv420) {
-				ttLibC_Frame_close(&decoder->frame);
-			}
 			ttLibC_Yuv420 *y = ttLibC_Yuv420_make(
-					(ttLibC_Yuv420 *)decoder->frame,
+					(ttLibC_Yuv420 *)AvcodecDecoder_prevFrame(
+						decoder,
+						frameType_yuv420,
+						Yuv420Type_planar,
+						decoder->avframe->width,
+						decoder->avframe->height),
 					Yuv420Type_planar,
 					decoder->avframe->width,
 					decoder->avframe->height,
@@ -488,18 +491,18 @@ static bool AvcodecDecoder_decodeVideo(
 					decoder->avframe->data[0], decoder->avframe->linesize[0],
 					decoder->avframe->data[1], decoder->avframe->linesize[1],
 					decoder->avframe->data[2], decoder->avframe->linesize[2],
-					true,
+					decoder->pool == NULL,
 #ifndef FF_API_PKT_PTS
 					decoder->avframe->pkt_pts,
 #else
 					decoder->avframe->pts,
 #endif
-					frame->inherit_super.timebase);
+					decoder->timebase);
 			if(y != NULL) {
 				decoder->frame = (ttLibC_Frame *)y;
-				decoder->frame->id = frame->inherit_super.id;
+				decoder->frame->id = id;
 				if(callback != NULL) {
-					return callback(ptr, decoder->frame);
+					return AvcodecDecoder_callback(decoder, callback, ptr);
 				}
 				else {
 					return true;
@@ -510,11 +513,13 @@ static bool AvcodecDecoder_decodeVideo(
 	case AV_PIX_FMT_YUV422P:
 	case AV_PIX_FMT_YUV444P:
 		{
-			if(decoder->frame != NULL && decoder->frame->type != frameType_yuv420) {
-				ttLibC_Frame_close(&decoder->frame);
-			}
 			ttLibC_Yuv420 *yuv = ttLibC_Yuv420_makeEmptyFrame2(
-					(ttLibC_Yuv420 *)decoder->frame,
+					(ttLibC_Yuv420 *)AvcodecDecoder_prevFrame(
+						decoder,
+						frameType_yuv420,
+						Yuv420Type_planar,
+						decoder->avframe->width,
+						decoder->avframe->height),
 					Yuv420Type_planar,
 					decoder->avframe->width,
 					decoder->avframe->height);
@@ -555,16 +560,8 @@ static bool AvcodecDecoder_decodeVideo(
 				for(int j = 0;j < decoder->avframe->height;++ j) {
 					memcpy(dst_y_data, src_y_data, decoder->avframe->width);
 					if((j & 0x01) == 0) {
-						uint8_t *ud = dst_u_data;
-						uint8_t *vd = dst_v_data;
-						for(int i = 0;i < decoder->avframe->width;++ i) {
-							if((i & 0x01) == 0x00) {
-								*ud = *(src_u_data + i);
-								*vd = *(src_v_data + i);
-								ud += yuv->u_step;
-								vd += yuv->v_step;
-							}
-						}
+						AvcodecDecoder_pickEvenPixels(dst_u_data, src_u_data, decoder->avframe->width);
+						AvcodecDecoder_pickEvenPixels(dst_v_data, src_v_data, decoder->avframe->width);
 						dst_u_data += yuv->u_stride;
 						dst_v_data += yuv->v_stride;
 					}
@@ -583,10 +580,10 @@ static bool AvcodecDecoder_decodeVideo(
 #else
 			yuv->inherit_super.inherit_super.pts = decoder->avframe->pts;
 #endif
-			yuv->inherit_super.inherit_super.timebase = frame->inherit_super.timebase;
-			decoder->frame->id = frame->inherit_super.id;
+			yuv->inherit_super.inherit_super.timebase = decoder->timebase;
+			decoder->frame->id = id;
 			if(callback != NULL) {
-				return callback(ptr, decoder->frame);
+				return AvcodecDecoder_callback(decoder, callback, ptr);
 			}
 			else {
 				return true;
@@ -606,7 +603,12 @@ static bool AvcodecDecoder_decodeVideo(
 			}
 			// use swscale to convert into yuv420.
 			ttLibC_Yuv420 *yuv = (ttLibC_Yuv420 *)ttLibC_Yuv420_makeEmptyFrame2(
-					(ttLibC_Yuv420 *)decoder->frame,
+					(ttLibC_Yuv420 *)AvcodecDecoder_prevFrame(
+						decoder,
+						frameType_yuv420,
+						Yuv420Type_planar,
+						decoder->avframe->width,
+						decoder->avframe->height),
 					Yuv420Type_planar,
 					decoder->avframe->width,
 					decoder->avframe->height);
@@ -658,11 +660,11 @@ static bool AvcodecDecoder_decodeVideo(
 #else
 			decoder->frame->pts = decoder->avframe->pts,
 #endif
-			decoder->frame->timebase = frame->inherit_super.timebase;
+			decoder->frame->timebase = decoder->timebase;
 			// done.
-			decoder->frame->id = frame->inherit_super.id;
+			decoder->frame->id = id;
 			if(callback != NULL) {
-				return callback(ptr, decoder->frame);
+				return AvcodecDecoder_callback(decoder, callback, ptr);
 			}
 			else {
 				return true;
@@ -680,9 +682,6 @@ static bool AvcodecDecoder_decodeVideo(
 	case AV_PIX_FMT_ARGB: // argbargb...
 	case AV_PIX_FMT_RGBA: // rgbargba...
 		{
-			if(decoder->frame != NULL && decoder->frame->type != frameType_bgr) {
-				ttLibC_Frame_close(&decoder->frame);
-			}
 			ttLibC_Bgr_Type type = BgrType_bgr;
 			switch(decoder->dec->pix_fmt) {
 			case AV_PIX_FMT_RGB24: // rgbrgb...
@@ -707,25 +706,30 @@ static bool AvcodecDecoder_decodeVideo(
 				break;
 			}
 			ttLibC_Bgr *b = ttLibC_Bgr_make(
-					(ttLibC_Bgr *)decoder->frame,
+					(ttLibC_Bgr *)AvcodecDecoder_prevFrame(
+						decoder,
+						frameType_bgr,
+						type,
+						decoder->avframe->width,
+						decoder->avframe->height),
 					type,
 					decoder->avframe->width,
 					decoder->avframe->height,
 					decoder->avframe->linesize[0],
 					decoder->avframe->data[0],
 					decoder->avframe->linesize[0] * decoder->avframe->height,
-					true,
+					decoder->pool == NULL,
 #ifndef FF_API_PKT_PTS
 					decoder->avframe->pkt_pts,
 #else
 					decoder->avframe->pts,
 #endif
-					frame->inherit_super.timebase);
+					decoder->timebase);
 			if(b != NULL) {
 				decoder->frame = (ttLibC_Frame *)b;
-				decoder->frame->id = frame->inherit_super.id;
+				decoder->frame->id = id;
 				if(callback != NULL) {
-					return callback(ptr, decoder->frame);
+					return AvcodecDecoder_callback(decoder, callback, ptr);
 				}
 				else {
 					return true;
@@ -736,7 +740,12 @@ static bool AvcodecDecoder_decodeVideo(
 	case AV_PIX_FMT_PAL8:
 		{
 			ttLibC_Bgr *bgr = ttLibC_Bgr_makeEmptyFrame2(
-					(ttLibC_Bgr *)decoder->frame,
+					(ttLibC_Bgr *)AvcodecDecoder_prevFrame(
+						decoder,
+						frameType_bgr,
+						BgrType_rgba,
+						decoder->avframe->width,
+						decoder->avframe->height),
 					BgrType_rgba,
 					decoder->avframe->width,
 					decoder->avframe->height);
@@ -750,7 +759,7 @@ static bool AvcodecDecoder_decodeVideo(
 #else
 			decoder->frame->pts = decoder->avframe->pts,
 #endif
-			decoder->frame->timebase = frame->inherit_super.timebase;
+			decoder->frame->timebase = decoder->timebase;
 
 			uint32_t *palette = (uint32_t *)decoder->avframe->data[1];
 			uint8_t *src = decoder->avframe->data[0];
@@ -771,9 +780,9 @@ static bool AvcodecDecoder_decodeVideo(
 				src += decoder->avframe->linesize[0];
 				dst += bgr->width_stride;
 			}
-			decoder->frame->id = frame->inherit_super.id;
+			decoder->frame->id = id;
 			if(callback != NULL) {
-				return callback(ptr, decoder->frame);
+				return AvcodecDecoder_callback(decoder, callback, ptr);
 			}
 			else {
 				return true;
@@ -788,10 +797,157 @@ static bool AvcodecDecoder_decodeVideo(
 		ERR_PRINT("unknown pixfmt output.%d", decoder->dec->pix_fmt);
 		return false;
 	}
+	return false;
+}
+
+/*
+ * do video decode.
+ * @param decoder  decoder object
+ * @param frame    target frame
+ * @param callback callback func
+ * @param ptr      user def pointer.
+ */
+static bool AvcodecDecoder_decodeVideo(
+		ttLibC_AvcodecDecoder_ *decoder,
+		ttLibC_Video *frame,
+		ttLibC_AvcodecDecodeFunc callback,
+		void *ptr) {
+	decoder->packet.data = frame->inherit_super.data;
+	decoder->packet.size = frame->inherit_super.buffer_size;
+	decoder->packet.pts  = frame->inherit_super.pts;
+	switch(frame->inherit_super.type) {
+	case frameType_h264:
+		{
+			ttLibC_H264 *h264 = (ttLibC_H264 *)frame;
+			switch(h264->type) {
+			case H264Type_configData:
+				{
+					ttLibC_Frame *f = ttLibC_Frame_clone(decoder->h26x_configData, (ttLibC_Frame *)frame);
+					if(f == NULL) {
+						ERR_PRINT("failed to make cloned frame.");
+						return false;
+					}
+					decoder->h26x_configData = f;
+					return true;
+				}
+				break;
+			case H264Type_sliceIDR:
+				{
+					if(decoder->h26x_configData == NULL) {
+						ERR_PRINT("need h264_configData for decode sliceIDR.");
+						return false;
+					}
+					if(decoder->extraDataBuffer == NULL) {
+						decoder->extraDataBuffer = ttLibC_DynamicBuffer_make();
+					}
+					ttLibC_DynamicBuffer_empty(decoder->extraDataBuffer);
+					ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, decoder->h26x_configData->data, decoder->h26x_configData->buffer_size);
+					ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, frame->inherit_super.data,      frame->inherit_super.buffer_size);
+					decoder->packet.data = ttLibC_DynamicBuffer_refData(decoder->extraDataBuffer);
+					decoder->packet.size = ttLibC_DynamicBuffer_refSize(decoder->extraDataBuffer);
+				}
+				break;
+			default:
+				break;
+			}
+		}
+		break;
+	case frameType_theora:
+		{
+			ttLibC_Theora *theora = (ttLibC_Theora *)frame;
+			switch(theora->type) {
+			case TheoraType_identificationHeaderDecodeFrame:
+				if(decoder->extraDataBuffer == NULL) {
+					decoder->extraDataBuffer = ttLibC_DynamicBuffer_make();
+				}
+				else {
+					ttLibC_DynamicBuffer_reset(decoder->extraDataBuffer);
+				}
+				uint8_t buf[3] = {0x02, frame->inherit_super.buffer_size, 0};
+				ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, buf, 3);
+				ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, frame->inherit_super.data, frame->inherit_super.buffer_size);
+				return true;
+			case TheoraType_commentHeaderFrame:
+				{
+					uint8_t *buf = ttLibC_DynamicBuffer_refData(decoder->extraDataBuffer);
+					buf[2] = frame->inherit_super.buffer_size;
+					ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, frame->inherit_super.data, frame->inherit_super.buffer_size);
+				}
+				return true;
+			case TheoraType_setupHeaderFrame:
+				ttLibC_DynamicBuffer_append(decoder->extraDataBuffer, frame->inherit_super.data, frame->inherit_super.buffer_size);
+				decoder->dec->extradata = ttLibC_DynamicBuffer_refData(decoder->extraDataBuffer);
+				decoder->dec->extradata_size = ttLibC_DynamicBuffer_refSize(decoder->extraDataBuffer);
+				if(!decoder->is_opened) {
+					int result = 0;
+					if((result = avcodec_open2(decoder->dec, decoder->dec->codec, NULL)) < 0) {
+						ERR_PRINT("failed to open codec.:%d", AVERROR(result));
+						av_free(decoder->dec);
+						ttLibC_free(decoder);
+						return NULL;
+					}
+					decoder->is_opened = true;
+				}
+				else {
+					ERR_PRINT("avcodec is already opened, therefore failed to set private data.");
+				}
+				return true;
+			default:
+				break;
+			}
+		}
+		break;
+	case frameType_jpeg:
+	case frameType_png:
+		{
+			decoder->packet.flags = AV_PKT_FLAG_KEY;
+		}
+		break;
+	default:
+		break;
+	}
+	decoder->timebase = frame->inherit_super.timebase;
+#ifdef AV_CODEC_FLAG_COPY_OPAQUE
+	// reordered_opaque is removed from newer avcodec, packet opaque is copied to output frame.
+	decoder->packet.opaque = (void *)(uintptr_t)frame->inherit_super.id;
+#else
+	decoder->dec->reordered_opaque = frame->inherit_super.id;
+#endif
+	int got_picture;
+	int result = avcodec_decode_video2(decoder->dec, decoder->avframe, &got_picture, &decoder->packet);
+	if(result < 0) {
+		ERR_PRINT("failed to decode:%d", result);
+		return false;
+	}
+	if(got_picture != 1) {
+		return true;
+	}
+#ifdef TT_FF_OLD_AVCODEC
+	int result = avcodec_send_packet(decoder->dec, &decoder->packet);
+	if(result < 0) {
+		ERR_PRINT("failed to decode:%d", result);
+		return false;
+	}
+	if(result != 0) {
+		return true;
+	}
+	do {
+		result = avcodec_receive_frame(decoder->dec, decoder->avframe);
+		if(result == AVERROR(EAGAIN)) {
+			return true;
+		}
+		if(result < 0) {
+			ERR_PRINT("failed to receive:%d", result);
+			return false;
+		}
+#endif
+	if(!AvcodecDecoder_outputVideo(decoder, frame->inherit_super.id, callback, ptr)) {
+		return false;
+	}
 #ifdef TT_FF_OLD_AVCODEC
 	}while(true);
 #endif
-	return false;
+	return true;
 }
 
 /*
@@ -976,7 +1132,12 @@ ttLibC_AvcodecDecoder TT_VISIBILITY_DEFAULT *ttLibC_AvcodecDecoder_makeWithAVCod
 	decoder->inFormat = AV_PIX_FMT_NONE;
 #endif
 	decoder->dec = dec;
+	decoder->pool = NULL;
 	decoder->is_opened = false;
+#ifdef AV_CODEC_FLAG_COPY_OPAQUE
+	// for frame id.
+	decoder->dec->flags |= AV_CODEC_FLAG_COPY_OPAQUE;
+#endif
 	if(frame_type != frameType_theora
 	&& frame_type != frameType_vorbis
 	&& frame_type != frameType_speex) {
@@ -1058,6 +1219,9 @@ ttLibC_AvcodecDecoder TT_VISIBILITY_DEFAULT *ttLibC_AvcodecDecoder_makeWithAVCod
 	decoder->frame = NULL;
 	decoder->h26x_configData = NULL;
 	decoder->extraDataBuffer = NULL;
+	decoder->timebase = 1000;
+	pthread_mutex_init(&decoder->ref_mutex, NULL);
+	decoder->ref_table = kh_init(ttLibC_AvcodecDecoder_Ref);
 	return (ttLibC_AvcodecDecoder *)decoder;
 }
 
@@ -1137,6 +1301,34 @@ ttLibC_AvcodecDecoder TT_VISIBILITY_DEFAULT *ttLibC_AvcodecVideoDecoder_make_ex(
 		uint32_t height,
 		void *extradata,
 		size_t extradata_size) {
+	return ttLibC_AvcodecVideoDecoder_makeWithThread(
+			frame_type,
+			width,
+			height,
+			extradata,
+			extradata_size,
+			1,
+			AvcodecDecoderThreadType_none);
+}
+
+/*
+ * make video decoder with threading.
+ * @param frame_type     target ttLibC_Frame_Type
+ * @param width          target width
+ * @param height         target height
+ * @param extradata      extradata(some codec require these value.)
+ * @param extradata_size extradata_size
+ * @param thread_count   number of thread. 0:auto(number of cpu)
+ * @param thread_type    threading method.
+ */
+ttLibC_AvcodecDecoder TT_VISIBILITY_DEFAULT *ttLibC_AvcodecVideoDecoder_makeWithThread(
+		ttLibC_Frame_Type frame_type,
+		uint32_t width,
+		uint32_t height,
+		void *extradata,
+		size_t extradata_size,
+		uint32_t thread_count,
+		ttLibC_AvcodecDecoder_ThreadType thread_type) {
 	AVCodecContext *dec = (AVCodecContext *)ttLibC_AvcodecDecoder_getAVCodecContext(frame_type);
 	if(dec == NULL) {
 		return NULL;
@@ -1145,6 +1337,16 @@ ttLibC_AvcodecDecoder TT_VISIBILITY_DEFAULT *ttLibC_AvcodecVideoDecoder_make_ex(
 	dec->height = height;
 	dec->extradata = extradata;
 	dec->extradata_size = (int)extradata_size;
+	if(thread_type != AvcodecDecoderThreadType_none) {
+		dec->thread_count = thread_count;
+		dec->thread_type = 0;
+		if((thread_type & AvcodecDecoderThreadType_frame) != 0) {
+			dec->thread_type |= FF_THREAD_FRAME;
+		}
+		if((thread_type & AvcodecDecoderThreadType_slice) != 0) {
+			dec->thread_type |= FF_THREAD_SLICE;
+		}
+	}
 	return ttLibC_AvcodecDecoder_makeWithAVCodecContext(dec);
 }
 
@@ -1173,6 +1375,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_AvcodecDecoder_decode(
 		ttLibC_Frame *frame,
 		ttLibC_AvcodecDecodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_decode);
 	if(decoder == NULL) {
 		return false;
 	}
@@ -1200,6 +1403,152 @@ bool TT_VISIBILITY_DEFAULT ttLibC_AvcodecDecoder_decode(
 	}
 }
 
+/*
+ * drain frames which is held in decoder, for end of stream.
+ * @param decoder  avcodec decoder
+ * @param callback callback func for avcodec decode.
+ * @param ptr      pointer for user def value, which call in callback.
+ * @return true / false
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_AvcodecDecoder_flush(
+		ttLibC_AvcodecDecoder *decoder,
+		ttLibC_AvcodecDecodeFunc callback,
+		void *ptr) {
+	ttLibC_AvcodecDecoder_ *decoder_ = (ttLibC_AvcodecDecoder_ *)decoder;
+	if(decoder_ == NULL) {
+		return false;
+	}
+	if(!decoder_->is_opened) {
+		return true;
+	}
+	bool result = true;
+	if(decoder_->dec->codec->type == AVMEDIA_TYPE_VIDEO) {
+		// empty packet makes decoder to output held frames.
+		decoder_->packet.data = NULL;
+		decoder_->packet.size = 0;
+#ifdef TT_FF_OLD_AVCODEC
+		avcodec_send_packet(decoder_->dec, NULL);
+		while(result && avcodec_receive_frame(decoder_->dec, decoder_->avframe) == 0) {
+			result = AvcodecDecoder_outputVideo(decoder_, 0, callback, ptr);
+		}
+#else
+		while(result) {
+			int got_picture = 0;
+			if(avcodec_decode_video2(decoder_->dec, decoder_->avframe, &got_picture, &decoder_->packet) < 0
+			|| got_picture != 1) {
+				break;
+			}
+			result = AvcodecDecoder_outputVideo(decoder_, 0, callback, ptr);
+		}
+#endif
+	}
+	// ready for next stream.
+	avcodec_flush_buffers(decoder_->dec);
+	return result;
+}
+
+/*
+ * set frame pool for output frame.
+ * @param decoder avcodec decoder
+ * @param pool    frame pool, NULL to use internal frame.
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_AvcodecDecoder_setFramePool(
+		ttLibC_AvcodecDecoder *decoder,
+		ttLibC_FramePool *pool) {
+	ttLibC_AvcodecDecoder_ *decoder_ = (ttLibC_AvcodecDecoder_ *)decoder;
+	if(decoder_ == NULL) {
+		return;
+	}
+	decoder_->pool = pool;
+}
+
+/*
+ * make ref of decoded frame, which is alive after next decode.
+ * @param decoder avcodec decoder
+ * @param frame   frame from decode callback.
+ * @return ref frame. release with ttLibC_AvcodecDecoder_unrefFrame.
+ */
+ttLibC_Frame TT_VISIBILITY_DEFAULT *ttLibC_AvcodecDecoder_refFrame(
+		ttLibC_AvcodecDecoder *decoder,
+		ttLibC_Frame *frame) {
+	ttLibC_AvcodecDecoder_ *decoder_ = (ttLibC_AvcodecDecoder_ *)decoder;
+	if(decoder_ == NULL || frame == NULL) {
+		return NULL;
+	}
+	AVFrame *avframe = NULL;
+	ttLibC_Frame *ref = NULL;
+	if(frame == decoder_->frame
+	&& frame->type == frameType_yuv420
+	&& frame->is_non_copy) {
+		// frame is the view of avframe, take ref of the buffer, no copy.
+		avframe = av_frame_clone(decoder_->avframe);
+		if(avframe == NULL) {
+			ERR_PRINT("failed to ref avframe.");
+			return NULL;
+		}
+		ttLibC_Yuv420 *yuv = (ttLibC_Yuv420 *)frame;
+		ref = (ttLibC_Frame *)ttLibC_Yuv420_make(
+				NULL,
+				yuv->type,
+				yuv->inherit_super.width,
+				yuv->inherit_super.height,
+				NULL,
+				0,
+				avframe->data[0], avframe->linesize[0],
+				avframe->data[1], avframe->linesize[1],
+				avframe->data[2], avframe->linesize[2],
+				true,
+				frame->pts,
+				frame->timebase);
+		if(ref == NULL) {
+			ERR_PRINT("failed to make ref frame.");
+			av_frame_free(&avframe);
+			return NULL;
+		}
+		ref->id = frame->id;
+	}
+	else {
+		// converted or pooled frame, copy.
+		ref = ttLibC_Frame_clone(NULL, frame);
+		if(ref == NULL) {
+			ERR_PRINT("failed to clone frame.");
+			return NULL;
+		}
+	}
+	int ret;
+	pthread_mutex_lock(&decoder_->ref_mutex);
+	khiter_t it = kh_put(ttLibC_AvcodecDecoder_Ref, decoder_->ref_table, (uint64_t)ref, &ret);
+	kh_value(decoder_->ref_table, it) = avframe;
+	pthread_mutex_unlock(&decoder_->ref_mutex);
+	return ref;
+}
+
+/*
+ * release frame from refFrame.
+ * @param decoder avcodec decoder
+ * @param frame   ref frame
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_AvcodecDecoder_unrefFrame(
+		ttLibC_AvcodecDecoder *decoder,
+		ttLibC_Frame **frame) {
+	ttLibC_AvcodecDecoder_ *decoder_ = (ttLibC_AvcodecDecoder_ *)decoder;
+	if(decoder_ == NULL || frame == NULL || *frame == NULL) {
+		return;
+	}
+	AVFrame *avframe = NULL;
+	pthread_mutex_lock(&decoder_->ref_mutex);
+	khiter_t it = kh_get(ttLibC_AvcodecDecoder_Ref, decoder_->ref_table, (uint64_t)*frame);
+	if(it != kh_end(decoder_->ref_table)) {
+		avframe = kh_value(decoder_->ref_table, it);
+		kh_del(ttLibC_AvcodecDecoder_Ref, decoder_->ref_table, it);
+	}
+	pthread_mutex_unlock(&decoder_->ref_mutex);
+	if(avframe != NULL) {
+		av_frame_free(&avframe);
+	}
+	ttLibC_Frame_close(frame);
+}
+
 /*
  * close avcodec decoder.
  * @param decoder.
@@ -1229,6 +1578,21 @@ void TT_VISIBILITY_DEFAULT ttLibC_AvcodecDecoder_close(ttLibC_AvcodecDecoder **d
 #endif
 	ttLibC_DynamicBuffer_close(&target->extraDataBuffer);
 	ttLibC_Frame_close(&target->frame);
+	if(target->ref_table != NULL) {
+		// release ref frames which is not unref yet, with their buffers.
+		for(khiter_t it = kh_begin(target->ref_table);it != kh_end(target->ref_table);++ it) {
+			if(kh_exist(target->ref_table, it)) {
+				ttLibC_Frame *ref = (ttLibC_Frame *)(uintptr_t)kh_key(target->ref_table, it);
+				AVFrame *avframe = kh_value(target->ref_table, it);
+				ttLibC_Frame_close(&ref);
+				if(avframe != NULL) {
+					av_frame_free(&avframe);
+				}
+			}
+		}
+		kh_destroy(ttLibC_AvcodecDecoder_Ref, target->ref_table);
+		pthread_mutex_destroy(&target->ref_mutex);
+	}
 	ttLibC_Frame_close(&target->h26x_configData);
 	ttLibC_free(target);
 	*decoder = NULL;
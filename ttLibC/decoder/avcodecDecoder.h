@@ -17,6 +17,7 @@ extern "C" {
 #endif
 
 #include "../frame/frame.h"
+#include "../util/framePoolUtil.h"
 
 /**
  * avcodec decoder definition
@@ -36,6 +37,20 @@ typedef struct ttLibC_Decoder_AvcodecDecoder {
 
 typedef ttLibC_Decoder_AvcodecDecoder ttLibC_AvcodecDecoder;
 
+/**
+ * threading method for video decoder.
+ */
+typedef enum ttLibC_AvcodecDecoder_ThreadType {
+	/** decode on caller thread only. */
+	AvcodecDecoderThreadType_none = 0x00,
+	/** decode several frames at once. output is delayed by thread_count - 1 frames. */
+	AvcodecDecoderThreadType_frame = 0x01,
+	/** decode slices of one frame at once. no delay, effective for multi slice stream only. */
+	AvcodecDecoderThreadType_slice = 0x02,
+	/** use frame and slice both. */
+	AvcodecDecoderThreadType_frameAndSlice = 0x03,
+} ttLibC_AvcodecDecoder_ThreadType;
+
 /**
  * callback function for avcodec decoder.
  * @param ptr   user def value pointer.
@@ -107,6 +122,27 @@ ttLibC_AvcodecDecoder *ttLibC_AvcodecVideoDecoder_make_ex(
 		void *extradata,
 		size_t extradata_size);
 
+/**
+ * make video decoder with threading.
+ * with frame threading, decoded frames are delayed, callback order is kept as output order.
+ * call ttLibC_AvcodecDecoder_flush at the end of stream, to get held frames.
+ * @param frame_type     target ttLibC_Frame_Type
+ * @param width          target width
+ * @param height         target height
+ * @param extradata      extradata(some codec require these value.)
+ * @param extradata_size extradata_size
+ * @param thread_count   number of thread. 0:auto(number of cpu)
+ * @param thread_type    threading method.
+ */
+ttLibC_AvcodecDecoder *ttLibC_AvcodecVideoDecoder_makeWithThread(
+		ttLibC_Frame_Type frame_type,
+		uint32_t width,
+		uint32_t height,
+		void *extradata,
+		size_t extradata_size,
+		uint32_t thread_count,
+		ttLibC_AvcodecDecoder_ThreadType thread_type);
+
 /**
  * make decoder
  * @param frame_type target ttLibC_Frame_Type
@@ -127,6 +163,54 @@ bool ttLibC_AvcodecDecoder_decode(
 		ttLibC_AvcodecDecodeFunc callback,
 		void *ptr);
 
+/**
+ * drain frames which is held in decoder, for end of stream.
+ * decoder can be used for next stream after flush.
+ * @param decoder  avcodec decoder
+ * @param callback callback func for avcodec decode.
+ * @param ptr      pointer for user def value, which call in callback.
+ * @return true / false
+ */
+bool ttLibC_AvcodecDecoder_flush(
+		ttLibC_AvcodecDecoder *decoder,
+		ttLibC_AvcodecDecodeFunc callback,
+		void *ptr);
+
+/**
+ * set frame pool for output frame.
+ * decoded frame is made on pooled frame directly (no extra copy), and back to pool after callback.
+ * use ttLibC_FramePool_ref in callback to keep the frame.
+ * pool must live longer than decoder.
+ * @param decoder avcodec decoder
+ * @param pool    frame pool, NULL to use internal frame.
+ */
+void ttLibC_AvcodecDecoder_setFramePool(
+		ttLibC_AvcodecDecoder *decoder,
+		ttLibC_FramePool *pool);
+
+/**
+ * make ref of decoded frame, which is alive after next decode.
+ * yuv420 planar output shares the AVFrame buffer by av_frame_ref, no copy.
+ * other output(converted, pooled) is copied.
+ * @param decoder avcodec decoder
+ * @param frame   frame from decode callback.
+ * @return ref frame. release with ttLibC_AvcodecDecoder_unrefFrame.
+ * ref frames which is not released are closed with decoder, do not use them after close.
+ */
+ttLibC_Frame *ttLibC_AvcodecDecoder_refFrame(
+		ttLibC_AvcodecDecoder *decoder,
+		ttLibC_Frame *frame);
+
+/**
+ * release frame from refFrame.
+ * can be called on other thread than decode.
+ * @param decoder avcodec decoder
+ * @param frame   ref frame
+ */
+void ttLibC_AvcodecDecoder_unrefFrame(
+		ttLibC_AvcodecDecoder *decoder,
+		ttLibC_Frame **frame);
+
 /**
  * close avcodec decoder.
  * @param decoder.
@@ -14,7 +14,9 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/hexUtil.h"
+#include "../util/framePoolUtil.h"
 
 #include <jpeglib.h>
 #include <setjmp.h>
@@ -28,6 +30,7 @@ typedef struct {
 	struct jpeg_decompress_struct dinfo;
 	struct jpeg_error_mgr jerr;
 	ttLibC_Yuv420 *yuv420;
+	ttLibC_FramePool *pool;
 	void *dummy_buffer;
 	size_t dummy_buffer_size;
 } ttLibC_Decoder_JpegDecoder_;
@@ -48,6 +51,7 @@ ttLibC_JpegDecoder TT_VISIBILITY_DEFAULT *ttLibC_JpegDecoder_make() {
 	jpeg_create_decompress(&decoder->dinfo);
 
 	decoder->yuv420 = NULL;
+	decoder->pool = NULL;
 	decoder->dummy_buffer = NULL;
 	decoder->dummy_buffer_size = 0;
 	return (ttLibC_JpegDecoder *)decoder;
@@ -66,6 +70,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_JpegDecoder_decode(
 		ttLibC_Jpeg *jpeg,
 		ttLibC_JpegDecodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_decode);
 	if(decoder == NULL) {
 		return false;
 	}
@@ -97,8 +102,19 @@ bool TT_VISIBILITY_DEFAULT ttLibC_JpegDecoder_decode(
 #endif
 	jpeg_start_decompress(&decoder_->dinfo);
 
+	ttLibC_Yuv420 *prev_frame = decoder_->yuv420;
+	if(decoder_->pool != NULL) {
+		// frame left by error is back to pool.
+		ttLibC_FramePool_release(decoder_->pool, (ttLibC_Frame **)&decoder_->yuv420);
+		prev_frame = (ttLibC_Yuv420 *)ttLibC_FramePool_getVideo(
+				decoder_->pool,
+				frameType_yuv420,
+				Yuv420Type_planar,
+				jpeg->inherit_super.width,
+				jpeg->inherit_super.height);
+	}
 	ttLibC_Yuv420 *yuv = ttLibC_Yuv420_makeEmptyFrame2(
-			decoder_->yuv420,
+			prev_frame,
 			Yuv420Type_planar,
 			jpeg->inherit_super.width,
 			jpeg->inherit_super.height);
@@ -169,10 +185,27 @@ bool TT_VISIBILITY_DEFAULT ttLibC_JpegDecoder_decode(
 	}
 	yuv->inherit_super.inherit_super.pts = jpeg->inherit_super.inherit_super.pts;
 	yuv->inherit_super.inherit_super.timebase = jpeg->inherit_super.inherit_super.timebase;
-	if(!callback(ptr, yuv)) {
-		return false;
+	bool result = callback(ptr, yuv);
+	if(decoder_->pool != NULL) {
+		// callback hold the frame with ttLibC_FramePool_ref if need.
+		ttLibC_FramePool_release(decoder_->pool, (ttLibC_Frame **)&decoder_->yuv420);
 	}
-	return true;
+	return result;
+}
+
+/*
+ * set frame pool for output frame.
+ * @param decoder jpeg decoder object.
+ * @param pool    frame pool, NULL to use internal frame.
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_JpegDecoder_setFramePool(
+		ttLibC_JpegDecoder *decoder,
+		ttLibC_FramePool *pool) {
+	ttLibC_JpegDecoder_ *decoder_ = (ttLibC_JpegDecoder_ *)decoder;
+	if(decoder_ == NULL) {
+		return;
+	}
+	decoder_->pool = pool;
 }
 
 /*
@@ -188,6 +221,9 @@ void TT_VISIBILITY_DEFAULT ttLibC_JpegDecoder_close(ttLibC_JpegDecoder **decoder
 		ttLibC_free(target->dummy_buffer);
 	}
 	jpeg_destroy_decompress(&target->dinfo);
+	if(target->pool != NULL) {
+		ttLibC_FramePool_release(target->pool, (ttLibC_Frame **)&target->yuv420);
+	}
 	ttLibC_Yuv420_close(&target->yuv420);
 	ttLibC_free(target);
 	*decoder = NULL;
@@ -17,6 +17,7 @@ extern "C" {
 
 #include "../frame/video/yuv420.h"
 #include "../frame/video/jpeg.h"
+#include "../util/framePoolUtil.h"
 
 /**
  * jpeg decoder definition
@@ -53,6 +54,18 @@ bool ttLibC_JpegDecoder_decode(
 		ttLibC_JpegDecodeFunc callback,
 		void *ptr);
 
+/**
+ * set frame pool for output frame.
+ * decoded frame is drawn from pool, and back to pool after callback.
+ * use ttLibC_FramePool_ref in callback to keep the frame.
+ * pool must live longer than decoder.
+ * @param decoder jpeg decoder object.
+ * @param pool    frame pool, NULL to use internal frame.
+ */
+void ttLibC_JpegDecoder_setFramePool(
+		ttLibC_JpegDecoder *decoder,
+		ttLibC_FramePool *pool);
+
 /**
  * close jpeg decoder
  * @param decoder
@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include <stdlib.h>
 #include <lame/lame.h>
 
@@ -86,6 +87,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_Mp3lameDecoder_decode(
 		ttLibC_Mp3 *mp3,
 		ttLibC_Mp3lameDecodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_decode);
 	if(decoder == NULL) {
 		return false;
 	}
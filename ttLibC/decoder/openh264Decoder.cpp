@@ -14,6 +14,8 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
+#include "../util/framePoolUtil.h"
 
 #include <wels/codec_api.h>
 #include <wels/codec_ver.h>
@@ -36,6 +38,8 @@ typedef struct {
 	SBufferInfo bufInfo;
 	/** yuv420 frame. */
 	ttLibC_Yuv420 *yuv420;
+	/** pool for output frame. */
+	ttLibC_FramePool *pool;
 } ttLibC_Decoder_Openh264Decoder_;
 
 typedef ttLibC_Decoder_Openh264Decoder_ ttLibC_Openh264Decoder_;
@@ -72,6 +76,7 @@ static ttLibC_Openh264Decoder *Openh264Decoder_make(SDecodingParam *param) {
 		return NULL;
 	}
 	decoder->yuv420 = NULL;
+	decoder->pool = NULL;
 	decoder->inherit_super.width  = 0;
 	decoder->inherit_super.height = 0;
 	return (ttLibC_Openh264Decoder *)decoder;
@@ -118,6 +123,34 @@ static bool Openh264Decoder_decode(
 //	decoder_->inherit_super.height = decoder_->bufInfo.UsrData.sSystemBuffer.iHeight;
 	decoder_->inherit_super.width  = h264->inherit_super.width;
 	decoder_->inherit_super.height = h264->inherit_super.height;
+	if(decoder_->pool != NULL) {
+		// copy openh264 buffer straight into pooled frame.
+		ttLibC_Yuv420 *pooled = ttLibC_Yuv420_make(
+				(ttLibC_Yuv420 *)ttLibC_FramePool_getVideo(
+					decoder_->pool,
+					frameType_yuv420,
+					Yuv420Type_planar,
+					decoder_->inherit_super.width,
+					decoder_->inherit_super.height),
+				Yuv420Type_planar,
+				decoder_->inherit_super.width,
+				decoder_->inherit_super.height,
+				NULL, 0,
+				decodeBuf[0], decoder_->bufInfo.UsrData.sSystemBuffer.iStride[0],
+				decodeBuf[1], decoder_->bufInfo.UsrData.sSystemBuffer.iStride[1],
+				decodeBuf[2], decoder_->bufInfo.UsrData.sSystemBuffer.iStride[1],
+				false,
+				decoder_->bufInfo.uiOutYuvTimeStamp,
+				h264->inherit_super.inherit_super.timebase);
+		if(pooled == NULL) {
+			ERR_PRINT("failed to make pooled frame.");
+			return false;
+		}
+		pooled->inherit_super.inherit_super.id = h264->inherit_super.inherit_super.id;
+		bool result = callback(ptr, pooled);
+		ttLibC_FramePool_release(decoder_->pool, (ttLibC_Frame **)&pooled);
+		return result;
+	}
 	ttLibC_Yuv420 *yuv = ttLibC_Yuv420_make(
 			decoder_->yuv420,
 			Yuv420Type_planar,
@@ -142,6 +175,21 @@ static bool Openh264Decoder_decode(
 	return true;
 }
 
+/*
+ * set frame pool for output frame.
+ * @param decoder openh264 decoder object.
+ * @param pool    frame pool, NULL to use internal frame.
+ */
+static void Openh264Decoder_setFramePool(
+		ttLibC_Openh264Decoder *decoder,
+		ttLibC_FramePool *pool) {
+	ttLibC_Openh264Decoder_ *decoder_ = (ttLibC_Openh264Decoder_ *)decoder;
+	if(decoder_ == NULL) {
+		return;
+	}
+	decoder_->pool = pool;
+}
+
 /*
  * close openh264 decoder
  * @param decoder
@@ -207,9 +255,19 @@ bool TT_VISIBILITY_DEFAULT ttLibC_Openh264Decoder_decode(
 		ttLibC_H264 *h264,
 		ttLibC_Openh264DecodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_decode);
 	return Openh264Decoder_decode(decoder, h264, callback, ptr);
 }
 
+/*
+ * call setFramePool for c code.
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_Openh264Decoder_setFramePool(
+		ttLibC_Openh264Decoder *decoder,
+		ttLibC_FramePool *pool) {
+	Openh264Decoder_setFramePool(decoder, pool);
+}
+
 /*
  * call close for c code
  */
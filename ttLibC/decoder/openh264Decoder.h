@@ -17,6 +17,7 @@ extern "C" {
 
 #include "../frame/video/h264.h"
 #include "../frame/video/yuv420.h"
+#include "../util/framePoolUtil.h"
 
 /**
  * openh264 decoder definition.
@@ -68,6 +69,18 @@ bool ttLibC_Openh264Decoder_decode(
 		ttLibC_Openh264DecodeFunc callback,
 		void *ptr);
 
+/**
+ * set frame pool for output frame.
+ * decoded frame is made on pooled frame directly (no extra copy), and back to pool after callback.
+ * use ttLibC_FramePool_ref in callback to keep the frame.
+ * pool must live longer than decoder.
+ * @param decoder openh264 decoder object.
+ * @param pool    frame pool, NULL to use internal frame.
+ */
+void ttLibC_Openh264Decoder_setFramePool(
+		ttLibC_Openh264Decoder *decoder,
+		ttLibC_FramePool *pool);
+
 /**
  * close openh264 decoder
  * @param decoder
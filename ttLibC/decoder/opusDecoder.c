@@ -11,6 +11,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include <stdlib.h>
 #include <string.h>
 #include <opus/opus.h>
@@ -79,6 +80,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_OpusDecoder_decode(
 		ttLibC_Opus *opus,
 		ttLibC_OpusDecodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_decode);
 	if(decoder == NULL) {
 		return false;
 	}
@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include <stdlib.h>
 #include <speex/speex.h>
 #include <speex/speex_header.h>
@@ -101,6 +102,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_SpeexDecoder_decode(
 		ttLibC_Speex *speex,
 		ttLibC_SpeexDecodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_decode);
 	if(decoder == NULL) {
 		return false;
 	}
@@ -13,6 +13,7 @@
 #include "theoraDecoder.h"
 #include "../ttLibC_predef.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../_log.h"
 #include <theora/theoradec.h>
 #include <string.h>
@@ -70,6 +71,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_TheoraDecoder_decode(
 		ttLibC_Theora *theora,
 		ttLibC_TheoraDecodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_decode);
 	ttLibC_TheoraDecoder_ *decoder_ = (ttLibC_TheoraDecoder_ *)decoder;
 	if(decoder_ == NULL) {
 		return false;
@@ -13,6 +13,7 @@
 #include "vorbisDecoder.h"
 #include "../ttLibC_predef.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../_log.h"
 #include <vorbis/codec.h>
 #include <string.h>
@@ -55,6 +56,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_VorbisDecoder_decode(
 		ttLibC_Vorbis *vorbis,
 		ttLibC_VorbisDecodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_decode);
 	ttLibC_VorbisDecoder_ *decoder_ = (ttLibC_VorbisDecoder_ *)decoder;
 	if(decoder_ == NULL) {
 		return false;
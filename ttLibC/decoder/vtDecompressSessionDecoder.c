@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/dynamicBufferUtil.h"
 #include "../util/ioUtil.h"
 #include "../util/hexUtil.h"
@@ -578,6 +579,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_VtDecoder_decode(
 		ttLibC_Video *video,
 		ttLibC_VtDecodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_decode);
 	return VtDecoder_decode(decoder,
 			video,
 			callback,
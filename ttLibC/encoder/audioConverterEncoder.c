@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/hexUtil.h"
 #include "../frame/audio/aac.h"
 #include "../frame/audio/pcmAlaw.h"
@@ -276,6 +277,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_AcEncoder_encode(
 		ttLibC_PcmS16 *pcm,
 		ttLibC_AcEncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	ttLibC_AcEncoder_ *encoder_ = (ttLibC_AcEncoder_ *)encoder;
 	if(encoder_ == NULL) {
 		return false;
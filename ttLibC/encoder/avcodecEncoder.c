@@ -16,6 +16,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/hexUtil.h"
 #include "../frame/video/yuv420.h"
 #include "../frame/video/bgr.h"
@@ -1396,6 +1397,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_AvcodecEncoder_encode(
 		ttLibC_Frame *frame,
 		ttLibC_AvcodecEncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	if(encoder == NULL) {
 		return false;
 	}
@@ -0,0 +1,355 @@
+/*
+ * @file   encodeSink.c
+ * @brief  caller provided output for encoders.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "encodeSink.h"
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+#include "../frame/video/h264.h"
+#include <string.h>
+
+/*
+ * detail definition of encode sink.
+ */
+typedef struct ttLibC_Encoder_EncodeSink_ {
+	ttLibC_EncodeSink inherit_super;
+	/** region mode */
+	uint8_t *data;
+	size_t data_size;
+	/** dynamicBuffer mode */
+	ttLibC_DynamicBuffer *buffer;
+	/** size of buffer data before this sink. */
+	size_t buffer_base;
+	/** reserved size, 0 for no reserve. */
+	size_t reserve_size;
+	/** position of current unit. */
+	size_t unit_start;
+	/** type of held h264 unit, H264Type_unknown for nothing. */
+	ttLibC_H264_Type h264_type;
+} ttLibC_Encoder_EncodeSink_;
+
+typedef ttLibC_Encoder_EncodeSink_ ttLibC_EncodeSink_;
+
+static ttLibC_EncodeSink_ *EncodeSink_make(ttLibC_EncodeSink_NalFormat nal_format) {
+	ttLibC_EncodeSink_ *sink = ttLibC_malloc(sizeof(ttLibC_EncodeSink_));
+	if(sink == NULL) {
+		return NULL;
+	}
+	memset(sink, 0, sizeof(ttLibC_EncodeSink_));
+	sink->inherit_super.nal_format = nal_format;
+	sink->inherit_super.frame_type = frameType_unknown;
+	sink->h264_type = H264Type_unknown;
+	return sink;
+}
+
+ttLibC_EncodeSink TT_VISIBILITY_DEFAULT *ttLibC_EncodeSink_makeRegion(
+		void *data,
+		size_t data_size,
+		ttLibC_EncodeSink_NalFormat nal_format) {
+	if(data == NULL && data_size != 0) {
+		return NULL;
+	}
+	ttLibC_EncodeSink_ *sink = EncodeSink_make(nal_format);
+	if(sink == NULL) {
+		return NULL;
+	}
+	sink->data      = (uint8_t *)data;
+	sink->data_size = data_size;
+	return (ttLibC_EncodeSink *)sink;
+}
+
+ttLibC_EncodeSink TT_VISIBILITY_DEFAULT *ttLibC_EncodeSink_makeBuffer(
+		ttLibC_DynamicBuffer *buffer,
+		ttLibC_EncodeSink_NalFormat nal_format) {
+	if(buffer == NULL) {
+		return NULL;
+	}
+	ttLibC_EncodeSink_ *sink = EncodeSink_make(nal_format);
+	if(sink == NULL) {
+		return NULL;
+	}
+	sink->buffer      = buffer;
+	sink->buffer_base = ttLibC_DynamicBuffer_refSize(buffer);
+	return (ttLibC_EncodeSink *)sink;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_EncodeSink_setRegion(
+		ttLibC_EncodeSink *sink,
+		void *data,
+		size_t data_size) {
+	ttLibC_EncodeSink_ *sink_ = (ttLibC_EncodeSink_ *)sink;
+	if(sink_ == NULL || sink_->buffer != NULL) {
+		return false;
+	}
+	sink_->data      = (uint8_t *)data;
+	sink_->data_size = data_size;
+	ttLibC_EncodeSink_reset(sink);
+	return true;
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_EncodeSink_reset(ttLibC_EncodeSink *sink) {
+	ttLibC_EncodeSink_ *sink_ = (ttLibC_EncodeSink_ *)sink;
+	if(sink_ == NULL) {
+		return;
+	}
+	if(sink_->buffer != NULL) {
+		sink_->buffer_base = ttLibC_DynamicBuffer_refSize(sink_->buffer);
+	}
+	sink_->reserve_size = 0;
+	sink_->unit_start   = 0;
+	sink_->h264_type    = H264Type_unknown;
+	sink_->inherit_super.write_size  = 0;
+	sink_->inherit_super.is_overflow = false;
+	sink_->inherit_super.unit_num    = 0;
+	sink_->inherit_super.unit_offset = 0;
+	sink_->inherit_super.unit_size   = 0;
+}
+
+/*
+ * ref the top of sink.
+ */
+static uint8_t *EncodeSink_refTop(ttLibC_EncodeSink_ *sink) {
+	if(sink->buffer != NULL) {
+		return ttLibC_DynamicBuffer_refData(sink->buffer) + sink->buffer_base;
+	}
+	return sink->data;
+}
+
+uint8_t TT_VISIBILITY_DEFAULT *ttLibC_EncodeSink_refUnit(ttLibC_EncodeSink *sink) {
+	ttLibC_EncodeSink_ *sink_ = (ttLibC_EncodeSink_ *)sink;
+	if(sink_ == NULL) {
+		return NULL;
+	}
+	return EncodeSink_refTop(sink_) + sink_->inherit_super.unit_offset;
+}
+
+uint8_t TT_VISIBILITY_DEFAULT *ttLibC_EncodeSink_reserve(
+		ttLibC_EncodeSink *sink,
+		size_t size) {
+	ttLibC_EncodeSink_ *sink_ = (ttLibC_EncodeSink_ *)sink;
+	if(sink_ == NULL || sink_->inherit_super.is_overflow) {
+		return NULL;
+	}
+	size_t write_size = sink_->inherit_super.write_size;
+	if(sink_->buffer == NULL) {
+		if(sink_->data_size - write_size < size) {
+			sink_->inherit_super.is_overflow = true;
+			return NULL;
+		}
+		sink_->reserve_size = size;
+		return sink_->data + write_size;
+	}
+	uint8_t *target = ttLibC_DynamicBuffer_reserve(sink_->buffer, size);
+	if(target == NULL) {
+		sink_->inherit_super.is_overflow = true;
+		return NULL;
+	}
+	sink_->reserve_size = size;
+	return target;
+}
+
+uint8_t TT_VISIBILITY_DEFAULT *ttLibC_EncodeSink_reserveUpTo(
+		ttLibC_EncodeSink *sink,
+		size_t size,
+		size_t *reserved_size) {
+	ttLibC_EncodeSink_ *sink_ = (ttLibC_EncodeSink_ *)sink;
+	if(sink_ == NULL) {
+		return NULL;
+	}
+	if(sink_->buffer == NULL) {
+		size_t free_size = sink_->data_size - sink_->inherit_super.write_size;
+		if(free_size < size) {
+			size = free_size;
+		}
+		if(size == 0) {
+			return NULL;
+		}
+	}
+	uint8_t *target = ttLibC_EncodeSink_reserve(sink, size);
+	if(target != NULL) {
+		*reserved_size = size;
+	}
+	return target;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_EncodeSink_commit(
+		ttLibC_EncodeSink *sink,
+		size_t size) {
+	ttLibC_EncodeSink_ *sink_ = (ttLibC_EncodeSink_ *)sink;
+	if(sink_ == NULL || sink_->inherit_super.is_overflow) {
+		return false;
+	}
+	if(size > sink_->reserve_size) {
+		ERR_PRINT("commit size is bigger than reserved.");
+		return false;
+	}
+	if(sink_->buffer != NULL && !ttLibC_DynamicBuffer_commit(sink_->buffer, size)) {
+		sink_->inherit_super.is_overflow = true;
+		return false;
+	}
+	sink_->reserve_size = 0;
+	sink_->inherit_super.write_size += size;
+	return true;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_EncodeSink_append(
+		ttLibC_EncodeSink *sink,
+		void *data,
+		size_t data_size) {
+	uint8_t *target = ttLibC_EncodeSink_reserve(sink, data_size);
+	if(target == NULL) {
+		return false;
+	}
+	memcpy(target, data, data_size);
+	return ttLibC_EncodeSink_commit(sink, data_size);
+}
+
+/*
+ * size of start code on the top of nal.
+ * @return 4 or 3 for start code, 0 for none.
+ */
+static size_t EncodeSink_getStartCodeSize(
+		uint8_t *nal,
+		size_t nal_size) {
+	if(nal_size >= 4 && nal[0] == 0 && nal[1] == 0 && nal[2] == 0 && nal[3] == 1) {
+		return 4;
+	}
+	if(nal_size >= 3 && nal[0] == 0 && nal[1] == 0 && nal[2] == 1) {
+		return 3;
+	}
+	return 0;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_EncodeSink_appendNal(
+		ttLibC_EncodeSink *sink,
+		uint8_t *nal,
+		size_t nal_size) {
+	if(sink == NULL) {
+		return false;
+	}
+	// skip start code.
+	size_t start_code_size = EncodeSink_getStartCodeSize(nal, nal_size);
+	nal += start_code_size;
+	nal_size -= start_code_size;
+	uint8_t *target = ttLibC_EncodeSink_reserve(sink, nal_size + 4);
+	if(target == NULL) {
+		return false;
+	}
+	switch(sink->nal_format) {
+	case EncodeSinkNalFormat_annexB:
+		target[0] = 0x00;
+		target[1] = 0x00;
+		target[2] = 0x00;
+		target[3] = 0x01;
+		break;
+	case EncodeSinkNalFormat_sizeNal:
+		target[0] = (nal_size >> 24) & 0xFF;
+		target[1] = (nal_size >> 16) & 0xFF;
+		target[2] = (nal_size >> 8) & 0xFF;
+		target[3] = nal_size & 0xFF;
+		break;
+	}
+	memcpy(target + 4, nal, nal_size);
+	return ttLibC_EncodeSink_commit(sink, nal_size + 4);
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_EncodeSink_beginUnit(ttLibC_EncodeSink *sink) {
+	ttLibC_EncodeSink_ *sink_ = (ttLibC_EncodeSink_ *)sink;
+	if(sink_ == NULL) {
+		return;
+	}
+	sink_->unit_start = sink_->inherit_super.write_size;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_EncodeSink_endUnit(
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr) {
+	ttLibC_EncodeSink_ *sink_ = (ttLibC_EncodeSink_ *)sink;
+	if(sink_ == NULL || sink_->inherit_super.is_overflow) {
+		return false;
+	}
+	sink_->inherit_super.unit_offset = sink_->unit_start;
+	sink_->inherit_super.unit_size   = sink_->inherit_super.write_size - sink_->unit_start;
+	++ sink_->inherit_super.unit_num;
+	sink_->unit_start = sink_->inherit_super.write_size;
+	if(callback != NULL) {
+		return callback(ptr, sink);
+	}
+	return true;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_EncodeSink_appendH264Nal(
+		ttLibC_EncodeSink *sink,
+		uint8_t *nal,
+		size_t nal_size,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr) {
+	ttLibC_EncodeSink_ *sink_ = (ttLibC_EncodeSink_ *)sink;
+	if(sink_ == NULL) {
+		return false;
+	}
+	size_t start_code_size = EncodeSink_getStartCodeSize(nal, nal_size);
+	if(start_code_size >= nal_size) {
+		ERR_PRINT("nal is empty.");
+		return false;
+	}
+	ttLibC_H264_Type type = H264Type_unknown;
+	switch(nal[start_code_size] & 0x1F) {
+	case H264NalType_slice:
+		type = H264Type_slice;
+		break;
+	case H264NalType_sliceIDR:
+		type = H264Type_sliceIDR;
+		break;
+	case H264NalType_sequenceParameterSet:
+	case H264NalType_pictureParameterSet:
+		type = H264Type_configData;
+		break;
+	default:
+		// sei, aud and others are not written, the same as frame output.
+		return true;
+	}
+	if(type != sink_->h264_type) {
+		if(!ttLibC_EncodeSink_endH264(sink, callback, ptr)) {
+			return false;
+		}
+		ttLibC_EncodeSink_beginUnit(sink);
+		sink_->h264_type = type;
+	}
+	return ttLibC_EncodeSink_appendNal(sink, nal, nal_size);
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_EncodeSink_endH264(
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr) {
+	ttLibC_EncodeSink_ *sink_ = (ttLibC_EncodeSink_ *)sink;
+	if(sink_ == NULL) {
+		return false;
+	}
+	if(sink_->h264_type == H264Type_unknown) {
+		return true;
+	}
+	sink_->inherit_super.frame_type = frameType_h264;
+	sink_->inherit_super.is_key     = sink_->h264_type == H264Type_sliceIDR;
+	sink_->inherit_super.is_config  = sink_->h264_type == H264Type_configData;
+	sink_->h264_type = H264Type_unknown;
+	return ttLibC_EncodeSink_endUnit(sink, callback, ptr);
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_EncodeSink_close(ttLibC_EncodeSink **sink) {
+	ttLibC_EncodeSink_ *target = (ttLibC_EncodeSink_ *)*sink;
+	if(target == NULL) {
+		return;
+	}
+	ttLibC_free(target);
+	*sink = NULL;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file   encodeSink.h
+ * @brief  caller provided output for encoders.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * encoder writes encoded data into sink directly, instead of making frame object.
+ * sink is either fixed memory region or dynamicBuffer.
+ * h264 / h265 nal can be written as annexB or sizeNal(4byte length, for mp4 / flv).
+ *
+ * usage:
+ *   ttLibC_EncodeSink *sink = ttLibC_EncodeSink_makeBuffer(buffer, EncodeSinkNalFormat_sizeNal);
+ *   ttLibC_Openh264Encoder_encodeToSink(encoder, yuv, sink, unitCallback, ptr);
+ *   // unitCallback is called for each encoded unit, ttLibC_EncodeSink_refUnit gives the data.
+ *   ttLibC_EncodeSink_close(&sink);
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_ENCODER_ENCODESINK_H_
+#define TTLIBC_ENCODER_ENCODESINK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../frame/frame.h"
+#include "../util/dynamicBufferUtil.h"
+
+/**
+ * format of nal for h264 / h265.
+ */
+typedef enum ttLibC_EncodeSink_NalFormat {
+	/** 00 00 00 01 start code + nal */
+	EncodeSinkNalFormat_annexB,
+	/** 4byte big endian size + nal (avcc / hvcc) */
+	EncodeSinkNalFormat_sizeNal,
+} ttLibC_EncodeSink_NalFormat;
+
+/**
+ * definition of encode sink.
+ */
+typedef struct ttLibC_Encoder_EncodeSink {
+	/** nal format for h264 / h265. */
+	ttLibC_EncodeSink_NalFormat nal_format;
+	/** written size from make or reset. */
+	size_t write_size;
+	/** true if region is too small. after overflow, nothing is written. */
+	bool is_overflow;
+	/** number of units from make or reset. */
+	uint32_t unit_num;
+	/** position of last unit from the top of sink. */
+	size_t unit_offset;
+	/** size of last unit. */
+	size_t unit_size;
+	/** frame type of last unit. */
+	ttLibC_Frame_Type frame_type;
+	/** true if last unit is key frame. */
+	bool is_key;
+	/** true if last unit is config data.(sps / pps ...) */
+	bool is_config;
+	/** pts of last unit. */
+	uint64_t pts;
+	/** timebase of last unit. */
+	uint32_t timebase;
+	/** id of last unit. */
+	uint32_t id;
+} ttLibC_Encoder_EncodeSink;
+
+typedef ttLibC_Encoder_EncodeSink ttLibC_EncodeSink;
+
+/**
+ * callback function for each encoded unit.
+ * @param ptr  user def value pointer.
+ * @param sink sink object. unit information is updated.
+ * @return true:continue false:error
+ */
+typedef bool (* ttLibC_EncodeSinkFunc)(void *ptr, ttLibC_EncodeSink *sink);
+
+/**
+ * make sink for fixed memory region.
+ * @param data       target memory
+ * @param data_size  size of memory
+ * @param nal_format nal format for h264 / h265.
+ * @return sink object.
+ */
+ttLibC_EncodeSink *ttLibC_EncodeSink_makeRegion(
+		void *data,
+		size_t data_size,
+		ttLibC_EncodeSink_NalFormat nal_format);
+
+/**
+ * make sink which append data on dynamicBuffer.
+ * @param buffer     target dynamicBuffer. sink does not close it.
+ * @param nal_format nal format for h264 / h265.
+ * @return sink object.
+ */
+ttLibC_EncodeSink *ttLibC_EncodeSink_makeBuffer(
+		ttLibC_DynamicBuffer *buffer,
+		ttLibC_EncodeSink_NalFormat nal_format);
+
+/**
+ * change target region, and reset.
+ * @param sink      sink object made by makeRegion.
+ * @param data      target memory
+ * @param data_size size of memory
+ * @return true:success false:error
+ */
+bool ttLibC_EncodeSink_setRegion(
+		ttLibC_EncodeSink *sink,
+		void *data,
+		size_t data_size);
+
+/**
+ * reset write position and counters.
+ * for dynamicBuffer, following data is appended after current data of buffer.
+ * @param sink sink object.
+ */
+void ttLibC_EncodeSink_reset(ttLibC_EncodeSink *sink);
+
+/**
+ * ref the data of last unit.
+ * @param sink sink object.
+ * @return pointer of last unit. valid until next write.
+ */
+uint8_t *ttLibC_EncodeSink_refUnit(ttLibC_EncodeSink *sink);
+
+/**
+ * get writable memory on the end of sink.
+ * @param sink sink object.
+ * @param size required size.
+ * @return pointer for write. NULL for overflow.
+ * @note call ttLibC_EncodeSink_commit with written size.
+ */
+uint8_t *ttLibC_EncodeSink_reserve(
+		ttLibC_EncodeSink *sink,
+		size_t size);
+
+/**
+ * get writable memory on the end of sink, up to size.
+ * for region, the rest of region is used if it is smaller than size.
+ * @param sink          sink object.
+ * @param size          required size.
+ * @param reserved_size reserved size.
+ * @return pointer for write. NULL for no space, is_overflow is not set if region is just full.
+ */
+uint8_t *ttLibC_EncodeSink_reserveUpTo(
+		ttLibC_EncodeSink *sink,
+		size_t size,
+		size_t *reserved_size);
+
+/**
+ * fix written size on reserved memory.
+ * @param sink sink object.
+ * @param size written size. (less than reserved size)
+ * @return true:success false:error
+ */
+bool ttLibC_EncodeSink_commit(
+		ttLibC_EncodeSink *sink,
+		size_t size);
+
+/**
+ * copy data on the end of sink.
+ * @param sink      sink object.
+ * @param data      data
+ * @param data_size size of data
+ * @return true:success false:overflow
+ */
+bool ttLibC_EncodeSink_append(
+		ttLibC_EncodeSink *sink,
+		void *data,
+		size_t data_size);
+
+/**
+ * write one nal with nal_format of sink.
+ * @param sink      sink object.
+ * @param nal       nal data. start code is skipped if exists.
+ * @param nal_size  size of nal data.
+ * @return true:success false:overflow
+ */
+bool ttLibC_EncodeSink_appendNal(
+		ttLibC_EncodeSink *sink,
+		uint8_t *nal,
+		size_t nal_size);
+
+/**
+ * mark the start of unit.
+ * @param sink sink object.
+ */
+void ttLibC_EncodeSink_beginUnit(ttLibC_EncodeSink *sink);
+
+/**
+ * mark the end of unit, and call callback.
+ * frame_type, is_key, is_config, pts, timebase and id should be set before call.
+ * @param sink     sink object.
+ * @param callback callback for unit. can be NULL.
+ * @param ptr      user def value pointer.
+ * @return true:success false:overflow or callback error.
+ */
+bool ttLibC_EncodeSink_endUnit(
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr);
+
+/**
+ * write one h264 nal of encoded picture.
+ * nals are grouped into unit by type, config(sps / pps), sliceIDR and slice.
+ * when the type is changed, held unit is ended and callback is called.
+ * sei, aud and other nals are dropped.
+ * pts, timebase and id of sink should be set before call.
+ * @param sink     sink object.
+ * @param nal      nal data. with or without start code.
+ * @param nal_size size of nal data.
+ * @param callback callback for unit. can be NULL.
+ * @param ptr      user def value pointer.
+ * @return true:success false:overflow, empty nal or callback error.
+ */
+bool ttLibC_EncodeSink_appendH264Nal(
+		ttLibC_EncodeSink *sink,
+		uint8_t *nal,
+		size_t nal_size,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr);
+
+/**
+ * end held h264 unit. call after all nals of picture are written.
+ * @param sink     sink object.
+ * @param callback callback for unit. can be NULL.
+ * @param ptr      user def value pointer.
+ * @return true:success false:overflow or callback error.
+ */
+bool ttLibC_EncodeSink_endH264(
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr);
+
+/**
+ * close sink.
+ * @param sink
+ */
+void ttLibC_EncodeSink_close(ttLibC_EncodeSink **sink);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_ENCODER_ENCODESINK_H_ */
@@ -15,6 +15,7 @@
 #include "../frame/audio/aac.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -241,6 +242,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_FaacEncoder_encode(
 		ttLibC_PcmS16 *pcm,
 		ttLibC_FaacEncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	if(encoder == NULL) {
 		return false;
 	}
@@ -14,14 +14,49 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/dynamicBufferUtil.h"
+#include "encodeSink.h"
 #include <jpeglib.h>
+#include <pthread.h>
+#include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#	include <emmintrin.h>
+#	define JPEGENCODER_USE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	include <arm_neon.h>
+#	define JPEGENCODER_USE_NEON
+#endif
+
+/*
+ * compress context for one horizontal strip.
+ * single thread encoder has only one strip for whole picture.
+ */
 typedef struct {
 	struct jpeg_compress_struct cinfo;
+	struct jpeg_error_mgr       jerr;
+	struct jpeg_destination_mgr dmgr;
 	ttLibC_DynamicBuffer       *buffer;
 	uint8_t                    *data;
 	size_t                      data_size;
+	/** output sink instead of buffer. (single strip only) */
+	ttLibC_EncodeSink          *sink;
+	uint8_t                    *sink_data;
+	size_t                      sink_size;
+	bool                        is_sink_full;
+	/** full range rows for one mcu row. */
+	uint8_t *y_rows;
+	uint8_t *u_rows;
+	uint8_t *v_rows;
+	/** first luma line of strip in the picture. */
+	uint32_t top;
+	/** luma lines of strip. */
+	uint32_t height;
+	pthread_t thread;
+	bool is_thread_running;
+	bool is_success;
+	void *encoder;
 } JpegEncoder_jpeg_compress_struct;
 
 /*
@@ -30,10 +65,22 @@ typedef struct {
 typedef struct {
 	/** inherit data from ttLibC_JpegEncoder */
 	ttLibC_JpegEncoder          inherit_super;
-	JpegEncoder_jpeg_compress_struct cinfo;
-	struct jpeg_error_mgr       jerr;
-	struct jpeg_destination_mgr dmgr;
-	ttLibC_Yuv420 *fullrange_yuv;
+	JpegEncoder_jpeg_compress_struct *strips;
+	uint32_t strip_num;
+	/** row size of y_rows and u_rows, v_rows. */
+	uint32_t y_row_stride;
+	uint32_t c_row_stride;
+	/** buffer for stitched jpeg. (parallel mode only) */
+	ttLibC_DynamicBuffer *buffer;
+	ttLibC_EncodeSink    *buffer_sink;
+	/** target of current encode, for worker threads. */
+	ttLibC_Yuv420 *yuv;
+	pthread_mutex_t mutex;
+	pthread_cond_t  start_cond;
+	pthread_cond_t  done_cond;
+	uint64_t generation;
+	uint32_t running_num;
+	bool is_closing;
 	ttLibC_Jpeg   *jpeg;
 } ttLibC_Encoder_JpegEncoder_;
 
@@ -44,10 +91,41 @@ static void ttLibC_JpegEncoder_init_buffer(j_compress_ptr cinfo) {
 	(void)cinfo;
 }
 
+/*
+ * set next output memory on sink.
+ * libjpeg requests next memory just after the memory is full, even if there is no more data.
+ * so when the sink is full, rest of data is written on strip data,
+ * and it is treated as overflow only if some data is written there.
+ */
+static void JpegEncoder_reserveSink(JpegEncoder_jpeg_compress_struct *strip) {
+	strip->sink_data = NULL;
+	if(!strip->is_sink_full) {
+		strip->sink_data = ttLibC_EncodeSink_reserveUpTo(strip->sink, strip->data_size, &strip->sink_size);
+	}
+	if(strip->sink_data == NULL) {
+		strip->is_sink_full = true;
+		strip->sink_data = strip->data;
+		strip->sink_size = strip->data_size;
+	}
+	strip->dmgr.next_output_byte = strip->sink_data;
+	strip->dmgr.free_in_buffer   = strip->sink_size;
+}
+
 // in the case of buffer is full.
 static boolean ttLibC_JpegEncoder_empty_buffer(j_compress_ptr cinfo) {
 	JpegEncoder_jpeg_compress_struct *cinfo_ex = (JpegEncoder_jpeg_compress_struct *)cinfo;
-
+	if(cinfo_ex->sink != NULL) {
+		if(cinfo_ex->is_sink_full) {
+			// data is discarded.
+			cinfo_ex->sink->is_overflow = true;
+		}
+		else {
+			// reserved memory is full.
+			ttLibC_EncodeSink_commit(cinfo_ex->sink, cinfo_ex->sink_size);
+		}
+		JpegEncoder_reserveSink(cinfo_ex);
+		return true;
+	}
 	ttLibC_DynamicBuffer_append(cinfo_ex->buffer, cinfo_ex->data, cinfo_ex->data_size);
 	cinfo->dest->next_output_byte = cinfo_ex->data;
 	cinfo->dest->free_in_buffer = cinfo_ex->data_size;
@@ -59,6 +137,329 @@ static void ttLibC_JpegEncoder_term_buffer(j_compress_ptr cinfo) {
 	(void)cinfo;
 }
 
+/*
+ * expand one luma row. 16->235 -> 0-255
+ * padding area is filled with the last pixel.
+ */
+static void JpegEncoder_expandY(
+		uint8_t *dst,
+		const uint8_t *src,
+		uint32_t src_step,
+		uint32_t width,
+		uint32_t padded_width) {
+	uint32_t i = 0;
+	if(src_step == 1) {
+#if defined(JPEGENCODER_USE_SSE2)
+		// (y * 1197) >> 6 == ((y << 8) * 4788) >> 16, fit in 16bit mulhi.
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i mul  = _mm_set1_epi16(4788);
+		const __m128i sub  = _mm_set1_epi16(299);
+		for(;i + 16 <= width;i += 16) {
+			__m128i v  = _mm_loadu_si128((const __m128i *)(src + i));
+			__m128i lo = _mm_unpacklo_epi8(zero, v);
+			__m128i hi = _mm_unpackhi_epi8(zero, v);
+			lo = _mm_srai_epi16(_mm_sub_epi16(_mm_mulhi_epu16(lo, mul), sub), 4);
+			hi = _mm_srai_epi16(_mm_sub_epi16(_mm_mulhi_epu16(hi, mul), sub), 4);
+			_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+		}
+#elif defined(JPEGENCODER_USE_NEON)
+		const uint16x4_t mul = vdup_n_u16(1197);
+		const int16x8_t  sub = vdupq_n_s16(299);
+		for(;i + 16 <= width;i += 16) {
+			uint8x16_t v = vld1q_u8(src + i);
+			uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+			uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+			int16x8_t slo = vreinterpretq_s16_u16(vcombine_u16(
+					vshrn_n_u32(vmull_u16(vget_low_u16(lo), mul), 6),
+					vshrn_n_u32(vmull_u16(vget_high_u16(lo), mul), 6)));
+			int16x8_t shi = vreinterpretq_s16_u16(vcombine_u16(
+					vshrn_n_u32(vmull_u16(vget_low_u16(hi), mul), 6),
+					vshrn_n_u32(vmull_u16(vget_high_u16(hi), mul), 6)));
+			slo = vshrq_n_s16(vsubq_s16(slo, sub), 4);
+			shi = vshrq_n_s16(vsubq_s16(shi, sub), 4);
+			vst1q_u8(dst + i, vcombine_u8(vqmovun_s16(slo), vqmovun_s16(shi)));
+		}
+#endif
+	}
+	int32_t y;
+	for(;i < width;++ i) {
+		y = (((((int32_t)src[i * src_step]) * 1197) >> 6) - 299) >> 4;
+		dst[i] = y > 255 ? 255 : y < 0 ? 0 : y;
+	}
+	if(width < padded_width) {
+		memset(dst + width, dst[width - 1], padded_width - width);
+	}
+}
+
+/*
+ * copy one chroma row.
+ * padding area is filled with the last pixel.
+ */
+static void JpegEncoder_copyC(
+		uint8_t *dst,
+		const uint8_t *src,
+		uint32_t src_step,
+		uint32_t width,
+		uint32_t padded_width) {
+	if(src_step == 1) {
+		memcpy(dst, src, width);
+	}
+	else {
+		for(uint32_t i = 0;i < width;++ i) {
+			dst[i] = src[i * src_step];
+		}
+	}
+	if(width < padded_width) {
+		memset(dst + width, dst[width - 1], padded_width - width);
+	}
+}
+
+/*
+ * make the rows of one mcu row in full range.
+ * lines out of picture repeat the last line.
+ */
+static void JpegEncoder_fillRows(
+		ttLibC_JpegEncoder_ *encoder,
+		JpegEncoder_jpeg_compress_struct *strip,
+		ttLibC_Yuv420 *yuv,
+		uint32_t mcu_top) {
+	uint32_t width  = encoder->inherit_super.width;
+	uint32_t height = encoder->inherit_super.height;
+	uint32_t half_width  = ((width + 1) >> 1);
+	uint32_t half_height = ((height + 1) >> 1);
+	for(uint32_t i = 0;i < 16;++ i) {
+		uint32_t line = mcu_top + i;
+		if(line >= height) {
+			line = height - 1;
+		}
+		JpegEncoder_expandY(
+				strip->y_rows + encoder->y_row_stride * i,
+				yuv->y_data + yuv->y_stride * line,
+				yuv->y_step,
+				width,
+				encoder->y_row_stride);
+	}
+	for(uint32_t i = 0;i < 8;++ i) {
+		uint32_t line = (mcu_top >> 1) + i;
+		if(line >= half_height) {
+			line = half_height - 1;
+		}
+		JpegEncoder_copyC(
+				strip->u_rows + encoder->c_row_stride * i,
+				yuv->u_data + yuv->u_stride * line,
+				yuv->u_step,
+				half_width,
+				encoder->c_row_stride);
+		JpegEncoder_copyC(
+				strip->v_rows + encoder->c_row_stride * i,
+				yuv->v_data + yuv->v_stride * line,
+				yuv->v_step,
+				half_width,
+				encoder->c_row_stride);
+	}
+}
+
+/*
+ * encode one strip into strip->buffer, or strip->sink if set.
+ */
+static bool JpegEncoder_encodeStrip(
+		ttLibC_JpegEncoder_ *encoder,
+		JpegEncoder_jpeg_compress_struct *strip,
+		ttLibC_Yuv420 *yuv) {
+	if(strip->sink != NULL) {
+		strip->is_sink_full = false;
+		JpegEncoder_reserveSink(strip);
+	}
+	else {
+		ttLibC_DynamicBuffer_empty(strip->buffer);
+		strip->dmgr.next_output_byte = strip->data;
+		strip->dmgr.free_in_buffer = strip->data_size;
+	}
+	JSAMPROW y[16], cb[8], cr[8];
+	JSAMPARRAY planes[3];
+	planes[0] = y;
+	planes[1] = cb;
+	planes[2] = cr;
+	for(int i = 0;i < 16;++ i) {
+		y[i] = strip->y_rows + encoder->y_row_stride * i;
+	}
+	for(int i = 0;i < 8;++ i) {
+		cb[i] = strip->u_rows + encoder->c_row_stride * i;
+		cr[i] = strip->v_rows + encoder->c_row_stride * i;
+	}
+	jpeg_start_compress(&strip->cinfo, true);
+	for(uint32_t j = 0;j < strip->height;j += 16) {
+		JpegEncoder_fillRows(encoder, strip, yuv, strip->top + j);
+		jpeg_write_raw_data(&strip->cinfo, planes, 16);
+	}
+	jpeg_finish_compress(&strip->cinfo);
+	if(strip->sink != NULL) {
+		size_t size = strip->cinfo.dest->next_output_byte - strip->sink_data;
+		if(strip->is_sink_full) {
+			if(size != 0) {
+				strip->sink->is_overflow = true;
+			}
+		}
+		else {
+			ttLibC_EncodeSink_commit(strip->sink, size);
+		}
+		return !strip->sink->is_overflow;
+	}
+	return ttLibC_DynamicBuffer_append(strip->buffer,
+		strip->data,
+		strip->cinfo.dest->next_output_byte - strip->data);
+}
+
+/*
+ * worker thread for strips except the first one.
+ */
+static void *JpegEncoder_workerThread(void *ptr) {
+	JpegEncoder_jpeg_compress_struct *strip = (JpegEncoder_jpeg_compress_struct *)ptr;
+	ttLibC_JpegEncoder_ *encoder = (ttLibC_JpegEncoder_ *)strip->encoder;
+	uint64_t generation = 0;
+	pthread_mutex_lock(&encoder->mutex);
+	while(true) {
+		while(encoder->generation == generation && !encoder->is_closing) {
+			pthread_cond_wait(&encoder->start_cond, &encoder->mutex);
+		}
+		if(encoder->is_closing) {
+			break;
+		}
+		generation = encoder->generation;
+		pthread_mutex_unlock(&encoder->mutex);
+		strip->is_success = JpegEncoder_encodeStrip(encoder, strip, encoder->yuv);
+		pthread_mutex_lock(&encoder->mutex);
+		if(-- encoder->running_num == 0) {
+			pthread_cond_signal(&encoder->done_cond);
+		}
+	}
+	pthread_mutex_unlock(&encoder->mutex);
+	return NULL;
+}
+
+/*
+ * find the end of header (just after SOS segment).
+ * @param data    jpeg binary
+ * @param size    size of data
+ * @param sof_pos position of SOF marker.
+ * @return size of header, 0 for error.
+ */
+static size_t JpegEncoder_parseHeader(
+		uint8_t *data,
+		size_t size,
+		size_t *sof_pos) {
+	if(size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+		return 0;
+	}
+	size_t pos = 2;
+	while(pos + 4 <= size) {
+		if(data[pos] != 0xFF) {
+			return 0;
+		}
+		uint8_t marker = data[pos + 1];
+		size_t length = (data[pos + 2] << 8) | data[pos + 3];
+		if(marker >= 0xC0 && marker <= 0xC2) {
+			*sof_pos = pos;
+		}
+		pos += 2 + length;
+		if(marker == 0xDA) {
+			return pos <= size ? pos : 0;
+		}
+	}
+	return 0;
+}
+
+/*
+ * stitch strips into one jpeg.
+ * every strip is one restart interval, so the entropy data of each strip
+ * can be connected with RSTn marker. header is taken from the first strip,
+ * and the height in SOF is updated for whole picture.
+ */
+static bool JpegEncoder_stitch(
+		ttLibC_JpegEncoder_ *encoder,
+		ttLibC_EncodeSink *sink) {
+	for(uint32_t i = 0;i < encoder->strip_num;++ i) {
+		uint8_t *data = ttLibC_DynamicBuffer_refData(encoder->strips[i].buffer);
+		size_t size = ttLibC_DynamicBuffer_refSize(encoder->strips[i].buffer);
+		size_t sof_pos = 0;
+		size_t header_size = JpegEncoder_parseHeader(data, size, &sof_pos);
+		if(header_size == 0 || sof_pos == 0 || size < header_size + 2) {
+			ERR_PRINT("failed to find scan data of strip.");
+			return false;
+		}
+		if(i == 0) {
+			uint8_t *sof = data + sof_pos;
+			sof[5] = (encoder->inherit_super.height >> 8) & 0xFF;
+			sof[6] = encoder->inherit_super.height & 0xFF;
+			ttLibC_EncodeSink_append(sink, data, header_size);
+		}
+		else {
+			uint8_t rst[2] = {0xFF, 0xD0 + ((i - 1) & 0x07)};
+			ttLibC_EncodeSink_append(sink, rst, 2);
+		}
+		// strip EOI is dropped.
+		ttLibC_EncodeSink_append(sink, data + header_size, size - header_size - 2);
+	}
+	uint8_t eoi[2] = {0xFF, 0xD9};
+	return ttLibC_EncodeSink_append(sink, eoi, 2);
+}
+
+/*
+ * setup compress context for strip.
+ */
+static bool JpegEncoder_setupStrip(
+		ttLibC_JpegEncoder_ *encoder,
+		JpegEncoder_jpeg_compress_struct *strip,
+		uint32_t top,
+		uint32_t height,
+		uint32_t restart_interval) {
+	strip->encoder = encoder;
+	strip->top = top;
+	strip->height = height;
+	strip->data_size = 65536;
+	strip->data = ttLibC_malloc(strip->data_size);
+	strip->buffer = ttLibC_DynamicBuffer_make();
+	strip->y_rows = ttLibC_malloc(encoder->y_row_stride * 16);
+	strip->u_rows = ttLibC_malloc(encoder->c_row_stride * 8);
+	strip->v_rows = ttLibC_malloc(encoder->c_row_stride * 8);
+	if(strip->data == NULL
+	|| strip->buffer == NULL
+	|| strip->y_rows == NULL
+	|| strip->u_rows == NULL
+	|| strip->v_rows == NULL) {
+		ERR_PRINT("failed to alloc memory.");
+		return false;
+	}
+	strip->cinfo.err = jpeg_std_error(&strip->jerr);
+	jpeg_create_compress(&strip->cinfo);
+	strip->cinfo.image_width = encoder->inherit_super.width;
+	strip->cinfo.image_height = height;
+	strip->cinfo.input_components = 3;
+	jpeg_set_defaults(&strip->cinfo);
+	strip->cinfo.dct_method = JDCT_FLOAT;
+	jpeg_set_colorspace(&strip->cinfo, JCS_YCbCr);
+	strip->cinfo.raw_data_in = true;
+	strip->cinfo.comp_info[0].h_samp_factor = 2;
+	strip->cinfo.comp_info[0].v_samp_factor = 2;
+	strip->cinfo.comp_info[1].h_samp_factor = 1;
+	strip->cinfo.comp_info[1].v_samp_factor = 1;
+	strip->cinfo.comp_info[2].h_samp_factor = 1;
+	strip->cinfo.comp_info[2].v_samp_factor = 1;
+	// strips must share the same huffman table, optimize only for single strip.
+	strip->cinfo.optimize_coding = (restart_interval == 0);
+	strip->cinfo.restart_interval = restart_interval;
+	jpeg_set_quality(&strip->cinfo, encoder->inherit_super.quality, true);
+#if JPEG_LIB_VERSION >= 70
+	strip->cinfo.do_fancy_downsampling = false;
+#endif
+	strip->dmgr.init_destination    = ttLibC_JpegEncoder_init_buffer;
+	strip->dmgr.empty_output_buffer = ttLibC_JpegEncoder_empty_buffer;
+	strip->dmgr.term_destination    = ttLibC_JpegEncoder_term_buffer;
+
+	strip->cinfo.dest = &strip->dmgr;
+	return true;
+}
+
 /*
  * make jpeg encoder
  * @param width   target width
@@ -70,60 +471,170 @@ ttLibC_JpegEncoder TT_VISIBILITY_DEFAULT *ttLibC_JpegEncoder_make(
 		uint32_t width,
 		uint32_t height,
 		uint32_t quality) {
+	return ttLibC_JpegEncoder_makeWithThread(width, height, quality, 1);
+}
+
+/*
+ * make jpeg encoder, which encode horizontal strips in parallel.
+ * @param width      target width
+ * @param height     target height
+ * @param quality    target quality 0 - 100 100 is best quality.
+ * @param thread_num number of strips(threads). 1 for single thread.
+ * @return jpegEncoder object.
+ */
+ttLibC_JpegEncoder TT_VISIBILITY_DEFAULT *ttLibC_JpegEncoder_makeWithThread(
+		uint32_t width,
+		uint32_t height,
+		uint32_t quality,
+		uint32_t thread_num) {
+	if(width == 0 || height == 0) {
+		ERR_PRINT("invalid size:%d x %d", width, height);
+		return NULL;
+	}
 	ttLibC_JpegEncoder_ *encoder = (ttLibC_JpegEncoder_ *)ttLibC_malloc(sizeof(ttLibC_JpegEncoder_));
 	if(encoder == NULL) {
 		ERR_PRINT("failed to alloc encoder object.");
 		return NULL;
 	}
-	encoder->cinfo.data_size = 65536;
-	encoder->cinfo.data = ttLibC_malloc(encoder->cinfo.data_size);
-	if(encoder->cinfo.data == NULL) {
-		ttLibC_free(encoder);
-		ERR_PRINT("failed to alloc memory.");
-		return NULL;
+	memset(encoder, 0, sizeof(ttLibC_JpegEncoder_));
+	encoder->inherit_super.width = width;
+	encoder->inherit_super.height = height;
+	encoder->inherit_super.quality = quality;
+	encoder->y_row_stride = ((width + 15) & ~15);
+	encoder->c_row_stride = ((((width + 1) >> 1) + 15) & ~15);
+
+	// decide strips, each strip is multiple of mcu rows.
+	uint32_t mcu_cols = (width + 15) >> 4;
+	uint32_t mcu_rows = (height + 15) >> 4;
+	if(thread_num == 0) {
+		thread_num = 1;
+	}
+	if(thread_num > mcu_rows) {
+		thread_num = mcu_rows;
 	}
-	encoder->cinfo.buffer = ttLibC_DynamicBuffer_make();
-	if(encoder->cinfo.buffer == NULL) {
-		ttLibC_free(encoder->cinfo.data);
+	uint32_t strip_rows = (mcu_rows + thread_num - 1) / thread_num;
+	// restart interval is 16bit.
+	if(strip_rows * mcu_cols > 65535) {
+		strip_rows = 65535 / mcu_cols;
+	}
+	uint32_t strip_num = (mcu_rows + strip_rows - 1) / strip_rows;
+	encoder->strips = ttLibC_malloc(sizeof(JpegEncoder_jpeg_compress_struct) * strip_num);
+	if(encoder->strips == NULL) {
+		ERR_PRINT("failed to alloc strips.");
 		ttLibC_free(encoder);
-		ERR_PRINT("failed to alloc dynamicBuffer.");
 		return NULL;
 	}
-
-	encoder->cinfo.cinfo.err = jpeg_std_error(&encoder->jerr);
-	jpeg_create_compress(&encoder->cinfo.cinfo);
-	encoder->cinfo.cinfo.image_width = width;
-	encoder->cinfo.cinfo.image_height = height;
-	encoder->cinfo.cinfo.input_components = 3;
-	jpeg_set_defaults(&encoder->cinfo.cinfo);
-	encoder->cinfo.cinfo.dct_method = JDCT_FLOAT;
-	jpeg_set_colorspace(&encoder->cinfo.cinfo, JCS_YCbCr);
-	encoder->cinfo.cinfo.raw_data_in = true;
-	encoder->cinfo.cinfo.comp_info[0].h_samp_factor = 2;
-	encoder->cinfo.cinfo.comp_info[0].v_samp_factor = 2;
-	encoder->cinfo.cinfo.comp_info[1].h_samp_factor = 1;
-	encoder->cinfo.cinfo.comp_info[1].v_samp_factor = 1;
-	encoder->cinfo.cinfo.comp_info[2].h_samp_factor = 1;
-	encoder->cinfo.cinfo.comp_info[2].v_samp_factor = 1;
-	encoder->cinfo.cinfo.optimize_coding = true;
-	jpeg_set_quality(&encoder->cinfo.cinfo, quality, true);
-#if JPEG_LIB_VERSION >= 70
-	encoder->cinfo.cinfo.do_fancy_downsampling = false;
-#endif
-	encoder->dmgr.init_destination    = ttLibC_JpegEncoder_init_buffer;
-	encoder->dmgr.empty_output_buffer = ttLibC_JpegEncoder_empty_buffer;
-	encoder->dmgr.term_destination    = ttLibC_JpegEncoder_term_buffer;
-
-	encoder->cinfo.cinfo.dest = &encoder->dmgr;
-
+	memset(encoder->strips, 0, sizeof(JpegEncoder_jpeg_compress_struct) * strip_num);
+	encoder->strip_num = strip_num;
+	pthread_mutex_init(&encoder->mutex, NULL);
+	pthread_cond_init(&encoder->start_cond, NULL);
+	pthread_cond_init(&encoder->done_cond, NULL);
+	encoder->inherit_super.thread_num = strip_num;
+	for(uint32_t i = 0;i < strip_num;++ i) {
+		uint32_t top = i * strip_rows * 16;
+		uint32_t strip_height = height - top;
+		if(strip_height > strip_rows * 16) {
+			strip_height = strip_rows * 16;
+		}
+		if(!JpegEncoder_setupStrip(
+				encoder,
+				&encoder->strips[i],
+				top,
+				strip_height,
+				strip_num == 1 ? 0 : strip_rows * mcu_cols)) {
+			ttLibC_JpegEncoder_close((ttLibC_JpegEncoder **)&encoder);
+			return NULL;
+		}
+	}
+	if(strip_num > 1) {
+		encoder->buffer = ttLibC_DynamicBuffer_make();
+		encoder->buffer_sink = ttLibC_EncodeSink_makeBuffer(encoder->buffer, EncodeSinkNalFormat_annexB);
+		if(encoder->buffer == NULL || encoder->buffer_sink == NULL) {
+			ERR_PRINT("failed to alloc dynamicBuffer.");
+			ttLibC_JpegEncoder_close((ttLibC_JpegEncoder **)&encoder);
+			return NULL;
+		}
+		for(uint32_t i = 1;i < strip_num;++ i) {
+			if(pthread_create(&encoder->strips[i].thread, NULL, JpegEncoder_workerThread, &encoder->strips[i]) != 0) {
+				ERR_PRINT("failed to start thread.");
+				ttLibC_JpegEncoder_close((ttLibC_JpegEncoder **)&encoder);
+				return NULL;
+			}
+			encoder->strips[i].is_thread_running = true;
+		}
+	}
 	encoder->jpeg = NULL;
-	encoder->fullrange_yuv = NULL;
-	encoder->inherit_super.width = width;
-	encoder->inherit_super.height = height;
-	encoder->inherit_super.quality = quality;
 	return (ttLibC_JpegEncoder *)encoder;
 }
 
+/*
+ * check the input yuv.
+ */
+static bool JpegEncoder_checkYuv(
+		ttLibC_JpegEncoder_ *encoder,
+		ttLibC_Yuv420 *yuv) {
+	switch(yuv->type) {
+	case Yuv420Type_planar:
+	case Yvu420Type_planar:
+		break;
+	case Yuv420Type_semiPlanar:
+	case Yvu420Type_semiPlanar:
+		ERR_PRINT("only support planar.");
+		return false;
+	}
+	if(yuv->inherit_super.width != encoder->inherit_super.width
+	|| yuv->inherit_super.height != encoder->inherit_super.height) {
+		ERR_PRINT("size is not match with encoder.");
+		return false;
+	}
+	return true;
+}
+
+/*
+ * encode all strips, and stitch them into sink.
+ * @param sink output sink. NULL for internal buffer.
+ */
+static bool JpegEncoder_encodeYuv(
+		ttLibC_JpegEncoder_ *encoder,
+		ttLibC_Yuv420 *yuv,
+		ttLibC_EncodeSink *sink) {
+	if(encoder->strip_num == 1) {
+		encoder->strips[0].sink = sink;
+		bool result = JpegEncoder_encodeStrip(encoder, &encoder->strips[0], yuv);
+		encoder->strips[0].sink = NULL;
+		if(!result) {
+			ERR_PRINT("failed to encode.");
+		}
+		return result;
+	}
+	pthread_mutex_lock(&encoder->mutex);
+	encoder->yuv = yuv;
+	encoder->running_num = encoder->strip_num - 1;
+	++ encoder->generation;
+	pthread_cond_broadcast(&encoder->start_cond);
+	pthread_mutex_unlock(&encoder->mutex);
+	// first strip on this thread.
+	encoder->strips[0].is_success = JpegEncoder_encodeStrip(encoder, &encoder->strips[0], yuv);
+	pthread_mutex_lock(&encoder->mutex);
+	while(encoder->running_num != 0) {
+		pthread_cond_wait(&encoder->done_cond, &encoder->mutex);
+	}
+	encoder->yuv = NULL;
+	pthread_mutex_unlock(&encoder->mutex);
+	for(uint32_t i = 0;i < encoder->strip_num;++ i) {
+		if(!encoder->strips[i].is_success) {
+			ERR_PRINT("failed to encode strip:%d", i);
+			return false;
+		}
+	}
+	if(sink == NULL) {
+		ttLibC_DynamicBuffer_empty(encoder->buffer);
+		ttLibC_EncodeSink_reset(encoder->buffer_sink);
+		sink = encoder->buffer_sink;
+	}
+	return JpegEncoder_stitch(encoder, sink);
+}
+
 /*
  * encode frame.
  * @param encoder  jpeg encoder object.
@@ -137,134 +648,38 @@ bool TT_VISIBILITY_DEFAULT ttLibC_JpegEncoder_encode(
 		ttLibC_Yuv420 *yuv,
 		ttLibC_JpegEncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	if(encoder == NULL) {
 		return false;
 	}
 	if(yuv == NULL) {
 		return true;
 	}
-	switch(yuv->type) {
-	case Yuv420Type_planar:
-	case Yvu420Type_planar:
-		break;
-	case Yuv420Type_semiPlanar:
-	case Yvu420Type_semiPlanar:
-		ERR_PRINT("only support planar.");
-		return false;
-	}
-
 	ttLibC_JpegEncoder_ *encoder_ = (ttLibC_JpegEncoder_ *)encoder;
-	uint32_t width = encoder_->inherit_super.width;
-	uint32_t height = encoder_->inherit_super.height;
-	ttLibC_Yuv420 *fullrange_yuv = ttLibC_Yuv420_makeEmptyFrame2(
-			encoder_->fullrange_yuv,
-			Yuv420Type_planar,
-			width,
-			height);
-	if(fullrange_yuv == NULL) {
-		ERR_PRINT("failed to make full range frame");
+	if(!JpegEncoder_checkYuv(encoder_, yuv)) {
 		return false;
 	}
-	encoder_->fullrange_yuv = fullrange_yuv;
-	// 16->235 -> 0-255
-	uint8_t *y_dst = fullrange_yuv->y_data;
-	uint8_t *y_src = yuv->y_data;
-	for(uint32_t i = 0;i < height;++ i) {
-		uint8_t *yd = y_dst;
-		uint8_t *ys = y_src;
-		int32_t y;
-		for(uint32_t j = 0;j < width;++ j) {
-			y = (((((*ys) * 1197) >> 6) - 299) >> 4);
-			*yd = y > 255 ? 255 : y < 0 ? 0 : y;
-			yd += fullrange_yuv->y_step;
-			ys += yuv->y_step;
-		}
-		for(uint32_t j = width;j < fullrange_yuv->y_stride;++ j) {
-			*yd = y > 255 ? 255 : y < 0 ? 0 : y;
-			yd += fullrange_yuv->y_step;
-		}
-		y_dst += fullrange_yuv->y_stride;
-		y_src += yuv->y_stride;
+	// do convert.
+	if(!JpegEncoder_encodeYuv(encoder_, yuv, NULL)) {
+		return false;
 	}
-	uint32_t half_width  = ((width + 1) >> 1);
-	uint32_t half_height = ((height + 1) >> 1);
-	uint8_t *u_dst = fullrange_yuv->u_data;
-	uint8_t *v_dst = fullrange_yuv->v_data;
-	uint8_t *u_src = yuv->u_data;
-	uint8_t *v_src = yuv->v_data;
-	for(uint32_t i = 0;i < half_height;++ i) {
-		uint8_t *ud = u_dst;
-		uint8_t *us = u_src;
-		uint8_t *vd = v_dst;
-		uint8_t *vs = v_src;
-		uint8_t u, v;
-		for(uint32_t j = 0;j < half_width;++ j) {
-			u = *us;
-			v = *vs;
-			*ud = u;
-			*vd = v;
-			ud += fullrange_yuv->u_step;
-			us += yuv->u_step;
-			vd += fullrange_yuv->v_step;
-			vs += yuv->v_step;
-		}
-		for(uint32_t j = half_width;j < fullrange_yuv->u_stride;++ j) {
-			*ud = u;
-			ud += fullrange_yuv->u_step;
-		}
-		for(uint32_t j = half_width;j < fullrange_yuv->v_stride;++ j) {
-			*vd = v;
-			vd += fullrange_yuv->v_step;
-		}
-		u_dst += fullrange_yuv->u_stride;
-		u_src += yuv->u_stride;
-		v_dst += fullrange_yuv->v_stride;
-		v_src += yuv->v_stride;
+	uint8_t *data = NULL;
+	size_t data_size = 0;
+	if(encoder_->strip_num == 1) {
+		data      = ttLibC_DynamicBuffer_refData(encoder_->strips[0].buffer);
+		data_size = ttLibC_DynamicBuffer_refSize(encoder_->strips[0].buffer);
 	}
-	// do convert.
-	ttLibC_DynamicBuffer_empty(encoder_->cinfo.buffer);
-	encoder_->dmgr.next_output_byte = encoder_->cinfo.data;
-	encoder_->dmgr.free_in_buffer = encoder_->cinfo.data_size;
-	JSAMPROW y[16], cb[16], cr[16];
-	JSAMPARRAY planes[3];
-	planes[0] = y;
-	planes[1] = cb;
-	planes[2] = cr;
-	jpeg_start_compress(&encoder_->cinfo.cinfo, true);
-	for(uint32_t j = 0;j < height;j += 16) {
-		int max = yuv->inherit_super.height - j;
-		if(max >= 16) {
-			max = 16;
-		}
-		for(int i = 0;i < 16;i ++) {
-			if(i >= max) {
-				y[i] = fullrange_yuv->y_data;
-				if((i & 0x01) == 0) {
-					cb[(i >> 1)] = fullrange_yuv->u_data;
-					cr[(i >> 1)] = fullrange_yuv->v_data;
-				}
-			}
-			else {
-				y[i] = fullrange_yuv->y_data + fullrange_yuv->y_stride * (i + j);
-				if((i & 0x01) == 0) {
-					cb[(i >> 1)] = fullrange_yuv->u_data + ((fullrange_yuv->u_stride * (i + j)) >> 1);
-					cr[(i >> 1)] = fullrange_yuv->v_data + ((fullrange_yuv->v_stride * (i + j)) >> 1);
-				}
-			}
-		}
-		jpeg_write_raw_data(&encoder_->cinfo.cinfo, planes, 16);
+	else {
+		data      = ttLibC_DynamicBuffer_refData(encoder_->buffer);
+		data_size = ttLibC_DynamicBuffer_refSize(encoder_->buffer);
 	}
-	jpeg_finish_compress(&encoder_->cinfo.cinfo);
-	ttLibC_DynamicBuffer_append(encoder_->cinfo.buffer,
-		encoder_->cinfo.data,
-		encoder_->cinfo.cinfo.dest->next_output_byte - encoder_->cinfo.data);
 
 	ttLibC_Jpeg *jpeg = ttLibC_Jpeg_make(
 		encoder_->jpeg,
 		encoder_->inherit_super.width,
 		encoder_->inherit_super.height,
-		ttLibC_DynamicBuffer_refData(encoder_->cinfo.buffer),
-		ttLibC_DynamicBuffer_refSize(encoder_->cinfo.buffer),
+		data,
+		data_size,
 		true,
 		yuv->inherit_super.inherit_super.pts,
 		yuv->inherit_super.inherit_super.timebase);
@@ -282,6 +697,46 @@ bool TT_VISIBILITY_DEFAULT ttLibC_JpegEncoder_encode(
 	return true;
 }
 
+/*
+ * encode frame into sink.
+ * in single strip mode, libjpeg writes on the sink memory directly.
+ * @param encoder  jpeg encoder object.
+ * @param yuv420   source yuv420 data
+ * @param sink     output sink.
+ * @param callback callback func for each unit. can be NULL.
+ * @param ptr      pointer for user def value, which will call in callback.
+ * @return true / false
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_JpegEncoder_encodeToSink(
+		ttLibC_JpegEncoder *encoder,
+		ttLibC_Yuv420 *yuv,
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
+	if(encoder == NULL || sink == NULL) {
+		return false;
+	}
+	if(yuv == NULL) {
+		return true;
+	}
+	ttLibC_JpegEncoder_ *encoder_ = (ttLibC_JpegEncoder_ *)encoder;
+	if(!JpegEncoder_checkYuv(encoder_, yuv)) {
+		return false;
+	}
+	ttLibC_EncodeSink_beginUnit(sink);
+	if(!JpegEncoder_encodeYuv(encoder_, yuv, sink)) {
+		return false;
+	}
+	sink->frame_type = frameType_jpeg;
+	sink->is_key     = true;
+	sink->is_config  = false;
+	sink->pts        = yuv->inherit_super.inherit_super.pts;
+	sink->timebase   = yuv->inherit_super.inherit_super.timebase;
+	sink->id         = yuv->inherit_super.inherit_super.id;
+	return ttLibC_EncodeSink_endUnit(sink, callback, ptr);
+}
+
 /**
  * update jpeg quality.
  * @param encoder jpeg encoder object.
@@ -295,7 +750,10 @@ bool TT_VISIBILITY_DEFAULT ttLibC_JpegEncoder_setQuality(
 		return false;
 	}
 	ttLibC_JpegEncoder_ *encoder_ = (ttLibC_JpegEncoder_ *)encoder;
-	jpeg_set_quality(&encoder_->cinfo.cinfo, quality, true);
+	for(uint32_t i = 0;i < encoder_->strip_num;++ i) {
+		jpeg_set_quality(&encoder_->strips[i].cinfo, quality, true);
+	}
+	encoder_->inherit_super.quality = quality;
 	return true;
 }
 
@@ -308,12 +766,38 @@ void TT_VISIBILITY_DEFAULT ttLibC_JpegEncoder_close(ttLibC_JpegEncoder **encoder
 	if(target == NULL) {
 		return;
 	}
-	jpeg_destroy_compress(&target->cinfo.cinfo);
-	if(target->cinfo.data) {
-		ttLibC_free(target->cinfo.data);
+	pthread_mutex_lock(&target->mutex);
+	target->is_closing = true;
+	pthread_cond_broadcast(&target->start_cond);
+	pthread_mutex_unlock(&target->mutex);
+	for(uint32_t i = 0;i < target->strip_num;++ i) {
+		JpegEncoder_jpeg_compress_struct *strip = &target->strips[i];
+		if(strip->is_thread_running) {
+			pthread_join(strip->thread, NULL);
+		}
+		if(strip->cinfo.err != NULL) {
+			jpeg_destroy_compress(&strip->cinfo);
+		}
+		if(strip->data) {
+			ttLibC_free(strip->data);
+		}
+		if(strip->y_rows) {
+			ttLibC_free(strip->y_rows);
+		}
+		if(strip->u_rows) {
+			ttLibC_free(strip->u_rows);
+		}
+		if(strip->v_rows) {
+			ttLibC_free(strip->v_rows);
+		}
+		ttLibC_DynamicBuffer_close(&strip->buffer);
 	}
-	ttLibC_DynamicBuffer_close(&target->cinfo.buffer);
-	ttLibC_Yuv420_close(&target->fullrange_yuv);
+	ttLibC_free(target->strips);
+	pthread_cond_destroy(&target->start_cond);
+	pthread_cond_destroy(&target->done_cond);
+	pthread_mutex_destroy(&target->mutex);
+	ttLibC_EncodeSink_close(&target->buffer_sink);
+	ttLibC_DynamicBuffer_close(&target->buffer);
 	ttLibC_Jpeg_close(&target->jpeg);
 	ttLibC_free(target);
 	*encoder = NULL;
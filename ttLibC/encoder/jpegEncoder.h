@@ -17,6 +17,7 @@ extern "C" {
 
 #include "../frame/video/jpeg.h"
 #include "../frame/video/yuv420.h"
+#include "encodeSink.h"
 
 /**
  * jpeg encoder definition
@@ -25,6 +26,8 @@ typedef struct ttLibC_Encoder_JpegEncoder {
 	uint32_t width;
 	uint32_t height;
 	uint32_t quality;
+	/** number of strips encoded in parallel. 1 for single thread. */
+	uint32_t thread_num;
 } ttLibC_Encoder_JpegEncoder;
 
 typedef ttLibC_Encoder_JpegEncoder ttLibC_JpegEncoder;
@@ -48,6 +51,22 @@ ttLibC_JpegEncoder *ttLibC_JpegEncoder_make(
 		uint32_t height,
 		uint32_t quality);
 
+/**
+ * make jpeg encoder, which encode horizontal strips in parallel.
+ * each strip is one restart interval, and strips are stitched with RSTn marker
+ * into one baseline jpeg. huffman table is not optimized in this mode.
+ * @param width      target width
+ * @param height     target height
+ * @param quality    target quality 0 - 100 100 is best quality.
+ * @param thread_num number of strips(threads). 1 for single thread.
+ * @return jpegEncoder object.
+ */
+ttLibC_JpegEncoder *ttLibC_JpegEncoder_makeWithThread(
+		uint32_t width,
+		uint32_t height,
+		uint32_t quality,
+		uint32_t thread_num);
+
 /**
  * encode frame.
  * @param encoder  jpeg encoder object.
@@ -61,6 +80,23 @@ bool ttLibC_JpegEncoder_encode(
 		ttLibC_JpegEncodeFunc callback,
 		void *ptr);
 
+/**
+ * encode frame into sink.
+ * in single strip mode, libjpeg writes on the sink memory directly.
+ * @param encoder  jpeg encoder object.
+ * @param yuv      source yuv420 data
+ * @param sink     output sink.
+ * @param callback callback func for each unit. can be NULL.
+ * @param ptr      pointer for user def value, which will call in callback.
+ * @return true / false
+ */
+bool ttLibC_JpegEncoder_encodeToSink(
+		ttLibC_JpegEncoder *encoder,
+		ttLibC_Yuv420 *yuv,
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr);
+
 /**
  * update jpeg quality.
  * @param encoder jpeg encoder object.
@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../frame/audio/pcms16.h"
 
 #include <windows.h>
@@ -117,6 +118,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_MsAacEncoder_encode(
 		ttLibC_PcmS16 *pcm,
 		ttLibC_MsAacEncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	HRESULT hr = S_OK;
 	if(pcm == NULL) {
 		return true;
@@ -13,6 +13,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/hexUtil.h"
 
 #include <windows.h>
@@ -508,6 +509,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_MsH264Encoder_encode(
 		ttLibC_Yuv420 *frame,
 		ttLibC_MsH264EncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	ttLibC_MsH264Encoder_ *encoder_ = (ttLibC_MsH264Encoder_ *)encoder;
 	if(encoder_ == NULL) {
 		return false;
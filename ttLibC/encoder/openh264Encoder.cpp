@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/dynamicBufferUtil.h"
 
 #include <wels/codec_api.h>
@@ -381,23 +382,43 @@ static bool Openh264Encoder_checkEncodedData(
 }
 
 /*
- * encode frame.
- * @param encoder  openh264 encoder object
- * @param yuv420   source yuv420 data.
- * @param callback callback func for h264 creation.
- * @param ptr      pointer for user def value, which will call in callback.
+ * write encoded data on sink.
+ * @param encoder  encoder object
+ * @param sink     output sink
+ * @param callback callback func for each unit
+ * @param ptr      user def data pointer
  */
-static bool Openh264Encoder_encode(
-		ttLibC_Openh264Encoder *encoder,
-		ttLibC_Yuv420 *yuv,
-		ttLibC_Openh264EncodeFunc callback,
+static bool Openh264Encoder_writeSink(
+		ttLibC_Openh264Encoder_ *encoder,
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
 		void *ptr) {
-	if(encoder == NULL) {
-		return false;
-	}
-	if(yuv == NULL) {
-		return true;
+	sink->pts      = encoder->info.uiTimeStamp;
+	sink->timebase = 1000;
+	sink->id       = encoder->id;
+	for(int i = 0;i < encoder->info.iLayerNum;++ i) {
+		const SLayerBSInfo& layerInfo = encoder->info.sLayerInfo[i];
+		uint8_t *buf = layerInfo.pBsBuf;
+		for(int j = 0;j < layerInfo.iNalCount;++ j) {
+			if(!ttLibC_EncodeSink_appendH264Nal(sink, buf, (size_t)layerInfo.pNalLengthInByte[j], callback, ptr)) {
+				ERR_PRINT("failed to write nal on sink.");
+				return false;
+			}
+			buf += layerInfo.pNalLengthInByte[j];
+		}
 	}
+	return ttLibC_EncodeSink_endH264(sink, callback, ptr);
+}
+
+/*
+ * encode picture with openh264, encoded data is held on info.
+ * @param encoder_ openh264 encoder object
+ * @param yuv      source yuv420 data.
+ * @return true / false
+ */
+static bool Openh264Encoder_encodePicture(
+		ttLibC_Openh264Encoder_ *encoder_,
+		ttLibC_Yuv420 *yuv) {
 	switch(yuv->type) {
 	case Yuv420Type_planar:
 	case Yvu420Type_planar:
@@ -407,7 +428,6 @@ static bool Openh264Encoder_encode(
 		ERR_PRINT("support only yuv420 planar.");
 		return false;
 	}
-	ttLibC_Openh264Encoder_ *encoder_ = (ttLibC_Openh264Encoder_ *)encoder;
 	encoder_->id = yuv->inherit_super.inherit_super.id;
 	encoder_->picture.iPicWidth    = yuv->inherit_super.width;
 	encoder_->picture.iPicHeight   = yuv->inherit_super.height;
@@ -435,6 +455,31 @@ static bool Openh264Encoder_encode(
 			encoder_->encoder->SetOption(ENCODER_OPTION_IDR_INTERVAL, &iIDRPeriod);
 		}
 	}
+	return true;
+}
+
+/*
+ * encode frame.
+ * @param encoder  openh264 encoder object
+ * @param yuv420   source yuv420 data.
+ * @param callback callback func for h264 creation.
+ * @param ptr      pointer for user def value, which will call in callback.
+ */
+static bool Openh264Encoder_encode(
+		ttLibC_Openh264Encoder *encoder,
+		ttLibC_Yuv420 *yuv,
+		ttLibC_Openh264EncodeFunc callback,
+		void *ptr) {
+	if(encoder == NULL) {
+		return false;
+	}
+	if(yuv == NULL) {
+		return true;
+	}
+	ttLibC_Openh264Encoder_ *encoder_ = (ttLibC_Openh264Encoder_ *)encoder;
+	if(!Openh264Encoder_encodePicture(encoder_, yuv)) {
+		return false;
+	}
 	return Openh264Encoder_checkEncodedData(encoder_, callback, ptr);
 }
 
@@ -587,10 +632,31 @@ bool TT_VISIBILITY_DEFAULT ttLibC_Openh264Encoder_encode(
 		ttLibC_Yuv420 *yuv420,
 		ttLibC_Openh264EncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	return Openh264Encoder_encode(
 			encoder, yuv420, callback, ptr);
 }
 
+bool TT_VISIBILITY_DEFAULT ttLibC_Openh264Encoder_encodeToSink(
+		ttLibC_Openh264Encoder *encoder,
+		ttLibC_Yuv420 *yuv420,
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
+	ttLibC_Openh264Encoder_ *encoder_ = (ttLibC_Openh264Encoder_ *)encoder;
+	if(encoder_ == NULL || sink == NULL) {
+		return false;
+	}
+	if(yuv420 == NULL) {
+		return true;
+	}
+	if(!Openh264Encoder_encodePicture(encoder_, yuv420)) {
+		return false;
+	}
+	return Openh264Encoder_writeSink(encoder_, sink, callback, ptr);
+}
+
 /*
  * ref liopenh264 native encoder object.
  * @param encoder openh264 encoder object.
@@ -17,6 +17,7 @@ extern "C" {
 
 #include "../frame/video/h264.h"
 #include "../frame/video/yuv420.h"
+#include "encodeSink.h"
 
 /**
  * openh264 encoder type
@@ -140,6 +141,24 @@ bool ttLibC_Openh264Encoder_encode(
 		ttLibC_Openh264EncodeFunc callback,
 		void *ptr);
 
+/**
+ * encode frame into sink.
+ * nal is written on sink directly with nal_format of sink, without making h264 frame.
+ * sps and pps make one config unit, sei is dropped.
+ * @param encoder  openh264 encoder object.
+ * @param yuv420   source yuv420 data.
+ * @param sink     output sink.
+ * @param callback callback func for each unit. can be NULL.
+ * @param ptr      pointer for user def value, which will call in callback.
+ * @return true / false
+ */
+bool ttLibC_Openh264Encoder_encodeToSink(
+		ttLibC_Openh264Encoder *encoder,
+		ttLibC_Yuv420 *yuv420,
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr);
+
 /**
  * ref liopenh264 native encoder object.
  * @param encoder openh264 encoder object.
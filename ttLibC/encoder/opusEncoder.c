@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -152,6 +153,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_OpusEncoder_encode(
 		ttLibC_PcmS16 *pcm,
 		ttLibC_OpusEncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	if(encoder == NULL) {
 		return false;
 	}
@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/hexUtil.h"
 #include "../util/ioUtil.h"
 #include <stdint.h>
@@ -174,6 +175,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_SpeexEncoder_encode(
 		ttLibC_PcmS16 *pcm,
 		ttLibC_SpeexEncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	if(encoder == NULL) {
 		return false;
 	}
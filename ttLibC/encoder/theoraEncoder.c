@@ -12,6 +12,7 @@
 #include "theoraEncoder.h"
 #include "../ttLibC_predef.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../_log.h"
 #include <theora/theoraenc.h>
 #include <string.h>
@@ -118,6 +119,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_TheoraEncoder_encode(
 		ttLibC_Yuv420 *yuv420,
 		ttLibC_TheoraEncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	ttLibC_TheoraEncoder_ *encoder_ = (ttLibC_TheoraEncoder_ *)encoder;
 	if(encoder_ == NULL) {
 		return false;
@@ -12,6 +12,7 @@
 #include "vorbisEncoder.h"
 #include "../ttLibC_predef.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../_log.h"
 #include <vorbis/vorbisenc.h>
 #include <string.h>
@@ -73,6 +74,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_VorbisEncoder_encode(
 		ttLibC_Audio *pcm,
 		ttLibC_VorbisEncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	ttLibC_VorbisEncoder_ *encoder_ = (ttLibC_VorbisEncoder_ *)encoder;
 	if(encoder_ == NULL) {
 		return false;
@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/hexUtil.h"
 #include "../util/dynamicBufferUtil.h"
 #include "../frame/video/h264.h"
@@ -630,6 +631,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_VtEncoder_encode(
 		ttLibC_Yuv420 *yuv420,
 		ttLibC_VtEncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	ttLibC_VtEncoder_ *encoder_ = (ttLibC_VtEncoder_ *)encoder;
 	if(encoder_ == NULL) {
 		return false;
@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/hexUtil.h"
 #include "../util/dynamicBufferUtil.h"
 #include <x264.h>
@@ -350,18 +351,19 @@ static bool X264Encoder_checkEncodedData(
 	return true;
 }
 
-bool TT_VISIBILITY_DEFAULT ttLibC_X264Encoder_encode(
-		ttLibC_X264Encoder *encoder,
+/*
+ * encode picture with x264.
+ * @param encoder_ x264 encoder object
+ * @param yuv420   source yuv420
+ * @param nal      encoded nals
+ * @param i_nal    number of nals
+ * @return frame_size. -1 for error.
+ */
+static int32_t X264Encoder_encodePicture(
+		ttLibC_X264Encoder_ *encoder_,
 		ttLibC_Yuv420 *yuv420,
-		ttLibC_X264EncodeFunc callback,
-		void *ptr) {
-	ttLibC_X264Encoder_ *encoder_ = (ttLibC_X264Encoder_ *)encoder;
-	if(encoder_ == NULL) {
-		return false;
-	}
-	if(yuv420 == NULL) {
-		return true;
-	}
+		x264_nal_t **nal,
+		int32_t *i_nal) {
 	switch(yuv420->type) {
 	case Yuv420Type_planar:
 	case Yvu420Type_planar:
@@ -369,7 +371,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_X264Encoder_encode(
 	case Yuv420Type_semiPlanar:
 	case Yvu420Type_semiPlanar:
 		ERR_PRINT("only support planar.");
-		return false;
+		return -1;
 	}
 	encoder_->id = yuv420->inherit_super.inherit_super.id;
 	// copy yuv data to pic.
@@ -386,13 +388,11 @@ bool TT_VISIBILITY_DEFAULT ttLibC_X264Encoder_encode(
 	// update pic pts.
 	encoder_->pic.i_pts = (int64_t)(yuv420->inherit_super.inherit_super.pts * encoder_->timebase / yuv420->inherit_super.inherit_super.timebase);
 
-	x264_nal_t *nal;
-	int32_t i_nal;
 	x264_picture_t pic;
-	int32_t frame_size = x264_encoder_encode(encoder_->enc, &nal, &i_nal, &encoder_->pic, &pic);
+	int32_t frame_size = x264_encoder_encode(encoder_->enc, nal, i_nal, &encoder_->pic, &pic);
 	if(frame_size < 0) {
 		ERR_PRINT("failed to encode data.");
-		return false;
+		return -1;
 	}
 	encoder_->pic.i_type = X264_TYPE_AUTO;
 	if(frame_size != 0) {
@@ -425,9 +425,91 @@ bool TT_VISIBILITY_DEFAULT ttLibC_X264Encoder_encode(
 		break;
 	}
 	*/
+	return frame_size;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_X264Encoder_encode(
+		ttLibC_X264Encoder *encoder,
+		ttLibC_Yuv420 *yuv420,
+		ttLibC_X264EncodeFunc callback,
+		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
+	ttLibC_X264Encoder_ *encoder_ = (ttLibC_X264Encoder_ *)encoder;
+	if(encoder_ == NULL) {
+		return false;
+	}
+	if(yuv420 == NULL) {
+		return true;
+	}
+	x264_nal_t *nal;
+	int32_t i_nal;
+	int32_t frame_size = X264Encoder_encodePicture(encoder_, yuv420, &nal, &i_nal);
+	if(frame_size < 0) {
+		return false;
+	}
 	return X264Encoder_checkEncodedData(encoder_, nal, i_nal, frame_size, callback, ptr);
 }
 
+/*
+ * write encoded nals on sink.
+ * nal is written with nal_format of sink, sps and pps make one config unit.
+ */
+static bool X264Encoder_writeSink(
+		ttLibC_X264Encoder_ *encoder,
+		x264_nal_t *nal,
+		int32_t nal_count,
+		int32_t frame_size,
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr) {
+	if(frame_size == 0) {
+		return true;
+	}
+	sink->pts      = encoder->pts;
+	sink->timebase = encoder->timebase;
+	sink->id       = encoder->id;
+	for(int32_t i = 0;i < nal_count;++ i, ++ nal) {
+		if(!ttLibC_EncodeSink_appendH264Nal(sink, nal->p_payload, nal->i_payload, callback, ptr)) {
+			ERR_PRINT("failed to write nal on sink.");
+			return false;
+		}
+	}
+	return ttLibC_EncodeSink_endH264(sink, callback, ptr);
+}
+
+/*
+ * encode frame into sink.
+ * nal is written on sink directly, without making h264 frame.
+ * @param encoder  x264 encoder object
+ * @param yuv420   source yuv420 data.
+ * @param sink     output sink.
+ * @param callback callback func for each unit. can be NULL.
+ * @param ptr      pointer for user def value, which will call in callback.
+ * @return true / false
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_X264Encoder_encodeToSink(
+		ttLibC_X264Encoder *encoder,
+		ttLibC_Yuv420 *yuv420,
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
+	ttLibC_X264Encoder_ *encoder_ = (ttLibC_X264Encoder_ *)encoder;
+	if(encoder_ == NULL || sink == NULL) {
+		return false;
+	}
+	if(yuv420 == NULL) {
+		return true;
+	}
+	x264_nal_t *nal;
+	int32_t i_nal;
+	int32_t frame_size = X264Encoder_encodePicture(encoder_, yuv420, &nal, &i_nal);
+	if(frame_size < 0) {
+		return false;
+	}
+	return X264Encoder_writeSink(encoder_, nal, i_nal, frame_size, sink, callback, ptr);
+}
+
 /*
  * parse params
  * @param param_t structure pointer for x264_param_t on x264.h
@@ -17,6 +17,7 @@ extern "C" {
 
 #include "../frame/video/h264.h"
 #include "../frame/video/yuv420.h"
+#include "encodeSink.h"
 
 typedef enum ttLibC_X264Encoder_FrameType {
 	X264FrameType_Auto     = 0x0000,
@@ -136,6 +137,23 @@ bool ttLibC_X264Encoder_encode(
 		ttLibC_X264EncodeFunc callback,
 		void *ptr);
 
+/**
+ * encode frame into sink.
+ * nal is written on sink directly with nal_format of sink, without making h264 frame.
+ * sps and pps make one config unit, sei is dropped.
+ * @param encoder  x264 encoder object.
+ * @param yuv420   source yuv420 data.
+ * @param sink     output sink.
+ * @param callback callback func for each unit. can be NULL.
+ * @param ptr      pointer for user def value, which will call in callback.
+ */
+bool ttLibC_X264Encoder_encodeToSink(
+		ttLibC_X264Encoder *encoder,
+		ttLibC_Yuv420 *yuv420,
+		ttLibC_EncodeSink *sink,
+		ttLibC_EncodeSinkFunc callback,
+		void *ptr);
+
 /**
  * parse params
  * @param param_t structure pointer for x264_param_t on x264.h
@@ -14,6 +14,7 @@
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
+#include "../util/statsUtil.h"
 #include "../util/dynamicBufferUtil.h"
 #include <x265.h>
 #include <string.h>
@@ -290,6 +291,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_X265Encoder_encode(
 		ttLibC_Yuv420 *yuv420,
 		ttLibC_X265EncodeFunc callback,
 		void *ptr) {
+	ttLibC_Stats_scope(StatsApi_encode);
 	// do encode.
 	ttLibC_X265Encoder_ *encoder_ = (ttLibC_X265Encoder_ *)encoder;
 	if(encoder_ == NULL) {
@@ -44,6 +44,7 @@
 #include "../../_log.h"
 #include "../../allocator.h"
 
+#include "../../util/audioSyncUtil.h"
 #include "../../util/byteUtil.h"
 #include "../../util/crc32Util.h"
 #include "../../util/hexUtil.h"
@@ -282,13 +283,8 @@ ttLibC_Aac TT_VISIBILITY_DEFAULT *ttLibC_Aac_getFrame(
 		// data_size is too short need more.
 		return NULL;
 	}
-	ttLibC_ByteReader *reader = ttLibC_ByteReader_make(data, data_size, ByteUtilType_default);
-	if(reader == NULL) {
-		ERR_PRINT("failed to make byteReader.");
-		return NULL;
-	}
-	if(ttLibC_ByteReader_bit(reader, 12) != 0xFFF) {
-		ttLibC_ByteReader_close(&reader);
+	uint8_t *buf = (uint8_t *)data;
+	if(buf[0] != 0xFF || (buf[1] & 0xF0) != 0xF0) {
 		return Aac_getRawFrame(
 				prev_frame,
 				data,
@@ -297,27 +293,21 @@ ttLibC_Aac TT_VISIBILITY_DEFAULT *ttLibC_Aac_getFrame(
 				pts,
 				timebase);
 	}
-	ttLibC_ByteReader_bit(reader, 1);
-	ttLibC_ByteReader_bit(reader, 2);
-	ttLibC_ByteReader_bit(reader, 1);
-	ttLibC_ByteReader_bit(reader, 2);
-	uint32_t sample_rate_index = ttLibC_ByteReader_bit(reader, 4);
-	uint32_t sample_rate = sample_rate_table[sample_rate_index];
-	ttLibC_ByteReader_bit(reader, 1);
-	uint32_t channel_num = ttLibC_ByteReader_bit(reader, 3);
-	ttLibC_ByteReader_bit(reader, 1);
-	ttLibC_ByteReader_bit(reader, 1);
-	ttLibC_ByteReader_bit(reader, 1);
-	ttLibC_ByteReader_bit(reader, 1);
-	uint32_t frame_size = ttLibC_ByteReader_bit(reader, 13);
-	ttLibC_ByteReader_bit(reader, 11);
-	ttLibC_ByteReader_bit(reader, 2);
-	if(reader->error != Error_noError) {
-		LOG_ERROR(reader->error);
-		ttLibC_ByteReader_close(&reader);
+	if(data_size < 7) {
+		// adts header is too short need more.
+		return NULL;
+	}
+	uint32_t frame_size = ttLibC_AudioSync_refAdtsSize(buf);
+	if(frame_size == 0) {
+		ERR_PRINT("invalid adts header:%02x %02x %02x", buf[1], buf[2], buf[3]);
 		return NULL;
 	}
-	ttLibC_ByteReader_close(&reader);
+	if(data_size < frame_size) {
+		// adts frame is too short need more, the same as mp3.
+		return NULL;
+	}
+	uint32_t sample_rate = sample_rate_table[(buf[2] >> 2) & 0x0F];
+	uint32_t channel_num = ((buf[2] & 0x01) << 2) | ((buf[3] >> 6) & 0x03);
 	// this frame_size includes the adts header.
 	return ttLibC_Aac_make(
 			prev_frame,
@@ -352,32 +342,19 @@ size_t TT_VISIBILITY_DEFAULT ttLibC_Aac_readAdtsHeader(
 		return 0;
 	}
 	ttLibC_Aac_ *aac_ = (ttLibC_Aac_ *)target_aac;
-	ttLibC_ByteReader *reader = ttLibC_ByteReader_make(&aac_->dsi_info, sizeof(aac_->dsi_info), ByteUtilType_default);
-	uint32_t object_type = ttLibC_ByteReader_bit(reader, 5);
+	// read dsi without byteReader, this is called for each frame.
+	uint8_t *dsi = (uint8_t *)&aac_->dsi_info;
+	uint32_t object_type = dsi[0] >> 3;
 	if(object_type == 31) {
 		ERR_PRINT("adts support only profile:main, low, ssr, and ltp.");
-		object_type = ttLibC_ByteReader_bit(reader, 6);
-		ttLibC_ByteReader_close(&reader);
 		return 0;
 	}
-	uint32_t frequency_index = ttLibC_ByteReader_bit(reader, 4);
+	uint32_t frequency_index = ((dsi[0] & 0x07) << 1) | (dsi[1] >> 7);
 	if(frequency_index == 15) {
 		ERR_PRINT("not tested yet. now return error.");
-//		uint32_t frequency = ttLibC_ByteReader_bit(reader, 24);
-		ttLibC_ByteReader_close(&reader);
-		return 0;
-	}
-	uint32_t channel_conf = ttLibC_ByteReader_bit(reader, 4);
-	if(reader == NULL) {
-		ERR_PRINT("failed to allocate byteReader.");
-		return 0;
-	}
-	if(reader->error != Error_noError) {
-		LOG_ERROR(reader->error);
-		ttLibC_ByteReader_close(&reader);
 		return 0;
 	}
-	ttLibC_ByteReader_close(&reader);
+	uint32_t channel_conf = (dsi[1] >> 3) & 0x0F;
 	-- object_type; // to make adts, need to decrement.
 	size_t aac_size = target_aac->inherit_super.inherit_super.buffer_size + 7;
 	// ready to work. make adts header.
@@ -18,6 +18,7 @@
 #include "../../_log.h"
 #include "../../allocator.h"
 #include "../../util/byteUtil.h"
+#include "../../util/audioSyncUtil.h"
 
 /*
  * mp3 frame definition(detail)
@@ -194,13 +195,8 @@ ttLibC_Mp3_Type TT_VISIBILITY_DEFAULT ttLibC_Mp3_getMp3Type(
 }
 
 /*
- * table for bitrate index.
+ * table for sample rate index.
  */
-static int bitrateIndexV1L1[]  = {-1, 32000, 64000, 96000, 128000, 160000, 192000, 224000, 256000, 288000, 320000, 352000, 384000, 416000, 448000, -1};
-static int bitrateIndexV1L2[]  = {-1, 32000, 48000, 56000,  64000,  80000,  96000, 112000, 128000, 160000, 192000, 224000, 256000, 320000, 384000, -1};
-static int bitrateIndexV1L3[]  = {-1, 32000, 40000, 48000,  56000,  64000,  80000,  96000, 112000, 128000, 160000, 192000, 224000, 256000, 320000, -1};
-static int bitrateIndexV2L1[]  = {-1, 32000, 48000, 56000,  64000,  80000,  96000, 112000, 128000, 144000, 160000, 176000, 192000, 224000, 256000, -1};
-static int bitrateIndexV2L23[] = {-1,  8000, 16000, 24000,  32000,  40000,  48000,  56000,  64000,  80000,  96000, 112000, 128000, 144000, 160000, -1};
 static int sampleRateTableV1[]  = {44100, 48000, 32000};
 static int sampleRateTableV2[]  = {22050, 24000, 16000};
 static int sampleRateTableV25[] = {11025, 12000,  8000};
@@ -215,75 +211,28 @@ static ttLibC_Mp3 *Mp3_makeFrame(
 	if(data_size < 4) {
 		return NULL;
 	}
-	ttLibC_ByteReader *reader = ttLibC_ByteReader_make(data, data_size, ByteUtilType_default);
-	if(reader == NULL) {
-		ERR_PRINT("failed to allocate byteReader.");
-		return NULL;
-	}
-	if(ttLibC_ByteReader_bit(reader, 11) != 0x07FF) {
+	uint8_t *buf = (uint8_t *)data;
+	if(buf[0] != 0xFF || (buf[1] & 0xE0) != 0xE0) {
 		ERR_PRINT("syncbit is invalid.");
-		ttLibC_ByteReader_close(&reader);
-		return 0;
+		return NULL;
 	}
-	uint8_t mpeg_version = ttLibC_ByteReader_bit(reader, 2);
-	uint8_t layer        = ttLibC_ByteReader_bit(reader, 2);
-	ttLibC_ByteReader_bit(reader, 1);
-	uint8_t bitrate_index     = ttLibC_ByteReader_bit(reader, 4);
-	uint8_t sample_rate_index = ttLibC_ByteReader_bit(reader, 2);
-	uint8_t padding_bit       = ttLibC_ByteReader_bit(reader, 1);
-	ttLibC_ByteReader_bit(reader, 1);
-	uint8_t channel_mode = ttLibC_ByteReader_bit(reader, 2);
-	ttLibC_ByteReader_bit(reader, 2);
-	ttLibC_ByteReader_bit(reader, 1);
-	ttLibC_ByteReader_bit(reader, 1);
-	ttLibC_ByteReader_bit(reader, 2);
-	if(reader->error != Error_noError) {
-		LOG_ERROR(reader->error);
-		ttLibC_ByteReader_close(&reader);
-		return 0;
+	// frame size is on the table of audioSyncUtil, 0 for invalid header.
+	size_t frame_size = ttLibC_AudioSync_refMp3Size(buf);
+	if(frame_size == 0) {
+		ERR_PRINT("invalid mp3 header:%02x %02x %02x", buf[1], buf[2], buf[3]);
+		return NULL;
 	}
-	ttLibC_ByteReader_close(&reader);
-
-	uint32_t bitrate = 0;
-	uint32_t sample_rate = 0;
-	size_t frame_size = 0;
-	uint32_t channel_num = channel_mode == 3 ? 1 : 2;
-	switch(mpeg_version) {
-	case 0:
-	case 2:
-		switch(layer) {
-		case 1:
-		case 2:
-			bitrate = bitrateIndexV2L23[bitrate_index];
-			break;
-		case 3:
-			bitrate = bitrateIndexV2L1[bitrate_index];
-			break;
-		default:
-			ERR_PRINT("unknown layer index:%d", layer);
-			return NULL;
-		}
-		break;
-	case 3:
-		switch(layer) {
-		case 1: // layer3
-			bitrate = bitrateIndexV1L3[bitrate_index];
-			break;
-		case 2: // layer2
-			bitrate = bitrateIndexV1L2[bitrate_index];
-			break;
-		case 3: // layer1
-			bitrate = bitrateIndexV1L1[bitrate_index];
-			break;
-		default:
-			ERR_PRINT("unknown layer index:%d", layer);
-			return NULL;
-		}
-		break;
-	default:
-		ERR_PRINT("unknown mpeg_version:%d", mpeg_version);
+	if(data_size < frame_size) {
+		// data size is too short. need more.
 		return NULL;
 	}
+	uint8_t mpeg_version      = (buf[1] >> 3) & 0x03;
+	uint8_t layer             = (buf[1] >> 1) & 0x03;
+	uint8_t sample_rate_index = (buf[2] >> 2) & 0x03;
+	uint8_t channel_mode      = (buf[3] >> 6) & 0x03;
+	uint32_t channel_num = channel_mode == 3 ? 1 : 2;
+	uint32_t sample_rate = 0;
+	uint32_t sample_num = 0;
 	switch(mpeg_version) {
 	case 0:
 		sample_rate = sampleRateTableV25[sample_rate_index];
@@ -292,43 +241,10 @@ static ttLibC_Mp3 *Mp3_makeFrame(
 		sample_rate = sampleRateTableV2[sample_rate_index];
 		break;
 	case 3:
-		sample_rate = sampleRateTableV1[sample_rate_index];
-		break;
 	default:
-		ERR_PRINT("unknown mpeg_version:%d", mpeg_version);
-		return NULL;
-	}
-	switch(layer) {
-	case 3:
-		frame_size = ((uint32_t)(12.0f * bitrate / sample_rate + padding_bit)) * 4;
-		break;
-	case 2:
-		frame_size = (uint32_t)(144.0f * bitrate / sample_rate + padding_bit);
-		break;
-	case 1:
-		switch(mpeg_version) {
-		case 0:
-		case 2:
-			frame_size = (uint32_t)(72.0f * bitrate / sample_rate + padding_bit);
-			break;
-		case 3:
-			frame_size = (uint32_t)(144.0f * bitrate / sample_rate + padding_bit);
-			break;
-		default:
-			ERR_PRINT("unknown mpeg_version:%d", mpeg_version);
-			return NULL;
-		}
+		sample_rate = sampleRateTableV1[sample_rate_index];
 		break;
-	default:
-		ERR_PRINT("unknown layer index:%d", layer);
-		return NULL;
-	}
-	if(data_size < frame_size) {
-		// data size is too short. need more.
-		return NULL;
 	}
-
-	uint32_t sample_num = 0;
 	switch(layer) {
 	case 3:
 		sample_num = 384;
@@ -337,22 +253,9 @@ static ttLibC_Mp3 *Mp3_makeFrame(
 		sample_num = 1152;
 		break;
 	case 1:
-		switch(mpeg_version) {
-		case 0:
-		case 2:
-			sample_num = 576;
-			break;
-		case 3:
-			sample_num = 1152;
-			break;
-		default:
-			ERR_PRINT("unknown mpeg_version:%d", mpeg_version);
-			return NULL;
-		}
-		break;
 	default:
-		ERR_PRINT("unknown layer index:%d", layer);
-		return NULL;
+		sample_num = mpeg_version == 3 ? 1152 : 576;
+		break;
 	}
 	// now make mp3 object.
 	ttLibC_Mp3_ *mp3 = (ttLibC_Mp3_ *)ttLibC_Mp3_make(
@@ -143,6 +143,24 @@ bool ttLibC_RtmpStream_addFrame(
 		ttLibC_RtmpStream *stream,
 		ttLibC_Frame *frame);
 
+/**
+ * enable aggregate message for publish.
+ * frames from addFrame are held, and sent as one aggregate message(type 22),
+ * when the held duration reach window_msec, or the size reach max_size.
+ * duration is checked with media timestamp on addFrame, and with wall clock on addFrame and ttLibC_RtmpConnection_update.
+ * so call update regularly, to send held frames for sparse input.
+ * this reduces the number of messages and write calls for small frames. (like 20 mili sec audio)
+ * sent bytes increase a little, each frame has flv tag header(11 byte) and tag size(4 byte) instead of chunk header.
+ * (500 pcm alaw frames of 20 mili sec with 100 msec window: 500 -> 84 write calls, 85004 -> 88771 bytes.)
+ * @param stream
+ * @param window_msec max duration to hold frames in mili sec. this is the max latency added. 0 to disable.
+ * @param max_size    max size of aggregate message. 0 for default.(65536)
+ */
+void ttLibC_RtmpStream_setAggregate(
+		ttLibC_RtmpStream *stream,
+		uint32_t window_msec,
+		size_t max_size);
+
 /**
  * send buffer length for play.
  */
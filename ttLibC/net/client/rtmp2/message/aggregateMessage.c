@@ -18,7 +18,7 @@ ttLibC_AggregateMessage TT_VISIBILITY_HIDDEN *ttLibC_AggregateMessage_make() {
 	if(message == NULL) {
 		return NULL;
 	}
-	ttLibC_RtmpHeader *header = ttLibC_RtmpHeader_make(3, 0, RtmpMessageType_aggregateMessage, 0);
+	ttLibC_RtmpHeader *header = ttLibC_RtmpHeader_make(8, 0, RtmpMessageType_aggregateMessage, 0);
 	if(header == NULL) {
 		ttLibC_free(message);
 		return NULL;
@@ -104,6 +104,17 @@ tetty2_errornum TT_VISIBILITY_HIDDEN ttLibC_AggregateMessage_getFrame(
 	return 0;
 }
 
+bool TT_VISIBILITY_HIDDEN ttLibC_AggregateMessage_getData(
+		ttLibC_AggregateMessage *message,
+		ttLibC_DynamicBuffer *buffer) {
+	// data is already flv tags, header->size is the size of data.
+	if(message->data == NULL) {
+		return false;
+	}
+	ttLibC_DynamicBuffer_append(buffer, message->data, message->inherit_super.header->size);
+	return true;
+}
+
 void TT_VISIBILITY_HIDDEN ttLibC_AggregateMessage_close(ttLibC_AggregateMessage **message) {
 	ttLibC_AggregateMessage *target = (ttLibC_AggregateMessage *)*message;
 	if(target == NULL) {
@@ -50,6 +50,9 @@ tetty2_errornum ttLibC_AggregateMessage_getFrame(
 		ttLibC_FlvFrameManager *manager,
 		ttLibC_RtmpStream_getFrameFunc callback,
 		void *ptr);
+bool ttLibC_AggregateMessage_getData(
+		ttLibC_AggregateMessage *message,
+		ttLibC_DynamicBuffer *buffer);
 void ttLibC_AggregateMessage_close(ttLibC_AggregateMessage **message);
 
 #ifdef __cplusplus
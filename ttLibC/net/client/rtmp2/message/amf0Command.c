@@ -29,6 +29,7 @@ ttLibC_Amf0Command TT_VISIBILITY_HIDDEN *ttLibC_Amf0Command_make(const char *com
 	command->obj1 = NULL;
 	command->obj2 = NULL;
 	command->obj3 = NULL;
+	command->arena = NULL;
 	command->promise = NULL;
 	return command;
 }
@@ -175,13 +176,13 @@ static bool Amf0Command_readBinaryObjectCallback(void *ptr, ttLibC_Amf0Object *a
 		}
 	}
 	else if(command->obj1 == NULL) {
-		command->obj1 = ttLibC_Amf0_clone(amf0_obj);
+		command->obj1 = amf0_obj;
 	}
 	else if(command->obj2 == NULL) {
-		command->obj2 = ttLibC_Amf0_clone(amf0_obj);
+		command->obj2 = amf0_obj;
 	}
 	else if(command->obj3 == NULL) {
-		command->obj3 = ttLibC_Amf0_clone(amf0_obj);
+		command->obj3 = amf0_obj;
 	}
 	else {
 		return false;
@@ -196,8 +197,14 @@ ttLibC_Amf0Command TT_VISIBILITY_HIDDEN *ttLibC_Amf0Command_readBinary(
 	if(command == NULL) {
 		return NULL;
 	}
+	// all objects of the message are held on one arena.
+	command->arena = ttLibC_Amf0Arena_make(data_size * 4);
+	if(command->arena == NULL) {
+		ttLibC_Amf0Command_close(&command);
+		return NULL;
+	}
 	// call callback until read all binary.(we will get some number of amf0 object.)
-	bool result = ttLibC_Amf0_read(data, data_size, Amf0Command_readBinaryObjectCallback, command);
+	bool result = ttLibC_Amf0_readArena(command->arena, data, data_size, Amf0Command_readBinaryObjectCallback, command);
 	if(!result) {
 		ttLibC_Amf0Command_close(&command);
 		return NULL;
@@ -215,21 +222,32 @@ bool TT_VISIBILITY_HIDDEN ttLibC_Amf0Command_getData(
 		ttLibC_Amf0Command *command,
 		ttLibC_DynamicBuffer *buffer) {
 	// amf0Command -> binary for send message.
-	ttLibC_Amf0Object *command_name = ttLibC_Amf0_string((const char *)command->command_name);
-	ttLibC_Amf0Object *command_id = ttLibC_Amf0_number(command->command_id);
-	ttLibC_Amf0_write(command_name, Amf0Command_writeCallback, buffer);
-	ttLibC_Amf0_write(command_id, Amf0Command_writeCallback, buffer);
-	if(command->obj1 != NULL) {
-		ttLibC_Amf0_write(command->obj1, Amf0Command_writeCallback, buffer);
-	}
-	if(command->obj2 != NULL) {
-		ttLibC_Amf0_write(command->obj2, Amf0Command_writeCallback, buffer);
-	}
-	if(command->obj3 != NULL) {
-		ttLibC_Amf0_write(command->obj3, Amf0Command_writeCallback, buffer);
+	// serialize on stack, command name and id are written without allocation.
+	uint8_t buf[1024];
+	double id = command->command_id;
+	ttLibC_Amf0Object command_name = {amf0Type_String, command->command_name, 0};
+	ttLibC_Amf0Object command_id = {amf0Type_Number, &id, 9};
+	ttLibC_Amf0Object *objs[] = {&command_name, &command_id, command->obj1, command->obj2, command->obj3};
+	size_t pos = 0;
+	for(int i = 0;i < 5;++ i) {
+		if(objs[i] == NULL) {
+			continue;
+		}
+		size_t size = ttLibC_Amf0_writeBuffer(objs[i], buf + pos, sizeof(buf) - pos);
+		if(size == 0) {
+			// buffer is short, flush and try again.
+			ttLibC_DynamicBuffer_append(buffer, buf, pos);
+			pos = 0;
+			size = ttLibC_Amf0_writeBuffer(objs[i], buf, sizeof(buf));
+			if(size == 0) {
+				// too big for stack buffer.
+				ttLibC_Amf0_write(objs[i], Amf0Command_writeCallback, buffer);
+				continue;
+			}
+		}
+		pos += size;
 	}
-	ttLibC_Amf0_close(&command_name);
-	ttLibC_Amf0_close(&command_id);
+	ttLibC_DynamicBuffer_append(buffer, buf, pos);
 	return true;
 }
 
@@ -239,9 +257,15 @@ void TT_VISIBILITY_HIDDEN ttLibC_Amf0Command_close(ttLibC_Amf0Command **command)
 		return;
 	}
 	ttLibC_RtmpHeader_close(&target->inherit_super.header);
-	ttLibC_Amf0_close(&target->obj1);
-	ttLibC_Amf0_close(&target->obj2);
-	ttLibC_Amf0_close(&target->obj3);
+	if(target->arena != NULL) {
+		// objects are owned by arena.
+		ttLibC_Amf0Arena_close(&target->arena);
+	}
+	else {
+		ttLibC_Amf0_close(&target->obj1);
+		ttLibC_Amf0_close(&target->obj2);
+		ttLibC_Amf0_close(&target->obj3);
+	}
 	ttLibC_free(target);
 	*command = NULL;
 }
@@ -32,6 +32,8 @@ typedef struct ttLibC_Net_Client_Rtmp2_Message_Amf0Command {
 	ttLibC_Amf0Object *obj1;
 	ttLibC_Amf0Object *obj2;
 	ttLibC_Amf0Object *obj3;
+	/** arena which owns obj for received message. */
+	ttLibC_Amf0Arena *arena;
 	ttLibC_Tetty2Promise *promise;
 } ttLibC_Net_Client_Rtmp2_Message_Amf0Command;
 
@@ -27,6 +27,7 @@ ttLibC_Amf0DataMessage TT_VISIBILITY_HIDDEN *ttLibC_Amf0DataMessage_make(const c
 	strcpy((char *)message->message_name, message_name);
 	message->obj1 = NULL;
 	message->obj2 = NULL;
+	message->arena = NULL;
 	return message;
 }
 
@@ -41,10 +42,10 @@ static bool Amf0DataMessage_readBinaryObjectCallback(void *ptr, ttLibC_Amf0Objec
 		}
 	}
 	else if(message->obj1 == NULL) {
-		message->obj1 = ttLibC_Amf0_clone(amf0_obj);
+		message->obj1 = amf0_obj;
 	}
 	else if(message->obj2 == NULL) {
-		message->obj2 = ttLibC_Amf0_clone(amf0_obj);
+		message->obj2 = amf0_obj;
 	}
 	else {
 		return false;
@@ -59,7 +60,13 @@ ttLibC_Amf0DataMessage TT_VISIBILITY_HIDDEN *ttLibC_Amf0DataMessage_readBinary(
 	if(message == NULL) {
 		return NULL;
 	}
-	bool result = ttLibC_Amf0_read(data, data_size, Amf0DataMessage_readBinaryObjectCallback, message);
+	// all objects of the message are held on one arena.
+	message->arena = ttLibC_Amf0Arena_make(data_size * 4);
+	if(message->arena == NULL) {
+		ttLibC_Amf0DataMessage_close(&message);
+		return NULL;
+	}
+	bool result = ttLibC_Amf0_readArena(message->arena, data, data_size, Amf0DataMessage_readBinaryObjectCallback, message);
 	if(!result) {
 		ttLibC_Amf0DataMessage_close(&message);
 		return NULL;
@@ -67,14 +74,43 @@ ttLibC_Amf0DataMessage TT_VISIBILITY_HIDDEN *ttLibC_Amf0DataMessage_readBinary(
 	return message;
 }
 
+static bool Amf0DataMessage_writeCallback(void *ptr, void *data, size_t data_size) {
+	ttLibC_DynamicBuffer *buffer = (ttLibC_DynamicBuffer *)ptr;
+	ttLibC_DynamicBuffer_append(buffer, data, data_size);
+	return true;
+}
+
+bool TT_VISIBILITY_HIDDEN ttLibC_Amf0DataMessage_getData(
+		ttLibC_Amf0DataMessage *message,
+		ttLibC_DynamicBuffer *buffer) {
+	// amf0DataMessage -> binary for send message.
+	ttLibC_Amf0Object message_name = {amf0Type_String, message->message_name, 0};
+	ttLibC_Amf0Object *objs[] = {&message_name, message->obj1, message->obj2};
+	for(int i = 0;i < 3;++ i) {
+		if(objs[i] == NULL) {
+			continue;
+		}
+		if(!ttLibC_Amf0_write(objs[i], Amf0DataMessage_writeCallback, buffer)) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void TT_VISIBILITY_HIDDEN ttLibC_Amf0DataMessage_close(ttLibC_Amf0DataMessage **message) {
 	ttLibC_Amf0DataMessage *target = (ttLibC_Amf0DataMessage *)*message;
 	if(target == NULL) {
 		return;
 	}
 	ttLibC_RtmpHeader_close(&target->inherit_super.header);
-	ttLibC_Amf0_close(&target->obj1);
-	ttLibC_Amf0_close(&target->obj2);
+	if(target->arena != NULL) {
+		// objects are owned by arena.
+		ttLibC_Amf0Arena_close(&target->arena);
+	}
+	else {
+		ttLibC_Amf0_close(&target->obj1);
+		ttLibC_Amf0_close(&target->obj2);
+	}
 	ttLibC_free(target);
 	*message = NULL;
 }
@@ -29,6 +29,8 @@ typedef struct ttLibC_Net_Client_Rtmp2_Message_Amf0DataMessage {
 	char *message_name[256];
 	ttLibC_Amf0Object *obj1;
 	ttLibC_Amf0Object *obj2;
+	/** arena which owns obj for received message. */
+	ttLibC_Amf0Arena *arena;
 } ttLibC_Net_Client_Rtmp2_Message_Amf0DataMessage;
 
 typedef ttLibC_Net_Client_Rtmp2_Message_Amf0DataMessage ttLibC_Amf0DataMessage;
@@ -39,6 +41,10 @@ ttLibC_Amf0DataMessage *ttLibC_Amf0DataMessage_readBinary(
 		uint8_t *data,
 		size_t data_size);
 
+bool ttLibC_Amf0DataMessage_getData(
+		ttLibC_Amf0DataMessage *message,
+		ttLibC_DynamicBuffer *buffer);
+
 void ttLibC_Amf0DataMessage_close(ttLibC_Amf0DataMessage **message);
 
 #ifdef __cplusplus
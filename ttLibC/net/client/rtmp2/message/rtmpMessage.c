@@ -36,10 +36,11 @@ bool TT_VISIBILITY_HIDDEN ttLibC_RtmpMessage_getData(
 	case RtmpMessageType_acknowledgement:
 		return ttLibC_Acknowledgement_getData((ttLibC_Acknowledgement *)message, buffer);
 	case RtmpMessageType_aggregateMessage:
-		return false;
+		return ttLibC_AggregateMessage_getData((ttLibC_AggregateMessage *)message, buffer);
 	case RtmpMessageType_amf0Command:
 		return ttLibC_Amf0Command_getData((ttLibC_Amf0Command *)message, buffer);
 	case RtmpMessageType_amf0DataMessage:
+		return ttLibC_Amf0DataMessage_getData((ttLibC_Amf0DataMessage *)message, buffer);
 	case RtmpMessageType_amf0SharedObjectMessage:
 	case RtmpMessageType_amf3Command:
 	case RtmpMessageType_amf3DataMessage:
@@ -48,8 +49,9 @@ bool TT_VISIBILITY_HIDDEN ttLibC_RtmpMessage_getData(
 	case RtmpMessageType_audioMessage:
 		return ttLibC_AudioMessage_getData((ttLibC_AudioMessage *)message, buffer);
 	case RtmpMessageType_setChunkSize:
+		return ttLibC_SetChunkSize_getData((ttLibC_SetChunkSize *)message, buffer);
 	case RtmpMessageType_setPeerBandwidth:
-		return false;
+		return ttLibC_SetPeerBandwidth_getData((ttLibC_SetPeerBandwidth *)message, buffer);
 	case RtmpMessageType_userControlMessage:
 		return ttLibC_UserControlMessage_getData((ttLibC_UserControlMessage *)message, buffer);
 	case RtmpMessageType_videoMessage:
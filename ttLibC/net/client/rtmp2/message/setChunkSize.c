@@ -9,6 +9,7 @@
 #include "../../../../ttLibC_predef.h"
 #include "../../../../_log.h"
 #include "../../../../allocator.h"
+#include "../../../../util/ioUtil.h"
 #include <string.h>
 
 ttLibC_SetChunkSize TT_VISIBILITY_HIDDEN *ttLibC_SetChunkSize_make(uint32_t size) {
@@ -27,6 +28,14 @@ ttLibC_SetChunkSize TT_VISIBILITY_HIDDEN *ttLibC_SetChunkSize_make(uint32_t size
 	return chunk_size;
 }
 
+bool TT_VISIBILITY_HIDDEN ttLibC_SetChunkSize_getData(
+		ttLibC_SetChunkSize *chunk_size,
+		ttLibC_DynamicBuffer *buffer) {
+	uint32_t size = be_uint32_t(chunk_size->size);
+	ttLibC_DynamicBuffer_append(buffer, (uint8_t *)&size, sizeof(size));
+	return true;
+}
+
 void TT_VISIBILITY_HIDDEN ttLibC_SetChunkSize_close(ttLibC_SetChunkSize **chunk_size) {
 	ttLibC_SetChunkSize *target = (ttLibC_SetChunkSize *)*chunk_size;
 	if(target == NULL) {
@@ -29,6 +29,10 @@ typedef ttLibC_Net_Client_Rtmp2_Message_SetChunkSize ttLibC_SetChunkSize;
 
 ttLibC_SetChunkSize *ttLibC_SetChunkSize_make(uint32_t size);
 
+bool ttLibC_SetChunkSize_getData(
+		ttLibC_SetChunkSize *chunk_size,
+		ttLibC_DynamicBuffer *buffer);
+
 void ttLibC_SetChunkSize_close(ttLibC_SetChunkSize **chunk_size);
 
 #ifdef __cplusplus
@@ -9,6 +9,7 @@
 #include "../../../../ttLibC_predef.h"
 #include "../../../../_log.h"
 #include "../../../../allocator.h"
+#include "../../../../util/ioUtil.h"
 #include <string.h>
 
 ttLibC_SetPeerBandwidth TT_VISIBILITY_HIDDEN *ttLibC_SetPeerBandwidth_make(
@@ -29,6 +30,16 @@ ttLibC_SetPeerBandwidth TT_VISIBILITY_HIDDEN *ttLibC_SetPeerBandwidth_make(
 	return bandwidth;
 }
 
+bool TT_VISIBILITY_HIDDEN ttLibC_SetPeerBandwidth_getData(
+		ttLibC_SetPeerBandwidth *bandwidth,
+		ttLibC_DynamicBuffer *buffer) {
+	uint32_t size = be_uint32_t(bandwidth->size);
+	uint8_t limit_type = bandwidth->limit_type;
+	ttLibC_DynamicBuffer_append(buffer, (uint8_t *)&size, sizeof(size));
+	ttLibC_DynamicBuffer_append(buffer, &limit_type, 1);
+	return true;
+}
+
 void TT_VISIBILITY_HIDDEN ttLibC_SetPeerBandwidth_close(ttLibC_SetPeerBandwidth **bandwidth) {
 	ttLibC_SetPeerBandwidth *target = (ttLibC_SetPeerBandwidth *)*bandwidth;
 	if(target == NULL) {
@@ -37,6 +37,10 @@ ttLibC_SetPeerBandwidth *ttLibC_SetPeerBandwidth_make(
 		uint32_t size,
 		ttLibC_SetPeerBandwidth_LimitType limit_type);
 
+bool ttLibC_SetPeerBandwidth_getData(
+		ttLibC_SetPeerBandwidth *bandwidth,
+		ttLibC_DynamicBuffer *buffer);
+
 void ttLibC_SetPeerBandwidth_close(ttLibC_SetPeerBandwidth **bandwidth);
 
 #ifdef __cplusplus
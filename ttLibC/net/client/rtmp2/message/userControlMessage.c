@@ -112,7 +112,11 @@ bool TT_VISIBILITY_HIDDEN ttLibC_UserControlMessage_getData(
 	case Type_RecordedStream:
 	case Type_BufferEmpty:
 	case Type_BufferFull:
-		return false;
+		{
+			uint32_t be_stream_id = be_uint32_t(user_control_message->stream_id);
+			ttLibC_DynamicBuffer_append(buffer, (uint8_t *)&be_stream_id, 4);
+		}
+		return true;
 
 	case Type_ClientBufferLength:
 		{
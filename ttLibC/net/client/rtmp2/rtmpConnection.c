@@ -8,6 +8,7 @@
 #ifdef __ENABLE_SOCKET__
 
 #include "rtmpConnection.h"
+#include "rtmpStream.h"
 #include "../../../ttLibC_predef.h"
 #include "../../../_log.h"
 #include "../../../allocator.h"
@@ -32,6 +33,7 @@ ttLibC_RtmpConnection TT_VISIBILITY_DEFAULT *ttLibC_RtmpConnection_make() {
 
 	conn->callback = NULL;
 	conn->ptr = NULL;
+	conn->aggregate_stream_list = ttLibC_StlList_make();
 	return (ttLibC_RtmpConnection *)conn;
 }
 
@@ -156,6 +158,12 @@ bool TT_VISIBILITY_DEFAULT ttLibC_RtmpConnection_connect(
 	return conn_->bootstrap->error_number == 0;
 }
 
+static bool RtmpConnection_updateAggregateCallback(void *ptr, void *item) {
+	(void)ptr;
+	ttLibC_RtmpStream_updateAggregate((ttLibC_RtmpStream_ *)item);
+	return true;
+}
+
 bool TT_VISIBILITY_DEFAULT ttLibC_RtmpConnection_update(ttLibC_RtmpConnection* conn, uint32_t wait_interval) {
 	ttLibC_RtmpConnection_ *conn_ = (ttLibC_RtmpConnection_ *)conn;
 	if(conn_ == NULL) {
@@ -176,6 +184,8 @@ bool TT_VISIBILITY_DEFAULT ttLibC_RtmpConnection_update(ttLibC_RtmpConnection* c
 		ERR_PRINT("error:%d", conn_->bootstrap->error_number);
 		return false;
 	}
+	// held frames are sent even if next frame does not come.
+	ttLibC_StlList_forEach(conn_->aggregate_stream_list, RtmpConnection_updateAggregateCallback, NULL);
 	return true;
 }
 
@@ -190,6 +200,7 @@ void TT_VISIBILITY_DEFAULT ttLibC_RtmpConnection_close(ttLibC_RtmpConnection **c
 	ttLibC_RtmpEncoder_close(&target->encoder);
 	ttLibC_RtmpCommandHandler_close(&target->command_handler);
 	ttLibC_RtmpClientHandler_close(&target->client_handler);
+	ttLibC_StlList_close(&target->aggregate_stream_list);
 	ttLibC_free(target);
 	*conn = NULL;
 }
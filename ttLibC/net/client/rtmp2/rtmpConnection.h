@@ -14,6 +14,7 @@ extern "C" {
 
 #include "../rtmp.h"
 #include "../../../util/tetty2.h"
+#include "../../../util/stlListUtil.h"
 #include "tetty2/rtmpClientHandler.h"
 #include "tetty2/rtmpCommandHandler.h"
 #include "tetty2/rtmpDecoder.h"
@@ -39,6 +40,9 @@ typedef struct ttLibC_Net_Client_Rtmp2_RtmpConnection_ {
 	// event listener callback.
 	ttLibC_RtmpEventFunc callback;
 	void *ptr;
+
+	// streams in aggregate mode, checked on update.
+	ttLibC_StlList *aggregate_stream_list;
 } ttLibC_Net_Client_Rtmp2_RtmpConnection_;
 
 typedef ttLibC_Net_Client_Rtmp2_RtmpConnection_ ttLibC_RtmpConnection_;
@@ -9,6 +9,7 @@
 
 #include "rtmpStream.h"
 #include "rtmpConnection.h"
+#include "message/aggregateMessage.h"
 #include "message/amf0Command.h"
 #include "message/videoMessage.h"
 #include "message/audioMessage.h"
@@ -19,12 +20,14 @@
 #include "../../../allocator.h"
 #include "../../tetty2/tcpBootstrap.h"
 #include <string.h>
+#include <time.h>
 
 #include "../../../frame/frame.h"
 #include "../../../frame/video/h264.h"
 #include "../../../frame/audio/aac.h"
 #include "../../../frame/audio/mp3.h"
 #include "../../../util/hexUtil.h"
+#include "../../../util/ioUtil.h"
 
 /**
  * callback for createStream.
@@ -75,6 +78,12 @@ ttLibC_RtmpStream TT_VISIBILITY_DEFAULT *ttLibC_RtmpStream_make(ttLibC_RtmpConne
 	stream->video_queue->isBframe_fixed = true;
 	stream->audio_type = frameType_unknown;
 	stream->audio_queue = ttLibC_FrameQueue_make(8, 1024);
+	stream->aggregate_window = 0;
+	stream->aggregate_max_size = 0;
+	stream->aggregate_timestamp = 0;
+	stream->aggregate_start_time = 0;
+	stream->aggregate_buffer = NULL;
+	stream->aggregate_work_buffer = NULL;
 	// make createStream and send it to server.
 	ttLibC_Amf0Command *createStream = ttLibC_Amf0Command_createStream();
 	stream->promise = ttLibC_Tetty2Bootstrap_makePromise(stream->conn->bootstrap);
@@ -141,6 +150,145 @@ void TT_VISIBILITY_DEFAULT ttLibC_RtmpStream_publish(
 	return;
 }
 
+/**
+ * ref current time in mili sec.
+ */
+static int64_t RtmpStream_now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * send holding messages as one aggregate message.
+ */
+static void RtmpStream_flushAggregate(ttLibC_RtmpStream_ *stream) {
+	if(stream->aggregate_buffer == NULL || ttLibC_DynamicBuffer_refSize(stream->aggregate_buffer) == 0) {
+		return;
+	}
+	ttLibC_AggregateMessage *aggregateMessage = ttLibC_AggregateMessage_make();
+	if(aggregateMessage != NULL) {
+		aggregateMessage->data = ttLibC_DynamicBuffer_refData(stream->aggregate_buffer);
+		aggregateMessage->inherit_super.header->size = ttLibC_DynamicBuffer_refSize(stream->aggregate_buffer);
+		aggregateMessage->inherit_super.header->timestamp = stream->aggregate_timestamp;
+		aggregateMessage->inherit_super.header->stream_id = stream->stream_id;
+		ttLibC_Tetty2Bootstrap_write(stream->conn->bootstrap, aggregateMessage, sizeof(ttLibC_AggregateMessage));
+		ttLibC_Tetty2Bootstrap_flush(stream->conn->bootstrap);
+		ttLibC_AggregateMessage_close(&aggregateMessage);
+	}
+	ttLibC_DynamicBuffer_empty(stream->aggregate_buffer);
+}
+
+/**
+ * send media message.
+ * in aggregate mode, message is held and sent later with other messages.
+ */
+static void RtmpStream_sendMessage(
+		ttLibC_RtmpStream_ *stream,
+		ttLibC_RtmpMessage *message,
+		bool is_flush) {
+	if(message == NULL) {
+		return;
+	}
+	if(stream->aggregate_window == 0) {
+		ttLibC_Tetty2Bootstrap_write(stream->conn->bootstrap, message, sizeof(ttLibC_RtmpMessage));
+		if(is_flush) {
+			ttLibC_Tetty2Bootstrap_flush(stream->conn->bootstrap);
+		}
+		return;
+	}
+	ttLibC_DynamicBuffer_empty(stream->aggregate_work_buffer);
+	if(!ttLibC_RtmpMessage_getData(NULL, message, stream->aggregate_work_buffer)) {
+		ERR_PRINT("failed to make binary for aggregate message.");
+		return;
+	}
+	uint32_t size = ttLibC_DynamicBuffer_refSize(stream->aggregate_work_buffer);
+	if(size == 0) {
+		return;
+	}
+	uint64_t timestamp = message->header->timestamp;
+	if(ttLibC_DynamicBuffer_refSize(stream->aggregate_buffer) == 0) {
+		stream->aggregate_timestamp = timestamp;
+		stream->aggregate_start_time = RtmpStream_now();
+	}
+	// flv tag: type, size, timestamp(24bit + 8bit ext), stream_id(always 0), data and prev tag size.
+	uint8_t tag[11];
+	tag[0] = message->header->message_type;
+	tag[1] = (size >> 16) & 0xFF;
+	tag[2] = (size >> 8) & 0xFF;
+	tag[3] = size & 0xFF;
+	tag[4] = (timestamp >> 16) & 0xFF;
+	tag[5] = (timestamp >> 8) & 0xFF;
+	tag[6] = timestamp & 0xFF;
+	tag[7] = (timestamp >> 24) & 0xFF;
+	tag[8] = 0;
+	tag[9] = 0;
+	tag[10] = 0;
+	uint32_t prev_size = be_uint32_t(size + 11);
+	ttLibC_DynamicBuffer_append(stream->aggregate_buffer, tag, 11);
+	ttLibC_DynamicBuffer_append(
+			stream->aggregate_buffer,
+			ttLibC_DynamicBuffer_refData(stream->aggregate_work_buffer),
+			size);
+	ttLibC_DynamicBuffer_append(stream->aggregate_buffer, (uint8_t *)&prev_size, 4);
+	// send when held duration reach the window, or buffer is full.
+	if(timestamp >= stream->aggregate_timestamp + stream->aggregate_window
+	|| ttLibC_DynamicBuffer_refSize(stream->aggregate_buffer) >= stream->aggregate_max_size) {
+		RtmpStream_flushAggregate(stream);
+		return;
+	}
+	ttLibC_RtmpStream_updateAggregate(stream);
+}
+
+/**
+ * send holding messages, if the first one is held over the window on wall clock.
+ * media timestamp does not move for sparse or stalled input, so wall clock is checked too.
+ */
+void TT_VISIBILITY_HIDDEN ttLibC_RtmpStream_updateAggregate(ttLibC_RtmpStream_ *stream) {
+	if(stream == NULL
+	|| stream->aggregate_buffer == NULL
+	|| ttLibC_DynamicBuffer_refSize(stream->aggregate_buffer) == 0) {
+		return;
+	}
+	if(RtmpStream_now() - stream->aggregate_start_time >= stream->aggregate_window) {
+		RtmpStream_flushAggregate(stream);
+	}
+}
+
+/**
+ * enable aggregate message for publish.
+ * @param stream
+ * @param window_msec max duration to hold frames in mili sec. 0 to disable.
+ * @param max_size    max size of aggregate message. 0 for default.(65536)
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_RtmpStream_setAggregate(
+		ttLibC_RtmpStream *stream,
+		uint32_t window_msec,
+		size_t max_size) {
+	ttLibC_RtmpStream_ *stream_ = (ttLibC_RtmpStream_ *)stream;
+	if(stream_ == NULL) {
+		return;
+	}
+	// send holding messages with old setting.
+	RtmpStream_flushAggregate(stream_);
+	stream_->aggregate_window = window_msec;
+	stream_->aggregate_max_size = max_size == 0 ? 65536 : max_size;
+	// connection update checks the window on wall clock.
+	ttLibC_StlList_remove(stream_->conn->aggregate_stream_list, stream_);
+	if(window_msec == 0) {
+		ttLibC_DynamicBuffer_close(&stream_->aggregate_buffer);
+		ttLibC_DynamicBuffer_close(&stream_->aggregate_work_buffer);
+		return;
+	}
+	ttLibC_StlList_addLast(stream_->conn->aggregate_stream_list, stream_);
+	if(stream_->aggregate_buffer == NULL) {
+		stream_->aggregate_buffer = ttLibC_DynamicBuffer_make();
+	}
+	if(stream_->aggregate_work_buffer == NULL) {
+		stream_->aggregate_work_buffer = ttLibC_DynamicBuffer_make();
+	}
+}
+
 bool TT_VISIBILITY_DEFAULT ttLibC_RtmpStream_addFrame(
 		ttLibC_RtmpStream *stream,
 		ttLibC_Frame *frame) {
@@ -220,14 +368,13 @@ bool TT_VISIBILITY_DEFAULT ttLibC_RtmpStream_addFrame(
 						ttLibC_AudioMessage *audioMessage = ttLibC_AudioMessage_addFrame(stream_->stream_id, (ttLibC_Audio *)audio);
 						if(audioMessage != NULL) {
 							audioMessage->is_dsi_info = true;
-							ttLibC_Tetty2Bootstrap_write(stream_->conn->bootstrap, audioMessage, sizeof(ttLibC_AudioMessage));
+							RtmpStream_sendMessage(stream_, (ttLibC_RtmpMessage *)audioMessage, false);
 							ttLibC_AudioMessage_close(&audioMessage);
 						}
 					}
 					ttLibC_AudioMessage *audioMessage = ttLibC_AudioMessage_addFrame(stream_->stream_id, (ttLibC_Audio *)audio);
 					if(audioMessage != NULL) {
-						ttLibC_Tetty2Bootstrap_write(stream_->conn->bootstrap, audioMessage, sizeof(ttLibC_AudioMessage));
-						ttLibC_Tetty2Bootstrap_flush(stream_->conn->bootstrap);
+						RtmpStream_sendMessage(stream_, (ttLibC_RtmpMessage *)audioMessage, true);
 						ttLibC_AudioMessage_close(&audioMessage);
 					}
 				}
@@ -236,8 +383,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_RtmpStream_addFrame(
 					video = ttLibC_FrameQueue_dequeue_first(stream_->video_queue);
 					ttLibC_VideoMessage *videoMessage = ttLibC_VideoMessage_addFrame(stream_->stream_id, (ttLibC_Video *)video);
 					if(videoMessage != NULL) {
-						ttLibC_Tetty2Bootstrap_write(stream_->conn->bootstrap, videoMessage, sizeof(ttLibC_VideoMessage));
-						ttLibC_Tetty2Bootstrap_flush(stream_->conn->bootstrap);
+						RtmpStream_sendMessage(stream_, (ttLibC_RtmpMessage *)videoMessage, true);
 						ttLibC_VideoMessage_close(&videoMessage);
 					}
 				}
@@ -255,14 +401,13 @@ bool TT_VISIBILITY_DEFAULT ttLibC_RtmpStream_addFrame(
 					ttLibC_AudioMessage *audioMessage = ttLibC_AudioMessage_addFrame(stream_->stream_id, (ttLibC_Audio *)audio);
 					if(audioMessage != NULL) {
 						audioMessage->is_dsi_info = true;
-						ttLibC_Tetty2Bootstrap_write(stream_->conn->bootstrap, audioMessage, sizeof(ttLibC_AudioMessage));
+						RtmpStream_sendMessage(stream_, (ttLibC_RtmpMessage *)audioMessage, false);
 						ttLibC_AudioMessage_close(&audioMessage);
 					}
 				}
 				ttLibC_AudioMessage *audioMessage = ttLibC_AudioMessage_addFrame(stream_->stream_id, (ttLibC_Audio *)audio);
 				if(audioMessage != NULL) {
-					ttLibC_Tetty2Bootstrap_write(stream_->conn->bootstrap, audioMessage, sizeof(ttLibC_AudioMessage));
-					ttLibC_Tetty2Bootstrap_flush(stream_->conn->bootstrap);
+					RtmpStream_sendMessage(stream_, (ttLibC_RtmpMessage *)audioMessage, true);
 					ttLibC_AudioMessage_close(&audioMessage);
 				}
 			}
@@ -280,8 +425,7 @@ bool TT_VISIBILITY_DEFAULT ttLibC_RtmpStream_addFrame(
 				count --;
 				video = ttLibC_FrameQueue_dequeue_first(stream_->video_queue);
 				ttLibC_VideoMessage *videoMessage = ttLibC_VideoMessage_addFrame(stream_->stream_id, (ttLibC_Video *)video);
-				ttLibC_Tetty2Bootstrap_write(stream_->conn->bootstrap, videoMessage, sizeof(ttLibC_VideoMessage));
-				ttLibC_Tetty2Bootstrap_flush(stream_->conn->bootstrap);
+				RtmpStream_sendMessage(stream_, (ttLibC_RtmpMessage *)videoMessage, true);
 				ttLibC_VideoMessage_close(&videoMessage);
 			}
 		}
@@ -359,6 +503,7 @@ void TT_VISIBILITY_DEFAULT ttLibC_RtmpStream_close(ttLibC_RtmpStream **stream) {
 	*stream = NULL; // *
 	// if we can, do stream.close command execute.
 	if(target->conn->bootstrap->error_number == 0) {
+		RtmpStream_flushAggregate(target);
 		// send close stream.
 		ttLibC_Amf0Command *closeStream = ttLibC_Amf0Command_closeStream(target->stream_id);
 		closeStream->inherit_super.header->timestamp = target->pts;
@@ -380,6 +525,9 @@ void TT_VISIBILITY_DEFAULT ttLibC_RtmpStream_close(ttLibC_RtmpStream **stream) {
 	ttLibC_FlvFrameManager_close(&target->frame_manager);
 	ttLibC_FrameQueue_close(&target->video_queue);
 	ttLibC_FrameQueue_close(&target->audio_queue);
+	ttLibC_StlList_remove(target->conn->aggregate_stream_list, target);
+	ttLibC_DynamicBuffer_close(&target->aggregate_buffer);
+	ttLibC_DynamicBuffer_close(&target->aggregate_work_buffer);
 	ttLibC_free(target);
 }
 
@@ -15,6 +15,7 @@ extern "C" {
 #include "../rtmp.h"
 #include "rtmpConnection.h"
 #include "../../../util/tetty2.h"
+#include "../../../util/dynamicBufferUtil.h"
 
 #include "../../../util/flvFrameUtil.h"
 #include "../../../container/misc.h"
@@ -43,10 +44,25 @@ typedef struct ttLibC_Net_Client_Rtmp2_RtmpStream_ {
 	ttLibC_Frame_Type audio_type;
 	ttLibC_FrameQueue *video_queue;
 	ttLibC_FrameQueue *audio_queue;
+
+	// aggregate mode for publish.
+	uint32_t aggregate_window; // 0 for disabled.
+	size_t aggregate_max_size;
+	uint64_t aggregate_timestamp; // timestamp of first message in buffer.
+	int64_t aggregate_start_time; // wall clock time of first message in buffer. (mili sec)
+	ttLibC_DynamicBuffer *aggregate_buffer;
+	ttLibC_DynamicBuffer *aggregate_work_buffer;
 } ttLibC_Net_Client_Rtmp2_RtmpStream_;
 
 typedef ttLibC_Net_Client_Rtmp2_RtmpStream_ ttLibC_RtmpStream_;
 
+/**
+ * send holding aggregate message, if window is passed on wall clock.
+ * called from ttLibC_RtmpConnection_update.
+ * @param stream
+ */
+void ttLibC_RtmpStream_updateAggregate(ttLibC_RtmpStream_ *stream);
+
 #ifdef __cplusplus
 }
 #endif
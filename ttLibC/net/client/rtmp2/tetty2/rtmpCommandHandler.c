@@ -86,11 +86,20 @@ static tetty2_errornum RtmpCommandHandler_write(
 				// clone command for result check.
 				ttLibC_Amf0Command *cloned_command = ttLibC_Amf0Command_make((const char *)amf0_command->command_name);
 				cloned_command->command_id = amf0_command->command_id;
+				// cloned objects are held on arena of cloned command.
+				size_t clone_size = 0;
 				if(amf0_command->obj1 != NULL) {
-					cloned_command->obj1 = ttLibC_Amf0_clone(amf0_command->obj1);
+					clone_size += amf0_command->obj1->data_size;
 				}
 				if(amf0_command->obj2 != NULL) {
-					cloned_command->obj2 = ttLibC_Amf0_clone(amf0_command->obj2);
+					clone_size += amf0_command->obj2->data_size;
+				}
+				cloned_command->arena = ttLibC_Amf0Arena_make(clone_size * 4);
+				if(amf0_command->obj1 != NULL) {
+					cloned_command->obj1 = ttLibC_Amf0_cloneArena(cloned_command->arena, amf0_command->obj1);
+				}
+				if(amf0_command->obj2 != NULL) {
+					cloned_command->obj2 = ttLibC_Amf0_cloneArena(cloned_command->arena, amf0_command->obj2);
 				}
 				cloned_command->promise = amf0_command->promise;
 				ttLibC_StlMap_put(client_object->commandId_command_map, (void *)((long)amf0_command->command_id), cloned_command);
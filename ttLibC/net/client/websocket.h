@@ -41,6 +41,8 @@ typedef struct ttLibC_Net_Client_WebSocketEvent {
 	ttLibC_WebSocket *target;
 	void *data;
 	size_t data_size;
+	/** for onmessagechunk, true on the last slice of message. */
+	bool is_last;
 } ttLibC_Net_Client_WebSocketEvent;
 
 typedef ttLibC_Net_Client_WebSocketEvent ttLibC_WebSocketEvent;
@@ -58,6 +60,12 @@ typedef struct ttLibC_Net_Client_WebSocket {
 	ttLibC_WebSocketEventFunc onclose;
 	/** event for receiving message^ */
 	ttLibC_WebSocketEventFunc onmessage;
+	/**
+	 * event for receiving slice of message.
+	 * if set, text and binary message is given as slices as they arrive, instead of onmessage.
+	 * (no null byte for text. control message is still given on onmessage.)
+	 */
+	ttLibC_WebSocketEventFunc onmessagechunk;
 	ttLibC_WebSocketEventFunc onopen;
 	ttLibC_WebSocketEventFunc onerror;
 	void *ptr; // you can put any data for ref.
@@ -102,6 +110,33 @@ void ttLibC_WebSocket_sendBinary(
 		ttLibC_WebSocket *socket,
 		void *data,
 		size_t data_size);
+/**
+ * producer for streaming send.
+ * @param ptr         user def pointer object.
+ * @param buffer      buffer to fill payload.
+ * @param buffer_size size of buffer.
+ * @return filled size. 0 for end of message.
+ */
+typedef size_t (* ttLibC_WebSocketProducerFunc)(void *ptr, void *buffer, size_t buffer_size);
+
+/**
+ * send message as sequence of frames, payload is pulled from producer.
+ * memory usage is bounded by chunk_size, for huge message.
+ * each frame is flushed before the next call of producer, write buffer holds one frame at most.
+ * @param socket     websocket object.
+ * @param opcode     WebSocketOpcode_text or WebSocketOpcode_binary
+ * @param chunk_size max payload size for each frame. 0 for default 64KiB.
+ * @param callback   producer for payload.
+ * @param ptr        user def pointer for callback.
+ * @return true:success false:error
+ */
+bool ttLibC_WebSocket_sendStream(
+		ttLibC_WebSocket *socket,
+		ttLibC_WebSocketEvent_Opcode opcode,
+		size_t chunk_size,
+		ttLibC_WebSocketProducerFunc callback,
+		void *ptr);
+
 /*
  * these function is used for internal only, now.
 void ttLibC_WebSocket_sendPing(ttLibC_WebSocket *socket);
@@ -109,6 +144,22 @@ void ttLibC_WebSocket_sendPong(ttLibC_WebSocket *socket);
 void ttLibC_WebSocket_sendClose(ttLibC_WebSocket *socket);
 */
 
+/**
+ * apply websocket mask on data.
+ * mask and unmask is the same xor operation, so this is used for both.
+ * @param dst       output buffer. can be the same as src for in place.
+ * @param src       input data.
+ * @param data_size size of data.
+ * @param mask      4byte mask key.
+ * @param offset    position of src from the beginning of payload. (for split payload)
+ */
+void ttLibC_WebSocket_mask(
+		void *dst,
+		const void *src,
+		size_t data_size,
+		const uint8_t *mask,
+		size_t offset);
+
 /**
  * close websocket.
  * @param socket
@@ -23,6 +23,7 @@ static tetty2_errornum WebSocketHandler_channelActive(ttLibC_Tetty2Context *ctx)
 		event.data_size = 0;
 		event.type = 0;
 		event.target = socket;
+		event.is_last = true;
 		socket->onopen(&event);
 	}
 	return 0;
@@ -122,10 +123,43 @@ static tetty2_errornum WebSocketHandler_channelRead(
 			handler->is_masked = is_masked;
 			handler->opcode = opcode;
 			handler->current_size = read_size;
+			handler->read_pos = 0;
 			handler->status = State_body;
 			buf = ttLibC_DynamicBuffer_refData(handler->read_buffer);
 		}
 		// current work for data body.
+		ttLibC_WebSocket *socket = (ttLibC_WebSocket *)ctx->tetty_info->ptr;
+		if(socket->onmessagechunk != NULL
+		&& (handler->opcode == WebSocketOpcode_text || handler->opcode == WebSocketOpcode_binary)) {
+			// streaming, give slice as it arrives, without recv_buffer.
+			size_t size = ttLibC_DynamicBuffer_refSize(handler->read_buffer);
+			if(size > (size_t)(handler->current_size - handler->read_pos)) {
+				size = (size_t)(handler->current_size - handler->read_pos);
+			}
+			if(handler->is_masked) {
+				// unmask in place, keep the mask phase from read_pos.
+				ttLibC_WebSocket_mask(buf, buf, size, handler->mask, handler->read_pos);
+			}
+			handler->read_pos += size;
+			ttLibC_WebSocketEvent event;
+			event.data = buf;
+			event.data_size = size;
+			event.target = socket;
+			event.type = handler->opcode;
+			event.is_last = handler->is_last_chunk && handler->read_pos == handler->current_size;
+			if(size > 0 || event.is_last) {
+				socket->onmessagechunk(&event);
+			}
+			ttLibC_DynamicBuffer_markAsRead(handler->read_buffer, size);
+			ttLibC_DynamicBuffer_clear(handler->read_buffer);
+			if(handler->read_pos < handler->current_size) {
+				// need more data. do later.
+				handler->in_reading = false;
+				return 0;
+			}
+			handler->status = State_header;
+			continue;
+		}
 		if(ttLibC_DynamicBuffer_refSize(handler->read_buffer) < (size_t)handler->current_size) {
 			// need more data. do later.
 			handler->in_reading = false;
@@ -133,10 +167,7 @@ static tetty2_errornum WebSocketHandler_channelRead(
 		}
 		if(handler->is_masked) {
 			// unmasked data.
-			uint8_t *b = buf;
-			for(int i = 0;i < handler->current_size;++ i) {
-				*b = *b ^ handler->mask[i % 4];
-			}
+			ttLibC_WebSocket_mask(buf, buf, handler->current_size, handler->mask, 0);
 		}
 		// copy data.
 		ttLibC_DynamicBuffer_append(handler->recv_buffer, buf, handler->current_size);
@@ -144,7 +175,6 @@ static tetty2_errornum WebSocketHandler_channelRead(
 		ttLibC_DynamicBuffer_clear(handler->read_buffer);
 		if(handler->is_last_chunk) {
 			// if current is last chunk. data is ready.
-			ttLibC_WebSocket *socket = (ttLibC_WebSocket *)ctx->tetty_info->ptr;
 			if(handler->opcode == WebSocketOpcode_text) {
 				// for the text, put null byte.
 				uint8_t null_str = 0x00;
@@ -156,6 +186,7 @@ static tetty2_errornum WebSocketHandler_channelRead(
 			event.data_size = ttLibC_DynamicBuffer_refSize(handler->recv_buffer);
 			event.target = socket;
 			event.type = handler->opcode;
+			event.is_last = true;
 			switch(event.type) {
 			case WebSocketOpcode_close:
 				if(socket->onclose != NULL) {
@@ -34,6 +34,8 @@ typedef struct ttLibC_Net_Client_WebSocket_Handler {
 	uint8_t mask[4];
 	ttLibC_WebSocketEvent_Opcode opcode;
 	int64_t current_size;
+	// read size of current frame body, for streaming.
+	int64_t read_pos;
 	ttLibC_WebSocketHandler_State status;
 	bool in_reading;
 } ttLibC_Net_Client_WebSocket_Handler;
@@ -82,6 +82,7 @@ ttLibC_WebSocket TT_VISIBILITY_DEFAULT *ttLibC_WebSocket_make(const char *addres
 	socket->inherit_super.onclose = NULL;
 	socket->inherit_super.onerror = NULL;
 	socket->inherit_super.onmessage = NULL;
+	socket->inherit_super.onmessagechunk = NULL;
 	socket->inherit_super.onopen = NULL;
 	socket->inherit_super.ptr = NULL;
 
@@ -168,27 +169,25 @@ void TT_VISIBILITY_HIDDEN ttLibC_WebSocket_sendClose(ttLibC_WebSocket *socket) {
 			0);
 }
 
-void TT_VISIBILITY_HIDDEN ttLibC_WebSocket__sendMessage(
-		ttLibC_WebSocket *socket,
+/*
+ * write frame header and mask key.
+ * @param socket_   websocket object.
+ * @param is_fin    true for the last frame of message.
+ * @param opcode    opcode for frame.
+ * @param data_size payload size.
+ * @param mask      ref for mask key, updated with new key.
+ * @return true:success false:error
+ */
+static bool WebSocket_writeHeader(
+		ttLibC_WebSocket_ *socket_,
+		bool is_fin,
 		ttLibC_WebSocketEvent_Opcode opcode,
-		void *data,
-		size_t data_size) {
-	ttLibC_WebSocket_ *socket_ = (ttLibC_WebSocket_ *)socket;
-	if(socket_->handshake_promise == NULL || !socket_->handshake_promise->is_done) {
-		ERR_PRINT("try to send message before handshake done.");
-		return;
-	}
-	// note: to support huge size of data.
-	// we can devide message into small chunks.
-	// but not support now.
-	/* example from rfc6455 docs.
-0x01 0x03 0x48 0x65 0x6c ( "Hel" )
-0x80 0x02 0x6c 0x6f ( "lo" )
-	 */
-	uint8_t buf[256];
+		size_t data_size,
+		uint8_t *mask) {
+	uint8_t buf[14];
 	size_t send_size = 0;
 	uint8_t *b8 = buf;
-	*b8 =  0x80 | opcode; // flag for message begining and opcode.
+	*b8 = (is_fin ? 0x80 : 0x00) | opcode; // flag for the last frame and opcode.
 	++ b8;
 	++ send_size;
 	// data from client should be masked.
@@ -197,7 +196,7 @@ void TT_VISIBILITY_HIDDEN ttLibC_WebSocket__sendMessage(
 		++ b8;
 		++ send_size;
 	}
-	else if(data_size < 0xFFFF) {
+	else if(data_size <= 0xFFFF) {
 		// data size with 16bit int.
 		*b8 = 0xFE;
 		++ b8;
@@ -218,33 +217,124 @@ void TT_VISIBILITY_HIDDEN ttLibC_WebSocket__sendMessage(
 	else {
 		// not possible to be here.
 		ERR_PRINT("unsupported data length.");
-		return;
+		return false;
 	}
-	ttLibC_Tetty2Bootstrap_write(socket_->bootstrap, buf, send_size);
 	// make mask bits from current unixtime.
-	uint8_t mask[4];
 	struct timeval mask_time;
 	gettimeofday(&mask_time, NULL);
 	mask[0] = mask_time.tv_sec & 0xFF;
 	mask[1] = mask_time.tv_usec & 0xFF;
 	mask[2] = (mask_time.tv_sec >> 8) & 0xFF;
 	mask[3] = (mask_time.tv_usec >> 8) & 0xFF;
-	// send mask
-	ttLibC_Tetty2Bootstrap_write(socket_->bootstrap, mask, 4);
+	memcpy(b8, mask, 4);
+	send_size += 4;
+	ttLibC_Tetty2Bootstrap_write(socket_->bootstrap, buf, send_size);
+	return true;
+}
+
+void TT_VISIBILITY_HIDDEN ttLibC_WebSocket__sendMessage(
+		ttLibC_WebSocket *socket,
+		ttLibC_WebSocketEvent_Opcode opcode,
+		void *data,
+		size_t data_size) {
+	ttLibC_WebSocket_ *socket_ = (ttLibC_WebSocket_ *)socket;
+	if(socket_->handshake_promise == NULL || !socket_->handshake_promise->is_done) {
+		ERR_PRINT("try to send message before handshake done.");
+		return;
+	}
+	// for huge data, use ttLibC_WebSocket_sendStream to divide into frames.
+	uint8_t mask[4];
+	if(!WebSocket_writeHeader(socket_, true, opcode, data_size, mask)) {
+		return;
+	}
 	// write data with masking.
+	uint8_t buf[256];
 	uint8_t *data_buf = data;
-	for(size_t i = 0;i < data_size;) {
-		buf[i % 256] = mask[i % 4] ^ data_buf[i];
-		++ i;
-		if(i != 0 && i % 256 == 0) {
-			ttLibC_Tetty2Bootstrap_write(socket_->bootstrap, buf, 256);
+	for(size_t i = 0;i < data_size;i += sizeof(buf)) {
+		size_t size = data_size - i;
+		if(size > sizeof(buf)) {
+			size = sizeof(buf);
 		}
+		ttLibC_WebSocket_mask(buf, data_buf + i, size, mask, i);
+		ttLibC_Tetty2Bootstrap_write(socket_->bootstrap, buf, size);
 	}
-	ttLibC_Tetty2Bootstrap_write(socket_->bootstrap, buf, data_size % 256);
 	// all done, flush and send.
 	ttLibC_Tetty2Bootstrap_flush(socket_->bootstrap);
 }
 
+/*
+ * send message as sequence of frames.
+ * @param socket     websocket object.
+ * @param opcode     WebSocketOpcode_text or WebSocketOpcode_binary
+ * @param chunk_size max payload size for each frame.
+ * @param callback   producer for payload.
+ * @param ptr        user def pointer for callback.
+ * @return true:success false:error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_WebSocket_sendStream(
+		ttLibC_WebSocket *socket,
+		ttLibC_WebSocketEvent_Opcode opcode,
+		size_t chunk_size,
+		ttLibC_WebSocketProducerFunc callback,
+		void *ptr) {
+	ttLibC_WebSocket_ *socket_ = (ttLibC_WebSocket_ *)socket;
+	if(socket_ == NULL || callback == NULL) {
+		return false;
+	}
+	if(socket_->handshake_promise == NULL || !socket_->handshake_promise->is_done) {
+		ERR_PRINT("try to send message before handshake done.");
+		return false;
+	}
+	if(opcode != WebSocketOpcode_text && opcode != WebSocketOpcode_binary) {
+		ERR_PRINT("only text or binary can be streamed.");
+		return false;
+	}
+	if(chunk_size == 0) {
+		chunk_size = 65536;
+	}
+	uint8_t *buf = ttLibC_malloc(chunk_size);
+	if(buf == NULL) {
+		ERR_PRINT("failed to allocate chunk buffer.");
+		return false;
+	}
+	/* example from rfc6455 docs.
+0x01 0x03 0x48 0x65 0x6c ( "Hel" )
+0x80 0x02 0x6c 0x6f ( "lo" )
+	 */
+	// each filled chunk is sent without fin, then finish with empty fin frame.
+	bool result = true;
+	uint8_t mask[4];
+	while(true) {
+		size_t size = callback(ptr, buf, chunk_size);
+		if(size > chunk_size) {
+			ERR_PRINT("producer returns too big size.");
+			result = false;
+			break;
+		}
+		if(size == 0) {
+			result = WebSocket_writeHeader(socket_, true, opcode, 0, mask);
+			break;
+		}
+		if(!WebSocket_writeHeader(socket_, false, opcode, size, mask)) {
+			result = false;
+			break;
+		}
+		// buffer is ours, mask in place.
+		ttLibC_WebSocket_mask(buf, buf, size, mask, 0);
+		ttLibC_Tetty2Bootstrap_write(socket_->bootstrap, buf, size);
+		// flush each frame, not to hold whole message in write buffer.
+		ttLibC_Tetty2Bootstrap_flush(socket_->bootstrap);
+		opcode = WebSocketOpcode_continue;
+		if(socket_->bootstrap->error_number != 0) {
+			result = false;
+			break;
+		}
+	}
+	ttLibC_free(buf);
+	ttLibC_Tetty2Bootstrap_flush(socket_->bootstrap);
+	return result;
+}
+
 void TT_VISIBILITY_DEFAULT ttLibC_WebSocket_close(ttLibC_WebSocket **socket) {
 	ttLibC_WebSocket_ *target = (ttLibC_WebSocket_ *)*socket;
 	if(target == NULL) {
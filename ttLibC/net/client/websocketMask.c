@@ -0,0 +1,100 @@
+/*
+ * @file   websocketMask.c
+ * @brief  mask / unmask for websocket payload.
+ *
+ * this code is under 3-Cause BSD License.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifdef __ENABLE_SOCKET__
+
+#include "websocket.h"
+#include "../../ttLibC_predef.h"
+#include <string.h>
+
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#	define WEBSOCKETMASK_USE_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#	include <emmintrin.h>
+#	define WEBSOCKETMASK_USE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	include <arm_neon.h>
+#	define WEBSOCKETMASK_USE_NEON
+#endif
+
+/*
+ * apply websocket mask.
+ * mask and unmask is the same xor operation.
+ * @param dst       output buffer. can be the same as src.
+ * @param src       input data.
+ * @param data_size size of data.
+ * @param mask      4byte mask key.
+ * @param offset    position of src from the beginning of payload.
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_WebSocket_mask(
+		void *dst,
+		const void *src,
+		size_t data_size,
+		const uint8_t *mask,
+		size_t offset) {
+	uint8_t *d = (uint8_t *)dst;
+	const uint8_t *s = (const uint8_t *)src;
+	size_t i = 0;
+	// scalar head, until dst is on 16byte alignment.
+	while(i < data_size && ((uintptr_t)(d + i) & 0x0F) != 0) {
+		d[i] = s[i] ^ mask[(offset + i) & 0x03];
+		++ i;
+	}
+	if(data_size - i < 8) {
+		for(;i < data_size;++ i) {
+			d[i] = s[i] ^ mask[(offset + i) & 0x03];
+		}
+		return;
+	}
+	// mask rotated for current position, word body keep this phase.
+	uint8_t rmask[8];
+	for(int j = 0;j < 8;++ j) {
+		rmask[j] = mask[(offset + i + j) & 0x03];
+	}
+	uint32_t m32;
+	memcpy(&m32, rmask, 4);
+#if defined(WEBSOCKETMASK_USE_AVX2)
+	// head gives 16byte alignment only, so unaligned store.
+	__m256i m256 = _mm256_set1_epi32((int)m32);
+	for(;i + 32 <= data_size;i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(s + i));
+		_mm256_storeu_si256((__m256i *)(d + i), _mm256_xor_si256(v, m256));
+	}
+#endif
+#if defined(WEBSOCKETMASK_USE_SSE2)
+	__m128i m128 = _mm_set1_epi32((int)m32);
+	for(;i + 16 <= data_size;i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+		_mm_store_si128((__m128i *)(d + i), _mm_xor_si128(v, m128));
+	}
+#elif defined(WEBSOCKETMASK_USE_NEON)
+	uint8x16_t m128 = vreinterpretq_u8_u32(vdupq_n_u32(m32));
+	for(;i + 16 <= data_size;i += 16) {
+		vst1q_u8(d + i, veorq_u8(vld1q_u8(s + i), m128));
+	}
+#endif
+	// 64bit word body.
+	uint64_t m64;
+	memcpy(&m64, rmask, 8);
+	for(;i + 8 <= data_size;i += 8) {
+		uint64_t v;
+		memcpy(&v, s + i, 8);
+		v ^= m64;
+		memcpy(d + i, &v, 8);
+	}
+	// scalar tail.
+	for(;i < data_size;++ i) {
+		d[i] = s[i] ^ mask[(offset + i) & 0x03];
+	}
+}
+
+#endif
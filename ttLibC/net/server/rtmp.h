@@ -0,0 +1,101 @@
+/**
+ * @file   rtmp.h
+ * @brief  support for rtmp server.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * one publisher for each stream name, and any number of players.
+ * media from publisher is serialized into chunks once, and the chunk binary is
+ * shared with all players which have the same stream_id.
+ * each player has own write queue, in the case of queue overflow,
+ * media is dropped until next keyFrame, so player always get complete gop.
+ *
+ * usage:
+ *   ttLibC_RtmpServer *server = ttLibC_RtmpServer_make(4096, 4 * 1024 * 1024);
+ *   ttLibC_RtmpServer_bind(server, 1935);
+ *   while(ttLibC_RtmpServer_update(server, 10000)) {
+ *   }
+ *   ttLibC_RtmpServer_close(&server);
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_NET_SERVER_RTMP_H_
+#define TTLIBC_NET_SERVER_RTMP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * data for rtmpServer
+ */
+typedef struct ttLibC_Net_Server_RtmpServer {
+	/** chunk size for send. */
+	uint32_t chunk_size;
+	/** max bytes for each player write queue. */
+	size_t max_queue_size;
+	/** number of connected clients. */
+	uint32_t client_num;
+	/** number of publishing streams. */
+	uint32_t publisher_num;
+	/** number of playing streams. */
+	uint32_t subscriber_num;
+	/** number of chunk serialize for media. */
+	uint64_t encode_count;
+	/** number of media message dropped for slow players. */
+	uint64_t drop_count;
+	/** error number. 0 for no error. */
+	int32_t error_number;
+	/** listening port, filled by bind.(useful for bind with port 0) */
+	int port;
+} ttLibC_Net_Server_RtmpServer;
+
+typedef ttLibC_Net_Server_RtmpServer ttLibC_RtmpServer;
+
+/**
+ * make rtmpServer object.
+ * @param chunk_size     chunk size for send. 128 - 65536
+ * @param max_queue_size max bytes of write queue for each player. 0 for default.(4MByte)
+ * @return rtmpServer object.
+ */
+ttLibC_RtmpServer *ttLibC_RtmpServer_make(
+		uint32_t chunk_size,
+		size_t max_queue_size);
+
+/**
+ * start listen.
+ * @param server rtmpServer object.
+ * @param port   port number for listen. 0 for ephemeral port, check server->port for actual one.
+ * @return true:success false:error
+ */
+bool ttLibC_RtmpServer_bind(
+		ttLibC_RtmpServer *server,
+		int port);
+
+/**
+ * update server event.
+ * @param server        rtmpServer object.
+ * @param wait_interval interval in micro sec.
+ * @return true:success false:error
+ */
+bool ttLibC_RtmpServer_update(
+		ttLibC_RtmpServer *server,
+		uint32_t wait_interval);
+
+/**
+ * close server, all clients are disconnected.
+ * @param server
+ */
+void ttLibC_RtmpServer_close(ttLibC_RtmpServer **server);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_NET_SERVER_RTMP_H_ */
@@ -0,0 +1,1121 @@
+/*
+ * @file   rtmpServer.c
+ * @brief  rtmp server on tetty2, one publisher and many players for each stream.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifdef __ENABLE_SOCKET__
+
+#include "../rtmp.h"
+#include "../../../ttLibC_predef.h"
+#include "../../../_log.h"
+#include "../../../allocator.h"
+#include "../../../util/amfUtil.h"
+#include "../../../util/dynamicBufferUtil.h"
+#include "../../../util/ioUtil.h"
+#include "../../../util/stlListUtil.h"
+#include "../../../util/tetty2/bootstrap.h"
+#include "../../tetty2/tcpBootstrap.h"
+#include "../../client/rtmp2/data/clientObject.h"
+#include "../../client/rtmp2/message/rtmpMessage.h"
+#include "../../client/rtmp2/message/acknowledgement.h"
+#include "../../client/rtmp2/message/aggregateMessage.h"
+#include "../../client/rtmp2/message/amf0Command.h"
+#include "../../client/rtmp2/message/amf0DataMessage.h"
+#include "../../client/rtmp2/message/audioMessage.h"
+#include "../../client/rtmp2/message/setChunkSize.h"
+#include "../../client/rtmp2/message/setPeerBandwidth.h"
+#include "../../client/rtmp2/message/userControlMessage.h"
+#include "../../client/rtmp2/message/videoMessage.h"
+#include "../../client/rtmp2/message/windowAcknowledgementSize.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+
+#ifdef MSG_NOSIGNAL
+#	define RTMPSERVER_SEND_FLAGS (MSG_DONTWAIT | MSG_NOSIGNAL)
+#else
+#	define RTMPSERVER_SEND_FLAGS MSG_DONTWAIT
+#endif
+
+#define RTMPSERVER_WINDOW_ACK_SIZE 2500000
+#define RTMPSERVER_MAX_SHARE_NUM 8
+
+typedef enum RtmpServer_PacketType {
+	/** command, metadata and sequence header. never dropped. */
+	RtmpServerPacket_control,
+	RtmpServerPacket_keyFrame,
+	RtmpServerPacket_innerFrame,
+	RtmpServerPacket_audio
+} RtmpServer_PacketType;
+
+/*
+ * serialized chunks of one message.
+ * shared by all players which have the same stream_id.
+ */
+typedef struct RtmpServer_Packet {
+	uint8_t *data;
+	size_t size;
+	uint32_t stream_id;
+	RtmpServer_PacketType type;
+	uint32_t ref_count;
+} RtmpServer_Packet;
+
+/*
+ * hold last message for late joined player.
+ */
+typedef struct RtmpServer_Cache {
+	ttLibC_DynamicBuffer *buffer;
+	uint64_t timestamp;
+	uint32_t cs_id;
+	ttLibC_RtmpMessage_Type message_type;
+} RtmpServer_Cache;
+
+struct RtmpServer_Client;
+
+typedef struct RtmpServer_Stream {
+	char name[256];
+	struct RtmpServer_Client *publisher;
+	ttLibC_StlList *players;
+	RtmpServer_Cache meta;
+	RtmpServer_Cache video_config;
+	RtmpServer_Cache audio_config;
+	bool has_video;
+} RtmpServer_Stream;
+
+typedef enum RtmpServer_HandshakePhase {
+	RtmpServerPhase_c1,
+	RtmpServerPhase_c2,
+	RtmpServerPhase_done
+} RtmpServer_HandshakePhase;
+
+typedef struct RtmpServer_Client {
+	struct ttLibC_Net_Server_RtmpServer_ *server;
+	ttLibC_TcpClientInfo *client_info;
+	ttLibC_ClientObject *client_object;
+	RtmpServer_HandshakePhase phase;
+	uint32_t next_stream_id;
+	RtmpServer_Stream *publish_stream;
+	uint32_t publish_stream_id;
+	RtmpServer_Stream *play_stream;
+	uint32_t play_stream_id;
+	/** true: skip media until next keyFrame. */
+	bool is_dropping;
+	/** true: write failed, wait for close. */
+	bool is_error;
+	uint64_t recv_size;
+	uint64_t ack_size;
+	// write queue. ring of packets.
+	RtmpServer_Packet **queue;
+	uint32_t queue_capacity;
+	uint32_t queue_head;
+	uint32_t queue_num;
+	/** written size of head packet. */
+	size_t queue_offset;
+	/** remain bytes in queue. */
+	size_t queue_size;
+} RtmpServer_Client;
+
+typedef struct RtmpServer_Handler {
+	ttLibC_Tetty2ChannelHandler channel_handler;
+	struct ttLibC_Net_Server_RtmpServer_ *server;
+} RtmpServer_Handler;
+
+typedef struct ttLibC_Net_Server_RtmpServer_ {
+	ttLibC_RtmpServer inherit_super;
+	ttLibC_Tetty2Bootstrap *bootstrap;
+	RtmpServer_Handler handler;
+	ttLibC_StlList *clients;
+	ttLibC_StlList *streams;
+	ttLibC_DynamicBuffer *work_buffer;
+	// packets made on current broadcast.
+	RtmpServer_Packet *shared_packets[RTMPSERVER_MAX_SHARE_NUM];
+	uint32_t shared_num;
+} ttLibC_Net_Server_RtmpServer_;
+
+typedef ttLibC_Net_Server_RtmpServer_ ttLibC_RtmpServer_;
+
+/*
+ * serialize message into chunks.
+ * use type0 header for the first chunk, so binary doesn't depend on the send history,
+ * and can be shared with other connections.
+ */
+static RtmpServer_Packet *RtmpServer_Packet_make(
+		uint32_t chunk_size,
+		uint32_t cs_id,
+		uint64_t timestamp,
+		ttLibC_RtmpMessage_Type message_type,
+		uint32_t stream_id,
+		uint8_t *data,
+		size_t data_size,
+		RtmpServer_PacketType type) {
+	size_t chunk_num = (data_size + chunk_size - 1) / chunk_size;
+	if(chunk_num == 0) {
+		chunk_num = 1;
+	}
+	RtmpServer_Packet *packet = ttLibC_malloc(sizeof(RtmpServer_Packet));
+	if(packet == NULL) {
+		return NULL;
+	}
+	// type0 is 18byte max, type3 is 3byte max.
+	packet->data = ttLibC_malloc(data_size + 18 + chunk_num * 3);
+	if(packet->data == NULL) {
+		ttLibC_free(packet);
+		return NULL;
+	}
+	ttLibC_RtmpHeader *header = ttLibC_RtmpHeader_make(cs_id, timestamp, message_type, stream_id);
+	if(header == NULL) {
+		ttLibC_free(packet->data);
+		ttLibC_free(packet);
+		return NULL;
+	}
+	header->type = Type0;
+	header->size = data_size;
+	uint8_t *buf = packet->data;
+	do {
+		buf += ttLibC_RtmpHeader_getData(header, buf, 18);
+		size_t write_size = data_size > chunk_size ? chunk_size : data_size;
+		memcpy(buf, data, write_size);
+		buf += write_size;
+		data += write_size;
+		data_size -= write_size;
+		header->type = Type3;
+	} while(data_size > 0);
+	ttLibC_RtmpHeader_close(&header);
+	packet->size = buf - packet->data;
+	packet->stream_id = stream_id;
+	packet->type = type;
+	packet->ref_count = 1;
+	return packet;
+}
+
+static void RtmpServer_Packet_release(RtmpServer_Packet **packet) {
+	RtmpServer_Packet *target = *packet;
+	if(target == NULL) {
+		return;
+	}
+	*packet = NULL;
+	if(-- target->ref_count != 0) {
+		return;
+	}
+	ttLibC_free(target->data);
+	ttLibC_free(target);
+}
+
+/*
+ * write queued packets as much as socket accept.
+ */
+static void RtmpServer_Client_flush(RtmpServer_Client *client) {
+	while(client->queue_num > 0 && !client->is_error) {
+		RtmpServer_Packet *packet = client->queue[client->queue_head];
+		ssize_t write_size = send(
+				client->client_info->inherit_super.socket,
+				packet->data + client->queue_offset,
+				packet->size - client->queue_offset,
+				RTMPSERVER_SEND_FLAGS);
+		if(write_size < 0) {
+			if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+				// socket buffer is full, try on next update.
+				return;
+			}
+			// connection is broken, shutdown to make bootstrap close this client.
+			client->is_error = true;
+			shutdown(client->client_info->inherit_super.socket, SHUT_RDWR);
+			return;
+		}
+		client->queue_offset += write_size;
+		client->queue_size -= write_size;
+		if(client->queue_offset < packet->size) {
+			return;
+		}
+		RtmpServer_Packet_release(&client->queue[client->queue_head]);
+		client->queue_head = (client->queue_head + 1) % client->queue_capacity;
+		-- client->queue_num;
+		client->queue_offset = 0;
+	}
+}
+
+/*
+ * put packet on write queue.
+ * for slow player, media is dropped from the point of overflow until next keyFrame.
+ * (in the case of audio only stream, until the queue is drained.)
+ */
+static void RtmpServer_Client_push(
+		RtmpServer_Client *client,
+		RtmpServer_Packet *packet) {
+	if(client->is_error) {
+		return;
+	}
+	ttLibC_RtmpServer_ *server = client->server;
+	if(packet->type != RtmpServerPacket_control) {
+		bool is_boundary = packet->type == RtmpServerPacket_keyFrame
+				|| (packet->type == RtmpServerPacket_audio
+						&& client->play_stream != NULL
+						&& !client->play_stream->has_video);
+		if(client->is_dropping) {
+			if(!is_boundary || client->queue_size > server->inherit_super.max_queue_size / 2) {
+				++ server->inherit_super.drop_count;
+				return;
+			}
+			client->is_dropping = false;
+		}
+		if(client->queue_size + packet->size > server->inherit_super.max_queue_size) {
+			client->is_dropping = true;
+			++ server->inherit_super.drop_count;
+			return;
+		}
+	}
+	if(client->queue_num == client->queue_capacity) {
+		// expand ring.
+		uint32_t capacity = client->queue_capacity * 2;
+		RtmpServer_Packet **queue = ttLibC_malloc(sizeof(RtmpServer_Packet *) * capacity);
+		if(queue == NULL) {
+			ERR_PRINT("failed to expand write queue.");
+			return;
+		}
+		for(uint32_t i = 0;i < client->queue_num;++ i) {
+			queue[i] = client->queue[(client->queue_head + i) % client->queue_capacity];
+		}
+		ttLibC_free(client->queue);
+		client->queue = queue;
+		client->queue_capacity = capacity;
+		client->queue_head = 0;
+	}
+	++ packet->ref_count;
+	client->queue[(client->queue_head + client->queue_num) % client->queue_capacity] = packet;
+	++ client->queue_num;
+	client->queue_size += packet->size;
+}
+
+/*
+ * serialize message object and send to one client.
+ */
+static void RtmpServer_Client_sendMessage(
+		RtmpServer_Client *client,
+		ttLibC_RtmpMessage *message) {
+	ttLibC_RtmpServer_ *server = client->server;
+	ttLibC_DynamicBuffer_empty(server->work_buffer);
+	if(!ttLibC_RtmpMessage_getData(client->client_object, message, server->work_buffer)) {
+		ERR_PRINT("failed to make binary for message:%d", message->header->message_type);
+		return;
+	}
+	RtmpServer_Packet *packet = RtmpServer_Packet_make(
+			client->client_object->send_chunk_size,
+			message->header->cs_id,
+			message->header->timestamp,
+			message->header->message_type,
+			message->header->stream_id,
+			ttLibC_DynamicBuffer_refData(server->work_buffer),
+			ttLibC_DynamicBuffer_refSize(server->work_buffer),
+			RtmpServerPacket_control);
+	if(packet == NULL) {
+		return;
+	}
+	RtmpServer_Client_push(client, packet);
+	RtmpServer_Packet_release(&packet);
+}
+
+static void RtmpServer_Client_sendStatus(
+		RtmpServer_Client *client,
+		uint32_t stream_id,
+		const char *level,
+		const char *code,
+		const char *description) {
+	ttLibC_Amf0Command *command = ttLibC_Amf0Command_make("onStatus");
+	if(command == NULL) {
+		return;
+	}
+	ttLibC_Amf0MapObject map_objects[] = {
+			{"level",       ttLibC_Amf0_string(level)},
+			{"code",        ttLibC_Amf0_string(code)},
+			{"description", ttLibC_Amf0_string(description)},
+			{NULL,          NULL}
+	};
+	command->command_id = 0;
+	command->obj1 = ttLibC_Amf0_null();
+	command->obj2 = ttLibC_Amf0_object(map_objects);
+	command->inherit_super.header->cs_id = 5;
+	command->inherit_super.header->stream_id = stream_id;
+	RtmpServer_Client_sendMessage(client, (ttLibC_RtmpMessage *)command);
+	ttLibC_Amf0Command_close(&command);
+}
+
+static void RtmpServer_Client_sendResult(
+		RtmpServer_Client *client,
+		int32_t command_id,
+		ttLibC_Amf0Object *obj1,
+		ttLibC_Amf0Object *obj2) {
+	ttLibC_Amf0Command *command = ttLibC_Amf0Command_make("_result");
+	if(command == NULL) {
+		ttLibC_Amf0_close(&obj1);
+		ttLibC_Amf0_close(&obj2);
+		return;
+	}
+	command->command_id = command_id;
+	command->obj1 = obj1;
+	command->obj2 = obj2;
+	RtmpServer_Client_sendMessage(client, (ttLibC_RtmpMessage *)command);
+	ttLibC_Amf0Command_close(&command);
+}
+
+static void RtmpServer_Cache_update(
+		RtmpServer_Cache *cache,
+		ttLibC_RtmpHeader *header,
+		uint8_t *data,
+		size_t data_size) {
+	if(cache->buffer == NULL) {
+		cache->buffer = ttLibC_DynamicBuffer_make();
+	}
+	ttLibC_DynamicBuffer_empty(cache->buffer);
+	ttLibC_DynamicBuffer_append(cache->buffer, data, data_size);
+	cache->timestamp = header->timestamp;
+	cache->cs_id = header->cs_id;
+	cache->message_type = header->message_type;
+}
+
+static void RtmpServer_Cache_send(
+		RtmpServer_Cache *cache,
+		RtmpServer_Client *client) {
+	if(cache->buffer == NULL || ttLibC_DynamicBuffer_refSize(cache->buffer) == 0) {
+		return;
+	}
+	RtmpServer_Packet *packet = RtmpServer_Packet_make(
+			client->client_object->send_chunk_size,
+			cache->cs_id,
+			cache->timestamp,
+			cache->message_type,
+			client->play_stream_id,
+			ttLibC_DynamicBuffer_refData(cache->buffer),
+			ttLibC_DynamicBuffer_refSize(cache->buffer),
+			RtmpServerPacket_control);
+	if(packet == NULL) {
+		return;
+	}
+	RtmpServer_Client_push(client, packet);
+	RtmpServer_Packet_release(&packet);
+}
+
+static void RtmpServer_Cache_clear(RtmpServer_Cache *cache) {
+	ttLibC_DynamicBuffer_close(&cache->buffer);
+}
+
+typedef struct RtmpServer_BroadcastInfo {
+	ttLibC_RtmpServer_ *server;
+	ttLibC_RtmpHeader *header;
+	uint8_t *data;
+	size_t data_size;
+	RtmpServer_PacketType type;
+} RtmpServer_BroadcastInfo;
+
+static bool RtmpServer_broadcastCallback(void *ptr, void *item) {
+	RtmpServer_BroadcastInfo *info = (RtmpServer_BroadcastInfo *)ptr;
+	RtmpServer_Client *client = (RtmpServer_Client *)item;
+	ttLibC_RtmpServer_ *server = info->server;
+	// reuse chunks for the same stream_id.
+	RtmpServer_Packet *packet = NULL;
+	for(uint32_t i = 0;i < server->shared_num;++ i) {
+		if(server->shared_packets[i]->stream_id == client->play_stream_id) {
+			packet = server->shared_packets[i];
+			break;
+		}
+	}
+	if(packet == NULL) {
+		packet = RtmpServer_Packet_make(
+				server->inherit_super.chunk_size,
+				info->header->cs_id,
+				info->header->timestamp,
+				info->header->message_type,
+				client->play_stream_id,
+				info->data,
+				info->data_size,
+				info->type);
+		if(packet == NULL) {
+			return true;
+		}
+		++ server->inherit_super.encode_count;
+		if(server->shared_num < RTMPSERVER_MAX_SHARE_NUM) {
+			server->shared_packets[server->shared_num ++] = packet;
+		}
+		else {
+			RtmpServer_Client_push(client, packet);
+			RtmpServer_Packet_release(&packet);
+			RtmpServer_Client_flush(client);
+			return true;
+		}
+	}
+	RtmpServer_Client_push(client, packet);
+	RtmpServer_Client_flush(client);
+	return true;
+}
+
+/*
+ * send message from publisher to all players.
+ */
+static void RtmpServer_Stream_broadcast(
+		ttLibC_RtmpServer_ *server,
+		RtmpServer_Stream *stream,
+		ttLibC_RtmpHeader *header,
+		uint8_t *data,
+		size_t data_size,
+		RtmpServer_PacketType type) {
+	RtmpServer_BroadcastInfo info;
+	info.server = server;
+	info.header = header;
+	info.data = data;
+	info.data_size = data_size;
+	info.type = type;
+	server->shared_num = 0;
+	ttLibC_StlList_forEach(stream->players, RtmpServer_broadcastCallback, &info);
+	for(uint32_t i = 0;i < server->shared_num;++ i) {
+		RtmpServer_Packet_release(&server->shared_packets[i]);
+	}
+	server->shared_num = 0;
+}
+
+static bool RtmpServer_findStreamCallback(void *ptr, void *item) {
+	RtmpServer_Stream **target = (RtmpServer_Stream **)ptr;
+	RtmpServer_Stream *stream = (RtmpServer_Stream *)item;
+	if(strcmp(stream->name, (*target)->name) == 0) {
+		*target = stream;
+		return false;
+	}
+	return true;
+}
+
+/*
+ * ref stream for name, make if not exist.
+ */
+static RtmpServer_Stream *RtmpServer_refStream(
+		ttLibC_RtmpServer_ *server,
+		const char *name) {
+	RtmpServer_Stream key;
+	RtmpServer_Stream *stream = &key;
+	strncpy(key.name, name, sizeof(key.name) - 1);
+	key.name[sizeof(key.name) - 1] = 0;
+	ttLibC_StlList_forEach(server->streams, RtmpServer_findStreamCallback, &stream);
+	if(stream != &key) {
+		return stream;
+	}
+	stream = ttLibC_malloc(sizeof(RtmpServer_Stream));
+	if(stream == NULL) {
+		return NULL;
+	}
+	memset(stream, 0, sizeof(RtmpServer_Stream));
+	strcpy(stream->name, key.name);
+	stream->players = ttLibC_StlList_make();
+	ttLibC_StlList_addLast(server->streams, stream);
+	return stream;
+}
+
+/*
+ * remove stream, if nobody use it.
+ */
+static void RtmpServer_checkStream(
+		ttLibC_RtmpServer_ *server,
+		RtmpServer_Stream *stream) {
+	if(stream->publisher != NULL || stream->players->size != 0) {
+		return;
+	}
+	ttLibC_StlList_remove(server->streams, stream);
+	RtmpServer_Cache_clear(&stream->meta);
+	RtmpServer_Cache_clear(&stream->video_config);
+	RtmpServer_Cache_clear(&stream->audio_config);
+	ttLibC_StlList_close(&stream->players);
+	ttLibC_free(stream);
+}
+
+static bool RtmpServer_unpublishCallback(void *ptr, void *item) {
+	(void)ptr;
+	RtmpServer_Client *client = (RtmpServer_Client *)item;
+	RtmpServer_Client_sendStatus(client, client->play_stream_id, "status", "NetStream.Play.UnpublishNotify", "stream is unpublished.");
+	RtmpServer_Client_flush(client);
+	// wait for keyFrame of next publish.
+	client->is_dropping = true;
+	return true;
+}
+
+/*
+ * detach client from publish / play stream.
+ */
+static void RtmpServer_Client_detach(RtmpServer_Client *client) {
+	ttLibC_RtmpServer_ *server = client->server;
+	RtmpServer_Stream *stream = client->publish_stream;
+	if(stream != NULL) {
+		stream->publisher = NULL;
+		RtmpServer_Cache_clear(&stream->meta);
+		RtmpServer_Cache_clear(&stream->video_config);
+		RtmpServer_Cache_clear(&stream->audio_config);
+		stream->has_video = false;
+		ttLibC_StlList_forEach(stream->players, RtmpServer_unpublishCallback, NULL);
+		client->publish_stream = NULL;
+		client->publish_stream_id = 0;
+		-- server->inherit_super.publisher_num;
+		RtmpServer_checkStream(server, stream);
+	}
+	stream = client->play_stream;
+	if(stream != NULL) {
+		ttLibC_StlList_remove(stream->players, client);
+		client->play_stream = NULL;
+		client->play_stream_id = 0;
+		-- server->inherit_super.subscriber_num;
+		RtmpServer_checkStream(server, stream);
+	}
+}
+
+static void RtmpServer_Client_onConnect(
+		RtmpServer_Client *client,
+		ttLibC_Amf0Command *command) {
+	ttLibC_RtmpServer_ *server = client->server;
+	ttLibC_RtmpMessage *message = NULL;
+	message = (ttLibC_RtmpMessage *)ttLibC_WindowAcknowledgementSize_make(RTMPSERVER_WINDOW_ACK_SIZE);
+	if(message != NULL) {
+		RtmpServer_Client_sendMessage(client, message);
+		ttLibC_RtmpMessage_close(&message);
+	}
+	message = (ttLibC_RtmpMessage *)ttLibC_SetPeerBandwidth_make(RTMPSERVER_WINDOW_ACK_SIZE, LimitType_Dynamic);
+	if(message != NULL) {
+		RtmpServer_Client_sendMessage(client, message);
+		ttLibC_RtmpMessage_close(&message);
+	}
+	message = (ttLibC_RtmpMessage *)ttLibC_SetChunkSize_make(server->inherit_super.chunk_size);
+	if(message != NULL) {
+		RtmpServer_Client_sendMessage(client, message);
+		ttLibC_RtmpMessage_close(&message);
+		// from now, all chunks are made with server chunk_size.
+		client->client_object->send_chunk_size = server->inherit_super.chunk_size;
+	}
+	ttLibC_Amf0MapObject properties[] = {
+			{"fmsVer",       ttLibC_Amf0_string("FMS/3,0,1,123")},
+			{"capabilities", ttLibC_Amf0_number(31)},
+			{NULL,           NULL}
+	};
+	ttLibC_Amf0MapObject information[] = {
+			{"level",          ttLibC_Amf0_string("status")},
+			{"code",           ttLibC_Amf0_string("NetConnection.Connect.Success")},
+			{"description",    ttLibC_Amf0_string("Connection succeeded.")},
+			{"objectEncoding", ttLibC_Amf0_number(0)},
+			{NULL,             NULL}
+	};
+	RtmpServer_Client_sendResult(
+			client,
+			command->command_id,
+			ttLibC_Amf0_object(properties),
+			ttLibC_Amf0_object(information));
+}
+
+static void RtmpServer_Client_onPublish(
+		RtmpServer_Client *client,
+		ttLibC_Amf0Command *command) {
+	ttLibC_RtmpServer_ *server = client->server;
+	uint32_t stream_id = command->inherit_super.header->stream_id;
+	if(command->obj2 == NULL || command->obj2->type != amf0Type_String) {
+		RtmpServer_Client_sendStatus(client, stream_id, "error", "NetStream.Publish.BadName", "stream name is missing.");
+		return;
+	}
+	RtmpServer_Client_detach(client);
+	RtmpServer_Stream *stream = RtmpServer_refStream(server, (const char *)command->obj2->object);
+	if(stream == NULL) {
+		return;
+	}
+	if(stream->publisher != NULL) {
+		RtmpServer_Client_sendStatus(client, stream_id, "error", "NetStream.Publish.BadName", "stream is already publishing.");
+		RtmpServer_checkStream(server, stream);
+		return;
+	}
+	stream->publisher = client;
+	client->publish_stream = stream;
+	client->publish_stream_id = stream_id;
+	++ server->inherit_super.publisher_num;
+	RtmpServer_Client_sendStatus(client, stream_id, "status", "NetStream.Publish.Start", "start publishing.");
+}
+
+static void RtmpServer_Client_onPlay(
+		RtmpServer_Client *client,
+		ttLibC_Amf0Command *command) {
+	ttLibC_RtmpServer_ *server = client->server;
+	uint32_t stream_id = command->inherit_super.header->stream_id;
+	if(command->obj2 == NULL || command->obj2->type != amf0Type_String) {
+		RtmpServer_Client_sendStatus(client, stream_id, "error", "NetStream.Play.StreamNotFound", "stream name is missing.");
+		return;
+	}
+	RtmpServer_Client_detach(client);
+	RtmpServer_Stream *stream = RtmpServer_refStream(server, (const char *)command->obj2->object);
+	if(stream == NULL) {
+		return;
+	}
+	ttLibC_StlList_addLast(stream->players, client);
+	client->play_stream = stream;
+	client->play_stream_id = stream_id;
+	++ server->inherit_super.subscriber_num;
+	ttLibC_UserControlMessage *begin = ttLibC_UserControlMessage_make(Type_StreamBegin, stream_id, 0, 0);
+	if(begin != NULL) {
+		RtmpServer_Client_sendMessage(client, (ttLibC_RtmpMessage *)begin);
+		ttLibC_UserControlMessage_close(&begin);
+	}
+	RtmpServer_Client_sendStatus(client, stream_id, "status", "NetStream.Play.Reset", "reset playing.");
+	RtmpServer_Client_sendStatus(client, stream_id, "status", "NetStream.Play.Start", "start playing.");
+	// config for decoder, then wait for keyFrame.
+	RtmpServer_Cache_send(&stream->meta, client);
+	RtmpServer_Cache_send(&stream->video_config, client);
+	RtmpServer_Cache_send(&stream->audio_config, client);
+	client->is_dropping = true;
+}
+
+static void RtmpServer_Client_onCommand(
+		RtmpServer_Client *client,
+		ttLibC_Amf0Command *command) {
+	const char *name = (const char *)command->command_name;
+	if(strcmp(name, "connect") == 0) {
+		RtmpServer_Client_onConnect(client, command);
+	}
+	else if(strcmp(name, "createStream") == 0) {
+		RtmpServer_Client_sendResult(
+				client,
+				command->command_id,
+				ttLibC_Amf0_null(),
+				ttLibC_Amf0_number(++ client->next_stream_id));
+	}
+	else if(strcmp(name, "publish") == 0) {
+		RtmpServer_Client_onPublish(client, command);
+	}
+	else if(strcmp(name, "play") == 0) {
+		RtmpServer_Client_onPlay(client, command);
+	}
+	else if(strcmp(name, "deleteStream") == 0
+			|| strcmp(name, "closeStream") == 0
+			|| strcmp(name, "FCUnpublish") == 0) {
+		if(strcmp(name, "closeStream") == 0) {
+			// client side close waits for onStatus.
+			if(client->publish_stream != NULL) {
+				RtmpServer_Client_sendStatus(client, client->publish_stream_id, "status", "NetStream.Unpublish.Success", "stop publishing.");
+			}
+			else if(client->play_stream != NULL) {
+				RtmpServer_Client_sendStatus(client, client->play_stream_id, "status", "NetStream.Play.Stop", "stop playing.");
+			}
+		}
+		RtmpServer_Client_detach(client);
+	}
+	else if(command->command_id > 0) {
+		// releaseStream, FCPublish, getStreamLength... reply with null.
+		RtmpServer_Client_sendResult(
+				client,
+				command->command_id,
+				ttLibC_Amf0_null(),
+				NULL);
+	}
+}
+
+static void RtmpServer_Client_onDataMessage(
+		RtmpServer_Client *client,
+		ttLibC_Amf0DataMessage *message) {
+	RtmpServer_Stream *stream = client->publish_stream;
+	if(stream == NULL) {
+		return;
+	}
+	ttLibC_RtmpServer_ *server = client->server;
+	// @setDataFrame onMetaData {} -> onMetaData {}
+	ttLibC_Amf0DataMessage *meta = NULL;
+	if(strcmp((const char *)message->message_name, "@setDataFrame") == 0) {
+		meta = ttLibC_Amf0DataMessage_make("onMetaData");
+		if(meta == NULL) {
+			return;
+		}
+		meta->obj1 = message->obj2;
+	}
+	else if(strcmp((const char *)message->message_name, "onMetaData") == 0) {
+		meta = ttLibC_Amf0DataMessage_make("onMetaData");
+		if(meta == NULL) {
+			return;
+		}
+		meta->obj1 = message->obj1;
+	}
+	else {
+		return;
+	}
+	ttLibC_DynamicBuffer_empty(server->work_buffer);
+	bool result = ttLibC_Amf0DataMessage_getData(meta, server->work_buffer);
+	// obj is owned by received message.
+	meta->obj1 = NULL;
+	ttLibC_Amf0DataMessage_close(&meta);
+	if(!result) {
+		return;
+	}
+	ttLibC_RtmpHeader *header = message->inherit_super.header;
+	RtmpServer_Cache_update(
+			&stream->meta,
+			header,
+			ttLibC_DynamicBuffer_refData(server->work_buffer),
+			ttLibC_DynamicBuffer_refSize(server->work_buffer));
+	RtmpServer_Stream_broadcast(
+			server,
+			stream,
+			header,
+			ttLibC_DynamicBuffer_refData(stream->meta.buffer),
+			ttLibC_DynamicBuffer_refSize(stream->meta.buffer),
+			RtmpServerPacket_control);
+}
+
+static void RtmpServer_Client_onMedia(
+		RtmpServer_Client *client,
+		ttLibC_RtmpHeader *header,
+		uint8_t *data) {
+	RtmpServer_Stream *stream = client->publish_stream;
+	if(stream == NULL || data == NULL || header->size < 2) {
+		return;
+	}
+	RtmpServer_PacketType type = RtmpServerPacket_audio;
+	if(header->message_type == RtmpMessageType_videoMessage) {
+		stream->has_video = true;
+		if((data[0] & 0x0F) == 7 && data[1] == 0) {
+			// avc sequence header.
+			RtmpServer_Cache_update(&stream->video_config, header, data, header->size);
+			type = RtmpServerPacket_control;
+		}
+		else if((data[0] >> 4) == 1) {
+			type = RtmpServerPacket_keyFrame;
+		}
+		else {
+			type = RtmpServerPacket_innerFrame;
+		}
+	}
+	else if((data[0] >> 4) == 10 && data[1] == 0) {
+		// aac sequence header.
+		RtmpServer_Cache_update(&stream->audio_config, header, data, header->size);
+		type = RtmpServerPacket_control;
+	}
+	RtmpServer_Stream_broadcast(client->server, stream, header, data, header->size, type);
+}
+
+/*
+ * split aggregate message, and handle each flv tag as media message.
+ */
+static void RtmpServer_Client_onAggregate(
+		RtmpServer_Client *client,
+		ttLibC_AggregateMessage *message) {
+	uint8_t *data = message->data;
+	size_t data_size = message->inherit_super.header->size;
+	if(data == NULL) {
+		return;
+	}
+	ttLibC_RtmpHeader header;
+	memcpy(&header, message->inherit_super.header, sizeof(ttLibC_RtmpHeader));
+	int64_t timestamp_diff = 0;
+	bool is_first = true;
+	while(data_size >= 11) {
+		uint32_t size = (data[1] << 16) | (data[2] << 8) | data[3];
+		uint32_t timestamp = (data[4] << 16) | (data[5] << 8) | data[6] | (data[7] << 24);
+		if(data_size < 11 + size) {
+			ERR_PRINT("data size is too small for aggregate message.");
+			return;
+		}
+		// tag timestamp is relative to the message timestamp.
+		if(is_first) {
+			timestamp_diff = (int64_t)message->inherit_super.header->timestamp - timestamp;
+			is_first = false;
+		}
+		header.message_type = data[0];
+		header.size = size;
+		header.timestamp = timestamp + timestamp_diff;
+		switch(header.message_type) {
+		case RtmpMessageType_audioMessage:
+			header.cs_id = 7;
+			RtmpServer_Client_onMedia(client, &header, data + 11);
+			break;
+		case RtmpMessageType_videoMessage:
+			header.cs_id = 6;
+			RtmpServer_Client_onMedia(client, &header, data + 11);
+			break;
+		default:
+			break;
+		}
+		if(data_size < 11 + size + 4) {
+			return;
+		}
+		data += 11 + size + 4;
+		data_size -= 11 + size + 4;
+	}
+}
+
+static void RtmpServer_Client_onMessage(
+		RtmpServer_Client *client,
+		ttLibC_RtmpMessage *message) {
+	switch(message->header->message_type) {
+	case RtmpMessageType_setChunkSize:
+		client->client_object->recv_chunk_size = ((ttLibC_SetChunkSize *)message)->size;
+		break;
+	case RtmpMessageType_userControlMessage:
+		{
+			ttLibC_UserControlMessage *user_control = (ttLibC_UserControlMessage *)message;
+			if(user_control->type == Type_Ping) {
+				ttLibC_UserControlMessage *pong = ttLibC_UserControlMessage_pong(user_control->time);
+				if(pong != NULL) {
+					RtmpServer_Client_sendMessage(client, (ttLibC_RtmpMessage *)pong);
+					ttLibC_UserControlMessage_close(&pong);
+				}
+			}
+		}
+		break;
+	case RtmpMessageType_amf0Command:
+		RtmpServer_Client_onCommand(client, (ttLibC_Amf0Command *)message);
+		break;
+	case RtmpMessageType_amf0DataMessage:
+		RtmpServer_Client_onDataMessage(client, (ttLibC_Amf0DataMessage *)message);
+		break;
+	case RtmpMessageType_videoMessage:
+		RtmpServer_Client_onMedia(client, message->header, ((ttLibC_VideoMessage *)message)->data);
+		break;
+	case RtmpMessageType_audioMessage:
+		RtmpServer_Client_onMedia(client, message->header, ((ttLibC_AudioMessage *)message)->data);
+		break;
+	case RtmpMessageType_aggregateMessage:
+		RtmpServer_Client_onAggregate(client, (ttLibC_AggregateMessage *)message);
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * simple handshake.
+ * c0 c1 -> s0 s1 s2(copy of c1), then wait for c2.
+ */
+static bool RtmpServer_Client_handshake(RtmpServer_Client *client) {
+	ttLibC_DynamicBuffer *buffer = client->client_object->recv_buffer;
+	switch(client->phase) {
+	case RtmpServerPhase_c1:
+		{
+			if(ttLibC_DynamicBuffer_refSize(buffer) < 1537) {
+				return false;
+			}
+			uint8_t *buf = ttLibC_DynamicBuffer_refData(buffer);
+			if(buf[0] != 0x03) {
+				ERR_PRINT("incompatible rtmp type.:%x", buf[0]);
+				client->is_error = true;
+				shutdown(client->client_info->inherit_super.socket, SHUT_RDWR);
+				return false;
+			}
+			RtmpServer_Packet *packet = ttLibC_malloc(sizeof(RtmpServer_Packet));
+			if(packet == NULL) {
+				return false;
+			}
+			packet->size = 1 + 1536 + 1536;
+			packet->data = ttLibC_malloc(packet->size);
+			if(packet->data == NULL) {
+				ttLibC_free(packet);
+				return false;
+			}
+			packet->stream_id = 0;
+			packet->type = RtmpServerPacket_control;
+			packet->ref_count = 1;
+			struct timeval tv;
+			gettimeofday(&tv, NULL);
+			uint32_t time = be_uint32_t((uint32_t)(tv.tv_sec * 1000 + tv.tv_usec / 1000));
+			packet->data[0] = 0x03;
+			memcpy(packet->data + 1, &time, 4);
+			memset(packet->data + 5, 0, 4);
+			for(int i = 9;i < 1537;++ i) {
+				packet->data[i] = (uint8_t)(rand() & 0xFF);
+			}
+			memcpy(packet->data + 1537, buf + 1, 1536);
+			RtmpServer_Client_push(client, packet);
+			RtmpServer_Packet_release(&packet);
+			RtmpServer_Client_flush(client);
+			ttLibC_DynamicBuffer_markAsRead(buffer, 1537);
+			client->phase = RtmpServerPhase_c2;
+		}
+		/* no break */
+	case RtmpServerPhase_c2:
+		if(ttLibC_DynamicBuffer_refSize(buffer) < 1536) {
+			return false;
+		}
+		ttLibC_DynamicBuffer_markAsRead(buffer, 1536);
+		ttLibC_DynamicBuffer_clear(buffer);
+		client->phase = RtmpServerPhase_done;
+		/* no break */
+	default:
+		return true;
+	}
+}
+
+static tetty2_errornum RtmpServer_channelActive(ttLibC_Tetty2Context *ctx) {
+	ttLibC_RtmpServer_ *server = ((RtmpServer_Handler *)ctx->channel_handler)->server;
+	RtmpServer_Client *client = ttLibC_malloc(sizeof(RtmpServer_Client));
+	if(client == NULL) {
+		return 0;
+	}
+	memset(client, 0, sizeof(RtmpServer_Client));
+	client->server = server;
+	client->client_info = (ttLibC_TcpClientInfo *)ctx->tetty_info->bootstrap_ptr;
+	client->client_object = ttLibC_ClientObject_make();
+	client->queue_capacity = 64;
+	client->queue = ttLibC_malloc(sizeof(RtmpServer_Packet *) * client->queue_capacity);
+	if(client->client_object == NULL || client->queue == NULL) {
+		ERR_PRINT("failed to make client.");
+		ttLibC_ClientObject_close(&client->client_object);
+		ttLibC_free(client->queue);
+		ttLibC_free(client);
+		return 0;
+	}
+	client->phase = RtmpServerPhase_c1;
+	ctx->tetty_info->ptr = client;
+	ttLibC_StlList_addLast(server->clients, client);
+	++ server->inherit_super.client_num;
+	return 0;
+}
+
+static tetty2_errornum RtmpServer_channelRead(
+		ttLibC_Tetty2Context *ctx,
+		void *data,
+		size_t data_size) {
+	RtmpServer_Client *client = (RtmpServer_Client *)ctx->tetty_info->ptr;
+	if(client == NULL || client->is_error) {
+		return 0;
+	}
+	ttLibC_ClientObject *client_object = client->client_object;
+	ttLibC_DynamicBuffer_append(client_object->recv_buffer, data, data_size);
+	if(!RtmpServer_Client_handshake(client)) {
+		return 0;
+	}
+	// acknowledgement for publisher.
+	client->recv_size += data_size;
+	if(client->recv_size - client->ack_size >= RTMPSERVER_WINDOW_ACK_SIZE) {
+		client->ack_size = client->recv_size;
+		ttLibC_Acknowledgement *ack = ttLibC_Acknowledgement_make((uint32_t)client->recv_size);
+		if(ack != NULL) {
+			RtmpServer_Client_sendMessage(client, (ttLibC_RtmpMessage *)ack);
+			ttLibC_Acknowledgement_close(&ack);
+		}
+	}
+	ttLibC_RtmpMessage *message = NULL;
+	while(!client->is_error
+			&& (message = ttLibC_RtmpMessage_readBinary(client_object->recv_buffer, client_object)) != NULL) {
+		RtmpServer_Client_onMessage(client, message);
+		ttLibC_RtmpMessage_close(&message);
+	}
+	RtmpServer_Client_flush(client);
+	return 0;
+}
+
+static tetty2_errornum RtmpServer_close(ttLibC_Tetty2Context *ctx) {
+	RtmpServer_Client *client = (RtmpServer_Client *)ctx->tetty_info->ptr;
+	if(client == NULL) {
+		return 0;
+	}
+	ttLibC_RtmpServer_ *server = client->server;
+	RtmpServer_Client_detach(client);
+	ttLibC_StlList_remove(server->clients, client);
+	while(client->queue_num > 0) {
+		RtmpServer_Packet_release(&client->queue[client->queue_head]);
+		client->queue_head = (client->queue_head + 1) % client->queue_capacity;
+		-- client->queue_num;
+	}
+	ttLibC_free(client->queue);
+	ttLibC_ClientObject_close(&client->client_object);
+	ttLibC_free(client);
+	ctx->tetty_info->ptr = NULL;
+	-- server->inherit_super.client_num;
+	return 0;
+}
+
+ttLibC_RtmpServer TT_VISIBILITY_DEFAULT *ttLibC_RtmpServer_make(
+		uint32_t chunk_size,
+		size_t max_queue_size) {
+	if(chunk_size < 128 || chunk_size > 65536) {
+		ERR_PRINT("chunk_size is out of range.:%u", chunk_size);
+		return NULL;
+	}
+	ttLibC_RtmpServer_ *server = ttLibC_malloc(sizeof(ttLibC_RtmpServer_));
+	if(server == NULL) {
+		ERR_PRINT("failed to allocate memory for server.");
+		return NULL;
+	}
+	memset(server, 0, sizeof(ttLibC_RtmpServer_));
+	server->bootstrap = ttLibC_TcpBootstrap_make();
+	server->clients = ttLibC_StlList_make();
+	server->streams = ttLibC_StlList_make();
+	server->work_buffer = ttLibC_DynamicBuffer_make();
+	if(server->bootstrap == NULL || server->clients == NULL || server->streams == NULL || server->work_buffer == NULL) {
+		ERR_PRINT("failed to make server.");
+		ttLibC_RtmpServer_close((ttLibC_RtmpServer **)&server);
+		return NULL;
+	}
+	ttLibC_TcpBootstrap_setOption(server->bootstrap, Tetty2Option_SO_KEEPALIVE);
+	ttLibC_TcpBootstrap_setOption(server->bootstrap, Tetty2Option_SO_REUSEADDR);
+	ttLibC_TcpBootstrap_setOption(server->bootstrap, Tetty2Option_TCP_NODELAY);
+	server->handler.channel_handler.channelActive = RtmpServer_channelActive;
+	server->handler.channel_handler.channelRead = RtmpServer_channelRead;
+	server->handler.channel_handler.close = RtmpServer_close;
+	server->handler.server = server;
+	ttLibC_Tetty2Bootstrap_pipeline_addLast(server->bootstrap, &server->handler);
+	server->inherit_super.chunk_size = chunk_size;
+	server->inherit_super.max_queue_size = max_queue_size == 0 ? 4 * 1024 * 1024 : max_queue_size;
+	return (ttLibC_RtmpServer *)server;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_RtmpServer_bind(
+		ttLibC_RtmpServer *server,
+		int port) {
+	ttLibC_RtmpServer_ *server_ = (ttLibC_RtmpServer_ *)server;
+	if(server_ == NULL) {
+		return false;
+	}
+	if(!ttLibC_TcpBootstrap_bind(server_->bootstrap, port)) {
+		server_->inherit_super.error_number = server_->bootstrap->error_number;
+		return false;
+	}
+	// get actual port, in the case of port 0.
+	ttLibC_SocketInfo *socket_info = (ttLibC_SocketInfo *)((ttLibC_Tetty2Bootstrap_ *)server_->bootstrap)->tetty_info.bootstrap_ptr;
+	struct sockaddr_in addr;
+	socklen_t addr_size = sizeof(addr);
+	if(getsockname(socket_info->socket, (struct sockaddr *)&addr, &addr_size) == 0) {
+		server_->inherit_super.port = ntohs(addr.sin_port);
+	}
+	else {
+		server_->inherit_super.port = port;
+	}
+	return true;
+}
+
+static bool RtmpServer_flushCallback(void *ptr, void *item) {
+	(void)ptr;
+	RtmpServer_Client *client = (RtmpServer_Client *)item;
+	RtmpServer_Client_flush(client);
+	return true;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_RtmpServer_update(
+		ttLibC_RtmpServer *server,
+		uint32_t wait_interval) {
+	ttLibC_RtmpServer_ *server_ = (ttLibC_RtmpServer_ *)server;
+	if(server_ == NULL) {
+		return false;
+	}
+	ttLibC_TcpBootstrap_update(server_->bootstrap, wait_interval);
+	// write pending data for slow clients.
+	ttLibC_StlList_forEach(server_->clients, RtmpServer_flushCallback, NULL);
+	server_->inherit_super.error_number = server_->bootstrap->error_number;
+	return server_->inherit_super.error_number == 0;
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_RtmpServer_close(ttLibC_RtmpServer **server) {
+	ttLibC_RtmpServer_ *target = (ttLibC_RtmpServer_ *)*server;
+	if(target == NULL) {
+		return;
+	}
+	// all clients are closed with close event, and streams are removed.
+	ttLibC_Tetty2Bootstrap_close(&target->bootstrap);
+	ttLibC_StlList_close(&target->clients);
+	ttLibC_StlList_close(&target->streams);
+	ttLibC_DynamicBuffer_close(&target->work_buffer);
+	ttLibC_free(target);
+	*server = NULL;
+}
+
+#endif
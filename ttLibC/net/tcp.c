@@ -89,6 +89,12 @@ ttLibC_TcpClientInfo TT_VISIBILITY_DEFAULT *ttLibC_TcpServer_wait(
 	}
 	memset(client_info, 0, sizeof(ttLibC_TcpClientInfo));
 	client_info->write_buffer = NULL;
+	client_info->inherit_super.addr = ttLibC_SockaddrIn_make();
+	if(client_info->inherit_super.addr == NULL) {
+		ERR_PRINT("failed to allocate sockaddr.");
+		ttLibC_free(client_info);
+		return NULL;
+	}
 	while(true) {
 		ttLibC_SockaddrIn_ *addr = (ttLibC_SockaddrIn_ *)client_info->inherit_super.addr;
 		socklen_t client_addr_len = sizeof(addr->addr);
@@ -103,6 +109,7 @@ ttLibC_TcpClientInfo TT_VISIBILITY_DEFAULT *ttLibC_TcpServer_wait(
 			continue;
 		}
 		ERR_PRINT("failed to accept.");
+		ttLibC_SockaddrIn_close(&client_info->inherit_super.addr);
 		ttLibC_free(client_info);
 		return NULL;
 	}
@@ -287,13 +287,14 @@ static bool TcpBootstrap_updateEach(void *ptr, void *item) {
 	ttLibC_TcpClientInfo *client_info = (ttLibC_TcpClientInfo *)item;
 	if(ttLibC_Fdset_FD_ISSET((ttLibC_SocketInfo *)client_info, tcpBootstrap->fdchkset)) {
 		uint8_t buffer[65536];
-		size_t read_size;
+		int64_t read_size;
 		memset((void *)buffer, 0, sizeof(buffer));
 		read_size = ttLibC_TcpClient_read(client_info, buffer, sizeof(buffer));
 		ttLibC_Tetty2Info info;
 		info.bootstrap_ptr = client_info;
 		info.ptr = client_info->inherit_super.ptr;
-		if(read_size == 0) {
+		if(read_size <= 0) {
+			// closed by remote, or connection reset.
 			ttLibC_StlList_remove(tcpBootstrap->tcp_client_info_list, client_info);
 			TcpBootstrap_closeClient(client_info, tcpBootstrap);
 			// return false, to stop forEach operation.
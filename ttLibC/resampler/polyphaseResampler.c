@@ -0,0 +1,732 @@
+/*
+ * @file   polyphaseResampler.c
+ * @brief  native polyphase windowed-sinc resampler.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "polyphaseResampler.h"
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+#include "../ttLibC_common.h"
+#include "../util/ioUtil.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__SSE__) || defined(_M_X64)
+#	include <xmmintrin.h>
+#	define POLYPHASE_USE_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	include <arm_neon.h>
+#	define POLYPHASE_USE_NEON
+#endif
+
+/** phase number limit for exact phase table, use interpolated table over this. */
+#define POLYPHASE_EXACT_PHASE_MAX 1024
+/** phase number for interpolated table. */
+#define POLYPHASE_INTERPOLATE_PHASE_NUM 256
+
+/**
+ * polyphase resampler detail definition.
+ */
+typedef struct {
+	/** inherit data from ttLibC_PolyphaseResampler */
+	ttLibC_PolyphaseResampler inherit_super;
+	/** up sampling factor (output_sample_rate / gcd) */
+	uint32_t up;
+	/** down sampling factor (input_sample_rate / gcd) */
+	uint32_t down;
+	/** true:phase_num is smaller than up, interpolate between 2 phases. */
+	bool is_interpolate;
+	/** (phase_num + 1) * tap_num coefficients */
+	float *filter_bank;
+	/** input history for each channel, planar float. */
+	float *history[2];
+	/** allocated sample num for history. */
+	uint32_t history_size;
+	/** valid sample num in history. */
+	uint32_t history_num;
+	/** float output work for pcms16. */
+	float *work;
+	/** allocated sample num for work. */
+	uint32_t work_size;
+	/** current phase numerator, 0 - up-1 */
+	uint32_t phase;
+	/** next output pts, in output_sample_rate timebase. */
+	uint64_t pts;
+	/** true:pts is not decided yet. */
+	bool is_first;
+	/** pool for output frame, used when prev_frame is NULL. */
+	ttLibC_FramePool *pool;
+} ttLibC_Resampler_PolyphaseResampler_;
+
+typedef ttLibC_Resampler_PolyphaseResampler_ ttLibC_PolyphaseResampler_;
+
+static uint32_t PolyphaseResampler_gcd(uint32_t a, uint32_t b) {
+	while(b != 0) {
+		uint32_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/**
+ * modified bessel function of the first kind order 0, for kaiser window.
+ */
+static double PolyphaseResampler_besselI0(double x) {
+	double sum = 1.0;
+	double term = 1.0;
+	double half_x = x / 2.0;
+	for(int k = 1;k < 64;++ k) {
+		term *= (half_x / k) * (half_x / k);
+		sum += term;
+		if(term < sum * 1e-12) {
+			break;
+		}
+	}
+	return sum;
+}
+
+/**
+ * inner product of coefficient and sample.
+ * @param coef  filter coefficient.
+ * @param data  sample data.
+ * @param num   number of taps, must be multiple of 4.
+ */
+static inline float PolyphaseResampler_dot(const float *coef, const float *data, uint32_t num) {
+#if defined(POLYPHASE_USE_SSE)
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	uint32_t i = 0;
+	for(;i + 8 <= num;i += 8) {
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(coef + i),     _mm_loadu_ps(data + i)));
+		acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(coef + i + 4), _mm_loadu_ps(data + i + 4)));
+	}
+	for(;i < num;i += 4) {
+		acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(coef + i), _mm_loadu_ps(data + i)));
+	}
+	acc0 = _mm_add_ps(acc0, acc1);
+	acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+	acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, 1));
+	return _mm_cvtss_f32(acc0);
+#elif defined(POLYPHASE_USE_NEON)
+	float32x4_t acc = vdupq_n_f32(0.0f);
+	for(uint32_t i = 0;i < num;i += 4) {
+		acc = vmlaq_f32(acc, vld1q_f32(coef + i), vld1q_f32(data + i));
+	}
+	float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+	return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#else
+	float acc0 = 0.0f, acc1 = 0.0f, acc2 = 0.0f, acc3 = 0.0f;
+	for(uint32_t i = 0;i < num;i += 4) {
+		acc0 += coef[i]     * data[i];
+		acc1 += coef[i + 1] * data[i + 1];
+		acc2 += coef[i + 2] * data[i + 2];
+		acc3 += coef[i + 3] * data[i + 3];
+	}
+	return (acc0 + acc1) + (acc2 + acc3);
+#endif
+}
+
+/**
+ * make filter bank.
+ * each phase p hold the kaiser windowed sinc, centered on input position p / phase_num.
+ */
+static bool PolyphaseResampler_makeFilterBank(ttLibC_PolyphaseResampler_ *resampler) {
+	uint32_t base_half = 16;
+	double beta = 7.0;
+	double rolloff = 0.90;
+	switch(resampler->inherit_super.quality) {
+	case PolyphaseResamplerQuality_low:
+		base_half = 8;
+		beta = 5.0;
+		rolloff = 0.85;
+		break;
+	default:
+	case PolyphaseResamplerQuality_medium:
+		break;
+	case PolyphaseResamplerQuality_high:
+		base_half = 32;
+		beta = 8.6;
+		rolloff = 0.94;
+		break;
+	case PolyphaseResamplerQuality_best:
+		base_half = 64;
+		beta = 10.0;
+		rolloff = 0.96;
+		break;
+	}
+	double cutoff = rolloff;
+	uint32_t half = base_half;
+	if(resampler->up < resampler->down) {
+		// down sampling, cut on output nyquist and stretch the filter to keep transition width.
+		double ratio = (double)resampler->up / resampler->down;
+		cutoff *= ratio;
+		half = (uint32_t)ceil(base_half / ratio);
+	}
+	// keep tap_num multiple of 4 for simd.
+	half = (half + 1) & ~1;
+	uint32_t tap_num = half * 2;
+	uint32_t phase_num = resampler->up;
+	resampler->is_interpolate = false;
+	if(phase_num > POLYPHASE_EXACT_PHASE_MAX) {
+		phase_num = POLYPHASE_INTERPOLATE_PHASE_NUM;
+		resampler->is_interpolate = true;
+	}
+	resampler->filter_bank = ttLibC_malloc(sizeof(float) * tap_num * (phase_num + 1));
+	if(resampler->filter_bank == NULL) {
+		return false;
+	}
+	double i0_beta = PolyphaseResampler_besselI0(beta);
+	for(uint32_t p = 0;p <= phase_num;++ p) {
+		float *coef = resampler->filter_bank + p * tap_num;
+		double sum = 0.0;
+		for(uint32_t j = 0;j < tap_num;++ j) {
+			// distance from output position to this tap, in input samples.
+			double d = (double)j - half + 1 - (double)p / phase_num;
+			double x = d / half;
+			double value = 0.0;
+			if(x > -1.0 && x < 1.0) {
+				double t = M_PI * cutoff * d;
+				double sinc = (t == 0.0) ? 1.0 : sin(t) / t;
+				value = cutoff * sinc * PolyphaseResampler_besselI0(beta * sqrt(1.0 - x * x)) / i0_beta;
+			}
+			coef[j] = (float)value;
+			sum += value;
+		}
+		// normalize dc gain.
+		for(uint32_t j = 0;j < tap_num;++ j) {
+			coef[j] = (float)(coef[j] / sum);
+		}
+	}
+	resampler->inherit_super.tap_num   = tap_num;
+	resampler->inherit_super.phase_num = phase_num;
+	return true;
+}
+
+/*
+ * make polyphase resampler.
+ * @param channel_num        target channel num 1:monoral 2:stereo
+ * @param input_sample_rate  input sample rate
+ * @param output_sample_rate output sample rate
+ * @param quality            quality tier
+ * @return resampler object.
+ */
+ttLibC_PolyphaseResampler TT_VISIBILITY_DEFAULT *ttLibC_PolyphaseResampler_make(
+		uint32_t channel_num,
+		uint32_t input_sample_rate,
+		uint32_t output_sample_rate,
+		ttLibC_PolyphaseResampler_Quality quality) {
+	if(channel_num != 1 && channel_num != 2) {
+		ERR_PRINT("channel_num must be 1 or 2.:%d", channel_num);
+		return NULL;
+	}
+	if(input_sample_rate == 0 || output_sample_rate == 0) {
+		ERR_PRINT("sample_rate is invalid.");
+		return NULL;
+	}
+	ttLibC_PolyphaseResampler_ *resampler = (ttLibC_PolyphaseResampler_ *)ttLibC_malloc(sizeof(ttLibC_PolyphaseResampler_));
+	if(resampler == NULL) {
+		ERR_PRINT("failed to allocate resampler object.");
+		return NULL;
+	}
+	memset(resampler, 0, sizeof(ttLibC_PolyphaseResampler_));
+	uint32_t gcd = PolyphaseResampler_gcd(input_sample_rate, output_sample_rate);
+	resampler->up   = output_sample_rate / gcd;
+	resampler->down = input_sample_rate / gcd;
+	resampler->inherit_super.channel_num        = channel_num;
+	resampler->inherit_super.input_sample_rate  = input_sample_rate;
+	resampler->inherit_super.output_sample_rate = output_sample_rate;
+	resampler->inherit_super.quality            = quality;
+	resampler->inherit_super.error              = Error_noError;
+	if(!PolyphaseResampler_makeFilterBank(resampler)) {
+		ERR_PRINT("failed to make filter bank.");
+		ttLibC_free(resampler);
+		return NULL;
+	}
+	ttLibC_PolyphaseResampler_reset((ttLibC_PolyphaseResampler *)resampler);
+	return (ttLibC_PolyphaseResampler *)resampler;
+}
+
+/**
+ * make sure the history can hold additional samples.
+ */
+static bool PolyphaseResampler_reserve(ttLibC_PolyphaseResampler_ *resampler, uint32_t add_num) {
+	uint32_t need = resampler->history_num + add_num;
+	if(need <= resampler->history_size) {
+		return true;
+	}
+	uint32_t size = need + (need >> 1);
+	for(uint32_t i = 0;i < resampler->inherit_super.channel_num;++ i) {
+		float *buf = ttLibC_malloc(sizeof(float) * size);
+		if(buf == NULL) {
+			return false;
+		}
+		if(resampler->history[i] != NULL) {
+			memcpy(buf, resampler->history[i], sizeof(float) * resampler->history_num);
+			ttLibC_free(resampler->history[i]);
+		}
+		resampler->history[i] = buf;
+	}
+	resampler->history_size = size;
+	return true;
+}
+
+/**
+ * decide the start pts from first input frame.
+ */
+static void PolyphaseResampler_updatePts(ttLibC_PolyphaseResampler_ *resampler, ttLibC_Frame *src_frame) {
+	if(!resampler->is_first) {
+		return;
+	}
+	if(src_frame->timebase == 0) {
+		resampler->pts = 0;
+	}
+	else {
+		resampler->pts = src_frame->pts * resampler->inherit_super.output_sample_rate / src_frame->timebase;
+	}
+	resampler->is_first = false;
+}
+
+/**
+ * count output samples for current history, without moving position.
+ */
+static uint32_t PolyphaseResampler_countOutput(ttLibC_PolyphaseResampler_ *resampler) {
+	uint32_t tap_num = resampler->inherit_super.tap_num;
+	if(resampler->history_num < tap_num) {
+		return 0;
+	}
+	// output k use history[ipos_k ... ipos_k + tap_num), ipos_k = (phase + k * down) / up
+	uint64_t pos_num = resampler->history_num - tap_num + 1;
+	return (uint32_t)((pos_num * resampler->up - resampler->phase - 1) / resampler->down + 1);
+}
+
+/**
+ * run filter for all channels.
+ * @param resampler
+ * @param out_num   output sample num (from countOutput)
+ * @param l_out     output for left channel
+ * @param r_out     output for right channel
+ * @param step      output step in float.
+ */
+static void PolyphaseResampler_process(
+		ttLibC_PolyphaseResampler_ *resampler,
+		uint32_t out_num,
+		float *l_out,
+		float *r_out,
+		uint32_t step) {
+	uint32_t tap_num   = resampler->inherit_super.tap_num;
+	uint32_t phase_num = resampler->inherit_super.phase_num;
+	uint32_t up        = resampler->up;
+	uint32_t down      = resampler->down;
+	float *outs[2] = {l_out, r_out};
+	uint32_t ipos = 0;
+	uint32_t phase = resampler->phase;
+	for(uint32_t ch = 0;ch < resampler->inherit_super.channel_num;++ ch) {
+		const float *history = resampler->history[ch];
+		float *out = outs[ch];
+		ipos = 0;
+		phase = resampler->phase;
+		if(!resampler->is_interpolate) {
+			for(uint32_t k = 0;k < out_num;++ k) {
+				*out = PolyphaseResampler_dot(resampler->filter_bank + phase * tap_num, history + ipos, tap_num);
+				out += step;
+				phase += down;
+				ipos += phase / up;
+				phase %= up;
+			}
+		}
+		else {
+			for(uint32_t k = 0;k < out_num;++ k) {
+				uint64_t pos = (uint64_t)phase * phase_num;
+				uint32_t index = (uint32_t)(pos / up);
+				float mu = (float)(pos % up) / up;
+				const float *coef = resampler->filter_bank + index * tap_num;
+				float a = PolyphaseResampler_dot(coef, history + ipos, tap_num);
+				float b = PolyphaseResampler_dot(coef + tap_num, history + ipos, tap_num);
+				*out = a + (b - a) * mu;
+				out += step;
+				phase += down;
+				ipos += phase / up;
+				phase %= up;
+			}
+		}
+	}
+	// move unused samples to the head of history.
+	uint32_t remain = resampler->history_num - ipos;
+	for(uint32_t ch = 0;ch < resampler->inherit_super.channel_num;++ ch) {
+		memmove(resampler->history[ch], resampler->history[ch] + ipos, sizeof(float) * remain);
+	}
+	resampler->history_num = remain;
+	resampler->phase = phase;
+}
+
+/**
+ * get output buffer, reuse prev_frame memory if possible.
+ */
+static uint8_t *PolyphaseResampler_getBuffer(
+		ttLibC_Frame *prev_frame,
+		size_t *data_size,
+		bool *alloc_flag) {
+	uint8_t *data = NULL;
+	*alloc_flag = false;
+	if(prev_frame != NULL) {
+		if(!prev_frame->is_non_copy) {
+			if(prev_frame->data_size >= *data_size) {
+				// reuse frame have enough buffer.
+				data = prev_frame->data;
+				*data_size = prev_frame->data_size;
+			}
+			else {
+				ttLibC_free(prev_frame->data);
+			}
+		}
+		prev_frame->is_non_copy = true;
+	}
+	if(data == NULL) {
+		data = ttLibC_malloc(*data_size);
+		*alloc_flag = true;
+	}
+	return data;
+}
+
+/*
+ * sample_rate resample for pcms16.
+ * @param resampler  resampler object.
+ * @param prev_frame reuse frame.
+ * @param src_pcms16 source pcms16 data.
+ * @return resampled pcms16 data. NULL for error or no output yet.
+ */
+ttLibC_PcmS16 TT_VISIBILITY_DEFAULT *ttLibC_PolyphaseResampler_resamplePcmS16(
+		ttLibC_PolyphaseResampler *resampler,
+		ttLibC_PcmS16 *prev_frame,
+		ttLibC_PcmS16 *src_pcms16) {
+	ttLibC_PolyphaseResampler_ *resampler_ = (ttLibC_PolyphaseResampler_ *)resampler;
+	if(resampler_ == NULL) {
+		return NULL;
+	}
+	if(src_pcms16 == NULL) {
+		return NULL;
+	}
+	uint32_t channel_num = resampler_->inherit_super.channel_num;
+	if(src_pcms16->inherit_super.channel_num != channel_num
+	|| src_pcms16->inherit_super.sample_rate != resampler_->inherit_super.input_sample_rate) {
+		resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_InvalidInput);
+		return NULL;
+	}
+	uint32_t in_num = src_pcms16->inherit_super.sample_num;
+	if(!PolyphaseResampler_reserve(resampler_, in_num)) {
+		resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_MemoryAllocate);
+		return NULL;
+	}
+	PolyphaseResampler_updatePts(resampler_, (ttLibC_Frame *)src_pcms16);
+	// append input to history.
+	const int16_t *src_l = (const int16_t *)src_pcms16->l_data;
+	const int16_t *src_r = NULL;
+	uint32_t src_step = 1;
+	bool is_big_endian = false;
+	switch(src_pcms16->type) {
+	case PcmS16Type_bigEndian:
+		is_big_endian = true;
+		/* no break */
+	case PcmS16Type_littleEndian:
+		if(channel_num == 2) {
+			src_r = src_l + 1;
+			src_step = 2;
+		}
+		break;
+	case PcmS16Type_bigEndian_planar:
+		is_big_endian = true;
+		/* no break */
+	case PcmS16Type_littleEndian_planar:
+		src_r = (const int16_t *)src_pcms16->r_data;
+		break;
+	default:
+		resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_InvalidInput);
+		return NULL;
+	}
+	float *dst_l = resampler_->history[0] + resampler_->history_num;
+	float *dst_r = channel_num == 2 ? resampler_->history[1] + resampler_->history_num : NULL;
+	for(uint32_t i = 0;i < in_num;++ i) {
+		int16_t l_val = is_big_endian ? be_int16_t(*src_l) : le_int16_t(*src_l);
+		dst_l[i] = l_val / 32768.0f;
+		src_l += src_step;
+		if(dst_r != NULL) {
+			int16_t r_val = is_big_endian ? be_int16_t(*src_r) : le_int16_t(*src_r);
+			dst_r[i] = r_val / 32768.0f;
+			src_r += src_step;
+		}
+	}
+	resampler_->history_num += in_num;
+	uint32_t out_num = PolyphaseResampler_countOutput(resampler_);
+	if(out_num == 0) {
+		return NULL;
+	}
+	if(resampler_->work_size < out_num * channel_num) {
+		ttLibC_free(resampler_->work);
+		resampler_->work_size = out_num * channel_num * 2;
+		resampler_->work = ttLibC_malloc(sizeof(float) * resampler_->work_size);
+		if(resampler_->work == NULL) {
+			resampler_->work_size = 0;
+			resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_MemoryAllocate);
+			return NULL;
+		}
+	}
+	float *work = resampler_->work;
+	PolyphaseResampler_process(resampler_, out_num, work, channel_num == 2 ? work + 1 : NULL, channel_num);
+	size_t data_size = out_num * channel_num * sizeof(int16_t);
+	bool alloc_flag = false;
+	if(prev_frame == NULL) {
+		prev_frame = (ttLibC_PcmS16 *)ttLibC_FramePool_getAudio(resampler_->pool, frameType_pcmS16, src_pcms16->type, channel_num);
+	}
+	uint8_t *data = PolyphaseResampler_getBuffer((ttLibC_Frame *)prev_frame, &data_size, &alloc_flag);
+	if(data == NULL) {
+		resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_MemoryAllocate);
+		return NULL;
+	}
+	uint8_t *l_data = data;
+	uint32_t l_stride = out_num * 2 * channel_num;
+	uint8_t *r_data = NULL;
+	uint32_t r_stride = 0;
+	uint32_t dst_step = channel_num;
+	int16_t *out_l = (int16_t *)data;
+	int16_t *out_r = NULL;
+	switch(src_pcms16->type) {
+	default:
+	case PcmS16Type_bigEndian:
+	case PcmS16Type_littleEndian:
+		if(channel_num == 2) {
+			out_r = out_l + 1;
+		}
+		break;
+	case PcmS16Type_bigEndian_planar:
+	case PcmS16Type_littleEndian_planar:
+		l_stride = out_num * 2;
+		dst_step = 1;
+		if(channel_num == 2) {
+			out_r = out_l + out_num;
+			r_data = (uint8_t *)out_r;
+			r_stride = l_stride;
+		}
+		break;
+	}
+	for(uint32_t i = 0;i < out_num;++ i) {
+		for(uint32_t ch = 0;ch < channel_num;++ ch) {
+			float value = work[i * channel_num + ch] * 32768.0f;
+			int32_t ivalue = (int32_t)lrintf(value);
+			if(ivalue > 32767) {
+				ivalue = 32767;
+			}
+			else if(ivalue < -32768) {
+				ivalue = -32768;
+			}
+			int16_t *out = ch == 0 ? out_l : out_r;
+			out[i * dst_step] = is_big_endian ? be_int16_t((int16_t)ivalue) : le_int16_t((int16_t)ivalue);
+		}
+	}
+	ttLibC_PcmS16 *pcms16 = ttLibC_PcmS16_make(
+			prev_frame,
+			src_pcms16->type,
+			resampler_->inherit_super.output_sample_rate,
+			out_num,
+			channel_num,
+			data,
+			data_size,
+			l_data,
+			l_stride,
+			r_data,
+			r_stride,
+			true,
+			resampler_->pts,
+			resampler_->inherit_super.output_sample_rate);
+	if(pcms16 == NULL) {
+		if(alloc_flag) {
+			ttLibC_free(data);
+		}
+		resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_MemoryAllocate);
+		return NULL;
+	}
+	pcms16->inherit_super.inherit_super.is_non_copy = false;
+	pcms16->inherit_super.inherit_super.id = src_pcms16->inherit_super.inherit_super.id;
+	resampler_->pts += out_num;
+	return pcms16;
+}
+
+/*
+ * sample_rate resample for pcmf32.
+ * @param resampler  resampler object.
+ * @param prev_frame reuse frame.
+ * @param src_pcmf32 source pcmf32 data.
+ * @return resampled pcmf32 data. NULL for error or no output yet.
+ */
+ttLibC_PcmF32 TT_VISIBILITY_DEFAULT *ttLibC_PolyphaseResampler_resamplePcmF32(
+		ttLibC_PolyphaseResampler *resampler,
+		ttLibC_PcmF32 *prev_frame,
+		ttLibC_PcmF32 *src_pcmf32) {
+	ttLibC_PolyphaseResampler_ *resampler_ = (ttLibC_PolyphaseResampler_ *)resampler;
+	if(resampler_ == NULL) {
+		return NULL;
+	}
+	if(src_pcmf32 == NULL) {
+		return NULL;
+	}
+	uint32_t channel_num = resampler_->inherit_super.channel_num;
+	if(src_pcmf32->inherit_super.channel_num != channel_num
+	|| src_pcmf32->inherit_super.sample_rate != resampler_->inherit_super.input_sample_rate) {
+		resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_InvalidInput);
+		return NULL;
+	}
+	uint32_t in_num = src_pcmf32->inherit_super.sample_num;
+	if(!PolyphaseResampler_reserve(resampler_, in_num)) {
+		resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_MemoryAllocate);
+		return NULL;
+	}
+	PolyphaseResampler_updatePts(resampler_, (ttLibC_Frame *)src_pcmf32);
+	float *dst_l = resampler_->history[0] + resampler_->history_num;
+	switch(src_pcmf32->type) {
+	case PcmF32Type_interleave:
+		if(channel_num == 2) {
+			float *dst_r = resampler_->history[1] + resampler_->history_num;
+			const float *src = (const float *)src_pcmf32->l_data;
+			for(uint32_t i = 0;i < in_num;++ i) {
+				dst_l[i] = src[0];
+				dst_r[i] = src[1];
+				src += 2;
+			}
+		}
+		else {
+			memcpy(dst_l, src_pcmf32->l_data, sizeof(float) * in_num);
+		}
+		break;
+	case PcmF32Type_planar:
+		memcpy(dst_l, src_pcmf32->l_data, sizeof(float) * in_num);
+		if(channel_num == 2) {
+			memcpy(resampler_->history[1] + resampler_->history_num, src_pcmf32->r_data, sizeof(float) * in_num);
+		}
+		break;
+	default:
+		resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_InvalidInput);
+		return NULL;
+	}
+	resampler_->history_num += in_num;
+	uint32_t out_num = PolyphaseResampler_countOutput(resampler_);
+	if(out_num == 0) {
+		return NULL;
+	}
+	size_t data_size = out_num * channel_num * sizeof(float);
+	bool alloc_flag = false;
+	if(prev_frame == NULL) {
+		prev_frame = (ttLibC_PcmF32 *)ttLibC_FramePool_getAudio(resampler_->pool, frameType_pcmF32, src_pcmf32->type, channel_num);
+	}
+	uint8_t *data = PolyphaseResampler_getBuffer((ttLibC_Frame *)prev_frame, &data_size, &alloc_flag);
+	if(data == NULL) {
+		resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_MemoryAllocate);
+		return NULL;
+	}
+	uint8_t *l_data = data;
+	uint32_t l_stride = out_num * sizeof(float) * channel_num;
+	uint8_t *r_data = NULL;
+	uint32_t r_stride = 0;
+	switch(src_pcmf32->type) {
+	default:
+	case PcmF32Type_interleave:
+		PolyphaseResampler_process(resampler_, out_num, (float *)data, channel_num == 2 ? (float *)data + 1 : NULL, channel_num);
+		break;
+	case PcmF32Type_planar:
+		l_stride = out_num * sizeof(float);
+		if(channel_num == 2) {
+			r_data = data + l_stride;
+			r_stride = l_stride;
+		}
+		PolyphaseResampler_process(resampler_, out_num, (float *)l_data, (float *)r_data, 1);
+		break;
+	}
+	ttLibC_PcmF32 *pcmf32 = ttLibC_PcmF32_make(
+			prev_frame,
+			src_pcmf32->type,
+			resampler_->inherit_super.output_sample_rate,
+			out_num,
+			channel_num,
+			data,
+			data_size,
+			l_data,
+			l_stride,
+			r_data,
+			r_stride,
+			true,
+			resampler_->pts,
+			resampler_->inherit_super.output_sample_rate);
+	if(pcmf32 == NULL) {
+		if(alloc_flag) {
+			ttLibC_free(data);
+		}
+		resampler_->inherit_super.error = ttLibC_updateError(Target_On_Resampler, Error_MemoryAllocate);
+		return NULL;
+	}
+	pcmf32->inherit_super.inherit_super.is_non_copy = false;
+	pcmf32->inherit_super.inherit_super.id = src_pcmf32->inherit_super.inherit_super.id;
+	resampler_->pts += out_num;
+	return pcmf32;
+}
+
+/*
+ * drop holding samples and pts, for discontinuous input.
+ * @param resampler
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_PolyphaseResampler_reset(ttLibC_PolyphaseResampler *resampler) {
+	ttLibC_PolyphaseResampler_ *resampler_ = (ttLibC_PolyphaseResampler_ *)resampler;
+	if(resampler_ == NULL) {
+		return;
+	}
+	uint32_t pad_num = resampler_->inherit_super.tap_num / 2 - 1;
+	resampler_->history_num = 0;
+	resampler_->phase       = 0;
+	resampler_->pts         = 0;
+	resampler_->is_first    = true;
+	if(!PolyphaseResampler_reserve(resampler_, pad_num)) {
+		return;
+	}
+	// put silent on head, then first output is centered on first input sample.
+	for(uint32_t ch = 0;ch < resampler_->inherit_super.channel_num;++ ch) {
+		memset(resampler_->history[ch], 0, sizeof(float) * pad_num);
+	}
+	resampler_->history_num = pad_num;
+}
+
+/*
+ * set frame pool for output frame.
+ * @param resampler resampler object.
+ * @param pool      frame pool, NULL to allocate output.
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_PolyphaseResampler_setFramePool(
+		ttLibC_PolyphaseResampler *resampler,
+		ttLibC_FramePool *pool) {
+	ttLibC_PolyphaseResampler_ *resampler_ = (ttLibC_PolyphaseResampler_ *)resampler;
+	if(resampler_ == NULL) {
+		return;
+	}
+	resampler_->pool = pool;
+}
+
+/*
+ * close resampler.
+ * @param resampler
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_PolyphaseResampler_close(ttLibC_PolyphaseResampler **resampler) {
+	ttLibC_PolyphaseResampler_ *target = (ttLibC_PolyphaseResampler_ *)*resampler;
+	if(target == NULL) {
+		return;
+	}
+	ttLibC_free(target->filter_bank);
+	ttLibC_free(target->history[0]);
+	ttLibC_free(target->history[1]);
+	ttLibC_free(target->work);
+	ttLibC_free(target);
+	*resampler = NULL;
+}
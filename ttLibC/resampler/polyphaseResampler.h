@@ -0,0 +1,122 @@
+/**
+ * @file   polyphaseResampler.h
+ * @brief  native polyphase windowed-sinc resampler.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_RESAMPLER_POLYPHASERESAMPLER_H_
+#define TTLIBC_RESAMPLER_POLYPHASERESAMPLER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../frame/audio/pcms16.h"
+#include "../frame/audio/pcmf32.h"
+#include "../ttLibC.h"
+#include "../util/framePoolUtil.h"
+
+/**
+ * quality tier for polyphase resampler.
+ * higher tier use longer filter, steeper roll off and better stop band.
+ */
+typedef enum ttLibC_PolyphaseResampler_Quality {
+	/** 16 taps, for voice chat. */
+	PolyphaseResamplerQuality_low,
+	/** 32 taps, almost same as speexdsp quality 4-5. */
+	PolyphaseResamplerQuality_medium,
+	/** 64 taps, almost same as speexdsp quality 7-8. */
+	PolyphaseResamplerQuality_high,
+	/** 128 taps, almost same as speexdsp quality 10. */
+	PolyphaseResamplerQuality_best,
+} ttLibC_PolyphaseResampler_Quality;
+
+/**
+ * polyphase resampler definition.
+ */
+typedef struct ttLibC_Resampler_PolyphaseResampler {
+	uint32_t channel_num;
+	uint32_t input_sample_rate;
+	uint32_t output_sample_rate;
+	ttLibC_PolyphaseResampler_Quality quality;
+	/** filter length for each phase. */
+	uint32_t tap_num;
+	/** number of precomputed filter phases. */
+	uint32_t phase_num;
+	Error_e error;
+} ttLibC_Resampler_PolyphaseResampler;
+
+typedef ttLibC_Resampler_PolyphaseResampler ttLibC_PolyphaseResampler;
+
+/**
+ * make polyphase resampler.
+ * @param channel_num        target channel num 1:monoral 2:stereo
+ * @param input_sample_rate  input sample rate
+ * @param output_sample_rate output sample rate
+ * @param quality            quality tier
+ * @return resampler object.
+ */
+ttLibC_PolyphaseResampler *ttLibC_PolyphaseResampler_make(
+		uint32_t channel_num,
+		uint32_t input_sample_rate,
+		uint32_t output_sample_rate,
+		ttLibC_PolyphaseResampler_Quality quality);
+
+/**
+ * sample_rate resample for pcms16.
+ * resampler hold the tail of input for next call, so output pts is continuous across frames.
+ * @param resampler  resampler object.
+ * @param prev_frame reuse frame.
+ * @param src_pcms16 source pcms16 data.
+ * @return resampled pcms16 data. NULL for error or no output yet.
+ */
+ttLibC_PcmS16 *ttLibC_PolyphaseResampler_resamplePcmS16(
+		ttLibC_PolyphaseResampler *resampler,
+		ttLibC_PcmS16 *prev_frame,
+		ttLibC_PcmS16 *src_pcms16);
+
+/**
+ * sample_rate resample for pcmf32.
+ * @param resampler  resampler object.
+ * @param prev_frame reuse frame.
+ * @param src_pcmf32 source pcmf32 data.
+ * @return resampled pcmf32 data. NULL for error or no output yet.
+ */
+ttLibC_PcmF32 *ttLibC_PolyphaseResampler_resamplePcmF32(
+		ttLibC_PolyphaseResampler *resampler,
+		ttLibC_PcmF32 *prev_frame,
+		ttLibC_PcmF32 *src_pcmf32);
+
+/**
+ * drop holding samples and pts, for discontinuous input.
+ * @param resampler
+ */
+void ttLibC_PolyphaseResampler_reset(ttLibC_PolyphaseResampler *resampler);
+
+/**
+ * set frame pool for output frame.
+ * when prev_frame is NULL, output is made on frame from pool.
+ * give back output with ttLibC_FramePool_release.
+ * pool must live longer than resampler.
+ * @param resampler resampler object.
+ * @param pool      frame pool, NULL to allocate output.
+ */
+void ttLibC_PolyphaseResampler_setFramePool(
+		ttLibC_PolyphaseResampler *resampler,
+		ttLibC_FramePool *pool);
+
+/**
+ * close resampler.
+ * @param resampler
+ */
+void ttLibC_PolyphaseResampler_close(ttLibC_PolyphaseResampler **resampler);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_RESAMPLER_POLYPHASERESAMPLER_H_ */
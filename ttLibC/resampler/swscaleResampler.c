@@ -21,6 +21,8 @@ typedef struct {
 	ttLibC_Frame_Type       output_type;
 	uint32_t                output_sub_type;
 	ttLibC_Frame           *frame;
+	/** pool for output frame. */
+	ttLibC_FramePool       *pool;
 } ttLibC_Resampler_SwscaleResampler_;
 
 typedef ttLibC_Resampler_SwscaleResampler_ ttLibC_SwscaleResampler_;
@@ -163,6 +165,7 @@ ttLibC_SwscaleResampler TT_VISIBILITY_DEFAULT *ttLibC_SwscaleResampler_make(
 	resampler->output_type     = output_frame_type;
 	resampler->output_sub_type = output_sub_type;
 	resampler->frame           = NULL;
+	resampler->pool            = NULL;
 	switch(output_frame_type) {
 	case frameType_bgr:
 		{
@@ -253,6 +256,37 @@ ttLibC_SwscaleResampler TT_VISIBILITY_DEFAULT *ttLibC_SwscaleResampler_make(
 	return (ttLibC_SwscaleResampler *)resampler;
 }
 
+/*
+ * make output frame on pooled frame.
+ * @param resampler resampler object
+ * @return output frame, give back with ttLibC_FramePool_release.
+ */
+static ttLibC_Frame *SwscaleResampler_makePooledFrame(ttLibC_SwscaleResampler_ *resampler) {
+	ttLibC_Frame *prev_frame = ttLibC_FramePool_getVideo(
+			resampler->pool,
+			resampler->output_type,
+			resampler->output_sub_type,
+			resampler->inherit_super.width,
+			resampler->inherit_super.height);
+	switch(resampler->output_type) {
+	case frameType_bgr:
+		return (ttLibC_Frame *)ttLibC_Bgr_makeEmptyFrame2(
+				(ttLibC_Bgr *)prev_frame,
+				resampler->output_sub_type,
+				resampler->inherit_super.width,
+				resampler->inherit_super.height);
+	case frameType_yuv420:
+		return (ttLibC_Frame *)ttLibC_Yuv420_makeEmptyFrame2(
+				(ttLibC_Yuv420 *)prev_frame,
+				resampler->output_sub_type,
+				resampler->inherit_super.width,
+				resampler->inherit_super.height);
+	default:
+		ttLibC_Frame_close(&prev_frame);
+		return NULL;
+	}
+}
+
 bool TT_VISIBILITY_DEFAULT ttLibC_SwscaleResampler_resample(
 		ttLibC_SwscaleResampler *resampler,
 		ttLibC_Frame *frame,
@@ -279,10 +313,21 @@ bool TT_VISIBILITY_DEFAULT ttLibC_SwscaleResampler_resample(
 			frame)) {
 		return false;
 	}
+	ttLibC_Frame *output = resampler_->frame;
+	if(resampler_->pool != NULL) {
+		output = SwscaleResampler_makePooledFrame(resampler_);
+		if(output == NULL) {
+			ERR_PRINT("failed to make pooled frame.");
+			return false;
+		}
+	}
 	if(!SwscaleResampler_setupDataStride(
 			dst_data,
 			dst_stride,
-			resampler_->frame)) {
+			output)) {
+		if(output != resampler_->frame) {
+			ttLibC_FramePool_release(resampler_->pool, &output);
+		}
 		return false;
 	}
 	ttLibC_Video *video = (ttLibC_Video *)frame;
@@ -295,15 +340,32 @@ bool TT_VISIBILITY_DEFAULT ttLibC_SwscaleResampler_resample(
 			(uint8_t *const *)dst_data,
 			(const int *)dst_stride);
 	// update pts.
-	resampler_->frame->pts      = frame->pts;
-	resampler_->frame->timebase = frame->timebase;
-	resampler_->frame->id       = frame->id;
+	output->pts      = frame->pts;
+	output->timebase = frame->timebase;
+	output->id       = frame->id;
+	bool result = true;
 	if(callback != NULL) {
-		if(!callback(ptr, resampler_->frame)) {
-			return false;
-		}
+		result = callback(ptr, output);
 	}
-	return true;
+	if(output != resampler_->frame) {
+		ttLibC_FramePool_release(resampler_->pool, &output);
+	}
+	return result;
+}
+
+/*
+ * set frame pool for output frame.
+ * @param resampler resampler object
+ * @param pool      frame pool, NULL to use internal frame.
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_SwscaleResampler_setFramePool(
+		ttLibC_SwscaleResampler *resampler,
+		ttLibC_FramePool *pool) {
+	ttLibC_SwscaleResampler_ *resampler_ = (ttLibC_SwscaleResampler_ *)resampler;
+	if(resampler_ == NULL) {
+		return;
+	}
+	resampler_->pool = pool;
 }
 
 void TT_VISIBILITY_DEFAULT ttLibC_SwscaleResampler_close(ttLibC_SwscaleResampler **resampler) {
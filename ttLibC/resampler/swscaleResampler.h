@@ -15,6 +15,7 @@ extern "C" {
 #include "../frame/video/yuv420.h"
 #include "../frame/video/bgr.h"
 #include "../frame/frame.h"
+#include "../util/framePoolUtil.h"
 
 typedef enum ttLibC_SwscaleResampler_Mode {
 	SwscaleResampler_FastBiLinear,
@@ -58,6 +59,18 @@ bool ttLibC_SwscaleResampler_resample(
 		ttLibC_getSwscaleFrameFunc callback,
 		void *ptr);
 
+/**
+ * set frame pool for output frame.
+ * resampled frame is made on pooled frame, and back to pool after callback.
+ * use ttLibC_FramePool_ref in callback to keep the frame.
+ * pool must live longer than resampler.
+ * @param resampler resampler object
+ * @param pool      frame pool, NULL to use internal frame.
+ */
+void ttLibC_SwscaleResampler_setFramePool(
+		ttLibC_SwscaleResampler *resampler,
+		ttLibC_FramePool *pool);
+
 void ttLibC_SwscaleResampler_close(ttLibC_SwscaleResampler **resampler);
 
 #ifdef __cplusplus
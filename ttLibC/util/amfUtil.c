@@ -18,12 +18,229 @@
 #include "ioUtil.h"
 #include "hexUtil.h"
 
+/** object and map with less elements use linear search. */
+#define AMF0_INDEX_MIN_ELEMENT 8
+/** nest limit for arena reader. */
+#define AMF0_ARENA_MAX_DEPTH 16
+/** element limit for object, same as heap reader. */
+#define AMF0_ARENA_MAX_ELEMENT 255
+
+/*
+ * memory block for arena.
+ */
+typedef struct Amf0Arena_Block {
+	struct Amf0Arena_Block *next;
+	size_t size;
+	size_t pos;
+} Amf0Arena_Block;
+
+/*
+ * detail definition of arena.
+ */
+typedef struct ttLibC_Util_Amf0Arena_ {
+	ttLibC_Amf0Arena inherit_super;
+	Amf0Arena_Block *first;
+	Amf0Arena_Block *current;
+} ttLibC_Util_Amf0Arena_;
+
+typedef ttLibC_Util_Amf0Arena_ ttLibC_Amf0Arena_;
+
+/*
+ * hash index for element lookup.
+ * slots hold element position + 1, 0 for empty.
+ */
+typedef struct {
+	uint32_t mask;
+	uint32_t slots[];
+} Amf0_ElementIndex;
+
+/*
+ * detail definition of amf0object.
+ * all objects made by this file use this size.
+ */
+typedef struct ttLibC_Util_Amf0Object_ {
+	ttLibC_Amf0Object inherit_super;
+	/** hash index of keys for getElement. only for object and map with many elements. */
+	Amf0_ElementIndex *element_index;
+	/** value holder for number and boolean, object refer this. */
+	uint64_t value;
+} ttLibC_Util_Amf0Object_;
+
+typedef ttLibC_Util_Amf0Object_ ttLibC_Amf0Object_;
+
+ttLibC_Amf0Arena TT_VISIBILITY_DEFAULT *ttLibC_Amf0Arena_make(size_t block_size) {
+	ttLibC_Amf0Arena_ *arena = ttLibC_malloc(sizeof(ttLibC_Amf0Arena_));
+	if(arena == NULL) {
+		ERR_PRINT("failed to allocate arena.");
+		return NULL;
+	}
+	if(block_size < 256) {
+		block_size = 256;
+	}
+	arena->inherit_super.block_size = block_size;
+	arena->inherit_super.used_size = 0;
+	arena->first = NULL;
+	arena->current = NULL;
+	return (ttLibC_Amf0Arena *)arena;
+}
+
+/*
+ * bump allocate from arena. memory is 8byte aligned.
+ * @param arena
+ * @param size
+ * @return memory, NULL for error.
+ */
+static void *Amf0Arena_alloc(ttLibC_Amf0Arena_ *arena, size_t size) {
+	size = (size + 7) & ~((size_t)7);
+	Amf0Arena_Block *block = arena->current;
+	while(block != NULL && block->pos + size > block->size) {
+		// try next kept block.
+		block = block->next;
+		if(block != NULL) {
+			block->pos = 0;
+		}
+	}
+	if(block == NULL) {
+		size_t block_size = arena->inherit_super.block_size;
+		if(block_size < size) {
+			block_size = size;
+		}
+		block = ttLibC_malloc(sizeof(Amf0Arena_Block) + block_size);
+		if(block == NULL) {
+			ERR_PRINT("failed to allocate arena block.");
+			return NULL;
+		}
+		block->size = block_size;
+		block->pos = 0;
+		block->next = NULL;
+		if(arena->current == NULL) {
+			arena->first = block;
+		}
+		else {
+			// insert after current, kept blocks are after that.
+			block->next = arena->current->next;
+			arena->current->next = block;
+		}
+	}
+	arena->current = block;
+	void *ptr = (uint8_t *)(block + 1) + block->pos;
+	block->pos += size;
+	arena->inherit_super.used_size += size;
+	return ptr;
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_Amf0Arena_reset(ttLibC_Amf0Arena *arena) {
+	ttLibC_Amf0Arena_ *arena_ = (ttLibC_Amf0Arena_ *)arena;
+	if(arena_ == NULL) {
+		return;
+	}
+	if(arena_->first != NULL) {
+		arena_->first->pos = 0;
+	}
+	arena_->current = arena_->first;
+	arena_->inherit_super.used_size = 0;
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_Amf0Arena_close(ttLibC_Amf0Arena **arena) {
+	ttLibC_Amf0Arena_ *target = (ttLibC_Amf0Arena_ *)*arena;
+	if(target == NULL) {
+		return;
+	}
+	Amf0Arena_Block *block = target->first;
+	while(block != NULL) {
+		Amf0Arena_Block *next = block->next;
+		ttLibC_free(block);
+		block = next;
+	}
+	ttLibC_free(target);
+	*arena = NULL;
+}
+
+/*
+ * FNV-1a hash for key.
+ */
+static uint32_t Amf0_hashKey(const char *key) {
+	uint32_t hash = 2166136261u;
+	while(*key != 0x00) {
+		hash ^= (uint8_t)(*key);
+		hash *= 16777619u;
+		++ key;
+	}
+	return hash;
+}
+
+/*
+ * make hash index for object and map.
+ * @param arena arena for memory, NULL for heap.
+ * @param list  element list.
+ * @return index, NULL for few elements or error.(fallback to linear search.)
+ */
+static Amf0_ElementIndex *Amf0_makeIndex(ttLibC_Amf0Arena_ *arena, ttLibC_Amf0MapObject *list) {
+	uint32_t element_num = 0;
+	for(int i = 0;list[i].key != NULL && list[i].amf0_obj != NULL;++ i) {
+		++ element_num;
+	}
+	if(element_num < AMF0_INDEX_MIN_ELEMENT) {
+		return NULL;
+	}
+	uint32_t slot_num = 16;
+	while(slot_num < element_num * 2) {
+		slot_num <<= 1;
+	}
+	size_t size = sizeof(Amf0_ElementIndex) + sizeof(uint32_t) * slot_num;
+	Amf0_ElementIndex *index = NULL;
+	if(arena != NULL) {
+		index = Amf0Arena_alloc(arena, size);
+	}
+	else {
+		index = ttLibC_malloc(size);
+	}
+	if(index == NULL) {
+		return NULL;
+	}
+	memset(index, 0, size);
+	index->mask = slot_num - 1;
+	for(uint32_t i = 0;i < element_num;++ i) {
+		uint32_t pos = Amf0_hashKey(list[i].key) & index->mask;
+		while(index->slots[pos] != 0) {
+			pos = (pos + 1) & index->mask;
+		}
+		index->slots[pos] = i + 1;
+	}
+	return index;
+}
+
+/*
+ * allocate empty amf0object.
+ * @param arena arena for memory, NULL for heap.
+ * @param type  amf0 type.
+ * @return object, NULL for error.
+ */
+static ttLibC_Amf0Object_ *Amf0_alloc(ttLibC_Amf0Arena_ *arena, ttLibC_Amf0_Type type) {
+	ttLibC_Amf0Object_ *obj = NULL;
+	if(arena != NULL) {
+		obj = Amf0Arena_alloc(arena, sizeof(ttLibC_Amf0Object_));
+	}
+	else {
+		obj = ttLibC_malloc(sizeof(ttLibC_Amf0Object_));
+	}
+	if(obj == NULL) {
+		return NULL;
+	}
+	obj->inherit_super.type = type;
+	obj->inherit_super.object = NULL;
+	obj->inherit_super.data_size = 0;
+	obj->element_index = NULL;
+	obj->value = 0;
+	return obj;
+}
+
 ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_map(ttLibC_Amf0MapObject *list) {
 	uint32_t element_num = 0;
 	for(int i = 0;list[i].key != NULL && list[i].amf0_obj != NULL;++ i) {
 		++ element_num;
 	}
-	ttLibC_Amf0Object *obj = ttLibC_malloc(sizeof(ttLibC_Amf0Object));
+	ttLibC_Amf0Object_ *obj = Amf0_alloc(NULL, amf0Type_Map);
 	if(obj == NULL) {
 		// TODO if failed, we need to clear data inside of mapObject.
 		ERR_PRINT("failed to alloc memory for map object. need to clear list objects.");
@@ -35,13 +252,12 @@ ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_map(ttLibC_Amf0MapObject *l
 		ttLibC_free(obj);
 		return NULL;
 	}
-	obj->data_size = 8;
-	obj->type = amf0Type_Map;
-	obj->object = (void *)map_list;
+	obj->inherit_super.data_size = 8;
+	obj->inherit_super.object = (void *)map_list;
 	int i = 0;
 	for(i = 0;list[i].key != NULL && list[i].amf0_obj != NULL;++ i) {
 		size_t size = strlen(list[i].key);
-		obj->data_size += 2 + size + list[i].amf0_obj->data_size;
+		obj->inherit_super.data_size += 2 + size + list[i].amf0_obj->data_size;
 		char *key = ttLibC_malloc(size + 1);
 		if(key == NULL) {
 			ERR_PRINT("failed to allocate key object.");
@@ -57,6 +273,7 @@ ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_map(ttLibC_Amf0MapObject *l
 	}
 	map_list[i].key = NULL;
 	map_list[i].amf0_obj = NULL;
+	obj->element_index = Amf0_makeIndex(NULL, map_list);
 	return (ttLibC_Amf0Object *)obj;
 }
 
@@ -65,7 +282,7 @@ ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_object(ttLibC_Amf0MapObject
 	for(int i = 0;list[i].key != NULL && list[i].amf0_obj != NULL;++ i) {
 		++ element_num;
 	}
-	ttLibC_Amf0Object *obj = ttLibC_malloc(sizeof(ttLibC_Amf0Object));
+	ttLibC_Amf0Object_ *obj = Amf0_alloc(NULL, amf0Type_Object);
 	if(obj == NULL) {
 		// TODO if failed, we need to clear data inside of mapObject.
 		ERR_PRINT("failed to alloc memory for map object. need to clear list objects.");
@@ -77,13 +294,12 @@ ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_object(ttLibC_Amf0MapObject
 		ttLibC_free(obj);
 		return NULL;
 	}
-	obj->data_size = 4;
-	obj->type = amf0Type_Object;
-	obj->object = (void *)map_list;
+	obj->inherit_super.data_size = 4;
+	obj->inherit_super.object = (void *)map_list;
 	int i = 0;
 	for(i = 0;list[i].key != NULL && list[i].amf0_obj != NULL;++ i) {
 		size_t size = strlen(list[i].key);
-		obj->data_size += 2 + size + list[i].amf0_obj->data_size;
+		obj->inherit_super.data_size += 2 + size + list[i].amf0_obj->data_size;
 		char *key = ttLibC_malloc(size + 1);
 		if(key == NULL) {
 			ERR_PRINT("failed to allocate key object.");
@@ -99,63 +315,58 @@ ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_object(ttLibC_Amf0MapObject
 	}
 	map_list[i].key = NULL;
 	map_list[i].amf0_obj = NULL;
+	obj->element_index = Amf0_makeIndex(NULL, map_list);
 	return (ttLibC_Amf0Object *)obj;
 }
 
 ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_number(double number) {
-	ttLibC_Amf0Object *obj = ttLibC_malloc(sizeof(ttLibC_Amf0Object));
+	ttLibC_Amf0Object_ *obj = Amf0_alloc(NULL, amf0Type_Number);
 	if(obj == NULL) {
 		return NULL;
 	}
-	obj->data_size = 9;
-	obj->type = amf0Type_Number;
-	uint8_t *buf = (uint8_t *)ttLibC_malloc(8);
-	memcpy(buf, &number, 8);
-	obj->object = buf;
+	obj->inherit_super.data_size = 9;
+	memcpy(&obj->value, &number, 8);
+	obj->inherit_super.object = &obj->value;
 	return (ttLibC_Amf0Object *)obj;
 }
 
 ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_boolean(bool flag) {
-	ttLibC_Amf0Object *obj = ttLibC_malloc(sizeof(ttLibC_Amf0Object));
+	ttLibC_Amf0Object_ *obj = Amf0_alloc(NULL, amf0Type_Boolean);
 	if(obj == NULL) {
 		return NULL;
 	}
-	obj->data_size = 2;
-	obj->type = amf0Type_Boolean;
-	uint8_t *buf = (uint8_t *)ttLibC_malloc(1);
+	obj->inherit_super.data_size = 2;
+	uint8_t *buf = (uint8_t *)&obj->value;
 	if(flag) {
 		*buf = 0x01;
 	}
 	else {
 		*buf = 0x00;
 	}
-	obj->object = buf;
+	obj->inherit_super.object = buf;
 	return (ttLibC_Amf0Object *)obj;
 }
 
 ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_null() {
-	ttLibC_Amf0Object *obj = ttLibC_malloc(sizeof(ttLibC_Amf0Object));
+	ttLibC_Amf0Object_ *obj = Amf0_alloc(NULL, amf0Type_Null);
 	if(obj == NULL) {
 		return NULL;
 	}
-	obj->data_size = 1;
-	obj->type = amf0Type_Null;
-	obj->object = NULL;
+	obj->inherit_super.data_size = 1;
 	return (ttLibC_Amf0Object *)obj;
 }
 
 ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_string(const char *string) {
-	ttLibC_Amf0Object *obj = ttLibC_malloc(sizeof(ttLibC_Amf0Object));
+	ttLibC_Amf0Object_ *obj = Amf0_alloc(NULL, amf0Type_String);
 	if(obj == NULL) {
 		return NULL;
 	}
 	size_t size = strlen(string);
-	obj->data_size = 3 + size;
-	obj->type = amf0Type_String;
+	obj->inherit_super.data_size = 3 + size;
 	uint8_t *buf = (uint8_t *)ttLibC_malloc(size + 1);
 	memcpy(buf, string, size);
 	buf[size] = 0x00;
-	obj->object = buf;
+	obj->inherit_super.object = buf;
 	return (ttLibC_Amf0Object *)obj;
 }
 
@@ -171,6 +382,18 @@ ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_getElement(ttLibC_Amf0Objec
 	case amf0Type_Map:
 		{
 			ttLibC_Amf0MapObject *list = (ttLibC_Amf0MapObject *)amf0_map->object;
+			Amf0_ElementIndex *index = ((ttLibC_Amf0Object_ *)amf0_map)->element_index;
+			if(index != NULL) {
+				uint32_t pos = Amf0_hashKey(key) & index->mask;
+				while(index->slots[pos] != 0) {
+					ttLibC_Amf0MapObject *element = &list[index->slots[pos] - 1];
+					if(strcmp(element->key, key) == 0) {
+						return element->amf0_obj;
+					}
+					pos = (pos + 1) & index->mask;
+				}
+				return NULL;
+			}
 			for(int i = 0;list[i].key != NULL && list[i].amf0_obj != NULL;++ i) {
 				if(strcmp(list[i].key, key) == 0) {
 					return list[i].amf0_obj;
@@ -254,34 +477,113 @@ ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_clone(ttLibC_Amf0Object *sr
 	return NULL;
 }
 
+/*
+ * clone amf0object on arena.
+ * @param arena   arena for objects.
+ * @param src_obj source object.
+ * @return cloned object, NULL for error.
+ */
+static ttLibC_Amf0Object *Amf0_cloneArena(ttLibC_Amf0Arena_ *arena, ttLibC_Amf0Object *src_obj) {
+	ttLibC_Amf0Object_ *obj = Amf0_alloc(arena, src_obj->type);
+	if(obj == NULL) {
+		return NULL;
+	}
+	obj->inherit_super.data_size = src_obj->data_size;
+	switch(src_obj->type) {
+	case amf0Type_Number:
+		memcpy(&obj->value, src_obj->object, 8);
+		obj->inherit_super.object = &obj->value;
+		return (ttLibC_Amf0Object *)obj;
+	case amf0Type_Boolean:
+		memcpy(&obj->value, src_obj->object, 1);
+		obj->inherit_super.object = &obj->value;
+		return (ttLibC_Amf0Object *)obj;
+	case amf0Type_String:
+		{
+			size_t size = strlen((const char *)src_obj->object);
+			char *string = Amf0Arena_alloc(arena, size + 1);
+			if(string == NULL) {
+				return NULL;
+			}
+			memcpy(string, src_obj->object, size + 1);
+			obj->inherit_super.object = string;
+		}
+		return (ttLibC_Amf0Object *)obj;
+	case amf0Type_Null:
+		return (ttLibC_Amf0Object *)obj;
+	case amf0Type_Object:
+	case amf0Type_Map:
+		{
+			ttLibC_Amf0MapObject *src_lists = (ttLibC_Amf0MapObject *)src_obj->object;
+			size_t count = 0;
+			for(int i = 0;src_lists[i].key != NULL && src_lists[i].amf0_obj != NULL;++ i) {
+				++ count;
+			}
+			ttLibC_Amf0MapObject *list = Amf0Arena_alloc(arena, sizeof(ttLibC_Amf0MapObject) * (count + 1));
+			if(list == NULL) {
+				return NULL;
+			}
+			for(size_t i = 0;i < count;++ i) {
+				size_t size = strlen(src_lists[i].key);
+				list[i].key = Amf0Arena_alloc(arena, size + 1);
+				if(list[i].key == NULL) {
+					return NULL;
+				}
+				memcpy(list[i].key, src_lists[i].key, size + 1);
+				list[i].amf0_obj = Amf0_cloneArena(arena, src_lists[i].amf0_obj);
+				if(list[i].amf0_obj == NULL) {
+					return NULL;
+				}
+			}
+			list[count].key = NULL;
+			list[count].amf0_obj = NULL;
+			obj->inherit_super.object = list;
+			obj->element_index = Amf0_makeIndex(arena, list);
+		}
+		return (ttLibC_Amf0Object *)obj;
+	default:
+		break;
+	}
+	LOG_PRINT("target_type:%d", src_obj->type);
+	return NULL;
+}
+
+ttLibC_Amf0Object TT_VISIBILITY_DEFAULT *ttLibC_Amf0_cloneArena(
+		ttLibC_Amf0Arena *arena,
+		ttLibC_Amf0Object *src_obj) {
+	if(arena == NULL || src_obj == NULL) {
+		return NULL;
+	}
+	return Amf0_cloneArena((ttLibC_Amf0Arena_ *)arena, src_obj);
+}
+
 /**
  * make and reply amf0object
  */
 static ttLibC_Amf0Object *Amf0_make(uint8_t *data, size_t data_size) {
-	ttLibC_Amf0Object *amf0_obj = ttLibC_malloc(sizeof(ttLibC_Amf0Object));
-	if(amf0_obj == NULL) {
+	ttLibC_Amf0Object_ *amf0_obj_ = Amf0_alloc(NULL, amf0Type_Null);
+	if(amf0_obj_ == NULL) {
 		ERR_PRINT("failed to make amf0object.");
 		return NULL;
 	}
+	ttLibC_Amf0Object *amf0_obj = (ttLibC_Amf0Object *)amf0_obj_;
 	size_t read_size = 0;
 	switch((*data)) {
 	case amf0Type_Number:
 		{
 			++ read_size;
 			// 8bit double, endian is bigendian.
-			uint8_t *number = ttLibC_malloc(8);
-			uint64_t be_val = be_uint64_t(*((uint64_t *)(data + read_size)));
-			memcpy(number, &be_val, 8);
+			amf0_obj_->value = be_uint64_t(*((uint64_t *)(data + read_size)));
 			read_size += 8;
 			amf0_obj->type = amf0Type_Number;
-			amf0_obj->object = number;
+			amf0_obj->object = &amf0_obj_->value;
 			amf0_obj->data_size = read_size;
 		}
 		return amf0_obj;
 	case amf0Type_Boolean:
 		{
 			++ read_size;
-			uint8_t *value = ttLibC_malloc(1);
+			uint8_t *value = (uint8_t *)&amf0_obj_->value;
 			*value = *(data + read_size);
 			++ read_size;
 			amf0_obj->type = amf0Type_Boolean;
@@ -347,6 +649,7 @@ static ttLibC_Amf0Object *Amf0_make(uint8_t *data, size_t data_size) {
 			}
 			read_size += 3;
 			amf0_obj->data_size = read_size;
+			amf0_obj_->element_index = Amf0_makeIndex(NULL, map_objects);
 		}
 		return amf0_obj;
 	case amf0Type_MovieClip:
@@ -413,6 +716,7 @@ static ttLibC_Amf0Object *Amf0_make(uint8_t *data, size_t data_size) {
 			}
 			read_size += 3;
 			amf0_obj->data_size = read_size;
+			amf0_obj_->element_index = Amf0_makeIndex(NULL, map_objects);
 		}
 		return amf0_obj;
 	case amf0Type_ObjectEnd:
@@ -434,6 +738,195 @@ static ttLibC_Amf0Object *Amf0_make(uint8_t *data, size_t data_size) {
 	return NULL;
 }
 
+/*
+ * element of object on arena, chained while reading and copied to list at the end.
+ */
+typedef struct Amf0Arena_Element {
+	ttLibC_Amf0MapObject element;
+	struct Amf0Arena_Element *next;
+} Amf0Arena_Element;
+
+/*
+ * make amf0object on arena.
+ * strings and keys are copied on arena with null byte.
+ * number and boolean are held inline in the object.
+ * @param arena     arena for objects.
+ * @param data      binary data
+ * @param data_size binary data size
+ * @param depth     nest level.
+ * @return amf0object. NULL for error.
+ */
+static ttLibC_Amf0Object *Amf0_makeArena(
+		ttLibC_Amf0Arena_ *arena,
+		uint8_t *data,
+		size_t data_size,
+		int depth) {
+	if(data_size < 1 || depth > AMF0_ARENA_MAX_DEPTH) {
+		ERR_PRINT("amf0 data is corrupted.");
+		return NULL;
+	}
+	ttLibC_Amf0Object_ *amf0_obj_ = Amf0_alloc(arena, (ttLibC_Amf0_Type)(*data));
+	if(amf0_obj_ == NULL) {
+		return NULL;
+	}
+	ttLibC_Amf0Object *amf0_obj = (ttLibC_Amf0Object *)amf0_obj_;
+	switch(*data) {
+	case amf0Type_Number:
+		{
+			if(data_size < 9) {
+				break;
+			}
+			// 8bit double, endian is bigendian.
+			uint64_t be_val;
+			memcpy(&be_val, data + 1, 8);
+			amf0_obj_->value = be_uint64_t(be_val);
+			amf0_obj->object = &amf0_obj_->value;
+			amf0_obj->data_size = 9;
+		}
+		return amf0_obj;
+	case amf0Type_Boolean:
+		{
+			if(data_size < 2) {
+				break;
+			}
+			uint8_t *value = (uint8_t *)&amf0_obj_->value;
+			*value = *(data + 1);
+			amf0_obj->object = value;
+			amf0_obj->data_size = 2;
+		}
+		return amf0_obj;
+	case amf0Type_String:
+		{
+			if(data_size < 3) {
+				break;
+			}
+			uint16_t size = (data[1] << 8) | data[2];
+			if(data_size < 3 + (size_t)size) {
+				break;
+			}
+			char *string = Amf0Arena_alloc(arena, size + 1);
+			if(string == NULL) {
+				return NULL;
+			}
+			memcpy(string, data + 3, size);
+			string[size] = 0x00;
+			amf0_obj->object = string;
+			amf0_obj->data_size = 3 + size;
+		}
+		return amf0_obj;
+	case amf0Type_Null:
+		amf0_obj->data_size = 1;
+		return amf0_obj;
+	case amf0Type_Object:
+	case amf0Type_Map:
+		{
+			Amf0Arena_Element *first = NULL;
+			Amf0Arena_Element *last = NULL;
+			uint32_t element_num = 0;
+			size_t read_size = 1;
+			if(*data == amf0Type_Map) {
+				// element num is not reliable(fms can reply 0), use the end marker.
+				read_size += 4;
+			}
+			while(true) {
+				if(read_size + 2 > data_size) {
+					ERR_PRINT("object is corrupted.");
+					return NULL;
+				}
+				uint16_t key_size = (data[read_size] << 8) | data[read_size + 1];
+				if(key_size == 0) {
+					break;
+				}
+				if(element_num >= AMF0_ARENA_MAX_ELEMENT) {
+					ERR_PRINT("too many elements for object.");
+					return NULL;
+				}
+				read_size += 2;
+				if(read_size + key_size > data_size) {
+					ERR_PRINT("object key is corrupted.");
+					return NULL;
+				}
+				char *key = Amf0Arena_alloc(arena, key_size + 1);
+				if(key == NULL) {
+					return NULL;
+				}
+				memcpy(key, data + read_size, key_size);
+				key[key_size] = 0x00;
+				read_size += key_size;
+				ttLibC_Amf0Object *element = Amf0_makeArena(arena, data + read_size, data_size - read_size, depth + 1);
+				if(element == NULL) {
+					return NULL;
+				}
+				Amf0Arena_Element *chain = Amf0Arena_alloc(arena, sizeof(Amf0Arena_Element));
+				if(chain == NULL) {
+					return NULL;
+				}
+				chain->element.key = key;
+				chain->element.amf0_obj = element;
+				chain->next = NULL;
+				if(last == NULL) {
+					first = chain;
+				}
+				else {
+					last->next = chain;
+				}
+				last = chain;
+				++ element_num;
+				read_size += element->data_size;
+			}
+			if(read_size + 3 > data_size || data[read_size + 2] != amf0Type_ObjectEnd) {
+				ERR_PRINT("object end is corrupted.");
+				return NULL;
+			}
+			read_size += 3;
+			ttLibC_Amf0MapObject *list = Amf0Arena_alloc(arena, sizeof(ttLibC_Amf0MapObject) * (element_num + 1));
+			if(list == NULL) {
+				return NULL;
+			}
+			uint32_t i = 0;
+			for(Amf0Arena_Element *chain = first;chain != NULL;chain = chain->next) {
+				list[i ++] = chain->element;
+			}
+			list[element_num].key = NULL;
+			list[element_num].amf0_obj = NULL;
+			amf0_obj->object = list;
+			amf0_obj->data_size = read_size;
+			amf0_obj_->element_index = Amf0_makeIndex(arena, list);
+		}
+		return amf0_obj;
+	default:
+		LOG_PRINT("unknown amf0Type:%x", (*data));
+		return NULL;
+	}
+	ERR_PRINT("amf0 data is corrupted. type:%x", (*data));
+	return NULL;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_Amf0_readArena(
+		ttLibC_Amf0Arena *arena,
+		void *data,
+		size_t data_size,
+		ttLibC_Amf0ObjectReadFunc callback,
+		void *ptr) {
+	if(arena == NULL) {
+		return false;
+	}
+	uint8_t *dat = data;
+	while(data_size > 0) {
+		ttLibC_Amf0Object *amf0_obj = Amf0_makeArena((ttLibC_Amf0Arena_ *)arena, dat, data_size, 0);
+		if(amf0_obj == NULL) {
+			ERR_PRINT("failed to get object.");
+			return false;
+		}
+		if(!callback(ptr, amf0_obj)) {
+			return false;
+		}
+		dat += amf0_obj->data_size;
+		data_size -= amf0_obj->data_size;
+	}
+	return true;
+}
+
 bool TT_VISIBILITY_DEFAULT ttLibC_Amf0_read(void *data, size_t data_size, ttLibC_Amf0ObjectReadFunc callback, void *ptr) {
 	uint8_t *dat = data;
 	while(data_size > 0) {
@@ -592,6 +1085,104 @@ bool TT_VISIBILITY_DEFAULT ttLibC_Amf0_write(ttLibC_Amf0Object *amf0_obj, ttLibC
 	return true;
 }
 
+static size_t Amf0_writeBuffer(ttLibC_Amf0Object *amf0_obj, uint8_t *buf, size_t buf_size) {
+	switch(amf0_obj->type) {
+	case amf0Type_Number:
+		{
+			if(buf_size < 9) {
+				return 0;
+			}
+			uint64_t num;
+			memcpy(&num, amf0_obj->object, 8);
+			num = be_uint64_t(num);
+			buf[0] = amf0Type_Number;
+			memcpy(buf + 1, &num, 8);
+		}
+		return 9;
+	case amf0Type_Boolean:
+		if(buf_size < 2) {
+			return 0;
+		}
+		buf[0] = amf0Type_Boolean;
+		buf[1] = *((uint8_t *)amf0_obj->object);
+		return 2;
+	case amf0Type_String:
+		{
+			size_t str_size = strlen((char *)amf0_obj->object);
+			if(str_size > 0xFFFF || buf_size < 3 + str_size) {
+				return 0;
+			}
+			buf[0] = amf0Type_String;
+			buf[1] = (str_size >> 8) & 0xFF;
+			buf[2] = str_size & 0xFF;
+			memcpy(buf + 3, amf0_obj->object, str_size);
+			return 3 + str_size;
+		}
+	case amf0Type_Null:
+		if(buf_size < 1) {
+			return 0;
+		}
+		buf[0] = amf0Type_Null;
+		return 1;
+	case amf0Type_Object:
+	case amf0Type_Map:
+		{
+			ttLibC_Amf0MapObject *lists = (ttLibC_Amf0MapObject *)amf0_obj->object;
+			size_t pos = 1;
+			if(amf0_obj->type == amf0Type_Map) {
+				pos += 4;
+			}
+			if(buf_size < pos) {
+				return 0;
+			}
+			buf[0] = amf0_obj->type;
+			uint32_t element_num = 0;
+			for(int i = 0;lists[i].key != NULL && lists[i].amf0_obj != NULL;++ i) {
+				size_t key_size = strlen(lists[i].key);
+				if(key_size > 0xFFFF || buf_size < pos + 2 + key_size) {
+					return 0;
+				}
+				buf[pos]     = (key_size >> 8) & 0xFF;
+				buf[pos + 1] = key_size & 0xFF;
+				memcpy(buf + pos + 2, lists[i].key, key_size);
+				pos += 2 + key_size;
+				size_t size = Amf0_writeBuffer(lists[i].amf0_obj, buf + pos, buf_size - pos);
+				if(size == 0) {
+					return 0;
+				}
+				pos += size;
+				++ element_num;
+			}
+			if(amf0_obj->type == amf0Type_Map) {
+				buf[1] = (element_num >> 24) & 0xFF;
+				buf[2] = (element_num >> 16) & 0xFF;
+				buf[3] = (element_num >> 8) & 0xFF;
+				buf[4] = element_num & 0xFF;
+			}
+			if(buf_size < pos + 3) {
+				return 0;
+			}
+			buf[pos]     = 0x00;
+			buf[pos + 1] = 0x00;
+			buf[pos + 2] = amf0Type_ObjectEnd;
+			return pos + 3;
+		}
+	default:
+		break;
+	}
+	return 0;
+}
+
+size_t TT_VISIBILITY_DEFAULT ttLibC_Amf0_writeBuffer(
+		ttLibC_Amf0Object *amf0_obj,
+		void *buffer,
+		size_t buffer_size) {
+	if(amf0_obj == NULL || buffer == NULL) {
+		return 0;
+	}
+	return Amf0_writeBuffer(amf0_obj, (uint8_t *)buffer, buffer_size);
+}
+
 void TT_VISIBILITY_DEFAULT ttLibC_Amf0_close(ttLibC_Amf0Object **amf0_obj) {
 	ttLibC_Amf0Object *target = *amf0_obj;
 	if(target == NULL) {
@@ -600,10 +1191,13 @@ void TT_VISIBILITY_DEFAULT ttLibC_Amf0_close(ttLibC_Amf0Object **amf0_obj) {
 	// close the holding object.
 	switch(target->type) {
 	case amf0Type_Number:
+		// value is inline.
 		break;
 	case amf0Type_Boolean:
+		// value is inline.
 		break;
 	case amf0Type_String:
+		ttLibC_free(target->object);
 		break;
 //	case amf0Type_MovieClip:
 	case amf0Type_Null:
@@ -622,6 +1216,7 @@ void TT_VISIBILITY_DEFAULT ttLibC_Amf0_close(ttLibC_Amf0Object **amf0_obj) {
 				ttLibC_Amf0_close((ttLibC_Amf0Object **)&map_objects[i].amf0_obj);
 				++ i;
 			}
+			ttLibC_free(map_objects);
 		}
 		break;
 //	case amf0Type_ObjectEnd:
@@ -636,8 +1231,9 @@ void TT_VISIBILITY_DEFAULT ttLibC_Amf0_close(ttLibC_Amf0Object **amf0_obj) {
 	default:
 		break;
 	}
-	if(target->object) {
-		ttLibC_free(target->object);
+	ttLibC_Amf0Object_ *target_ = (ttLibC_Amf0Object_ *)target;
+	if(target_->element_index) {
+		ttLibC_free(target_->element_index);
 	}
 	ttLibC_free(target);
 	*amf0_obj = NULL;
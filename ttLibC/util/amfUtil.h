@@ -67,6 +67,37 @@ typedef ttLibC_Util_Amf0MapObject ttLibC_Amf0MapObject;
 
 typedef bool (* ttLibC_Amf0ObjectReadFunc)(void *ptr, ttLibC_Amf0Object *amf0_obj);
 
+/**
+ * bump allocator which owns amf0 objects of one message.
+ */
+typedef struct ttLibC_Util_Amf0Arena {
+	/** size of each memory block. */
+	size_t block_size;
+	/** allocated size from arena. */
+	size_t used_size;
+} ttLibC_Util_Amf0Arena;
+
+typedef ttLibC_Util_Amf0Arena ttLibC_Amf0Arena;
+
+/**
+ * make arena.
+ * @param block_size size of each memory block. bigger request use own block.
+ * @return arena object.
+ */
+ttLibC_Amf0Arena *ttLibC_Amf0Arena_make(size_t block_size);
+
+/**
+ * drop all objects in arena, memory blocks are kept for reuse.
+ * @param arena
+ */
+void ttLibC_Amf0Arena_reset(ttLibC_Amf0Arena *arena);
+
+/**
+ * close arena, all objects in arena are released.
+ * @param arena
+ */
+void ttLibC_Amf0Arena_close(ttLibC_Amf0Arena **arena);
+
 /**
  * make amf0 number object.
  * @param number
@@ -110,6 +141,7 @@ ttLibC_Amf0Object *ttLibC_Amf0_object(ttLibC_Amf0MapObject *list);
 
 /**
  * get the amf0object from amf0object or amf0map.
+ * amf0_map should be made by ttLibC_Amf0 functions.(not on stack.)
  * @param amf0_map
  * @param key
  * @return ttLibC_Amf0Object
@@ -124,6 +156,17 @@ ttLibC_Amf0Object *ttLibC_Amf0_getElement(ttLibC_Amf0Object *amf0_map, const cha
  */
 ttLibC_Amf0Object *ttLibC_Amf0_clone(ttLibC_Amf0Object *src);
 
+/**
+ * make amf0 clone on arena.
+ * cloned object is alive until arena reset or close, do not call ttLibC_Amf0_close for it.
+ * @param arena arena for objects.
+ * @param src   source object.
+ * @return ttLibC_Amf0Object, NULL for error.
+ */
+ttLibC_Amf0Object *ttLibC_Amf0_cloneArena(
+		ttLibC_Amf0Arena *arena,
+		ttLibC_Amf0Object *src);
+
 /**
  * read data from binary stream.
  * @param data      binary data
@@ -134,6 +177,35 @@ ttLibC_Amf0Object *ttLibC_Amf0_clone(ttLibC_Amf0Object *src);
  */
 bool ttLibC_Amf0_read(void *data, size_t data_size, ttLibC_Amf0ObjectReadFunc callback, void *ptr);
 
+/**
+ * read data from binary stream, objects are made on arena.
+ * objects are alive until arena reset or close, do not call ttLibC_Amf0_close for them.
+ * @param arena     arena for objects.
+ * @param data      binary data
+ * @param data_size data size
+ * @param callback  callback func, which will call when found amf0object.
+ * @param ptr       user def value pointer.
+ * @return true:success false:abort.
+ */
+bool ttLibC_Amf0_readArena(
+		ttLibC_Amf0Arena *arena,
+		void *data,
+		size_t data_size,
+		ttLibC_Amf0ObjectReadFunc callback,
+		void *ptr);
+
+/**
+ * write amf0Object into buffer directly.
+ * @param object      target amf0object.
+ * @param buffer      target buffer.
+ * @param buffer_size size of buffer.
+ * @return written size. 0 for short buffer or unsupported object.
+ */
+size_t ttLibC_Amf0_writeBuffer(
+		ttLibC_Amf0Object *object,
+		void *buffer,
+		size_t buffer_size);
+
 /**
  * write amf0Object as binary data.
  * @param object   target amf0object.
@@ -0,0 +1,634 @@
+/*
+ * @file   audioMixerUtil.c
+ * @brief  mix pcm from multiple sources.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "audioMixerUtil.h"
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+#include "../ttLibC_common.h"
+#include "../resampler/audioResampler.h"
+#include "stlMapUtil.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#	include <emmintrin.h>
+#	define AUDIOMIXER_USE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#	include <arm_neon.h>
+#	define AUDIOMIXER_USE_NEON
+#endif
+
+/** gain is held as Q14 fixed point. */
+#define AUDIOMIXER_GAIN_SHIFT 14
+
+/**
+ * source information.
+ */
+typedef struct {
+	uint32_t id;
+	/** gain in Q14 */
+	int16_t gain;
+	bool is_mix_minus;
+	/** true:offset is not decided yet. */
+	bool is_first;
+	/** mixer pts = source pts(in sample) + offset */
+	int64_t offset;
+	/** ring buffer of interleaved samples, out of [mixer pts, write_end) is always 0. */
+	int16_t *buffer;
+	/** end position of written samples, in mixer pts. */
+	uint64_t write_end;
+	/** scaled contribution of this source for current mix, for mix minus. */
+	int32_t *contrib;
+	/** reuse frame for format conversion. */
+	ttLibC_Audio *converted;
+	/** output frame for mix minus. */
+	ttLibC_PcmS16 *output;
+} ttLibC_Util_AudioMixerUtil_AudioMixer_Source;
+
+typedef ttLibC_Util_AudioMixerUtil_AudioMixer_Source AudioMixer_Source;
+
+/**
+ * detail definition of audioMixer
+ */
+typedef struct {
+	ttLibC_AudioMixer inherit_super;
+	/** source_id -> AudioMixer_Source */
+	ttLibC_StlMap *source_map;
+	/** ring buffer size of each source in sample num. */
+	uint32_t capacity;
+	/** accumulator for all sources. */
+	int32_t *acc;
+	/** output frame for all sources mix. */
+	ttLibC_PcmS16 *output;
+	/** pcm data area for output. */
+	int16_t *output_data;
+} ttLibC_Util_AudioMixerUtil_AudioMixer_;
+
+typedef ttLibC_Util_AudioMixerUtil_AudioMixer_ ttLibC_AudioMixer_;
+
+/**
+ * acc += (src * gain) >> 14, and keep the scaled value on contrib.
+ * @param acc     accumulator
+ * @param contrib scaled value output, can be NULL.
+ * @param src     source samples
+ * @param gain    Q14 gain
+ * @param num     number of values
+ */
+static void AudioMixer_accumulate(
+		int32_t *acc,
+		int32_t *contrib,
+		const int16_t *src,
+		int16_t gain,
+		uint32_t num) {
+	uint32_t i = 0;
+#if defined(AUDIOMIXER_USE_SSE2)
+	__m128i g = _mm_set1_epi16(gain);
+	for(;i + 8 <= num;i += 8) {
+		__m128i s  = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i lo = _mm_mullo_epi16(s, g);
+		__m128i hi = _mm_mulhi_epi16(s, g);
+		__m128i p0 = _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), AUDIOMIXER_GAIN_SHIFT);
+		__m128i p1 = _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), AUDIOMIXER_GAIN_SHIFT);
+		if(contrib != NULL) {
+			_mm_storeu_si128((__m128i *)(contrib + i),     p0);
+			_mm_storeu_si128((__m128i *)(contrib + i + 4), p1);
+		}
+		_mm_storeu_si128((__m128i *)(acc + i),     _mm_add_epi32(_mm_loadu_si128((const __m128i *)(acc + i)),     p0));
+		_mm_storeu_si128((__m128i *)(acc + i + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(acc + i + 4)), p1));
+	}
+#elif defined(AUDIOMIXER_USE_NEON)
+	int16x4_t g = vdup_n_s16(gain);
+	for(;i + 8 <= num;i += 8) {
+		int16x8_t s  = vld1q_s16(src + i);
+		int32x4_t p0 = vshrq_n_s32(vmull_s16(vget_low_s16(s), g),  AUDIOMIXER_GAIN_SHIFT);
+		int32x4_t p1 = vshrq_n_s32(vmull_s16(vget_high_s16(s), g), AUDIOMIXER_GAIN_SHIFT);
+		if(contrib != NULL) {
+			vst1q_s32(contrib + i,     p0);
+			vst1q_s32(contrib + i + 4, p1);
+		}
+		vst1q_s32(acc + i,     vaddq_s32(vld1q_s32(acc + i),     p0));
+		vst1q_s32(acc + i + 4, vaddq_s32(vld1q_s32(acc + i + 4), p1));
+	}
+#endif
+	for(;i < num;++ i) {
+		int32_t value = ((int32_t)src[i] * gain) >> AUDIOMIXER_GAIN_SHIFT;
+		if(contrib != NULL) {
+			contrib[i] = value;
+		}
+		acc[i] += value;
+	}
+}
+
+/**
+ * dst = saturate(acc - minus)
+ * @param dst   output samples
+ * @param acc   accumulator
+ * @param minus value to remove, can be NULL.
+ * @param num   number of values
+ */
+static void AudioMixer_pack(
+		int16_t *dst,
+		const int32_t *acc,
+		const int32_t *minus,
+		uint32_t num) {
+	uint32_t i = 0;
+#if defined(AUDIOMIXER_USE_SSE2)
+	for(;i + 8 <= num;i += 8) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *)(acc + i));
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(acc + i + 4));
+		if(minus != NULL) {
+			v0 = _mm_sub_epi32(v0, _mm_loadu_si128((const __m128i *)(minus + i)));
+			v1 = _mm_sub_epi32(v1, _mm_loadu_si128((const __m128i *)(minus + i + 4)));
+		}
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(v0, v1));
+	}
+#elif defined(AUDIOMIXER_USE_NEON)
+	for(;i + 8 <= num;i += 8) {
+		int32x4_t v0 = vld1q_s32(acc + i);
+		int32x4_t v1 = vld1q_s32(acc + i + 4);
+		if(minus != NULL) {
+			v0 = vsubq_s32(v0, vld1q_s32(minus + i));
+			v1 = vsubq_s32(v1, vld1q_s32(minus + i + 4));
+		}
+		vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(v0), vqmovn_s32(v1)));
+	}
+#endif
+	for(;i < num;++ i) {
+		int32_t value = acc[i];
+		if(minus != NULL) {
+			value -= minus[i];
+		}
+		if(value > 32767) {
+			value = 32767;
+		}
+		else if(value < -32768) {
+			value = -32768;
+		}
+		dst[i] = (int16_t)value;
+	}
+}
+
+static void AudioMixer_Source_close(AudioMixer_Source **source) {
+	AudioMixer_Source *target = *source;
+	if(target == NULL) {
+		return;
+	}
+	ttLibC_free(target->buffer);
+	ttLibC_free(target->contrib);
+	ttLibC_Audio_close(&target->converted);
+	ttLibC_PcmS16_close(&target->output);
+	ttLibC_free(target);
+	*source = NULL;
+}
+
+static AudioMixer_Source *AudioMixer_getSource(
+		ttLibC_AudioMixer_ *mixer,
+		uint32_t source_id,
+		bool is_create) {
+	AudioMixer_Source *source = (AudioMixer_Source *)ttLibC_StlMap_get(mixer->source_map, (void *)(long)source_id);
+	if(source != NULL || !is_create) {
+		return source;
+	}
+	uint32_t channel_num = mixer->inherit_super.channel_num;
+	source = (AudioMixer_Source *)ttLibC_malloc(sizeof(AudioMixer_Source));
+	if(source == NULL) {
+		return NULL;
+	}
+	memset(source, 0, sizeof(AudioMixer_Source));
+	source->id       = source_id;
+	source->gain     = 1 << AUDIOMIXER_GAIN_SHIFT;
+	source->is_first = true;
+	source->buffer   = ttLibC_calloc(mixer->capacity * channel_num, sizeof(int16_t));
+	source->contrib  = ttLibC_malloc(sizeof(int32_t) * mixer->inherit_super.sample_num * channel_num);
+	if(source->buffer == NULL || source->contrib == NULL) {
+		AudioMixer_Source_close(&source);
+		return NULL;
+	}
+	source->write_end = mixer->inherit_super.pts;
+	ttLibC_StlMap_put(mixer->source_map, (void *)(long)source_id, source);
+	mixer->inherit_super.source_num = mixer->source_map->size;
+	return source;
+}
+
+/*
+ * make audio mixer
+ * @param sample_rate    sample_rate for mixing.
+ * @param channel_num    channel_num for output. 1:monoral 2:stereo
+ * @param sample_num     sample num for each output frame. (960 for opus 20mili sec on 48kHz)
+ * @param delay_mili_sec jitter buffer size in mili sec.
+ * @return mixer object.
+ */
+ttLibC_AudioMixer TT_VISIBILITY_DEFAULT *ttLibC_AudioMixer_make(
+		uint32_t sample_rate,
+		uint32_t channel_num,
+		uint32_t sample_num,
+		uint32_t delay_mili_sec) {
+	if(channel_num != 1 && channel_num != 2) {
+		ERR_PRINT("channel_num must be 1 or 2.:%d", channel_num);
+		return NULL;
+	}
+	if(sample_rate == 0 || sample_num == 0) {
+		ERR_PRINT("sample_rate or sample_num is invalid.");
+		return NULL;
+	}
+	ttLibC_AudioMixer_ *mixer = (ttLibC_AudioMixer_ *)ttLibC_malloc(sizeof(ttLibC_AudioMixer_));
+	if(mixer == NULL) {
+		ERR_PRINT("failed to allocate memory for audioMixer.");
+		return NULL;
+	}
+	memset(mixer, 0, sizeof(ttLibC_AudioMixer_));
+	mixer->inherit_super.sample_rate      = sample_rate;
+	mixer->inherit_super.channel_num      = channel_num;
+	mixer->inherit_super.sample_num       = sample_num;
+	mixer->inherit_super.delay_sample_num = (uint32_t)(1L * delay_mili_sec * sample_rate / 1000);
+	mixer->inherit_super.pts              = 0;
+	mixer->inherit_super.source_num       = 0;
+	mixer->inherit_super.error            = Error_noError;
+	// room for delay, and jitter on both side.
+	mixer->capacity    = mixer->inherit_super.delay_sample_num * 2 + sample_num * 4;
+	mixer->source_map  = ttLibC_StlMap_make();
+	mixer->acc         = ttLibC_malloc(sizeof(int32_t) * sample_num * channel_num);
+	mixer->output_data = ttLibC_malloc(sizeof(int16_t) * sample_num * channel_num);
+	if(mixer->source_map == NULL || mixer->acc == NULL || mixer->output_data == NULL) {
+		ERR_PRINT("failed to allocate memory for audioMixer.");
+		ttLibC_AudioMixer_close((ttLibC_AudioMixer **)&mixer);
+		return NULL;
+	}
+	return (ttLibC_AudioMixer *)mixer;
+}
+
+/**
+ * write samples on ring buffer.
+ */
+static void AudioMixer_Source_write(
+		ttLibC_AudioMixer_ *mixer,
+		AudioMixer_Source *source,
+		uint64_t start,
+		const int16_t *data,
+		uint32_t num) {
+	uint32_t channel_num = mixer->inherit_super.channel_num;
+	while(num > 0) {
+		uint32_t pos = (uint32_t)(start % mixer->capacity);
+		uint32_t copy_num = mixer->capacity - pos;
+		if(copy_num > num) {
+			copy_num = num;
+		}
+		memcpy(source->buffer + pos * channel_num, data, sizeof(int16_t) * copy_num * channel_num);
+		data  += copy_num * channel_num;
+		start += copy_num;
+		num   -= copy_num;
+	}
+}
+
+/*
+ * queue source frame.
+ * @param mixer     mixer object.
+ * @param source_id id of source. 0 is reserved.
+ * @param frame     ttLibC_PcmS16 or ttLibC_PcmF32 frame.
+ * @return true:success false:error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_AudioMixer_queue(
+		ttLibC_AudioMixer *mixer,
+		uint32_t source_id,
+		ttLibC_Audio *frame) {
+	ttLibC_AudioMixer_ *mixer_ = (ttLibC_AudioMixer_ *)mixer;
+	if(mixer_ == NULL || frame == NULL) {
+		return false;
+	}
+	if(source_id == 0) {
+		ERR_PRINT("source_id 0 is reserved.");
+		mixer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_InvalidInput);
+		return false;
+	}
+	if(frame->sample_rate != mixer_->inherit_super.sample_rate) {
+		ERR_PRINT("sample_rate is different from mixer.:%d", frame->sample_rate);
+		mixer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_InvalidInput);
+		return false;
+	}
+	AudioMixer_Source *source = AudioMixer_getSource(mixer_, source_id, true);
+	if(source == NULL) {
+		mixer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_MemoryAllocate);
+		return false;
+	}
+	uint32_t channel_num = mixer_->inherit_super.channel_num;
+	const int16_t *data = NULL;
+	switch(frame->inherit_super.type) {
+	case frameType_pcmS16:
+		{
+			ttLibC_PcmS16 *pcm = (ttLibC_PcmS16 *)frame;
+			if(pcm->type == PcmS16Type_littleEndian && frame->channel_num == channel_num) {
+				data = (const int16_t *)pcm->l_data;
+				break;
+			}
+		}
+		/* no break */
+	case frameType_pcmF32:
+		{
+			ttLibC_Audio *converted = ttLibC_AudioResampler_convertFormat(
+					source->converted,
+					frameType_pcmS16,
+					PcmS16Type_littleEndian,
+					channel_num,
+					frame);
+			if(converted == NULL) {
+				mixer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_TtLibCError);
+				return false;
+			}
+			source->converted = converted;
+			data = (const int16_t *)((ttLibC_PcmS16 *)converted)->l_data;
+		}
+		break;
+	default:
+		ERR_PRINT("frame must be pcmS16 or pcmF32.");
+		mixer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_InvalidInput);
+		return false;
+	}
+	if(frame->sample_num > mixer_->capacity - mixer_->inherit_super.delay_sample_num) {
+		ERR_PRINT("frame is too long for jitter buffer.:%d", frame->sample_num);
+		mixer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_InvalidInput);
+		return false;
+	}
+	uint64_t mix_pts = mixer_->inherit_super.pts;
+	uint32_t delay   = mixer_->inherit_super.delay_sample_num;
+	int64_t src_pos = 0;
+	if(frame->inherit_super.timebase != 0) {
+		src_pos = (int64_t)(frame->inherit_super.pts * mixer_->inherit_super.sample_rate / frame->inherit_super.timebase);
+	}
+	if(source->is_first) {
+		source->offset = (int64_t)(mix_pts + delay) - src_pos;
+		source->is_first = false;
+	}
+	int64_t start = src_pos + source->offset;
+	int64_t end   = start + frame->sample_num;
+	if(end > (int64_t)(mix_pts + mixer_->capacity)) {
+		// source clock run too fast, or discontinuity. put on delay position again.
+		LOG_PRINT("source %u is out of range, realign.", source_id);
+		memset(source->buffer, 0, sizeof(int16_t) * mixer_->capacity * channel_num);
+		source->write_end = mix_pts;
+		source->offset = (int64_t)(mix_pts + delay) - src_pos;
+		start = src_pos + source->offset;
+		end   = start + frame->sample_num;
+	}
+	if(end <= (int64_t)mix_pts) {
+		// too late, drop.
+		return true;
+	}
+	if(start < (int64_t)mix_pts) {
+		data += (mix_pts - start) * channel_num;
+		start = mix_pts;
+	}
+	AudioMixer_Source_write(mixer_, source, (uint64_t)start, data, (uint32_t)(end - start));
+	if((uint64_t)end > source->write_end) {
+		source->write_end = (uint64_t)end;
+	}
+	return true;
+}
+
+/*
+ * set gain for source.
+ * @param mixer     mixer object.
+ * @param source_id id of source.
+ * @param gain      gain 0.0 - 2.0
+ * @return true:success false:error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_AudioMixer_setGain(
+		ttLibC_AudioMixer *mixer,
+		uint32_t source_id,
+		float gain) {
+	ttLibC_AudioMixer_ *mixer_ = (ttLibC_AudioMixer_ *)mixer;
+	if(mixer_ == NULL || source_id == 0) {
+		return false;
+	}
+	AudioMixer_Source *source = AudioMixer_getSource(mixer_, source_id, true);
+	if(source == NULL) {
+		return false;
+	}
+	if(gain < 0.0f) {
+		gain = 0.0f;
+	}
+	int32_t q = (int32_t)(gain * (1 << AUDIOMIXER_GAIN_SHIFT) + 0.5f);
+	if(q > 32767) {
+		q = 32767;
+	}
+	source->gain = (int16_t)q;
+	return true;
+}
+
+/*
+ * enable or disable mix minus output for source.
+ * @param mixer     mixer object.
+ * @param source_id id of source.
+ * @param enable    true:make mix except the source on each mix.
+ * @return true:success false:error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_AudioMixer_setMixMinus(
+		ttLibC_AudioMixer *mixer,
+		uint32_t source_id,
+		bool enable) {
+	ttLibC_AudioMixer_ *mixer_ = (ttLibC_AudioMixer_ *)mixer;
+	if(mixer_ == NULL || source_id == 0) {
+		return false;
+	}
+	AudioMixer_Source *source = AudioMixer_getSource(mixer_, source_id, true);
+	if(source == NULL) {
+		return false;
+	}
+	source->is_mix_minus = enable;
+	return true;
+}
+
+/*
+ * remove source.
+ * @param mixer     mixer object.
+ * @param source_id id of source.
+ * @return true:success false:error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_AudioMixer_removeSource(
+		ttLibC_AudioMixer *mixer,
+		uint32_t source_id) {
+	ttLibC_AudioMixer_ *mixer_ = (ttLibC_AudioMixer_ *)mixer;
+	if(mixer_ == NULL) {
+		return false;
+	}
+	AudioMixer_Source *source = AudioMixer_getSource(mixer_, source_id, false);
+	if(source == NULL) {
+		return false;
+	}
+	ttLibC_StlMap_remove(mixer_->source_map, (void *)(long)source_id);
+	AudioMixer_Source_close(&source);
+	mixer_->inherit_super.source_num = mixer_->source_map->size;
+	return true;
+}
+
+/**
+ * sum one source into accumulator, and clear consumed region.
+ */
+static bool AudioMixer_sumSourceCallback(void *ptr, void *key, void *item) {
+	(void)key;
+	ttLibC_AudioMixer_ *mixer = (ttLibC_AudioMixer_ *)ptr;
+	AudioMixer_Source *source = (AudioMixer_Source *)item;
+	uint32_t channel_num = mixer->inherit_super.channel_num;
+	uint32_t pos = (uint32_t)(mixer->inherit_super.pts % mixer->capacity);
+	uint32_t num = mixer->inherit_super.sample_num;
+	int32_t *contrib = source->is_mix_minus ? source->contrib : NULL;
+	uint32_t done = 0;
+	while(done < num) {
+		uint32_t copy_num = mixer->capacity - pos;
+		if(copy_num > num - done) {
+			copy_num = num - done;
+		}
+		int16_t *src = source->buffer + pos * channel_num;
+		AudioMixer_accumulate(
+				mixer->acc + done * channel_num,
+				contrib == NULL ? NULL : contrib + done * channel_num,
+				src,
+				source->gain,
+				copy_num * channel_num);
+		memset(src, 0, sizeof(int16_t) * copy_num * channel_num);
+		done += copy_num;
+		pos = 0;
+	}
+	if(source->write_end < mixer->inherit_super.pts + num) {
+		source->write_end = mixer->inherit_super.pts + num;
+	}
+	return true;
+}
+
+typedef struct {
+	ttLibC_AudioMixer_ *mixer;
+	ttLibC_AudioMixerFunc callback;
+	void *ptr;
+} AudioMixer_MixMinusParam;
+
+/**
+ * make mix minus frame for one source.
+ */
+static bool AudioMixer_mixMinusCallback(void *ptr, void *key, void *item) {
+	(void)key;
+	AudioMixer_MixMinusParam *param = (AudioMixer_MixMinusParam *)ptr;
+	ttLibC_AudioMixer_ *mixer = param->mixer;
+	AudioMixer_Source *source = (AudioMixer_Source *)item;
+	if(!source->is_mix_minus) {
+		return true;
+	}
+	uint32_t channel_num = mixer->inherit_super.channel_num;
+	uint32_t sample_num  = mixer->inherit_super.sample_num;
+	uint32_t data_size   = sample_num * channel_num * sizeof(int16_t);
+	if(source->output == NULL) {
+		// hold own data buffer on the frame, reused after this.
+		source->output = ttLibC_PcmS16_make(
+				NULL,
+				PcmS16Type_littleEndian,
+				mixer->inherit_super.sample_rate,
+				sample_num,
+				channel_num,
+				mixer->output_data,
+				data_size,
+				mixer->output_data,
+				data_size,
+				NULL,
+				0,
+				false,
+				mixer->inherit_super.pts,
+				mixer->inherit_super.sample_rate);
+		if(source->output == NULL) {
+			mixer->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_MemoryAllocate);
+			return false;
+		}
+	}
+	ttLibC_PcmS16 *output = source->output;
+	AudioMixer_pack((int16_t *)output->l_data, mixer->acc, source->contrib, sample_num * channel_num);
+	output->inherit_super.inherit_super.pts = mixer->inherit_super.pts;
+	output->inherit_super.inherit_super.id  = source->id;
+	return param->callback(param->ptr, source->id, true, output);
+}
+
+/*
+ * make next output frame.
+ * @param mixer    mixer object.
+ * @param callback callback for output.
+ * @param ptr      user def pointer object.
+ * @return true:success false:error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_AudioMixer_mix(
+		ttLibC_AudioMixer *mixer,
+		ttLibC_AudioMixerFunc callback,
+		void *ptr) {
+	ttLibC_AudioMixer_ *mixer_ = (ttLibC_AudioMixer_ *)mixer;
+	if(mixer_ == NULL || callback == NULL) {
+		return false;
+	}
+	uint32_t channel_num = mixer_->inherit_super.channel_num;
+	uint32_t sample_num  = mixer_->inherit_super.sample_num;
+	uint32_t data_size   = sample_num * channel_num * sizeof(int16_t);
+	memset(mixer_->acc, 0, sizeof(int32_t) * sample_num * channel_num);
+	ttLibC_StlMap_forEach(mixer_->source_map, AudioMixer_sumSourceCallback, mixer_);
+	AudioMixer_pack(mixer_->output_data, mixer_->acc, NULL, sample_num * channel_num);
+	ttLibC_PcmS16 *output = ttLibC_PcmS16_make(
+			mixer_->output,
+			PcmS16Type_littleEndian,
+			mixer_->inherit_super.sample_rate,
+			sample_num,
+			channel_num,
+			mixer_->output_data,
+			data_size,
+			mixer_->output_data,
+			data_size,
+			NULL,
+			0,
+			true,
+			mixer_->inherit_super.pts,
+			mixer_->inherit_super.sample_rate);
+	if(output == NULL) {
+		mixer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_MemoryAllocate);
+		return false;
+	}
+	mixer_->output = output;
+	output->inherit_super.inherit_super.id = 0;
+	bool result = callback(ptr, 0, false, output);
+	if(result) {
+		AudioMixer_MixMinusParam param;
+		param.mixer    = mixer_;
+		param.callback = callback;
+		param.ptr      = ptr;
+		result = ttLibC_StlMap_forEach(mixer_->source_map, AudioMixer_mixMinusCallback, &param);
+	}
+	mixer_->inherit_super.pts += sample_num;
+	return result;
+}
+
+static bool AudioMixer_closeSourceCallback(void *ptr, void *key, void *item) {
+	(void)ptr;
+	(void)key;
+	AudioMixer_Source *source = (AudioMixer_Source *)item;
+	AudioMixer_Source_close(&source);
+	return true;
+}
+
+/*
+ * close mixer
+ * @param mixer
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_AudioMixer_close(ttLibC_AudioMixer **mixer) {
+	ttLibC_AudioMixer_ *target = (ttLibC_AudioMixer_ *)*mixer;
+	if(target == NULL) {
+		return;
+	}
+	if(target->source_map != NULL) {
+		ttLibC_StlMap_forEach(target->source_map, AudioMixer_closeSourceCallback, NULL);
+		ttLibC_StlMap_close(&target->source_map);
+	}
+	ttLibC_PcmS16_close(&target->output);
+	ttLibC_free(target->acc);
+	ttLibC_free(target->output_data);
+	ttLibC_free(target);
+	*mixer = NULL;
+}
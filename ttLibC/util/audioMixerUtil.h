@@ -0,0 +1,139 @@
+/**
+ * @file   audioMixerUtil.h
+ * @brief  mix pcm from multiple sources.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_UTIL_AUDIOMIXERUTIL_H_
+#define TTLIBC_UTIL_AUDIOMIXERUTIL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../ttLibC.h"
+#include "../frame/audio/pcms16.h"
+#include "../frame/audio/pcmf32.h"
+
+/**
+ * data for audioMixer
+ */
+typedef struct ttLibC_Util_AudioMixerUtil_AudioMixer {
+	/** sample_rate for mixing. all sources must have the same sample_rate. */
+	uint32_t sample_rate;
+	/** channel_num for output 1:monoral 2:stereo */
+	uint32_t channel_num;
+	/** sample num for each output frame. */
+	uint32_t sample_num;
+	/** jitter buffer size in sample num. */
+	uint32_t delay_sample_num;
+	/** pts for next output frame. timebase is sample_rate. */
+	uint64_t pts;
+	/** number of sources. */
+	uint32_t source_num;
+	Error_e error;
+} ttLibC_Util_AudioMixerUtil_AudioMixer;
+
+typedef ttLibC_Util_AudioMixerUtil_AudioMixer ttLibC_AudioMixer;
+
+/**
+ * callback for mixed pcm.
+ * @param ptr          user def pointer object.
+ * @param source_id    target source id for mix minus. 0 for all sources mix.
+ * @param is_mix_minus true:mix without source_id. false:mix of all sources.
+ * @param pcm          mixed pcm. littleEndian interleave.
+ * @return true:continue false:stop
+ */
+typedef bool (* ttLibC_AudioMixerFunc)(void *ptr, uint32_t source_id, bool is_mix_minus, ttLibC_PcmS16 *pcm);
+
+/**
+ * make audio mixer
+ * @param sample_rate    sample_rate for mixing.
+ * @param channel_num    channel_num for output. 1:monoral 2:stereo
+ * @param sample_num     sample num for each output frame. (960 for opus 20mili sec on 48kHz)
+ * @param delay_mili_sec jitter buffer size in mili sec.
+ * @return mixer object.
+ */
+ttLibC_AudioMixer *ttLibC_AudioMixer_make(
+		uint32_t sample_rate,
+		uint32_t channel_num,
+		uint32_t sample_num,
+		uint32_t delay_mili_sec);
+
+/**
+ * queue source frame.
+ * first frame of each source is put on (current pts + delay),
+ * later frames are placed by the pts distance from the first one.
+ * @param mixer     mixer object.
+ * @param source_id id of source. 0 is reserved.
+ * @param frame     ttLibC_PcmS16 or ttLibC_PcmF32 frame.
+ * @return true:success false:error
+ */
+bool ttLibC_AudioMixer_queue(
+		ttLibC_AudioMixer *mixer,
+		uint32_t source_id,
+		ttLibC_Audio *frame);
+
+/**
+ * set gain for source.
+ * @param mixer     mixer object.
+ * @param source_id id of source.
+ * @param gain      gain 0.0 - 2.0
+ * @return true:success false:error
+ */
+bool ttLibC_AudioMixer_setGain(
+		ttLibC_AudioMixer *mixer,
+		uint32_t source_id,
+		float gain);
+
+/**
+ * enable or disable mix minus output for source.
+ * @param mixer     mixer object.
+ * @param source_id id of source.
+ * @param enable    true:make mix except the source on each mix.
+ * @return true:success false:error
+ */
+bool ttLibC_AudioMixer_setMixMinus(
+		ttLibC_AudioMixer *mixer,
+		uint32_t source_id,
+		bool enable);
+
+/**
+ * remove source.
+ * @param mixer     mixer object.
+ * @param source_id id of source.
+ * @return true:success false:error
+ */
+bool ttLibC_AudioMixer_removeSource(
+		ttLibC_AudioMixer *mixer,
+		uint32_t source_id);
+
+/**
+ * make next output frame.
+ * callback is called for all sources mix, then for each mix minus source.
+ * lacking sample is treated as silent.
+ * @param mixer    mixer object.
+ * @param callback callback for output.
+ * @param ptr      user def pointer object.
+ * @return true:success false:error
+ */
+bool ttLibC_AudioMixer_mix(
+		ttLibC_AudioMixer *mixer,
+		ttLibC_AudioMixerFunc callback,
+		void *ptr);
+
+/**
+ * close mixer
+ * @param mixer
+ */
+void ttLibC_AudioMixer_close(ttLibC_AudioMixer **mixer);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_UTIL_AUDIOMIXERUTIL_H_ */
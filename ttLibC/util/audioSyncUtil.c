@@ -0,0 +1,201 @@
+/*
+ * @file   audioSyncUtil.c
+ * @brief  find frame boundaries of mp3 / adts aac stream.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "audioSyncUtil.h"
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+
+#include <pthread.h>
+#include <string.h>
+
+/*
+ * table for 2nd and 3rd byte of header.
+ * mp3: frame size without padding is decided by them. 0 for invalid.
+ * adts: 1 for valid, frame size is on 4th - 6th byte.
+ */
+static uint16_t AudioSync_mp3Table[65536];
+static uint16_t AudioSync_adtsTable[65536];
+static pthread_once_t AudioSync_once = PTHREAD_ONCE_INIT;
+
+static const int AudioSync_bitrateV1L1[]  = {-1, 32000, 64000, 96000, 128000, 160000, 192000, 224000, 256000, 288000, 320000, 352000, 384000, 416000, 448000, -1};
+static const int AudioSync_bitrateV1L2[]  = {-1, 32000, 48000, 56000,  64000,  80000,  96000, 112000, 128000, 160000, 192000, 224000, 256000, 320000, 384000, -1};
+static const int AudioSync_bitrateV1L3[]  = {-1, 32000, 40000, 48000,  56000,  64000,  80000,  96000, 112000, 128000, 160000, 192000, 224000, 256000, 320000, -1};
+static const int AudioSync_bitrateV2L1[]  = {-1, 32000, 48000, 56000,  64000,  80000,  96000, 112000, 128000, 144000, 160000, 176000, 192000, 224000, 256000, -1};
+static const int AudioSync_bitrateV2L23[] = {-1,  8000, 16000, 24000,  32000,  40000,  48000,  56000,  64000,  80000,  96000, 112000, 128000, 144000, 160000, -1};
+static const int AudioSync_sampleRateV1[]  = {44100, 48000, 32000};
+static const int AudioSync_sampleRateV2[]  = {22050, 24000, 16000};
+static const int AudioSync_sampleRateV25[] = {11025, 12000,  8000};
+
+/*
+ * mp3 frame size, same calculation with frame/audio/mp3.c
+ */
+static uint32_t AudioSync_calcMp3Size(uint8_t byte1, uint8_t byte2) {
+	if((byte1 & 0xE0) != 0xE0) {
+		return 0;
+	}
+	uint32_t mpeg_version      = (byte1 >> 3) & 0x03;
+	uint32_t layer             = (byte1 >> 1) & 0x03;
+	uint32_t bitrate_index     = (byte2 >> 4) & 0x0F;
+	uint32_t sample_rate_index = (byte2 >> 2) & 0x03;
+	uint32_t padding_bit       = (byte2 >> 1) & 0x01;
+	if(mpeg_version == 1 || layer == 0 || sample_rate_index == 3
+	|| bitrate_index == 0 || bitrate_index == 15) {
+		return 0;
+	}
+	int bitrate = 0;
+	int sample_rate = 0;
+	switch(mpeg_version) {
+	case 0:
+		sample_rate = AudioSync_sampleRateV25[sample_rate_index];
+		bitrate = layer == 3 ? AudioSync_bitrateV2L1[bitrate_index] : AudioSync_bitrateV2L23[bitrate_index];
+		break;
+	case 2:
+		sample_rate = AudioSync_sampleRateV2[sample_rate_index];
+		bitrate = layer == 3 ? AudioSync_bitrateV2L1[bitrate_index] : AudioSync_bitrateV2L23[bitrate_index];
+		break;
+	case 3:
+	default:
+		sample_rate = AudioSync_sampleRateV1[sample_rate_index];
+		switch(layer) {
+		case 1:
+			bitrate = AudioSync_bitrateV1L3[bitrate_index];
+			break;
+		case 2:
+			bitrate = AudioSync_bitrateV1L2[bitrate_index];
+			break;
+		case 3:
+		default:
+			bitrate = AudioSync_bitrateV1L1[bitrate_index];
+			break;
+		}
+		break;
+	}
+	switch(layer) {
+	case 3:
+		return ((uint32_t)(12.0f * bitrate / sample_rate + padding_bit)) * 4;
+	case 2:
+		return (uint32_t)(144.0f * bitrate / sample_rate + padding_bit);
+	case 1:
+	default:
+		if(mpeg_version == 3) {
+			return (uint32_t)(144.0f * bitrate / sample_rate + padding_bit);
+		}
+		return (uint32_t)(72.0f * bitrate / sample_rate + padding_bit);
+	}
+}
+
+static void AudioSync_makeTable() {
+	for(uint32_t i = 0;i < 65536;++ i) {
+		uint8_t byte1 = (uint8_t)(i >> 8);
+		uint8_t byte2 = (uint8_t)i;
+		AudioSync_mp3Table[i] = (uint16_t)AudioSync_calcMp3Size(byte1, byte2);
+		// sync:4bit(0xF) id:1bit layer:2bit(00) protection_absent:1bit
+		// profile:2bit sampling_frequency_index:4bit(0 - 12) private:1bit channel:1bit
+		AudioSync_adtsTable[i] = ((byte1 & 0xF6) == 0xF0 && ((byte2 >> 2) & 0x0F) <= 12) ? 1 : 0;
+	}
+}
+
+uint32_t TT_VISIBILITY_DEFAULT ttLibC_AudioSync_refMp3Size(const uint8_t *data) {
+	pthread_once(&AudioSync_once, AudioSync_makeTable);
+	return AudioSync_mp3Table[(data[1] << 8) | data[2]];
+}
+
+uint32_t TT_VISIBILITY_DEFAULT ttLibC_AudioSync_refAdtsSize(const uint8_t *data) {
+	pthread_once(&AudioSync_once, AudioSync_makeTable);
+	if(AudioSync_adtsTable[(data[1] << 8) | data[2]] == 0) {
+		return 0;
+	}
+	uint32_t size = ((data[3] & 0x03) << 11) | (data[4] << 3) | (data[5] >> 5);
+	// header is 7byte, 9byte with crc.
+	if(size < ((data[1] & 0x01) ? 7u : 9u)) {
+		return 0;
+	}
+	return size;
+}
+
+uint32_t TT_VISIBILITY_DEFAULT ttLibC_AudioSync_scan(
+		ttLibC_AudioSync_Type type,
+		const uint8_t *data,
+		size_t data_size,
+		ttLibC_AudioSync_Unit *units,
+		uint32_t units_num,
+		size_t *read_size) {
+	pthread_once(&AudioSync_once, AudioSync_makeTable);
+	size_t header_size = 0;
+	switch(type) {
+	case AudioSyncType_mp3:
+		header_size = 4;
+		break;
+	case AudioSyncType_adts:
+		header_size = 7;
+		break;
+	default:
+		ERR_PRINT("unknown type:%d", type);
+		*read_size = 0;
+		return 0;
+	}
+	uint32_t num = 0;
+	size_t pos = 0;
+	bool is_resync = false;
+	while(num < units_num && pos + header_size <= data_size) {
+		const uint8_t *header = data + pos;
+		uint32_t size = 0;
+		if(header[0] == 0xFF) {
+			if(type == AudioSyncType_mp3) {
+				size = AudioSync_mp3Table[(header[1] << 8) | header[2]];
+			}
+			else {
+				size = ttLibC_AudioSync_refAdtsSize(header);
+			}
+		}
+		if(size != 0) {
+			if(pos + size > data_size) {
+				// need more data.
+				break;
+			}
+			if(!is_resync) {
+				units[num].offset = pos;
+				units[num].size   = size;
+				++ num;
+				pos += size;
+				continue;
+			}
+			// after garbage, 0xFF can be a part of garbage. check next header too.
+			// frame which ends at the end of data is also accepted.
+			const uint8_t *next = header + size;
+			if(pos + size == data_size) {
+				is_resync = false;
+				continue;
+			}
+			if(pos + size + header_size > data_size) {
+				break;
+			}
+			if(next[0] == 0xFF
+			&& (type == AudioSyncType_mp3 ? ttLibC_AudioSync_refMp3Size(next) : ttLibC_AudioSync_refAdtsSize(next)) != 0) {
+				is_resync = false;
+				continue;
+			}
+		}
+		if(num != 0) {
+			// return found frames first, caller may handle non frame data. (id3 tag...)
+			break;
+		}
+		// find next candidate.
+		is_resync = true;
+		const uint8_t *found = memchr(header + 1, 0xFF, data_size - pos - 1);
+		if(found == NULL) {
+			pos = data_size;
+			break;
+		}
+		pos = found - data;
+	}
+	*read_size = pos;
+	return num;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file   audioSyncUtil.h
+ * @brief  find frame boundaries of mp3 / adts aac stream.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * 0xFF candidates are found with memchr,
+ * and header is checked with 64K table of 2nd and 3rd byte. (mp3:frame size, adts:valid flag)
+ * on resync (garbage before frame), the header of next frame is checked too.
+ * scan stops at non frame data after found frames, so caller can check it. (id3 tag...)
+ *
+ * usage:
+ *   ttLibC_AudioSync_Unit units[64];
+ *   size_t read_size;
+ *   uint32_t num = ttLibC_AudioSync_scan(AudioSyncType_mp3, data, data_size, units, 64, &read_size);
+ *   // units[0 - num) are complete frames, drop read_size byte and keep the rest for next scan.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_UTIL_AUDIOSYNCUTIL_H_
+#define TTLIBC_UTIL_AUDIOSYNCUTIL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * stream type for scan.
+ */
+typedef enum ttLibC_AudioSync_Type {
+	AudioSyncType_mp3,
+	AudioSyncType_adts
+} ttLibC_AudioSync_Type;
+
+/**
+ * position of one frame.
+ */
+typedef struct ttLibC_Util_AudioSyncUtil_Unit {
+	/** offset from the top of data. */
+	size_t   offset;
+	/** frame size including header. */
+	uint32_t size;
+} ttLibC_Util_AudioSyncUtil_Unit;
+
+typedef ttLibC_Util_AudioSyncUtil_Unit ttLibC_AudioSync_Unit;
+
+/**
+ * ref frame size from mp3 header.
+ * @param data 4byte header, 1st byte should be 0xFF.
+ * @return frame size. 0 for invalid header.
+ */
+uint32_t ttLibC_AudioSync_refMp3Size(const uint8_t *data);
+
+/**
+ * ref frame size from adts header.
+ * @param data 7byte header, 1st byte should be 0xFF.
+ * @return frame size including header. 0 for invalid header.
+ */
+uint32_t ttLibC_AudioSync_refAdtsSize(const uint8_t *data);
+
+/**
+ * scan frames.
+ * @param type       stream type.
+ * @param data       target data
+ * @param data_size  target data size
+ * @param units      array for result.
+ * @param units_num  size of units array.
+ * @param read_size  byte size of found frames and skipped garbage. the rest need more data.
+ * @return number of found frames.
+ */
+uint32_t ttLibC_AudioSync_scan(
+		ttLibC_AudioSync_Type type,
+		const uint8_t *data,
+		size_t data_size,
+		ttLibC_AudioSync_Unit *units,
+		uint32_t units_num,
+		size_t *read_size);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_UTIL_AUDIOSYNCUTIL_H_ */
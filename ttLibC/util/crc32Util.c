@@ -13,14 +13,31 @@
 #include <stdlib.h>
 #include "../ttLibC_predef.h"
 #include "../allocator.h"
+#include <pthread.h>
 
 /**
  * crc32 table make up on the first object.
+ * objects can be made on many threads, table is made only once.
  */
 static uint32_t crc_table[256] = {0};
+static pthread_once_t crc_table_once = PTHREAD_ONCE_INIT;
 
 static const uint32_t POLYNOMINAL = 0x04C11DB7L;
 
+/*
+ * make crc32 table.
+ */
+static void Crc32_makeTable() {
+	uint64_t crc = 0;
+	for(int i = 0;i < 256; ++ i) {
+		crc = i << 24;
+		for(int j = 0;j < 8;++ j) {
+			crc = (crc << 1) ^ ((crc & 0x80000000L) != 0 ? POLYNOMINAL : 0);
+		}
+		crc_table[i] = crc & 0xFFFFFFFFL;
+	}
+}
+
 /*
  * make crc32
  * @param initial_data
@@ -33,17 +50,7 @@ ttLibC_Crc32 TT_VISIBILITY_DEFAULT *ttLibC_Crc32_make(uint32_t initial_data) {
 		return NULL;
 	}
 	crc32->error = Error_noError;
-	if(crc_table[1] == 0) {
-		// not initialize.
-		uint64_t crc = 0;
-		for(int i = 0;i < 256; ++ i) {
-			crc = i << 24;
-			for(int j = 0;j < 8;++ j) {
-				crc = (crc << 1) ^ ((crc & 0x80000000L) != 0 ? POLYNOMINAL : 0);
-			}
-			crc_table[i] = crc & 0xFFFFFFFFL;
-		}
-	}
+	pthread_once(&crc_table_once, Crc32_makeTable);
 	crc32->crc = initial_data;
 	return crc32;
 }
@@ -21,6 +21,10 @@ typedef struct {
 	size_t read_pos;
 	size_t buffer_size;
 	size_t target_size;
+	/** data of appendNonCopy, NULL for own buffer. */
+	uint8_t *ref_data;
+	/** size of reserve, which can be committed. other update of buffer drops it. */
+	size_t reserve_size;
 } ttLibC_Util_DynamicBuffer_;
 
 typedef ttLibC_Util_DynamicBuffer_ ttLibC_DynamicBuffer_;
@@ -37,9 +41,47 @@ ttLibC_DynamicBuffer TT_VISIBILITY_DEFAULT *ttLibC_DynamicBuffer_make() {
 	buffer->buffer_size = 0;
 	buffer->target_size = 0;
 	buffer->read_pos = 0;
+	buffer->ref_data = NULL;
+	buffer->reserve_size = 0;
 	return (ttLibC_DynamicBuffer *)buffer;
 }
 
+/*
+ * copy ref_data from start_pos on own buffer, and leave non copy mode.
+ * @param buffer_   target dynamic buffer object.
+ * @param start_pos data before this position is dropped.
+ */
+static bool DynamicBuffer_own(
+		ttLibC_DynamicBuffer_ *buffer_,
+		size_t start_pos) {
+	if(buffer_->ref_data == NULL) {
+		return true;
+	}
+	size_t size = buffer_->target_size - start_pos;
+	if(size != 0 && (buffer_->buffer == NULL || buffer_->buffer_size < size)) {
+		uint8_t *new_buffer = ttLibC_malloc(size);
+		if(new_buffer == NULL) {
+			ERR_PRINT("failed to allocate memory for buffer.");
+			buffer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_MemoryAllocate);
+			return false;
+		}
+		if(buffer_->buffer != NULL) {
+			ttLibC_free(buffer_->buffer);
+		}
+		buffer_->buffer = new_buffer;
+		buffer_->buffer_size = size;
+		buffer_->inherit_super.buffer_size = buffer_->buffer_size;
+	}
+	if(size != 0) {
+		memcpy(buffer_->buffer, buffer_->ref_data + start_pos, size);
+	}
+	buffer_->ref_data = NULL;
+	buffer_->read_pos -= start_pos;
+	buffer_->target_size = size;
+	buffer_->inherit_super.target_size = buffer_->target_size;
+	return true;
+}
+
 bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_append(
 		ttLibC_DynamicBuffer *buffer,
 		uint8_t *data,
@@ -48,6 +90,10 @@ bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_append(
 	if(buffer_ == NULL) {
 		return false;
 	}
+	buffer_->reserve_size = 0;
+	if(!DynamicBuffer_own(buffer_, buffer_->read_pos)) {
+		return false;
+	}
 	if(buffer_->buffer == NULL) {
 		// no data. make new one.
 		buffer_->buffer = ttLibC_malloc(data_size);
@@ -95,6 +141,26 @@ bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_append(
 	}
 }
 
+bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_appendNonCopy(
+		ttLibC_DynamicBuffer *buffer,
+		uint8_t *data,
+		size_t data_size) {
+	ttLibC_DynamicBuffer_ *buffer_ = (ttLibC_DynamicBuffer_ *)buffer;
+	if(buffer_ == NULL) {
+		return false;
+	}
+	buffer_->reserve_size = 0;
+	if(buffer_->read_pos != buffer_->target_size) {
+		// have unread data, need to join with copy.
+		return ttLibC_DynamicBuffer_append(buffer, data, data_size);
+	}
+	buffer_->ref_data = data;
+	buffer_->read_pos = 0;
+	buffer_->target_size = data_size;
+	buffer_->inherit_super.target_size = buffer_->target_size;
+	return true;
+}
+
 bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_markAsRead(ttLibC_DynamicBuffer *buffer, size_t read_size) {
 	ttLibC_DynamicBuffer_ *buffer_ = (ttLibC_DynamicBuffer_ *)buffer;
 	if(buffer_ == NULL) {
@@ -114,6 +180,9 @@ uint8_t TT_VISIBILITY_DEFAULT *ttLibC_DynamicBuffer_refData(ttLibC_DynamicBuffer
 	if(buffer_ == NULL) {
 		return NULL;
 	}
+	if(buffer_->ref_data != NULL) {
+		return buffer_->ref_data + buffer_->read_pos;
+	}
 	return buffer_->buffer + buffer_->read_pos;
 }
 
@@ -130,6 +199,11 @@ bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_clear(ttLibC_DynamicBuffer *buff
 	if(buffer_ == NULL) {
 		return false;
 	}
+	buffer_->reserve_size = 0;
+	if(buffer_->ref_data != NULL) {
+		// keep unread data with copy, ref_data could be released after this.
+		return DynamicBuffer_own(buffer_, buffer_->read_pos);
+	}
 	if(buffer_->read_pos == 0) {
 		// if read_pos is 0, no need to shift.
 		return true;
@@ -162,9 +236,11 @@ bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_empty(ttLibC_DynamicBuffer *buff
 	if(buffer_ == NULL) {
 		return false;
 	}
+	buffer_->reserve_size = 0;
 	buffer_->read_pos = 0;
 	buffer_->target_size = 0;
 	buffer_->inherit_super.target_size = 0;
+	buffer_->ref_data = NULL;
 	return true;
 }
 
@@ -175,6 +251,10 @@ bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_alloc(
 	if(buffer_ == NULL) {
 		return false;
 	}
+	buffer_->reserve_size = 0;
+	if(!DynamicBuffer_own(buffer_, 0)) {
+		return false;
+	}
 	if(buffer_->buffer == NULL) {
 		// if no data. alloc memory.
 		buffer_->buffer = ttLibC_malloc(size);
@@ -218,6 +298,59 @@ bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_alloc(
 	return true;
 }
 
+uint8_t TT_VISIBILITY_DEFAULT *ttLibC_DynamicBuffer_reserve(
+		ttLibC_DynamicBuffer *buffer,
+		size_t size) {
+	ttLibC_DynamicBuffer_ *buffer_ = (ttLibC_DynamicBuffer_ *)buffer;
+	if(buffer_ == NULL) {
+		return NULL;
+	}
+	buffer_->reserve_size = 0;
+	if(!DynamicBuffer_own(buffer_, buffer_->read_pos)) {
+		return NULL;
+	}
+	if(buffer_->buffer == NULL || buffer_->target_size + size > buffer_->buffer_size) {
+		// double the memory, so that repeated reserve does not reallocate every time.
+		size_t buffer_size = buffer_->buffer_size * 2;
+		if(buffer_size < buffer_->target_size + size) {
+			buffer_size = buffer_->target_size + size;
+		}
+		uint8_t *new_buffer = ttLibC_malloc(buffer_size);
+		if(new_buffer == NULL) {
+			ERR_PRINT("failed to allocate memory for reserve.");
+			buffer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_MemoryAllocate);
+			return NULL;
+		}
+		if(buffer_->buffer != NULL) {
+			memcpy(new_buffer, buffer_->buffer, buffer_->target_size);
+			ttLibC_free(buffer_->buffer);
+		}
+		buffer_->buffer = new_buffer;
+		buffer_->buffer_size = buffer_size;
+		buffer_->inherit_super.buffer_size = buffer_->buffer_size;
+	}
+	buffer_->reserve_size = size;
+	return buffer_->buffer + buffer_->target_size;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_commit(
+		ttLibC_DynamicBuffer *buffer,
+		size_t size) {
+	ttLibC_DynamicBuffer_ *buffer_ = (ttLibC_DynamicBuffer_ *)buffer;
+	if(buffer_ == NULL) {
+		return false;
+	}
+	if(size > buffer_->reserve_size) {
+		ERR_PRINT("commit size is bigger than reserved size.");
+		buffer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_TtLibCError);
+		return false;
+	}
+	buffer_->target_size += size;
+	buffer_->inherit_super.target_size = buffer_->target_size;
+	buffer_->reserve_size = 0;
+	return true;
+}
+
 bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_write(
 		ttLibC_DynamicBuffer *buffer,
 		size_t write_pos,
@@ -227,6 +360,9 @@ bool TT_VISIBILITY_DEFAULT ttLibC_DynamicBuffer_write(
 	if(buffer_ == NULL) {
 		return false;
 	}
+	if(!DynamicBuffer_own(buffer_, 0)) {
+		return false;
+	}
 	if(buffer_->buffer == NULL) {
 		buffer_->inherit_super.error = ttLibC_updateError(Target_On_Util, Error_MemoryAllocate);
 		return false;
@@ -52,6 +52,20 @@ bool ttLibC_DynamicBuffer_append(
 		uint8_t *data,
 		size_t data_size);
 
+/**
+ * append data without copy, if all data is read.
+ * buffer refers the data until clear, the unread part is copied on clear.
+ * (readers call clear before return, so data of read call can be used directly.)
+ * if some data is not read yet, data is copied as append.
+ * @param buffer    target dynamic buffer object.
+ * @param data      append data. should be alive until clear, empty or close.
+ * @param data_size append data size
+ */
+bool ttLibC_DynamicBuffer_appendNonCopy(
+		ttLibC_DynamicBuffer *buffer,
+		uint8_t *data,
+		size_t data_size);
+
 /**
  * set read pointer.
  * read_size will be deleted on clear function.
@@ -102,6 +116,26 @@ bool ttLibC_DynamicBuffer_alloc(
 		ttLibC_DynamicBuffer *buffer,
 		size_t size);
 
+/**
+ * reserve writable memory on the end of buffer.
+ * data size is not changed until commit. memory is expanded with margin for next reserve.
+ * @param buffer target dynamic buffer object.
+ * @param size   required size.
+ * @return pointer for write. valid until next call for buffer. NULL for error.
+ */
+uint8_t *ttLibC_DynamicBuffer_reserve(
+		ttLibC_DynamicBuffer *buffer,
+		size_t size);
+
+/**
+ * append the data written on reserved memory.
+ * @param buffer target dynamic buffer object.
+ * @param size   written size. (less than or equal to reserved size)
+ */
+bool ttLibC_DynamicBuffer_commit(
+		ttLibC_DynamicBuffer *buffer,
+		size_t size);
+
 /**
  * write data on the dynamic buffer on specific position.
  * if the data is overflowed, error.
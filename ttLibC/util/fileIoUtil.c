@@ -0,0 +1,309 @@
+/*
+ * @file   fileIoUtil.c
+ * @brief  mmaped file source and buffered file sink for containers.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifdef __ENABLE_FILE__
+
+#ifndef _GNU_SOURCE
+#	define _GNU_SOURCE
+#endif
+
+#include "fileIoUtil.h"
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * alignment for O_DIRECT. (buffer address, write size and file offset)
+ */
+#define FileIo_alignSize 4096
+
+/*
+ * detail definition of file source.
+ */
+typedef struct ttLibC_Util_FileIoUtil_FileSource_ {
+	ttLibC_FileSource inherit_super;
+	uint8_t *map;
+} ttLibC_Util_FileIoUtil_FileSource_;
+
+typedef ttLibC_Util_FileIoUtil_FileSource_ ttLibC_FileSource_;
+
+ttLibC_FileSource TT_VISIBILITY_DEFAULT *ttLibC_FileSource_make(const char *path) {
+	if(path == NULL) {
+		return NULL;
+	}
+	int fd = open(path, O_RDONLY);
+	if(fd < 0) {
+		ERR_PRINT("failed to open:%s errno:%d", path, errno);
+		return NULL;
+	}
+	struct stat st;
+	if(fstat(fd, &st) != 0 || st.st_size == 0) {
+		ERR_PRINT("file is empty or unknown size:%s", path);
+		close(fd);
+		return NULL;
+	}
+	size_t size = st.st_size;
+	// readers rewrite data in place (nal size to start code...), so writable private mapping.
+	// written page is copied, file is not changed.
+	uint8_t *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	// mapping is alive after close.
+	close(fd);
+	if(map == MAP_FAILED) {
+		ERR_PRINT("failed to mmap:%s errno:%d", path, errno);
+		return NULL;
+	}
+	madvise(map, size, MADV_SEQUENTIAL);
+	ttLibC_FileSource_ *source = ttLibC_malloc(sizeof(ttLibC_FileSource_));
+	if(source == NULL) {
+		ERR_PRINT("failed to allocate memory for file source.");
+		munmap(map, size);
+		return NULL;
+	}
+	source->inherit_super.size = size;
+	source->inherit_super.slice_size = 1 << 20;
+	source->map = map;
+	return (ttLibC_FileSource *)source;
+}
+
+uint8_t TT_VISIBILITY_DEFAULT *ttLibC_FileSource_refData(ttLibC_FileSource *source) {
+	ttLibC_FileSource_ *source_ = (ttLibC_FileSource_ *)source;
+	if(source_ == NULL) {
+		return NULL;
+	}
+	return source_->map;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_FileSource_read(
+		ttLibC_FileSource *source,
+		ttLibC_ContainerReader *reader,
+		ttLibC_ContainerReadFunc callback,
+		void *ptr) {
+	ttLibC_FileSource_ *source_ = (ttLibC_FileSource_ *)source;
+	if(source_ == NULL || reader == NULL) {
+		return false;
+	}
+	// slice is aligned with page, for madvise.
+	size_t page_size = sysconf(_SC_PAGESIZE);
+	size_t slice_size = (source_->inherit_super.slice_size + page_size - 1) / page_size * page_size;
+	if(slice_size == 0) {
+		slice_size = page_size;
+	}
+	// reader refers the mapped memory without copy.
+	// unread tail is copied at the end of each read, so non copy mode is only for the call.
+	bool is_non_copy = reader->is_non_copy;
+	ttLibC_ContainerReader_setNonCopy(reader, true);
+	bool result = true;
+	for(size_t pos = 0;pos < source_->inherit_super.size && result;pos += slice_size) {
+		size_t size = source_->inherit_super.size - pos;
+		if(size > slice_size) {
+			size = slice_size;
+		}
+		result = ttLibC_ContainerReader_read(reader, source_->map + pos, size, callback, ptr);
+		// slice is not referred any more. drop private copy of rewritten pages,
+		// memory is released and file data comes back on next access.
+		madvise(source_->map + pos, size, MADV_DONTNEED);
+	}
+	ttLibC_ContainerReader_setNonCopy(reader, is_non_copy);
+	return result;
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_FileSource_close(ttLibC_FileSource **source) {
+	ttLibC_FileSource_ *target = (ttLibC_FileSource_ *)*source;
+	if(target == NULL) {
+		return;
+	}
+	munmap(target->map, target->inherit_super.size);
+	ttLibC_free(target);
+	*source = NULL;
+}
+
+/*
+ * detail definition of file sink.
+ */
+typedef struct ttLibC_Util_FileIoUtil_FileSink_ {
+	ttLibC_FileSink inherit_super;
+	int      fd;
+	/** allocated memory, buffer is aligned in it. */
+	void    *memory;
+	uint8_t *buffer;
+	size_t   buffer_size;
+	size_t   pos;
+} ttLibC_Util_FileIoUtil_FileSink_;
+
+typedef ttLibC_Util_FileIoUtil_FileSink_ ttLibC_FileSink_;
+
+ttLibC_FileSink TT_VISIBILITY_DEFAULT *ttLibC_FileSink_make(
+		const char *path,
+		size_t buffer_size,
+		bool is_direct) {
+	if(path == NULL) {
+		return NULL;
+	}
+	if(buffer_size == 0) {
+		buffer_size = 1 << 20;
+	}
+	buffer_size = (buffer_size + FileIo_alignSize - 1) / FileIo_alignSize * FileIo_alignSize;
+	ttLibC_FileSink_ *sink = ttLibC_malloc(sizeof(ttLibC_FileSink_));
+	if(sink == NULL) {
+		ERR_PRINT("failed to allocate memory for file sink.");
+		return NULL;
+	}
+	memset(sink, 0, sizeof(ttLibC_FileSink_));
+	sink->fd = -1;
+	sink->memory = ttLibC_malloc(buffer_size + FileIo_alignSize);
+	if(sink->memory == NULL) {
+		ERR_PRINT("failed to allocate memory for buffer.");
+		ttLibC_FileSink_close((ttLibC_FileSink **)&sink);
+		return NULL;
+	}
+	sink->buffer = (uint8_t *)(((uintptr_t)sink->memory + FileIo_alignSize - 1) & ~(uintptr_t)(FileIo_alignSize - 1));
+	sink->buffer_size = buffer_size;
+#ifdef O_DIRECT
+	if(is_direct) {
+		sink->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+		if(sink->fd >= 0) {
+			sink->inherit_super.is_direct = true;
+		}
+		else {
+			// some file system (tmpfs...) does not support O_DIRECT.
+			LOG_PRINT("O_DIRECT is not supported:%s errno:%d", path, errno);
+		}
+	}
+#endif
+	if(sink->fd < 0) {
+		sink->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	}
+	if(sink->fd < 0) {
+		ERR_PRINT("failed to open:%s errno:%d", path, errno);
+		ttLibC_FileSink_close((ttLibC_FileSink **)&sink);
+		return NULL;
+	}
+	return (ttLibC_FileSink *)sink;
+}
+
+/*
+ * write all data to fd.
+ */
+static bool FileSink_writeFully(ttLibC_FileSink_ *sink, uint8_t *data, size_t data_size) {
+	while(data_size > 0) {
+		ssize_t written = write(sink->fd, data, data_size);
+		if(written < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			ERR_PRINT("failed to write. errno:%d", errno);
+			sink->inherit_super.is_error = true;
+			return false;
+		}
+		++ sink->inherit_super.flush_count;
+		data += written;
+		data_size -= written;
+	}
+	return true;
+}
+
+/*
+ * write buffered data, for O_DIRECT unaligned rest is kept for next.
+ */
+static bool FileSink_flushAligned(ttLibC_FileSink_ *sink) {
+	size_t size = sink->pos;
+	if(sink->inherit_super.is_direct) {
+		size = size / FileIo_alignSize * FileIo_alignSize;
+	}
+	if(size == 0) {
+		return true;
+	}
+	if(!FileSink_writeFully(sink, sink->buffer, size)) {
+		return false;
+	}
+	memmove(sink->buffer, sink->buffer + size, sink->pos - size);
+	sink->pos -= size;
+	return true;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_FileSink_flush(ttLibC_FileSink *sink) {
+	ttLibC_FileSink_ *sink_ = (ttLibC_FileSink_ *)sink;
+	if(sink_ == NULL || sink_->inherit_super.is_error) {
+		return false;
+	}
+	if(!FileSink_flushAligned(sink_)) {
+		return false;
+	}
+	if(sink_->pos == 0) {
+		return true;
+	}
+#ifdef O_DIRECT
+	// unaligned tail, file offset will be unaligned, so O_DIRECT is not used any more.
+	int flags = fcntl(sink_->fd, F_GETFL);
+	fcntl(sink_->fd, F_SETFL, flags & ~O_DIRECT);
+#endif
+	sink_->inherit_super.is_direct = false;
+	if(!FileSink_writeFully(sink_, sink_->buffer, sink_->pos)) {
+		return false;
+	}
+	sink_->pos = 0;
+	return true;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_FileSink_write(void *ptr, void *data, size_t data_size) {
+	ttLibC_FileSink_ *sink = (ttLibC_FileSink_ *)ptr;
+	if(sink == NULL || sink->inherit_super.is_error) {
+		return false;
+	}
+	sink->inherit_super.write_size += data_size;
+	uint8_t *u8 = (uint8_t *)data;
+	if(!sink->inherit_super.is_direct && sink->pos + data_size > sink->buffer_size) {
+		if(!FileSink_flushAligned(sink)) {
+			return false;
+		}
+		if(data_size >= sink->buffer_size) {
+			// big data, no need to copy.
+			return FileSink_writeFully(sink, u8, data_size);
+		}
+	}
+	// for O_DIRECT, all data goes through aligned buffer.
+	while(data_size > 0) {
+		size_t size = sink->buffer_size - sink->pos;
+		if(size > data_size) {
+			size = data_size;
+		}
+		memcpy(sink->buffer + sink->pos, u8, size);
+		sink->pos += size;
+		u8 += size;
+		data_size -= size;
+		if(sink->pos == sink->buffer_size && !FileSink_flushAligned(sink)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_FileSink_close(ttLibC_FileSink **sink) {
+	ttLibC_FileSink_ *target = (ttLibC_FileSink_ *)*sink;
+	if(target == NULL) {
+		return;
+	}
+	if(target->fd >= 0) {
+		ttLibC_FileSink_flush((ttLibC_FileSink *)target);
+		close(target->fd);
+	}
+	ttLibC_free(target->memory);
+	ttLibC_free(target);
+	*sink = NULL;
+}
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file   fileIoUtil.h
+ * @brief  mmaped file source and buffered file sink for containers.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * source maps whole file with MADV_SEQUENTIAL, and give it to reader in slices.
+ * mapping is private copy on write, so reader can rewrite data without changing the file.
+ * reader refers the mapped memory, only unread tail of each slice is copied.
+ * read slice is dropped with MADV_DONTNEED, copied pages do not stay until close.
+ * sink gathers the data of writer callback, and write it in large aligned block.
+ * O_DIRECT is used when it is requested and supported, otherwise page cache is used.
+ *
+ * usage:
+ *   ttLibC_FileSource *source = ttLibC_FileSource_make("in.flv");
+ *   ttLibC_FileSink *sink = ttLibC_FileSink_make("out.mp4", 0, false);
+ *   ttLibC_FileSource_read(source, reader, readCallback, sink);
+ *   // in readCallback: ttLibC_ContainerWriter_write(writer, frame, ttLibC_FileSink_write, sink);
+ *   ttLibC_FileSink_close(&sink);
+ *   ttLibC_FileSource_close(&source);
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_UTIL_FILEIOUTIL_H_
+#define TTLIBC_UTIL_FILEIOUTIL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../container/container.h"
+
+/**
+ * data for file source
+ */
+typedef struct ttLibC_Util_FileIoUtil_FileSource {
+	/** byte size of file. */
+	size_t size;
+	/** byte size to give reader on one call, rounded up to page size. default 1MiB, can be changed before read. */
+	size_t slice_size;
+} ttLibC_Util_FileIoUtil_FileSource;
+
+typedef ttLibC_Util_FileIoUtil_FileSource ttLibC_FileSource;
+
+/**
+ * make file source.
+ * @param path target file path.
+ * @return file source object. NULL for empty file or error.
+ */
+ttLibC_FileSource *ttLibC_FileSource_make(const char *path);
+
+/**
+ * ref mapped data.
+ * @param source file source object.
+ * @return top of mapped data.
+ */
+uint8_t *ttLibC_FileSource_refData(ttLibC_FileSource *source);
+
+/**
+ * read whole file with container reader, in non copy mode.
+ * file is given in slices of slice_size. each slice is released after the reader call,
+ * data rewritten by reader is restored from file, so source can be read again.
+ * @param source   file source object.
+ * @param reader   container reader.
+ * @param callback callback for read container.
+ * @param ptr      user def pointer object.
+ * @return true:success false:error
+ */
+bool ttLibC_FileSource_read(
+		ttLibC_FileSource *source,
+		ttLibC_ContainerReader *reader,
+		ttLibC_ContainerReadFunc callback,
+		void *ptr);
+
+/**
+ * close file source.
+ * @param source
+ */
+void ttLibC_FileSource_close(ttLibC_FileSource **source);
+
+/**
+ * data for file sink
+ */
+typedef struct ttLibC_Util_FileIoUtil_FileSink {
+	/** byte size of given data. */
+	uint64_t write_size;
+	/** number of write system call. */
+	uint64_t flush_count;
+	/** true:file is opened with O_DIRECT. */
+	bool is_direct;
+	/** true:write failed. */
+	bool is_error;
+} ttLibC_Util_FileIoUtil_FileSink;
+
+typedef ttLibC_Util_FileIoUtil_FileSink ttLibC_FileSink;
+
+/**
+ * make file sink.
+ * @param path        target file path. truncated.
+ * @param buffer_size size of buffer. rounded up to 4096. 0 for 1MByte.
+ * @param is_direct   true:try O_DIRECT.
+ * @return file sink object.
+ */
+ttLibC_FileSink *ttLibC_FileSink_make(
+		const char *path,
+		size_t buffer_size,
+		bool is_direct);
+
+/**
+ * write data, can be used as ttLibC_ContainerWriteFunc.
+ * @param ptr       file sink object.
+ * @param data      data to write.
+ * @param data_size size of data.
+ * @return true:success false:error
+ */
+bool ttLibC_FileSink_write(void *ptr, void *data, size_t data_size);
+
+/**
+ * write all buffered data to file.
+ * for O_DIRECT, unaligned tail is written without O_DIRECT, and it is not used after that.
+ * @param sink file sink object.
+ * @return true:success false:error
+ */
+bool ttLibC_FileSink_flush(ttLibC_FileSink *sink);
+
+/**
+ * close file sink. rest data is written.
+ * call flush before close to check the write error.
+ * @param sink
+ */
+void ttLibC_FileSink_close(ttLibC_FileSink **sink);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_UTIL_FILEIOUTIL_H_ */
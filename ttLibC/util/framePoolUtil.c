@@ -0,0 +1,340 @@
+/*
+ * @file   framePoolUtil.c
+ * @brief  pool of frames for prev_frame recycling.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "framePoolUtil.h"
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+#include "../khash.h"
+#include "../frame/video/video.h"
+#include "../frame/video/yuv420.h"
+#include "../frame/video/bgr.h"
+#include "../frame/audio/audio.h"
+#include "../frame/audio/pcms16.h"
+#include "../frame/audio/pcmf32.h"
+#include <pthread.h>
+#include <string.h>
+
+KHASH_MAP_INIT_INT64(ttLibC_FramePool_Ref, uint32_t)
+
+typedef struct ttLibC_Util_FramePoolUtil_FramePool_ {
+	ttLibC_FramePool inherit_super;
+	/** idle frames, last one is the most recent. */
+	ttLibC_Frame **frames;
+	/** extra reference count for shared frames. */
+	khash_t(ttLibC_FramePool_Ref) *ref_table;
+	pthread_mutex_t mutex;
+} ttLibC_Util_FramePoolUtil_FramePool_;
+
+typedef ttLibC_Util_FramePoolUtil_FramePool_ ttLibC_FramePool_;
+
+/*
+ * make frame pool.
+ * @param max_num max number of frames to hold.
+ * @return pool object.
+ */
+ttLibC_FramePool TT_VISIBILITY_DEFAULT *ttLibC_FramePool_make(uint32_t max_num) {
+	if(max_num == 0) {
+		ERR_PRINT("max_num must be more than 0.");
+		return NULL;
+	}
+	ttLibC_FramePool_ *pool = ttLibC_malloc(sizeof(ttLibC_FramePool_));
+	if(pool == NULL) {
+		ERR_PRINT("failed to allocate memory for pool.");
+		return NULL;
+	}
+	memset(pool, 0, sizeof(ttLibC_FramePool_));
+	pool->frames = ttLibC_malloc(sizeof(ttLibC_Frame *) * max_num);
+	if(pool->frames == NULL) {
+		ERR_PRINT("failed to allocate memory for frame table.");
+		ttLibC_free(pool);
+		return NULL;
+	}
+	pool->ref_table = kh_init(ttLibC_FramePool_Ref);
+	if(pthread_mutex_init(&pool->mutex, NULL) != 0) {
+		ERR_PRINT("failed to init mutex.");
+		kh_destroy(ttLibC_FramePool_Ref, pool->ref_table);
+		ttLibC_free(pool->frames);
+		ttLibC_free(pool);
+		return NULL;
+	}
+	pool->inherit_super.max_num = max_num;
+	return (ttLibC_FramePool *)pool;
+}
+
+/*
+ * ref detail type for raw frames.
+ * @param frame
+ * @return sub type, 0 for other frames.
+ */
+static uint32_t FramePool_getSubType(ttLibC_Frame *frame) {
+	switch(frame->type) {
+	case frameType_yuv420:
+		return ((ttLibC_Yuv420 *)frame)->type;
+	case frameType_bgr:
+		return ((ttLibC_Bgr *)frame)->type;
+	case frameType_pcmS16:
+		return ((ttLibC_PcmS16 *)frame)->type;
+	case frameType_pcmF32:
+		return ((ttLibC_PcmF32 *)frame)->type;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * ref line stride of raw video frame.
+ * @param frame
+ * @return y_stride for yuv420, width_stride for bgr, 0 for other frames.
+ */
+static uint32_t FramePool_getStride(ttLibC_Frame *frame) {
+	switch(frame->type) {
+	case frameType_yuv420:
+		return ((ttLibC_Yuv420 *)frame)->y_stride;
+	case frameType_bgr:
+		return ((ttLibC_Bgr *)frame)->width_stride;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * stride which makeEmptyFrame2 use for the geometry.
+ * only frames with this stride are held, so make func can reuse the layout as is.
+ * @param type     frame type
+ * @param sub_type detail type
+ * @param width    width
+ * @return stride, 0 for other frames.
+ */
+static uint32_t FramePool_getEmptyFrameStride(
+		ttLibC_Frame_Type type,
+		uint32_t sub_type,
+		uint32_t width) {
+#define GET_ALIGNED_STRIDE(w) (((((w) - 1) >> 4) + 1) << 4)
+	switch(type) {
+	case frameType_yuv420:
+		return GET_ALIGNED_STRIDE(width);
+	case frameType_bgr:
+		switch(sub_type) {
+		case BgrType_bgr:
+		case BgrType_rgb:
+			return GET_ALIGNED_STRIDE(width * 3);
+		default:
+			return GET_ALIGNED_STRIDE(width * 4);
+		}
+	default:
+		return 0;
+	}
+#undef GET_ALIGNED_STRIDE
+}
+
+/*
+ * take frame which match out of idle list.
+ * key is type, sub_type(layout), geometry and stride.
+ * search from the most recent one, for cache hit.
+ */
+static ttLibC_Frame *FramePool_get(
+		ttLibC_FramePool_ *pool,
+		ttLibC_Frame_Type type,
+		uint32_t sub_type,
+		uint32_t width,
+		uint32_t height,
+		bool is_video) {
+	if(pool == NULL) {
+		return NULL;
+	}
+	ttLibC_Frame *result = NULL;
+	pthread_mutex_lock(&pool->mutex);
+	for(int i = (int)pool->inherit_super.num - 1;i >= 0;-- i) {
+		ttLibC_Frame *frame = pool->frames[i];
+		if(frame->type != type || FramePool_getSubType(frame) != sub_type) {
+			continue;
+		}
+		if(is_video) {
+			ttLibC_Video *video = (ttLibC_Video *)frame;
+			if(video->width != width || video->height != height
+			|| FramePool_getStride(frame) != FramePool_getEmptyFrameStride(type, sub_type, width)) {
+				continue;
+			}
+		}
+		else {
+			ttLibC_Audio *audio = (ttLibC_Audio *)frame;
+			if(audio->channel_num != width) {
+				continue;
+			}
+		}
+		result = frame;
+		-- pool->inherit_super.num;
+		pool->frames[i] = pool->frames[pool->inherit_super.num];
+		break;
+	}
+	if(result == NULL) {
+		++ pool->inherit_super.miss_count;
+	}
+	else {
+		++ pool->inherit_super.hit_count;
+	}
+	pthread_mutex_unlock(&pool->mutex);
+	return result;
+}
+
+/*
+ * take reusable video frame out of pool.
+ * @param pool     pool object.
+ * @param type     frame type.
+ * @param sub_type detail type.
+ * @param width    width
+ * @param height   height
+ * @return frame for prev_frame. NULL if nothing matched.
+ */
+ttLibC_Frame TT_VISIBILITY_DEFAULT *ttLibC_FramePool_getVideo(
+		ttLibC_FramePool *pool,
+		ttLibC_Frame_Type type,
+		uint32_t sub_type,
+		uint32_t width,
+		uint32_t height) {
+	return FramePool_get((ttLibC_FramePool_ *)pool, type, sub_type, width, height, true);
+}
+
+/*
+ * take reusable audio frame out of pool.
+ * @param pool        pool object.
+ * @param type        frame type.
+ * @param sub_type    detail type.
+ * @param channel_num channel_num
+ * @return frame for prev_frame. NULL if nothing matched.
+ */
+ttLibC_Frame TT_VISIBILITY_DEFAULT *ttLibC_FramePool_getAudio(
+		ttLibC_FramePool *pool,
+		ttLibC_Frame_Type type,
+		uint32_t sub_type,
+		uint32_t channel_num) {
+	return FramePool_get((ttLibC_FramePool_ *)pool, type, sub_type, channel_num, 0, false);
+}
+
+/*
+ * make copy of frame on pooled frame.
+ * @param pool      pool object.
+ * @param src_frame source of clone.
+ * @return cloned frame.
+ */
+ttLibC_Frame TT_VISIBILITY_DEFAULT *ttLibC_FramePool_clone(
+		ttLibC_FramePool *pool,
+		ttLibC_Frame *src_frame) {
+	if(src_frame == NULL) {
+		return NULL;
+	}
+	ttLibC_Frame *prev_frame = NULL;
+	uint32_t sub_type = FramePool_getSubType(src_frame);
+	if(ttLibC_Frame_isVideo(src_frame)) {
+		ttLibC_Video *video = (ttLibC_Video *)src_frame;
+		prev_frame = ttLibC_FramePool_getVideo(pool, src_frame->type, sub_type, video->width, video->height);
+	}
+	else if(ttLibC_Frame_isAudio(src_frame)) {
+		ttLibC_Audio *audio = (ttLibC_Audio *)src_frame;
+		prev_frame = ttLibC_FramePool_getAudio(pool, src_frame->type, sub_type, audio->channel_num);
+	}
+	ttLibC_Frame *frame = ttLibC_Frame_clone(prev_frame, src_frame);
+	if(frame == NULL) {
+		ttLibC_Frame_close(&prev_frame);
+	}
+	return frame;
+}
+
+/*
+ * add reference for frame.
+ * @param pool  pool object.
+ * @param frame target frame.
+ * @return frame
+ */
+ttLibC_Frame TT_VISIBILITY_DEFAULT *ttLibC_FramePool_ref(
+		ttLibC_FramePool *pool,
+		ttLibC_Frame *frame) {
+	ttLibC_FramePool_ *pool_ = (ttLibC_FramePool_ *)pool;
+	if(pool_ == NULL || frame == NULL) {
+		return frame;
+	}
+	int ret;
+	pthread_mutex_lock(&pool_->mutex);
+	khiter_t it = kh_put(ttLibC_FramePool_Ref, pool_->ref_table, (uint64_t)frame, &ret);
+	if(ret == 0) {
+		++ kh_value(pool_->ref_table, it);
+	}
+	else {
+		kh_value(pool_->ref_table, it) = 1;
+	}
+	pthread_mutex_unlock(&pool_->mutex);
+	return frame;
+}
+
+/*
+ * release reference.
+ * @param pool  pool object.
+ * @param frame target frame, set NULL after call.
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_FramePool_release(
+		ttLibC_FramePool *pool,
+		ttLibC_Frame **frame) {
+	if(frame == NULL || *frame == NULL) {
+		return;
+	}
+	ttLibC_FramePool_ *pool_ = (ttLibC_FramePool_ *)pool;
+	if(pool_ == NULL) {
+		ttLibC_Frame_close(frame);
+		return;
+	}
+	ttLibC_Frame *target = *frame;
+	*frame = NULL;
+	pthread_mutex_lock(&pool_->mutex);
+	khiter_t it = kh_get(ttLibC_FramePool_Ref, pool_->ref_table, (uint64_t)target);
+	if(it != kh_end(pool_->ref_table)) {
+		// still referred by others.
+		if(-- kh_value(pool_->ref_table, it) == 0) {
+			kh_del(ttLibC_FramePool_Ref, pool_->ref_table, it);
+		}
+		pthread_mutex_unlock(&pool_->mutex);
+		return;
+	}
+	bool is_reusable = !target->is_non_copy;
+	if(is_reusable && ttLibC_Frame_isVideo(target)) {
+		// frame with other stride (made from external buffer) can not be reused as is.
+		ttLibC_Video *video = (ttLibC_Video *)target;
+		is_reusable = FramePool_getStride(target) == FramePool_getEmptyFrameStride(target->type, FramePool_getSubType(target), video->width);
+	}
+	if(is_reusable && pool_->inherit_super.num < pool_->inherit_super.max_num) {
+		// only frames which own their buffer can be reused.
+		pool_->frames[pool_->inherit_super.num ++] = target;
+		target = NULL;
+	}
+	else {
+		++ pool_->inherit_super.drop_count;
+	}
+	pthread_mutex_unlock(&pool_->mutex);
+	ttLibC_Frame_close(&target);
+}
+
+/*
+ * close pool
+ * @param pool
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_FramePool_close(ttLibC_FramePool **pool) {
+	ttLibC_FramePool_ *target = (ttLibC_FramePool_ *)*pool;
+	if(target == NULL) {
+		return;
+	}
+	for(uint32_t i = 0;i < target->inherit_super.num;++ i) {
+		ttLibC_Frame_close(&target->frames[i]);
+	}
+	ttLibC_free(target->frames);
+	kh_destroy(ttLibC_FramePool_Ref, target->ref_table);
+	pthread_mutex_destroy(&target->mutex);
+	ttLibC_free(target);
+	*pool = NULL;
+}
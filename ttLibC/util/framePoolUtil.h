@@ -0,0 +1,131 @@
+/**
+ * @file   framePoolUtil.h
+ * @brief  pool of frames for prev_frame recycling.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * usage:
+ *   ttLibC_FramePool *pool = ttLibC_FramePool_make(16);
+ *   // draw reuse frame from pool, and make.
+ *   ttLibC_Yuv420 *prev = (ttLibC_Yuv420 *)ttLibC_FramePool_getVideo(pool, frameType_yuv420, Yuv420Type_planar, 640, 480);
+ *   ttLibC_Yuv420 *yuv = ttLibC_ImageResizer_resizeYuv420(prev, Yuv420Type_planar, 640, 480, src, false);
+ *   // done with frame, return to pool.
+ *   ttLibC_FramePool_release(pool, (ttLibC_Frame **)&yuv);
+ *
+ * frames are keyed by type, sub_type(layout), geometry and stride.
+ * raw video frames are held only with the stride of makeEmptyFrame2,
+ * frames with other stride (or non_copy frames) are closed on release.
+ *
+ * decoders and resamplers with pool (setFramePool) make output on pooled frame.
+ * call ttLibC_FramePool_ref in callback to hold it, and ttLibC_FramePool_release when done.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_UTIL_FRAMEPOOLUTIL_H_
+#define TTLIBC_UTIL_FRAMEPOOLUTIL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../frame/frame.h"
+
+/**
+ * data for framePool
+ */
+typedef struct ttLibC_Util_FramePoolUtil_FramePool {
+	/** max number of holding frames. */
+	uint32_t max_num;
+	/** number of holding frames. */
+	uint32_t num;
+	/** number of get request which found reusable frame. */
+	uint64_t hit_count;
+	/** number of get request which found nothing. */
+	uint64_t miss_count;
+	/** number of released frame which is closed, cause of pool full or not reusable. */
+	uint64_t drop_count;
+} ttLibC_Util_FramePoolUtil_FramePool;
+
+typedef ttLibC_Util_FramePoolUtil_FramePool ttLibC_FramePool;
+
+/**
+ * make frame pool.
+ * @param max_num max number of frames to hold.
+ * @return pool object.
+ */
+ttLibC_FramePool *ttLibC_FramePool_make(uint32_t max_num);
+
+/**
+ * take reusable video frame out of pool.
+ * @param pool     pool object.
+ * @param type     frame type. (frameType_yuv420, frameType_bgr...)
+ * @param sub_type detail type. (ttLibC_Yuv420_Type, ttLibC_Bgr_Type...) 0 for other frame.
+ * @param width    width
+ * @param height   height
+ * @return frame for prev_frame, with stride of makeEmptyFrame2. NULL if nothing matched.
+ */
+ttLibC_Frame *ttLibC_FramePool_getVideo(
+		ttLibC_FramePool *pool,
+		ttLibC_Frame_Type type,
+		uint32_t sub_type,
+		uint32_t width,
+		uint32_t height);
+
+/**
+ * take reusable audio frame out of pool.
+ * sample_num is not checked, make func reallocate the buffer if short.
+ * @param pool        pool object.
+ * @param type        frame type. (frameType_pcmS16, frameType_pcmF32...)
+ * @param sub_type    detail type. (ttLibC_PcmS16_Type, ttLibC_PcmF32_Type...) 0 for other frame.
+ * @param channel_num channel_num
+ * @return frame for prev_frame. NULL if nothing matched.
+ */
+ttLibC_Frame *ttLibC_FramePool_getAudio(
+		ttLibC_FramePool *pool,
+		ttLibC_Frame_Type type,
+		uint32_t sub_type,
+		uint32_t channel_num);
+
+/**
+ * make copy of frame on pooled frame.
+ * @param pool      pool object.
+ * @param src_frame source of clone.
+ * @return cloned frame. give back with ttLibC_FramePool_release.
+ */
+ttLibC_Frame *ttLibC_FramePool_clone(
+		ttLibC_FramePool *pool,
+		ttLibC_Frame *src_frame);
+
+/**
+ * add reference for frame, which is shared.
+ * @param pool  pool object.
+ * @param frame target frame.
+ * @return frame
+ */
+ttLibC_Frame *ttLibC_FramePool_ref(
+		ttLibC_FramePool *pool,
+		ttLibC_Frame *frame);
+
+/**
+ * release reference. if no more reference, frame is back to pool.
+ * (or closed when pool is full, or the frame is not reusable)
+ * @param pool  pool object.
+ * @param frame target frame, set NULL after call.
+ */
+void ttLibC_FramePool_release(
+		ttLibC_FramePool *pool,
+		ttLibC_Frame **frame);
+
+/**
+ * close pool, holding frames are closed.
+ * @param pool
+ */
+void ttLibC_FramePool_close(ttLibC_FramePool **pool);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_UTIL_FRAMEPOOLUTIL_H_ */
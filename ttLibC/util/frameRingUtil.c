@@ -0,0 +1,487 @@
+/*
+ * @file   frameRingUtil.c
+ * @brief  lock-free bounded queue of frame references between threads.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "frameRingUtil.h"
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#	include <sys/eventfd.h>
+#endif
+
+#define FrameRing_cacheLine 64
+
+/*
+ * producer index and consumer index are put on separate cache lines.
+ */
+typedef struct ttLibC_Util_FrameRingUtil_FrameRing_ {
+	ttLibC_FrameRing inherit_super;
+	ttLibC_Frame **frames;
+	/** sequence of each slot for mpsc. */
+	uint64_t *sequences;
+	uint64_t mask;
+	/** fd for wait. read side */
+	int read_fd;
+	/** fd for wait. write side (same as read_fd for eventfd) */
+	int write_fd;
+	/** fd for producer wait on full. read side */
+	int space_read_fd;
+	/** fd for producer wait on full. write side */
+	int space_write_fd;
+	uint8_t pad0[FrameRing_cacheLine];
+	/** consumer position. */
+	uint64_t head;
+	/** tail seen by consumer. (spsc) */
+	uint64_t cached_tail;
+	uint8_t pad1[FrameRing_cacheLine];
+	/** producer position. */
+	uint64_t tail;
+	/** head seen by producer. (spsc) */
+	uint64_t cached_head;
+	uint8_t pad2[FrameRing_cacheLine];
+	/** 1 while consumer waits on fd. */
+	uint32_t waiting;
+	uint8_t pad3[FrameRing_cacheLine];
+	/** number of producers which wait on space fd. */
+	uint32_t space_waiting;
+	uint8_t pad4[FrameRing_cacheLine];
+} ttLibC_Util_FrameRingUtil_FrameRing_;
+
+typedef ttLibC_Util_FrameRingUtil_FrameRing_ ttLibC_FrameRing_;
+
+/*
+ * make fd for wait.
+ * @param read_fd  fd for poll.
+ * @param write_fd fd for signal. (same as read_fd for eventfd)
+ */
+static void FrameRing_makeFd(int *read_fd, int *write_fd) {
+#ifdef __linux__
+	*read_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	*write_fd = *read_fd;
+#else
+	int fds[2];
+	if(pipe(fds) == 0) {
+		fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+		fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+		*read_fd  = fds[0];
+		*write_fd = fds[1];
+	}
+#endif
+}
+
+/*
+ * make frame ring.
+ * @param type     spsc or mpsc
+ * @param capacity max number of frames. rounded up to power of 2.
+ * @return ring object.
+ */
+ttLibC_FrameRing TT_VISIBILITY_DEFAULT *ttLibC_FrameRing_make(
+		ttLibC_FrameRing_Type type,
+		uint32_t capacity) {
+	if(capacity == 0 || capacity > 0x80000000) {
+		ERR_PRINT("capacity is out of range.:%u", capacity);
+		return NULL;
+	}
+	uint32_t size = 1;
+	while(size < capacity) {
+		size <<= 1;
+	}
+	ttLibC_FrameRing_ *ring = ttLibC_malloc(sizeof(ttLibC_FrameRing_));
+	if(ring == NULL) {
+		ERR_PRINT("failed to allocate memory for ring.");
+		return NULL;
+	}
+	memset(ring, 0, sizeof(ttLibC_FrameRing_));
+	ring->read_fd  = -1;
+	ring->write_fd = -1;
+	ring->space_read_fd  = -1;
+	ring->space_write_fd = -1;
+	ring->frames = ttLibC_malloc(sizeof(ttLibC_Frame *) * size);
+	if(ring->frames == NULL) {
+		ERR_PRINT("failed to allocate memory for frame table.");
+		ttLibC_FrameRing_close((ttLibC_FrameRing **)&ring);
+		return NULL;
+	}
+	if(type == FrameRingType_mpsc) {
+		ring->sequences = ttLibC_malloc(sizeof(uint64_t) * size);
+		if(ring->sequences == NULL) {
+			ERR_PRINT("failed to allocate memory for sequence table.");
+			ttLibC_FrameRing_close((ttLibC_FrameRing **)&ring);
+			return NULL;
+		}
+		for(uint32_t i = 0;i < size;++ i) {
+			ring->sequences[i] = i;
+		}
+	}
+	FrameRing_makeFd(&ring->read_fd, &ring->write_fd);
+	FrameRing_makeFd(&ring->space_read_fd, &ring->space_write_fd);
+	if(ring->read_fd < 0 || ring->space_read_fd < 0) {
+		ERR_PRINT("failed to make fd for wait.");
+		ttLibC_FrameRing_close((ttLibC_FrameRing **)&ring);
+		return NULL;
+	}
+	ring->mask = size - 1;
+	ring->inherit_super.type     = type;
+	ring->inherit_super.capacity = size;
+	return (ttLibC_FrameRing *)ring;
+}
+
+/*
+ * make fd readable.
+ */
+static void FrameRing_signal(int fd) {
+#ifdef __linux__
+	uint64_t value = 1;
+#else
+	uint8_t value = 1;
+#endif
+	if(write(fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+		ERR_PRINT("failed to write fd.");
+	}
+}
+
+/*
+ * wake consumer if it waits on fd.
+ */
+static void FrameRing_notify(ttLibC_FrameRing_ *ring) {
+	// pair with the fence of armWait, either consumer sees the frame or we see waiting.
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if(__atomic_load_n(&ring->waiting, __ATOMIC_RELAXED) == 0) {
+		return;
+	}
+	if(__atomic_exchange_n(&ring->waiting, 0, __ATOMIC_RELAXED) == 0) {
+		return;
+	}
+	FrameRing_signal(ring->write_fd);
+}
+
+/*
+ * wake producers if they wait on space fd.
+ */
+static void FrameRing_notifySpace(ttLibC_FrameRing_ *ring) {
+	// pair with the fence of FrameRing_armSpaceWait.
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if(__atomic_load_n(&ring->space_waiting, __ATOMIC_RELAXED) == 0) {
+		return;
+	}
+	FrameRing_signal(ring->space_write_fd);
+}
+
+/*
+ * drop the signal on fd.
+ */
+static void FrameRing_drain(int fd) {
+	uint8_t buf[64];
+	while(read(fd, buf, sizeof(buf)) > 0) {
+#ifdef __linux__
+		break;
+#endif
+	}
+}
+
+static bool FrameRing_pushSpsc(ttLibC_FrameRing_ *ring, ttLibC_Frame *frame) {
+	uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	if(tail - ring->cached_head > ring->mask) {
+		ring->cached_head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		if(tail - ring->cached_head > ring->mask) {
+			return false;
+		}
+	}
+	ring->frames[tail & ring->mask] = frame;
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+static bool FrameRing_pushMpsc(ttLibC_FrameRing_ *ring, ttLibC_Frame *frame) {
+	uint64_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	while(true) {
+		uint64_t seq = __atomic_load_n(&ring->sequences[pos & ring->mask], __ATOMIC_ACQUIRE);
+		int64_t diff = (int64_t)(seq - pos);
+		if(diff == 0) {
+			// slot is free, take the position.
+			if(__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+				break;
+			}
+			// pos is updated by failed cas.
+		}
+		else if(diff < 0) {
+			// consumer does not release the slot yet, full.
+			return false;
+		}
+		else {
+			pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+		}
+	}
+	ring->frames[pos & ring->mask] = frame;
+	__atomic_store_n(&ring->sequences[pos & ring->mask], pos + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+/*
+ * push frame reference. (producer)
+ * @param ring  ring object.
+ * @param frame target frame. consumer owns it after success.
+ * @return true:success false:full or error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_FrameRing_push(
+		ttLibC_FrameRing *ring,
+		ttLibC_Frame *frame) {
+	ttLibC_FrameRing_ *ring_ = (ttLibC_FrameRing_ *)ring;
+	if(ring_ == NULL || frame == NULL) {
+		return false;
+	}
+	bool result = false;
+	switch(ring_->inherit_super.type) {
+	case FrameRingType_spsc:
+		result = FrameRing_pushSpsc(ring_, frame);
+		break;
+	case FrameRingType_mpsc:
+		result = FrameRing_pushMpsc(ring_, frame);
+		break;
+	default:
+		return false;
+	}
+	if(result) {
+		FrameRing_notify(ring_);
+	}
+	return result;
+}
+
+/*
+ * check frame on head.
+ * @param ring
+ * @return true:frame is ready.
+ */
+static bool FrameRing_hasFrame(ttLibC_FrameRing_ *ring) {
+	uint64_t head = ring->head;
+	if(ring->inherit_super.type == FrameRingType_mpsc) {
+		return __atomic_load_n(&ring->sequences[head & ring->mask], __ATOMIC_ACQUIRE) == head + 1;
+	}
+	if(head != ring->cached_tail) {
+		return true;
+	}
+	ring->cached_tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	return head != ring->cached_tail;
+}
+
+/*
+ * pop frame reference without wait. (consumer)
+ * @param ring ring object.
+ * @return frame. NULL for empty.
+ */
+ttLibC_Frame TT_VISIBILITY_DEFAULT *ttLibC_FrameRing_pop(ttLibC_FrameRing *ring) {
+	ttLibC_FrameRing_ *ring_ = (ttLibC_FrameRing_ *)ring;
+	if(ring_ == NULL || !FrameRing_hasFrame(ring_)) {
+		return NULL;
+	}
+	uint64_t head = ring_->head;
+	ttLibC_Frame *frame = ring_->frames[head & ring_->mask];
+	if(ring_->inherit_super.type == FrameRingType_mpsc) {
+		// slot is free for the producer of next round.
+		__atomic_store_n(&ring_->sequences[head & ring_->mask], head + ring_->mask + 1, __ATOMIC_RELEASE);
+		ring_->head = head + 1;
+	}
+	else {
+		__atomic_store_n(&ring_->head, head + 1, __ATOMIC_RELEASE);
+	}
+	FrameRing_notifySpace(ring_);
+	return frame;
+}
+
+/*
+ * prepare wait on fd. (consumer)
+ * @param ring ring object.
+ * @return true:ring is empty, and next push makes fd readable. false:frame is ready to pop.
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_FrameRing_armWait(ttLibC_FrameRing *ring) {
+	ttLibC_FrameRing_ *ring_ = (ttLibC_FrameRing_ *)ring;
+	if(ring_ == NULL) {
+		return false;
+	}
+	FrameRing_drain(ring_->read_fd);
+	__atomic_store_n(&ring_->waiting, 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	if(FrameRing_hasFrame(ring_)) {
+		__atomic_store_n(&ring_->waiting, 0, __ATOMIC_RELAXED);
+		return false;
+	}
+	return true;
+}
+
+/*
+ * ref current time in milli sec.
+ */
+static int64_t FrameRing_now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*
+ * pop frame reference, wait for push if empty. (consumer)
+ * @param ring         ring object.
+ * @param timeout_msec max wait time. -1 for infinite, 0 for no wait.
+ * @return frame. NULL for timeout.
+ */
+ttLibC_Frame TT_VISIBILITY_DEFAULT *ttLibC_FrameRing_popWait(
+		ttLibC_FrameRing *ring,
+		int32_t timeout_msec) {
+	ttLibC_FrameRing_ *ring_ = (ttLibC_FrameRing_ *)ring;
+	if(ring_ == NULL) {
+		return NULL;
+	}
+	int64_t end_time = timeout_msec > 0 ? FrameRing_now() + timeout_msec : 0;
+	while(true) {
+		ttLibC_Frame *frame = ttLibC_FrameRing_pop(ring);
+		if(frame != NULL || timeout_msec == 0) {
+			return frame;
+		}
+		if(!ttLibC_FrameRing_armWait(ring)) {
+			continue;
+		}
+		int wait_msec = -1;
+		if(timeout_msec > 0) {
+			int64_t left = end_time - FrameRing_now();
+			if(left <= 0) {
+				__atomic_store_n(&ring_->waiting, 0, __ATOMIC_RELAXED);
+				return ttLibC_FrameRing_pop(ring);
+			}
+			wait_msec = (int)left;
+		}
+		struct pollfd pfd;
+		pfd.fd      = ring_->read_fd;
+		pfd.events  = POLLIN;
+		pfd.revents = 0;
+		if(poll(&pfd, 1, wait_msec) < 0 && errno != EINTR) {
+			ERR_PRINT("failed to poll.");
+			__atomic_store_n(&ring_->waiting, 0, __ATOMIC_RELAXED);
+			return NULL;
+		}
+	}
+}
+
+/*
+ * check free slot for producer.
+ * @param ring
+ * @return true:ring has space. (can be taken by other producer for mpsc)
+ */
+static bool FrameRing_hasSpace(ttLibC_FrameRing_ *ring) {
+	uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+	if(ring->inherit_super.type == FrameRingType_mpsc) {
+		return __atomic_load_n(&ring->sequences[tail & ring->mask], __ATOMIC_ACQUIRE) == tail;
+	}
+	return tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) <= ring->mask;
+}
+
+/*
+ * push frame reference, wait for pop if full. (producer)
+ * @param ring         ring object.
+ * @param frame        target frame. consumer owns it after success.
+ * @param timeout_msec max wait time. -1 for infinite, 0 for no wait.
+ * @return true:success false:timeout or error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_FrameRing_pushWait(
+		ttLibC_FrameRing *ring,
+		ttLibC_Frame *frame,
+		int32_t timeout_msec) {
+	ttLibC_FrameRing_ *ring_ = (ttLibC_FrameRing_ *)ring;
+	if(ring_ == NULL || frame == NULL) {
+		return false;
+	}
+	int64_t end_time = timeout_msec > 0 ? FrameRing_now() + timeout_msec : 0;
+	while(true) {
+		if(ttLibC_FrameRing_push(ring, frame)) {
+			return true;
+		}
+		if(timeout_msec == 0) {
+			return false;
+		}
+		// same as armWait, either pop sees space_waiting or we see the free slot.
+		FrameRing_drain(ring_->space_read_fd);
+		__atomic_fetch_add(&ring_->space_waiting, 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		int wait_msec = -1;
+		if(timeout_msec > 0) {
+			int64_t left = end_time - FrameRing_now();
+			wait_msec = left > 0 ? (int)left : 0;
+		}
+		bool result = true;
+		if(!FrameRing_hasSpace(ring_) && wait_msec != 0) {
+			struct pollfd pfd;
+			pfd.fd      = ring_->space_read_fd;
+			pfd.events  = POLLIN;
+			pfd.revents = 0;
+			if(poll(&pfd, 1, wait_msec) < 0 && errno != EINTR) {
+				ERR_PRINT("failed to poll.");
+				result = false;
+			}
+		}
+		__atomic_fetch_sub(&ring_->space_waiting, 1, __ATOMIC_RELAXED);
+		if(!result) {
+			return false;
+		}
+		if(wait_msec == 0) {
+			// timeout, last try.
+			return ttLibC_FrameRing_push(ring, frame);
+		}
+	}
+}
+
+/*
+ * ref the fd, which will be readable on push after ttLibC_FrameRing_armWait.
+ * @param ring ring object.
+ * @return fd. -1 for error.
+ */
+int TT_VISIBILITY_DEFAULT ttLibC_FrameRing_refFd(ttLibC_FrameRing *ring) {
+	ttLibC_FrameRing_ *ring_ = (ttLibC_FrameRing_ *)ring;
+	if(ring_ == NULL) {
+		return -1;
+	}
+	return ring_->read_fd;
+}
+
+/*
+ * close ring. left frames are closed.
+ * @param ring
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_FrameRing_close(ttLibC_FrameRing **ring) {
+	ttLibC_FrameRing_ *target = (ttLibC_FrameRing_ *)*ring;
+	if(target == NULL) {
+		return;
+	}
+	if(target->frames != NULL && target->read_fd >= 0) {
+		ttLibC_Frame *frame = NULL;
+		while((frame = ttLibC_FrameRing_pop((ttLibC_FrameRing *)target)) != NULL) {
+			ttLibC_Frame_close(&frame);
+		}
+	}
+	if(target->write_fd >= 0 && target->write_fd != target->read_fd) {
+		close(target->write_fd);
+	}
+	if(target->read_fd >= 0) {
+		close(target->read_fd);
+	}
+	if(target->space_write_fd >= 0 && target->space_write_fd != target->space_read_fd) {
+		close(target->space_write_fd);
+	}
+	if(target->space_read_fd >= 0) {
+		close(target->space_read_fd);
+	}
+	ttLibC_free(target->sequences);
+	ttLibC_free(target->frames);
+	ttLibC_free(target);
+	*ring = NULL;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file   frameRingUtil.h
+ * @brief  lock-free bounded queue of frame references between threads.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * frames are not cloned. pushed frame is owned by the consumer.
+ * (use ttLibC_FramePool_ref to keep sharing the frame)
+ * spsc: one producer thread and one consumer thread.
+ * mpsc: many producer threads (ex: mixing sources) and one consumer thread.
+ *
+ * usage:
+ *   ttLibC_FrameRing *ring = ttLibC_FrameRing_make(FrameRingType_spsc, 64);
+ *   // producer thread.
+ *   if(!ttLibC_FrameRing_push(ring, frame)) {
+ *     // full.
+ *   }
+ *   // consumer thread.
+ *   ttLibC_Frame *frame = ttLibC_FrameRing_popWait(ring, 100);
+ *
+ * producer can wait for free slot with ttLibC_FrameRing_pushWait, it wakes up on pop.
+ *
+ * for event loop, consumer waits on ttLibC_FrameRing_refFd with select / poll.
+ *   if(ttLibC_FrameRing_armWait(ring)) {
+ *     // ring is empty, add refFd to readable check of loop.
+ *   }
+ *   // fd is readable -> ttLibC_FrameRing_pop until NULL.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_UTIL_FRAMERINGUTIL_H_
+#define TTLIBC_UTIL_FRAMERINGUTIL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../frame/frame.h"
+
+/**
+ * producer model of ring.
+ */
+typedef enum ttLibC_FrameRing_Type {
+	/** single producer single consumer. */
+	FrameRingType_spsc,
+	/** multi producer single consumer. */
+	FrameRingType_mpsc,
+} ttLibC_FrameRing_Type;
+
+/**
+ * data for frameRing
+ */
+typedef struct ttLibC_Util_FrameRingUtil_FrameRing {
+	ttLibC_FrameRing_Type type;
+	/** max number of frames. (power of 2) */
+	uint32_t capacity;
+} ttLibC_Util_FrameRingUtil_FrameRing;
+
+typedef ttLibC_Util_FrameRingUtil_FrameRing ttLibC_FrameRing;
+
+/**
+ * make frame ring.
+ * @param type     spsc or mpsc
+ * @param capacity max number of frames. rounded up to power of 2.
+ * @return ring object.
+ */
+ttLibC_FrameRing *ttLibC_FrameRing_make(
+		ttLibC_FrameRing_Type type,
+		uint32_t capacity);
+
+/**
+ * push frame reference. (producer)
+ * @param ring  ring object.
+ * @param frame target frame. consumer owns it after success.
+ * @return true:success false:full or error
+ */
+bool ttLibC_FrameRing_push(
+		ttLibC_FrameRing *ring,
+		ttLibC_Frame *frame);
+
+/**
+ * push frame reference, wait for pop if full. (producer)
+ * @param ring         ring object.
+ * @param frame        target frame. consumer owns it after success.
+ * @param timeout_msec max wait time. -1 for infinite, 0 for no wait.
+ * @return true:success false:timeout or error
+ */
+bool ttLibC_FrameRing_pushWait(
+		ttLibC_FrameRing *ring,
+		ttLibC_Frame *frame,
+		int32_t timeout_msec);
+
+/**
+ * pop frame reference without wait. (consumer)
+ * @param ring ring object.
+ * @return frame. NULL for empty.
+ */
+ttLibC_Frame *ttLibC_FrameRing_pop(ttLibC_FrameRing *ring);
+
+/**
+ * pop frame reference, wait for push if empty. (consumer)
+ * @param ring         ring object.
+ * @param timeout_msec max wait time. -1 for infinite, 0 for no wait.
+ * @return frame. NULL for timeout.
+ */
+ttLibC_Frame *ttLibC_FrameRing_popWait(
+		ttLibC_FrameRing *ring,
+		int32_t timeout_msec);
+
+/**
+ * ref the fd, which will be readable on push after ttLibC_FrameRing_armWait.
+ * (eventfd on linux, pipe on other)
+ * @param ring ring object.
+ * @return fd. -1 for error.
+ */
+int ttLibC_FrameRing_refFd(ttLibC_FrameRing *ring);
+
+/**
+ * prepare wait on fd. (consumer)
+ * @param ring ring object.
+ * @return true:ring is empty, and next push makes fd readable. false:frame is ready to pop.
+ */
+bool ttLibC_FrameRing_armWait(ttLibC_FrameRing *ring);
+
+/**
+ * close ring. left frames are closed.
+ * @param ring
+ */
+void ttLibC_FrameRing_close(ttLibC_FrameRing **ring);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_UTIL_FRAMERINGUTIL_H_ */
@@ -0,0 +1,313 @@
+/*
+ * @file   httpStreamUtil.c
+ * @brief  read-ahead http source with range requests.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifdef __ENABLE_FILE__
+
+#include "httpStreamUtil.h"
+#include "httpUtil.h"
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+#include <pthread.h>
+#include <string.h>
+#include <sys/time.h>
+
+/**
+ * buffer for downloaded data.
+ */
+typedef struct {
+	uint8_t *data;
+	size_t size;
+	size_t buffer_size;
+} ttLibC_HttpStream_Buffer;
+
+typedef struct ttLibC_Util_HttpStreamUtil_HttpStream_ {
+	ttLibC_HttpStream inherit_super;
+	char address[256];
+	size_t min_chunk_size;
+	size_t max_chunk_size;
+	ttLibC_HttpClient *client;
+	/** ring of buffers. */
+	ttLibC_HttpStream_Buffer *buffers;
+	uint32_t buffer_num;
+	/** position of next read. */
+	uint32_t head;
+	/** number of filled buffers. */
+	uint32_t count;
+	/** total time for download in micro sec. */
+	uint64_t fetch_time;
+	bool is_waiting;
+	bool is_stop;
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+} ttLibC_Util_HttpStreamUtil_HttpStream_;
+
+typedef ttLibC_Util_HttpStreamUtil_HttpStream_ ttLibC_HttpStream_;
+
+/*
+ * callback from httpClient, copy data on target buffer.
+ */
+static bool HttpStream_fetchCallback(void *ptr, ttLibC_HttpClient *client, void *data, size_t data_size) {
+	ttLibC_HttpStream_Buffer *buffer = (ttLibC_HttpStream_Buffer *)ptr;
+	if(buffer->size + data_size > buffer->buffer_size) {
+		// server ignored range, stop download.
+		buffer->size += data_size;
+		return false;
+	}
+	memcpy(buffer->data + buffer->size, data, data_size);
+	buffer->size += data_size;
+	return true;
+}
+
+/*
+ * download thread.
+ */
+static void *HttpStream_fetchLoop(void *ptr) {
+	ttLibC_HttpStream_ *stream = (ttLibC_HttpStream_ *)ptr;
+	while(true) {
+		// wait for free buffer.
+		pthread_mutex_lock(&stream->mutex);
+		if(!stream->is_stop && stream->count == stream->buffer_num) {
+			++ stream->inherit_super.fetch_stall_count;
+			while(!stream->is_stop && stream->count == stream->buffer_num) {
+				pthread_cond_wait(&stream->cond, &stream->mutex);
+			}
+		}
+		if(stream->is_stop) {
+			pthread_mutex_unlock(&stream->mutex);
+			break;
+		}
+		// read waited for download, make request size bigger.
+		if(stream->is_waiting) {
+			stream->is_waiting = false;
+			if(stream->inherit_super.chunk_size < stream->max_chunk_size) {
+				stream->inherit_super.chunk_size *= 2;
+				if(stream->inherit_super.chunk_size > stream->max_chunk_size) {
+					stream->inherit_super.chunk_size = stream->max_chunk_size;
+				}
+			}
+		}
+		ttLibC_HttpStream_Buffer *buffer = &stream->buffers[(stream->head + stream->count) % stream->buffer_num];
+		size_t request_size = stream->inherit_super.chunk_size;
+		size_t position = stream->inherit_super.fetch_position;
+		pthread_mutex_unlock(&stream->mutex);
+
+		// the buffer out of count is owned by this thread.
+		buffer->size = 0;
+		struct timeval begin, end;
+		gettimeofday(&begin, NULL);
+		// status of previous request should not be left on failure before status line.
+		stream->client->status_code = 0;
+		bool is_success = ttLibC_HttpClient_getRanges(stream->client, stream->address, &position, &request_size, 1, true, HttpStream_fetchCallback, buffer);
+		gettimeofday(&end, NULL);
+		ttLibC_HttpClient *client = stream->client;
+		bool is_eof = false;
+		bool is_error = false;
+		if(!is_success) {
+			// connect failure, or connection is closed on header or body.
+			ERR_PRINT("failed to download. position:%zu", position);
+			is_error = true;
+		}
+		else if(client->status_code == 416) {
+			// range is out of file.
+			is_eof = true;
+			buffer->size = 0;
+		}
+		else if(client->status_code == 200 && position != 0) {
+			ERR_PRINT("server does not support range request.");
+			is_error = true;
+		}
+		else if(client->status_code < 200 || client->status_code >= 300) {
+			ERR_PRINT("failed to download. status:%d", client->status_code);
+			is_error = true;
+		}
+		else if(buffer->size > request_size) {
+			ERR_PRINT("got more data than requested.");
+			is_error = true;
+		}
+		else if(buffer->size < client->content_length
+		|| (buffer->size < request_size && client->file_length != 0 && position + buffer->size < client->file_length)) {
+			// Content-Length or Content-Range says more data.
+			ERR_PRINT("body is shorter than expected. size:%zu", buffer->size);
+			is_error = true;
+		}
+		else if(buffer->size < request_size
+		|| (client->file_length != 0 && position + buffer->size >= client->file_length)) {
+			is_eof = true;
+		}
+
+		pthread_mutex_lock(&stream->mutex);
+		++ stream->inherit_super.request_count;
+		stream->inherit_super.file_length = client->file_length;
+		if(!is_error) {
+			stream->fetch_time += (end.tv_sec - begin.tv_sec) * 1000000 + (end.tv_usec - begin.tv_usec);
+			stream->inherit_super.fetch_position += buffer->size;
+			if(stream->fetch_time > 0) {
+				stream->inherit_super.throughput = (double)stream->inherit_super.fetch_position * 1000000 / stream->fetch_time;
+			}
+			if(buffer->size > 0) {
+				++ stream->count;
+			}
+		}
+		stream->inherit_super.is_eof = is_eof;
+		stream->inherit_super.is_error = is_error;
+		pthread_cond_broadcast(&stream->cond);
+		pthread_mutex_unlock(&stream->mutex);
+		if(is_eof || is_error) {
+			break;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * make http stream, and start download on background thread.
+ * @param target_address address for download.
+ * @param min_chunk_size first request size.
+ * @param max_chunk_size max request size. this is the size of each buffer.
+ * @param buffer_num     number of buffers for read-ahead.
+ * @return http stream object.
+ */
+ttLibC_HttpStream TT_VISIBILITY_DEFAULT *ttLibC_HttpStream_make(
+		const char *target_address,
+		size_t min_chunk_size,
+		size_t max_chunk_size,
+		uint32_t buffer_num) {
+	if(target_address == NULL || strlen(target_address) > 255) {
+		ERR_PRINT("target address is invalid.");
+		return NULL;
+	}
+	if(min_chunk_size == 0 || max_chunk_size < min_chunk_size || buffer_num == 0) {
+		ERR_PRINT("invalid chunk size or buffer num.");
+		return NULL;
+	}
+	ttLibC_HttpStream_ *stream = ttLibC_malloc(sizeof(ttLibC_HttpStream_));
+	if(stream == NULL) {
+		ERR_PRINT("failed to allocate memory for stream.");
+		return NULL;
+	}
+	memset(stream, 0, sizeof(ttLibC_HttpStream_));
+	strcpy(stream->address, target_address);
+	stream->min_chunk_size = min_chunk_size;
+	stream->max_chunk_size = max_chunk_size;
+	stream->inherit_super.chunk_size = min_chunk_size;
+	stream->buffer_num = buffer_num;
+	stream->client = ttLibC_HttpClient_make(65536, 0);
+	stream->buffers = ttLibC_malloc(sizeof(ttLibC_HttpStream_Buffer) * buffer_num);
+	if(stream->client == NULL || stream->buffers == NULL) {
+		ERR_PRINT("failed to allocate memory.");
+		ttLibC_HttpClient_close(&stream->client);
+		ttLibC_free(stream->buffers);
+		ttLibC_free(stream);
+		return NULL;
+	}
+	memset(stream->buffers, 0, sizeof(ttLibC_HttpStream_Buffer) * buffer_num);
+	ttLibC_HttpClient_setKeepAlive(stream->client, 1);
+	bool result = true;
+	for(uint32_t i = 0;i < buffer_num;++ i) {
+		stream->buffers[i].data = ttLibC_malloc(max_chunk_size);
+		stream->buffers[i].buffer_size = max_chunk_size;
+		if(stream->buffers[i].data == NULL) {
+			result = false;
+		}
+	}
+	if(result) {
+		pthread_mutex_init(&stream->mutex, NULL);
+		pthread_cond_init(&stream->cond, NULL);
+		if(pthread_create(&stream->thread, NULL, HttpStream_fetchLoop, stream) != 0) {
+			pthread_cond_destroy(&stream->cond);
+			pthread_mutex_destroy(&stream->mutex);
+			result = false;
+		}
+	}
+	if(!result) {
+		ERR_PRINT("failed to initialize stream.");
+		for(uint32_t i = 0;i < buffer_num;++ i) {
+			ttLibC_free(stream->buffers[i].data);
+		}
+		ttLibC_free(stream->buffers);
+		ttLibC_HttpClient_close(&stream->client);
+		ttLibC_free(stream);
+		return NULL;
+	}
+	return (ttLibC_HttpStream *)stream;
+}
+
+/*
+ * read next buffer. block until download is done.
+ * @param stream   http stream object.
+ * @param callback callback for data.
+ * @param ptr      user def pointer object.
+ * @return true:data is given false:eof, error or stopped by callback.
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_HttpStream_read(
+		ttLibC_HttpStream *stream,
+		ttLibC_HttpStreamFunc callback,
+		void *ptr) {
+	ttLibC_HttpStream_ *stream_ = (ttLibC_HttpStream_ *)stream;
+	if(stream_ == NULL) {
+		return false;
+	}
+	pthread_mutex_lock(&stream_->mutex);
+	if(stream_->count == 0 && !stream->is_eof && !stream->is_error) {
+		++ stream->read_stall_count;
+		stream_->is_waiting = true;
+		while(stream_->count == 0 && !stream->is_eof && !stream->is_error) {
+			pthread_cond_wait(&stream_->cond, &stream_->mutex);
+		}
+	}
+	if(stream_->count == 0) {
+		pthread_mutex_unlock(&stream_->mutex);
+		return false;
+	}
+	ttLibC_HttpStream_Buffer *buffer = &stream_->buffers[stream_->head];
+	pthread_mutex_unlock(&stream_->mutex);
+	// the head buffer is not touched by download thread, until count is decreased.
+	bool result = true;
+	if(callback != NULL) {
+		result = callback(ptr, buffer->data, buffer->size);
+	}
+	pthread_mutex_lock(&stream_->mutex);
+	stream->read_position += buffer->size;
+	stream_->head = (stream_->head + 1) % stream_->buffer_num;
+	-- stream_->count;
+	pthread_cond_broadcast(&stream_->cond);
+	pthread_mutex_unlock(&stream_->mutex);
+	return result;
+}
+
+/*
+ * close http stream
+ * @param stream
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_HttpStream_close(ttLibC_HttpStream **stream) {
+	ttLibC_HttpStream_ *target = (ttLibC_HttpStream_ *)*stream;
+	if(target == NULL) {
+		return;
+	}
+	// current request is done before thread end.
+	pthread_mutex_lock(&target->mutex);
+	target->is_stop = true;
+	pthread_cond_broadcast(&target->cond);
+	pthread_mutex_unlock(&target->mutex);
+	pthread_join(target->thread, NULL);
+	pthread_cond_destroy(&target->cond);
+	pthread_mutex_destroy(&target->mutex);
+	for(uint32_t i = 0;i < target->buffer_num;++ i) {
+		ttLibC_free(target->buffers[i].data);
+	}
+	ttLibC_free(target->buffers);
+	ttLibC_HttpClient_close(&target->client);
+	ttLibC_free(target);
+	*stream = NULL;
+}
+
+#endif
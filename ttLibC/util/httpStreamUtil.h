@@ -0,0 +1,103 @@
+/**
+ * @file   httpStreamUtil.h
+ * @brief  read-ahead http source with range requests.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * usage:
+ *   ttLibC_HttpStream *stream = ttLibC_HttpStream_make("http://localhost/test.mp4", 65536, 1048576, 4);
+ *   while(ttLibC_HttpStream_read(stream, readCallback, reader)) {
+ *     // readCallback calls ttLibC_ContainerReader_read with data.
+ *   }
+ *   ttLibC_HttpStream_close(&stream);
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_UTIL_HTTPSTREAMUTIL_H_
+#define TTLIBC_UTIL_HTTPSTREAMUTIL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * data for httpStream
+ */
+typedef struct ttLibC_Util_HttpStreamUtil_HttpStream {
+	/** size of target file. 0 until the first response. */
+	size_t file_length;
+	/** size of data given to read callback. */
+	size_t read_position;
+	/** size of data downloaded. */
+	size_t fetch_position;
+	/** number of range requests. */
+	uint64_t request_count;
+	/** number of read which waited for download. */
+	uint64_t read_stall_count;
+	/** number of download which waited for free buffer. */
+	uint64_t fetch_stall_count;
+	/** download speed in byte/sec. */
+	double throughput;
+	/** current request size. */
+	size_t chunk_size;
+	/** true:all data is downloaded. */
+	bool is_eof;
+	/** true:download failed. */
+	bool is_error;
+} ttLibC_Util_HttpStreamUtil_HttpStream;
+
+typedef ttLibC_Util_HttpStreamUtil_HttpStream ttLibC_HttpStream;
+
+/**
+ * callback for read data.
+ * @param ptr       user def pointer object.
+ * @param data      downloaded data. valid only in callback.
+ * @param data_size size of data.
+ * @return true:continue false:stop
+ */
+typedef bool (* ttLibC_HttpStreamFunc)(void *ptr, void *data, size_t data_size);
+
+/**
+ * make http stream, and start download on background thread.
+ * request size starts with min_chunk_size, and doubles up to max_chunk_size while read waits for download.
+ * @param target_address address for download.
+ * @param min_chunk_size first request size.
+ * @param max_chunk_size max request size. this is the size of each buffer.
+ * @param buffer_num     number of buffers for read-ahead.
+ * @return http stream object.
+ */
+ttLibC_HttpStream *ttLibC_HttpStream_make(
+		const char *target_address,
+		size_t min_chunk_size,
+		size_t max_chunk_size,
+		uint32_t buffer_num);
+
+/**
+ * read next buffer. block until download is done.
+ * @param stream   http stream object.
+ * @param callback callback for data.
+ * @param ptr      user def pointer object.
+ * @return true:data is given false:eof, error or stopped by callback.
+ */
+bool ttLibC_HttpStream_read(
+		ttLibC_HttpStream *stream,
+		ttLibC_HttpStreamFunc callback,
+		void *ptr);
+
+/**
+ * close http stream
+ * @param stream
+ */
+void ttLibC_HttpStream_close(ttLibC_HttpStream **stream);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_UTIL_HTTPSTREAMUTIL_H_ */
@@ -24,12 +24,31 @@
 #include <sys/time.h>
 #include <unistd.h>
 #include <stdbool.h>
+#include <strings.h>
+#include <netinet/tcp.h>
 
 #include "../ttLibC_predef.h"
 #include "../_log.h"
 #include "../allocator.h"
 
 #define BUF_LEN 256
+#define READ_BUF_LEN 4096
+
+/**
+ * connection for keep-alive.
+ */
+typedef struct {
+	char host[BUF_LEN];
+	uint16_t port;
+	int32_t sock;
+	/** received size after taken from pool, for stale check. */
+	size_t received_size;
+	size_t read_pos;
+	size_t read_size;
+	uint8_t read_buffer[READ_BUF_LEN];
+} ttLibC_Util_HttpUtil_HttpConnection;
+
+typedef ttLibC_Util_HttpUtil_HttpConnection ttLibC_HttpConnection;
 
 /**
  * detail data for httpClient
@@ -37,6 +56,10 @@
 typedef struct {
 	ttLibC_HttpClient inherit_super;
 	uint8_t *buffer;
+	/** idle connections, last one is the most recent. */
+	ttLibC_HttpConnection **connections;
+	uint32_t connection_num;
+	uint32_t max_connection_num;
 } ttLibC_Util_HttpUtil_HttpClient_;
 
 typedef ttLibC_Util_HttpUtil_HttpClient_ ttLibC_HttpClient_;
@@ -66,6 +89,13 @@ ttLibC_HttpClient TT_VISIBILITY_DEFAULT *ttLibC_HttpClient_make(
 	client->inherit_super.content_length = 0;
 	client->inherit_super.file_length = 0;
 	client->inherit_super.wait_interval = wait_interval;
+	client->inherit_super.status_code = 0;
+	client->inherit_super.is_keep_alive = false;
+	client->inherit_super.range_index = 0;
+	client->inherit_super.reuse_count = 0;
+	client->connections = NULL;
+	client->connection_num = 0;
+	client->max_connection_num = 0;
 	return (ttLibC_HttpClient *)client;
 }
 
@@ -86,6 +116,601 @@ void TT_VISIBILITY_DEFAULT ttLibC_HttpClient_get(
 	ttLibC_HttpClient_getRange(client, target_address, 0, 0, is_binary, callback, ptr);
 }
 
+/*
+ * analyze http address.
+ * @param target_address address
+ * @param host           buffer for host name. (BUF_LEN)
+ * @param port           ref for port number.
+ * @param path           buffer for path. (BUF_LEN)
+ * @return true:success false:error
+ */
+static bool HttpClient_parseAddress(
+		const char *target_address,
+		char *host,
+		uint16_t *port,
+		char *path) {
+	char host_path[BUF_LEN];
+	if(strlen(target_address) > BUF_LEN - 1) {
+		ERR_PRINT("target address is too long.");
+		return false;
+	}
+	if(strstr(target_address, "http://")
+	&& sscanf(target_address, "http://%s", host_path)
+	&& strcmp(target_address, "http://")) {
+		char *p;
+
+		p = strchr(host_path, '/');
+		if(p != NULL) {
+			strcpy(path, p);
+			*p = '\0';
+			strcpy(host, host_path);
+		}
+		else {
+			strcpy(path, "/");
+			strcpy(host, host_path);
+		}
+
+		*port = 80;
+		p = strchr(host, ':');
+		if(p != NULL) {
+			int num = atoi(p + 1);
+			if(num > 0 && num < 0x10000) {
+				*port = (uint16_t)num;
+			}
+			*p = '\0';
+		}
+		return true;
+	}
+	ERR_PRINT("target_address (url) is invalid. %s", target_address);
+	return false;
+}
+
+/*
+ * check header value has token, ignore case.
+ */
+static bool HttpClient_hasToken(const char *value, const char *token) {
+	size_t length = strlen(token);
+	for(const char *p = value;*p != '\0';++ p) {
+		if(strncasecmp(p, token, length) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * sleep for wait_interval.
+ */
+static void HttpClient_wait(ttLibC_HttpClient *client) {
+	if(client->wait_interval != 0) {
+		struct timespec ts;
+		ts.tv_sec = (client->wait_interval / 1000);
+		ts.tv_nsec = (client->wait_interval % 1000) * 1000000;
+		nanosleep(&ts, NULL);
+	}
+}
+
+/*
+ * open new connection.
+ * @param host
+ * @param port
+ * @return connection object.
+ */
+static ttLibC_HttpConnection *HttpConnection_make(const char *host, uint16_t port) {
+	struct hostent *servhost = gethostbyname(host);
+	if(servhost == NULL) {
+		ERR_PRINT("failed to get ip address from [%s]", host);
+		return NULL;
+	}
+	struct sockaddr_in server;
+	memset(&server, 0, sizeof(server));
+	memcpy(&server.sin_addr, servhost->h_addr_list[0], servhost->h_length);
+	server.sin_family = AF_INET;
+	server.sin_port = htons(port);
+	int32_t sock = socket(AF_INET, SOCK_STREAM, 0);
+	if(sock < 0) {
+		ERR_PRINT("fail to make socket.");
+		return NULL;
+	}
+	if(connect(sock, (struct sockaddr *)&server, sizeof(server)) == -1) {
+		ERR_PRINT("failed to connect.");
+		close(sock);
+		return NULL;
+	}
+	// requests are small and pipelined, don't wait for ack.
+	int flag = 1;
+	setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+#ifdef SO_NOSIGPIPE
+	setsockopt(sock, SOL_SOCKET, SO_NOSIGPIPE, &flag, sizeof(flag));
+#endif
+	ttLibC_HttpConnection *conn = ttLibC_malloc(sizeof(ttLibC_HttpConnection));
+	if(conn == NULL) {
+		ERR_PRINT("failed to allocate connection.");
+		close(sock);
+		return NULL;
+	}
+	strcpy(conn->host, host);
+	conn->port = port;
+	conn->sock = sock;
+	conn->received_size = 0;
+	conn->read_pos = 0;
+	conn->read_size = 0;
+	return conn;
+}
+
+static void HttpConnection_close(ttLibC_HttpConnection **conn) {
+	ttLibC_HttpConnection *target = *conn;
+	if(target == NULL) {
+		return;
+	}
+	close(target->sock);
+	ttLibC_free(target);
+	*conn = NULL;
+}
+
+/*
+ * write all data on connection.
+ */
+static bool HttpConnection_write(ttLibC_HttpConnection *conn, const void *data, size_t data_size) {
+	const uint8_t *buf = data;
+	int flags = 0;
+#ifdef MSG_NOSIGNAL
+	flags = MSG_NOSIGNAL;
+#endif
+	while(data_size > 0) {
+		ssize_t size = send(conn->sock, buf, data_size, flags);
+		if(size <= 0) {
+			return false;
+		}
+		buf += size;
+		data_size -= size;
+	}
+	return true;
+}
+
+/*
+ * fill read buffer, if empty.
+ * @return false:connection closed or error.
+ */
+static bool HttpConnection_fill(ttLibC_HttpConnection *conn) {
+	if(conn->read_pos < conn->read_size) {
+		return true;
+	}
+	ssize_t size = recv(conn->sock, conn->read_buffer, READ_BUF_LEN, 0);
+	if(size <= 0) {
+		return false;
+	}
+	conn->read_pos = 0;
+	conn->read_size = size;
+	conn->received_size += size;
+	return true;
+}
+
+/*
+ * read one line, without crlf.
+ * too long line is truncated.
+ * @return true:success false:error
+ */
+static bool HttpConnection_readLine(ttLibC_HttpConnection *conn, char *line, size_t line_size) {
+	size_t pos = 0;
+	while(true) {
+		if(!HttpConnection_fill(conn)) {
+			return false;
+		}
+		char ch = (char)conn->read_buffer[conn->read_pos ++];
+		if(ch == '\n') {
+			break;
+		}
+		if(ch != '\r' && pos < line_size - 1) {
+			line[pos ++] = ch;
+		}
+	}
+	line[pos] = '\0';
+	return true;
+}
+
+/*
+ * read body and give to callback.
+ * @param client_      client object
+ * @param conn         connection object
+ * @param size         size to read. SIZE_MAX for until closed.
+ * @param is_deliver   false:discard body.
+ * @param is_binary    false:give null terminated string.
+ * @param callback     callback for body.
+ * @param ptr          user def pointer.
+ * @param is_stopped   ref for stop request from callback.
+ * @return true:success false:error
+ */
+static bool HttpClient_readBody(
+		ttLibC_HttpClient_ *client_,
+		ttLibC_HttpConnection *conn,
+		size_t size,
+		bool is_deliver,
+		bool is_binary,
+		ttLibC_HttpClientFunc callback,
+		void *ptr,
+		bool *is_stopped) {
+	while(size > 0) {
+		if(!HttpConnection_fill(conn)) {
+			return size == SIZE_MAX;
+		}
+		size_t read_size = conn->read_size - conn->read_pos;
+		if(read_size > size) {
+			read_size = size;
+		}
+		size_t limit = is_binary ? client_->inherit_super.buffer_size : client_->inherit_super.buffer_size - 1;
+		if(read_size > limit) {
+			read_size = limit;
+		}
+		uint8_t *data = conn->read_buffer + conn->read_pos;
+		conn->read_pos += read_size;
+		if(size != SIZE_MAX) {
+			size -= read_size;
+		}
+		if(!is_deliver || *is_stopped || callback == NULL) {
+			continue;
+		}
+		if(!is_binary) {
+			memcpy(client_->buffer, data, read_size);
+			client_->buffer[read_size] = 0x00;
+			data = client_->buffer;
+		}
+		if(!callback(ptr, (ttLibC_HttpClient *)client_, data, read_size)) {
+			*is_stopped = true;
+			return true;
+		}
+		HttpClient_wait((ttLibC_HttpClient *)client_);
+	}
+	return true;
+}
+
+/*
+ * read one response.
+ * @param client_    client object
+ * @param conn       connection object
+ * @param is_binary  true:binary false:string
+ * @param callback   callback for body.
+ * @param ptr        user def pointer.
+ * @param can_reuse  ref for keep-alive state of connection.
+ * @param is_stopped ref for stop request from callback.
+ * @return true:success false:error
+ */
+static bool HttpClient_readResponse(
+		ttLibC_HttpClient_ *client_,
+		ttLibC_HttpConnection *conn,
+		bool is_binary,
+		ttLibC_HttpClientFunc callback,
+		void *ptr,
+		bool *can_reuse,
+		bool *is_stopped) {
+	ttLibC_HttpClient *client = (ttLibC_HttpClient *)client_;
+	char line[READ_BUF_LEN];
+	int major = 0, minor = 0;
+	bool is_chunked = false;
+	bool has_length = false;
+	bool is_keep_alive = false;
+	do {
+		// status line, skip 1xx informational response.
+		if(!HttpConnection_readLine(conn, line, sizeof(line))) {
+			return false;
+		}
+		client->status_code = 0;
+		if(sscanf(line, "HTTP/%d.%d %u", &major, &minor, &client->status_code) != 3) {
+			ERR_PRINT("invalid status line:%s", line);
+			return false;
+		}
+		sprintf(client->ETag, "");
+		client->content_length = 0;
+		client->file_length = 0;
+		is_chunked = false;
+		has_length = false;
+		is_keep_alive = (major == 1 && minor >= 1);
+		while(true) {
+			if(!HttpConnection_readLine(conn, line, sizeof(line))) {
+				return false;
+			}
+			if(line[0] == '\0') {
+				break;
+			}
+			char *value = strchr(line, ':');
+			if(value == NULL) {
+				continue;
+			}
+			*value = '\0';
+			++ value;
+			while(*value == ' ' || *value == '\t') {
+				++ value;
+			}
+			if(strcasecmp(line, "Content-Length") == 0) {
+				client->content_length = strtoull(value, NULL, 10);
+				has_length = true;
+				if(client->file_length == 0) {
+					client->file_length = client->content_length;
+				}
+			}
+			else if(strcasecmp(line, "Content-Range") == 0) {
+				char *p = strchr(value, '/');
+				if(p != NULL && *(p + 1) != '*') {
+					client->file_length = strtoull(p + 1, NULL, 10);
+				}
+			}
+			else if(strcasecmp(line, "Transfer-Encoding") == 0) {
+				is_chunked = (HttpClient_hasToken(value, "chunked"));
+			}
+			else if(strcasecmp(line, "Connection") == 0) {
+				if(HttpClient_hasToken(value, "close")) {
+					is_keep_alive = false;
+				}
+				else if(HttpClient_hasToken(value, "keep-alive")) {
+					is_keep_alive = true;
+				}
+			}
+			else if(strcasecmp(line, "ETag") == 0) {
+				char *p = value;
+				if(*p == '"') {
+					++ p;
+				}
+				strncpy(client->ETag, p, sizeof(client->ETag) - 1);
+				client->ETag[sizeof(client->ETag) - 1] = 0x00;
+				size_t length = strlen(client->ETag);
+				if(length > 0 && client->ETag[length - 1] == '"') {
+					client->ETag[length - 1] = 0x00;
+				}
+			}
+		}
+	} while(client->status_code >= 100 && client->status_code < 200);
+	// body for error status is read and discarded, to keep connection usable.
+	bool is_deliver = (client->status_code >= 200 && client->status_code < 300);
+	if(is_chunked) {
+		while(true) {
+			if(!HttpConnection_readLine(conn, line, sizeof(line))) {
+				return false;
+			}
+			size_t chunk_size = strtoull(line, NULL, 16);
+			if(chunk_size == 0) {
+				// skip trailer.
+				do {
+					if(!HttpConnection_readLine(conn, line, sizeof(line))) {
+						return false;
+					}
+				} while(line[0] != '\0');
+				break;
+			}
+			if(!HttpClient_readBody(client_, conn, chunk_size, is_deliver, is_binary, callback, ptr, is_stopped)) {
+				return false;
+			}
+			if(*is_stopped) {
+				// rest of body is not read, connection is dropped by caller.
+				*can_reuse = false;
+				return true;
+			}
+			// crlf after chunk data.
+			if(!HttpConnection_readLine(conn, line, sizeof(line))) {
+				return false;
+			}
+		}
+	}
+	else if(has_length) {
+		if(!HttpClient_readBody(client_, conn, client->content_length, is_deliver, is_binary, callback, ptr, is_stopped)) {
+			return false;
+		}
+		if(*is_stopped) {
+			*can_reuse = false;
+			return true;
+		}
+	}
+	else {
+		// body is until connection close.
+		is_keep_alive = false;
+		if(!HttpClient_readBody(client_, conn, SIZE_MAX, is_deliver, is_binary, callback, ptr, is_stopped)) {
+			return false;
+		}
+	}
+	*can_reuse = is_keep_alive && !*is_stopped;
+	return true;
+}
+
+/*
+ * take idle connection for host, or make new one.
+ * @param client_   client object
+ * @param host      host name
+ * @param port      port number
+ * @param is_reused ref for reuse state.
+ * @return connection object
+ */
+static ttLibC_HttpConnection *HttpClient_takeConnection(
+		ttLibC_HttpClient_ *client_,
+		const char *host,
+		uint16_t port,
+		bool *is_reused) {
+	for(int i = (int)client_->connection_num - 1;i >= 0;-- i) {
+		ttLibC_HttpConnection *conn = client_->connections[i];
+		if(conn->port != port || strcmp(conn->host, host) != 0) {
+			continue;
+		}
+		-- client_->connection_num;
+		memmove(&client_->connections[i], &client_->connections[i + 1], sizeof(ttLibC_HttpConnection *) * (client_->connection_num - i));
+		conn->received_size = 0;
+		*is_reused = true;
+		return conn;
+	}
+	*is_reused = false;
+	return HttpConnection_make(host, port);
+}
+
+/*
+ * put connection back to pool.
+ * the oldest one is closed, if pool is full.
+ */
+static void HttpClient_giveBackConnection(
+		ttLibC_HttpClient_ *client_,
+		ttLibC_HttpConnection *conn) {
+	if(client_->max_connection_num == 0) {
+		HttpConnection_close(&conn);
+		return;
+	}
+	if(client_->connection_num == client_->max_connection_num) {
+		HttpConnection_close(&client_->connections[0]);
+		-- client_->connection_num;
+		memmove(&client_->connections[0], &client_->connections[1], sizeof(ttLibC_HttpConnection *) * client_->connection_num);
+	}
+	client_->connections[client_->connection_num ++] = conn;
+}
+
+/*
+ * write get request.
+ */
+static bool HttpClient_writeRequest(
+		ttLibC_HttpConnection *conn,
+		const char *path,
+		size_t range_start,
+		size_t range_length,
+		bool is_close) {
+	char buf[BUF_LEN * 3];
+	int size = snprintf(buf, sizeof(buf),
+			"GET %s HTTP/1.1\r\nHost: %s:%d\r\nConnection: %s\r\n",
+			path, conn->host, conn->port, is_close ? "close" : "keep-alive");
+	if(range_start != 0) {
+		if(range_length != 0) {
+			size += snprintf(buf + size, sizeof(buf) - size, "Range: bytes=%zu-%zu\r\n", range_start, range_start + range_length - 1);
+		}
+		else {
+			size += snprintf(buf + size, sizeof(buf) - size, "Range: bytes=%zu-\r\n", range_start);
+		}
+	}
+	else if(range_length != 0) {
+		size += snprintf(buf + size, sizeof(buf) - size, "Range: bytes=0-%zu\r\n", range_length - 1);
+	}
+	size += snprintf(buf + size, sizeof(buf) - size, "\r\n");
+	return HttpConnection_write(conn, buf, size);
+}
+
+/*
+ * enable keep-alive connection pool.
+ * @param client              http client object
+ * @param max_connection_num  max number of idle connections to hold. 0 for disable and close all.
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_HttpClient_setKeepAlive(
+		ttLibC_HttpClient *client,
+		uint32_t max_connection_num) {
+	ttLibC_HttpClient_ *client_ = (ttLibC_HttpClient_ *)client;
+	if(client_ == NULL) {
+		return;
+	}
+	// close all idle connections, then remake table.
+	for(uint32_t i = 0;i < client_->connection_num;++ i) {
+		HttpConnection_close(&client_->connections[i]);
+	}
+	client_->connection_num = 0;
+	if(client_->connections != NULL) {
+		ttLibC_free(client_->connections);
+		client_->connections = NULL;
+	}
+	client_->max_connection_num = 0;
+	client->is_keep_alive = false;
+	if(max_connection_num == 0) {
+		return;
+	}
+	client_->connections = ttLibC_malloc(sizeof(ttLibC_HttpConnection *) * max_connection_num);
+	if(client_->connections == NULL) {
+		ERR_PRINT("failed to allocate connection table.");
+		return;
+	}
+	client_->max_connection_num = max_connection_num;
+	client->is_keep_alive = true;
+}
+
+/*
+ * get method download for multiple ranges.
+ * @param client         http client object
+ * @param target_address address for download.
+ * @param range_starts   begin points for download.
+ * @param range_lengths  download sizes for download. 0 for until the end.
+ * @param range_num      number of ranges.
+ * @param is_binary      true:read as binary false:read as string
+ * @param callback       callback for download data.
+ * @param ptr            user def data pointer.
+ * @return true:success false:error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_HttpClient_getRanges(
+		ttLibC_HttpClient *client,
+		const char *target_address,
+		const size_t *range_starts,
+		const size_t *range_lengths,
+		uint32_t range_num,
+		bool is_binary,
+		ttLibC_HttpClientFunc callback,
+		void *ptr) {
+	ttLibC_HttpClient_ *client_ = (ttLibC_HttpClient_ *)client;
+	if(client_ == NULL || range_starts == NULL || range_lengths == NULL) {
+		return false;
+	}
+	if(target_address == NULL || strlen(target_address) == 0) {
+		return false;
+	}
+	char host[BUF_LEN];
+	char path[BUF_LEN];
+	uint16_t port = 80;
+	if(!HttpClient_parseAddress(target_address, host, &port, path)) {
+		return false;
+	}
+	uint32_t index = 0;
+	bool is_retried = false;
+	while(index < range_num) {
+		bool is_reused = false;
+		ttLibC_HttpConnection *conn = HttpClient_takeConnection(client_, host, port, &is_reused);
+		if(conn == NULL) {
+			return false;
+		}
+		if(is_reused) {
+			++ client->reuse_count;
+		}
+		// pipeline all remaining requests.
+		bool result = true;
+		for(uint32_t i = index;i < range_num && result;++ i) {
+			result = HttpClient_writeRequest(conn, path, range_starts[i], range_lengths[i], !client->is_keep_alive && i == range_num - 1);
+		}
+		bool can_reuse = false;
+		bool is_stopped = false;
+		while(result && index < range_num) {
+			client->range_index = index;
+			can_reuse = false;
+			result = HttpClient_readResponse(client_, conn, is_binary, callback, ptr, &can_reuse, &is_stopped);
+			if(!result) {
+				break;
+			}
+			++ index;
+			if(is_stopped) {
+				HttpConnection_close(&conn);
+				return true;
+			}
+			if(!can_reuse) {
+				// rest of pipelined requests are lost, make new connection.
+				break;
+			}
+		}
+		if(!result) {
+			bool is_stale = is_reused && conn->received_size == 0;
+			HttpConnection_close(&conn);
+			if(is_stale && !is_retried) {
+				// server closed idle connection, try again with new one.
+				is_retried = true;
+				-- client->reuse_count;
+				continue;
+			}
+			ERR_PRINT("failed to get response.");
+			return false;
+		}
+		if(can_reuse && client->is_keep_alive) {
+			HttpClient_giveBackConnection(client_, conn);
+		}
+		else {
+			HttpConnection_close(&conn);
+		}
+	}
+	return true;
+}
+
 /*
  * get method download.
  * @param client         http client object
@@ -119,38 +744,11 @@ void TT_VISIBILITY_DEFAULT ttLibC_HttpClient_getRange(
 	char host[BUF_LEN];
 	char path[BUF_LEN];
 	uint16_t port = 80;
-	char host_path[BUF_LEN];
-	// analyze http address.
-	if(strlen(target_address) > BUF_LEN - 1) {
-		ERR_PRINT("target address is too long.");
+	if(!HttpClient_parseAddress(target_address, host, &port, path)) {
 		return;
 	}
-	if(strstr(target_address, "http://")
-	&& sscanf(target_address, "http://%s", host_path)
-	&& strcmp(target_address, "http://")) {
-		char *p;
-
-		p = strchr(host_path, '/');
-		if(p != NULL) {
-			strcpy(path, p);
-			*p = '\0';
-			strcpy(host, host_path);
-		}
-		else {
-			strcpy(host, host_path);
-		}
-
-		p = strchr(host, ':');
-		if(p != NULL) {
-			port = atoi(p + 1);
-			if(port <= 0) {
-				port = 80;
-			}
-			*p = '\0';
-		}
-	}
-	else {
-		ERR_PRINT("target_address (url) is invalid. %s", target_address);
+	if(client->is_keep_alive) {
+		ttLibC_HttpClient_getRanges(client, target_address, &range_start, &range_length, 1, is_binary, callback, ptr);
 		return;
 	}
 
@@ -275,6 +873,7 @@ void TT_VISIBILITY_DEFAULT ttLibC_HttpClient_close(ttLibC_HttpClient **client) {
 	if(target == NULL) {
 		return;
 	}
+	ttLibC_HttpClient_setKeepAlive(*client, 0);
 	if(target->buffer) {
 		ttLibC_free(target->buffer);
 		target->buffer = NULL;
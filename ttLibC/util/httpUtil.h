@@ -35,6 +35,12 @@ typedef struct ttLibC_Util_HttpUtil_HttpClient {
 	size_t buffer_size;
 	/** reply status code */
 	uint32_t status_code;
+	/** true:hold connection for reuse (HTTP/1.1 keep-alive). */
+	bool is_keep_alive;
+	/** index of range for current callback. (for getRanges) */
+	uint32_t range_index;
+	/** number of request on reused connection. */
+	uint64_t reuse_count;
 } ttLibC_Util_HttpUtil_HttpClient;
 
 typedef ttLibC_Util_HttpUtil_HttpClient ttLibC_HttpClient;
@@ -92,6 +98,43 @@ void ttLibC_HttpClient_getRange(
 		ttLibC_HttpClientFunc callback,
 		void *ptr);
 
+/**
+ * enable keep-alive connection pool.
+ * requests are sent as HTTP/1.1, and connection is held for the next request to the same host.
+ * chunked transfer encoding is supported.
+ * if callback returns false in the middle of body, rest of body is not read and the connection is dropped.
+ * note: the client is blocking. non-blocking use on tetty2 event loop is out of scope.
+ * @param client              http client object
+ * @param max_connection_num  max number of idle connections to hold. 0 for disable and close all.
+ */
+void ttLibC_HttpClient_setKeepAlive(
+		ttLibC_HttpClient *client,
+		uint32_t max_connection_num);
+
+/**
+ * get method download for multiple ranges.
+ * all requests are pipelined on one connection, and responses are given in order.
+ * client->range_index tells the index of range on callback.
+ * @param client         http client object
+ * @param target_address address for download.
+ * @param range_starts   begin points for download.
+ * @param range_lengths  download sizes for download. 0 for until the end.
+ * @param range_num      number of ranges.
+ * @param is_binary      true:read as binary false:read as string
+ * @param callback       callback for download data.
+ * @param ptr            user def data pointer.
+ * @return true:success false:error
+ */
+bool ttLibC_HttpClient_getRanges(
+		ttLibC_HttpClient *client,
+		const char *target_address,
+		const size_t *range_starts,
+		const size_t *range_lengths,
+		uint32_t range_num,
+		bool is_binary,
+		ttLibC_HttpClientFunc callback,
+		void *ptr);
+
 /**
  * close http client
  * @param client
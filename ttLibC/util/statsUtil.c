@@ -0,0 +1,313 @@
+/*
+ * @file   statsUtil.c
+ * @brief  always-on allocation and latency counters.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "statsUtil.h"
+#include "../ttLibC_predef.h"
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#	define Stats_add(target, value) __atomic_fetch_add(&(target), (value), __ATOMIC_RELAXED)
+#	define Stats_load(target)       __atomic_load_n(&(target), __ATOMIC_RELAXED)
+#	define Stats_store(target, value) __atomic_store_n(&(target), (value), __ATOMIC_RELAXED)
+#	define Stats_claim(target, value) __sync_bool_compare_and_swap(&(target), 0, (value))
+#else
+#	define Stats_add(target, value) ((target) += (value))
+#	define Stats_load(target)       (target)
+#	define Stats_store(target, value) ((target) = (value))
+#	define Stats_claim(target, value) ((target) == 0 ? ((target) = (value), true) : false)
+#endif
+
+static ttLibC_Stats Stats_counter;
+
+/*
+ * module of source path, cached with the pointer of __FILE__ string.
+ * entry = pointer | (module << 56), so that one atomic load gives both.
+ */
+#define Stats_cacheNum 256
+#define Stats_pointerMask 0x00FFFFFFFFFFFFFFULL
+static uint64_t Stats_fileCache[Stats_cacheNum];
+
+/*
+ * counter of entry points.
+ * key = pointer of __FILE__ | (api << 56), open addressing, slot is never released.
+ */
+static uint64_t Stats_entryKeys[ttLibC_Stats_entryNum];
+static ttLibC_Stats_ApiStats Stats_entryStats[ttLibC_Stats_entryNum];
+
+static const char *Stats_moduleNames[] = {
+	"frame",
+	"container",
+	"net",
+	"resampler",
+	"encoder",
+	"decoder",
+	"util",
+	"other"
+};
+
+static const char *Stats_apiNames[] = {
+	"encode",
+	"decode",
+	"read",
+	"write"
+};
+
+/*
+ * find module from the first directory under ttLibC/.
+ * path can be "container/flv/flvWriter.c" or "../ttLibC/container/flv/flvWriter.c".
+ */
+static ttLibC_Stats_Module Stats_findModule(const char *file_name) {
+	if(file_name == NULL) {
+		return StatsModule_other;
+	}
+	const char *path = file_name;
+	const char *found = NULL;
+	while((found = strstr(path, "ttLibC/")) != NULL) {
+		path = found + 7;
+	}
+	const char *slash = strchr(path, '/');
+	if(slash == NULL) {
+		return StatsModule_other;
+	}
+	size_t length = slash - path;
+	for(int i = 0;i < StatsModule_other;++ i) {
+		if(strlen(Stats_moduleNames[i]) == length
+		&& strncmp(path, Stats_moduleNames[i], length) == 0) {
+			return (ttLibC_Stats_Module)i;
+		}
+	}
+	return StatsModule_other;
+}
+
+void TT_VISIBILITY_HIDDEN ttLibC_Stats_countAlloc(const char *file_name, size_t size) {
+	uint64_t key = (uint64_t)(uintptr_t)file_name & Stats_pointerMask;
+	uint32_t index = (uint32_t)((key >> 3) ^ (key >> 11)) & (Stats_cacheNum - 1);
+	uint64_t entry = Stats_load(Stats_fileCache[index]);
+	ttLibC_Stats_Module module;
+	if(entry != 0 && (entry & Stats_pointerMask) == key) {
+		module = (ttLibC_Stats_Module)(entry >> 56);
+	}
+	else {
+		module = Stats_findModule(file_name);
+		Stats_store(Stats_fileCache[index], key | ((uint64_t)module << 56));
+	}
+	Stats_add(Stats_counter.modules[module].alloc_count, 1);
+	Stats_add(Stats_counter.modules[module].alloc_size, size);
+}
+
+void TT_VISIBILITY_HIDDEN ttLibC_Stats_countFree() {
+	Stats_add(Stats_counter.free_count, 1);
+}
+
+uint64_t TT_VISIBILITY_HIDDEN ttLibC_Stats_now() {
+#ifdef CLOCK_MONOTONIC
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return (uint64_t)tv.tv_sec * 1000000000ULL + tv.tv_usec * 1000ULL;
+#endif
+}
+
+/*
+ * ref counter of entry point, claim new slot for the first call.
+ * @param file_name __FILE__ of entry point.
+ * @param api       kind of api
+ * @return counter, NULL when table is full.
+ */
+static ttLibC_Stats_ApiStats *Stats_refEntry(const char *file_name, ttLibC_Stats_Api api) {
+	uint64_t key = ((uint64_t)(uintptr_t)file_name & Stats_pointerMask) | ((uint64_t)api << 56);
+	uint32_t index = (uint32_t)((key >> 3) ^ (key >> 11) ^ api);
+	for(uint32_t i = 0;i < ttLibC_Stats_entryNum;++ i) {
+		uint32_t pos = (index + i) & (ttLibC_Stats_entryNum - 1);
+		uint64_t current = Stats_load(Stats_entryKeys[pos]);
+		if(current == 0) {
+			if(Stats_claim(Stats_entryKeys[pos], key)) {
+				return &Stats_entryStats[pos];
+			}
+			current = Stats_load(Stats_entryKeys[pos]);
+		}
+		if(current == key) {
+			return &Stats_entryStats[pos];
+		}
+	}
+	return NULL;
+}
+
+/*
+ * count one call on counter.
+ */
+static void Stats_countCall(ttLibC_Stats_ApiStats *api_stats, uint64_t elapsed, uint32_t bucket) {
+	Stats_add(api_stats->call_count, 1);
+	Stats_add(api_stats->total_time, elapsed);
+	Stats_add(api_stats->histogram[bucket], 1);
+}
+
+void TT_VISIBILITY_HIDDEN ttLibC_Stats_endScope(ttLibC_Stats_Scope *scope) {
+	uint64_t elapsed = ttLibC_Stats_now() - scope->start;
+	uint64_t usec = elapsed / 1000;
+	uint32_t bucket = 0;
+	// bucket is the bit length of micro sec.
+	while(usec != 0 && bucket < ttLibC_Stats_histogramNum - 1) {
+		usec >>= 1;
+		++ bucket;
+	}
+	Stats_countCall(&Stats_counter.apis[scope->api], elapsed, bucket);
+	ttLibC_Stats_ApiStats *entry_stats = Stats_refEntry(scope->file_name, scope->api);
+	if(entry_stats != NULL) {
+		Stats_countCall(entry_stats, elapsed, bucket);
+	}
+}
+
+/*
+ * copy counter.
+ */
+static void Stats_loadApiStats(ttLibC_Stats_ApiStats *target, ttLibC_Stats_ApiStats *source) {
+	target->call_count = Stats_load(source->call_count);
+	target->total_time = Stats_load(source->total_time);
+	for(int j = 0;j < ttLibC_Stats_histogramNum;++ j) {
+		target->histogram[j] = Stats_load(source->histogram[j]);
+	}
+}
+
+/*
+ * make entry name from source path. "../ttLibC/encoder/x264Encoder.c" -> "x264Encoder"
+ */
+static void Stats_makeEntryName(char *name, const char *file_name) {
+	const char *base = strrchr(file_name, '/');
+	base = base == NULL ? file_name : base + 1;
+	const char *ext = strrchr(base, '.');
+	size_t length = ext == NULL ? strlen(base) : (size_t)(ext - base);
+	if(length > ttLibC_Stats_entryNameSize - 1) {
+		length = ttLibC_Stats_entryNameSize - 1;
+	}
+	memcpy(name, base, length);
+	name[length] = 0;
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_Stats_snapshot(ttLibC_Stats *stats) {
+	if(stats == NULL) {
+		return;
+	}
+	for(int i = 0;i < StatsModule_num;++ i) {
+		stats->modules[i].alloc_count = Stats_load(Stats_counter.modules[i].alloc_count);
+		stats->modules[i].alloc_size  = Stats_load(Stats_counter.modules[i].alloc_size);
+	}
+	stats->free_count = Stats_load(Stats_counter.free_count);
+	for(int i = 0;i < StatsApi_num;++ i) {
+		Stats_loadApiStats(&stats->apis[i], &Stats_counter.apis[i]);
+	}
+	stats->entry_num = 0;
+	for(int i = 0;i < ttLibC_Stats_entryNum;++ i) {
+		uint64_t key = Stats_load(Stats_entryKeys[i]);
+		if(key == 0) {
+			continue;
+		}
+		ttLibC_Stats_EntryStats *entry = &stats->entries[stats->entry_num];
+		Stats_makeEntryName(entry->name, (const char *)(uintptr_t)(key & Stats_pointerMask));
+		entry->api = (ttLibC_Stats_Api)(key >> 56);
+		Stats_loadApiStats(&entry->stats, &Stats_entryStats[i]);
+		// same source can have several __FILE__ pointers, merge by name.
+		ttLibC_Stats_ApiStats *found = ttLibC_Stats_findEntry(stats, entry->name, entry->api);
+		if(found == NULL) {
+			++ stats->entry_num;
+			continue;
+		}
+		found->call_count += entry->stats.call_count;
+		found->total_time += entry->stats.total_time;
+		for(int j = 0;j < ttLibC_Stats_histogramNum;++ j) {
+			found->histogram[j] += entry->stats.histogram[j];
+		}
+	}
+}
+
+/*
+ * clear counter.
+ */
+static void Stats_clearApiStats(ttLibC_Stats_ApiStats *api_stats) {
+	Stats_store(api_stats->call_count, 0);
+	Stats_store(api_stats->total_time, 0);
+	for(int j = 0;j < ttLibC_Stats_histogramNum;++ j) {
+		Stats_store(api_stats->histogram[j], 0);
+	}
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_Stats_reset() {
+	for(int i = 0;i < StatsModule_num;++ i) {
+		Stats_store(Stats_counter.modules[i].alloc_count, 0);
+		Stats_store(Stats_counter.modules[i].alloc_size, 0);
+	}
+	Stats_store(Stats_counter.free_count, 0);
+	for(int i = 0;i < StatsApi_num;++ i) {
+		Stats_clearApiStats(&Stats_counter.apis[i]);
+	}
+	// keep the slots of entry points, clear counter only.
+	for(int i = 0;i < ttLibC_Stats_entryNum;++ i) {
+		Stats_clearApiStats(&Stats_entryStats[i]);
+	}
+}
+
+const char TT_VISIBILITY_DEFAULT *ttLibC_Stats_getModuleName(ttLibC_Stats_Module module) {
+	if(module < 0 || module >= StatsModule_num) {
+		return "unknown";
+	}
+	return Stats_moduleNames[module];
+}
+
+const char TT_VISIBILITY_DEFAULT *ttLibC_Stats_getApiName(ttLibC_Stats_Api api) {
+	if(api < 0 || api >= StatsApi_num) {
+		return "unknown";
+	}
+	return Stats_apiNames[api];
+}
+
+ttLibC_Stats_ApiStats TT_VISIBILITY_DEFAULT *ttLibC_Stats_findEntry(
+		ttLibC_Stats *stats,
+		const char *name,
+		ttLibC_Stats_Api api) {
+	if(stats == NULL || name == NULL) {
+		return NULL;
+	}
+	for(uint32_t i = 0;i < stats->entry_num;++ i) {
+		if(stats->entries[i].api == api
+		&& strcmp(stats->entries[i].name, name) == 0) {
+			return &stats->entries[i].stats;
+		}
+	}
+	return NULL;
+}
+
+uint64_t TT_VISIBILITY_DEFAULT ttLibC_Stats_getPercentile(
+		ttLibC_Stats_ApiStats *api_stats,
+		double percentile) {
+	if(api_stats == NULL || api_stats->call_count == 0) {
+		return 0;
+	}
+	uint64_t total = 0;
+	for(int i = 0;i < ttLibC_Stats_histogramNum;++ i) {
+		total += api_stats->histogram[i];
+	}
+	uint64_t target = (uint64_t)(total * percentile);
+	if(target >= total) {
+		target = total - 1;
+	}
+	uint64_t count = 0;
+	for(int i = 0;i < ttLibC_Stats_histogramNum;++ i) {
+		count += api_stats->histogram[i];
+		if(count > target) {
+			return 1ULL << i;
+		}
+	}
+	return 1ULL << (ttLibC_Stats_histogramNum - 1);
+}
@@ -0,0 +1,245 @@
+/**
+ * @file   statsUtil.h
+ * @brief  always-on allocation and latency counters.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * allocation count and bytes are counted for each module (frame, container, net ...),
+ * module is decided from the source path given to ttLibC_malloc.
+ * encode / decode / read / write entry points count calls and latency histogram,
+ * for each api and for each entry point (source file x api, ex: "x264Encoder" encode).
+ * each count is a few relaxed atomic increments, no lock.
+ *
+ * usage:
+ *   ttLibC_Stats stats;
+ *   ttLibC_Stats_snapshot(&stats);
+ *   stats.modules[StatsModule_container].alloc_count;
+ *   ttLibC_Stats_getPercentile(&stats.apis[StatsApi_encode], 0.99);
+ *   ttLibC_Stats_getPercentile(ttLibC_Stats_findEntry(&stats, "x264Encoder", StatsApi_encode), 0.99);
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_UTIL_STATSUTIL_H_
+#define TTLIBC_UTIL_STATSUTIL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * number of histogram bucket.
+ * bucket n counts the call, which takes less than 2^n micro sec.
+ * the last bucket counts all longer calls.
+ */
+#define ttLibC_Stats_histogramNum 24
+
+/**
+ * max number of entry point.
+ * calls on more entry points are counted only for the api.
+ */
+#define ttLibC_Stats_entryNum 64
+
+/**
+ * max length of entry name, includes null.
+ */
+#define ttLibC_Stats_entryNameSize 32
+
+/**
+ * module of allocation.
+ */
+typedef enum ttLibC_Stats_Module {
+	StatsModule_frame = 0,
+	StatsModule_container,
+	StatsModule_net,
+	StatsModule_resampler,
+	StatsModule_encoder,
+	StatsModule_decoder,
+	StatsModule_util,
+	/** allocator, ttLibC.c and the caller out of ttLibC. */
+	StatsModule_other,
+
+	StatsModule_num
+} ttLibC_Stats_Module;
+
+/**
+ * kind of api for latency.
+ */
+typedef enum ttLibC_Stats_Api {
+	/** ttLibC_XxxEncoder_encode */
+	StatsApi_encode = 0,
+	/** ttLibC_XxxDecoder_decode */
+	StatsApi_decode,
+	/** ttLibC_XxxReader_read */
+	StatsApi_read,
+	/** ttLibC_XxxWriter_write */
+	StatsApi_write,
+
+	StatsApi_num
+} ttLibC_Stats_Api;
+
+/**
+ * allocation counter of one module.
+ */
+typedef struct ttLibC_Util_StatsUtil_ModuleStats {
+	/** number of malloc / calloc. */
+	uint64_t alloc_count;
+	/** total allocated bytes. */
+	uint64_t alloc_size;
+} ttLibC_Util_StatsUtil_ModuleStats;
+
+typedef ttLibC_Util_StatsUtil_ModuleStats ttLibC_Stats_ModuleStats;
+
+/**
+ * call counter of one api.
+ * time includes the callback, which is called in the api.
+ */
+typedef struct ttLibC_Util_StatsUtil_ApiStats {
+	/** number of call. */
+	uint64_t call_count;
+	/** total time in nano sec. */
+	uint64_t total_time;
+	/** latency histogram, log2 of micro sec. */
+	uint64_t histogram[ttLibC_Stats_histogramNum];
+} ttLibC_Util_StatsUtil_ApiStats;
+
+typedef ttLibC_Util_StatsUtil_ApiStats ttLibC_Stats_ApiStats;
+
+/**
+ * call counter of one entry point.
+ */
+typedef struct ttLibC_Util_StatsUtil_EntryStats {
+	/** source file name of entry point without extension. ex:"x264Encoder" */
+	char name[ttLibC_Stats_entryNameSize];
+	/** kind of api. */
+	ttLibC_Stats_Api api;
+	/** counter */
+	ttLibC_Stats_ApiStats stats;
+} ttLibC_Util_StatsUtil_EntryStats;
+
+typedef ttLibC_Util_StatsUtil_EntryStats ttLibC_Stats_EntryStats;
+
+/**
+ * snapshot of all counters.
+ */
+typedef struct ttLibC_Util_StatsUtil_Stats {
+	ttLibC_Stats_ModuleStats modules[StatsModule_num];
+	/** number of free. module is not known for free. */
+	uint64_t free_count;
+	/** total of each api. */
+	ttLibC_Stats_ApiStats apis[StatsApi_num];
+	/** number of valid entries. */
+	uint32_t entry_num;
+	/** counter of each entry point. */
+	ttLibC_Stats_EntryStats entries[ttLibC_Stats_entryNum];
+} ttLibC_Util_StatsUtil_Stats;
+
+typedef ttLibC_Util_StatsUtil_Stats ttLibC_Stats;
+
+/**
+ * copy current counters.
+ * each counter is read atomically, but the whole is not one moment.
+ * @param stats target
+ */
+void ttLibC_Stats_snapshot(ttLibC_Stats *stats);
+
+/**
+ * clear all counters.
+ */
+void ttLibC_Stats_reset();
+
+/**
+ * ref the name of module.
+ * @param module
+ * @return name. ex:"container"
+ */
+const char *ttLibC_Stats_getModuleName(ttLibC_Stats_Module module);
+
+/**
+ * ref the name of api.
+ * @param api
+ * @return name. ex:"encode"
+ */
+const char *ttLibC_Stats_getApiName(ttLibC_Stats_Api api);
+
+/**
+ * find entry point counter in snapshot.
+ * @param stats snapshot
+ * @param name  source file name without extension. ex:"x264Encoder"
+ * @param api   kind of api
+ * @return api stats of the entry point. NULL if not called.
+ */
+ttLibC_Stats_ApiStats *ttLibC_Stats_findEntry(
+		ttLibC_Stats *stats,
+		const char *name,
+		ttLibC_Stats_Api api);
+
+/**
+ * get latency of percentile from histogram.
+ * @param api_stats  target api stats in snapshot.
+ * @param percentile 0.0 - 1.0 ex: 0.99 for p99
+ * @return upper bound of bucket in micro sec. 0 for no call.
+ */
+uint64_t ttLibC_Stats_getPercentile(
+		ttLibC_Stats_ApiStats *api_stats,
+		double percentile);
+
+// -------------------------------------------------------------- //
+// for ttLibC inside.
+
+/**
+ * count allocation, called from allocator.
+ * @param file_name source path of caller.
+ * @param size      allocated size.
+ */
+void ttLibC_Stats_countAlloc(const char *file_name, size_t size);
+
+/**
+ * count free, called from allocator.
+ */
+void ttLibC_Stats_countFree();
+
+/**
+ * ref monotonic time in nano sec.
+ */
+uint64_t ttLibC_Stats_now();
+
+/**
+ * scope of one api call.
+ */
+typedef struct ttLibC_Util_StatsUtil_Scope {
+	ttLibC_Stats_Api api;
+	/** __FILE__ of entry point. */
+	const char *file_name;
+	uint64_t start;
+} ttLibC_Util_StatsUtil_Scope;
+
+typedef ttLibC_Util_StatsUtil_Scope ttLibC_Stats_Scope;
+
+/**
+ * count the api call from scope start.
+ * @param scope
+ */
+void ttLibC_Stats_endScope(ttLibC_Stats_Scope *scope);
+
+/**
+ * put on the top of api function. the call is counted on every return.
+ * @param api ttLibC_Stats_Api
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#	define ttLibC_Stats_scope(api) \
+	ttLibC_Stats_Scope ttLibC_Stats_scope_ __attribute__((cleanup(ttLibC_Stats_endScope))) = {api, __FILE__, ttLibC_Stats_now()}
+#else
+#	define ttLibC_Stats_scope(api)
+#endif
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_UTIL_STATSUTIL_H_ */
@@ -0,0 +1,251 @@
+/*
+ * @file   thumbnailUtil.c
+ * @brief  make jpeg thumbnail from video frames, with reusing decoder, resizer and encoder.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifdef __ENABLE_JPEG__
+
+#include "thumbnailUtil.h"
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+#include "../frame/video/yuv420.h"
+#include "../decoder/jpegDecoder.h"
+#include "../encoder/jpegEncoder.h"
+#include "../resampler/imageResizer.h"
+#ifdef __ENABLE_AVCODEC__
+#	include "../decoder/avcodecDecoder.h"
+#endif
+#include <sys/time.h>
+
+typedef struct ttLibC_Util_ThumbnailUtil_Thumbnail_ {
+	ttLibC_Thumbnail inherit_super;
+	ttLibC_JpegDecoder *jpeg_decoder;
+#ifdef __ENABLE_AVCODEC__
+	ttLibC_AvcodecDecoder *avcodec_decoder;
+#endif
+	ttLibC_JpegEncoder *encoder;
+	ttLibC_Yuv420 *resized;
+	ttLibC_ThumbnailFunc callback;
+	void *ptr;
+} ttLibC_Util_ThumbnailUtil_Thumbnail_;
+
+typedef ttLibC_Util_ThumbnailUtil_Thumbnail_ ttLibC_Thumbnail_;
+
+ttLibC_Thumbnail TT_VISIBILITY_DEFAULT *ttLibC_Thumbnail_make(
+		uint32_t width,
+		uint32_t height,
+		uint32_t quality) {
+	if(width == 0 && height == 0) {
+		ERR_PRINT("need width or height for thumbnail.");
+		return NULL;
+	}
+	ttLibC_Thumbnail_ *thumbnail = ttLibC_malloc(sizeof(ttLibC_Thumbnail_));
+	if(thumbnail == NULL) {
+		return NULL;
+	}
+	thumbnail->inherit_super.width             = width;
+	thumbnail->inherit_super.height            = height;
+	thumbnail->inherit_super.quality           = quality;
+	thumbnail->inherit_super.frame_count       = 0;
+	thumbnail->inherit_super.thumbnail_count   = 0;
+	thumbnail->inherit_super.elapsed_time      = 0;
+	thumbnail->inherit_super.thumbnail_per_sec = 0;
+	thumbnail->jpeg_decoder = NULL;
+#ifdef __ENABLE_AVCODEC__
+	thumbnail->avcodec_decoder = NULL;
+#endif
+	thumbnail->encoder  = NULL;
+	thumbnail->resized  = NULL;
+	thumbnail->callback = NULL;
+	thumbnail->ptr      = NULL;
+	return (ttLibC_Thumbnail *)thumbnail;
+}
+
+/*
+ * resize and encode decoded picture.
+ * encoder is remade only when the output size is changed.
+ */
+static bool Thumbnail_encode(void *ptr, ttLibC_Yuv420 *yuv) {
+	ttLibC_Thumbnail_ *thumbnail = (ttLibC_Thumbnail_ *)ptr;
+	uint32_t src_width  = yuv->inherit_super.width;
+	uint32_t src_height = yuv->inherit_super.height;
+	if(src_width == 0 || src_height == 0) {
+		return true;
+	}
+	uint32_t width  = thumbnail->inherit_super.width;
+	uint32_t height = thumbnail->inherit_super.height;
+	if(width == 0) {
+		width = (uint32_t)((uint64_t)src_width * height / src_height);
+	}
+	if(height == 0) {
+		height = (uint32_t)((uint64_t)src_height * width / src_width);
+	}
+	// yuv420 need even size.
+	width  = (width  + 1) & ~1;
+	height = (height + 1) & ~1;
+	ttLibC_Yuv420 *target = yuv;
+	if(width != src_width || height != src_height || yuv->type != Yuv420Type_planar) {
+		ttLibC_Yuv420 *resized = ttLibC_ImageResizer_resizeYuv420(
+				thumbnail->resized,
+				Yuv420Type_planar,
+				width,
+				height,
+				yuv,
+				false);
+		if(resized == NULL) {
+			ERR_PRINT("failed to resize.");
+			return false;
+		}
+		thumbnail->resized = resized;
+		target = resized;
+	}
+	if(thumbnail->encoder != NULL
+	&& (thumbnail->encoder->width != width || thumbnail->encoder->height != height)) {
+		ttLibC_JpegEncoder_close(&thumbnail->encoder);
+	}
+	if(thumbnail->encoder == NULL) {
+		thumbnail->encoder = ttLibC_JpegEncoder_make(width, height, thumbnail->inherit_super.quality);
+		if(thumbnail->encoder == NULL) {
+			ERR_PRINT("failed to make jpeg encoder.");
+			return false;
+		}
+	}
+	if(!ttLibC_JpegEncoder_encode(thumbnail->encoder, target, thumbnail->callback, thumbnail->ptr)) {
+		return false;
+	}
+	++ thumbnail->inherit_super.thumbnail_count;
+	return true;
+}
+
+#ifdef __ENABLE_AVCODEC__
+static bool Thumbnail_avcodecDecodeCallback(void *ptr, ttLibC_Frame *frame) {
+	if(frame->type != frameType_yuv420) {
+		return true;
+	}
+	return Thumbnail_encode(ptr, (ttLibC_Yuv420 *)frame);
+}
+#endif
+
+/*
+ * add elapsed time from start, and update thumbnail_per_sec.
+ */
+static void Thumbnail_updateElapsed(
+		ttLibC_Thumbnail_ *thumbnail,
+		struct timeval *start) {
+	struct timeval end;
+	gettimeofday(&end, NULL);
+	thumbnail->inherit_super.elapsed_time += (end.tv_sec - start->tv_sec) * 1000000 + (end.tv_usec - start->tv_usec);
+	if(thumbnail->inherit_super.elapsed_time > 0) {
+		thumbnail->inherit_super.thumbnail_per_sec = thumbnail->inherit_super.thumbnail_count * 1000000.0 / thumbnail->inherit_super.elapsed_time;
+	}
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_Thumbnail_convert(
+		ttLibC_Thumbnail *thumbnail,
+		ttLibC_Frame *frame,
+		ttLibC_ThumbnailFunc callback,
+		void *ptr) {
+	ttLibC_Thumbnail_ *thumbnail_ = (ttLibC_Thumbnail_ *)thumbnail;
+	if(thumbnail_ == NULL) {
+		return false;
+	}
+	if(frame == NULL || !ttLibC_Frame_isVideo(frame)) {
+		return true;
+	}
+	struct timeval start;
+	gettimeofday(&start, NULL);
+	thumbnail_->callback = callback;
+	thumbnail_->ptr      = ptr;
+	++ thumbnail_->inherit_super.frame_count;
+	bool result = true;
+	switch(frame->type) {
+	case frameType_yuv420:
+		result = Thumbnail_encode(thumbnail_, (ttLibC_Yuv420 *)frame);
+		break;
+	case frameType_jpeg:
+		if(thumbnail_->jpeg_decoder == NULL) {
+			thumbnail_->jpeg_decoder = ttLibC_JpegDecoder_make();
+			if(thumbnail_->jpeg_decoder == NULL) {
+				ERR_PRINT("failed to make jpeg decoder.");
+				return false;
+			}
+		}
+		result = ttLibC_JpegDecoder_decode(thumbnail_->jpeg_decoder, (ttLibC_Jpeg *)frame, Thumbnail_encode, thumbnail_);
+		break;
+	default:
+#ifdef __ENABLE_AVCODEC__
+		if(thumbnail_->avcodec_decoder != NULL
+		&& thumbnail_->avcodec_decoder->frame_type != frame->type) {
+			// held pictures of previous stream are done first.
+			if(!ttLibC_AvcodecDecoder_flush(thumbnail_->avcodec_decoder, Thumbnail_avcodecDecodeCallback, thumbnail_)) {
+				result = false;
+			}
+			ttLibC_AvcodecDecoder_close(&thumbnail_->avcodec_decoder);
+		}
+		if(thumbnail_->avcodec_decoder == NULL) {
+			thumbnail_->avcodec_decoder = ttLibC_AvcodecDecoder_make(frame->type);
+			if(thumbnail_->avcodec_decoder == NULL) {
+				ERR_PRINT("failed to make decoder for frame type:%d", frame->type);
+				return false;
+			}
+		}
+		if(!ttLibC_AvcodecDecoder_decode(thumbnail_->avcodec_decoder, frame, Thumbnail_avcodecDecodeCallback, thumbnail_)) {
+			result = false;
+		}
+#else
+		ERR_PRINT("avcodec is required to decode frame type:%d", frame->type);
+		result = false;
+#endif
+		break;
+	}
+	Thumbnail_updateElapsed(thumbnail_, &start);
+	return result;
+}
+
+bool TT_VISIBILITY_DEFAULT ttLibC_Thumbnail_flush(
+		ttLibC_Thumbnail *thumbnail,
+		ttLibC_ThumbnailFunc callback,
+		void *ptr) {
+	ttLibC_Thumbnail_ *thumbnail_ = (ttLibC_Thumbnail_ *)thumbnail;
+	if(thumbnail_ == NULL) {
+		return false;
+	}
+	bool result = true;
+#ifdef __ENABLE_AVCODEC__
+	if(thumbnail_->avcodec_decoder != NULL) {
+		struct timeval start;
+		gettimeofday(&start, NULL);
+		thumbnail_->callback = callback;
+		thumbnail_->ptr      = ptr;
+		result = ttLibC_AvcodecDecoder_flush(thumbnail_->avcodec_decoder, Thumbnail_avcodecDecodeCallback, thumbnail_);
+		Thumbnail_updateElapsed(thumbnail_, &start);
+	}
+#else
+	(void)callback;
+	(void)ptr;
+#endif
+	return result;
+}
+
+void TT_VISIBILITY_DEFAULT ttLibC_Thumbnail_close(ttLibC_Thumbnail **thumbnail) {
+	ttLibC_Thumbnail_ *target = (ttLibC_Thumbnail_ *)*thumbnail;
+	if(target == NULL) {
+		return;
+	}
+	ttLibC_JpegDecoder_close(&target->jpeg_decoder);
+#ifdef __ENABLE_AVCODEC__
+	ttLibC_AvcodecDecoder_close(&target->avcodec_decoder);
+#endif
+	ttLibC_JpegEncoder_close(&target->encoder);
+	ttLibC_Yuv420_close(&target->resized);
+	ttLibC_free(target);
+	*thumbnail = NULL;
+}
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file   thumbnailUtil.h
+ * @brief  make jpeg thumbnail from video frames, with reusing decoder, resizer and encoder.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * usage:
+ *   ttLibC_ContainerReader_setKeyOnly(reader, true);
+ *   ttLibC_Thumbnail *thumbnail = ttLibC_Thumbnail_make(320, 0, 80);
+ *   // in getFrame callback of reader.
+ *   ttLibC_Thumbnail_convert(thumbnail, frame, jpegCallback, ptr);
+ *   // end of input, pictures held in decoder are done.
+ *   ttLibC_Thumbnail_flush(thumbnail, jpegCallback, ptr);
+ *   ttLibC_Thumbnail_close(&thumbnail);
+ *
+ * yuv420 planar frame is resized and encoded directly.
+ * jpeg frame is decoded with libjpeg, other video frames need avcodec.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_UTIL_THUMBNAILUTIL_H_
+#define TTLIBC_UTIL_THUMBNAILUTIL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../frame/frame.h"
+#include "../frame/video/jpeg.h"
+
+/**
+ * data for thumbnail
+ */
+typedef struct ttLibC_Util_ThumbnailUtil_Thumbnail {
+	/** target width. 0 for keep aspect with height. */
+	uint32_t width;
+	/** target height. 0 for keep aspect with width. */
+	uint32_t height;
+	/** jpeg quality. */
+	uint32_t quality;
+	/** number of video frames given to convert. */
+	uint64_t frame_count;
+	/** number of made thumbnails. */
+	uint64_t thumbnail_count;
+	/** time for decode, resize and encode in micro sec. */
+	uint64_t elapsed_time;
+	/** thumbnails per sec. */
+	double thumbnail_per_sec;
+} ttLibC_Util_ThumbnailUtil_Thumbnail;
+
+typedef ttLibC_Util_ThumbnailUtil_Thumbnail ttLibC_Thumbnail;
+
+/**
+ * callback for thumbnail.
+ * @param ptr  user def pointer object.
+ * @param jpeg made thumbnail. valid only in callback.
+ * @return true:continue false:error
+ */
+typedef bool (* ttLibC_ThumbnailFunc)(void *ptr, ttLibC_Jpeg *jpeg);
+
+/**
+ * make thumbnail object.
+ * @param width   target width. 0 for keep aspect.
+ * @param height  target height. 0 for keep aspect.
+ * @param quality jpeg quality 0 - 100
+ * @return thumbnail object.
+ */
+ttLibC_Thumbnail *ttLibC_Thumbnail_make(
+		uint32_t width,
+		uint32_t height,
+		uint32_t quality);
+
+/**
+ * make thumbnail from frame.
+ * audio frame and video frame which is not decoded into picture is ignored.
+ * @param thumbnail thumbnail object.
+ * @param frame     source frame.
+ * @param callback  callback for made jpeg.
+ * @param ptr       user def pointer object.
+ * @return true:success false:error
+ */
+bool ttLibC_Thumbnail_convert(
+		ttLibC_Thumbnail *thumbnail,
+		ttLibC_Frame *frame,
+		ttLibC_ThumbnailFunc callback,
+		void *ptr);
+
+/**
+ * make thumbnails from pictures held in decoder, for the end of input.
+ * avcodec decoder delays pictures, the last key frames are lost without flush.
+ * @param thumbnail thumbnail object.
+ * @param callback  callback for made jpeg.
+ * @param ptr       user def pointer object.
+ * @return true:success false:error
+ */
+bool ttLibC_Thumbnail_flush(
+		ttLibC_Thumbnail *thumbnail,
+		ttLibC_ThumbnailFunc callback,
+		void *ptr);
+
+/**
+ * close thumbnail object.
+ * @param thumbnail
+ */
+void ttLibC_Thumbnail_close(ttLibC_Thumbnail **thumbnail);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_UTIL_THUMBNAILUTIL_H_ */
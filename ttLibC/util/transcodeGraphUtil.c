@@ -0,0 +1,477 @@
+/*
+ * @file   transcodeGraphUtil.c
+ * @brief  pipeline of decode / resize / encode / mux, each node on its own thread.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#include "transcodeGraphUtil.h"
+#include "../ttLibC_predef.h"
+#include "../_log.h"
+#include "../allocator.h"
+#include "framePoolUtil.h"
+#include "frameRingUtil.h"
+#include "statsUtil.h"
+#include <pthread.h>
+#include <string.h>
+
+#define TranscodeGraph_maxNode   64
+#define TranscodeGraph_maxOutput 32
+
+typedef struct ttLibC_Util_TranscodeGraphUtil_TranscodeGraph_ ttLibC_TranscodeGraph_;
+
+typedef struct ttLibC_Util_TranscodeGraphUtil_TranscodeNode_ {
+	ttLibC_TranscodeNode inherit_super;
+	ttLibC_TranscodeGraph_ *graph;
+	ttLibC_TranscodeNodeFunc func;
+	void *ptr;
+	/** input frames. (mpsc, upstream nodes push) */
+	ttLibC_FrameRing *ring;
+	struct ttLibC_Util_TranscodeGraphUtil_TranscodeNode_ *outputs[TranscodeGraph_maxOutput];
+	uint32_t output_num;
+	/** number of upstream. input node has 1 for the caller of push. */
+	uint32_t upstream_num;
+	/** number of upstream which reached end of stream. */
+	uint32_t finished_num;
+	/** true for the node without upstream node. */
+	bool is_input;
+	/** true:func does not modify input frame, frame can be shared on fan-out. */
+	bool is_read_only;
+	pthread_t thread;
+	bool has_thread;
+} ttLibC_Util_TranscodeGraphUtil_TranscodeNode_;
+
+typedef ttLibC_Util_TranscodeGraphUtil_TranscodeNode_ ttLibC_TranscodeNode_;
+
+struct ttLibC_Util_TranscodeGraphUtil_TranscodeGraph_ {
+	ttLibC_TranscodeGraph inherit_super;
+	ttLibC_TranscodeNode_ *nodes[TranscodeGraph_maxNode];
+	/** frames between nodes. */
+	ttLibC_FramePool *pool;
+	/** 1 for stop request. */
+	uint32_t stop;
+	uint64_t start_time;
+	uint64_t end_time;
+};
+
+/*
+ * make graph.
+ * @param pool_size max number of idle frames to reuse.
+ * @return graph object.
+ */
+ttLibC_TranscodeGraph TT_VISIBILITY_DEFAULT *ttLibC_TranscodeGraph_make(uint32_t pool_size) {
+	ttLibC_TranscodeGraph_ *graph = ttLibC_malloc(sizeof(ttLibC_TranscodeGraph_));
+	if(graph == NULL) {
+		ERR_PRINT("failed to allocate memory for graph.");
+		return NULL;
+	}
+	memset(graph, 0, sizeof(ttLibC_TranscodeGraph_));
+	graph->pool = ttLibC_FramePool_make(pool_size == 0 ? 1 : pool_size);
+	if(graph->pool == NULL) {
+		ttLibC_free(graph);
+		return NULL;
+	}
+	return (ttLibC_TranscodeGraph *)graph;
+}
+
+/*
+ * add node. (before start)
+ * @param graph      graph object.
+ * @param name       name for report.
+ * @param queue_size max number of input frames waiting.
+ * @param func       node function.
+ * @param ptr        user def value pointer for func.
+ * @return node object. owned by graph.
+ */
+ttLibC_TranscodeNode TT_VISIBILITY_DEFAULT *ttLibC_TranscodeGraph_addNode(
+		ttLibC_TranscodeGraph *graph,
+		const char *name,
+		uint32_t queue_size,
+		ttLibC_TranscodeNodeFunc func,
+		void *ptr) {
+	ttLibC_TranscodeGraph_ *graph_ = (ttLibC_TranscodeGraph_ *)graph;
+	if(graph_ == NULL || func == NULL) {
+		return NULL;
+	}
+	if(graph_->inherit_super.is_running) {
+		ERR_PRINT("graph is already started.");
+		return NULL;
+	}
+	if(graph_->inherit_super.node_num >= TranscodeGraph_maxNode) {
+		ERR_PRINT("too many nodes.");
+		return NULL;
+	}
+	ttLibC_TranscodeNode_ *node = ttLibC_malloc(sizeof(ttLibC_TranscodeNode_));
+	if(node == NULL) {
+		ERR_PRINT("failed to allocate memory for node.");
+		return NULL;
+	}
+	memset(node, 0, sizeof(ttLibC_TranscodeNode_));
+	node->ring = ttLibC_FrameRing_make(FrameRingType_mpsc, queue_size == 0 ? 1 : queue_size);
+	if(node->ring == NULL) {
+		ttLibC_free(node);
+		return NULL;
+	}
+	if(name != NULL) {
+		strncpy(node->inherit_super.name, name, sizeof(node->inherit_super.name) - 1);
+	}
+	node->graph = graph_;
+	node->func  = func;
+	node->ptr   = ptr;
+	graph_->nodes[graph_->inherit_super.node_num ++] = node;
+	return (ttLibC_TranscodeNode *)node;
+}
+
+/*
+ * connect output of node to input of other node. (before start)
+ * @param graph graph object.
+ * @param from  upstream node
+ * @param to    downstream node
+ * @return true:success false:error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_TranscodeGraph_connect(
+		ttLibC_TranscodeGraph *graph,
+		ttLibC_TranscodeNode *from,
+		ttLibC_TranscodeNode *to) {
+	ttLibC_TranscodeGraph_ *graph_ = (ttLibC_TranscodeGraph_ *)graph;
+	ttLibC_TranscodeNode_ *from_ = (ttLibC_TranscodeNode_ *)from;
+	ttLibC_TranscodeNode_ *to_   = (ttLibC_TranscodeNode_ *)to;
+	if(graph_ == NULL || from_ == NULL || to_ == NULL || from_ == to_) {
+		return false;
+	}
+	if(from_->graph != graph_ || to_->graph != graph_) {
+		ERR_PRINT("node of other graph.");
+		return false;
+	}
+	if(graph_->inherit_super.is_running) {
+		ERR_PRINT("graph is already started.");
+		return false;
+	}
+	if(from_->output_num >= TranscodeGraph_maxOutput) {
+		ERR_PRINT("too many outputs.");
+		return false;
+	}
+	from_->outputs[from_->output_num ++] = to_;
+	++ to_->upstream_num;
+	return true;
+}
+
+/*
+ * put frame on the ring of node, wait while it is full.
+ * @param graph
+ * @param node       target node
+ * @param frame      pooled frame, released on failure.
+ * @param block_time wait time is added.
+ * @return true:success false:graph is stopped.
+ */
+static bool TranscodeGraph_pushRing(
+		ttLibC_TranscodeGraph_ *graph,
+		ttLibC_TranscodeNode_ *node,
+		ttLibC_Frame *frame,
+		uint64_t *block_time) {
+	if(ttLibC_FrameRing_push(node->ring, frame)) {
+		return true;
+	}
+	uint64_t start = ttLibC_Stats_now();
+	bool result = true;
+	// wakes up on pop of the node, timeout is for checking stop.
+	while(!ttLibC_FrameRing_pushWait(node->ring, frame, 20)) {
+		if(__atomic_load_n(&graph->stop, __ATOMIC_RELAXED) != 0) {
+			ttLibC_FramePool_release(graph->pool, &frame);
+			result = false;
+			break;
+		}
+	}
+	__atomic_fetch_add(block_time, ttLibC_Stats_now() - start, __ATOMIC_RELAXED);
+	return result;
+}
+
+/*
+ * pass pooled frame to all outputs.
+ * read only outputs share the frame with reference, others get own clone.
+ * @param node
+ * @param frame pooled frame.
+ * @return true:success false:graph is stopped or error.
+ */
+static bool TranscodeNode_send(
+		ttLibC_TranscodeNode_ *node,
+		ttLibC_Frame *frame) {
+	ttLibC_TranscodeGraph_ *graph = node->graph;
+	ttLibC_Frame *frames[TranscodeGraph_maxOutput];
+	uint32_t shared_num = 0;
+	for(uint32_t i = 0;i < node->output_num;++ i) {
+		if(node->outputs[i]->is_read_only) {
+			++ shared_num;
+		}
+	}
+	// without read only output, first output takes the frame itself.
+	// clones are made before push, cuz pushed frame can be modified by the next node.
+	bool result = true;
+	uint32_t ref_num = 0;
+	for(uint32_t i = 0;i < node->output_num;++ i) {
+		if(node->outputs[i]->is_read_only || (shared_num == 0 && i == 0)) {
+			frames[i] = frame;
+			++ ref_num;
+			continue;
+		}
+		frames[i] = result ? ttLibC_FramePool_clone(graph->pool, frame) : NULL;
+		if(frames[i] == NULL && result) {
+			ERR_PRINT("failed to clone frame.");
+			result = false;
+		}
+	}
+	for(uint32_t i = 1;i < ref_num;++ i) {
+		ttLibC_FramePool_ref(graph->pool, frame);
+	}
+	for(uint32_t i = 0;i < node->output_num;++ i) {
+		if(frames[i] == NULL) {
+			continue;
+		}
+		if(!result) {
+			// drop the reference for the rest.
+			ttLibC_FramePool_release(graph->pool, &frames[i]);
+			continue;
+		}
+		result = TranscodeGraph_pushRing(graph, node->outputs[i], frames[i], &node->inherit_super.block_time);
+	}
+	return result;
+}
+
+/*
+ * pass frame to all downstream nodes.
+ * @param node  node object.
+ * @param frame output frame.
+ * @return true:success false:graph is stopped.
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_TranscodeNode_emit(
+		ttLibC_TranscodeNode *node,
+		ttLibC_Frame *frame) {
+	ttLibC_TranscodeNode_ *node_ = (ttLibC_TranscodeNode_ *)node;
+	if(node_ == NULL || frame == NULL) {
+		return false;
+	}
+	__atomic_fetch_add(&node_->inherit_super.out_count, 1, __ATOMIC_RELAXED);
+	if(node_->output_num == 0) {
+		return true;
+	}
+	ttLibC_Frame *cloned = ttLibC_FramePool_clone(node_->graph->pool, frame);
+	if(cloned == NULL) {
+		ERR_PRINT("failed to clone frame.");
+		return false;
+	}
+	return TranscodeNode_send(node_, cloned);
+}
+
+/*
+ * request all threads to stop, cause of error.
+ */
+static void TranscodeGraph_fail(ttLibC_TranscodeGraph_ *graph) {
+	graph->inherit_super.is_error = true;
+	__atomic_store_n(&graph->stop, 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * thread of node.
+ */
+static void *TranscodeNode_run(void *arg) {
+	ttLibC_TranscodeNode_ *node = (ttLibC_TranscodeNode_ *)arg;
+	ttLibC_TranscodeGraph_ *graph = node->graph;
+	while(__atomic_load_n(&graph->stop, __ATOMIC_RELAXED) == 0) {
+		ttLibC_Frame *frame = ttLibC_FrameRing_popWait(node->ring, 20);
+		if(frame == NULL) {
+			if(__atomic_load_n(&node->finished_num, __ATOMIC_ACQUIRE) != node->upstream_num) {
+				continue;
+			}
+			// all upstream finished, check the frame pushed just before finish.
+			frame = ttLibC_FrameRing_pop(node->ring);
+			if(frame == NULL) {
+				if(!node->func(node->ptr, (ttLibC_TranscodeNode *)node, NULL)) {
+					TranscodeGraph_fail(graph);
+				}
+				for(uint32_t i = 0;i < node->output_num;++ i) {
+					__atomic_fetch_add(&node->outputs[i]->finished_num, 1, __ATOMIC_RELEASE);
+				}
+				break;
+			}
+		}
+		uint64_t start = ttLibC_Stats_now();
+		bool result = node->func(node->ptr, (ttLibC_TranscodeNode *)node, frame);
+		__atomic_fetch_add(&node->inherit_super.busy_time, ttLibC_Stats_now() - start, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&node->inherit_super.in_count, 1, __ATOMIC_RELAXED);
+		ttLibC_FramePool_release(graph->pool, &frame);
+		if(!result) {
+			ERR_PRINT("node func failed.:%s", node->inherit_super.name);
+			TranscodeGraph_fail(graph);
+		}
+	}
+	return NULL;
+}
+
+/*
+ * wait for all threads.
+ */
+static void TranscodeGraph_join(ttLibC_TranscodeGraph_ *graph) {
+	for(uint32_t i = 0;i < graph->inherit_super.node_num;++ i) {
+		ttLibC_TranscodeNode_ *node = graph->nodes[i];
+		if(node->has_thread) {
+			pthread_join(node->thread, NULL);
+			node->has_thread = false;
+		}
+	}
+	graph->end_time = ttLibC_Stats_now();
+	graph->inherit_super.is_running = false;
+}
+
+/*
+ * declare that func of node does not modify input frame. (before start)
+ * @param node         node object.
+ * @param is_read_only true:read only, frame is shared on fan-out.
+ * @return true:success false:error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_TranscodeNode_setReadOnly(
+		ttLibC_TranscodeNode *node,
+		bool is_read_only) {
+	ttLibC_TranscodeNode_ *node_ = (ttLibC_TranscodeNode_ *)node;
+	if(node_ == NULL) {
+		return false;
+	}
+	if(node_->graph->inherit_super.is_running) {
+		ERR_PRINT("graph is already started.");
+		return false;
+	}
+	node_->is_read_only = is_read_only;
+	return true;
+}
+
+/*
+ * start threads of nodes.
+ * @param graph graph object.
+ * @return true:success false:error
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_TranscodeGraph_start(ttLibC_TranscodeGraph *graph) {
+	ttLibC_TranscodeGraph_ *graph_ = (ttLibC_TranscodeGraph_ *)graph;
+	if(graph_ == NULL || graph_->inherit_super.is_running) {
+		return false;
+	}
+	for(uint32_t i = 0;i < graph_->inherit_super.node_num;++ i) {
+		ttLibC_TranscodeNode_ *node = graph_->nodes[i];
+		if(node->upstream_num == 0) {
+			// input node, caller of push is the upstream.
+			node->is_input = true;
+			node->upstream_num = 1;
+		}
+	}
+	graph_->start_time = ttLibC_Stats_now();
+	graph_->inherit_super.is_running = true;
+	for(uint32_t i = 0;i < graph_->inherit_super.node_num;++ i) {
+		ttLibC_TranscodeNode_ *node = graph_->nodes[i];
+		if(pthread_create(&node->thread, NULL, TranscodeNode_run, node) != 0) {
+			ERR_PRINT("failed to create thread.:%s", node->inherit_super.name);
+			TranscodeGraph_fail(graph_);
+			TranscodeGraph_join(graph_);
+			return false;
+		}
+		node->has_thread = true;
+	}
+	return true;
+}
+
+/*
+ * put frame on input node.
+ * @param graph graph object.
+ * @param node  input node.
+ * @param frame source frame.
+ * @return true:success false:error or graph is stopped.
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_TranscodeGraph_push(
+		ttLibC_TranscodeGraph *graph,
+		ttLibC_TranscodeNode *node,
+		ttLibC_Frame *frame) {
+	ttLibC_TranscodeGraph_ *graph_ = (ttLibC_TranscodeGraph_ *)graph;
+	ttLibC_TranscodeNode_ *node_ = (ttLibC_TranscodeNode_ *)node;
+	if(graph_ == NULL || node_ == NULL || frame == NULL) {
+		return false;
+	}
+	if(!graph_->inherit_super.is_running || __atomic_load_n(&graph_->stop, __ATOMIC_RELAXED) != 0) {
+		return false;
+	}
+	ttLibC_Frame *cloned = ttLibC_FramePool_clone(graph_->pool, frame);
+	if(cloned == NULL) {
+		ERR_PRINT("failed to clone frame.");
+		return false;
+	}
+	uint64_t block_time = 0;
+	return TranscodeGraph_pushRing(graph_, node_, cloned, &block_time);
+}
+
+/*
+ * end of input, wait until all nodes finish.
+ * @param graph graph object.
+ * @return true:success false:some node failed.
+ */
+bool TT_VISIBILITY_DEFAULT ttLibC_TranscodeGraph_finish(ttLibC_TranscodeGraph *graph) {
+	ttLibC_TranscodeGraph_ *graph_ = (ttLibC_TranscodeGraph_ *)graph;
+	if(graph_ == NULL) {
+		return false;
+	}
+	if(!graph_->inherit_super.is_running) {
+		return !graph_->inherit_super.is_error;
+	}
+	for(uint32_t i = 0;i < graph_->inherit_super.node_num;++ i) {
+		ttLibC_TranscodeNode_ *node = graph_->nodes[i];
+		if(node->is_input) {
+			__atomic_fetch_add(&node->finished_num, 1, __ATOMIC_RELEASE);
+		}
+	}
+	TranscodeGraph_join(graph_);
+	return !graph_->inherit_super.is_error;
+}
+
+/*
+ * ref the busy time rate of node from start.
+ * @param node node object.
+ * @return 0.0 - 1.0
+ */
+double TT_VISIBILITY_DEFAULT ttLibC_TranscodeNode_refUtilization(ttLibC_TranscodeNode *node) {
+	ttLibC_TranscodeNode_ *node_ = (ttLibC_TranscodeNode_ *)node;
+	if(node_ == NULL || node_->graph->start_time == 0) {
+		return 0.0;
+	}
+	uint64_t end_time = node_->graph->inherit_super.is_running ? ttLibC_Stats_now() : node_->graph->end_time;
+	if(end_time <= node_->graph->start_time) {
+		return 0.0;
+	}
+	double rate = (double)__atomic_load_n(&node_->inherit_super.busy_time, __ATOMIC_RELAXED) / (end_time - node_->graph->start_time);
+	return rate > 1.0 ? 1.0 : rate;
+}
+
+/*
+ * close graph, stop threads if running.
+ * @param graph
+ */
+void TT_VISIBILITY_DEFAULT ttLibC_TranscodeGraph_close(ttLibC_TranscodeGraph **graph) {
+	ttLibC_TranscodeGraph_ *target = (ttLibC_TranscodeGraph_ *)*graph;
+	if(target == NULL) {
+		return;
+	}
+	if(target->inherit_super.is_running) {
+		__atomic_store_n(&target->stop, 1, __ATOMIC_RELAXED);
+		TranscodeGraph_join(target);
+	}
+	for(uint32_t i = 0;i < target->inherit_super.node_num;++ i) {
+		ttLibC_TranscodeNode_ *node = target->nodes[i];
+		// frames in ring can be shared, give back to pool.
+		ttLibC_Frame *frame = NULL;
+		while((frame = ttLibC_FrameRing_pop(node->ring)) != NULL) {
+			ttLibC_FramePool_release(target->pool, &frame);
+		}
+		ttLibC_FrameRing_close(&node->ring);
+		ttLibC_free(node);
+	}
+	ttLibC_FramePool_close(&target->pool);
+	ttLibC_free(target);
+	*graph = NULL;
+}
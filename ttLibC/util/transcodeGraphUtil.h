@@ -0,0 +1,196 @@
+/**
+ * @file   transcodeGraphUtil.h
+ * @brief  pipeline of decode / resize / encode / mux, each node on its own thread.
+ *
+ * this code is under 3-Cause BSD license.
+ *
+ * nodes are connected with bounded frameRing.
+ * when the ring of next node is full, emit waits. (backpressure)
+ * one node can feed many nodes. (ex: decoder -> resizers and encoders for abr ladder)
+ * frames between nodes are cloned on framePool of graph.
+ * on fan-out, the frame is shared by read only nodes, other nodes get own clone.
+ * node func of read only node should not modify the frame, even id or pts.
+ * node which is not read only can modify it. (ex: set frame->id for container writer)
+ * container writers do not modify the input frame, only frame->id is needed to change.
+ *
+ * usage:
+ *   ttLibC_TranscodeGraph *graph = ttLibC_TranscodeGraph_make(64);
+ *   ttLibC_TranscodeNode *decode = ttLibC_TranscodeGraph_addNode(graph, "decode", 8, decodeFunc, decoder);
+ *   ttLibC_TranscodeNode *encode = ttLibC_TranscodeGraph_addNode(graph, "encode", 8, encodeFunc, encoder);
+ *   ttLibC_TranscodeGraph_connect(graph, decode, encode);
+ *   ttLibC_TranscodeGraph_start(graph);
+ *   // on reader callback.
+ *   ttLibC_TranscodeGraph_push(graph, decode, frame);
+ *   // end of input, wait for all nodes.
+ *   ttLibC_TranscodeGraph_finish(graph);
+ *   ttLibC_TranscodeGraph_close(&graph);
+ *
+ * node func calls existing component, and emit the output on the callback.
+ *   static bool decodeCallback(void *ptr, ttLibC_Yuv420 *yuv) {
+ *     return ttLibC_TranscodeNode_emit((ttLibC_TranscodeNode *)ptr, (ttLibC_Frame *)yuv);
+ *   }
+ *   static bool decodeFunc(void *ptr, ttLibC_TranscodeNode *node, ttLibC_Frame *frame) {
+ *     if(frame == NULL) {
+ *       return true; // end of stream, flush if needed.
+ *     }
+ *     return ttLibC_AvcodecDecoder_decode((ttLibC_AvcodecDecoder *)ptr, frame, decodeCallback, node);
+ *   }
+ *
+ * @author taktod
+ * @date   2026/10/19
+ */
+
+#ifndef TTLIBC_UTIL_TRANSCODEGRAPHUTIL_H_
+#define TTLIBC_UTIL_TRANSCODEGRAPHUTIL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../frame/frame.h"
+
+/**
+ * data for transcode node
+ * counters are updated by the thread of node, read them as approximate value.
+ */
+typedef struct ttLibC_Util_TranscodeGraphUtil_TranscodeNode {
+	/** name for report. */
+	char name[64];
+	/** number of processed frames. */
+	uint64_t in_count;
+	/** number of emitted frames. */
+	uint64_t out_count;
+	/** time in node func. (nano sec) */
+	uint64_t busy_time;
+	/** time to wait for the space of next node. (nano sec) */
+	uint64_t block_time;
+} ttLibC_Util_TranscodeGraphUtil_TranscodeNode;
+
+typedef ttLibC_Util_TranscodeGraphUtil_TranscodeNode ttLibC_TranscodeNode;
+
+/**
+ * data for transcode graph
+ */
+typedef struct ttLibC_Util_TranscodeGraphUtil_TranscodeGraph {
+	/** number of nodes. */
+	uint32_t node_num;
+	/** true while worker threads run. */
+	bool is_running;
+	/** true if some node func returns false. */
+	bool is_error;
+} ttLibC_Util_TranscodeGraphUtil_TranscodeGraph;
+
+typedef ttLibC_Util_TranscodeGraphUtil_TranscodeGraph ttLibC_TranscodeGraph;
+
+/**
+ * node function, called on the thread of node.
+ * @param ptr   user def value pointer, given on addNode.
+ * @param node  node object. use for ttLibC_TranscodeNode_emit.
+ * @param frame input frame. valid only in this call. NULL for end of stream.
+ *              shared with other threads for read only node, should be treated as read only.
+ * @return true:continue false:error, graph is stopped.
+ */
+typedef bool (* ttLibC_TranscodeNodeFunc)(void *ptr, ttLibC_TranscodeNode *node, ttLibC_Frame *frame);
+
+/**
+ * make graph.
+ * @param pool_size max number of idle frames to reuse.
+ * @return graph object.
+ */
+ttLibC_TranscodeGraph *ttLibC_TranscodeGraph_make(uint32_t pool_size);
+
+/**
+ * add node. (before start)
+ * @param graph      graph object.
+ * @param name       name for report.
+ * @param queue_size max number of input frames waiting.
+ * @param func       node function.
+ * @param ptr        user def value pointer for func.
+ * @return node object. owned by graph.
+ */
+ttLibC_TranscodeNode *ttLibC_TranscodeGraph_addNode(
+		ttLibC_TranscodeGraph *graph,
+		const char *name,
+		uint32_t queue_size,
+		ttLibC_TranscodeNodeFunc func,
+		void *ptr);
+
+/**
+ * connect output of node to input of other node. (before start)
+ * @param graph graph object.
+ * @param from  upstream node
+ * @param to    downstream node
+ * @return true:success false:error
+ */
+bool ttLibC_TranscodeGraph_connect(
+		ttLibC_TranscodeGraph *graph,
+		ttLibC_TranscodeNode *from,
+		ttLibC_TranscodeNode *to);
+
+/**
+ * declare that node func does not modify input frame. (before start)
+ * read only nodes share one frame on fan-out, without clone.
+ * @param node         node object.
+ * @param is_read_only true:read only false:node gets own frame. (default)
+ * @return true:success false:error
+ */
+bool ttLibC_TranscodeNode_setReadOnly(
+		ttLibC_TranscodeNode *node,
+		bool is_read_only);
+
+/**
+ * start threads of nodes.
+ * nodes without upstream are the input of graph.
+ * @param graph graph object.
+ * @return true:success false:error
+ */
+bool ttLibC_TranscodeGraph_start(ttLibC_TranscodeGraph *graph);
+
+/**
+ * put frame on input node. frame is cloned, wait if the node is busy.
+ * @param graph graph object.
+ * @param node  input node.
+ * @param frame source frame.
+ * @return true:success false:error or graph is stopped.
+ */
+bool ttLibC_TranscodeGraph_push(
+		ttLibC_TranscodeGraph *graph,
+		ttLibC_TranscodeNode *node,
+		ttLibC_Frame *frame);
+
+/**
+ * end of input, wait until all nodes finish.
+ * @param graph graph object.
+ * @return true:success false:some node failed.
+ */
+bool ttLibC_TranscodeGraph_finish(ttLibC_TranscodeGraph *graph);
+
+/**
+ * pass frame to all downstream nodes. call in node func. (or its callback)
+ * frame is cloned, wait if the next node is busy.
+ * @param node  node object.
+ * @param frame output frame.
+ * @return true:success false:graph is stopped.
+ */
+bool ttLibC_TranscodeNode_emit(
+		ttLibC_TranscodeNode *node,
+		ttLibC_Frame *frame);
+
+/**
+ * ref the busy time rate of node from start.
+ * @param node node object.
+ * @return 0.0 - 1.0
+ */
+double ttLibC_TranscodeNode_refUtilization(ttLibC_TranscodeNode *node);
+
+/**
+ * close graph, stop threads if running.
+ * @param graph
+ */
+void ttLibC_TranscodeGraph_close(ttLibC_TranscodeGraph **graph);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TTLIBC_UTIL_TRANSCODEGRAPHUTIL_H_ */